@@ -69,6 +69,7 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 #include "marfs.h"
 #include "datastream/datastream.h"
 #include "mdal/mdal.h"
+#include "stats/stats.h"
 
 #include <dirent.h>
 
@@ -103,6 +104,34 @@ typedef struct marfs_dhandle_struct {
    marfs_config*    config; // reference to the containing config ( for chdir validation )
 }* marfs_dhandle;
 
+typedef struct marfs_aop_struct {
+   struct marfs_aop_struct* next;
+   char            writing; // if non-zero, this is a write op
+   marfs_fhandle    stream;
+   off_t            offset; // read offset ( unused for writes )
+   void*               buf;
+   size_t            count;
+   void*               tag; // caller tag value
+   uint64_t      statstart; // submission time of the op ( for stats )
+   ssize_t          result;
+   int               error;
+} marfs_aop;
+
+typedef struct marfs_aqueue_struct {
+   pthread_mutex_t    lock; // for serializing access to this structure
+   pthread_cond_t     work; // signaled when ops become available for execution
+   pthread_cond_t     done; // signaled when ops complete
+   marfs_aop*      pending; // submitted ops, in submission order
+   marfs_aop*     pendtail;
+   marfs_aop*     complete; // completed ops, in completion order
+   marfs_aop*     comptail;
+   size_t      outstanding; // count of submitted ops which have not yet completed
+   char            writing; // set while a write op is executing
+   char          terminate; // set to indicate that workers should exit, once idle
+   unsigned int threadcount;
+   pthread_t*      threads;
+}* marfs_aqueue;
+
 
 //   -------------   INTERNAL FUNCTIONS    -------------
 
@@ -176,7 +205,7 @@ void pathcleanup( char* subpath, marfs_position* oppos ) {
  *                      If non-zero, verify the config and abort if any problems are found
  * @return marfs_ctxt : Newly initialized marfs_ctxt, or NULL if a failure occurred
  */
-marfs_ctxt marfs_init( const char* configpath, marfs_interface type, char verify ) {
+static marfs_ctxt untimed_marfs_init( const char* configpath, marfs_interface type, char verify ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid args
    if ( configpath == NULL ) {
@@ -250,7 +279,7 @@ marfs_ctxt marfs_init( const char* configpath, marfs_interface type, char verify
  * @param const char* ctag : New client tag string value
  * @return int : Zero on success, or -1 on failure
  */
-int marfs_setctag( marfs_ctxt ctxt, const char* ctag ) {
+static int untimed_marfs_setctag( marfs_ctxt ctxt, const char* ctag ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid args
    if ( ctxt == NULL ) {
@@ -298,7 +327,7 @@ int marfs_setctag( marfs_ctxt ctxt, const char* ctag ) {
  *                  indicates that insufficint buffer space was provided and the resulting
  *                  output string was truncated.
  */
-size_t marfs_configver( marfs_ctxt ctxt, char* verstr, size_t len ) {
+static size_t untimed_marfs_configver( marfs_ctxt ctxt, char* verstr, size_t len ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid arg
    if ( ctxt == NULL ) {
@@ -315,12 +344,43 @@ size_t marfs_configver( marfs_ctxt ctxt, char* verstr, size_t len ) {
    return retval;
 }
 
+/**
+ * Populate the given string with a report of per-operation latency and byte counts
+ * NOTE -- These values are accumulated across every thread and marfs_ctxt of the process.
+ *         The report consists of a single header line, beginning with '#', followed by a
+ *         line for each tracked operation of the form :
+ *            <op-name> <count> <errors> <bytes> <total-ns> <max-ns> <p50-ns> <p90-ns> <p99-ns> <p999-ns>
+ * @param marfs_ctxt ctxt : marfs_ctxt to retrieve stats for
+ * @param char* statstr : String to be populated
+ * @param size_t len : Allocated length of the target string
+ * @return size_t : Length of the produced string ( excluding NULL-terminator ), or zero if
+ *                  an error occurred.
+ *                  NOTE -- if this value is >= the length of the provided buffer, this
+ *                  indicates that insufficint buffer space was provided and the resulting
+ *                  output string was truncated.
+ */
+size_t marfs_getstats( marfs_ctxt ctxt, char* statstr, size_t len ) {
+   LOG( LOG_INFO, "ENTRY\n" );
+   // check for invalid arg
+   if ( ctxt == NULL ) {
+      LOG( LOG_ERR, "Received a NULL marfs_ctxt\n" );
+      errno = EINVAL;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return 0;
+   }
+   // print out the stats report
+   size_t retval = stats_report( statstr, len );
+   if ( retval ) { LOG( LOG_INFO, "EXIT - Success\n" ); }
+   else { LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) ); }
+   return retval;
+}
+
 /**
  * Destroy the provided marfs_ctxt
  * @param marfs_ctxt ctxt : marfs_ctxt to be destroyed
  * @return int : Zero on success, or -1 on failure
  */
-int marfs_term( marfs_ctxt ctxt ) {
+static int untimed_marfs_term( marfs_ctxt ctxt ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid arg
    if ( ctxt == NULL ) {
@@ -371,7 +431,7 @@ int marfs_term( marfs_ctxt ctxt ) {
  *                  indicates that insufficint buffer space was provided and the resulting
  *                  output string was truncated.
  */
-size_t marfs_mountpath( marfs_ctxt ctxt, char* mountstr, size_t len ) {
+static size_t untimed_marfs_mountpath( marfs_ctxt ctxt, char* mountstr, size_t len ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid arg
    if ( ctxt == NULL ) {
@@ -409,7 +469,7 @@ size_t marfs_mountpath( marfs_ctxt ctxt, char* mountstr, size_t len ) {
  *                    AT_SYMLINK_NOFOLLOW - do not dereference a symlink target
  * @return int : Zero on success, or -1 if a failure occurred
  */
-int marfs_access( marfs_ctxt ctxt, const char* path, int mode, int flags ) {
+static int untimed_marfs_access( marfs_ctxt ctxt, const char* path, int mode, int flags ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid arg
    if ( ctxt == NULL ) {
@@ -455,6 +515,28 @@ int marfs_access( marfs_ctxt ctxt, const char* path, int mode, int flags ) {
    return retval;
 }
 
+/**
+ * Adjust the MDAL stat values of a target to hide MarFS-internal structures
+ * @param struct stat* buf : Stat structure to be adjusted
+ * @param int tgtdepth : Depth of the target below its NS ( zero for the NS itself )
+ * @param marfs_ns* ns : NS containing the target
+ */
+static void adjuststat( struct stat* buf, int tgtdepth, marfs_ns* ns ) {
+   if ( tgtdepth == 0 ) {
+      // note subspaces in link count
+      buf->st_nlink += ns->subnodecount;
+   }
+   else if ( S_ISREG( buf->st_mode ) ) {
+      // regular files may need link count adjusted to ignore ref path
+      if ( buf->st_nlink > 1 ) { buf->st_nlink--; }
+      if ( buf->st_size ) {
+         // assume allocated blocks, based on logical file size ( saves us having to pull an FTAG xattr )
+         blkcnt_t estblocks = ( buf->st_size / 512 ) + ( (buf->st_size % 512) ? 1 : 0 );
+         if ( estblocks > buf->st_blocks ) { buf->st_blocks = estblocks; }
+      }
+   }
+}
+
 /**
  * Stat the specified file
  * @param const marfs_ctxt ctxt : marfs_ctxt to operate relative to
@@ -464,7 +546,7 @@ int marfs_access( marfs_ctxt ctxt, const char* path, int mode, int flags ) {
  *                    AT_SYMLINK_NOFOLLOW - do not dereference a symlink target
  * @return int : Zero on success, or -1 if a failure occurred
  */
-int marfs_stat( marfs_ctxt ctxt, const char* path, struct stat *buf, int flags ) {
+static int untimed_marfs_stat( marfs_ctxt ctxt, const char* path, struct stat *buf, int flags ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid arg
    if ( ctxt == NULL ) {
@@ -503,19 +585,7 @@ int marfs_stat( marfs_ctxt ctxt, const char* path, struct stat *buf, int flags )
       retval = curmdal->stat( oppos.ctxt, subpath, buf, flags );
    }
    // adjust stat values, if necessary
-   if ( tgtdepth == 0  &&  retval == 0 ) {
-      // note subspaces in link count
-      buf->st_nlink += oppos.ns->subnodecount;
-   }
-   else if ( tgtdepth != 0  &&  S_ISREG( buf->st_mode ) ) {
-      // regular files may need link count adjusted to ignore ref path
-      if ( buf->st_nlink > 1 ) { buf->st_nlink--; }
-      if ( buf->st_size ) {
-         // assume allocated blocks, based on logical file size ( saves us having to pull an FTAG xattr )
-         blkcnt_t estblocks = ( buf->st_size / 512 ) + ( (buf->st_size % 512) ? 1 : 0 );
-         if ( estblocks > buf->st_blocks ) { buf->st_blocks = estblocks; }
-      }
-   }
+   if ( retval == 0 ) { adjuststat( buf, tgtdepth, oppos.ns ); }
    // cleanup references
    pathcleanup( subpath, &oppos );
    // return op result
@@ -533,7 +603,7 @@ int marfs_stat( marfs_ctxt ctxt, const char* path, struct stat *buf, int flags )
  *                    AT_SYMLINK_NOFOLLOW - do not dereference a symlink target
  * @return int : Zero on success, or -1 if a failure occurred
  */
-int marfs_chmod( marfs_ctxt ctxt, const char* path, mode_t mode, int flags ) {
+static int untimed_marfs_chmod( marfs_ctxt ctxt, const char* path, mode_t mode, int flags ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid arg
    if ( ctxt == NULL ) {
@@ -588,7 +658,7 @@ int marfs_chmod( marfs_ctxt ctxt, const char* path, mode_t mode, int flags ) {
  *                    AT_SYMLINK_NOFOLLOW - do not dereference a symlink target
  * @return int : Zero on success, or -1 if a failure occurred
  */
-int marfs_chown( marfs_ctxt ctxt, const char* path, uid_t uid, gid_t gid, int flags ) {
+static int untimed_marfs_chown( marfs_ctxt ctxt, const char* path, uid_t uid, gid_t gid, int flags ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid arg
    if ( ctxt == NULL ) {
@@ -640,7 +710,7 @@ int marfs_chown( marfs_ctxt ctxt, const char* path, uid_t uid, gid_t gid, int fl
  * @param const char* to : Destination string path
  * @return int : Zero on success, or -1 if a failure occurred
  */
-int marfs_rename( marfs_ctxt ctxt, const char* from, const char* to ) {
+static int untimed_marfs_rename( marfs_ctxt ctxt, const char* from, const char* to ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid arg
    if ( ctxt == NULL ) {
@@ -730,7 +800,7 @@ int marfs_rename( marfs_ctxt ctxt, const char* from, const char* to ) {
  * @param const char* linkname : String path of the new link
  * @return int : Zero on success, or -1 if a failure occurred
  */
-int marfs_symlink( marfs_ctxt ctxt, const char* target, const char* linkname ) {
+static int untimed_marfs_symlink( marfs_ctxt ctxt, const char* target, const char* linkname ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid arg
    if ( ctxt == NULL ) {
@@ -788,7 +858,7 @@ int marfs_symlink( marfs_ctxt ctxt, const char* target, const char* linkname ) {
  * @param size_t size : Size of the target buffer
  * @return ssize_t : Size of the link target string, or -1 if a failure occurred
  */
-ssize_t marfs_readlink( marfs_ctxt ctxt, const char* path, char* buf, size_t size ) {
+static ssize_t untimed_marfs_readlink( marfs_ctxt ctxt, const char* path, char* buf, size_t size ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid arg
    if ( ctxt == NULL ) {
@@ -841,7 +911,7 @@ ssize_t marfs_readlink( marfs_ctxt ctxt, const char* path, char* buf, size_t siz
  * @param const char* path : String path of the target file
  * @return int : Zero on success, or -1 if a failure occurred
  */
-int marfs_unlink( marfs_ctxt ctxt, const char* path ) {
+static int untimed_marfs_unlink( marfs_ctxt ctxt, const char* path ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid arg
    if ( ctxt == NULL ) {
@@ -897,7 +967,7 @@ int marfs_unlink( marfs_ctxt ctxt, const char* path ) {
  *                    AT_SYMLINK_NOFOLLOW - do not dereference a symlink target
  * @return int : Zero on success, or -1 if a failure occurred
  */
-int marfs_link( marfs_ctxt ctxt, const char* oldpath, const char* newpath, int flags ) {
+static int untimed_marfs_link( marfs_ctxt ctxt, const char* oldpath, const char* newpath, int flags ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid arg
    if ( ctxt == NULL ) {
@@ -998,7 +1068,7 @@ int marfs_link( marfs_ctxt ctxt, const char* oldpath, const char* newpath, int f
  *                    AT_SYMLINK_NOFOLLOW - do not dereference a symlink target
  * @return int : Zero value on success, or -1 if a failure occurred
  */
-int marfs_utimens( marfs_ctxt ctxt, const char* path, const struct timespec times[2], int flags ) {
+static int untimed_marfs_utimens( marfs_ctxt ctxt, const char* path, const struct timespec times[2], int flags ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid arg
    if ( ctxt == NULL ) {
@@ -1052,7 +1122,7 @@ int marfs_utimens( marfs_ctxt ctxt, const char* path, const struct timespec time
  * @param mode_t mode : Mode value of the new directory (see inode man page)
  * @return int : Zero on success, or -1 if a failure occurred
  */
-int marfs_mkdir( marfs_ctxt ctxt, const char* path, mode_t mode ) {
+static int untimed_marfs_mkdir( marfs_ctxt ctxt, const char* path, mode_t mode ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid arg
    if ( ctxt == NULL ) {
@@ -1104,7 +1174,7 @@ int marfs_mkdir( marfs_ctxt ctxt, const char* path, mode_t mode ) {
  * @param const char* path : String path of the target directory
  * @return int : Zero on success, or -1 if a failure occurred
  */
-int marfs_rmdir( marfs_ctxt ctxt, const char* path ) {
+static int untimed_marfs_rmdir( marfs_ctxt ctxt, const char* path ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid arg
    if ( ctxt == NULL ) {
@@ -1156,7 +1226,7 @@ int marfs_rmdir( marfs_ctxt ctxt, const char* path ) {
  * @param struct statvfs* buf : Reference to the statvfs structure to be populated
  * @return int : Zero on success, or -1 if a failure occurred
  */
-int marfs_statvfs( marfs_ctxt ctxt, const char* path, struct statvfs *buf ) {
+static int untimed_marfs_statvfs( marfs_ctxt ctxt, const char* path, struct statvfs *buf ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for invalid arg
    if ( ctxt == NULL ) {
@@ -1240,7 +1310,7 @@ int marfs_statvfs( marfs_ctxt ctxt, const char* path, struct statvfs *buf ) {
  * @param struct stat* buf : Reference to a stat buffer to be populated
  * @return int : Zero on success, or -1 if a failure occurred
  */
-int marfs_fstat( marfs_fhandle fh, struct stat* buf ) {
+static int untimed_marfs_fstat( marfs_fhandle fh, struct stat* buf ) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( fh == NULL ) {
@@ -1268,7 +1338,7 @@ int marfs_fstat( marfs_fhandle fh, struct stat* buf ) {
  *                                         (see man utimensat for struct reference)
  * @return int : Zero value on success, or -1 if a failure occurred
  */
-int marfs_futimens(marfs_fhandle fh, const struct timespec times[2]) {
+static int untimed_marfs_futimens(marfs_fhandle fh, const struct timespec times[2]) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( fh == NULL ) {
@@ -1322,7 +1392,7 @@ int marfs_futimens(marfs_fhandle fh, const struct timespec times[2]) {
  *                    XATTR_REPLACE - replace the xattr only (fail if xattr missing)
  * @return int : Zero on success, or -1 if a failure occurred
  */
-int marfs_fsetxattr(marfs_fhandle fh, const char* name, const void* value, size_t size, int flags) {
+static int untimed_marfs_fsetxattr(marfs_fhandle fh, const char* name, const void* value, size_t size, int flags) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( fh == NULL ) {
@@ -1354,7 +1424,7 @@ int marfs_fsetxattr(marfs_fhandle fh, const char* name, const void* value, size_
  * @param size_t size : Size of the target buffer
  * @return ssize_t : Size of the returned xattr value, or -1 if a failure occurred
  */
-ssize_t marfs_fgetxattr(marfs_fhandle fh, const char* name, void* value, size_t size) {
+static ssize_t untimed_marfs_fgetxattr(marfs_fhandle fh, const char* name, void* value, size_t size) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( fh == NULL ) {
@@ -1376,7 +1446,7 @@ ssize_t marfs_fgetxattr(marfs_fhandle fh, const char* name, void* value, size_t
  * @param const char* name : String name of the xattr to remove
  * @return int : Zero on success, or -1 if a failure occurred
  */
-int marfs_fremovexattr(marfs_fhandle fh, const char* name) {
+static int untimed_marfs_fremovexattr(marfs_fhandle fh, const char* name) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( fh == NULL ) {
@@ -1407,7 +1477,7 @@ int marfs_fremovexattr(marfs_fhandle fh, const char* name) {
  * @param size_t size : Size of the target buffer
  * @return ssize_t : Size of the returned xattr name list, or -1 if a failure occurred
  */
-ssize_t marfs_flistxattr(marfs_fhandle fh, char* buf, size_t size) {
+static ssize_t untimed_marfs_flistxattr(marfs_fhandle fh, char* buf, size_t size) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( fh == NULL ) {
@@ -1432,7 +1502,7 @@ ssize_t marfs_flistxattr(marfs_fhandle fh, char* buf, size_t size) {
  * @param const char* path : String path of the target directory
  * @return marfs_dhandle : Open directory handle, or NULL if a failure occurred
  */
-marfs_dhandle marfs_opendir(marfs_ctxt ctxt, const char *path) {
+static marfs_dhandle untimed_marfs_opendir(marfs_ctxt ctxt, const char *path) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( ctxt == NULL ) {
@@ -1537,7 +1607,7 @@ marfs_dhandle marfs_opendir(marfs_ctxt ctxt, const char *path) {
  *                          if all entries have been read, or NULL w/ errno set if a
  *                          failure occurred
  */
-struct dirent *marfs_readdir(marfs_dhandle dh) {
+static struct dirent *untimed_marfs_readdir(marfs_dhandle dh) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( dh == NULL ) {
@@ -1608,12 +1678,115 @@ struct dirent *marfs_readdir(marfs_dhandle dh) {
    return retval;
 }
 
+/**
+ * Read a batch of entries, each with stat info, from an open directory handle
+ * @param marfs_dhandle dh : marfs_dhandle to read from
+ * @param marfs_direntplus* entries : Array of entries to be populated
+ * @param size_t count : Length of the entries array
+ * @return ssize_t : Count of populated entries, zero if all entries have been read,
+ *                   or -1 if a failure occurred
+ */
+static ssize_t untimed_marfs_readdirplus(marfs_dhandle dh, marfs_direntplus* entries, size_t count) {
+   LOG( LOG_INFO, "ENTRY\n" );
+   // check for NULL args
+   if ( dh == NULL ) {
+      LOG( LOG_ERR, "Received a NULL marfs_dhandle arg\n" );
+      errno = EINVAL;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   if ( entries == NULL  &&  count ) {
+      LOG( LOG_ERR, "Received a NULL entries arg\n" );
+      errno = EINVAL;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   // acquire directory lock
+   if ( pthread_mutex_lock( &(dh->lock) ) ) {
+      LOG( LOG_ERR, "Failed to aqcuire marfs_dhandle lock\n" );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   // cache our original errno value, and clear it
+   int cachederrno = errno;
+   errno = 0;
+   size_t filled = 0;
+   // potentially insert subspace entries
+   while ( filled < count  &&  dh->depth == 0  &&  dh->subspcindex < dh->ns->subnodecount ) {
+      marfs_direntplus* tgtent = entries + filled;
+      HASH_NODE* subnode = dh->ns->subnodes + dh->subspcindex;
+      marfs_ns* tgtsubspace = (marfs_ns*)(subnode->content);
+      char* subspacepath = NULL;
+      if ( config_nsinfo( tgtsubspace->idstr, NULL, &(subspacepath) ) ) {
+         LOG( LOG_ERR, "Failed to identify NS path of subspace: \"%s\"\n", tgtsubspace->idstr );
+         pthread_mutex_unlock( &(dh->lock) );
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return -1;
+      }
+      MDAL tgtmdal = tgtsubspace->prepo->metascheme.mdal;
+      if ( tgtmdal->statnamespace( tgtmdal->ctxt, subspacepath, &(tgtent->st) ) ) {
+         LOG( LOG_ERR, "Failed to stat subspace root: \"%s\"\n", subspacepath );
+         free( subspacepath );
+         pthread_mutex_unlock( &(dh->lock) );
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return -1;
+      }
+      free( subspacepath );
+      adjuststat( &(tgtent->st), 0, tgtsubspace );
+      if ( snprintf( tgtent->dent.d_name, sizeof( tgtent->dent.d_name ), "%s", subnode->name ) >= sizeof( tgtent->dent.d_name ) ) {
+         LOG( LOG_ERR, "Dirent struct does not have sufficient space to store subspace name: \"%s\"\n", subnode->name );
+         pthread_mutex_unlock( &(dh->lock) );
+         errno = ENAMETOOLONG;
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return -1;
+      }
+      tgtent->dent.d_ino = tgtent->st.st_ino;
+      tgtent->dent.d_off = 0;
+      tgtent->dent.d_reclen = sizeof( struct dirent );
+      tgtent->dent.d_type = DT_DIR;
+      dh->subspcindex++;
+      filled++;
+   }
+   // fill the remainder from the MDAL
+   MDAL curmdal = dh->ns->prepo->metascheme.mdal;
+   while ( filled < count ) {
+      marfs_direntplus* tgtent = entries + filled;
+      struct dirent* mdalent = curmdal->readdirplus( dh->metahandle, &(tgtent->st) );
+      if ( mdalent == NULL ) { break; } // EOF or failure
+      // filter out any restricted entries at the root of a NS
+      if ( dh->depth == 0  &&  curmdal->pathfilter( mdalent->d_name ) ) {
+         LOG( LOG_INFO, "Omitting hidden dirent: \"%s\"\n", mdalent->d_name );
+         continue;
+      }
+      // copy out individual values, as the MDAL dirent may not be a full-length struct
+      if ( snprintf( tgtent->dent.d_name, sizeof( tgtent->dent.d_name ), "%s", mdalent->d_name ) >= sizeof( tgtent->dent.d_name ) ) {
+         LOG( LOG_ERR, "Dirent struct does not have sufficient space to store entry name: \"%s\"\n", mdalent->d_name );
+         errno = ENAMETOOLONG;
+         break;
+      }
+      tgtent->dent.d_ino = mdalent->d_ino;
+      tgtent->dent.d_off = mdalent->d_off;
+      tgtent->dent.d_reclen = sizeof( struct dirent );
+      tgtent->dent.d_type = mdalent->d_type;
+      adjuststat( &(tgtent->st), dh->depth + 1, dh->ns );
+      filled++;
+   }
+   pthread_mutex_unlock( &(dh->lock) );
+   if ( errno ) {
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   errno = cachederrno;
+   LOG( LOG_INFO, "EXIT - Success ( %zu entries )\n", filled );
+   return (ssize_t)filled;
+}
+
 /**
  * Close the given directory handle
  * @param marfs_dhandle dh : marfs_dhandle to close
  * @return int : Zero on success, or -1 if a failure occurred
  */
-int marfs_closedir(marfs_dhandle dh) {
+static int untimed_marfs_closedir(marfs_dhandle dh) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( dh == NULL ) {
@@ -1652,7 +1825,7 @@ int marfs_closedir(marfs_dhandle dh) {
  *                           NOTE -- this operation will destroy the provided marfs_dhandle
  * @return int : Zero on success, -1 if a failure occurred
  */
-int marfs_chdir(marfs_ctxt ctxt, marfs_dhandle dh) {
+static int untimed_marfs_chdir(marfs_ctxt ctxt, marfs_dhandle dh) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( ctxt == NULL ) {
@@ -1724,7 +1897,7 @@ int marfs_chdir(marfs_ctxt ctxt, marfs_dhandle dh) {
  *                    XATTR_REPLACE - replace the xattr only (fail if xattr missing)
  * @return int : Zero on success, or -1 if a failure occurred
  */
-int marfs_dsetxattr(marfs_dhandle dh, const char* name, const void* value, size_t size, int flags) {
+static int untimed_marfs_dsetxattr(marfs_dhandle dh, const char* name, const void* value, size_t size, int flags) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( dh == NULL ) {
@@ -1756,7 +1929,7 @@ int marfs_dsetxattr(marfs_dhandle dh, const char* name, const void* value, size_
  * @param size_t size : Size of the target buffer
  * @return ssize_t : Size of the returned xattr value, or -1 if a failure occurred
  */
-ssize_t marfs_dgetxattr(marfs_dhandle dh, const char* name, void* value, size_t size) {
+static ssize_t untimed_marfs_dgetxattr(marfs_dhandle dh, const char* name, void* value, size_t size) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( dh == NULL ) {
@@ -1778,7 +1951,7 @@ ssize_t marfs_dgetxattr(marfs_dhandle dh, const char* name, void* value, size_t
  * @param const char* name : String name of the xattr to remove
  * @return int : Zero on success, or -1 if a failure occurred
  */
-int marfs_dremovexattr(marfs_dhandle dh, const char* name) {
+static int untimed_marfs_dremovexattr(marfs_dhandle dh, const char* name) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( dh == NULL ) {
@@ -1809,7 +1982,7 @@ int marfs_dremovexattr(marfs_dhandle dh, const char* name) {
  * @param size_t size : Size of the target buffer
  * @return ssize_t : Size of the returned xattr name list, or -1 if a failure occurred
  */
-ssize_t marfs_dlistxattr(marfs_dhandle dh, char* buf, size_t size) {
+static ssize_t untimed_marfs_dlistxattr(marfs_dhandle dh, char* buf, size_t size) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( dh == NULL ) {
@@ -1851,7 +2024,7 @@ ssize_t marfs_dlistxattr(marfs_dhandle dh, char* buf, size_t size) {
  *            In such a case, errno will be set to EBADFD and any subsequent operations
  *            against the provided marfs_fhandle will fail, besides marfs_release().
  */
-marfs_fhandle marfs_creat(marfs_ctxt ctxt, marfs_fhandle stream, const char *path, mode_t mode) {
+static marfs_fhandle untimed_marfs_creat(marfs_ctxt ctxt, marfs_fhandle stream, const char *path, mode_t mode) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( ctxt == NULL ) {
@@ -2021,140 +2194,428 @@ marfs_fhandle marfs_creat(marfs_ctxt ctxt, marfs_fhandle stream, const char *pat
 }
 
 /**
- * Open an existing file
+ * Create and write out a batch of new MarFS files, all within the same directory, packing
+ * them into the given marfs_fhandle
+ * NOTE -- This is equivalent to a marfs_creat() + marfs_write() of each entry, in order.
+ *         However, the target directory, NS perms, and NS quotas are only checked once for
+ *         the entire batch ( quotas must allow for every entry ).
  * @param marfs_ctxt ctxt : marfs_ctxt to operate relative to
- * @param marfs_fhandle stream : Reference to an existing marfs_fhandle, or NULL
- *                               If non-NULL, the previous marfs_fhandle will be modified
- *                               to reference the new file, preserving existing meta/data
- *                               values/buffers to whatever extent is possible.  The
- *                               modified handle will be returned by this function.
- *                               If NULL, the created file will be tied to a completely
- *                               fresh marfs_fhandle.
- *                               NOTE -- Clients should essentially always open new files
- *                               via an existing marfs_fhandle, when feasible to do so.
- * @param const char* path : Path of the file to be opened
- * @param marfs_flags flags : Flags specifying the mode in which to open the file
- * @return marfs_fhandle : marfs_fhandle referencing the opened file,
- *                         or NULL if a failure occurred
- *    NOTE -- In most failure conditions, any previous marfs_fhandle reference will be
- *            preserved ( continue to reference whatever file it previously referenced ).
- *            However, it is possible for certain catastrophic error conditions to occur.
- *            In such a case, errno will be set to EBADFD and any subsequent operations
- *            against the provided marfs_fhandle will fail, besides marfs_release().
+ * @param marfs_fhandle* stream : Reference to an existing marfs_fhandle, or to NULL
+ *                                ( see the 'stream' arg of marfs_creat() )
+ *                                This will be updated to reference the last created file.
+ * @param const char* dirpath : Path of the directory to create all files within
+ * @param const marfs_batchent* entries : Array of files to be created
+ *                                        NOTE -- entry names must not contain '/'
+ * @param size_t count : Length of the entries array
+ * @param size_t* bytes : Reference to be populated with the total data bytes written
+ * @return ssize_t : Number of entries created and written, or -1 if none were
+ *                   NOTE -- if less than 'count', errno will indicate the failure cause
+ *    NOTE -- As with marfs_creat(), if a catastrophic error condition occurs, errno will be
+ *            set to EBADFD and any subsequent operations against the marfs_fhandle will fail,
+ *            besides marfs_release().
  */
-marfs_fhandle marfs_open(marfs_ctxt ctxt, marfs_fhandle stream, const char *path, marfs_flags flags) {
+static ssize_t untimed_marfs_creat_batch(marfs_ctxt ctxt, marfs_fhandle* stream, const char* dirpath, const marfs_batchent* entries, size_t count, size_t* bytes) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
-   if ( ctxt == NULL ) {
-      LOG( LOG_ERR, "Received a NULL marfs_ctxt arg\n" );
+   if ( ctxt == NULL  ||  stream == NULL  ||  dirpath == NULL  ||  entries == NULL  ||  count == 0 ) {
+      LOG( LOG_ERR, "Received a NULL / empty arg\n" );
       errno = EINVAL;
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
-      return NULL;
+      return -1;
    }
-   // check for invalid flags
-   if ( (flags & ~(MARFS_META)) != MARFS_READ  &&  (flags & ~(MARFS_META)) != MARFS_WRITE ) {
-      LOG( LOG_ERR, "Unrecognized flags value\n" );
-      errno = EINVAL;
+   // validate all entries, prior to creating anything
+   size_t maxnamelen = 0;
+   size_t totalbytes = 0;
+   size_t index = 0;
+   for ( ; index < count; index++ ) {
+      const char* name = entries[index].name;
+      if ( name == NULL  ||  *name == '\0'  ||  strchr( name, '/' )  ||
+           strcmp( name, "." ) == 0  ||  strcmp( name, ".." ) == 0  ||
+           ( entries[index].buf == NULL  &&  entries[index].size ) ) {
+         LOG( LOG_ERR, "Invalid batch entry %zu\n", index );
+         errno = EINVAL;
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return -1;
+      }
+      size_t namelen = strlen( name );
+      if ( namelen > maxnamelen ) { maxnamelen = namelen; }
+      totalbytes += entries[index].size;
+   }
+   // identify the path target, via the first entry
+   //    NOTE -- the parent directory must be resolved relative to an entry, rather than on
+   //            its own, as a NS root directory is only traversable by full path.  The entry
+   //            itself is never substituted for a symlink target, so that the resolved parent
+   //            is shared by every entry.
+   size_t dirlen = strlen( dirpath );
+   char* entpath = malloc( sizeof(char) * ( dirlen + 1 + maxnamelen + 1 ) );
+   if ( entpath == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate batch entry path\n" );
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
-      return NULL;
+      return -1;
    }
-   // identify the path target
+   snprintf( entpath, dirlen + 1 + maxnamelen + 1, "%s/%s", dirpath, entries[0].name );
    marfs_position oppos = { .ns = NULL, .depth = 0, .ctxt = NULL };
    char* subpath = NULL;
-   int tgtdepth = pathshift( ctxt, path, &(subpath), &(oppos), 1 );
+   int tgtdepth = pathshift( ctxt, entpath, &(subpath), &(oppos), 1 );
+   free( entpath );
    if ( tgtdepth < 0 ) {
-      LOG( LOG_ERR, "Failed to identify target info for create op\n" );
+      LOG( LOG_ERR, "Failed to identify target info for batch create op\n" );
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
-      return NULL;
+      return -1;
    }
    LOG( LOG_INFO, "TGT: Depth=%d, NS=\"%s\", SubPath=\"%s\"\n", tgtdepth, oppos.ns->idstr, subpath );
-   // check NS perms
-   if ( ( ctxt->itype != MARFS_INTERACTIVE  &&  !(oppos.ns->bperms & NS_READMETA) )  ||
-        ( ctxt->itype != MARFS_BATCH        &&  !(oppos.ns->iperms & NS_READMETA) ) ) {
-      LOG( LOG_ERR, "NS perms do not allow an open op\n" );
+   // check NS perms ( require RWMETA and WRITEDATA for file creation )
+   if ( ( ctxt->itype != MARFS_INTERACTIVE  &&
+            ( (oppos.ns->bperms & NS_RWMETA) != NS_RWMETA  ||
+             !(oppos.ns->bperms & NS_WRITEDATA) ) )
+        ||
+        ( ctxt->itype != MARFS_BATCH        &&
+            ( (oppos.ns->iperms & NS_RWMETA) != NS_RWMETA   ||
+             !(oppos.ns->iperms & NS_WRITEDATA) ) )
+      ) {
+      LOG( LOG_ERR, "NS perms do not allow a create op\n" );
       pathcleanup( subpath, &oppos );
       errno = EPERM;
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
-      return NULL;
+      return -1;
    }
+   // check for NS target
    if ( tgtdepth == 0 ) {
       LOG( LOG_ERR, "Cannot target a MarFS NS with a create op\n" );
       pathcleanup( subpath, &oppos );
       errno = EISDIR;
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
-      return NULL;
+      return -1;
+   }
+   // within a NS root, every entry must be checked for subspace names, just as pathshift() checked the first
+   MDAL tgtmdal = oppos.ns->prepo->metascheme.mdal;
+   if ( tgtdepth == 1 ) {
+      for ( index = 0; index < count; index++ ) {
+         HASH_NODE* resnode = NULL;
+         if ( oppos.ns->subspaces  &&  hash_lookup( oppos.ns->subspaces, entries[index].name, &(resnode) ) == 0 ) {
+            LOG( LOG_ERR, "Batch entry %zu targets a MarFS NS: \"%s\"\n", index, entries[index].name );
+            errno = EISDIR;
+            break;
+         }
+         if ( tgtmdal->pathfilter( entries[index].name ) ) {
+            LOG( LOG_ERR, "Batch entry %zu rejected by MDAL: \"%s\"\n", index, entries[index].name );
+            errno = EPERM;
+            break;
+         }
+      }
+      if ( index != count ) {
+         pathcleanup( subpath, &oppos );
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return -1;
+      }
+   }
+   // check NS quota, against the entire batch
+   if ( oppos.ns->fquota ) {
+      off_t inodeusage = tgtmdal->getinodeusage( oppos.ctxt );
+      if ( inodeusage < 0 ) {
+         LOG( LOG_ERR, "Failed to retrieve NS inode usage info\n" );
+      }
+      else if ( inodeusage + count > oppos.ns->fquota ) {
+         LOG( LOG_ERR, "NS inode count (%zd) does not allow for %zu new files\n", inodeusage, count );
+         inodeusage = -1;
+      }
+      if ( inodeusage < 0 ) {
+         pathcleanup( subpath, &oppos );
+         errno = EDQUOT;
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return -1;
+      }
+   }
+   if ( oppos.ns->dquota ) {
+      off_t datausage = tgtmdal->getdatausage( oppos.ctxt );
+      if ( datausage < 0 ) {
+         LOG( LOG_ERR, "Failed to retrieve NS data usage info\n" );
+      }
+      else if ( datausage >= oppos.ns->dquota  ||  totalbytes > oppos.ns->dquota - datausage ) {
+         LOG( LOG_ERR, "NS data usage (%zd) does not allow for %zu new bytes\n", datausage, totalbytes );
+         datausage = -1;
+      }
+      if ( datausage < 0 ) {
+         pathcleanup( subpath, &oppos );
+         errno = EDQUOT;
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return -1;
+      }
+   }
+   // generate a path buffer, reusing the resolved parent path for every entry
+   char* parentend = strrchr( subpath, '/' );
+   size_t parentlen = ( parentend ) ? (size_t)( parentend - subpath ) + 1 : 0;
+   entpath = malloc( sizeof(char) * ( parentlen + maxnamelen + 1 ) );
+   if ( entpath == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate batch entry subpath\n" );
+      pathcleanup( subpath, &oppos );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
    }
+   memcpy( entpath, subpath, parentlen );
    // check the state of our handle argument
+   marfs_fhandle tgtstream = *stream;
    char newstream = 0;
-   if ( stream == NULL ) {
+   if ( tgtstream == NULL ) {
       // allocate a fresh handle
-      stream = malloc( sizeof( struct marfs_fhandle_struct ) );
-      if ( stream == NULL ) {
+      tgtstream = malloc( sizeof( struct marfs_fhandle_struct ) );
+      if ( tgtstream == NULL ) {
          LOG( LOG_ERR, "Failed to allocate a new marfs_fhandle struct\n" );
+         free( entpath );
          pathcleanup( subpath, &oppos );
          LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
-         return NULL;
+         return -1;
       }
-      stream->ns = NULL;
-      stream->datastream = NULL;
-      stream->metahandle = NULL;
-      if ( pthread_mutex_init( &(stream->lock), NULL ) ) {
+      tgtstream->ns = NULL;
+      tgtstream->datastream = NULL;
+      tgtstream->metahandle = NULL;
+      tgtstream->dataremaining = 0;
+      if ( pthread_mutex_init( &(tgtstream->lock), NULL ) ) {
          LOG( LOG_ERR, "Failed to initialize lock of new marfs_fhandle struct\n" );
-         free( stream );
+         free( tgtstream );
+         free( entpath );
          pathcleanup( subpath, &oppos );
          LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
-         return NULL;
+         return -1;
       }
       newstream = 1;
-      // acquire the lock, just in case
-      if ( pthread_mutex_lock( &(stream->lock) ) ) {
-         LOG( LOG_ERR, "Failed to acquire lock on new marfs_fhandle\n" );
-         pthread_mutex_destroy( &(stream->lock) );
-         free( stream );
-         pathcleanup( subpath, &oppos );
-         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
-         return NULL;
-      }
    }
    else {
       // acquire the lock for an existing stream
-      if ( pthread_mutex_lock( &(stream->lock) ) ) {
+      if ( pthread_mutex_lock( &(tgtstream->lock) ) ) {
          LOG( LOG_ERR, "Failed to acquire marfs_fhandle lock\n" );
+         free( entpath );
          pathcleanup( subpath, &oppos );
          LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
-         return NULL;
+         return -1;
       }
-      if ( stream->datastream == NULL  &&  stream->metahandle == NULL ) {
+      if ( tgtstream->datastream == NULL  &&  tgtstream->metahandle == NULL ) {
          // a double-NULL handle has been flushed or suffered a fatal error
          LOG( LOG_ERR, "Received a flushed marfs_fhandle\n" );
-         pthread_mutex_unlock( &(stream->lock) );
+         pthread_mutex_unlock( &(tgtstream->lock) );
+         free( entpath );
          pathcleanup( subpath, &oppos );
          errno = EINVAL;
          LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
-         return NULL;
+         return -1;
       }
-      else if ( stream->datastream == NULL  &&  stream->metahandle != NULL ) {
+      else if ( tgtstream->datastream == NULL  &&  tgtstream->metahandle != NULL ) {
          // meta-only reference; attempt to close it
-         MDAL curmdal = stream->ns->prepo->metascheme.mdal;
-         if ( curmdal->close( stream->metahandle ) ) {
+         MDAL curmdal = tgtstream->ns->prepo->metascheme.mdal;
+         if ( curmdal->close( tgtstream->metahandle ) ) {
             LOG( LOG_ERR, "Failed to close previous MDAL_FHANDLE\n" );
-            stream->metahandle = NULL;
-            pthread_mutex_unlock( &(stream->lock) );
+            tgtstream->metahandle = NULL;
+            pthread_mutex_unlock( &(tgtstream->lock) );
+            free( entpath );
             pathcleanup( subpath, &oppos );
             errno = EBADFD;
             LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
-            return NULL;
+            return -1;
          }
-         stream->metahandle = NULL; // don't reattempt this op
+         tgtstream->metahandle = NULL; // don't reattempt this op
       }
    }
    // duplicate the current NS ref
    marfs_ns* dupref = config_duplicatensref( oppos.ns );
    if ( dupref == NULL ) {
       LOG( LOG_ERR, "Failed to duplicate op NS reference\n" );
+      free( entpath );
       pathcleanup( subpath, &oppos );
-      if ( !(newstream)  &&  stream->metahandle == NULL ) { errno = EBADFD; } // ref is now defunct
-      pthread_mutex_unlock( &(stream->lock) );
+      if ( newstream ) { free( tgtstream ); }
+      else { pthread_mutex_unlock( &(tgtstream->lock) ); }
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   // create and write out each entry in turn
+   size_t created = 0;
+   *bytes = 0;
+   for ( ; created < count; created++ ) {
+      const marfs_batchent* entry = entries + created;
+      strcpy( entpath + parentlen, entry->name );
+      if ( datastream_create( &(tgtstream->datastream), entpath, &oppos, entry->mode, ctxt->config->ctag ) ) {
+         LOG( LOG_ERR, "Failure of datastream_create() for batch entry %zu: \"%s\"\n", created, entpath );
+         break;
+      }
+      if ( created == 0 ) {
+         // update our stream info to reflect the new target
+         if ( tgtstream->ns ) { config_destroynsref( tgtstream->ns ); }
+         tgtstream->flags = O_WRONLY | O_CREAT;
+         tgtstream->ns = dupref;
+         tgtstream->itype = ctxt->itype;
+         dupref = NULL; // now owned by the stream
+      }
+      tgtstream->metahandle = tgtstream->datastream->files[tgtstream->datastream->curfile].metahandle;
+      if ( entry->size  &&
+           datastream_write( &(tgtstream->datastream), entry->buf, entry->size ) != entry->size ) {
+         LOG( LOG_ERR, "Failed to write %zu bytes to batch entry %zu: \"%s\"\n", entry->size, created, entpath );
+         break;
+      }
+      *bytes += entry->size;
+   }
+   free( entpath );
+   pathcleanup( subpath, &oppos ); // done with path info
+   int olderrno = errno;
+   if ( dupref ) {
+      // the handle never came to reference any entry
+      config_destroynsref( dupref );
+      if ( newstream ) {
+         pthread_mutex_destroy( &(tgtstream->lock) );
+         free( tgtstream );
+         errno = olderrno;
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return -1;
+      }
+   }
+   if ( tgtstream->datastream == NULL ) {
+      tgtstream->metahandle = NULL; // ref is now defunct
+      olderrno = EBADFD;
+   }
+   if ( !(newstream) ) { pthread_mutex_unlock( &(tgtstream->lock) ); }
+   *stream = tgtstream;
+   errno = olderrno;
+   if ( created < count ) {
+      LOG( LOG_INFO, "EXIT - Partial success (%zu of %zu files) w/ \"%s\"\n", created, count, strerror(errno) );
+      return ( created ) ? (ssize_t)created : -1;
+   }
+   LOG( LOG_INFO, "EXIT - Success (%zu files)\n", count );
+   return created;
+}
+
+/**
+ * Open an existing file
+ * @param marfs_ctxt ctxt : marfs_ctxt to operate relative to
+ * @param marfs_fhandle stream : Reference to an existing marfs_fhandle, or NULL
+ *                               If non-NULL, the previous marfs_fhandle will be modified
+ *                               to reference the new file, preserving existing meta/data
+ *                               values/buffers to whatever extent is possible.  The
+ *                               modified handle will be returned by this function.
+ *                               If NULL, the created file will be tied to a completely
+ *                               fresh marfs_fhandle.
+ *                               NOTE -- Clients should essentially always open new files
+ *                               via an existing marfs_fhandle, when feasible to do so.
+ * @param const char* path : Path of the file to be opened
+ * @param marfs_flags flags : Flags specifying the mode in which to open the file
+ * @return marfs_fhandle : marfs_fhandle referencing the opened file,
+ *                         or NULL if a failure occurred
+ *    NOTE -- In most failure conditions, any previous marfs_fhandle reference will be
+ *            preserved ( continue to reference whatever file it previously referenced ).
+ *            However, it is possible for certain catastrophic error conditions to occur.
+ *            In such a case, errno will be set to EBADFD and any subsequent operations
+ *            against the provided marfs_fhandle will fail, besides marfs_release().
+ */
+static marfs_fhandle untimed_marfs_open(marfs_ctxt ctxt, marfs_fhandle stream, const char *path, marfs_flags flags) {
+   LOG( LOG_INFO, "ENTRY\n" );
+   // check for NULL args
+   if ( ctxt == NULL ) {
+      LOG( LOG_ERR, "Received a NULL marfs_ctxt arg\n" );
+      errno = EINVAL;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   // check for invalid flags
+   if ( (flags & ~(MARFS_META)) != MARFS_READ  &&  (flags & ~(MARFS_META)) != MARFS_WRITE ) {
+      LOG( LOG_ERR, "Unrecognized flags value\n" );
+      errno = EINVAL;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   // identify the path target
+   marfs_position oppos = { .ns = NULL, .depth = 0, .ctxt = NULL };
+   char* subpath = NULL;
+   int tgtdepth = pathshift( ctxt, path, &(subpath), &(oppos), 1 );
+   if ( tgtdepth < 0 ) {
+      LOG( LOG_ERR, "Failed to identify target info for create op\n" );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   LOG( LOG_INFO, "TGT: Depth=%d, NS=\"%s\", SubPath=\"%s\"\n", tgtdepth, oppos.ns->idstr, subpath );
+   // check NS perms
+   if ( ( ctxt->itype != MARFS_INTERACTIVE  &&  !(oppos.ns->bperms & NS_READMETA) )  ||
+        ( ctxt->itype != MARFS_BATCH        &&  !(oppos.ns->iperms & NS_READMETA) ) ) {
+      LOG( LOG_ERR, "NS perms do not allow an open op\n" );
+      pathcleanup( subpath, &oppos );
+      errno = EPERM;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   if ( tgtdepth == 0 ) {
+      LOG( LOG_ERR, "Cannot target a MarFS NS with a create op\n" );
+      pathcleanup( subpath, &oppos );
+      errno = EISDIR;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   // check the state of our handle argument
+   char newstream = 0;
+   if ( stream == NULL ) {
+      // allocate a fresh handle
+      stream = malloc( sizeof( struct marfs_fhandle_struct ) );
+      if ( stream == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate a new marfs_fhandle struct\n" );
+         pathcleanup( subpath, &oppos );
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return NULL;
+      }
+      stream->ns = NULL;
+      stream->datastream = NULL;
+      stream->metahandle = NULL;
+      if ( pthread_mutex_init( &(stream->lock), NULL ) ) {
+         LOG( LOG_ERR, "Failed to initialize lock of new marfs_fhandle struct\n" );
+         free( stream );
+         pathcleanup( subpath, &oppos );
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return NULL;
+      }
+      newstream = 1;
+      // acquire the lock, just in case
+      if ( pthread_mutex_lock( &(stream->lock) ) ) {
+         LOG( LOG_ERR, "Failed to acquire lock on new marfs_fhandle\n" );
+         pthread_mutex_destroy( &(stream->lock) );
+         free( stream );
+         pathcleanup( subpath, &oppos );
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return NULL;
+      }
+   }
+   else {
+      // acquire the lock for an existing stream
+      if ( pthread_mutex_lock( &(stream->lock) ) ) {
+         LOG( LOG_ERR, "Failed to acquire marfs_fhandle lock\n" );
+         pathcleanup( subpath, &oppos );
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return NULL;
+      }
+      if ( stream->datastream == NULL  &&  stream->metahandle == NULL ) {
+         // a double-NULL handle has been flushed or suffered a fatal error
+         LOG( LOG_ERR, "Received a flushed marfs_fhandle\n" );
+         pthread_mutex_unlock( &(stream->lock) );
+         pathcleanup( subpath, &oppos );
+         errno = EINVAL;
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return NULL;
+      }
+      else if ( stream->datastream == NULL  &&  stream->metahandle != NULL ) {
+         // meta-only reference; attempt to close it
+         MDAL curmdal = stream->ns->prepo->metascheme.mdal;
+         if ( curmdal->close( stream->metahandle ) ) {
+            LOG( LOG_ERR, "Failed to close previous MDAL_FHANDLE\n" );
+            stream->metahandle = NULL;
+            pthread_mutex_unlock( &(stream->lock) );
+            pathcleanup( subpath, &oppos );
+            errno = EBADFD;
+            LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+            return NULL;
+         }
+         stream->metahandle = NULL; // don't reattempt this op
+      }
+   }
+   // duplicate the current NS ref
+   marfs_ns* dupref = config_duplicatensref( oppos.ns );
+   if ( dupref == NULL ) {
+      LOG( LOG_ERR, "Failed to duplicate op NS reference\n" );
+      pathcleanup( subpath, &oppos );
+      if ( !(newstream)  &&  stream->metahandle == NULL ) { errno = EBADFD; } // ref is now defunct
+      pthread_mutex_unlock( &(stream->lock) );
       if ( newstream ) { free( stream ); }
       LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
       return NULL;
@@ -2258,7 +2719,7 @@ marfs_fhandle marfs_open(marfs_ctxt ctxt, marfs_fhandle stream, const char *path
  *            of this call may indicate incomplete operations throughout the *entire* data
  *            stream referenced by this handle.
  */
-int marfs_close(marfs_fhandle stream) {
+static int untimed_marfs_close(marfs_fhandle stream) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( stream == NULL ) {
@@ -2323,7 +2784,7 @@ int marfs_close(marfs_fhandle stream) {
  *            of this call may indicate incomplete operations throughout the *entire* data
  *            stream referenced by this handle.
  */
-int marfs_release(marfs_fhandle stream) {
+static int untimed_marfs_release(marfs_fhandle stream) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( stream == NULL ) {
@@ -2379,7 +2840,7 @@ int marfs_release(marfs_fhandle stream) {
  *            of this call may indicate incomplete operations throughout the *entire* data
  *            stream referenced by this handle.
  */
-int marfs_flush(marfs_fhandle stream) {
+static int untimed_marfs_flush(marfs_fhandle stream) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( stream == NULL ) {
@@ -2431,7 +2892,7 @@ int marfs_flush(marfs_fhandle stream) {
  * @param const char* recovpath : New recovery path to be set
  * @return int : Zero on success, or -1 on failure
  */
-int marfs_setrecoverypath(marfs_ctxt ctxt, marfs_fhandle stream, const char* recovpath) {
+static int untimed_marfs_setrecoverypath(marfs_ctxt ctxt, marfs_fhandle stream, const char* recovpath) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( ctxt == NULL ) {
@@ -2504,7 +2965,7 @@ int marfs_setrecoverypath(marfs_ctxt ctxt, marfs_fhandle stream, const char* rec
  *            In such a case, errno will be set to EBADFD and any subsequent operations
  *            against the provided marfs_fhandle will fail, besides marfs_release().
  */
-ssize_t marfs_read(marfs_fhandle stream, void* buf, size_t count) {
+static ssize_t untimed_marfs_read(marfs_fhandle stream, void* buf, size_t count) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( stream == NULL ) {
@@ -2574,7 +3035,7 @@ ssize_t marfs_read(marfs_fhandle stream, void* buf, size_t count) {
  *            In such a case, errno will be set to EBADFD and any subsequent operations
  *            against the provided marfs_fhandle will fail, besides marfs_release().
  */
-ssize_t marfs_write(marfs_fhandle stream, const void* buf, size_t size) {
+static ssize_t untimed_marfs_write(marfs_fhandle stream, const void* buf, size_t size) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( stream == NULL ) {
@@ -2628,7 +3089,7 @@ ssize_t marfs_write(marfs_fhandle stream, const void* buf, size_t size) {
  *            In such a case, errno will be set to EBADFD and any subsequent operations
  *            against the provided marfs_fhandle will fail, besides marfs_release().
  */
-off_t marfs_seek(marfs_fhandle stream, off_t offset, int whence) {
+static off_t untimed_marfs_seek(marfs_fhandle stream, off_t offset, int whence) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( stream == NULL ) {
@@ -2695,7 +3156,7 @@ off_t marfs_seek(marfs_fhandle stream, off_t offset, int whence) {
  *            In such a case, errno will be set to EBADFD and any subsequent operations
  *            against the provided marfs_fhandle will fail, besides marfs_release().
  */
-ssize_t marfs_read_at_offset(marfs_fhandle stream, off_t offset, void* buf, size_t count) {
+static ssize_t untimed_marfs_read_at_offset(marfs_fhandle stream, off_t offset, void* buf, size_t count) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( stream == NULL ) {
@@ -2789,7 +3250,7 @@ ssize_t marfs_read_at_offset(marfs_fhandle stream, off_t offset, void* buf, size
  * @param size_t* size : Reference to be populated with the size of the target data chunk
  * @return int : Zero on success, or -1 on failure
  */
-int marfs_chunkbounds(marfs_fhandle stream, int chunknum, off_t* offset, size_t* size) {
+static int untimed_marfs_chunkbounds(marfs_fhandle stream, int chunknum, off_t* offset, size_t* size) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( stream == NULL ) {
@@ -2828,7 +3289,7 @@ int marfs_chunkbounds(marfs_fhandle stream, int chunknum, off_t* offset, size_t*
  * @param off_t length : Target total file length to truncate to
  * @return int : Zero on success, or -1 on failure
  */
-int marfs_ftruncate(marfs_fhandle stream, off_t length) {
+static int untimed_marfs_ftruncate(marfs_fhandle stream, off_t length) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( stream == NULL ) {
@@ -2902,7 +3363,7 @@ int marfs_ftruncate(marfs_fhandle stream, off_t length) {
  *            In such a case, errno will be set to EBADFD and any subsequent operations
  *            against the provided marfs_fhandle will fail, besides marfs_release().
  */
-int marfs_extend(marfs_fhandle stream, off_t length) {
+static int untimed_marfs_extend(marfs_fhandle stream, off_t length) {
    LOG( LOG_INFO, "ENTRY\n" );
    // check for NULL args
    if ( stream == NULL ) {
@@ -2935,3 +3396,743 @@ int marfs_extend(marfs_fhandle stream, off_t length) {
 }
 
 
+// ASYNCHRONOUS DATA OPS
+
+static int untimed_marfs_aqueue_term( marfs_aqueue queue );
+
+/**
+ * Execute the given asynchronous read op
+ * @param marfs_aop* op : Op to be executed ( result and error values are populated )
+ */
+static void aqueue_doread( marfs_aop* op ) {
+   marfs_fhandle stream = op->stream;
+   if ( stream == NULL ) {
+      LOG( LOG_ERR, "Received a NULL marfs_fhandle arg\n" );
+      op->result = -1;
+      op->error = EINVAL;
+      return;
+   }
+   if ( pthread_mutex_lock( &(stream->lock) ) ) {
+      LOG( LOG_ERR, "Failed to acquire marfs_fhandle lock\n" );
+      op->result = -1;
+      op->error = errno;
+      return;
+   }
+   if ( stream->datastream == NULL  ||  stream->datastream->type != READ_STREAM ) {
+      // direct reads and non-READ handles can only use the standard ( serialized ) path
+      pthread_mutex_unlock( &(stream->lock) );
+      op->result = untimed_marfs_read_at_offset( stream, op->offset, op->buf, op->count );
+      op->error = ( op->result < 0 ) ? errno : 0;
+      return;
+   }
+   // check NS perms
+   if ( ( stream->itype != MARFS_INTERACTIVE  &&  !(stream->ns->bperms & NS_READDATA) )  ||
+        ( stream->itype != MARFS_BATCH        &&  !(stream->ns->iperms & NS_READDATA) ) ) {
+      LOG( LOG_ERR, "NS perms do not allow a read op\n" );
+      pthread_mutex_unlock( &(stream->lock) );
+      op->result = -1;
+      op->error = EPERM;
+      return;
+   }
+   // capture the read target, then release the handle for use by other ops
+   DATASTREAM_PREAD req = datastream_preadprep( &(stream->datastream), op->offset, op->count );
+   pthread_mutex_unlock( &(stream->lock) );
+   if ( req == NULL ) {
+      LOG( LOG_ERR, "Failed to prepare read of %zu bytes at offset %zd\n", op->count, op->offset );
+      op->result = -1;
+      op->error = errno;
+      return;
+   }
+   op->result = datastream_pread( req, op->buf );
+   op->error = ( op->result < 0 ) ? errno : 0;
+}
+
+/**
+ * Asynchronous op worker thread ( executes ops of the queue until terminated )
+ * @param void* arg : Reference to the marfs_aqueue to be serviced
+ * @return void* : Always NULL
+ */
+static void* aqueue_worker( void* arg ) {
+   marfs_aqueue queue = (marfs_aqueue)arg;
+   pthread_mutex_lock( &(queue->lock) );
+   while ( 1 ) {
+      // locate the first op we are able to execute
+      //    reads are always available, but only the first pending write, and only if
+      //    no other write is still in progress
+      marfs_aop* prevop = NULL;
+      marfs_aop* op = queue->pending;
+      while ( op  &&  op->writing  &&  queue->writing ) {
+         prevop = op;
+         op = op->next;
+      }
+      if ( op == NULL ) {
+         if ( queue->terminate ) { break; }
+         pthread_cond_wait( &(queue->work), &(queue->lock) );
+         continue;
+      }
+      // remove the op from the pending list
+      if ( prevop ) { prevop->next = op->next; }
+      else { queue->pending = op->next; }
+      if ( queue->pendtail == op ) { queue->pendtail = prevop; }
+      op->next = NULL;
+      if ( op->writing ) { queue->writing = 1; }
+      pthread_mutex_unlock( &(queue->lock) );
+      // execute the op
+      if ( op->writing ) {
+         op->result = untimed_marfs_write( op->stream, op->buf, op->count );
+         op->error = ( op->result < 0 ) ? errno : 0;
+         stats_record( STATS_MARFS_AWRITE, op->statstart, ( op->result > 0 ) ? (size_t)op->result : 0, ( op->result < 0 ) );
+      }
+      else {
+         aqueue_doread( op );
+         stats_record( STATS_MARFS_AREAD, op->statstart, ( op->result > 0 ) ? (size_t)op->result : 0, ( op->result < 0 ) );
+      }
+      // append the op to the completion list
+      pthread_mutex_lock( &(queue->lock) );
+      if ( op->writing ) {
+         queue->writing = 0;
+         // the next write may now be picked up by any idle worker
+         pthread_cond_broadcast( &(queue->work) );
+      }
+      if ( queue->comptail ) { queue->comptail->next = op; }
+      else { queue->complete = op; }
+      queue->comptail = op;
+      queue->outstanding--;
+      pthread_cond_broadcast( &(queue->done) );
+   }
+   pthread_mutex_unlock( &(queue->lock) );
+   return NULL;
+}
+
+/**
+ * Append a new op to the pending list of the given queue
+ * @param marfs_aqueue queue : Queue to submit to
+ * @param marfs_aop* op : Op to be submitted
+ * @return int : Zero on success, or -1 on failure
+ */
+static int aqueue_submit( marfs_aqueue queue, marfs_aop* op ) {
+   if ( pthread_mutex_lock( &(queue->lock) ) ) {
+      LOG( LOG_ERR, "Failed to acquire marfs_aqueue lock\n" );
+      return -1;
+   }
+   if ( queue->pendtail ) { queue->pendtail->next = op; }
+   else { queue->pending = op; }
+   queue->pendtail = op;
+   queue->outstanding++;
+   pthread_cond_signal( &(queue->work) );
+   pthread_mutex_unlock( &(queue->lock) );
+   return 0;
+}
+
+/**
+ * Free all ops of the given list
+ * @param marfs_aop* oplist : List of ops to be freed
+ */
+static void aqueue_freeops( marfs_aop* oplist ) {
+   while ( oplist ) {
+      marfs_aop* nextop = oplist->next;
+      free( oplist );
+      oplist = nextop;
+   }
+}
+
+/**
+ * Initialize a new asynchronous op queue
+ * NOTE -- A single queue may be used for ops against any number of marfs_fhandles, but
+ *         should only be reaped ( see marfs_acomplete() ) by a single thread at a time.
+ * @param unsigned int depth : Maximum number of ops to be executed concurrently
+ * @return marfs_aqueue : Reference to the new queue, or NULL on failure
+ */
+static marfs_aqueue untimed_marfs_aqueue_init( unsigned int depth ) {
+   LOG( LOG_INFO, "ENTRY\n" );
+   if ( depth == 0 ) {
+      LOG( LOG_ERR, "Received a zero queue depth\n" );
+      errno = EINVAL;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   marfs_aqueue queue = calloc( 1, sizeof( struct marfs_aqueue_struct ) );
+   if ( queue == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new marfs_aqueue\n" );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   queue->threads = calloc( depth, sizeof( pthread_t ) );
+   if ( queue->threads == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate thread list of length %u\n", depth );
+      free( queue );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   if ( pthread_mutex_init( &(queue->lock), NULL ) ) {
+      LOG( LOG_ERR, "Failed to initialize marfs_aqueue lock\n" );
+      free( queue->threads );
+      free( queue );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   if ( pthread_cond_init( &(queue->work), NULL ) ) {
+      LOG( LOG_ERR, "Failed to initialize marfs_aqueue work condition\n" );
+      pthread_mutex_destroy( &(queue->lock) );
+      free( queue->threads );
+      free( queue );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   if ( pthread_cond_init( &(queue->done), NULL ) ) {
+      LOG( LOG_ERR, "Failed to initialize marfs_aqueue done condition\n" );
+      pthread_cond_destroy( &(queue->work) );
+      pthread_mutex_destroy( &(queue->lock) );
+      free( queue->threads );
+      free( queue );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return NULL;
+   }
+   for ( ; queue->threadcount < depth; queue->threadcount++ ) {
+      int createres = pthread_create( queue->threads + queue->threadcount, NULL, aqueue_worker, queue );
+      if ( createres ) {
+         LOG( LOG_ERR, "Failed to create marfs_aqueue worker thread %u\n", queue->threadcount );
+         int olderrno = createres;
+         untimed_marfs_aqueue_term( queue );
+         errno = olderrno;
+         LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+         return NULL;
+      }
+   }
+   LOG( LOG_INFO, "EXIT - Success\n" );
+   return queue;
+}
+
+/**
+ * Submit a read of the file referenced by the given marfs_fhandle to the given queue
+ * NOTE -- Unlike marfs_read(), the position of the marfs_fhandle is neither used nor
+ *         altered.  Any number of reads against the same marfs_fhandle may be in flight
+ *         at once, each reading from its own data object handles.
+ *         The buffer must remain valid until the op has been reaped.
+ * @param marfs_aqueue queue : Queue to submit the op to
+ * @param marfs_fhandle stream : marfs_fhandle to be read from
+ * @param off_t offset : Offset of the read, relative to the start of the file
+ * @param void* buf : Reference to the buffer to be populated with read data
+ * @param size_t count : Number of bytes to be read
+ * @param void* tag : Caller value, to be returned with the completion of this op
+ * @return int : Zero on successful submission, or -1 on failure
+ */
+static int untimed_marfs_aread( marfs_aqueue queue, marfs_fhandle stream, off_t offset, void* buf, size_t count, void* tag ) {
+   LOG( LOG_INFO, "ENTRY\n" );
+   // check for NULL args
+   if ( queue == NULL  ||  stream == NULL ) {
+      LOG( LOG_ERR, "Received a NULL marfs_aqueue / marfs_fhandle arg\n" );
+      errno = EINVAL;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   marfs_aop* op = calloc( 1, sizeof( struct marfs_aop_struct ) );
+   if ( op == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new read op\n" );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   op->stream = stream;
+   op->offset = offset;
+   op->buf = buf;
+   op->count = count;
+   op->tag = tag;
+   op->statstart = stats_start();
+   if ( aqueue_submit( queue, op ) ) {
+      free( op );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   LOG( LOG_INFO, "EXIT - Success\n" );
+   return 0;
+}
+
+/**
+ * Submit a write to the file referenced by the given marfs_fhandle to the given queue
+ * NOTE -- As with marfs_write(), data is written at the current position of the marfs_fhandle.
+ *         All writes submitted to the same queue are executed one at a time, in submission
+ *         order, though they may overlap with any number of reads.
+ *         The buffer must remain valid until the op has been reaped.
+ * @param marfs_aqueue queue : Queue to submit the op to
+ * @param marfs_fhandle stream : marfs_fhandle to be written to
+ * @param const void* buf : Reference to the buffer containing data to be written
+ * @param size_t count : Number of bytes to be written
+ * @param void* tag : Caller value, to be returned with the completion of this op
+ * @return int : Zero on successful submission, or -1 on failure
+ */
+static int untimed_marfs_awrite( marfs_aqueue queue, marfs_fhandle stream, const void* buf, size_t count, void* tag ) {
+   LOG( LOG_INFO, "ENTRY\n" );
+   // check for NULL args
+   if ( queue == NULL  ||  stream == NULL ) {
+      LOG( LOG_ERR, "Received a NULL marfs_aqueue / marfs_fhandle arg\n" );
+      errno = EINVAL;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   marfs_aop* op = calloc( 1, sizeof( struct marfs_aop_struct ) );
+   if ( op == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new write op\n" );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   op->writing = 1;
+   op->stream = stream;
+   op->buf = (void*)buf;
+   op->count = count;
+   op->tag = tag;
+   op->statstart = stats_start();
+   if ( aqueue_submit( queue, op ) ) {
+      free( op );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   LOG( LOG_INFO, "EXIT - Success\n" );
+   return 0;
+}
+
+/**
+ * Reap completed ops from the given queue
+ * @param marfs_aqueue queue : Queue to reap ops from
+ * @param marfs_acompletion* completions : Array to be populated with completion info
+ * @param size_t count : Length of the completions array
+ * @param char wait : If non-zero, wait for at least one op to complete ( unless none
+ *                    are outstanding )
+ * @return ssize_t : Number of completions populated, or -1 on failure
+ */
+static ssize_t untimed_marfs_acomplete( marfs_aqueue queue, marfs_acompletion* completions, size_t count, char wait ) {
+   // check for NULL args
+   if ( queue == NULL  ||  ( completions == NULL  &&  count ) ) {
+      LOG( LOG_ERR, "Received a NULL marfs_aqueue / completions arg\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( pthread_mutex_lock( &(queue->lock) ) ) {
+      LOG( LOG_ERR, "Failed to acquire marfs_aqueue lock\n" );
+      return -1;
+   }
+   while ( wait  &&  count  &&  queue->complete == NULL  &&  queue->outstanding ) {
+      pthread_cond_wait( &(queue->done), &(queue->lock) );
+   }
+   ssize_t reaped = 0;
+   while ( reaped < count  &&  queue->complete ) {
+      marfs_aop* op = queue->complete;
+      queue->complete = op->next;
+      if ( queue->comptail == op ) { queue->comptail = NULL; }
+      completions[reaped].tag = op->tag;
+      completions[reaped].result = op->result;
+      completions[reaped].error = op->error;
+      free( op );
+      reaped++;
+   }
+   pthread_mutex_unlock( &(queue->lock) );
+   return reaped;
+}
+
+/**
+ * Terminate the given queue, waiting for all submitted ops to complete
+ * NOTE -- Completions which have not been reaped are discarded.
+ * @param marfs_aqueue queue : Queue to be terminated
+ * @return int : Zero on success, or -1 on failure
+ */
+static int untimed_marfs_aqueue_term( marfs_aqueue queue ) {
+   LOG( LOG_INFO, "ENTRY\n" );
+   // check for NULL args
+   if ( queue == NULL ) {
+      LOG( LOG_ERR, "Received a NULL marfs_aqueue arg\n" );
+      errno = EINVAL;
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   if ( pthread_mutex_lock( &(queue->lock) ) ) {
+      LOG( LOG_ERR, "Failed to acquire marfs_aqueue lock\n" );
+      LOG( LOG_INFO, "EXIT - Failure w/ \"%s\"\n", strerror(errno) );
+      return -1;
+   }
+   // workers will only exit once no executable ops remain
+   queue->terminate = 1;
+   pthread_cond_broadcast( &(queue->work) );
+   pthread_mutex_unlock( &(queue->lock) );
+   unsigned int index = 0;
+   for ( ; index < queue->threadcount; index++ ) {
+      if ( pthread_join( queue->threads[index], NULL ) ) {
+         LOG( LOG_WARNING, "Failed to join marfs_aqueue worker thread %u\n", index );
+      }
+   }
+   // with no workers left, any pending ops could never be executed
+   if ( queue->pending ) {
+      LOG( LOG_WARNING, "Discarding %zu unexecuted ops\n", queue->outstanding );
+   }
+   aqueue_freeops( queue->pending );
+   aqueue_freeops( queue->complete );
+   pthread_cond_destroy( &(queue->done) );
+   pthread_cond_destroy( &(queue->work) );
+   pthread_mutex_destroy( &(queue->lock) );
+   free( queue->threads );
+   free( queue );
+   LOG( LOG_INFO, "EXIT - Success\n" );
+   return 0;
+}
+
+
+//   -------------   INSTRUMENTED EXTERNAL FUNCTIONS    -------------
+
+// Every external function is a thin wrapper around the matching 'untimed_' implementation
+// above, recording its latency ( and any data bytes moved ) via the stats interface.
+// See marfs_getstats() for retrieval of these values.
+
+marfs_ctxt marfs_init( const char* configpath, marfs_interface type, char verify ) {
+   uint64_t statstart = stats_start();
+   marfs_ctxt retval = untimed_marfs_init( configpath, type, verify );
+   stats_record( STATS_MARFS_INIT, statstart, 0, ( retval == NULL ) );
+   return retval;
+}
+
+int marfs_setctag( marfs_ctxt ctxt, const char* ctag ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_setctag( ctxt, ctag );
+   stats_record( STATS_MARFS_SETCTAG, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+size_t marfs_configver( marfs_ctxt ctxt, char* verstr, size_t len ) {
+   uint64_t statstart = stats_start();
+   size_t retval = untimed_marfs_configver( ctxt, verstr, len );
+   stats_record( STATS_MARFS_CONFIGVER, statstart, 0, ( retval == 0 ) );
+   return retval;
+}
+
+int marfs_term( marfs_ctxt ctxt ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_term( ctxt );
+   stats_record( STATS_MARFS_TERM, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+size_t marfs_mountpath( marfs_ctxt ctxt, char* mountstr, size_t len ) {
+   uint64_t statstart = stats_start();
+   size_t retval = untimed_marfs_mountpath( ctxt, mountstr, len );
+   stats_record( STATS_MARFS_MOUNTPATH, statstart, 0, ( retval == 0 ) );
+   return retval;
+}
+
+int marfs_access( marfs_ctxt ctxt, const char* path, int mode, int flags ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_access( ctxt, path, mode, flags );
+   stats_record( STATS_MARFS_ACCESS, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_stat( marfs_ctxt ctxt, const char* path, struct stat *buf, int flags ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_stat( ctxt, path, buf, flags );
+   stats_record( STATS_MARFS_STAT, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_chmod( marfs_ctxt ctxt, const char* path, mode_t mode, int flags ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_chmod( ctxt, path, mode, flags );
+   stats_record( STATS_MARFS_CHMOD, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_chown( marfs_ctxt ctxt, const char* path, uid_t uid, gid_t gid, int flags ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_chown( ctxt, path, uid, gid, flags );
+   stats_record( STATS_MARFS_CHOWN, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_rename( marfs_ctxt ctxt, const char* from, const char* to ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_rename( ctxt, from, to );
+   stats_record( STATS_MARFS_RENAME, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_symlink( marfs_ctxt ctxt, const char* target, const char* linkname ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_symlink( ctxt, target, linkname );
+   stats_record( STATS_MARFS_SYMLINK, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+ssize_t marfs_readlink( marfs_ctxt ctxt, const char* path, char* buf, size_t size ) {
+   uint64_t statstart = stats_start();
+   ssize_t retval = untimed_marfs_readlink( ctxt, path, buf, size );
+   stats_record( STATS_MARFS_READLINK, statstart, 0, ( retval < 0 ) );
+   return retval;
+}
+
+int marfs_unlink( marfs_ctxt ctxt, const char* path ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_unlink( ctxt, path );
+   stats_record( STATS_MARFS_UNLINK, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_link( marfs_ctxt ctxt, const char* oldpath, const char* newpath, int flags ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_link( ctxt, oldpath, newpath, flags );
+   stats_record( STATS_MARFS_LINK, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_utimens( marfs_ctxt ctxt, const char* path, const struct timespec times[2], int flags ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_utimens( ctxt, path, times, flags );
+   stats_record( STATS_MARFS_UTIMENS, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_mkdir( marfs_ctxt ctxt, const char* path, mode_t mode ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_mkdir( ctxt, path, mode );
+   stats_record( STATS_MARFS_MKDIR, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_rmdir( marfs_ctxt ctxt, const char* path ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_rmdir( ctxt, path );
+   stats_record( STATS_MARFS_RMDIR, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_statvfs( marfs_ctxt ctxt, const char* path, struct statvfs *buf ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_statvfs( ctxt, path, buf );
+   stats_record( STATS_MARFS_STATVFS, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_fstat( marfs_fhandle fh, struct stat* buf ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_fstat( fh, buf );
+   stats_record( STATS_MARFS_FSTAT, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_futimens( marfs_fhandle fh, const struct timespec times[2] ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_futimens( fh, times );
+   stats_record( STATS_MARFS_FUTIMENS, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_fsetxattr( marfs_fhandle fh, const char* name, const void* value, size_t size, int flags ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_fsetxattr( fh, name, value, size, flags );
+   stats_record( STATS_MARFS_FSETXATTR, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+ssize_t marfs_fgetxattr( marfs_fhandle fh, const char* name, void* value, size_t size ) {
+   uint64_t statstart = stats_start();
+   ssize_t retval = untimed_marfs_fgetxattr( fh, name, value, size );
+   stats_record( STATS_MARFS_FGETXATTR, statstart, 0, ( retval < 0 ) );
+   return retval;
+}
+
+int marfs_fremovexattr( marfs_fhandle fh, const char* name ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_fremovexattr( fh, name );
+   stats_record( STATS_MARFS_FREMOVEXATTR, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+ssize_t marfs_flistxattr( marfs_fhandle fh, char* buf, size_t size ) {
+   uint64_t statstart = stats_start();
+   ssize_t retval = untimed_marfs_flistxattr( fh, buf, size );
+   stats_record( STATS_MARFS_FLISTXATTR, statstart, 0, ( retval < 0 ) );
+   return retval;
+}
+
+marfs_dhandle marfs_opendir( marfs_ctxt ctxt, const char *path ) {
+   uint64_t statstart = stats_start();
+   marfs_dhandle retval = untimed_marfs_opendir( ctxt, path );
+   stats_record( STATS_MARFS_OPENDIR, statstart, 0, ( retval == NULL ) );
+   return retval;
+}
+
+struct dirent* marfs_readdir( marfs_dhandle dh ) {
+   uint64_t statstart = stats_start();
+   int origerrno = errno;
+   errno = 0;
+   struct dirent* retval = untimed_marfs_readdir( dh );
+   // a NULL result with an unchanged errno simply indicates the end of the directory
+   char failed = ( retval == NULL  &&  errno != 0 );
+   if ( errno == 0 ) { errno = origerrno; }
+   stats_record( STATS_MARFS_READDIR, statstart, 0, failed );
+   return retval;
+}
+
+ssize_t marfs_readdirplus( marfs_dhandle dh, marfs_direntplus* entries, size_t count ) {
+   uint64_t statstart = stats_start();
+   ssize_t retval = untimed_marfs_readdirplus( dh, entries, count );
+   stats_record( STATS_MARFS_READDIRPLUS, statstart, 0, ( retval < 0 ) );
+   return retval;
+}
+
+int marfs_closedir( marfs_dhandle dh ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_closedir( dh );
+   stats_record( STATS_MARFS_CLOSEDIR, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_chdir( marfs_ctxt ctxt, marfs_dhandle dh ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_chdir( ctxt, dh );
+   stats_record( STATS_MARFS_CHDIR, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_dsetxattr( marfs_dhandle dh, const char* name, const void* value, size_t size, int flags ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_dsetxattr( dh, name, value, size, flags );
+   stats_record( STATS_MARFS_DSETXATTR, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+ssize_t marfs_dgetxattr( marfs_dhandle dh, const char* name, void* value, size_t size ) {
+   uint64_t statstart = stats_start();
+   ssize_t retval = untimed_marfs_dgetxattr( dh, name, value, size );
+   stats_record( STATS_MARFS_DGETXATTR, statstart, 0, ( retval < 0 ) );
+   return retval;
+}
+
+int marfs_dremovexattr( marfs_dhandle dh, const char* name ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_dremovexattr( dh, name );
+   stats_record( STATS_MARFS_DREMOVEXATTR, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+ssize_t marfs_dlistxattr( marfs_dhandle dh, char* buf, size_t size ) {
+   uint64_t statstart = stats_start();
+   ssize_t retval = untimed_marfs_dlistxattr( dh, buf, size );
+   stats_record( STATS_MARFS_DLISTXATTR, statstart, 0, ( retval < 0 ) );
+   return retval;
+}
+
+marfs_fhandle marfs_creat( marfs_ctxt ctxt, marfs_fhandle stream, const char *path, mode_t mode ) {
+   uint64_t statstart = stats_start();
+   marfs_fhandle retval = untimed_marfs_creat( ctxt, stream, path, mode );
+   stats_record( STATS_MARFS_CREAT, statstart, 0, ( retval == NULL ) );
+   return retval;
+}
+
+ssize_t marfs_creat_batch( marfs_ctxt ctxt, marfs_fhandle* stream, const char* dirpath, const marfs_batchent* entries, size_t count ) {
+   uint64_t statstart = stats_start();
+   size_t bytes = 0;
+   ssize_t retval = untimed_marfs_creat_batch( ctxt, stream, dirpath, entries, count, &(bytes) );
+   stats_record( STATS_MARFS_CREAT_BATCH, statstart, bytes, ( retval < 0  ||  (size_t)retval < count ) );
+   return retval;
+}
+
+marfs_fhandle marfs_open( marfs_ctxt ctxt, marfs_fhandle stream, const char *path, marfs_flags flags ) {
+   uint64_t statstart = stats_start();
+   marfs_fhandle retval = untimed_marfs_open( ctxt, stream, path, flags );
+   stats_record( STATS_MARFS_OPEN, statstart, 0, ( retval == NULL ) );
+   return retval;
+}
+
+int marfs_close( marfs_fhandle stream ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_close( stream );
+   stats_record( STATS_MARFS_CLOSE, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_release( marfs_fhandle stream ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_release( stream );
+   stats_record( STATS_MARFS_RELEASE, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_flush( marfs_fhandle stream ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_flush( stream );
+   stats_record( STATS_MARFS_FLUSH, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_setrecoverypath( marfs_ctxt ctxt, marfs_fhandle stream, const char* recovpath ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_setrecoverypath( ctxt, stream, recovpath );
+   stats_record( STATS_MARFS_SETRECOVERYPATH, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+ssize_t marfs_read( marfs_fhandle stream, void* buf, size_t count ) {
+   uint64_t statstart = stats_start();
+   ssize_t retval = untimed_marfs_read( stream, buf, count );
+   stats_record( STATS_MARFS_READ, statstart, ( retval > 0 ) ? (size_t)retval : 0, ( retval < 0 ) );
+   return retval;
+}
+
+ssize_t marfs_write( marfs_fhandle stream, const void* buf, size_t size ) {
+   uint64_t statstart = stats_start();
+   ssize_t retval = untimed_marfs_write( stream, buf, size );
+   stats_record( STATS_MARFS_WRITE, statstart, ( retval > 0 ) ? (size_t)retval : 0, ( retval < 0 ) );
+   return retval;
+}
+
+off_t marfs_seek( marfs_fhandle stream, off_t offset, int whence ) {
+   uint64_t statstart = stats_start();
+   off_t retval = untimed_marfs_seek( stream, offset, whence );
+   stats_record( STATS_MARFS_SEEK, statstart, 0, ( retval < 0 ) );
+   return retval;
+}
+
+ssize_t marfs_read_at_offset( marfs_fhandle stream, off_t offset, void* buf, size_t count ) {
+   uint64_t statstart = stats_start();
+   ssize_t retval = untimed_marfs_read_at_offset( stream, offset, buf, count );
+   stats_record( STATS_MARFS_READ_AT_OFFSET, statstart, ( retval > 0 ) ? (size_t)retval : 0, ( retval < 0 ) );
+   return retval;
+}
+
+int marfs_chunkbounds( marfs_fhandle stream, int chunknum, off_t* offset, size_t* size ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_chunkbounds( stream, chunknum, offset, size );
+   stats_record( STATS_MARFS_CHUNKBOUNDS, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_ftruncate( marfs_fhandle stream, off_t length ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_ftruncate( stream, length );
+   stats_record( STATS_MARFS_FTRUNCATE, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+int marfs_extend( marfs_fhandle stream, off_t length ) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_marfs_extend( stream, length );
+   stats_record( STATS_MARFS_EXTEND, statstart, 0, ( retval != 0 ) );
+   return retval;
+}
+
+marfs_aqueue marfs_aqueue_init( unsigned int depth ) {
+   return untimed_marfs_aqueue_init( depth );
+}
+
+// NOTE -- asynchronous ops are recorded by the executing worker, upon completion, so their
+//         latency values cover the full span from submission to completion
+int marfs_aread( marfs_aqueue queue, marfs_fhandle stream, off_t offset, void* buf, size_t count, void* tag ) {
+   return untimed_marfs_aread( queue, stream, offset, buf, count, tag );
+}
+
+int marfs_awrite( marfs_aqueue queue, marfs_fhandle stream, const void* buf, size_t count, void* tag ) {
+   return untimed_marfs_awrite( queue, stream, buf, count, tag );
+}
+
+ssize_t marfs_acomplete( marfs_aqueue queue, marfs_acompletion* completions, size_t count, char wait ) {
+   return untimed_marfs_acomplete( queue, completions, count, wait );
+}
+
+int marfs_aqueue_term( marfs_aqueue queue ) {
+   return untimed_marfs_aqueue_term( queue );
+}
@@ -65,6 +65,8 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 */
 
 #include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
 #include <sys/statvfs.h>
 
 
@@ -83,6 +85,26 @@ typedef struct marfs_dhandle_struct *marfs_dhandle;
 
 typedef struct marfs_fhandle_struct *marfs_fhandle;
 
+typedef struct marfs_aqueue_struct *marfs_aqueue;
+
+typedef struct marfs_acompletion_struct {
+	void*   tag;    // caller tag value of the completed op ( as passed to marfs_aread() / marfs_awrite() )
+	ssize_t result; // return value of the op ( bytes read / written, or -1 on failure )
+	int     error;  // errno value of a failed op ( zero on success )
+} marfs_acompletion;
+
+typedef struct marfs_direntplus_struct {
+	struct dirent dent; // directory entry
+	struct stat   st;   // stat info of the entry ( as from marfs_stat() w/ AT_SYMLINK_NOFOLLOW )
+} marfs_direntplus;
+
+typedef struct marfs_batchent_struct {
+	const char* name; // name of the file to be created, within the target directory
+	mode_t      mode; // mode value of the file to be created
+	const void* buf;  // content of the file
+	size_t      size; // length of the file content
+} marfs_batchent;
+
 typedef enum
 {
 	MARFS_INTERACTIVE,
@@ -138,6 +160,23 @@ int marfs_setctag(marfs_ctxt ctxt, const char* ctag);
  */
 size_t marfs_configver(marfs_ctxt ctxt, char* verstr, size_t len);
 
+/**
+ * Populate the given string with a report of per-operation latency and byte counts
+ * NOTE -- These values are accumulated across every thread and marfs_ctxt of the process.
+ *         The report consists of a single header line, beginning with '#', followed by a
+ *         line for each tracked operation of the form :
+ *            <op-name> <count> <errors> <bytes> <total-ns> <max-ns> <p50-ns> <p90-ns> <p99-ns> <p999-ns>
+ * @param marfs_ctxt ctxt : marfs_ctxt to retrieve stats for
+ * @param char* statstr : String to be populated
+ * @param size_t len : Allocated length of the target string
+ * @return size_t : Length of the produced string ( excluding NULL-terminator ), or zero if
+ *                  an error occurred.
+ *                  NOTE -- if this value is >= the length of the provided buffer, this
+ *                  indicates that insufficint buffer space was provided and the resulting
+ *                  output string was truncated.
+ */
+size_t marfs_getstats(marfs_ctxt ctxt, char* statstr, size_t len);
+
 /**
  * Destroy the provided marfs_ctxt
  * @param marfs_ctxt ctxt : marfs_ctxt to be destroyed
@@ -392,6 +431,19 @@ marfs_dhandle marfs_opendir(marfs_ctxt ctxt, const char *path);
  */
 struct dirent *marfs_readdir(marfs_dhandle handle);
 
+/**
+ * Read a batch of entries, each with stat info, from an open directory handle
+ * NOTE -- Stat values match those produced by marfs_stat() with AT_SYMLINK_NOFOLLOW, but
+ *         without the cost of resolving the path of each entry.
+ *         Calls to this function may be freely intermixed with calls to marfs_readdir().
+ * @param marfs_dhandle dh : marfs_dhandle to read from
+ * @param marfs_direntplus* entries : Array of entries to be populated
+ * @param size_t count : Length of the entries array
+ * @return ssize_t : Count of populated entries, zero if all entries have been read,
+ *                   or -1 if a failure occurred
+ */
+ssize_t marfs_readdirplus(marfs_dhandle handle, marfs_direntplus* entries, size_t count);
+
 /**
  * Close the given directory handle
  * @param marfs_dhandle dh : marfs_dhandle to close
@@ -482,6 +534,28 @@ ssize_t marfs_dlistxattr(marfs_dhandle dh, char* buf, size_t size);
  */
 marfs_fhandle marfs_creat(marfs_ctxt ctxt, marfs_fhandle stream, const char *path, mode_t mode);
 
+/**
+ * Create and write out a batch of new MarFS files, all within the same directory, packing
+ * them into the given marfs_fhandle
+ * NOTE -- This is equivalent to a marfs_creat() + marfs_write() of each entry, in order.
+ *         However, the target directory, NS perms, and NS quotas are only checked once for
+ *         the entire batch ( quotas must allow for every entry ).
+ * @param marfs_ctxt ctxt : marfs_ctxt to operate relative to
+ * @param marfs_fhandle* stream : Reference to an existing marfs_fhandle, or to NULL
+ *                                ( see the 'stream' arg of marfs_creat() )
+ *                                This will be updated to reference the last created file.
+ * @param const char* dirpath : Path of the directory to create all files within
+ * @param const marfs_batchent* entries : Array of files to be created
+ *                                        NOTE -- entry names must not contain '/'
+ * @param size_t count : Length of the entries array
+ * @return ssize_t : Number of entries created and written, or -1 if none were
+ *                   NOTE -- if less than 'count', errno will indicate the failure cause
+ *    NOTE -- As with marfs_creat(), if a catastrophic error condition occurs, errno will be
+ *            set to EBADFD and any subsequent operations against the marfs_fhandle will fail,
+ *            besides marfs_release().
+ */
+ssize_t marfs_creat_batch(marfs_ctxt ctxt, marfs_fhandle* stream, const char* dirpath, const marfs_batchent* entries, size_t count);
+
 /**
  * Open an existing file
  * @param marfs_ctxt ctxt : marfs_ctxt to operate relative to
@@ -686,6 +760,67 @@ Note -- in the case of parallel writing the workflow can be thought of like this
 			marfs_creat( newpath, fhandle ... )
 */
 
+// ASYNCHRONOUS DATA OPS
+
+/**
+ * Initialize a new asynchronous op queue
+ * NOTE -- A single queue may be used for ops against any number of marfs_fhandles, but
+ *         should only be reaped ( see marfs_acomplete() ) by a single thread at a time.
+ * @param unsigned int depth : Maximum number of ops to be executed concurrently
+ * @return marfs_aqueue : Reference to the new queue, or NULL on failure
+ */
+marfs_aqueue marfs_aqueue_init(unsigned int depth);
+
+/**
+ * Submit a read of the file referenced by the given marfs_fhandle to the given queue
+ * NOTE -- Unlike marfs_read(), the position of the marfs_fhandle is neither used nor
+ *         altered.  Any number of reads against the same marfs_fhandle may be in flight
+ *         at once, each reading from its own data object handles.
+ *         The buffer must remain valid until the op has been reaped.
+ * @param marfs_aqueue queue : Queue to submit the op to
+ * @param marfs_fhandle stream : marfs_fhandle to be read from
+ * @param off_t offset : Offset of the read, relative to the start of the file
+ * @param void* buf : Reference to the buffer to be populated with read data
+ * @param size_t count : Number of bytes to be read
+ * @param void* tag : Caller value, to be returned with the completion of this op
+ * @return int : Zero on successful submission, or -1 on failure
+ */
+int marfs_aread(marfs_aqueue queue, marfs_fhandle stream, off_t offset, void* buf, size_t count, void* tag);
+
+/**
+ * Submit a write to the file referenced by the given marfs_fhandle to the given queue
+ * NOTE -- As with marfs_write(), data is written at the current position of the marfs_fhandle.
+ *         All writes submitted to the same queue are executed one at a time, in submission
+ *         order, though they may overlap with any number of reads.
+ *         The buffer must remain valid until the op has been reaped.
+ * @param marfs_aqueue queue : Queue to submit the op to
+ * @param marfs_fhandle stream : marfs_fhandle to be written to
+ * @param const void* buf : Reference to the buffer containing data to be written
+ * @param size_t count : Number of bytes to be written
+ * @param void* tag : Caller value, to be returned with the completion of this op
+ * @return int : Zero on successful submission, or -1 on failure
+ */
+int marfs_awrite(marfs_aqueue queue, marfs_fhandle stream, const void* buf, size_t count, void* tag);
+
+/**
+ * Reap completed ops from the given queue
+ * @param marfs_aqueue queue : Queue to reap ops from
+ * @param marfs_acompletion* completions : Array to be populated with completion info
+ * @param size_t count : Length of the completions array
+ * @param char wait : If non-zero, wait for at least one op to complete ( unless none
+ *                    are outstanding )
+ * @return ssize_t : Number of completions populated, or -1 on failure
+ */
+ssize_t marfs_acomplete(marfs_aqueue queue, marfs_acompletion* completions, size_t count, char wait);
+
+/**
+ * Terminate the given queue, waiting for all submitted ops to complete
+ * NOTE -- Completions which have not been reaped are discarded.
+ * @param marfs_aqueue queue : Queue to be terminated
+ * @return int : Zero on success, or -1 on failure
+ */
+int marfs_aqueue_term(marfs_aqueue queue);
+
 
 #ifdef __cplusplus
 }
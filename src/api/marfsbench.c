@@ -0,0 +1,682 @@
+/*
+Copyright (c) 2015, Los Alamos National Security, LLC
+All rights reserved.
+
+Copyright 2015.  Los Alamos National Security, LLC. This software was
+produced under U.S. Government contract DE-AC52-06NA25396 for Los
+Alamos National Laboratory (LANL), which is operated by Los Alamos
+National Security, LLC for the U.S. Department of Energy. The
+U.S. Government has rights to use, reproduce, and distribute this
+software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL SECURITY,
+LLC MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY
+FOR THE USE OF THIS SOFTWARE.  If software is modified to produce
+derivative works, such modified software should be clearly marked, so
+as not to confuse it with the version available from LANL.
+
+Additionally, redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the following
+conditions are met: 1. Redistributions of source code must retain the
+above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of Los Alamos National Security, LLC, Los Alamos
+National Laboratory, LANL, the U.S. Government, nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL LOS
+ALAMOS NATIONAL SECURITY, LLC OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-----
+NOTE:
+-----
+MarFS is released under the BSD license.
+
+MarFS was reviewed and released by LANL under Los Alamos Computer Code
+identifier: LA-CC-15-039.
+
+MarFS uses libaws4c for Amazon S3 object communication. The original
+version is at https://aws.amazon.com/code/Amazon-S3/2601 and under the
+LGPL license.  LANL added functionality to the original work. The
+original work plus LANL contributions is found at
+https://github.com/jti-lanl/aws4c.
+
+GNU licenses can be found at http://www.gnu.org/licenses/.
+*/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // for nftw() and its FTW_* flags
+#endif
+
+#include "marfs_auto_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <time.h>
+#include <limits.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "marfs.h"
+#include "config/config.h"
+
+#define PROGNAME "marfs-bench"
+#define OUTPREFX PROGNAME ": "
+
+#define MOUNT_TOP "/campaign"
+#define MiB ( 1024.0 * 1024.0 )
+
+
+typedef struct benchopts_struct {
+   const char* workparent;  // parent dir of the throwaway bench tree
+   size_t      filecount;   // count of files for create / stat / readdir / packed tests
+   size_t      streambytes; // total bytes for the streaming read/write tests
+   size_t      iosize;      // size of each individual read/write call
+   size_t      packsize;    // size of each file in the packed small-file test
+   int         N;           // data blocks per object
+   int         E;           // erasure blocks per object
+   const char* rmanpath;    // path of the marfs-rman executable ( NULL to skip the sweep test )
+   char        keep;        // if set, the bench tree will be left behind for inspection
+} benchopts;
+
+typedef struct benchstate_struct {
+   benchopts   opts;
+   char*       topdir;  // throwaway tree root
+   char*       cfgpath; // generated config file
+   marfs_ctxt  ctxt;
+   void*       iobuf;
+} benchstate;
+
+
+void print_usage_info() {
+   printf( "\n"
+           PROGNAME " [-d Work-Parent] [-n File-Count] [-s Stream-MiB] [-b IO-KiB] [-p Pack-Bytes]\n"
+           "            [-N Data-Blocks] [-E Erasure-Blocks] [-m Rman-Path] [-M] [-k] [-h]\n"
+           "\n"
+           " Arguments --\n"
+           "  -d Work-Parent   : Dir beneath which a throwaway MarFS tree ( posix MDAL + posix DAL )\n"
+           "                     will be created ( defaults to \"/tmp\" )\n"
+           "  -n File-Count    : Count of files for the create / stat / readdir / packed tests\n"
+           "                     ( defaults to 1000 )\n"
+           "  -s Stream-MiB    : MiB to write and read back for the streaming tests ( defaults to 256 )\n"
+           "  -b IO-KiB        : KiB per read / write call ( defaults to 1024 )\n"
+           "  -p Pack-Bytes    : Size of each file in the packed small-file test ( defaults to 4096 )\n"
+           "  -N Data-Blocks   : Data blocks per object ( defaults to 4 )\n"
+           "  -E Erasure-Blocks: Erasure blocks per object ( defaults to 1 )\n"
+           "  -m Rman-Path     : Path of the marfs-rman executable for the sweep test\n"
+           "                     ( defaults to \"marfs-rman\", located via PATH )\n"
+           "  -M               : Skip the marfs-rman sweep test\n"
+           "  -k               : Keep the bench tree, rather than deleting it on exit\n"
+           "  -h               : Print this usage info\n"
+           "\n"
+           " Output --\n"
+           "  One CSV record per test is printed to stdout, preceded by a header line.\n"
+           "  All progress and error info is printed to stderr.\n"
+           "\n" );
+}
+
+/**
+ * Return the current monotonic time, in seconds
+ * @return double : Current time
+ */
+double curtime( void ) {
+   struct timespec ts;
+   clock_gettime( CLOCK_MONOTONIC, &ts );
+   return (double)ts.tv_sec + ( (double)ts.tv_nsec / 1000000000.0 );
+}
+
+/**
+ * Print a single machine-readable result record
+ * @param const char* test : Name of the test
+ * @param size_t ops : Count of operations performed
+ * @param size_t bytes : Count of data bytes transferred ( zero for metadata-only tests )
+ * @param double secs : Elapsed time of the test
+ */
+void report( const char* test, size_t ops, size_t bytes, double secs ) {
+   if ( secs <= 0.0 ) { secs = 1.0 / 1000000000.0; }
+   printf( "%s,%zu,%zu,%.6f,%.2f,%.2f\n", test, ops, bytes, secs,
+           (double)ops / secs, ( (double)bytes / MiB ) / secs );
+   fflush( stdout );
+}
+
+/**
+ * Write out a throwaway MarFS config, rooted at the given dir
+ * @param benchstate* state : Bench state, with topdir populated
+ * @return int : Zero on success, or -1 on failure
+ */
+int writeconfig( benchstate* state ) {
+   size_t pathlen = strlen( state->topdir ) + strlen( "/config.xml" ) + 1;
+   state->cfgpath = malloc( sizeof(char) * pathlen );
+   if ( state->cfgpath == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to allocate config path\n" );
+      return -1;
+   }
+   snprintf( state->cfgpath, pathlen, "%s/config.xml", state->topdir );
+   FILE* cfgfile = fopen( state->cfgpath, "w" );
+   if ( cfgfile == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to open config file \"%s\" (%s)\n", state->cfgpath, strerror(errno) );
+      return -1;
+   }
+   // use the smallest objects which still allow the full stream to be chunked across several objects
+   fprintf( cfgfile,
+            "<marfs_config version=\"0.0001-bench-notarealversion\">\n"
+            "   <mnt_top>" MOUNT_TOP "</mnt_top>\n"
+            "   <hosts> ... </hosts>\n"
+            "   <repo name=\"benchREPO\">\n"
+            "      <data>\n"
+            "         <protection>\n"
+            "            <N>%d</N>\n"
+            "            <E>%d</E>\n"
+            "            <PSZ>4096</PSZ>\n"
+            "         </protection>\n"
+            "         <packing enabled=\"yes\">\n"
+            "            <max_files>4096</max_files>\n"
+            "         </packing>\n"
+            "         <chunking enabled=\"yes\">\n"
+            "            <max_size>64M</max_size>\n"
+            "         </chunking>\n"
+            "         <distribution>\n"
+            "            <pods cnt=\"1\"/>\n"
+            "            <caps cnt=\"1\"/>\n"
+            "            <scatters cnt=\"16\"/>\n"
+            "         </distribution>\n"
+            "         <DAL type=\"posix\">\n"
+            "            <dir_template>pod{p}/cap{c}/scat{s}/block{b}/</dir_template>\n"
+            "            <sec_root>%s/dal_root</sec_root>\n"
+            "         </DAL>\n"
+            "      </data>\n"
+            "      <meta>\n"
+            "         <namespaces rbreadth=\"10\" rdepth=\"2\" rdigits=\"3\">\n"
+            "            <ns name=\"root\">\n"
+            "               <perms>\n"
+            "                  <interactive>RM,WM,RD,WD</interactive>\n"
+            "                  <batch>RM,WM,RD,WD</batch>\n"
+            "               </perms>\n"
+            "            </ns>\n"
+            "         </namespaces>\n"
+            "         <MDAL type=\"posix\">\n"
+            "            <ns_root>%s/mdal_root</ns_root>\n"
+            "         </MDAL>\n"
+            "      </meta>\n"
+            "   </repo>\n"
+            "</marfs_config>\n",
+            state->opts.N, state->opts.E, state->topdir, state->topdir );
+   if ( fclose( cfgfile ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to close config file \"%s\" (%s)\n", state->cfgpath, strerror(errno) );
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Create the throwaway bench tree, write out its config, and initialize a MarFS ctxt
+ * @param benchstate* state : Bench state, with opts populated
+ * @return int : Zero on success, or -1 on failure
+ */
+int setupbench( benchstate* state ) {
+   size_t pathlen = strlen( state->opts.workparent ) + strlen( "/" PROGNAME ".XXXXXX" ) + 1;
+   state->topdir = malloc( sizeof(char) * pathlen );
+   if ( state->topdir == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to allocate top dir path\n" );
+      return -1;
+   }
+   snprintf( state->topdir, pathlen, "%s/" PROGNAME ".XXXXXX", state->opts.workparent );
+   if ( mkdtemp( state->topdir ) == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to create bench tree beneath \"%s\" (%s)\n",
+               state->opts.workparent, strerror(errno) );
+      free( state->topdir );
+      state->topdir = NULL;
+      return -1;
+   }
+   char subpath[PATH_MAX];
+   snprintf( subpath, PATH_MAX, "%s/dal_root", state->topdir );
+   if ( mkdir( subpath, S_IRWXU ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to create \"%s\" (%s)\n", subpath, strerror(errno) );
+      return -1;
+   }
+   snprintf( subpath, PATH_MAX, "%s/mdal_root", state->topdir );
+   if ( mkdir( subpath, S_IRWXU ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to create \"%s\" (%s)\n", subpath, strerror(errno) );
+      return -1;
+   }
+   if ( writeconfig( state ) ) { return -1; }
+   // verify the config, creating all NS / reference / DAL dirs
+   marfs_config* verconf = config_init( state->cfgpath );
+   if ( verconf == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to parse generated config \"%s\"\n", state->cfgpath );
+      return -1;
+   }
+   if ( config_verify( verconf, ".", 1, 1, 1, 1 ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to verify generated config \"%s\"\n", state->cfgpath );
+      config_term( verconf );
+      return -1;
+   }
+   config_term( verconf );
+   state->ctxt = marfs_init( state->cfgpath, MARFS_BATCH, 0 );
+   if ( state->ctxt == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to initialize MarFS ctxt (%s)\n", strerror(errno) );
+      return -1;
+   }
+   if ( marfs_setctag( state->ctxt, PROGNAME ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to set client tag (%s)\n", strerror(errno) );
+      return -1;
+   }
+   if ( marfs_mkdir( state->ctxt, MOUNT_TOP "/create", 0755 )  ||
+        marfs_mkdir( state->ctxt, MOUNT_TOP "/packed", 0755 ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to create bench dirs (%s)\n", strerror(errno) );
+      return -1;
+   }
+   state->iobuf = malloc( state->opts.iosize );
+   if ( state->iobuf == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to allocate %zu byte IO buffer\n", state->opts.iosize );
+      return -1;
+   }
+   size_t index;
+   for ( index = 0; index < state->opts.iosize; index++ ) {
+      *((char*)( state->iobuf + index )) = (char)index;
+   }
+   return 0;
+}
+
+/**
+ * Time creation ( and completion ) of filecount empty files, each in its own stream
+ * @param benchstate* state : Bench state
+ * @return int : Zero on success, or -1 on failure
+ */
+int bench_create( benchstate* state ) {
+   char path[PATH_MAX];
+   size_t index;
+   double start = curtime();
+   for ( index = 0; index < state->opts.filecount; index++ ) {
+      snprintf( path, PATH_MAX, MOUNT_TOP "/create/file%zu", index );
+      marfs_fhandle fh = marfs_creat( state->ctxt, NULL, path, 0644 );
+      if ( fh == NULL ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to create \"%s\" (%s)\n", path, strerror(errno) );
+         return -1;
+      }
+      if ( marfs_close( fh ) ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to close \"%s\" (%s)\n", path, strerror(errno) );
+         return -1;
+      }
+   }
+   report( "create", state->opts.filecount, 0, curtime() - start );
+   return 0;
+}
+
+/**
+ * Time stat of every file produced by bench_create()
+ * @param benchstate* state : Bench state
+ * @return int : Zero on success, or -1 on failure
+ */
+int bench_stat( benchstate* state ) {
+   char path[PATH_MAX];
+   struct stat st;
+   size_t index;
+   double start = curtime();
+   for ( index = 0; index < state->opts.filecount; index++ ) {
+      snprintf( path, PATH_MAX, MOUNT_TOP "/create/file%zu", index );
+      if ( marfs_stat( state->ctxt, path, &st, 0 ) ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to stat \"%s\" (%s)\n", path, strerror(errno) );
+         return -1;
+      }
+   }
+   report( "stat", state->opts.filecount, 0, curtime() - start );
+   return 0;
+}
+
+/**
+ * Time a full listing of the dir populated by bench_create()
+ * @param benchstate* state : Bench state
+ * @return int : Zero on success, or -1 on failure
+ */
+int bench_readdir( benchstate* state ) {
+   size_t entries = 0;
+   double start = curtime();
+   marfs_dhandle dh = marfs_opendir( state->ctxt, MOUNT_TOP "/create" );
+   if ( dh == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to open bench create dir (%s)\n", strerror(errno) );
+      return -1;
+   }
+   errno = 0;
+   struct dirent* dent;
+   while ( (dent = marfs_readdir( dh )) != NULL ) { entries++; errno = 0; }
+   if ( errno ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to read bench create dir (%s)\n", strerror(errno) );
+      marfs_closedir( dh );
+      return -1;
+   }
+   if ( marfs_closedir( dh ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to close bench create dir (%s)\n", strerror(errno) );
+      return -1;
+   }
+   report( "readdir", entries, 0, curtime() - start );
+   return 0;
+}
+
+/**
+ * Time a full listing, with attributes, of the dir populated by bench_create()
+ * @param benchstate* state : Bench state
+ * @return int : Zero on success, or -1 on failure
+ */
+int bench_readdirplus( benchstate* state ) {
+   size_t entries = 0;
+   marfs_direntplus dents[64];
+   double start = curtime();
+   marfs_dhandle dh = marfs_opendir( state->ctxt, MOUNT_TOP "/create" );
+   if ( dh == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to open bench create dir (%s)\n", strerror(errno) );
+      return -1;
+   }
+   ssize_t dentcount;
+   while ( (dentcount = marfs_readdirplus( dh, dents, 64 )) > 0 ) { entries += dentcount; }
+   if ( dentcount < 0 ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to read bench create dir (%s)\n", strerror(errno) );
+      marfs_closedir( dh );
+      return -1;
+   }
+   if ( marfs_closedir( dh ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to close bench create dir (%s)\n", strerror(errno) );
+      return -1;
+   }
+   report( "readdirplus", entries, 0, curtime() - start );
+   return 0;
+}
+
+/**
+ * Time a single streaming write of streambytes, followed by a streaming read of the same file
+ * @param benchstate* state : Bench state
+ * @return int : Zero on success, or -1 on failure
+ */
+int bench_stream( benchstate* state ) {
+   const char* path = MOUNT_TOP "/streamfile";
+   size_t remaining = state->opts.streambytes;
+   double start = curtime();
+   marfs_fhandle fh = marfs_creat( state->ctxt, NULL, path, 0644 );
+   if ( fh == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to create \"%s\" (%s)\n", path, strerror(errno) );
+      return -1;
+   }
+   while ( remaining ) {
+      size_t iosize = ( remaining < state->opts.iosize ) ? remaining : state->opts.iosize;
+      if ( marfs_write( fh, state->iobuf, iosize ) != (ssize_t)iosize ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to write to \"%s\" (%s)\n", path, strerror(errno) );
+         marfs_release( fh );
+         return -1;
+      }
+      remaining -= iosize;
+   }
+   if ( marfs_close( fh ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to close \"%s\" (%s)\n", path, strerror(errno) );
+      return -1;
+   }
+   report( "stream_write", ( state->opts.streambytes + state->opts.iosize - 1 ) / state->opts.iosize,
+           state->opts.streambytes, curtime() - start );
+
+   size_t readbytes = 0;
+   size_t readops = 0;
+   start = curtime();
+   fh = marfs_open( state->ctxt, NULL, path, MARFS_READ );
+   if ( fh == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to open \"%s\" for read (%s)\n", path, strerror(errno) );
+      return -1;
+   }
+   ssize_t readres;
+   while ( (readres = marfs_read( fh, state->iobuf, state->opts.iosize )) > 0 ) {
+      readbytes += readres;
+      readops++;
+   }
+   if ( readres < 0 ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to read from \"%s\" (%s)\n", path, strerror(errno) );
+      marfs_release( fh );
+      return -1;
+   }
+   if ( marfs_close( fh ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to close read handle of \"%s\" (%s)\n", path, strerror(errno) );
+      return -1;
+   }
+   double elapsed = curtime() - start;
+   if ( readbytes != state->opts.streambytes ) {
+      fprintf( stderr, OUTPREFX "ERROR: Read back %zu bytes of \"%s\", but expected %zu\n",
+               readbytes, path, state->opts.streambytes );
+      return -1;
+   }
+   report( "stream_read", readops, readbytes, elapsed );
+   return 0;
+}
+
+/**
+ * Time creation of filecount small files, all packed into shared streams
+ * @param benchstate* state : Bench state
+ * @return int : Zero on success, or -1 on failure
+ */
+int bench_packed( benchstate* state ) {
+   char path[PATH_MAX];
+   size_t packsize = ( state->opts.packsize < state->opts.iosize ) ? state->opts.packsize : state->opts.iosize;
+   marfs_fhandle fh = NULL;
+   size_t index;
+   double start = curtime();
+   for ( index = 0; index < state->opts.filecount; index++ ) {
+      snprintf( path, PATH_MAX, MOUNT_TOP "/packed/file%zu", index );
+      marfs_fhandle newfh = marfs_creat( state->ctxt, fh, path, 0644 );
+      if ( newfh == NULL ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to create \"%s\" (%s)\n", path, strerror(errno) );
+         if ( fh ) { marfs_release( fh ); }
+         return -1;
+      }
+      fh = newfh;
+      if ( packsize  &&  marfs_write( fh, state->iobuf, packsize ) != (ssize_t)packsize ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to write to \"%s\" (%s)\n", path, strerror(errno) );
+         marfs_release( fh );
+         return -1;
+      }
+   }
+   if ( fh  &&  marfs_close( fh ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to close final packed file (%s)\n", strerror(errno) );
+      return -1;
+   }
+   report( "packed_create", state->opts.filecount, packsize * state->opts.filecount, curtime() - start );
+   return 0;
+}
+
+/**
+ * Time a dry-run marfs-rman sweep ( quota + GC scan ) over every file produced by prior tests
+ * @param benchstate* state : Bench state
+ * @return int : Zero on success, or -1 on failure
+ */
+int bench_rman( benchstate* state ) {
+   char logroot[PATH_MAX];
+   snprintf( logroot, PATH_MAX, "%s/rman_logs", state->topdir );
+   // every create produced a single stream, plus one streaming file and the packed files
+   size_t filecount = ( state->opts.filecount * 2 ) + 1;
+   double start = curtime();
+   pid_t child = fork();
+   if ( child < 0 ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to fork for marfs-rman (%s)\n", strerror(errno) );
+      return -1;
+   }
+   if ( child == 0 ) {
+      // keep rman output out of our result stream
+      int nullfd = open( "/dev/null", O_WRONLY );
+      if ( nullfd >= 0 ) { dup2( nullfd, STDOUT_FILENO ); close( nullfd ); }
+      execlp( state->opts.rmanpath, state->opts.rmanpath, "-c", state->cfgpath, "-n", ".", "-r",
+              "-l", logroot, "-d", "-Q", "-G", "-T", "G0", (char*)NULL );
+      fprintf( stderr, OUTPREFX "ERROR: Failed to exec \"%s\" (%s)\n", state->opts.rmanpath, strerror(errno) );
+      _exit( 127 );
+   }
+   int status = 0;
+   if ( waitpid( child, &status, 0 ) != child ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to wait on marfs-rman (%s)\n", strerror(errno) );
+      return -1;
+   }
+   double elapsed = curtime() - start;
+   if ( !WIFEXITED(status)  ||  WEXITSTATUS(status) ) {
+      fprintf( stderr, OUTPREFX "ERROR: marfs-rman sweep failed ( status = %d )\n", status );
+      return -1;
+   }
+   report( "rman_sweep", filecount, 0, elapsed );
+   return 0;
+}
+
+int deletetgt( const char* fpath, const struct stat* sb, int typeflag, struct FTW* ftwbuf ) {
+   if ( remove( fpath ) ) {
+      fprintf( stderr, OUTPREFX "WARNING: Failed to delete \"%s\" (%s)\n", fpath, strerror(errno) );
+   }
+   return 0;
+}
+
+/**
+ * Terminate the MarFS ctxt and delete the bench tree ( unless it is to be kept )
+ * @param benchstate* state : Bench state
+ */
+void cleanupbench( benchstate* state ) {
+   if ( state->ctxt  &&  marfs_term( state->ctxt ) ) {
+      fprintf( stderr, OUTPREFX "WARNING: Failed to terminate MarFS ctxt (%s)\n", strerror(errno) );
+   }
+   if ( state->topdir ) {
+      if ( state->opts.keep ) {
+         fprintf( stderr, OUTPREFX "Bench tree retained at \"%s\"\n", state->topdir );
+      }
+      else {
+         nftw( state->topdir, deletetgt, 64, FTW_DEPTH | FTW_PHYS );
+      }
+      free( state->topdir );
+   }
+   if ( state->cfgpath ) { free( state->cfgpath ); }
+   if ( state->iobuf ) { free( state->iobuf ); }
+}
+
+/**
+ * Parse a positive size value from the given arg string
+ * @param const char* arg : Argument string
+ * @param char flag : Argument flag, for error output
+ * @param size_t* val : Reference to be populated with the parsed value
+ * @return int : Zero on success, or -1 on failure
+ */
+int parsesize( const char* arg, char flag, size_t* val ) {
+   char* endptr = NULL;
+   errno = 0;
+   unsigned long long parseval = strtoull( arg, &(endptr), 10 );
+   if ( errno  ||  endptr == NULL  ||  *endptr != '\0'  ||  endptr == arg ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to parse '-%c' argument value: \"%s\"\n", flag, arg );
+      return -1;
+   }
+   *val = (size_t)parseval;
+   return 0;
+}
+
+
+int main( int argc, char** argv ) {
+   benchstate state;
+   bzero( &(state), sizeof( struct benchstate_struct ) );
+   state.opts.workparent = "/tmp";
+   state.opts.filecount = 1000;
+   state.opts.streambytes = 256 * 1024 * 1024;
+   state.opts.iosize = 1024 * 1024;
+   state.opts.packsize = 4096;
+   state.opts.N = 4;
+   state.opts.E = 1;
+   state.opts.rmanpath = "marfs-rman";
+
+   // parse all position-independent arguments
+   char pr_usage = 0;
+   size_t parseval = 0;
+   int c;
+   while ((c = getopt(argc, (char* const*)argv, "d:n:s:b:p:N:E:m:Mkh")) != -1) {
+      switch (c) {
+      case 'd':
+         state.opts.workparent = optarg;
+         break;
+      case 'n':
+         if ( parsesize( optarg, c, &(state.opts.filecount) ) ) { pr_usage = 1; }
+         break;
+      case 's':
+         if ( parsesize( optarg, c, &(parseval) ) ) { pr_usage = 1; }
+         state.opts.streambytes = parseval * 1024 * 1024;
+         break;
+      case 'b':
+         if ( parsesize( optarg, c, &(parseval) ) ) { pr_usage = 1; }
+         state.opts.iosize = parseval * 1024;
+         break;
+      case 'p':
+         if ( parsesize( optarg, c, &(state.opts.packsize) ) ) { pr_usage = 1; }
+         break;
+      case 'N':
+         if ( parsesize( optarg, c, &(parseval) ) ) { pr_usage = 1; }
+         state.opts.N = (int)parseval;
+         break;
+      case 'E':
+         if ( parsesize( optarg, c, &(parseval) ) ) { pr_usage = 1; }
+         state.opts.E = (int)parseval;
+         break;
+      case 'm':
+         state.opts.rmanpath = optarg;
+         break;
+      case 'M':
+         state.opts.rmanpath = NULL;
+         break;
+      case 'k':
+         state.opts.keep = 1;
+         break;
+      case '?':
+         fprintf( stderr, OUTPREFX "ERROR: Unrecognized cmdline argument: \'%c\'\n", optopt );
+      case 'h': // note fallthrough from above
+         pr_usage = 1;
+         break;
+      default:
+         fprintf( stderr, OUTPREFX "ERROR: Failed to parse command line options\n" );
+         return -1;
+      }
+   }
+   if ( pr_usage == 0  &&  ( state.opts.iosize == 0  ||  state.opts.N < 1 ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: IO size and data block count must both be non-zero\n" );
+      pr_usage = 1;
+   }
+   if ( pr_usage ) {
+      print_usage_info();
+      return -1;
+   }
+
+   int retval = 0;
+   if ( setupbench( &(state) ) ) {
+      cleanupbench( &(state) );
+      return -1;
+   }
+   printf( "test,ops,bytes,seconds,ops_per_sec,mib_per_sec\n" );
+   if ( bench_create( &(state) )  ||  bench_stat( &(state) )  ||  bench_readdir( &(state) )  ||
+        bench_readdirplus( &(state) )  ||  bench_stream( &(state) )  ||  bench_packed( &(state) ) ) {
+      retval = -1;
+   }
+   // the rman sweep requires a fully terminated ctxt, to ensure all files are complete
+   if ( marfs_term( state.ctxt ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to terminate MarFS ctxt (%s)\n", strerror(errno) );
+      retval = -1;
+   }
+   state.ctxt = NULL;
+   if ( retval == 0  &&  state.opts.rmanpath  &&  bench_rman( &(state) ) ) {
+      retval = -1;
+   }
+   cleanupbench( &(state) );
+   return retval;
+}
+
@@ -0,0 +1,581 @@
+/*
+Copyright (c) 2015, Los Alamos National Security, LLC
+All rights reserved.
+
+Copyright 2015.  Los Alamos National Security, LLC. This software was
+produced under U.S. Government contract DE-AC52-06NA25396 for Los
+Alamos National Laboratory (LANL), which is operated by Los Alamos
+National Security, LLC for the U.S. Department of Energy. The
+U.S. Government has rights to use, reproduce, and distribute this
+software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL SECURITY,
+LLC MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY
+FOR THE USE OF THIS SOFTWARE.  If software is modified to produce
+derivative works, such modified software should be clearly marked, so
+as not to confuse it with the version available from LANL.
+
+Additionally, redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the following
+conditions are met: 1. Redistributions of source code must retain the
+above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of Los Alamos National Security, LLC, Los Alamos
+National Laboratory, LANL, the U.S. Government, nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL LOS
+ALAMOS NATIONAL SECURITY, LLC OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-----
+NOTE:
+-----
+MarFS is released under the BSD license.
+
+MarFS was reviewed and released by LANL under Los Alamos Computer Code
+identifier: LA-CC-15-039.
+
+MarFS uses libaws4c for Amazon S3 object communication. The original
+version is at https://aws.amazon.com/code/Amazon-S3/2601 and under the
+LGPL license.  LANL added functionality to the original work. The
+original work plus LANL contributions is found at
+https://github.com/jti-lanl/aws4c.
+
+GNU licenses can be found at http://www.gnu.org/licenses/.
+*/
+
+#include "marfs_auto_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <mpi.h>
+
+#include "marfs.h"
+
+#define PROGNAME "marfs-pcp"
+#define OUTPREFX PROGNAME ": "
+
+#define DEFAULT_THREAD_COUNT 4
+#define DEFAULT_BUFFER_SIZE ( 16 * 1024 * 1024 )
+
+
+typedef struct pcpstate_struct {
+   // static values, set prior to thread creation
+   marfs_ctxt  ctxt;
+   const char* srcpath;
+   const char* dstpath;
+   char        reverse;     // if set, copy from MarFS to POSIX, rather than the inverse
+   int         posixfd;     // POSIX source / destination file
+   size_t      buffersize;  // size of each thread's IO buffer
+   size_t      chunkcount;  // total count of chunks in the MarFS file
+   size_t      chunkstride; // step between chunks claimed by this process ( MPI rank count )
+   // shared values
+   pthread_mutex_t lock;
+   size_t      nextchunk;   // next chunk to be claimed by a thread of this process
+   size_t      bytesmoved;  // total bytes copied by this process
+   char        failed;      // set if any thread encountered an error
+} pcpstate;
+
+
+void print_usage_info() {
+   printf( "\n"
+           PROGNAME " [-c MarFS-Config-File] [-t Thread-Count] [-b Buffer-MiB] [-r] [-m] [-h]\n"
+           "          Source-Path Dest-Path\n"
+           "\n"
+           " Copy a single large file into ( or, with '-r', out of ) MarFS, with each data chunk\n"
+           " of the MarFS file being transferred in parallel.\n"
+           "\n"
+           " Arguments --\n"
+           "  -c MarFS-Config-File : Specifies the path of the MarFS config file to use\n"
+           "                         (uses the MARFS_CONFIG_PATH env val, if unspecified)\n"
+           "  -t Thread-Count      : Count of transfer threads per process (defaults to %d)\n"
+           "  -b Buffer-MiB        : Size of each thread's IO buffer, in MiB (defaults to %d)\n"
+           "  -r                   : Reverse copy, from a MarFS Source-Path to a POSIX Dest-Path\n"
+           "                         (by default, Source-Path is POSIX and Dest-Path is MarFS)\n"
+           "  -m                   : Distribute chunks across all MPI ranks, in addition to threads\n"
+           "                         (program must be launched via mpirun or similar)\n"
+           "  -h                   : Print this usage info\n"
+           "\n",
+           DEFAULT_THREAD_COUNT, DEFAULT_BUFFER_SIZE / ( 1024 * 1024 ) );
+}
+
+/**
+ * Claim the next chunk to be transferred by this process
+ * @param pcpstate* state : Shared transfer state
+ * @param size_t* chunknum : Reference to be populated with the claimed chunk index
+ * @return int : One if a chunk was claimed, zero if none remain
+ */
+int claimchunk( pcpstate* state, size_t* chunknum ) {
+   int retval = 0;
+   pthread_mutex_lock( &(state->lock) );
+   if ( state->failed == 0  &&  state->nextchunk < state->chunkcount ) {
+      *chunknum = state->nextchunk;
+      state->nextchunk += state->chunkstride;
+      retval = 1;
+   }
+   pthread_mutex_unlock( &(state->lock) );
+   return retval;
+}
+
+/**
+ * Copy a single chunk from a POSIX source into the MarFS destination
+ * @param pcpstate* state : Shared transfer state
+ * @param size_t chunknum : Index of the chunk to be copied
+ * @param void* buffer : IO buffer of state->buffersize bytes
+ * @return ssize_t : Count of bytes copied, or -1 on failure
+ */
+ssize_t putchunk( pcpstate* state, size_t chunknum, void* buffer ) {
+   marfs_fhandle fh = marfs_open( state->ctxt, NULL, state->dstpath, MARFS_WRITE );
+   if ( fh == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to open \"%s\" for write of chunk %zu (%s)\n",
+               state->dstpath, chunknum, strerror(errno) );
+      return -1;
+   }
+   off_t offset = 0;
+   size_t size = 0;
+   if ( marfs_chunkbounds( fh, (int)chunknum, &offset, &size ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to identify bounds of chunk %zu (%s)\n", chunknum, strerror(errno) );
+      marfs_release( fh );
+      return -1;
+   }
+   if ( marfs_seek( fh, offset, SEEK_SET ) != offset ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to seek to chunk %zu offset %zd (%s)\n",
+               chunknum, (ssize_t)offset, strerror(errno) );
+      marfs_release( fh );
+      return -1;
+   }
+   size_t remaining = size;
+   while ( remaining ) {
+      size_t iosize = ( remaining < state->buffersize ) ? remaining : state->buffersize;
+      ssize_t readres = pread( state->posixfd, buffer, iosize, offset + ( size - remaining ) );
+      if ( readres <= 0 ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to read source \"%s\" at offset %zd (%s)\n",
+                  state->srcpath, (ssize_t)( offset + ( size - remaining ) ),
+                  ( readres ) ? strerror(errno) : "unexpected EOF" );
+         marfs_release( fh );
+         return -1;
+      }
+      if ( marfs_write( fh, buffer, readres ) != readres ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to write chunk %zu of \"%s\" (%s)\n",
+                  chunknum, state->dstpath, strerror(errno) );
+         marfs_release( fh );
+         return -1;
+      }
+      remaining -= readres;
+   }
+   if ( marfs_release( fh ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to release handle for chunk %zu (%s)\n", chunknum, strerror(errno) );
+      return -1;
+   }
+   return (ssize_t)size;
+}
+
+/**
+ * Copy a single chunk from the MarFS source into a POSIX destination
+ * @param pcpstate* state : Shared transfer state
+ * @param size_t chunknum : Index of the chunk to be copied
+ * @param void* buffer : IO buffer of state->buffersize bytes
+ * @return ssize_t : Count of bytes copied, or -1 on failure
+ */
+ssize_t getchunk( pcpstate* state, size_t chunknum, void* buffer ) {
+   marfs_fhandle fh = marfs_open( state->ctxt, NULL, state->srcpath, MARFS_READ );
+   if ( fh == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to open \"%s\" for read of chunk %zu (%s)\n",
+               state->srcpath, chunknum, strerror(errno) );
+      return -1;
+   }
+   off_t offset = 0;
+   size_t size = 0;
+   if ( marfs_chunkbounds( fh, (int)chunknum, &offset, &size ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to identify bounds of chunk %zu (%s)\n", chunknum, strerror(errno) );
+      marfs_close( fh );
+      return -1;
+   }
+   if ( marfs_seek( fh, offset, SEEK_SET ) != offset ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to seek to chunk %zu offset %zd (%s)\n",
+               chunknum, (ssize_t)offset, strerror(errno) );
+      marfs_close( fh );
+      return -1;
+   }
+   size_t remaining = size;
+   while ( remaining ) {
+      size_t iosize = ( remaining < state->buffersize ) ? remaining : state->buffersize;
+      ssize_t readres = marfs_read( fh, buffer, iosize );
+      if ( readres <= 0 ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to read chunk %zu of \"%s\" (%s)\n",
+                  chunknum, state->srcpath, ( readres ) ? strerror(errno) : "unexpected EOF" );
+         marfs_close( fh );
+         return -1;
+      }
+      if ( pwrite( state->posixfd, buffer, readres, offset + ( size - remaining ) ) != readres ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to write dest \"%s\" at offset %zd (%s)\n",
+                  state->dstpath, (ssize_t)( offset + ( size - remaining ) ), strerror(errno) );
+         marfs_close( fh );
+         return -1;
+      }
+      remaining -= readres;
+   }
+   if ( marfs_close( fh ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to close handle for chunk %zu (%s)\n", chunknum, strerror(errno) );
+      return -1;
+   }
+   return (ssize_t)size;
+}
+
+/**
+ * Transfer thread behavior : claim and copy chunks until none remain
+ * @param void* arg : Reference to the shared pcpstate
+ * @return void* : Always NULL
+ */
+void* transferthread( void* arg ) {
+   pcpstate* state = (pcpstate*)arg;
+   void* buffer = malloc( state->buffersize );
+   if ( buffer == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to allocate %zu byte IO buffer\n", state->buffersize );
+      pthread_mutex_lock( &(state->lock) );
+      state->failed = 1;
+      pthread_mutex_unlock( &(state->lock) );
+      return NULL;
+   }
+   size_t chunknum;
+   while ( claimchunk( state, &chunknum ) ) {
+      ssize_t moved = ( state->reverse ) ? getchunk( state, chunknum, buffer ) :
+                                           putchunk( state, chunknum, buffer );
+      pthread_mutex_lock( &(state->lock) );
+      if ( moved < 0 ) { state->failed = 1; }
+      else { state->bytesmoved += moved; }
+      pthread_mutex_unlock( &(state->lock) );
+   }
+   free( buffer );
+   return NULL;
+}
+
+/**
+ * Count the data chunks of the file referenced by the given handle
+ * @param marfs_fhandle fh : Handle of the target file
+ * @param off_t filesize : Total size of the target file
+ * @return ssize_t : Count of chunks, or -1 on failure
+ */
+ssize_t countchunks( marfs_fhandle fh, off_t filesize ) {
+   ssize_t chunkcount = 0;
+   off_t offset = 0;
+   size_t size = 0;
+   do {
+      if ( marfs_chunkbounds( fh, (int)chunkcount, &offset, &size ) ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to identify bounds of chunk %zd (%s)\n",
+                  chunkcount, strerror(errno) );
+         return -1;
+      }
+      chunkcount++;
+   } while ( offset + (off_t)size < filesize );
+   return chunkcount;
+}
+
+/**
+ * Prepare the destination of a copy, and identify the chunk count of the MarFS file
+ * NOTE -- This is performed by a single process, prior to any chunk transfers
+ * @param pcpstate* state : Transfer state ( chunkcount will be populated )
+ * @return int : Zero on success, or -1 on failure
+ */
+int preparecopy( pcpstate* state ) {
+   if ( state->reverse ) {
+      struct stat stval;
+      if ( marfs_stat( state->ctxt, state->srcpath, &stval, 0 ) ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to stat MarFS source \"%s\" (%s)\n", state->srcpath, strerror(errno) );
+         return -1;
+      }
+      int dstfd = open( state->dstpath, O_WRONLY | O_CREAT | O_TRUNC, stval.st_mode & 07777 );
+      if ( dstfd < 0 ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to create POSIX dest \"%s\" (%s)\n", state->dstpath, strerror(errno) );
+         return -1;
+      }
+      if ( ftruncate( dstfd, stval.st_size ) ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to size POSIX dest \"%s\" (%s)\n", state->dstpath, strerror(errno) );
+         close( dstfd );
+         return -1;
+      }
+      close( dstfd );
+      marfs_fhandle fh = marfs_open( state->ctxt, NULL, state->srcpath, MARFS_READ );
+      if ( fh == NULL ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to open MarFS source \"%s\" (%s)\n", state->srcpath, strerror(errno) );
+         return -1;
+      }
+      ssize_t chunkcount = countchunks( fh, stval.st_size );
+      marfs_close( fh );
+      if ( chunkcount < 0 ) { return -1; }
+      state->chunkcount = chunkcount;
+      return 0;
+   }
+   struct stat stval;
+   if ( fstat( state->posixfd, &stval ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to stat POSIX source \"%s\" (%s)\n", state->srcpath, strerror(errno) );
+      return -1;
+   }
+   // create the MarFS dest, and extend it to the full source size for parallel write
+   marfs_fhandle fh = marfs_creat( state->ctxt, NULL, state->dstpath, stval.st_mode & 07777 );
+   if ( fh == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to create MarFS dest \"%s\" (%s)\n", state->dstpath, strerror(errno) );
+      return -1;
+   }
+   if ( marfs_extend( fh, stval.st_size ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to extend MarFS dest \"%s\" to %zd bytes (%s)\n",
+               state->dstpath, (ssize_t)stval.st_size, strerror(errno) );
+      marfs_release( fh );
+      return -1;
+   }
+   // the create handle must be released, to make the final chunk accessible
+   if ( marfs_release( fh ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to release MarFS create handle (%s)\n", strerror(errno) );
+      return -1;
+   }
+   // chunk bounds are only reported accurately by a handle opened for parallel write
+   fh = marfs_open( state->ctxt, NULL, state->dstpath, MARFS_WRITE );
+   if ( fh == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to open MarFS dest \"%s\" for write (%s)\n", state->dstpath, strerror(errno) );
+      return -1;
+   }
+   ssize_t chunkcount = countchunks( fh, stval.st_size );
+   if ( marfs_release( fh ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to release MarFS write handle (%s)\n", strerror(errno) );
+      return -1;
+   }
+   if ( chunkcount < 0 ) { return -1; }
+   state->chunkcount = chunkcount;
+   return 0;
+}
+
+/**
+ * Complete the destination of a copy, after all chunks have been transferred
+ * NOTE -- This is performed by a single process, after all chunk transfers
+ * @param pcpstate* state : Transfer state
+ * @return int : Zero on success, or -1 on failure
+ */
+int finalizecopy( pcpstate* state ) {
+   if ( state->reverse ) { return 0; } // nothing to be done for POSIX dests
+   marfs_fhandle fh = marfs_open( state->ctxt, NULL, state->dstpath, MARFS_WRITE );
+   if ( fh == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to open MarFS dest \"%s\" for finalization (%s)\n",
+               state->dstpath, strerror(errno) );
+      return -1;
+   }
+   if ( marfs_close( fh ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to finalize MarFS dest \"%s\" (%s)\n", state->dstpath, strerror(errno) );
+      return -1;
+   }
+   return 0;
+}
+
+
+int main( int argc, char** argv ) {
+   char* config_path = getenv( "MARFS_CONFIG_PATH" ); // check for config env var
+   int threadcount = DEFAULT_THREAD_COUNT;
+   char usempi = 0;
+   pcpstate state;
+   bzero( &(state), sizeof( struct pcpstate_struct ) );
+   state.buffersize = DEFAULT_BUFFER_SIZE;
+   state.chunkstride = 1;
+   state.posixfd = -1;
+
+   // parse all position-independent arguments
+   char pr_usage = 0;
+   int c;
+   while ((c = getopt(argc, (char* const*)argv, "c:t:b:rmh")) != -1) {
+      switch (c) {
+      case 'c':
+         config_path = optarg;
+         break;
+      case 't':
+         threadcount = atoi( optarg );
+         if ( threadcount < 1 ) {
+            fprintf( stderr, OUTPREFX "ERROR: Invalid thread count: \"%s\"\n", optarg );
+            pr_usage = 1;
+         }
+         break;
+      case 'b':
+         {
+         long long bufmib = atoll( optarg );
+         if ( bufmib < 1 ) {
+            fprintf( stderr, OUTPREFX "ERROR: Invalid buffer size: \"%s\"\n", optarg );
+            pr_usage = 1;
+         }
+         state.buffersize = (size_t)bufmib * 1024 * 1024;
+         break;
+         }
+      case 'r':
+         state.reverse = 1;
+         break;
+      case 'm':
+         usempi = 1;
+         break;
+      case '?':
+         fprintf( stderr, OUTPREFX "ERROR: Unrecognized cmdline argument: \'%c\'\n", optopt );
+      case 'h': // note fallthrough from above
+         pr_usage = 1;
+         break;
+      default:
+         fprintf( stderr, OUTPREFX "ERROR: Failed to parse command line options\n" );
+         return -1;
+      }
+   }
+   if ( pr_usage == 0  &&  ( argc - optind ) != 2 ) {
+      fprintf( stderr, OUTPREFX "ERROR: Expected exactly two path arguments\n" );
+      pr_usage = 1;
+   }
+   if ( pr_usage == 0  &&  config_path == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: no config path defined ( '-c' arg or MARFS_CONFIG_PATH env var )\n" );
+      pr_usage = 1;
+   }
+   if ( pr_usage ) {
+      print_usage_info();
+      return -1;
+   }
+   state.srcpath = argv[optind];
+   state.dstpath = argv[optind + 1];
+
+   int rank = 0;
+   int rankcount = 1;
+   if ( usempi ) {
+      if ( MPI_Init( &argc, &argv ) != MPI_SUCCESS ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to initialize MPI\n" );
+         return -1;
+      }
+      if ( MPI_Comm_rank( MPI_COMM_WORLD, &rank ) != MPI_SUCCESS  ||
+           MPI_Comm_size( MPI_COMM_WORLD, &rankcount ) != MPI_SUCCESS ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to identify MPI rank info\n" );
+         MPI_Abort( MPI_COMM_WORLD, -1 );
+         return -1;
+      }
+   }
+
+   state.ctxt = marfs_init( config_path, MARFS_BATCH, 0 );
+   if ( state.ctxt == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to initialize MarFS ctxt from \"%s\" (%s)\n", config_path, strerror(errno) );
+      if ( usempi ) { MPI_Abort( MPI_COMM_WORLD, -1 ); }
+      return -1;
+   }
+   if ( marfs_setctag( state.ctxt, PROGNAME ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to set MarFS client tag (%s)\n", strerror(errno) );
+      if ( usempi ) { MPI_Abort( MPI_COMM_WORLD, -1 ); }
+      return -1;
+   }
+   if ( state.reverse == 0 ) {
+      state.posixfd = open( state.srcpath, O_RDONLY );
+      if ( state.posixfd < 0 ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to open POSIX source \"%s\" (%s)\n", state.srcpath, strerror(errno) );
+         if ( usempi ) { MPI_Abort( MPI_COMM_WORLD, -1 ); }
+         return -1;
+      }
+   }
+
+   // a single rank sets up the destination and identifies the chunk count for all
+   int retval = 0;
+   unsigned long long chunkcount = 0;
+   if ( rank == 0 ) {
+      if ( preparecopy( &(state) ) ) { retval = -1; }
+      else { chunkcount = state.chunkcount; }
+   }
+   if ( usempi ) {
+      if ( MPI_Bcast( &chunkcount, 1, MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD ) != MPI_SUCCESS ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to broadcast chunk count\n" );
+         MPI_Abort( MPI_COMM_WORLD, -1 );
+         return -1;
+      }
+   }
+   if ( chunkcount == 0 ) {
+      // rank zero failed to prepare the copy
+      if ( usempi ) { MPI_Finalize(); }
+      marfs_term( state.ctxt );
+      return -1;
+   }
+   state.chunkcount = chunkcount;
+   state.nextchunk = rank;
+   state.chunkstride = rankcount;
+   if ( state.reverse ) {
+      state.posixfd = open( state.dstpath, O_WRONLY );
+      if ( state.posixfd < 0 ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to open POSIX dest \"%s\" (%s)\n", state.dstpath, strerror(errno) );
+         state.failed = 1;
+      }
+   }
+
+   // transfer all chunks assigned to this process
+   if ( pthread_mutex_init( &(state.lock), NULL ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to initialize state lock\n" );
+      state.failed = 1;
+   }
+   pthread_t* threads = calloc( threadcount, sizeof( pthread_t ) );
+   if ( threads == NULL ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to allocate thread list\n" );
+      state.failed = 1;
+   }
+   int startedthreads = 0;
+   while ( state.failed == 0  &&  startedthreads < threadcount ) {
+      if ( pthread_create( threads + startedthreads, NULL, transferthread, &(state) ) ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to create transfer thread %d\n", startedthreads );
+         pthread_mutex_lock( &(state.lock) );
+         state.failed = 1;
+         pthread_mutex_unlock( &(state.lock) );
+         break;
+      }
+      startedthreads++;
+   }
+   while ( startedthreads ) {
+      startedthreads--;
+      pthread_join( threads[startedthreads], NULL );
+   }
+   if ( threads ) { free( threads ); }
+   if ( state.posixfd >= 0  &&  close( state.posixfd ) ) {
+      fprintf( stderr, OUTPREFX "ERROR: Failed to close POSIX file (%s)\n", strerror(errno) );
+      state.failed = 1;
+   }
+
+   // all ranks must agree on success, before the dest is finalized
+   int anyfailed = state.failed;
+   if ( usempi ) {
+      int localfailed = state.failed;
+      if ( MPI_Allreduce( &localfailed, &anyfailed, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD ) != MPI_SUCCESS ) {
+         fprintf( stderr, OUTPREFX "ERROR: Failed to reduce transfer results\n" );
+         anyfailed = 1;
+      }
+   }
+   if ( anyfailed ) { retval = -1; }
+   else if ( rank == 0  &&  finalizecopy( &(state) ) ) { retval = -1; }
+
+   unsigned long long totalbytes = state.bytesmoved;
+   if ( usempi ) {
+      unsigned long long localbytes = state.bytesmoved;
+      MPI_Reduce( &localbytes, &totalbytes, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD );
+   }
+   if ( rank == 0  &&  retval == 0 ) {
+      printf( OUTPREFX "Copied %llu bytes in %llu chunks from \"%s\" to \"%s\"\n",
+              totalbytes, chunkcount, state.srcpath, state.dstpath );
+   }
+   pthread_mutex_destroy( &(state.lock) );
+   if ( marfs_term( state.ctxt ) ) {
+      fprintf( stderr, OUTPREFX "WARNING: Failed to terminate MarFS ctxt (%s)\n", strerror(errno) );
+   }
+   if ( usempi ) { MPI_Finalize(); }
+   return retval;
+}
+
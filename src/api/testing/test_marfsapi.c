@@ -60,6 +60,9 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 
 #include "marfs.c" // include C file directly, to allow traversal of all structures
 #include "config/config.h" // for config validation, alone
+#define main marfspcp_main // include the marfs-pcp source as well, to allow testing of its transfer funcs
+#include "marfspcp.c"
+#undef main
 
 #include <ftw.h>
 
@@ -176,6 +179,27 @@ int main( int argc, char** argv ) {
       return -1;
    }
 
+   // check that our op stats reflect the above configver call
+   size_t statlen = marfs_getstats( batchctxt, NULL, 0 );
+   if ( statlen == 0 ) {
+      printf( "failed to identify stats report length\n" );
+      return -1;
+   }
+   char* statstr = malloc( statlen + 1 );
+   if ( statstr == NULL ) {
+      printf( "failed to allocate stats string\n" );
+      return -1;
+   }
+   if ( marfs_getstats( batchctxt, statstr, statlen + 1 ) != statlen ) {
+      printf( "inconsistent stats report length\n" );
+      return -1;
+   }
+   if ( strstr( statstr, "\nmarfs_configver 1 0 " ) == NULL ) {
+      printf( "unexpected stats report:\n%s", statstr );
+      return -1;
+   }
+   free( statstr );
+
    // shift our interactive ctxt down to '/gransom-allocation/heavily-protected-data'
    marfs_dhandle hpdhandle = marfs_opendir( interctxt, "/campaign/gransom-allocation/heavily-protected-data" );
    if ( hpdhandle == NULL ) {
@@ -270,6 +294,84 @@ int main( int argc, char** argv ) {
       printf( "failed to close 'bgasubfilehandle'\n" );
       return -1;
    }
+   // create another set of packed files, in batches
+   marfs_batchent batchents[256];
+   char batchnames[256][32];
+   marfs_fhandle batchhandle = NULL;
+   for ( index = 0; index < 1024; index++ ) {
+      int entindex = index % 256;
+      snprintf( batchnames[entindex], 32, "bfile%d", index );
+      batchents[entindex].name = batchnames[entindex];
+      batchents[entindex].mode = 0644;
+      batchents[entindex].buf = oneMBbuffer + index;
+      batchents[entindex].size = index % 100; // includes some empty files
+      if ( entindex == 255 ) {
+         if ( marfs_creat_batch( batchctxt, &(batchhandle), "gransom-allocation/packed-files", batchents, 256 ) != 256 ) {
+            printf( "failed to batch create packed-files/bfile%d - bfile%d\n", index - 255, index );
+            return -1;
+         }
+      }
+   }
+   // names may not reference other directories
+   batchents[0].name = "../bfile";
+   if ( marfs_creat_batch( batchctxt, &(batchhandle), "gransom-allocation/packed-files", batchents, 1 ) != -1  ||  errno != EINVAL ) {
+      printf( "expected failure of batch create with an invalid name\n" );
+      return -1;
+   }
+   // names at the root of a NS may not target a subspace, even following the first entry
+   marfs_fhandle failhandle = NULL;
+   batchents[0].name = "bsubspacepeer";
+   batchents[1].name = "read-only-data";
+   if ( marfs_creat_batch( batchctxt, &(failhandle), "gransom-allocation", batchents, 2 ) != -1  ||  errno != EISDIR  ||
+        failhandle != NULL ) {
+      printf( "expected failure of batch create with a subspace name\n" );
+      return -1;
+   }
+   struct stat batchstval;
+   if ( marfs_stat( batchctxt, "gransom-allocation/bsubspacepeer", &(batchstval), AT_SYMLINK_NOFOLLOW ) == 0  ||
+        errno != ENOENT ) {
+      printf( "batch create with a subspace name produced 'bsubspacepeer'\n" );
+      return -1;
+   }
+   // a symlink as the first entry must be replaced, rather than followed, and must not redirect the remaining entries
+   if ( marfs_symlink( interctxt, "../read-only-data", "hpdbatchlink" ) ) {
+      printf( "failed to create 'hpdbatchlink'\n" );
+      return -1;
+   }
+   batchents[0].name = "hpdbatchlink";
+   batchents[1].name = "hpdbatchpeer";
+   marfs_fhandle linkhandle = NULL;
+   if ( marfs_creat_batch( interctxt, &(linkhandle), ".", batchents, 2 ) != 2 ) {
+      printf( "failed to batch create over a symlink entry\n" );
+      return -1;
+   }
+   if ( marfs_close( linkhandle ) ) {
+      printf( "failed to close 'linkhandle'\n" );
+      return -1;
+   }
+   if ( marfs_stat( interctxt, "hpdbatchlink", &(batchstval), AT_SYMLINK_NOFOLLOW )  ||  !(S_ISREG(batchstval.st_mode))  ||
+        batchstval.st_size != batchents[0].size ) {
+      printf( "batch create did not replace symlink 'hpdbatchlink'\n" );
+      return -1;
+   }
+   if ( marfs_stat( interctxt, "hpdbatchpeer", &(batchstval), AT_SYMLINK_NOFOLLOW )  ||  !(S_ISREG(batchstval.st_mode))  ||
+        batchstval.st_size != batchents[1].size ) {
+      printf( "batch create with a symlink entry failed to produce 'hpdbatchpeer'\n" );
+      return -1;
+   }
+   if ( marfs_stat( batchctxt, "gransom-allocation/read-only-data/hpdbatchpeer", &(batchstval), AT_SYMLINK_NOFOLLOW ) == 0  ||
+        errno != ENOENT ) {
+      printf( "batch create with a symlink entry produced 'read-only-data/hpdbatchpeer'\n" );
+      return -1;
+   }
+   if ( marfs_unlink( interctxt, "hpdbatchlink" )  ||  marfs_unlink( interctxt, "hpdbatchpeer" ) ) {
+      printf( "failed to unlink 'hpdbatchlink' / 'hpdbatchpeer'\n" );
+      return -1;
+   }
+   if ( marfs_close( batchhandle ) ) {
+      printf( "failed to close 'batchhandle'\n" );
+      return -1;
+   }
    // create a chunked file in a different NS
    marfs_fhandle hpdstream = marfs_creat( interctxt, NULL, "chunked", 0704 );
    if ( hpdstream == NULL ) {
@@ -536,6 +638,81 @@ int main( int argc, char** argv ) {
    }
 
 
+   // copy a POSIX file into MarFS, via the chunk transfer functions of marfs-pcp
+   int pcpfd = open( "./test_datastream_topdir/pcpsource", O_CREAT | O_TRUNC | O_RDWR, 0600 );
+   if ( pcpfd < 0  ||  pwrite( pcpfd, oneMBbuffer, 712400, 0 ) != 712400 ) {
+      printf( "failed to populate 'pcpsource'\n" );
+      return -1;
+   }
+   pcpstate pcp;
+   bzero( &(pcp), sizeof( struct pcpstate_struct ) );
+   pcp.ctxt = batchctxt;
+   pcp.srcpath = "./test_datastream_topdir/pcpsource";
+   pcp.dstpath = "gransom-allocation/pcpfile";
+   pcp.posixfd = pcpfd;
+   pcp.buffersize = 65536;
+   pcp.chunkstride = 1;
+   if ( pthread_mutex_init( &(pcp.lock), NULL ) ) {
+      printf( "failed to initialize pcp lock\n" );
+      return -1;
+   }
+   if ( preparecopy( &(pcp) ) ) {
+      printf( "failed to prepare copy to 'pcpfile'\n" );
+      return -1;
+   }
+   // should match the chunking of 'parallelfile', with no empty trailing chunk
+   if ( pcp.chunkcount != 7 ) {
+      printf( "unexpected chunk count of 'pcpfile': %zu\n", pcp.chunkcount );
+      return -1;
+   }
+   transferthread( &(pcp) );
+   if ( pcp.failed  ||  pcp.bytesmoved != 712400 ) {
+      printf( "failed to transfer all chunks to 'pcpfile' ( %zu bytes moved )\n", pcp.bytesmoved );
+      return -1;
+   }
+   if ( finalizecopy( &(pcp) ) ) {
+      printf( "failed to finalize 'pcpfile'\n" );
+      return -1;
+   }
+   close( pcpfd );
+   // ...then copy it back out again
+   pcp.reverse = 1;
+   pcp.srcpath = "gransom-allocation/pcpfile";
+   pcp.dstpath = "./test_datastream_topdir/pcpdest";
+   pcp.nextchunk = 0;
+   pcp.bytesmoved = 0;
+   if ( preparecopy( &(pcp) )  ||  pcp.chunkcount != 7 ) {
+      printf( "failed to prepare copy from 'pcpfile'\n" );
+      return -1;
+   }
+   pcp.posixfd = open( pcp.dstpath, O_WRONLY );
+   if ( pcp.posixfd < 0 ) {
+      printf( "failed to open 'pcpdest'\n" );
+      return -1;
+   }
+   transferthread( &(pcp) );
+   close( pcp.posixfd );
+   pthread_mutex_destroy( &(pcp.lock) );
+   if ( pcp.failed  ||  pcp.bytesmoved != 712400 ) {
+      printf( "failed to transfer all chunks from 'pcpfile' ( %zu bytes moved )\n", pcp.bytesmoved );
+      return -1;
+   }
+   void* pcpbuf = malloc( 712401 );
+   pcpfd = open( "./test_datastream_topdir/pcpdest", O_RDONLY );
+   if ( pcpbuf == NULL  ||  pcpfd < 0  ||  read( pcpfd, pcpbuf, 712401 ) != 712400  ||
+        memcmp( pcpbuf, oneMBbuffer, 712400 ) ) {
+      printf( "unexpected content of 'pcpdest'\n" );
+      return -1;
+   }
+   close( pcpfd );
+   free( pcpbuf );
+   if ( marfs_unlink( batchctxt, "gransom-allocation/pcpfile" )  ||
+        unlink( "./test_datastream_topdir/pcpsource" )  ||  unlink( "./test_datastream_topdir/pcpdest" ) ) {
+      printf( "failed to unlink pcp files\n" );
+      return -1;
+   }
+
+
    // read back written files
    void* oneMBreadbuf = calloc( 1024, 1024 );
    if ( oneMBreadbuf == NULL ) {
@@ -578,6 +755,28 @@ int main( int argc, char** argv ) {
          return -1;
       }
    }
+   // batch created files
+   for ( index = 0; index < 1024; index += 7 ) {
+      char fname[1024];
+      if ( snprintf( fname, 1024, "/campaign/gransom-allocation/packed-files/bfile%d", index ) >= 1024 ) {
+         printf( "failed to generate name of packed-files/bfile%d\n", index );
+         return -1;
+      }
+      phandle = marfs_open( batchctxt, phandle, fname, MARFS_READ );
+      if ( phandle == NULL ) {
+         printf( "failed to open packed-files/bfile%d for read\n", index );
+         return -1;
+      }
+      bzero( oneMBreadbuf, 1048576 );
+      if ( marfs_read( phandle, oneMBreadbuf, 1048576 ) != index % 100 ) {
+         printf( "failed to read %d bytes from %s\n", index % 100, fname );
+         return -1;
+      }
+      if ( memcmp( oneMBreadbuf, oneMBbuffer + index, index % 100 ) ) {
+         printf( "unexpected content of %s\n", fname );
+         return -1;
+      }
+   }
    // file1
    phandle = marfs_open( batchctxt, phandle, "gransom-allocation/gasubdir/file1", MARFS_READ );
    if ( phandle == NULL ) {
@@ -654,6 +853,136 @@ int main( int argc, char** argv ) {
       printf( "104857 bytes of 'file1' @ offset 600000 do not match expectations\n" );
       return -1;
    }
+   // read the entire file asynchronously, in 16 concurrent chunks
+   marfs_aqueue aqueue = marfs_aqueue_init( 4 );
+   if ( aqueue == NULL ) {
+      printf( "failed to initialize an async queue\n" );
+      return -1;
+   }
+   bzero( oneMBreadbuf, 1048576 );
+   for ( index = 0; index < 16; index++ ) {
+      if ( marfs_aread( aqueue, phandle, index * 65536, oneMBreadbuf + (index * 65536), 65536, (void*)((long)index) ) ) {
+         printf( "failed to submit async read %d of 'file1'\n", index );
+         return -1;
+      }
+   }
+   // a read beyond EOF should simply produce no data
+   if ( marfs_aread( aqueue, phandle, 1048576 + 10, oneMBreadbuf, 100, (void*)16L ) ) {
+      printf( "failed to submit async read beyond EOF of 'file1'\n" );
+      return -1;
+   }
+   int reaped = 0;
+   while ( reaped < 17 ) {
+      marfs_acompletion completions[5];
+      ssize_t compres = marfs_acomplete( aqueue, completions, 5, 1 );
+      if ( compres <= 0 ) {
+         printf( "failed to reap async reads of 'file1' ( %d reaped so far )\n", reaped );
+         return -1;
+      }
+      ssize_t compindex = 0;
+      for ( ; compindex < compres; compindex++ ) {
+         long tag = (long)completions[compindex].tag;
+         ssize_t expected = ( tag == 16 ) ? 0 : 65536;
+         if ( completions[compindex].result != expected ) {
+            printf( "unexpected result of async read %ld of 'file1': %zd\n", tag, completions[compindex].result );
+            return -1;
+         }
+      }
+      reaped += compres;
+   }
+   if ( memcmp( oneMBreadbuf, oneMBbuffer, 1048576 ) ) {
+      printf( "async read content of 'file1' does not match expectations\n" );
+      return -1;
+   }
+   // write a new file asynchronously, in 8 chunks, while reading 'file1' via the same queue
+   marfs_fhandle ahandle = marfs_creat( batchctxt, NULL, "gransom-allocation/gasubdir/afile", 0700 );
+   if ( ahandle == NULL ) {
+      printf( "failed to create 'afile'\n" );
+      return -1;
+   }
+   bzero( oneMBreadbuf, 1048576 );
+   for ( index = 0; index < 8; index++ ) {
+      if ( marfs_awrite( aqueue, ahandle, oneMBbuffer + (index * 65536), 65536, (void*)((long)(100 + index)) ) ) {
+         printf( "failed to submit async write %d of 'afile'\n", index );
+         return -1;
+      }
+      if ( marfs_aread( aqueue, phandle, (7 - index) * 65536, oneMBreadbuf + ((7 - index) * 65536), 65536, (void*)((long)(200 + index)) ) ) {
+         printf( "failed to submit async read %d of 'file1'\n", index );
+         return -1;
+      }
+   }
+   reaped = 0;
+   long lastwrite = 99;
+   while ( reaped < 16 ) {
+      marfs_acompletion completions[5];
+      ssize_t compres = marfs_acomplete( aqueue, completions, 5, 1 );
+      if ( compres <= 0 ) {
+         printf( "failed to reap async writes/reads ( %d reaped so far )\n", reaped );
+         return -1;
+      }
+      ssize_t compindex = 0;
+      for ( ; compindex < compres; compindex++ ) {
+         long tag = (long)completions[compindex].tag;
+         if ( completions[compindex].result != 65536  ||  completions[compindex].error ) {
+            printf( "unexpected result of async op %ld: %zd (%s)\n", tag, completions[compindex].result,
+                    strerror(completions[compindex].error) );
+            return -1;
+         }
+         if ( tag < 200 ) {
+            // writes must complete in submission order
+            if ( tag != lastwrite + 1 ) {
+               printf( "async write %ld of 'afile' completed out of order ( previous = %ld )\n", tag, lastwrite );
+               return -1;
+            }
+            lastwrite = tag;
+         }
+      }
+      reaped += compres;
+   }
+   if ( memcmp( oneMBreadbuf, oneMBbuffer, 524288 ) ) {
+      printf( "async read content of 'file1' does not match expectations\n" );
+      return -1;
+   }
+   if ( marfs_close( ahandle ) ) {
+      printf( "failed to close 'afile' write handle\n" );
+      return -1;
+   }
+   // verify the size and content of the async written file
+   if ( marfs_stat( batchctxt, "gransom-allocation/gasubdir/afile", &(stval), 0 ) ) {
+      printf( "failed to stat 'afile'\n" );
+      return -1;
+   }
+   if ( stval.st_size != 524288 ) {
+      printf( "unexpected size of 'afile': %zd\n", (ssize_t)stval.st_size );
+      return -1;
+   }
+   ahandle = marfs_open( batchctxt, NULL, "gransom-allocation/gasubdir/afile", MARFS_READ );
+   if ( ahandle == NULL ) {
+      printf( "failed to open 'afile' for read\n" );
+      return -1;
+   }
+   bzero( oneMBreadbuf, 1048576 );
+   if ( marfs_read( ahandle, oneMBreadbuf, 1048576 ) != 524288 ) {
+      printf( "failed to read 524288 bytes from 'afile'\n" );
+      return -1;
+   }
+   if ( memcmp( oneMBreadbuf, oneMBbuffer, 524288 ) ) {
+      printf( "content of 'afile' does not match expectations\n" );
+      return -1;
+   }
+   if ( marfs_close( ahandle ) ) {
+      printf( "failed to close 'afile' read handle\n" );
+      return -1;
+   }
+   if ( marfs_aqueue_term( aqueue ) ) {
+      printf( "failed to terminate async queue\n" );
+      return -1;
+   }
+   // async reads should not have moved the handle
+   if ( marfs_seek( phandle, 0, SEEK_CUR ) != 704857 ) {
+      printf( "unexpected offset of 'file1' handle following async reads\n" );
+      return -1;
+   }
    if ( marfs_close( phandle ) ) {
       printf( "failed to close 'file1' read handle\n" );
       return -1;
@@ -703,6 +1032,17 @@ int main( int argc, char** argv ) {
          return -1;
       }
    }
+   for( index = 0; index < 1024; index++ ) {
+      char fname[1024];
+      if ( snprintf( fname, 1024, "/campaign/gransom-allocation/packed-files/bfile%d", index ) >= 1024 ) {
+         printf( "failed to generate name of packed-files/bfile%d\n", index );
+         return -1;
+      }
+      if ( marfs_unlink( interctxt, fname ) ) {
+         printf( "failed to unlink '%s'\n", fname );
+         return -1;
+      }
+   }
    if ( marfs_rmdir( interctxt, "/campaign/gransom-allocation/packed-files" ) ) {
       printf( "failed to rmdir '/campaign/gransom-allocation/packed-files'\n" );
       return -1;
@@ -715,6 +1055,10 @@ int main( int argc, char** argv ) {
       printf( "failed to unlink 'gransom-allocation/gasubdir/file2'\n" );
       return -1;
    }
+   if ( marfs_unlink( batchctxt, "gransom-allocation/gasubdir/afile" ) ) {
+      printf( "failed to unlink 'gransom-allocation/gasubdir/afile'\n" );
+      return -1;
+   }
    if ( marfs_unlink( batchctxt, "ghost-gransom/gfile1" ) ) {
       printf( "failed to unlink 'ghost-gransom/gfile1'\n" );
       return -1;
@@ -0,0 +1,772 @@
+/*
+Copyright (c) 2015, Los Alamos National Security, LLC
+All rights reserved.
+
+Copyright 2015.  Los Alamos National Security, LLC. This software was
+produced under U.S. Government contract DE-AC52-06NA25396 for Los
+Alamos National Laboratory (LANL), which is operated by Los Alamos
+National Security, LLC for the U.S. Department of Energy. The
+U.S. Government has rights to use, reproduce, and distribute this
+software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL SECURITY,
+LLC MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY
+FOR THE USE OF THIS SOFTWARE.  If software is modified to produce
+derivative works, such modified software should be clearly marked, so
+as not to confuse it with the version available from LANL.
+ 
+Additionally, redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the following
+conditions are met: 1. Redistributions of source code must retain the
+above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of Los Alamos National Security, LLC, Los Alamos
+National Laboratory, LANL, the U.S. Government, nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL LOS
+ALAMOS NATIONAL SECURITY, LLC OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-----
+NOTE:
+-----
+MarFS is released under the BSD license.
+
+MarFS was reviewed and released by LANL under Los Alamos Computer Code
+identifier: LA-CC-15-039.
+
+MarFS uses libaws4c for Amazon S3 object communication. The original version
+is at https://aws.amazon.com/code/Amazon-S3/2601 and under the LGPL license.
+LANL added functionality to the original work. The original work plus
+LANL contributions is found at https://github.com/jti-lanl/aws4c.
+
+GNU licenses can be found at http://www.gnu.org/licenses/.
+*/
+
+#include "marfs_auto_config.h"
+#ifdef DEBUG_COMPRESS
+#define DEBUG DEBUG_COMPRESS
+#elif (defined DEBUG_ALL)
+#define DEBUG DEBUG_ALL
+#endif
+#define LOG_PREFIX "compress"
+
+#include <logging.h>
+#include "compress.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+//   -------------   INTERNAL DEFINITIONS    -------------
+
+#define COMPRESS_RAWFLAG 0x80000000U // payload length flag, indicating an uncompressed payload
+
+typedef struct compress_job_struct {
+   FTAG_COMPRESSION type;
+   int     level;
+   char    decode;   // if set, inflate 'in' into 'out'; otherwise, produce a complete frame in 'out'
+   size_t  blockno;  // logical block number of this job
+   char*   in;       // input buffer ( logical block content, or compressed frame payload )
+   size_t  inlen;
+   char*   out;      // output buffer ( complete frame, or logical block content )
+   size_t  outlen;   // output length ( for decode jobs, this must be set to the expected length )
+   int     error;    // errno value of a failed job ( zero on success )
+   char    done;     // set once the job has been completed ( protected by the pool lock )
+   struct compress_job_struct* next; // pool queue linkage
+} compress_job;
+
+struct compress_handle_struct {
+   FTAG_COMPRESSION type;
+   int          level;
+   char         writing;
+   COMPRESS_IO  io;
+   int          error;       // errno value of a previous failure ( the handle is unusable after any failure )
+   // ring of submitted jobs, in block order
+   compress_job jobs[COMPRESS_MAXINFLIGHT];
+   size_t       jobhead;     // index of the oldest job
+   size_t       jobcount;    // count of submitted jobs
+   size_t       nextblock;   // block number of the next job to be submitted
+   // WRITE state
+   size_t       fill;        // bytes of the next block populated so far ( within the first unused job )
+   // READ state
+   size_t       tgtblock;    // block number of the current logical position
+   size_t       tgtpos;      // offset of the current logical position within that block
+   off_t*       frameoffs;   // physical offsets of frames, by block number
+   size_t       knownframes; // count of populated frameoffs entries
+   size_t       framealloc;  // allocated length of the frameoffs list
+   size_t       framecount;  // total count of frames ( SIZE_MAX, until the end is located )
+   off_t        rawpos;      // current physical offset of the data object
+};
+
+static pthread_once_t poolonce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t poollock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t poolwork = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pooldone = PTHREAD_COND_INITIALIZER;
+static compress_job* poolhead = NULL;
+static compress_job* pooltail = NULL;
+static int poolthreads = 0;
+
+
+//   -------------   INTERNAL FUNCTIONS    -------------
+
+/**
+ * Encode the given value as a 32-bit big-endian frame header field
+ * @param unsigned char* tgt : Target buffer
+ * @param uint32_t value : Value to be encoded
+ */
+static void putheaderval( unsigned char* tgt, uint32_t value ) {
+   tgt[0] = (unsigned char)( value >> 24 );
+   tgt[1] = (unsigned char)( value >> 16 );
+   tgt[2] = (unsigned char)( value >> 8 );
+   tgt[3] = (unsigned char)value;
+}
+
+/**
+ * Decode a 32-bit big-endian frame header field
+ * @param const unsigned char* src : Source buffer
+ * @return uint32_t : Decoded value
+ */
+static uint32_t getheaderval( const unsigned char* src ) {
+   return ( (uint32_t)src[0] << 24 ) | ( (uint32_t)src[1] << 16 ) | ( (uint32_t)src[2] << 8 ) | (uint32_t)src[3];
+}
+
+/**
+ * Perform the compression / decompression work of the given job
+ * @param compress_job* job : Job to be processed
+ */
+static void runjob( compress_job* job ) {
+   job->error = 0;
+   if ( job->decode ) {
+      uLongf destlen = job->outlen;
+      int zres = uncompress( (Bytef*)job->out, &(destlen), (const Bytef*)job->in, job->inlen );
+      if ( zres != Z_OK  ||  destlen != job->outlen ) {
+         LOG( LOG_ERR, "Failed to decompress block %zu ( zlib result = %d, length = %lu, expected = %zu )\n",
+              job->blockno, zres, (unsigned long)destlen, job->outlen );
+         job->error = EIO;
+      }
+      return;
+   }
+   uLongf destlen = compressBound( COMPRESS_BLOCKSIZE );
+   int level = ( job->level ) ? job->level : Z_DEFAULT_COMPRESSION;
+   int zres = compress2( (Bytef*)job->out + COMPRESS_HEADERSIZE, &(destlen), (const Bytef*)job->in, job->inlen, level );
+   if ( zres != Z_OK  ||  destlen >= job->inlen ) {
+      // this block is better off stored as is
+      LOG( LOG_INFO, "Storing block %zu without compression ( zlib result = %d )\n", job->blockno, zres );
+      memcpy( job->out + COMPRESS_HEADERSIZE, job->in, job->inlen );
+      putheaderval( (unsigned char*)job->out, (uint32_t)job->inlen | COMPRESS_RAWFLAG );
+      job->outlen = COMPRESS_HEADERSIZE + job->inlen;
+   }
+   else {
+      putheaderval( (unsigned char*)job->out, (uint32_t)destlen );
+      job->outlen = COMPRESS_HEADERSIZE + destlen;
+   }
+   putheaderval( (unsigned char*)job->out + 4, (uint32_t)job->inlen );
+}
+
+/**
+ * Worker thread behavior, processing queued jobs for the lifetime of the process
+ * @param void* arg : Unused
+ * @return void* : Never returns
+ */
+static void* poolworker( void* arg ) {
+   while ( 1 ) {
+      pthread_mutex_lock( &(poollock) );
+      while ( poolhead == NULL ) { pthread_cond_wait( &(poolwork), &(poollock) ); }
+      compress_job* job = poolhead;
+      poolhead = job->next;
+      if ( poolhead == NULL ) { pooltail = NULL; }
+      pthread_mutex_unlock( &(poollock) );
+      runjob( job );
+      pthread_mutex_lock( &(poollock) );
+      job->done = 1;
+      pthread_cond_broadcast( &(pooldone) );
+      pthread_mutex_unlock( &(poollock) );
+   }
+   return NULL;
+}
+
+/**
+ * Start the worker pool ( called exactly once, via pthread_once() )
+ */
+static void poolinit( void ) {
+   long ncpus = sysconf( _SC_NPROCESSORS_ONLN );
+   int target = ( ncpus < 1 ) ? 1 : ( ncpus > COMPRESS_MAXTHREADS ) ? COMPRESS_MAXTHREADS : (int)ncpus;
+   pthread_attr_t attr;
+   if ( pthread_attr_init( &(attr) )  ||  pthread_attr_setdetachstate( &(attr), PTHREAD_CREATE_DETACHED ) ) {
+      LOG( LOG_WARNING, "Failed to initialize worker thread attributes ( all work will be performed inline )\n" );
+      return;
+   }
+   for ( ; poolthreads < target; poolthreads++ ) {
+      pthread_t thread;
+      if ( pthread_create( &(thread), &(attr), poolworker, NULL ) ) {
+         LOG( LOG_WARNING, "Failed to create worker thread %d of %d\n", poolthreads + 1, target );
+         break;
+      }
+   }
+   pthread_attr_destroy( &(attr) );
+   LOG( LOG_INFO, "Started %d compression worker threads\n", poolthreads );
+}
+
+/**
+ * Submit the given job to the worker pool
+ * NOTE -- if no worker threads could be started, the job is completed before returning
+ * @param compress_job* job : Job to be submitted
+ */
+static void submitjob( compress_job* job ) {
+   pthread_once( &(poolonce), poolinit );
+   job->done = 0;
+   job->next = NULL;
+   if ( poolthreads == 0 ) {
+      runjob( job );
+      job->done = 1;
+      return;
+   }
+   pthread_mutex_lock( &(poollock) );
+   if ( pooltail ) { pooltail->next = job; }
+   else { poolhead = job; }
+   pooltail = job;
+   pthread_cond_signal( &(poolwork) );
+   pthread_mutex_unlock( &(poollock) );
+}
+
+/**
+ * Wait for completion of the given job
+ * @param compress_job* job : Job to wait on
+ */
+static void waitjob( compress_job* job ) {
+   pthread_mutex_lock( &(poollock) );
+   while ( !(job->done) ) { pthread_cond_wait( &(pooldone), &(poollock) ); }
+   pthread_mutex_unlock( &(poollock) );
+}
+
+/**
+ * Check for completion of the given job, without waiting
+ * @param compress_job* job : Job to check
+ * @return char : 1 if the job is complete, 0 if not
+ */
+static char checkjob( compress_job* job ) {
+   pthread_mutex_lock( &(poollock) );
+   char done = job->done;
+   pthread_mutex_unlock( &(poollock) );
+   return done;
+}
+
+/**
+ * Ensure that the given job has allocated buffers
+ * @param compress_job* job : Job to be prepared
+ * @return int : Zero on success, or -1 on failure
+ */
+static int prepjob( compress_job* job ) {
+   if ( job->in ) { return 0; }
+   size_t buflen = COMPRESS_HEADERSIZE + compressBound( COMPRESS_BLOCKSIZE );
+   job->in = malloc( buflen );
+   job->out = malloc( buflen );
+   if ( job->in == NULL  ||  job->out == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate job buffers\n" );
+      free( job->in );
+      free( job->out );
+      job->in = NULL;
+      job->out = NULL;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Wait for and discard all submitted jobs of the given handle
+ * @param COMPRESS_HANDLE handle : Handle to drop jobs of
+ */
+static void dropjobs( COMPRESS_HANDLE handle ) {
+   for ( ; handle->jobcount; handle->jobcount-- ) {
+      waitjob( handle->jobs + handle->jobhead );
+      handle->jobhead = ( handle->jobhead + 1 ) % COMPRESS_MAXINFLIGHT;
+   }
+}
+
+/**
+ * Free the given handle ( all jobs must have already been completed )
+ * @param COMPRESS_HANDLE handle : Handle to be freed
+ */
+static void freehandle( COMPRESS_HANDLE handle ) {
+   int index = 0;
+   for ( ; index < COMPRESS_MAXINFLIGHT; index++ ) {
+      free( handle->jobs[index].in );
+      free( handle->jobs[index].out );
+   }
+   free( handle->frameoffs );
+   free( handle );
+}
+
+/**
+ * Write out completed frames of the given WRITE handle, in order
+ * @param COMPRESS_HANDLE handle : Handle to write out frames of
+ * @param char waitall : If non-zero, wait for and write out all submitted jobs; otherwise,
+ *                       only wait if no free job remains
+ * @return int : Zero on success, or -1 on failure
+ */
+static int writeframes( COMPRESS_HANDLE handle, char waitall ) {
+   while ( handle->jobcount ) {
+      compress_job* job = handle->jobs + handle->jobhead;
+      if ( !(waitall)  &&  handle->jobcount < COMPRESS_MAXINFLIGHT  &&  !(checkjob( job )) ) { break; }
+      waitjob( job );
+      handle->jobhead = ( handle->jobhead + 1 ) % COMPRESS_MAXINFLIGHT;
+      handle->jobcount--;
+      if ( handle->error ) { continue; } // just clear out all remaining jobs
+      if ( job->error ) {
+         handle->error = job->error;
+         continue;
+      }
+      ssize_t writeres = handle->io.write( handle->io.arg, job->out, job->outlen );
+      if ( writeres < 0  ||  (size_t)writeres != job->outlen ) {
+         LOG( LOG_ERR, "Failed to write out frame %zu\n", job->blockno );
+         handle->error = ( writeres < 0  &&  errno ) ? errno : EIO;
+      }
+   }
+   if ( handle->error ) {
+      errno = handle->error;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Submit the partially / fully populated next block of the given WRITE handle
+ * @param COMPRESS_HANDLE handle : Handle to submit the block of
+ * @return int : Zero on success, or -1 on failure
+ */
+static int submitblock( COMPRESS_HANDLE handle ) {
+   compress_job* job = handle->jobs + ( ( handle->jobhead + handle->jobcount ) % COMPRESS_MAXINFLIGHT );
+   job->type = handle->type;
+   job->level = handle->level;
+   job->decode = 0;
+   job->blockno = handle->nextblock;
+   job->inlen = handle->fill;
+   submitjob( job );
+   handle->jobcount++;
+   handle->nextblock++;
+   handle->fill = 0;
+   // ensure we always have a free job for the next block
+   return writeframes( handle, 0 );
+}
+
+/**
+ * Read from the data object of the given READ handle, failing on any short read
+ * @param COMPRESS_HANDLE handle : Handle to read from
+ * @param void* buf : Buffer to be populated
+ * @param size_t count : Number of bytes to be read
+ * @return ssize_t : Number of bytes read ( zero at the end of the object, otherwise always
+ *                   'count' ), or -1 on failure
+ */
+static ssize_t readraw( COMPRESS_HANDLE handle, void* buf, size_t count ) {
+   ssize_t readres = handle->io.read( handle->io.arg, buf, count );
+   if ( readres < 0 ) {
+      LOG( LOG_ERR, "Failed to read %zu bytes at physical offset %zd\n", count, handle->rawpos );
+      return -1;
+   }
+   if ( readres  &&  (size_t)readres != count ) {
+      LOG( LOG_ERR, "Data object is truncated at physical offset %zd\n", handle->rawpos + readres );
+      errno = EIO;
+      return -1;
+   }
+   handle->rawpos += readres;
+   return readres;
+}
+
+/**
+ * Read the header of the given frame of a READ handle, indexing the position of the next
+ * NOTE -- the data object is left positioned at the start of the frame payload
+ * @param COMPRESS_HANDLE handle : Handle to read from
+ * @param size_t blockno : Block number of the frame ( must be within knownframes )
+ * @param size_t* paylen : Reference to be populated with the frame payload length
+ * @param size_t* loglen : Reference to be populated with the frame logical length
+ * @param char* raw : Reference to be populated with the raw payload flag
+ * @return int : 1 if the header was read, 0 if the frame does not exist, or -1 on failure
+ */
+static int readheader( COMPRESS_HANDLE handle, size_t blockno, size_t* paylen, size_t* loglen, char* raw ) {
+   if ( handle->rawpos != handle->frameoffs[blockno] ) {
+      if ( handle->io.seek( handle->io.arg, handle->frameoffs[blockno] ) != handle->frameoffs[blockno] ) {
+         LOG( LOG_ERR, "Failed to seek to frame %zu at physical offset %zd\n", blockno, handle->frameoffs[blockno] );
+         handle->rawpos = -1; // position is now unknown
+         return -1;
+      }
+      handle->rawpos = handle->frameoffs[blockno];
+   }
+   unsigned char header[COMPRESS_HEADERSIZE];
+   ssize_t readres = readraw( handle, header, COMPRESS_HEADERSIZE );
+   if ( readres <= 0 ) {
+      if ( readres == 0 ) { handle->framecount = blockno; }
+      return (int)readres;
+   }
+   uint32_t headerval = getheaderval( header );
+   *raw = ( headerval & COMPRESS_RAWFLAG ) ? 1 : 0;
+   *paylen = headerval & ~(COMPRESS_RAWFLAG);
+   *loglen = getheaderval( header + 4 );
+   if ( *loglen == 0  ||  *loglen > COMPRESS_BLOCKSIZE  ||  *paylen == 0  ||
+        ( *raw  &&  *paylen != *loglen )  ||  *paylen > compressBound( COMPRESS_BLOCKSIZE ) ) {
+      LOG( LOG_ERR, "Frame %zu has an invalid header ( payload = %zu, logical = %zu )\n", blockno, *paylen, *loglen );
+      errno = EIO;
+      return -1;
+   }
+   // a short frame must be the last
+   if ( *loglen < COMPRESS_BLOCKSIZE ) { handle->framecount = blockno + 1; }
+   // index the position of the next frame
+   if ( blockno + 1 == handle->knownframes ) {
+      if ( handle->knownframes == handle->framealloc ) {
+         size_t newalloc = handle->framealloc * 2;
+         off_t* newoffs = realloc( handle->frameoffs, sizeof(off_t) * newalloc );
+         if ( newoffs == NULL ) {
+            LOG( LOG_ERR, "Failed to expand frame index to %zu entries\n", newalloc );
+            return -1;
+         }
+         handle->frameoffs = newoffs;
+         handle->framealloc = newalloc;
+      }
+      handle->frameoffs[handle->knownframes] = handle->frameoffs[blockno] + COMPRESS_HEADERSIZE + *paylen;
+      handle->knownframes++;
+   }
+   return 1;
+}
+
+/**
+ * Submit a decode job for the next block of the given READ handle
+ * @param COMPRESS_HANDLE handle : Handle to fetch the next block of
+ * @return int : 1 if a job was submitted, 0 if the block does not exist, or -1 on failure
+ */
+static int fetchblock( COMPRESS_HANDLE handle ) {
+   size_t blockno = handle->nextblock;
+   size_t paylen = 0;
+   size_t loglen = 0;
+   char raw = 0;
+   // scan forward through frame headers, until the position of this frame is known
+   while ( handle->knownframes <= blockno ) {
+      if ( handle->framecount != SIZE_MAX ) { return 0; }
+      int scanres = readheader( handle, handle->knownframes - 1, &(paylen), &(loglen), &(raw) );
+      if ( scanres <= 0 ) { return scanres; }
+   }
+   if ( blockno >= handle->framecount ) { return 0; }
+   int headerres = readheader( handle, blockno, &(paylen), &(loglen), &(raw) );
+   if ( headerres <= 0 ) { return headerres; }
+   compress_job* job = handle->jobs + ( ( handle->jobhead + handle->jobcount ) % COMPRESS_MAXINFLIGHT );
+   if ( prepjob( job ) ) { return -1; }
+   job->type = handle->type;
+   job->level = handle->level;
+   job->decode = 1;
+   job->blockno = blockno;
+   job->outlen = loglen;
+   if ( raw ) {
+      // no decoding required
+      ssize_t readres = readraw( handle, job->out, paylen );
+      if ( readres != (ssize_t)paylen ) {
+         if ( readres == 0 ) {
+            LOG( LOG_ERR, "Data object is truncated within frame %zu\n", blockno );
+            errno = EIO;
+         }
+         return -1;
+      }
+      job->error = 0;
+      job->done = 1;
+   }
+   else {
+      job->inlen = paylen;
+      ssize_t readres = readraw( handle, job->in, paylen );
+      if ( readres != (ssize_t)paylen ) {
+         if ( readres == 0 ) {
+            LOG( LOG_ERR, "Data object is truncated within frame %zu\n", blockno );
+            errno = EIO;
+         }
+         return -1;
+      }
+      submitjob( job );
+   }
+   handle->jobcount++;
+   handle->nextblock++;
+   return 1;
+}
+
+/**
+ * Ensure that the oldest job of the given READ handle holds the decoded content of the
+ * block at the current logical position, and that later blocks are being read ahead
+ * @param COMPRESS_HANDLE handle : Handle to load the current block of
+ * @return int : 1 if the block was loaded, 0 if the block does not exist, or -1 on failure
+ */
+static int loadblock( COMPRESS_HANDLE handle ) {
+   // discard any jobs preceding the target block
+   while ( handle->jobcount  &&  handle->jobs[handle->jobhead].blockno != handle->tgtblock ) {
+      if ( handle->jobs[handle->jobhead].blockno > handle->tgtblock ) {
+         dropjobs( handle ); // moved backwards, so every job is useless
+         break;
+      }
+      waitjob( handle->jobs + handle->jobhead );
+      handle->jobhead = ( handle->jobhead + 1 ) % COMPRESS_MAXINFLIGHT;
+      handle->jobcount--;
+   }
+   if ( handle->jobcount == 0 ) {
+      handle->nextblock = handle->tgtblock;
+      int fetchres = fetchblock( handle );
+      if ( fetchres <= 0 ) { return fetchres; }
+   }
+   // read ahead, while the current block is decoded
+   while ( handle->jobcount < COMPRESS_MAXINFLIGHT ) {
+      int fetchres = fetchblock( handle );
+      if ( fetchres < 0 ) { return -1; }
+      if ( fetchres == 0 ) { break; }
+   }
+   compress_job* job = handle->jobs + handle->jobhead;
+   waitjob( job );
+   if ( job->error ) {
+      errno = job->error;
+      return -1;
+   }
+   return 1;
+}
+
+
+//   -------------   EXTERNAL FUNCTIONS    -------------
+
+/**
+ * Open a new COMPRESS_HANDLE, wrapping an already open data object
+ * NOTE -- All io->seek offsets are relative to the start of the first frame, which need
+ *         not be the start of the data object.  A WRITE handle assumes that the data
+ *         object is positioned at that first frame.
+ * @param FTAG_COMPRESSION type : Compression type of the data object
+ * @param int level : Compression level to be used ( zero for the type default; ignored
+ *                    for READ handles )
+ * @param char writing : If non-zero, the handle will produce a new object via io->write;
+ *                       otherwise, it will read an existing object via io->read/seek
+ * @param const COMPRESS_IO* io : Reference to the data object I/O functions
+ *                                ( the struct itself is copied )
+ * @return COMPRESS_HANDLE : Reference to the new handle, or NULL on failure
+ */
+COMPRESS_HANDLE compress_open( FTAG_COMPRESSION type, int level, char writing, const COMPRESS_IO* io ) {
+   // check for invalid args
+   if ( type != FTAG_COMPRESS_ZLIB ) {
+      LOG( LOG_ERR, "Unsupported compression type: %d\n", (int)type );
+      errno = EINVAL;
+      return NULL;
+   }
+   if ( level < 0  ||  level > 9 ) {
+      LOG( LOG_ERR, "Invalid compression level: %d\n", level );
+      errno = EINVAL;
+      return NULL;
+   }
+   if ( io == NULL  ||  ( writing  &&  io->write == NULL )  ||
+        ( !(writing)  &&  ( io->read == NULL  ||  io->seek == NULL ) ) ) {
+      LOG( LOG_ERR, "Received an incomplete COMPRESS_IO reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   COMPRESS_HANDLE handle = calloc( 1, sizeof( struct compress_handle_struct ) );
+   if ( handle == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new handle\n" );
+      return NULL;
+   }
+   handle->type = type;
+   handle->level = level;
+   handle->writing = writing;
+   handle->io = *io;
+   handle->framecount = SIZE_MAX;
+   if ( writing ) {
+      // a WRITE handle will immediately need a block buffer
+      if ( prepjob( handle->jobs ) ) {
+         freehandle( handle );
+         return NULL;
+      }
+      return handle;
+   }
+   handle->framealloc = 64;
+   handle->frameoffs = malloc( sizeof(off_t) * handle->framealloc );
+   if ( handle->frameoffs == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate frame index\n" );
+      freehandle( handle );
+      return NULL;
+   }
+   handle->frameoffs[0] = 0; // the first frame begins the object
+   handle->knownframes = 1;
+   handle->rawpos = -1; // don't assume anything about the current object position
+   return handle;
+}
+
+/**
+ * Read logical data object content from the given READ COMPRESS_HANDLE
+ * @param COMPRESS_HANDLE handle : Handle to read from
+ * @param void* buf : Buffer to be populated
+ * @param size_t count : Number of bytes to be read
+ * @return ssize_t : Number of bytes read ( less than 'count' only at the end of the
+ *                   object ), or -1 on failure
+ */
+ssize_t compress_read( COMPRESS_HANDLE handle, void* buf, size_t count ) {
+   // check for invalid args
+   if ( handle == NULL  ||  handle->writing ) {
+      LOG( LOG_ERR, "Received a NULL or WRITE handle\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( handle->error ) {
+      LOG( LOG_ERR, "Handle is unusable due to a previous failure\n" );
+      errno = handle->error;
+      return -1;
+   }
+   size_t readbytes = 0;
+   while ( readbytes < count ) {
+      int loadres = loadblock( handle );
+      if ( loadres < 0 ) {
+         LOG( LOG_ERR, "Failed to load block %zu\n", handle->tgtblock );
+         handle->error = ( errno ) ? errno : EIO;
+         return -1;
+      }
+      if ( loadres == 0 ) { break; } // end of object
+      compress_job* job = handle->jobs + handle->jobhead;
+      if ( handle->tgtpos >= job->outlen ) { break; } // beyond the end of the final block
+      size_t toread = job->outlen - handle->tgtpos;
+      if ( toread > count - readbytes ) { toread = count - readbytes; }
+      memcpy( (char*)buf + readbytes, job->out + handle->tgtpos, toread );
+      readbytes += toread;
+      handle->tgtpos += toread;
+      if ( handle->tgtpos == job->outlen ) {
+         if ( job->outlen < COMPRESS_BLOCKSIZE ) { break; } // end of object
+         handle->tgtblock++;
+         handle->tgtpos = 0;
+      }
+   }
+   return readbytes;
+}
+
+/**
+ * Seek the given READ COMPRESS_HANDLE to a new logical offset
+ * NOTE -- As with lseek(), an offset beyond the end of the object is not an error, but
+ *         subsequent reads will produce no data.
+ * @param COMPRESS_HANDLE handle : Handle to be seeked
+ * @param off_t offset : Target logical offset
+ * @return off_t : Resulting offset, or -1 on failure
+ */
+off_t compress_seek( COMPRESS_HANDLE handle, off_t offset ) {
+   // check for invalid args
+   if ( handle == NULL  ||  handle->writing ) {
+      LOG( LOG_ERR, "Received a NULL or WRITE handle\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( offset < 0 ) {
+      LOG( LOG_ERR, "Received a negative offset value: %zd\n", offset );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( handle->error ) {
+      LOG( LOG_ERR, "Handle is unusable due to a previous failure\n" );
+      errno = handle->error;
+      return -1;
+   }
+   // the target block is only loaded by the next read
+   handle->tgtblock = offset / COMPRESS_BLOCKSIZE;
+   handle->tgtpos = offset % COMPRESS_BLOCKSIZE;
+   return offset;
+}
+
+/**
+ * Write logical data object content to the given WRITE COMPRESS_HANDLE
+ * NOTE -- Data is compressed and written out asynchronously, so a failure may not be
+ *         reported until a later write or the final compress_close() call.
+ * @param COMPRESS_HANDLE handle : Handle to write to
+ * @param const void* buf : Buffer to be written
+ * @param size_t count : Number of bytes to be written
+ * @return ssize_t : Number of bytes written, or -1 on failure
+ */
+ssize_t compress_write( COMPRESS_HANDLE handle, const void* buf, size_t count ) {
+   // check for invalid args
+   if ( handle == NULL  ||  !(handle->writing) ) {
+      LOG( LOG_ERR, "Received a NULL or READ handle\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( handle->error ) {
+      LOG( LOG_ERR, "Handle is unusable due to a previous failure\n" );
+      errno = handle->error;
+      return -1;
+   }
+   size_t written = 0;
+   while ( written < count ) {
+      compress_job* job = handle->jobs + ( ( handle->jobhead + handle->jobcount ) % COMPRESS_MAXINFLIGHT );
+      if ( prepjob( job ) ) {
+         handle->error = ENOMEM;
+         return -1;
+      }
+      size_t towrite = COMPRESS_BLOCKSIZE - handle->fill;
+      if ( towrite > count - written ) { towrite = count - written; }
+      memcpy( job->in + handle->fill, (const char*)buf + written, towrite );
+      handle->fill += towrite;
+      written += towrite;
+      if ( handle->fill == COMPRESS_BLOCKSIZE  &&  submitblock( handle ) ) {
+         LOG( LOG_ERR, "Failed to output block %zu\n", handle->nextblock - 1 );
+         return -1;
+      }
+   }
+   return written;
+}
+
+/**
+ * Close the given COMPRESS_HANDLE, writing out all remaining content of a WRITE handle
+ * NOTE -- The underlying data object is left open, regardless of the result.
+ * @param COMPRESS_HANDLE handle : Handle to be closed
+ * @return int : Zero on success, or -1 on failure ( the handle is freed in either case )
+ */
+int compress_close( COMPRESS_HANDLE handle ) {
+   // check for invalid args
+   if ( handle == NULL ) {
+      LOG( LOG_ERR, "Received a NULL handle\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   int retval = 0;
+   if ( handle->writing ) {
+      if ( handle->fill  &&  handle->error == 0 ) {
+         // submit the final, partial block
+         compress_job* job = handle->jobs + ( ( handle->jobhead + handle->jobcount ) % COMPRESS_MAXINFLIGHT );
+         job->type = handle->type;
+         job->level = handle->level;
+         job->decode = 0;
+         job->blockno = handle->nextblock++;
+         job->inlen = handle->fill;
+         handle->fill = 0;
+         submitjob( job );
+         handle->jobcount++;
+      }
+      if ( writeframes( handle, 1 ) ) {
+         LOG( LOG_ERR, "Failed to output all blocks\n" );
+         retval = -1;
+      }
+   }
+   dropjobs( handle );
+   int olderrno = errno;
+   freehandle( handle );
+   errno = olderrno;
+   return retval;
+}
+
+/**
+ * Abandon the given COMPRESS_HANDLE, discarding any content not yet written out
+ * NOTE -- The underlying data object is left open.
+ * @param COMPRESS_HANDLE handle : Handle to be abandoned
+ */
+void compress_abort( COMPRESS_HANDLE handle ) {
+   if ( handle == NULL ) { return; }
+   dropjobs( handle );
+   freehandle( handle );
+}
+
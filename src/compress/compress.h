@@ -0,0 +1,160 @@
+#ifndef _COMPRESS_H
+#define _COMPRESS_H
+/*
+Copyright (c) 2015, Los Alamos National Security, LLC
+All rights reserved.
+
+Copyright 2015.  Los Alamos National Security, LLC. This software was
+produced under U.S. Government contract DE-AC52-06NA25396 for Los
+Alamos National Laboratory (LANL), which is operated by Los Alamos
+National Security, LLC for the U.S. Department of Energy. The
+U.S. Government has rights to use, reproduce, and distribute this
+software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL SECURITY,
+LLC MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY
+FOR THE USE OF THIS SOFTWARE.  If software is modified to produce
+derivative works, such modified software should be clearly marked, so
+as not to confuse it with the version available from LANL.
+ 
+Additionally, redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the following
+conditions are met: 1. Redistributions of source code must retain the
+above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of Los Alamos National Security, LLC, Los Alamos
+National Laboratory, LANL, the U.S. Government, nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL LOS
+ALAMOS NATIONAL SECURITY, LLC OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-----
+NOTE:
+-----
+MarFS is released under the BSD license.
+
+MarFS was reviewed and released by LANL under Los Alamos Computer Code
+identifier: LA-CC-15-039.
+
+MarFS uses libaws4c for Amazon S3 object communication. The original version
+is at https://aws.amazon.com/code/Amazon-S3/2601 and under the LGPL license.
+LANL added functionality to the original work. The original work plus
+LANL contributions is found at https://github.com/jti-lanl/aws4c.
+
+GNU licenses can be found at http://www.gnu.org/licenses/.
+*/
+
+#include "tagging/tagging.h"
+
+#include <sys/types.h>
+
+// A COMPRESS_HANDLE translates between the logical content of a single data object and the
+// compressed form of that content, as actually stored.  The logical content is divided into
+// fixed blocks of COMPRESS_BLOCKSIZE bytes ( the final block may be shorter ), each of which
+// is stored as a single frame :
+//    <payload length> <logical length> <payload>
+// Both lengths are 32-bit big-endian values.  The high bit of the payload length indicates
+// that the payload is stored without compression, as is done whenever compression would
+// fail to shrink a block.
+//
+// As every frame but the last holds exactly COMPRESS_BLOCKSIZE logical bytes, the frame
+// containing any logical offset is known without decoding earlier frames.  Frame positions
+// are indexed as they are encountered, so that reseeking to a previously visited frame
+// requires no further header reads.
+//
+// Block compression / decompression is performed by a process-wide pool of worker threads,
+// overlapping that work with the I/O of other blocks.  All data object I/O is performed by
+// the calling thread, via the provided COMPRESS_IO functions.
+
+#define COMPRESS_BLOCKSIZE   ( 1024 * 1024 ) // logical bytes per compressed frame
+#define COMPRESS_HEADERSIZE  8               // byte length of each frame header
+#define COMPRESS_MAXINFLIGHT 4               // maximum count of blocks queued per handle
+#define COMPRESS_MAXTHREADS  8               // maximum count of worker threads
+
+typedef struct compress_io_struct {
+   void*   arg;  // argument passed to all functions below
+   ssize_t (*read)( void* arg, void* buf, size_t count );        // required for READ handles
+   ssize_t (*write)( void* arg, const void* buf, size_t count ); // required for WRITE handles
+   off_t   (*seek)( void* arg, off_t offset );                   // required for READ handles
+} COMPRESS_IO;
+
+typedef struct compress_handle_struct* COMPRESS_HANDLE;
+
+/**
+ * Open a new COMPRESS_HANDLE, wrapping an already open data object
+ * NOTE -- All io->seek offsets are relative to the start of the first frame, which need
+ *         not be the start of the data object.  A WRITE handle assumes that the data
+ *         object is positioned at that first frame.
+ * @param FTAG_COMPRESSION type : Compression type of the data object
+ * @param int level : Compression level to be used ( zero for the type default; ignored
+ *                    for READ handles )
+ * @param char writing : If non-zero, the handle will produce a new object via io->write;
+ *                       otherwise, it will read an existing object via io->read/seek
+ * @param const COMPRESS_IO* io : Reference to the data object I/O functions
+ *                                ( the struct itself is copied )
+ * @return COMPRESS_HANDLE : Reference to the new handle, or NULL on failure
+ */
+COMPRESS_HANDLE compress_open( FTAG_COMPRESSION type, int level, char writing, const COMPRESS_IO* io );
+
+/**
+ * Read logical data object content from the given READ COMPRESS_HANDLE
+ * @param COMPRESS_HANDLE handle : Handle to read from
+ * @param void* buf : Buffer to be populated
+ * @param size_t count : Number of bytes to be read
+ * @return ssize_t : Number of bytes read ( less than 'count' only at the end of the
+ *                   object ), or -1 on failure
+ */
+ssize_t compress_read( COMPRESS_HANDLE handle, void* buf, size_t count );
+
+/**
+ * Seek the given READ COMPRESS_HANDLE to a new logical offset
+ * NOTE -- As with lseek(), an offset beyond the end of the object is not an error, but
+ *         subsequent reads will produce no data.
+ * @param COMPRESS_HANDLE handle : Handle to be seeked
+ * @param off_t offset : Target logical offset
+ * @return off_t : Resulting offset, or -1 on failure
+ */
+off_t compress_seek( COMPRESS_HANDLE handle, off_t offset );
+
+/**
+ * Write logical data object content to the given WRITE COMPRESS_HANDLE
+ * NOTE -- Data is compressed and written out asynchronously, so a failure may not be
+ *         reported until a later write or the final compress_close() call.
+ * @param COMPRESS_HANDLE handle : Handle to write to
+ * @param const void* buf : Buffer to be written
+ * @param size_t count : Number of bytes to be written
+ * @return ssize_t : Number of bytes written, or -1 on failure
+ */
+ssize_t compress_write( COMPRESS_HANDLE handle, const void* buf, size_t count );
+
+/**
+ * Close the given COMPRESS_HANDLE, writing out all remaining content of a WRITE handle
+ * NOTE -- The underlying data object is left open, regardless of the result.
+ * @param COMPRESS_HANDLE handle : Handle to be closed
+ * @return int : Zero on success, or -1 on failure ( the handle is freed in either case )
+ */
+int compress_close( COMPRESS_HANDLE handle );
+
+/**
+ * Abandon the given COMPRESS_HANDLE, discarding any content not yet written out
+ * NOTE -- The underlying data object is left open.
+ * @param COMPRESS_HANDLE handle : Handle to be abandoned
+ */
+void compress_abort( COMPRESS_HANDLE handle );
+
+#endif // _COMPRESS_H
+
@@ -0,0 +1,301 @@
+/*
+Copyright (c) 2015, Los Alamos National Security, LLC
+All rights reserved.
+
+Copyright 2015.  Los Alamos National Security, LLC. This software was
+produced under U.S. Government contract DE-AC52-06NA25396 for Los
+Alamos National Laboratory (LANL), which is operated by Los Alamos
+National Security, LLC for the U.S. Department of Energy. The
+U.S. Government has rights to use, reproduce, and distribute this
+software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL SECURITY,
+LLC MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY
+FOR THE USE OF THIS SOFTWARE.  If software is modified to produce
+derivative works, such modified software should be clearly marked, so
+as not to confuse it with the version available from LANL.
+ 
+Additionally, redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the following
+conditions are met: 1. Redistributions of source code must retain the
+above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of Los Alamos National Security, LLC, Los Alamos
+National Laboratory, LANL, the U.S. Government, nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL LOS
+ALAMOS NATIONAL SECURITY, LLC OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-----
+NOTE:
+-----
+MarFS is released under the BSD license.
+
+MarFS was reviewed and released by LANL under Los Alamos Computer Code
+identifier: LA-CC-15-039.
+
+MarFS uses libaws4c for Amazon S3 object communication. The original version
+is at https://aws.amazon.com/code/Amazon-S3/2601 and under the LGPL license.
+LANL added functionality to the original work. The original work plus
+LANL contributions is found at https://github.com/jti-lanl/aws4c.
+
+GNU licenses can be found at http://www.gnu.org/licenses/.
+*/
+
+#include "compress/compress.c"
+
+#include <stdio.h>
+
+// simple in-memory data object
+typedef struct memobj_struct {
+   char*  data;
+   size_t len;
+   size_t alloc;
+   off_t  pos;
+   char   failwrites;
+} memobj;
+
+ssize_t memread( void* arg, void* buf, size_t count ) {
+   memobj* obj = (memobj*)arg;
+   if ( obj->pos >= obj->len ) { return 0; }
+   if ( count > obj->len - obj->pos ) { count = obj->len - obj->pos; }
+   memcpy( buf, obj->data + obj->pos, count );
+   obj->pos += count;
+   return count;
+}
+
+ssize_t memwrite( void* arg, const void* buf, size_t count ) {
+   memobj* obj = (memobj*)arg;
+   if ( obj->failwrites ) { errno = ENOSPC; return -1; }
+   if ( obj->len + count > obj->alloc ) {
+      size_t newalloc = ( obj->len + count ) * 2;
+      char* newdata = realloc( obj->data, newalloc );
+      if ( newdata == NULL ) { return -1; }
+      obj->data = newdata;
+      obj->alloc = newalloc;
+   }
+   memcpy( obj->data + obj->len, buf, count );
+   obj->len += count;
+   return count;
+}
+
+off_t memseek( void* arg, off_t offset ) {
+   memobj* obj = (memobj*)arg;
+   obj->pos = offset;
+   return offset;
+}
+
+/**
+ * Produce a compressed copy of the given content, written out in 'chunk' byte pieces
+ */
+int writeobj( memobj* obj, const char* content, size_t len, size_t chunk ) {
+   COMPRESS_IO io = { .arg = obj, .read = NULL, .write = memwrite, .seek = NULL };
+   COMPRESS_HANDLE handle = compress_open( FTAG_COMPRESS_ZLIB, 3, 1, &(io) );
+   if ( handle == NULL ) {
+      printf( "failed to open WRITE handle\n" );
+      return -1;
+   }
+   size_t written = 0;
+   while ( written < len ) {
+      size_t towrite = ( len - written > chunk ) ? chunk : len - written;
+      if ( compress_write( handle, content + written, towrite ) != towrite ) {
+         printf( "failed to write %zu bytes at offset %zu\n", towrite, written );
+         compress_abort( handle );
+         return -1;
+      }
+      written += towrite;
+   }
+   if ( compress_close( handle ) ) {
+      printf( "failed to close WRITE handle\n" );
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Verify that a read of 'count' bytes at 'offset' matches the original content
+ */
+int checkread( COMPRESS_HANDLE handle, const char* content, size_t len, off_t offset, size_t count ) {
+   if ( compress_seek( handle, offset ) != offset ) {
+      printf( "failed to seek to offset %zd\n", offset );
+      return -1;
+   }
+   char* buf = malloc( count + 1 );
+   if ( buf == NULL ) { printf( "failed to allocate read buffer\n" ); return -1; }
+   size_t expected = ( offset >= len ) ? 0 : ( len - offset > count ) ? count : len - offset;
+   ssize_t readres = compress_read( handle, buf, count );
+   if ( readres != expected ) {
+      printf( "read of %zu bytes at offset %zd returned %zd ( expected %zu )\n", count, offset, readres, expected );
+      free( buf );
+      return -1;
+   }
+   if ( expected  &&  memcmp( buf, content + offset, expected ) ) {
+      printf( "read of %zu bytes at offset %zd produced mismatched content\n", count, offset );
+      free( buf );
+      return -1;
+   }
+   free( buf );
+   return 0;
+}
+
+int main( int argc, char** argv ) {
+
+   // NOTE -- I'm ignoring memory leaks for error conditions
+   //         which result in immediate termination
+
+   // produce content with a mix of compressible and incompressible blocks
+   size_t contentlen = ( COMPRESS_BLOCKSIZE * 3 ) + ( COMPRESS_BLOCKSIZE / 2 );
+   char* content = malloc( contentlen );
+   if ( content == NULL ) { printf( "failed to allocate content\n" ); return -1; }
+   size_t index = 0;
+   for ( ; index < contentlen; index++ ) {
+      if ( index / COMPRESS_BLOCKSIZE == 1 ) { content[index] = (char)rand(); }
+      else { content[index] = "compressible content "[index % 21]; }
+   }
+
+   // write it out, and verify that it actually shrank
+   memobj obj = { .data = NULL, .len = 0, .alloc = 0, .pos = 0, .failwrites = 0 };
+   if ( writeobj( &(obj), content, contentlen, 7777 ) ) { return -1; }
+   if ( obj.len >= contentlen  ||  obj.len <= COMPRESS_BLOCKSIZE ) {
+      printf( "unexpected compressed object length: %zu\n", obj.len );
+      return -1;
+   }
+   // the second frame should have been stored without compression
+   size_t firstpay = getheaderval( (unsigned char*)obj.data );
+   if ( ( firstpay & COMPRESS_RAWFLAG )  ||
+        !( getheaderval( (unsigned char*)obj.data + COMPRESS_HEADERSIZE + firstpay ) & COMPRESS_RAWFLAG ) ) {
+      printf( "unexpected raw flag values of the initial frames\n" );
+      return -1;
+   }
+
+   // read it back, sequentially
+   COMPRESS_IO io = { .arg = &(obj), .read = memread, .write = NULL, .seek = memseek };
+   COMPRESS_HANDLE handle = compress_open( FTAG_COMPRESS_ZLIB, 0, 0, &(io) );
+   if ( handle == NULL ) {
+      printf( "failed to open READ handle\n" );
+      return -1;
+   }
+   char* readbuf = malloc( contentlen );
+   if ( readbuf == NULL ) { printf( "failed to allocate read buffer\n" ); return -1; }
+   size_t readbytes = 0;
+   while ( readbytes < contentlen ) {
+      size_t toread = ( contentlen - readbytes > 10000 ) ? 10000 : contentlen - readbytes;
+      if ( compress_read( handle, readbuf + readbytes, toread ) != toread ) {
+         printf( "failed sequential read at offset %zu\n", readbytes );
+         return -1;
+      }
+      readbytes += toread;
+   }
+   if ( memcmp( readbuf, content, contentlen ) ) {
+      printf( "sequential read produced mismatched content\n" );
+      return -1;
+   }
+   if ( compress_read( handle, readbuf, 10 ) != 0 ) {
+      printf( "read at end of object produced data\n" );
+      return -1;
+   }
+   free( readbuf );
+
+   // read at various offsets, including backwards seeks and reads spanning frames
+   if ( checkread( handle, content, contentlen, 123, 5000 )  ||
+        checkread( handle, content, contentlen, COMPRESS_BLOCKSIZE * 2 + 5, 100 )  ||
+        checkread( handle, content, contentlen, COMPRESS_BLOCKSIZE - 50, 200 )  ||
+        checkread( handle, content, contentlen, COMPRESS_BLOCKSIZE * 3 - 10, COMPRESS_BLOCKSIZE )  ||
+        checkread( handle, content, contentlen, 0, contentlen + 10 )  ||
+        checkread( handle, content, contentlen, contentlen, 10 )  ||
+        checkread( handle, content, contentlen, contentlen + 12345, 10 ) ) {
+      return -1;
+   }
+   if ( compress_close( handle ) ) {
+      printf( "failed to close READ handle\n" );
+      return -1;
+   }
+
+   // a fresh handle must locate frames by scanning headers alone
+   if ( (handle = compress_open( FTAG_COMPRESS_ZLIB, 0, 0, &(io) )) == NULL ) {
+      printf( "failed to open second READ handle\n" );
+      return -1;
+   }
+   if ( checkread( handle, content, contentlen, COMPRESS_BLOCKSIZE * 3 + 17, 1000 )  ||
+        checkread( handle, content, contentlen, 17, 1000 ) ) {
+      return -1;
+   }
+   compress_abort( handle );
+
+   // an object ending on a block boundary
+   memobj evenobj = { .data = NULL, .len = 0, .alloc = 0, .pos = 0, .failwrites = 0 };
+   if ( writeobj( &(evenobj), content, COMPRESS_BLOCKSIZE * 2, COMPRESS_BLOCKSIZE * 2 ) ) { return -1; }
+   io.arg = &(evenobj);
+   if ( (handle = compress_open( FTAG_COMPRESS_ZLIB, 0, 0, &(io) )) == NULL ) {
+      printf( "failed to open READ handle for even object\n" );
+      return -1;
+   }
+   if ( checkread( handle, content, COMPRESS_BLOCKSIZE * 2, COMPRESS_BLOCKSIZE * 2 - 3, 10 )  ||
+        checkread( handle, content, COMPRESS_BLOCKSIZE * 2, COMPRESS_BLOCKSIZE * 2, 10 )  ||
+        checkread( handle, content, COMPRESS_BLOCKSIZE * 2, 0, COMPRESS_BLOCKSIZE * 3 ) ) {
+      return -1;
+   }
+   compress_abort( handle );
+   free( evenobj.data );
+
+   // corrupt the first frame, and verify that reads of it fail
+   obj.data[COMPRESS_HEADERSIZE + 10] ^= 0xff;
+   io.arg = &(obj);
+   if ( (handle = compress_open( FTAG_COMPRESS_ZLIB, 0, 0, &(io) )) == NULL ) {
+      printf( "failed to open READ handle for corrupt object\n" );
+      return -1;
+   }
+   char smallbuf[100];
+   if ( compress_read( handle, smallbuf, 100 ) >= 0 ) {
+      printf( "read of a corrupt frame did not fail\n" );
+      return -1;
+   }
+   if ( compress_seek( handle, 0 ) >= 0 ) {
+      printf( "seek of a failed handle did not fail\n" );
+      return -1;
+   }
+   compress_abort( handle );
+   free( obj.data );
+
+   // verify that write failures are reported by close
+   memobj failobj = { .data = NULL, .len = 0, .alloc = 0, .pos = 0, .failwrites = 1 };
+   io.arg = &(failobj);
+   io.write = memwrite;
+   if ( (handle = compress_open( FTAG_COMPRESS_ZLIB, 0, 1, &(io) )) == NULL ) {
+      printf( "failed to open WRITE handle for failing object\n" );
+      return -1;
+   }
+   if ( compress_write( handle, content, 1000 ) != 1000 ) {
+      printf( "buffered write unexpectedly failed\n" );
+      return -1;
+   }
+   if ( compress_close( handle ) == 0 ) {
+      printf( "close of a failing WRITE handle did not fail\n" );
+      return -1;
+   }
+
+   // verify rejection of invalid args
+   if ( compress_open( FTAG_COMPRESS_NONE, 0, 1, &(io) ) != NULL  ||
+        compress_open( FTAG_COMPRESS_ZLIB, 10, 1, &(io) ) != NULL ) {
+      printf( "invalid open args were not rejected\n" );
+      return -1;
+   }
+
+   free( content );
+   return 0;
+}
+
@@ -90,6 +90,18 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
  *             <max_size>1G</max_size>
  *          </chunking>
  *
+ *          <!-- Object Compression -->
+ *          <compression enabled="yes">
+ *             <type>zlib</type>
+ *             <level>6</level>
+ *          </compression>
+ *
+ *          <!-- Local Object Cache -->
+ *          <localcache enabled="yes">
+ *             <path>/local/nvme/marfs-cache</path>
+ *             <max_size>500G</max_size>
+ *          </localcache>
+ *
  *          <!-- Object Distribution -->
  *          <distribution>
  *             <pods dweight=2>4:0=1,3=5</pods>
@@ -171,7 +183,14 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 #include "general_include/numdigits.h"
 #include "general_include/restrictedchars.h"
 
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <libxml/tree.h>
+#include <libxml/parser.h>
 
 #ifndef LIBXML_TREE_ENABLED
 #error "Included Libxml2 does not support tree functionality!"
@@ -204,6 +223,143 @@ char* config_prevpathelem( char* path, char* curpath ) {
    return curpath;
 }
 
+/**
+ * Free the given GhostNS view
+ * NOTE -- This should only be called for views which are not referenced by any position
+ * @param marfs_ns* view : Reference to the view to be freed
+ */
+void free_ghostview( marfs_ns* view ) {
+   if ( view->subspaces ) { hash_term( view->subspaces, NULL, NULL ); }
+   if ( view->subnodes ) { free( view->subnodes ); }
+   if ( view->idstr ) { free( view->idstr ); }
+   free( view );
+}
+
+/**
+ * Locate an existing view of the given GhostNS, targeting the given NS
+ * NOTE -- On success, the returned view will have an additional reference taken
+ *         ( see config_destroynsref() )
+ * @param marfs_ns* ghost : GhostNS to search the views of
+ * @param marfs_ns* target : Target NS of the view
+ * @return marfs_ns* : Reference to the matching view, or NULL if none exists
+ */
+marfs_ns* find_ghostview( marfs_ns* ghost, marfs_ns* target ) {
+   // views are never removed from the list, and are immutable once published
+   marfs_ns* view = __atomic_load_n( &(ghost->ghviews), __ATOMIC_ACQUIRE );
+   for ( ; view; view = view->ghnext ) {
+      if ( view->ghtarget == target ) {
+         __atomic_add_fetch( &(view->ghrefs), 1, __ATOMIC_RELAXED );
+         return view;
+      }
+   }
+   return NULL;
+}
+
+/**
+ * Create a view of the given GhostNS, targeting the given NS
+ * NOTE -- Views are shared by all positions ( across all threads ) which reference the same
+ *         GhostNS / target pair, and persist until the GhostNS itself is freed.  If a matching
+ *         view is published by another thread in the interim, that view is returned instead.
+ * @param marfs_ns* ghost : GhostNS to create a view of
+ * @param marfs_ns* target : Target NS of the view
+ * @param char* idstr : ID string of the new view
+ *                      NOTE -- This string is consumed by this func, regardless of success
+ * @return marfs_ns* : Reference to the view ( with an additional reference taken ), or NULL on failure
+ */
+marfs_ns* create_ghostview( marfs_ns* ghost, marfs_ns* target, char* idstr ) {
+   marfs_ns* view = malloc( sizeof( struct marfs_namespace_struct ) );
+   if ( view == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate space for a new view of GhostNS \"%s\"\n", ghost->idstr );
+      free( idstr );
+      return NULL;
+   }
+   view->idstr = idstr;
+   // Store the original GhostNS as our source, and the new NS as our target
+   view->ghsource = ghost;
+   view->ghtarget = target;
+   view->ghviews = NULL;
+   view->ghnext = NULL;
+   view->ghrefs = 1;
+   // Parent NS and repo of the view match those of the target
+   view->pnamespace = target->pnamespace;
+   view->prepo = target->prepo;
+   // Quotas become the 'lesser' values, between the original Ghost and the target
+   //    ( with zero considered the 'greatest', unlimited, value )
+   view->fquota = ghost->fquota;
+   if ( target->fquota  &&  (target->fquota < view->fquota  ||  view->fquota == 0 ) ) {
+      view->fquota = target->fquota;
+   }
+   view->dquota = ghost->dquota;
+   if ( target->dquota  &&  (target->dquota < view->dquota  ||  view->dquota == 0 ) ) {
+      view->dquota = target->dquota;
+   }
+   // Permissions become the most restrictive set, between the Ghost and its target
+   view->iperms = ( ghost->iperms & target->iperms );
+   view->bperms = ( ghost->bperms & target->bperms );
+   // Subspaces become a copy of the target NS subspaces, EXCLUDING ALL GHOSTS
+   //    ( Ghost inclusion implies possible FS loop )
+   HASH_NODE* parsenode = target->subnodes;
+   size_t parsecount = 0;
+   view->subnodecount = 0;
+   // count up non-ghost children of the target
+   for ( ; parsecount < target->subnodecount; parsecount++ ) {
+      if ( ( (marfs_ns*)parsenode->content )->ghtarget == NULL ) { view->subnodecount++; }
+      parsenode++;
+   }
+   view->subspaces = NULL;
+   view->subnodes = NULL;
+   if ( view->subnodecount ) {
+      // allocate subspace list
+      view->subnodes = malloc( sizeof( HASH_NODE ) * view->subnodecount );
+      if ( view->subnodes == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate subnode list for view of GhostNS: \"%s\"\n", view->idstr );
+         free_ghostview( view );
+         return NULL;
+      }
+      // copy non-GhostNS nodes
+      parsenode = target->subnodes;
+      size_t nodeindex = 0;
+      for ( parsecount = 0; parsecount < target->subnodecount; parsecount++ ) {
+         if ( ( (marfs_ns*)parsenode->content )->ghtarget == NULL ) {
+            HASH_NODE* editnode = view->subnodes + nodeindex;
+            nodeindex++;
+            // just directly copy hash node values, rather than duplicating
+            editnode->name = parsenode->name;
+            editnode->weight = parsenode->weight;
+            editnode->content = parsenode->content;
+            if ( nodeindex == view->subnodecount ) { break; } // potentially exit early
+         }
+         parsenode++;
+      }
+      // establish the subspace table
+      view->subspaces = hash_init( view->subnodes, view->subnodecount, 1 );
+      if ( view->subspaces == NULL ) {
+         LOG( LOG_ERR, "Failed to initialize subspace table for view of GhostNS: \"%s\"\n", view->idstr );
+         free_ghostview( view );
+         return NULL;
+      }
+   }
+   // publish the new view, unless another thread has beaten us to it
+   marfs_ns* listhead = __atomic_load_n( &(ghost->ghviews), __ATOMIC_ACQUIRE );
+   marfs_ns* checkedhead = NULL;
+   do {
+      // check over any views published since our last pass
+      marfs_ns* parseview = listhead;
+      for ( ; parseview != checkedhead; parseview = parseview->ghnext ) {
+         if ( parseview->ghtarget == target ) {
+            LOG( LOG_INFO, "Using concurrently created view of GhostNS \"%s\": \"%s\"\n", ghost->idstr, parseview->idstr );
+            __atomic_add_fetch( &(parseview->ghrefs), 1, __ATOMIC_RELAXED );
+            free_ghostview( view );
+            return parseview;
+         }
+      }
+      checkedhead = listhead;
+      view->ghnext = listhead;
+   } while ( !__atomic_compare_exchange_n( &(ghost->ghviews), &(listhead), view, 0, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE ) );
+   LOG( LOG_INFO, "Created view of GhostNS \"%s\": \"%s\"\n", ghost->idstr, view->idstr );
+   return view;
+}
+
 /**
  * Update the given position to reference a new NS
  * NOTE -- This exists primarily due to the complexity of Ghost namespace transitions
@@ -264,7 +420,6 @@ int config_enterns( marfs_position* pos, marfs_ns* nextns, const char* relpath,
       }
 
       // we are moving into a new ghost ( nextns->ghtarget != NULL )
-      marfs_ns* tgtns = NULL;
 
       // sanity check : should be impossible for a standard NS to be a child of a ghost
       if ( ascending ) {
@@ -272,92 +427,24 @@ int config_enterns( marfs_position* pos, marfs_ns* nextns, const char* relpath,
          config_abandonposition( pos );
          return -1;
       }
-      // need to allocate a fresh NS struct to hold ghost state
-      tgtns = malloc( sizeof( struct marfs_namespace_struct ) );
+      // identify the shared view of the Ghost, targeting the Ghost's own target
+      marfs_ns* tgtns = find_ghostview( nextns, nextns->ghtarget );
       if ( tgtns == NULL ) {
-         LOG( LOG_ERR, "Failed to allocate space for a new GhostNS\n" );
-         config_abandonposition( pos );
-         return -1;
-      }
-      // Store the original GhostNS as our source ( will never change for this copy )
-      tgtns->ghsource = nextns;
-      // Target of the copy should match that of the Ghost itself
-      tgtns->ghtarget = nextns->ghtarget;
-      // Parent NS of the copy should match that of the Ghost Target ( this parent can never appear as a child )
-      tgtns->pnamespace = nextns->ghtarget->pnamespace;
-      // Parent repo of the copy should match that of the target
-      tgtns->prepo = nextns->ghtarget->prepo;
-      // ID String becomes a copy of the GhostNS itself ( for now )
-      tgtns->idstr = strdup( nextns->idstr );
-      if ( tgtns->idstr == NULL ) {
-         LOG( LOG_ERR, "Failed to duplicate tgtNS ID string for copy of GhostNS: \"%s\"\n", nextns->idstr );
-         free( tgtns );
-         config_abandonposition( pos );
-         return -1;
-      }
-      // Ghost copy inherits most of the GhostTgtNS values with slight modification
-      // Quotas become the 'lesser' values, between the Ghost and its target
-      //    ( with zero considered the 'greatest', unlimited, value )
-      tgtns->fquota = nextns->fquota;
-      if ( nextns->ghtarget->fquota  &&  (nextns->ghtarget->fquota < tgtns->fquota  ||  tgtns->fquota == 0 ) ) {
-         tgtns->fquota = nextns->ghtarget->fquota;
-      }
-      tgtns->dquota = nextns->dquota;
-      if ( nextns->ghtarget->dquota  &&  (nextns->ghtarget->dquota < tgtns->dquota  ||  tgtns->dquota == 0 ) ) {
-         tgtns->dquota = nextns->ghtarget->dquota;
-      }
-      // Permissions become the most restrictive set, between the Ghost at its target
-      tgtns->iperms = ( nextns->iperms & nextns->ghtarget->iperms );
-      tgtns->bperms = ( nextns->bperms & nextns->ghtarget->bperms );
-      // Subspaces become a copy of the Ghost's target NS subspaces, EXCLUDING ALL GHOSTS
-      //    ( Ghost inclusion implies possible FS loop )
-      HASH_NODE* parsenode = nextns->ghtarget->subnodes;
-      size_t parsecount = 0;
-      tgtns->subnodecount = 0;
-      // count up non-ghost children of the target
-      for ( ; parsecount < nextns->ghtarget->subnodecount; parsecount++ ) {
-         if ( ( (marfs_ns*)parsenode->content )->ghtarget == NULL ) { tgtns->subnodecount++; }
-         parsenode++;
-      }
-      tgtns->subspaces = NULL;
-      tgtns->subnodes = NULL;
-      if ( tgtns->subnodecount ) {
-         // allocate subspace list
-         tgtns->subnodes = malloc( sizeof( HASH_NODE ) * tgtns->subnodecount );
-         if ( tgtns->subnodes == NULL ) {
-            LOG( LOG_ERR, "Failed to allocate subnode list for copy of GhostNS: \"%s\"\n", nextns->idstr );
-            free( tgtns->idstr );
-            free( tgtns );
+         // ID String of this view matches that of the GhostNS itself
+         char* tgtidstr = strdup( nextns->idstr );
+         if ( tgtidstr == NULL ) {
+            LOG( LOG_ERR, "Failed to duplicate ID string of GhostNS: \"%s\"\n", nextns->idstr );
             config_abandonposition( pos );
             return -1;
          }
-         // copy non-GhostNS nodes
-         parsenode = nextns->ghtarget->subnodes;
-         size_t nodeindex = 0;
-         for ( parsecount = 0; parsecount < nextns->ghtarget->subnodecount; parsecount++ ) {
-            if ( ( (marfs_ns*)parsenode->content )->ghtarget == NULL ) {
-               HASH_NODE* editnode = tgtns->subnodes + nodeindex;
-               nodeindex++;
-               // just directly copy hash node values, rather than duplicating
-               editnode->name = parsenode->name;
-               editnode->weight = parsenode->weight;
-               editnode->content = parsenode->content;
-               if ( nodeindex == tgtns->subnodecount ) { break; } // potentially exit early
-            }
-            parsenode++;
-         }
-         // establish the subspace table
-         tgtns->subspaces = hash_init( tgtns->subnodes, tgtns->subnodecount, 1 );
-         if ( tgtns->subspaces == NULL ) {
-            LOG( LOG_ERR, "Failed to initialize subspace table for copy of GhostNS: \"%s\"\n", nextns->idstr );
-            free( tgtns->subnodes );
-            free( tgtns->idstr );
-            free( tgtns );
+         tgtns = create_ghostview( nextns, nextns->ghtarget, tgtidstr );
+         if ( tgtns == NULL ) {
+            LOG( LOG_ERR, "Failed to create initial view of GhostNS: \"%s\"\n", nextns->idstr );
             config_abandonposition( pos );
             return -1;
          }
       }
-      // provide the new, dynamically allocated NS target
+      // provide the view as our new NS target
       pos->ns = tgtns;
       // GhostNS contexts must always be freshly created
       if ( pos->ctxt  &&  curns->prepo->metascheme.mdal->destroyctxt( pos->ctxt ) ) {
@@ -368,12 +455,12 @@ int config_enterns( marfs_position* pos, marfs_ns* nextns, const char* relpath,
       if ( updatectxt ) {
          // generate a new 'split' ctxt
          if ( config_fortifyposition( pos ) ) {
-            LOG( LOG_ERR, "Failed to generate split ctxt for new GhostNS copy: \"%s\"\n", tgtns->idstr );
+            LOG( LOG_ERR, "Failed to generate split ctxt for view of GhostNS: \"%s\"\n", tgtns->idstr );
             config_abandonposition( pos );
             return -1;
          }
       }
-      LOG( LOG_INFO, "Entered newly created copy of GhostNS \"%s\" from parent NS \"%s\"\n", tgtns->idstr, curns->idstr );
+      LOG( LOG_INFO, "Entered view of GhostNS \"%s\" from parent NS \"%s\"\n", tgtns->idstr, curns->idstr );
       return 0;
    }
 
@@ -385,9 +472,9 @@ int config_enterns( marfs_position* pos, marfs_ns* nextns, const char* relpath,
       // we are exiting the ghost dimension!
       pos->ns = curns->ghsource->pnamespace;
       // GhostNS contexts must always be destroyed
-      if ( pos->ctxt  &&  curns->ghtarget->prepo->metascheme.mdal->destroyctxt( pos->ctxt ) ) {
+      if ( pos->ctxt  &&  curns->prepo->metascheme.mdal->destroyctxt( pos->ctxt ) ) {
          // nothing to do but complain
-         LOG( LOG_WARNING, "Failed to destroy MDAL_CTXT for active copy of GhostNS \"%s\"\n", curns->idstr );
+         LOG( LOG_WARNING, "Failed to destroy MDAL_CTXT for view of GhostNS \"%s\"\n", curns->idstr );
       }
       pos->ctxt = NULL;
       // potentially recreate
@@ -412,186 +499,113 @@ int config_enterns( marfs_position* pos, marfs_ns* nextns, const char* relpath,
       config_abandonposition( pos );
       return -1;
    }
-   // Target the new NS
-   curns->ghtarget = nextns;
-   // Parent NS of the copy should match that of the target
-   curns->pnamespace = nextns->pnamespace;
-//   if ( nextns == curns->ghsource->ghtarget ) {
-//      // special case, reentering the origianl NS target means we must inherit the original Ghost's parent
-//      //    We're redirecting, such that further ascent will exit the Ghost rather than continue up the tree
-//      LOG( LOG_INFO, "Redirecting parent of active Ghost copy \"%s\" to \"%s\"\n",
-//                     curns->idstr, curns->ghsource->pnamespace->idstr );
-//      curns->pnamespace = curns->ghsource->pnamespace;
-//      // sanity check : this should only ever happen when ascending
-//      if ( !(ascending) ) {
-//         LOG( LOG_ERR, "Encountered original target NS \"%s\" of GhostNS \"%s\" when NOT ascending\n", nextns->idstr, curns->ghsource->idstr );
-//         config_abandonposition( pos );
-//         return -1;
-//      }
-//   }
-   // Parent repo always matches the target
-   curns->prepo = nextns->prepo;
-   // ID String manipulation depends on direction
-   char* repostr;
-   char* nspath;
-   if ( config_nsinfo( curns->idstr, &(repostr), &(nspath) ) ) {
-      LOG( LOG_ERR, "Failed to identify NS path value of active Ghost copy: \"%s\"\n", curns->idstr );
-      config_abandonposition( pos );
-      return -1;
-   }
-   if ( ascending ) {
-      // we need to strip off the last path component
-      char* parsepath = nspath;
-      char* prevelem = NULL;
-      while ( *parsepath != '\0' ) {
-         if ( *parsepath == '/' ) {
-            prevelem = parsepath;
-            while ( *parsepath == '/' ) { parsepath++; } // skip any repeated slashes
-            continue;
-         }
-         parsepath++;
-      }
-      if ( prevelem == NULL ) {
-         LOG( LOG_ERR, "Failed to identify final path component of NS string: \"%s\"\n", nspath );
-         free( repostr );
-         free( nspath );
-         config_abandonposition( pos );
-         return -1;
-      }
-      if ( prevelem == nspath ) {
-         // sanity check for truncation of the entire nspath string
-         LOG( LOG_ERR, "Ascent from \"%s\" to \"%s\" would result in fully-truncated nspath\n", curns->idstr, nextns->idstr );
-         free( repostr );
-         free( nspath );
-         config_abandonposition( pos );
-         return -1;
-      }
-      // just truncate the string directly
-      *prevelem = '\0';
-      // allocate a new ID string
-      size_t newstrlen = strlen(repostr) + 1 + strlen(nspath) + 1;
-      char* tmpidstr = malloc( sizeof( char ) * newstrlen );
-      if ( tmpidstr == NULL ) {
-         LOG( LOG_ERR, "Failed to allocate a new ID string (ascending)\n" );
-         free( repostr );
-         free( nspath );
-         config_abandonposition( pos );
-         return -1;
-      }
-      if ( snprintf( tmpidstr, newstrlen, "%s|%s", repostr, nspath ) < 2 ) {
-         LOG( LOG_ERR, "Failed to populate new ID string (ascending)\n" );
-         free( tmpidstr );
-         free( repostr );
-         free( nspath );
+   // identify the shared view of the Ghost, targeting the new NS
+   marfs_ns* tgtns = find_ghostview( curns->ghsource, nextns );
+   if ( tgtns == NULL ) {
+      // ID String of the new view is derived from our current one, and depends on direction
+      char* repostr;
+      char* nspath;
+      if ( config_nsinfo( curns->idstr, &(repostr), &(nspath) ) ) {
+         LOG( LOG_ERR, "Failed to identify NS path value of GhostNS view: \"%s\"\n", curns->idstr );
          config_abandonposition( pos );
          return -1;
       }
-      free( repostr );
-      free( nspath );
-      free( curns->idstr );
-      curns->idstr = tmpidstr;
-   }
-   else {
-      // we need to append the next relative path component
-      size_t newstrlen = strlen(repostr) + 1 + strlen(nspath) + 1 + strlen(relpath) + 1;
-      char* tmpidstr = malloc( sizeof(char) * newstrlen );
-      if ( tmpidstr == NULL ) {
-         LOG( LOG_ERR, "Failed to allocate a new ID string (descending)\n" );
-         free( repostr );
-         free( nspath );
-         config_abandonposition( pos );
-         return -1;
+      char* tmpidstr = NULL;
+      if ( ascending ) {
+         // we need to strip off the last path component
+         char* parsepath = nspath;
+         char* prevelem = NULL;
+         while ( *parsepath != '\0' ) {
+            if ( *parsepath == '/' ) {
+               prevelem = parsepath;
+               while ( *parsepath == '/' ) { parsepath++; } // skip any repeated slashes
+               continue;
+            }
+            parsepath++;
+         }
+         if ( prevelem == NULL ) {
+            LOG( LOG_ERR, "Failed to identify final path component of NS string: \"%s\"\n", nspath );
+            free( repostr );
+            free( nspath );
+            config_abandonposition( pos );
+            return -1;
+         }
+         if ( prevelem == nspath ) {
+            // sanity check for truncation of the entire nspath string
+            LOG( LOG_ERR, "Ascent from \"%s\" to \"%s\" would result in fully-truncated nspath\n", curns->idstr, nextns->idstr );
+            free( repostr );
+            free( nspath );
+            config_abandonposition( pos );
+            return -1;
+         }
+         // just truncate the string directly
+         *prevelem = '\0';
+         // allocate a new ID string
+         size_t newstrlen = strlen(repostr) + 1 + strlen(nspath) + 1;
+         tmpidstr = malloc( sizeof( char ) * newstrlen );
+         if ( tmpidstr == NULL ) {
+            LOG( LOG_ERR, "Failed to allocate a new ID string (ascending)\n" );
+            free( repostr );
+            free( nspath );
+            config_abandonposition( pos );
+            return -1;
+         }
+         if ( snprintf( tmpidstr, newstrlen, "%s|%s", repostr, nspath ) < 2 ) {
+            LOG( LOG_ERR, "Failed to populate new ID string (ascending)\n" );
+            free( tmpidstr );
+            free( repostr );
+            free( nspath );
+            config_abandonposition( pos );
+            return -1;
+         }
       }
-      if ( snprintf( tmpidstr, newstrlen, "%s|%s/%s", repostr, nspath, relpath ) < 3 ) {
-         LOG( LOG_ERR, "Failed to populate new ID string (descending)\n" );
-         free( tmpidstr );
-         free( repostr );
-         free( nspath );
-         config_abandonposition( pos );
-         return -1;
+      else {
+         // we need to append the next relative path component
+         size_t newstrlen = strlen(repostr) + 1 + strlen(nspath) + 1 + strlen(relpath) + 1;
+         tmpidstr = malloc( sizeof(char) * newstrlen );
+         if ( tmpidstr == NULL ) {
+            LOG( LOG_ERR, "Failed to allocate a new ID string (descending)\n" );
+            free( repostr );
+            free( nspath );
+            config_abandonposition( pos );
+            return -1;
+         }
+         if ( snprintf( tmpidstr, newstrlen, "%s|%s/%s", repostr, nspath, relpath ) < 3 ) {
+            LOG( LOG_ERR, "Failed to populate new ID string (descending)\n" );
+            free( tmpidstr );
+            free( repostr );
+            free( nspath );
+            config_abandonposition( pos );
+            return -1;
+         }
       }
       free( repostr );
       free( nspath );
-      free( curns->idstr );
-      curns->idstr = tmpidstr;
-   }
-   // Ghost copy inherits most of the new NS values with slight modification
-   // Quotas become the 'lesser' values, between the original Ghost and new target
-   //    ( with zero considered the 'greatest', unlimited, value )
-   curns->fquota = curns->ghsource->fquota;
-   if ( nextns->fquota  &&  (nextns->fquota < curns->fquota  ||  curns->fquota == 0 ) ) {
-      curns->fquota = nextns->fquota;
-   }
-   curns->dquota = curns->ghsource->dquota;
-   if ( nextns->dquota  &&  (nextns->dquota < curns->dquota  ||  curns->dquota == 0 ) ) {
-      curns->dquota = nextns->dquota;
-   }
-   // Permissions become the most restrictive set, between the Ghost at its target
-   curns->iperms = ( curns->ghsource->iperms & nextns->iperms );
-   curns->bperms = ( curns->ghsource->bperms & nextns->bperms );
-   // clear out the subspace allocations of the copy
-   if ( curns->subspaces ) { hash_term( curns->subspaces, NULL, NULL ); }
-   if ( curns->subnodes ) { free( curns->subnodes ); }
-   // Subspaces become a copy of the target NS subspaces, EXCLUDING ALL GHOSTS
-   //    ( Ghost inclusion implies possible FS loop )
-   HASH_NODE* parsenode = nextns->subnodes;
-   size_t parsecount = 0;
-   curns->subnodecount = 0;
-   // count up non-ghost children of the target
-   for ( ; parsecount < nextns->subnodecount; parsecount++ ) {
-      if ( ( (marfs_ns*)parsenode->content )->ghtarget == NULL ) { curns->subnodecount++; }
-      parsenode++;
-   }
-   curns->subspaces = NULL;
-   curns->subnodes = NULL;
-   if ( curns->subnodecount ) {
-      // allocate subspace list
-      curns->subnodes = malloc( sizeof( HASH_NODE ) * curns->subnodecount );
-      if ( curns->subnodes == NULL ) {
-         LOG( LOG_ERR, "Failed to allocate subnode list for active GhostNS copy: \"%s\"\n", curns->idstr );
-         config_abandonposition( pos );
-         return -1;
-      }
-      // copy non-GhostNS nodes
-      parsenode = nextns->subnodes;
-      size_t nodeindex = 0;
-      for ( parsecount = 0; parsecount < nextns->subnodecount; parsecount++ ) {
-         if ( ( (marfs_ns*)parsenode->content )->ghtarget == NULL ) {
-            HASH_NODE* editnode = curns->subnodes + nodeindex;
-            nodeindex++;
-            // just directly copy hash node values, rather than duplicating
-            editnode->name = parsenode->name;
-            editnode->weight = parsenode->weight;
-            editnode->content = parsenode->content;
-            if ( nodeindex == curns->subnodecount ) { break; } // potentially exit early
-         }
-         parsenode++;
-      }
-      // establish the subspace table
-      curns->subspaces = hash_init( curns->subnodes, curns->subnodecount, 1 );
-      if ( curns->subspaces == NULL ) {
-         LOG( LOG_ERR, "Failed to initialize subspace table for active GhostNS copy: \"%s\"\n", curns->idstr );
+      tgtns = create_ghostview( curns->ghsource, nextns, tmpidstr );
+      if ( tgtns == NULL ) {
+         LOG( LOG_ERR, "Failed to create view of GhostNS \"%s\" targeting \"%s\"\n", curns->ghsource->idstr, nextns->idstr );
          config_abandonposition( pos );
          return -1;
       }
    }
-   // NOTE -- No need to update NS pointer
-
    // GhostNS contexts must always be freshly created
-   if ( pos->ctxt  &&  curns->ghtarget->prepo->metascheme.mdal->destroyctxt( pos->ctxt ) ) {
+   if ( pos->ctxt  &&  curns->prepo->metascheme.mdal->destroyctxt( pos->ctxt ) ) {
       // nothing to do but complain
-      LOG( LOG_WARNING, "Failed to destroy MDAL_CTXT for active Ghost NS copy \"%s\"\n", curns->idstr );
+      LOG( LOG_WARNING, "Failed to destroy MDAL_CTXT for view of GhostNS \"%s\"\n", curns->idstr );
    }
    pos->ctxt = NULL;
+   // swap to the new view, releasing our reference to the previous one
+   pos->ns = tgtns;
+   config_destroynsref( curns );
    if ( updatectxt ) {
       // generate a new 'split' ctxt
       if ( config_fortifyposition( pos ) ) {
-         LOG( LOG_ERR, "Failed to generate split ctxt for active GhostNS copy: \"%s\"\n", curns->idstr );
+         LOG( LOG_ERR, "Failed to generate split ctxt for view of GhostNS: \"%s\"\n", tgtns->idstr );
          config_abandonposition( pos );
          return -1;
       }
    }
-   LOG( LOG_INFO, "Moved within GhostNS \"%s\" to new target \"%s\"  --> \"%s\"\n", curns->ghsource->idstr, curns->ghtarget->idstr, curns->idstr );
+   LOG( LOG_INFO, "Moved within GhostNS \"%s\" to new target \"%s\"  --> \"%s\"\n", tgtns->ghsource->idstr, tgtns->ghtarget->idstr, tgtns->idstr );
    return 0;
 }
 
@@ -1173,6 +1187,16 @@ int free_namespace( HASH_NODE* nsnode ) {
    // free NS componenets
    if ( ns ) {
       LOG( LOG_INFO, "Freeing NS: \"%s\"\n", nsname );
+      // free any views of this GhostNS
+      while ( ns->ghviews ) {
+         marfs_ns* view = ns->ghviews;
+         ns->ghviews = view->ghnext;
+         if ( view->ghrefs ) {
+            LOG( LOG_WARNING, "Freeing view \"%s\" of GhostNS \"%s\" with %zu outstanding references\n",
+                 view->idstr, nsname, view->ghrefs );
+         }
+         free_ghostview( view );
+      }
       // free the namespace id string
       free( ns->idstr );
       // free the namespace itself
@@ -1367,6 +1391,9 @@ int create_namespace( HASH_NODE* nsnode, marfs_ns* pnamespace, marfs_repo* prepo
    ns->subnodecount = 0;
    ns->ghtarget = NULL;
    ns->ghsource = NULL;
+   ns->ghviews = NULL;
+   ns->ghnext = NULL;
+   ns->ghrefs = 0;
 
    // set parent values
    ns->prepo = prepo;
@@ -1824,6 +1851,13 @@ int free_repo( marfs_repo* repo ) {
    if ( repo->metascheme.nslist ) { free( repo->metascheme.nslist ); }
 
    // free data scheme components
+   if ( repo->datascheme.cache ) {
+      if ( datacache_term( repo->datascheme.cache ) ) {
+         LOG( LOG_WARNING, "failed to terminate local object cache of \"%s\" repo\n", repo->name );
+         retval = -1;
+      }
+   }
+   if ( repo->datascheme.cachepath ) { free( repo->datascheme.cachepath ); }
    if ( repo->datascheme.nectxt ) {
       if ( ne_term( repo->datascheme.nectxt ) ) {
          LOG( LOG_WARNING, "failed to terminate NE context of \"%s\" repo\n", repo->name );
@@ -2018,6 +2052,126 @@ int parse_datascheme( marfs_ds* ds, xmlNode* dataroot ) {
             return -1;
          }
       }
+      else if ( strncmp( (char*)dataroot->name, "readcache", 10 ) == 0 ) {
+         // iterate over child nodes, populating max_handles
+         char haveM = 0;
+         for( ; subnode; subnode = subnode->next ) {
+            if ( subnode->type != XML_ELEMENT_NODE ) {
+               // skip comment nodes
+               if ( subnode->type == XML_COMMENT_NODE ) { continue; }
+               LOG( LOG_ERR, "encountered unknown node within a 'readcache' definition\n" );
+               return -1;
+            }
+            if ( strncmp( (char*)subnode->name, "max_handles", 12 ) == 0 ) {
+               haveM = 1;
+               if( parse_size_node( &(ds->readcache), subnode ) ) {
+                  LOG( LOG_ERR, "failed to parse 'max_handles' value within a 'readcache' definition\n" );
+                  return -1;
+               }
+            }
+            else {
+               LOG( LOG_ERR, "encountered an unrecognized \"%s\" node within a 'readcache' definition\n", (char*)subnode->name );
+               return -1;
+            }
+         }
+         // verify that all expected values were populated
+         if ( !(haveM) ) {
+            LOG( LOG_ERR, "encountered a 'readcache' definition without a 'max_handles' value\n" );
+            return -1;
+         }
+      }
+      else if ( strncmp( (char*)dataroot->name, "compression", 12 ) == 0 ) {
+         // iterate over child nodes, populating type and level
+         char haveT = 0;
+         for( ; subnode; subnode = subnode->next ) {
+            if ( subnode->type != XML_ELEMENT_NODE ) {
+               // skip comment nodes
+               if ( subnode->type == XML_COMMENT_NODE ) { continue; }
+               LOG( LOG_ERR, "encountered unknown node within a 'compression' definition\n" );
+               return -1;
+            }
+            if ( strncmp( (char*)subnode->name, "type", 5 ) == 0 ) {
+               haveT = 1;
+               if ( subnode->children == NULL  ||  subnode->children->type != XML_TEXT_NODE  ||
+                    subnode->children->content == NULL ) {
+                  LOG( LOG_ERR, "unexpected format of 'type' node within a 'compression' definition\n" );
+                  return -1;
+               }
+               if ( strncmp( (char*)subnode->children->content, "none", 5 ) == 0 ) {
+                  ds->compression = FTAG_COMPRESS_NONE;
+               }
+               else if ( strncmp( (char*)subnode->children->content, "zlib", 5 ) == 0 ) {
+                  ds->compression = FTAG_COMPRESS_ZLIB;
+               }
+               else {
+                  LOG( LOG_ERR, "encountered an unrecognized compression type: \"%s\"\n", (char*)subnode->children->content );
+                  return -1;
+               }
+            }
+            else if ( strncmp( (char*)subnode->name, "level", 6 ) == 0 ) {
+               if( parse_int_node( &(ds->complevel), subnode ) ) {
+                  LOG( LOG_ERR, "failed to parse 'level' value within a 'compression' definition\n" );
+                  return -1;
+               }
+               if ( ds->complevel < 1  ||  ds->complevel > 9 ) {
+                  LOG( LOG_ERR, "compression 'level' value is outside of the allowable range ( 1 - 9 ): %d\n", ds->complevel );
+                  return -1;
+               }
+            }
+            else {
+               LOG( LOG_ERR, "encountered an unrecognized \"%s\" node within a 'compression' definition\n", (char*)subnode->name );
+               return -1;
+            }
+         }
+         // verify that all expected values were populated
+         if ( !(haveT) ) {
+            LOG( LOG_ERR, "encountered a 'compression' definition without a 'type' value\n" );
+            return -1;
+         }
+      }
+      else if ( strncmp( (char*)dataroot->name, "localcache", 11 ) == 0 ) {
+         // iterate over child nodes, populating path and max_size
+         char haveS = 0;
+         for( ; subnode; subnode = subnode->next ) {
+            if ( subnode->type != XML_ELEMENT_NODE ) {
+               // skip comment nodes
+               if ( subnode->type == XML_COMMENT_NODE ) { continue; }
+               LOG( LOG_ERR, "encountered unknown node within a 'localcache' definition\n" );
+               return -1;
+            }
+            if ( strncmp( (char*)subnode->name, "path", 5 ) == 0 ) {
+               if ( ds->cachepath ) {
+                  LOG( LOG_ERR, "encountered a duplicate 'path' value within a 'localcache' definition\n" );
+                  return -1;
+               }
+               if ( subnode->children == NULL  ||  subnode->children->type != XML_TEXT_NODE  ||
+                    subnode->children->content == NULL ) {
+                  LOG( LOG_ERR, "unexpected format of 'path' node within a 'localcache' definition\n" );
+                  return -1;
+               }
+               if ( (ds->cachepath = strdup( (char*)subnode->children->content )) == NULL ) {
+                  LOG( LOG_ERR, "failed to duplicate 'path' value of a 'localcache' definition\n" );
+                  return -1;
+               }
+            }
+            else if ( strncmp( (char*)subnode->name, "max_size", 9 ) == 0 ) {
+               haveS = 1;
+               if( parse_size_node( &(ds->cachesize), subnode ) ) {
+                  LOG( LOG_ERR, "failed to parse 'max_size' value within a 'localcache' definition\n" );
+                  return -1;
+               }
+            }
+            else {
+               LOG( LOG_ERR, "encountered an unrecognized \"%s\" node within a 'localcache' definition\n", (char*)subnode->name );
+               return -1;
+            }
+         }
+         // verify that all expected values were populated
+         if ( ds->cachepath == NULL  ||  !(haveS)  ||  ds->cachesize == 0 ) {
+            LOG( LOG_ERR, "encountered a 'localcache' definition without both 'path' and non-zero 'max_size' values\n" );
+            return -1;
+         }
+      }
       else if ( strncmp( (char*)dataroot->name, "distribution", 13 ) == 0 ) {
          // iterate over child nodes, creating our distribution tables
          for( ; subnode; subnode = subnode->next ) {
@@ -2069,6 +2223,11 @@ int parse_datascheme( marfs_ds* ds, xmlNode* dataroot ) {
       LOG( LOG_ERR, "failed to initialize an NE context\n" );
       return -1;
    }
+   // attempt to create our local object cache, if one was defined
+   if ( ds->cachepath  &&  (ds->cache = datacache_init( ds->cachepath, ds->cachesize, ds->nectxt )) == NULL ) {
+      LOG( LOG_ERR, "failed to initialize the local object cache at \"%s\"\n", ds->cachepath );
+      return -1;
+   }
 
    return 0;
 }
@@ -2306,6 +2465,12 @@ int create_repo( marfs_repo* repo, xmlNode* reporoot ) {
    repo->datascheme.nectxt = NULL;
    repo->datascheme.objfiles = 1;
    repo->datascheme.objsize = 0;
+   repo->datascheme.compression = FTAG_COMPRESS_NONE;
+   repo->datascheme.complevel = 0;
+   repo->datascheme.readcache = 0;
+   repo->datascheme.cachepath = NULL;
+   repo->datascheme.cachesize = 0;
+   repo->datascheme.cache = NULL;
    repo->datascheme.podtable = NULL;
    repo->datascheme.captable = NULL;
    repo->datascheme.scattertable = NULL;
@@ -2605,47 +2770,860 @@ int establish_nsrefs( marfs_config* config ) {
 }
 
 
-//   -------------   EXTERNAL FUNCTIONS    -------------
+//   -------------   SNAPSHOT FUNCTIONS    -------------
+
+/*
+ * CONFIG SNAPSHOT FORMAT
+ *
+ * A snapshot is a 'pre-digested' copy of a MarFS config file, allowing clients to skip the XML
+ * parse and validation of ( potentially enormous ) namespace hierarchies at startup.  The file
+ * consists of a fixed snapshot_header, followed by a body of length-prefixed records.
+ * All body values are stored as host-order uint64_t values, and all strings as a uint64_t
+ * length followed by that many characters ( no NULL terminator ).
+ *
+ * BODY :
+ *    <config version> <mountpoint> <repo count> <REPO>...
+ * REPO :
+ *    <name> <N> <E> <O> <partsz> <objfiles> <objsize> <compression> <complevel> <readcache>
+ *    <cachepath> <cachesize>
+ *    <DIST:pods> <DIST:caps> <DIST:scatters> <DAL xml>
+ *    <directread> <refbreadth> <refdepth> <refdigits> <MDAL xml> <NS count> <NS>...
+ * DIST :
+ *    <node count> <node weight>...   ( node count of zero indicates an absent table )
+ * ( an empty cachepath string indicates that no local object cache is defined )
+ * NS :
+ *    <type> <name> <idstr> <fquota> <dquota> <iperms> <bperms> <subspace count> <NS>...
+ *
+ * The DAL and MDAL definitions are stored as raw XML fragments, as their content is opaque
+ * to this code and must be passed to ne_init() / init_mdal().  All namespace info reflects
+ * the state of the structures produced by create_repo(), prior to establish_nsrefs().
+ */
+
+#define SNAPSHOT_MAGIC "MARFSCFG"
+#define SNAPSHOT_VERSION 3
+#define SNAPSHOT_BYTEORDER 0x01020304
+#define SNAPSHOT_FNV_OFFSET 14695981039346656037ULL
+#define SNAPSHOT_FNV_PRIME 1099511628211ULL
+
+#define SNAPSHOT_NS  0
+#define SNAPSHOT_RNS 1
+#define SNAPSHOT_GNS 2
+
+typedef struct snapshot_header_struct {
+   char     magic[8];   // SNAPSHOT_MAGIC ( no NULL terminator )
+   uint32_t version;    // SNAPSHOT_VERSION of the producing code
+   uint32_t byteorder;  // SNAPSHOT_BYTEORDER, as written by the producing host
+   uint64_t xmlsize;    // size of the XML config file this snapshot was compiled from
+   uint64_t xmlsum;     // checksum of the XML config file content
+   uint64_t bodysize;   // length of the snapshot body, following this header
+   uint64_t bodysum;    // checksum of the snapshot body
+} snapshot_header;
+
+typedef struct snapshot_buffer_struct {
+   char*  data;
+   size_t len;
+   size_t alloc;
+} snapshot_buffer;
+
+typedef struct snapshot_cursor_struct {
+   const char* data;
+   size_t      len;
+   size_t      offset;
+} snapshot_cursor;
 
 /**
- * Initialize memory structures based on the given config file
- * @param const char* cpath : Path of the config file to be parsed
- * @return marfs_config* : Reference to the newly populated config structures
+ * Produce a ( FNV-1a ) checksum of the given data
+ * @param const char* data : Data to be checksummed
+ * @param size_t len : Length of the data
+ * @return uint64_t : Resulting checksum
  */
-marfs_config* config_init( const char* cpath ) {
-   // Initialize the libxml library and check potential API mismatches between 
-   // the version it was compiled for and the actual shared library used.
-   LIBXML_TEST_VERSION
+uint64_t snapshot_checksum( const char* data, size_t len ) {
+   uint64_t sum = SNAPSHOT_FNV_OFFSET;
+   const unsigned char* parse = (const unsigned char*)data;
+   const unsigned char* end = parse + len;
+   for ( ; parse < end; parse++ ) {
+      sum ^= *parse;
+      sum *= SNAPSHOT_FNV_PRIME;
+   }
+   return sum;
+}
 
-   // attempt to parse the given config file into an xmlDoc
-   xmlDoc* doc = xmlReadFile( cpath, NULL, XML_PARSE_NOBLANKS );
-   if ( doc == NULL ) {
-      LOG( LOG_ERR, "Failed to parse the given XML config file: \"%s\"\n", cpath );
-      xmlCleanupParser();
-      errno = EINVAL;
+/**
+ * Read the entire content of the given file
+ * @param const char* path : Path of the file to be read
+ * @param size_t* len : Reference to be populated with the length of the file content
+ * @return char* : Newly allocated file content, or NULL on failure
+ */
+char* snapshot_readfile( const char* path, size_t* len ) {
+   int fd = open( path, O_RDONLY );
+   if ( fd < 0 ) {
+      LOG( LOG_ERR, "Failed to open file: \"%s\" ( %s )\n", path, strerror(errno) );
       return NULL;
    }
-   // get the root element node
-   xmlNode* root_element = xmlDocGetRootElement(doc);
-
-   // skip any number of comment nodes
-   while ( root_element  &&  root_element->type == XML_COMMENT_NODE ) {
-      root_element = root_element->next;
-   }
-
-   // verify we actually found a root element
-   if ( root_element == NULL ) {
-      LOG( LOG_ERR, "Failed to locate non-comment root element of the given XML config\n" );
-      xmlFreeDoc(doc);
-      xmlCleanupParser();
+   struct stat stval;
+   if ( fstat( fd, &(stval) ) ) {
+      LOG( LOG_ERR, "Failed to stat file: \"%s\" ( %s )\n", path, strerror(errno) );
+      close( fd );
       return NULL;
    }
-
-   // verify the marfs_config root element
-   if ( root_element->type != XML_ELEMENT_NODE  ||  strcmp( (char*)(root_element->name), "marfs_config" ) ) {
-      LOG( LOG_ERR, "Root element of config file is not 'marfs_config'\n" );
-      xmlFreeDoc(doc);
-      xmlCleanupParser();
+   char* content = malloc( stval.st_size + 1 );
+   if ( content == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate %zd bytes for the content of \"%s\"\n", (ssize_t)stval.st_size, path );
+      close( fd );
+      return NULL;
+   }
+   size_t readlen = 0;
+   while ( readlen < stval.st_size ) {
+      ssize_t readres = read( fd, content + readlen, stval.st_size - readlen );
+      if ( readres <= 0 ) {
+         if ( readres < 0  &&  errno == EINTR ) { continue; }
+         LOG( LOG_ERR, "Failed to read the content of \"%s\"\n", path );
+         if ( readres == 0 ) { errno = EIO; }
+         free( content );
+         close( fd );
+         return NULL;
+      }
+      readlen += readres;
+   }
+   close( fd );
+   content[readlen] = '\0';
+   *len = readlen;
+   return content;
+}
+
+/**
+ * Append the given data to a snapshot buffer
+ * @param snapshot_buffer* buf : Buffer to be appended to
+ * @param const void* data : Data to be appended
+ * @param size_t len : Length of the data
+ * @return int : Zero on success, or -1 on failure
+ */
+int snapshot_put( snapshot_buffer* buf, const void* data, size_t len ) {
+   if ( buf->len + len > buf->alloc ) {
+      size_t newalloc = ( buf->alloc ) ? buf->alloc : 4096;
+      while ( buf->len + len > newalloc ) { newalloc *= 2; }
+      char* newdata = realloc( buf->data, newalloc );
+      if ( newdata == NULL ) {
+         LOG( LOG_ERR, "Failed to expand snapshot buffer to %zu bytes\n", newalloc );
+         return -1;
+      }
+      buf->data = newdata;
+      buf->alloc = newalloc;
+   }
+   memcpy( buf->data + buf->len, data, len );
+   buf->len += len;
+   return 0;
+}
+
+/**
+ * Append the given value to a snapshot buffer
+ * @param snapshot_buffer* buf : Buffer to be appended to
+ * @param uint64_t val : Value to be appended
+ * @return int : Zero on success, or -1 on failure
+ */
+int snapshot_putval( snapshot_buffer* buf, uint64_t val ) {
+   return snapshot_put( buf, &(val), sizeof(uint64_t) );
+}
+
+/**
+ * Append the given string to a snapshot buffer
+ * @param snapshot_buffer* buf : Buffer to be appended to
+ * @param const char* str : String to be appended
+ * @return int : Zero on success, or -1 on failure
+ */
+int snapshot_putstr( snapshot_buffer* buf, const char* str ) {
+   size_t len = strlen( str );
+   if ( snapshot_putval( buf, len ) ) { return -1; }
+   return snapshot_put( buf, str, len );
+}
+
+/**
+ * Append the given xml subtree, as text, to a snapshot buffer
+ * @param snapshot_buffer* buf : Buffer to be appended to
+ * @param xmlDoc* doc : Document containing the subtree
+ * @param xmlNode* node : Root of the subtree
+ * @return int : Zero on success, or -1 on failure
+ */
+int snapshot_putxml( snapshot_buffer* buf, xmlDoc* doc, xmlNode* node ) {
+   xmlBuffer* xmlbuf = xmlBufferCreate();
+   if ( xmlbuf == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate an xml output buffer\n" );
+      return -1;
+   }
+   if ( xmlNodeDump( xmlbuf, doc, node, 0, 0 ) < 0 ) {
+      LOG( LOG_ERR, "Failed to output the \"%s\" xml node\n", (char*)node->name );
+      xmlBufferFree( xmlbuf );
+      errno = EINVAL;
+      return -1;
+   }
+   int retval = snapshot_putstr( buf, (const char*)xmlBufferContent( xmlbuf ) );
+   xmlBufferFree( xmlbuf );
+   return retval;
+}
+
+/**
+ * Append the node weights of the given distribution table to a snapshot buffer
+ * @param snapshot_buffer* buf : Buffer to be appended to
+ * @param HASH_TABLE table : Distribution table to be recorded ( may be NULL )
+ * @return int : Zero on success, or -1 on failure
+ */
+int snapshot_putdist( snapshot_buffer* buf, HASH_TABLE table ) {
+   if ( table == NULL ) { return snapshot_putval( buf, 0 ); }
+   // view the nodes of this table ( no iteration state is touched, so this is safe against
+   //    concurrent users of the same table )
+   HASH_NODE* nodes = NULL;
+   size_t nodecount = 0;
+   if ( hash_nodes( table, &(nodes), &(nodecount) ) ) {
+      LOG( LOG_ERR, "Failed to retrieve distribution table nodes\n" );
+      return -1;
+   }
+   uint64_t* weights = calloc( nodecount, sizeof(uint64_t) );
+   if ( weights == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a weight list for %zu distribution nodes\n", nodecount );
+      return -1;
+   }
+   // record weights by node name ( i.e. position ), regardless of node order
+   int parseres = 0;
+   size_t nodeindex = 0;
+   for ( ; nodeindex < nodecount; nodeindex++ ) {
+      HASH_NODE* node = nodes + nodeindex;
+      char* endptr = NULL;
+      unsigned long long nodenum = strtoull( node->name, &(endptr), 10 );
+      if ( *endptr != '\0'  ||  nodenum >= nodecount ) {
+         LOG( LOG_ERR, "Encountered unexpected distribution node name: \"%s\"\n", node->name );
+         parseres = -1;
+         errno = EINVAL;
+         break;
+      }
+      weights[nodenum] = node->weight;
+   }
+   int retval = -1;
+   if ( parseres == 0  &&  snapshot_putval( buf, nodecount ) == 0  &&
+        snapshot_put( buf, weights, sizeof(uint64_t) * nodecount ) == 0 ) {
+      retval = 0;
+   }
+   free( weights );
+   return retval;
+}
+
+/**
+ * Append the given namespace ( and all subspaces ) to a snapshot buffer
+ * @param snapshot_buffer* buf : Buffer to be appended to
+ * @param HASH_NODE* nsnode : Node of the namespace to be recorded
+ * @return int : Zero on success, or -1 on failure
+ */
+int snapshot_putns( snapshot_buffer* buf, HASH_NODE* nsnode ) {
+   marfs_ns* ns = (marfs_ns*)nsnode->content;
+   uint64_t type = SNAPSHOT_NS;
+   if ( ns->prepo == NULL ) { type = SNAPSHOT_RNS; }
+   else if ( ns->ghtarget ) { type = SNAPSHOT_GNS; }
+   if ( snapshot_putval( buf, type )  ||
+        snapshot_putstr( buf, nsnode->name )  ||
+        snapshot_putstr( buf, ns->idstr )  ||
+        snapshot_putval( buf, ns->fquota )  ||
+        snapshot_putval( buf, ns->dquota )  ||
+        snapshot_putval( buf, ns->iperms )  ||
+        snapshot_putval( buf, ns->bperms )  ||
+        snapshot_putval( buf, ns->subnodecount ) ) {
+      return -1;
+   }
+   size_t subindex = 0;
+   for ( ; subindex < ns->subnodecount; subindex++ ) {
+      if ( snapshot_putns( buf, ns->subnodes + subindex ) ) { return -1; }
+   }
+   return 0;
+}
+
+/**
+ * Locate the first child element of the given xml node with the given name
+ * @param xmlNode* parent : Node to search beneath
+ * @param const char* name : Name of the child element
+ * @return xmlNode* : Reference to the child, or NULL if none was found
+ */
+xmlNode* snapshot_findchild( xmlNode* parent, const char* name ) {
+   xmlNode* child = parent->children;
+   for ( ; child; child = child->next ) {
+      if ( child->type == XML_ELEMENT_NODE  &&  strcmp( (char*)child->name, name ) == 0 ) { return child; }
+   }
+   return NULL;
+}
+
+/**
+ * Append the given ( freshly created ) repo to a snapshot buffer
+ * @param snapshot_buffer* buf : Buffer to be appended to
+ * @param marfs_repo* repo : Repo to be recorded
+ * @param xmlDoc* doc : Config document the repo was created from
+ * @param xmlNode* reporoot : Xml node the repo was created from
+ * @return int : Zero on success, or -1 on failure
+ */
+int snapshot_putrepo( snapshot_buffer* buf, marfs_repo* repo, xmlDoc* doc, xmlNode* reporoot ) {
+   // locate the DAL / MDAL definitions of this repo
+   xmlNode* dalnode = snapshot_findchild( reporoot, "data" );
+   if ( dalnode ) { dalnode = snapshot_findchild( dalnode, "DAL" ); }
+   xmlNode* mdalnode = snapshot_findchild( reporoot, "meta" );
+   if ( mdalnode ) { mdalnode = snapshot_findchild( mdalnode, "MDAL" ); }
+   if ( dalnode == NULL  ||  mdalnode == NULL ) {
+      LOG( LOG_ERR, "Failed to locate DAL/MDAL definitions of the \"%s\" repo\n", repo->name );
+      errno = EINVAL;
+      return -1;
+   }
+   marfs_ds* ds = &(repo->datascheme);
+   marfs_ms* ms = &(repo->metascheme);
+   if ( snapshot_putstr( buf, repo->name )  ||
+        snapshot_putval( buf, ds->protection.N )  ||
+        snapshot_putval( buf, ds->protection.E )  ||
+        snapshot_putval( buf, ds->protection.O )  ||
+        snapshot_putval( buf, ds->protection.partsz )  ||
+        snapshot_putval( buf, ds->objfiles )  ||
+        snapshot_putval( buf, ds->objsize )  ||
+        snapshot_putval( buf, ds->compression )  ||
+        snapshot_putval( buf, ds->complevel )  ||
+        snapshot_putval( buf, ds->readcache )  ||
+        snapshot_putstr( buf, ( ds->cachepath ) ? ds->cachepath : "" )  ||
+        snapshot_putval( buf, ds->cachesize )  ||
+        snapshot_putdist( buf, ds->podtable )  ||
+        snapshot_putdist( buf, ds->captable )  ||
+        snapshot_putdist( buf, ds->scattertable )  ||
+        snapshot_putxml( buf, doc, dalnode )  ||
+        snapshot_putval( buf, ms->directread )  ||
+        snapshot_putval( buf, ms->refbreadth )  ||
+        snapshot_putval( buf, ms->refdepth )  ||
+        snapshot_putval( buf, ms->refdigits )  ||
+        snapshot_putxml( buf, doc, mdalnode )  ||
+        snapshot_putval( buf, ms->nscount ) ) {
+      LOG( LOG_ERR, "Failed to record the \"%s\" repo\n", repo->name );
+      return -1;
+   }
+   int nsindex = 0;
+   for ( ; nsindex < ms->nscount; nsindex++ ) {
+      if ( snapshot_putns( buf, ms->nslist + nsindex ) ) {
+         LOG( LOG_ERR, "Failed to record NS %d of the \"%s\" repo\n", nsindex, repo->name );
+         return -1;
+      }
+   }
+   return 0;
+}
+
+/**
+ * Read the next value from a snapshot cursor
+ * @param snapshot_cursor* cur : Cursor to read from
+ * @param uint64_t* val : Reference to be populated with the value
+ * @return int : Zero on success, or -1 on failure
+ */
+int snapshot_getval( snapshot_cursor* cur, uint64_t* val ) {
+   if ( cur->len - cur->offset < sizeof(uint64_t) ) {
+      LOG( LOG_ERR, "Snapshot is truncated at offset %zu\n", cur->offset );
+      errno = EINVAL;
+      return -1;
+   }
+   memcpy( val, cur->data + cur->offset, sizeof(uint64_t) );
+   cur->offset += sizeof(uint64_t);
+   return 0;
+}
+
+/**
+ * Read the next value from a snapshot cursor, as a count of at least 'unitsize' byte elements
+ * @param snapshot_cursor* cur : Cursor to read from
+ * @param uint64_t* count : Reference to be populated with the count
+ * @param size_t unitsize : Minimum snapshot length of each counted element
+ * @return int : Zero on success, or -1 on failure
+ */
+int snapshot_getcount( snapshot_cursor* cur, uint64_t* count, size_t unitsize ) {
+   if ( snapshot_getval( cur, count ) ) { return -1; }
+   // reject counts which could not possibly fit in the remaining snapshot content
+   if ( *count > ( cur->len - cur->offset ) / unitsize ) {
+      LOG( LOG_ERR, "Snapshot count value exceeds remaining content: %llu\n", (unsigned long long)*count );
+      errno = EINVAL;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Read the next string from a snapshot cursor
+ * @param snapshot_cursor* cur : Cursor to read from
+ * @return char* : Newly allocated string, or NULL on failure
+ */
+char* snapshot_getstr( snapshot_cursor* cur ) {
+   uint64_t len;
+   if ( snapshot_getcount( cur, &(len), 1 ) ) { return NULL; }
+   char* str = malloc( sizeof(char) * (len + 1) );
+   if ( str == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a snapshot string of length %llu\n", (unsigned long long)len );
+      return NULL;
+   }
+   memcpy( str, cur->data + cur->offset, len );
+   str[len] = '\0';
+   cur->offset += len;
+   return str;
+}
+
+/**
+ * Read the next xml fragment from a snapshot cursor
+ * @param snapshot_cursor* cur : Cursor to read from
+ * @return xmlDoc* : Newly parsed document, containing only the fragment, or NULL on failure
+ */
+xmlDoc* snapshot_getxml( snapshot_cursor* cur ) {
+   uint64_t len;
+   if ( snapshot_getcount( cur, &(len), 1 ) ) { return NULL; }
+   xmlDoc* doc = xmlReadMemory( cur->data + cur->offset, (int)len, "snapshot.xml", NULL, XML_PARSE_NOBLANKS );
+   if ( doc == NULL  ||  xmlDocGetRootElement( doc ) == NULL ) {
+      LOG( LOG_ERR, "Failed to parse snapshot xml fragment at offset %zu\n", cur->offset );
+      if ( doc ) { xmlFreeDoc( doc ); }
+      errno = EINVAL;
+      return NULL;
+   }
+   cur->offset += len;
+   return doc;
+}
+
+/**
+ * Read the next distribution table from a snapshot cursor
+ * @param snapshot_cursor* cur : Cursor to read from
+ * @param int* count : Reference to be populated with the count of distribution targets
+ * @param HASH_TABLE* table : Reference to be populated with the table ( NULL if absent )
+ * @return int : Zero on success, or -1 on failure
+ */
+int snapshot_getdist( snapshot_cursor* cur, int* count, HASH_TABLE* table ) {
+   uint64_t nodecount;
+   if ( snapshot_getcount( cur, &(nodecount), sizeof(uint64_t) ) ) { return -1; }
+   *table = NULL;
+   *count = 0;
+   if ( nodecount == 0 ) { return 0; } // no table defined
+   HASH_NODE* nodelist = malloc( sizeof(HASH_NODE) * nodecount );
+   if ( nodelist == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate space for %llu distribution nodes\n", (unsigned long long)nodecount );
+      return -1;
+   }
+   size_t curnode;
+   for ( curnode = 0; curnode < nodecount; curnode++ ) {
+      uint64_t weight;
+      snapshot_getval( cur, &(weight) ); // length was already verified via snapshot_getcount()
+      nodelist[curnode].content = NULL;
+      nodelist[curnode].weight = weight;
+      int namelen = snprintf( NULL, 0, "%zu", curnode );
+      nodelist[curnode].name = malloc( sizeof(char) * (namelen + 1) );
+      if ( nodelist[curnode].name == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate space for distribution node names\n" );
+         break;
+      }
+      snprintf( nodelist[curnode].name, namelen + 1, "%zu", curnode );
+   }
+   if ( curnode == nodecount ) {
+      *table = hash_init( nodelist, nodecount, 0 ); // NOT a lookup table
+      if ( *table ) {
+         *count = (int)nodecount;
+         return 0;
+      }
+      LOG( LOG_ERR, "Failed to initialize a distribution table\n" );
+   }
+   while ( curnode ) {
+      curnode--;
+      free( nodelist[curnode].name );
+   }
+   free( nodelist );
+   return -1;
+}
+
+/**
+ * Read the next namespace ( and all subspaces ) from a snapshot cursor
+ * @param snapshot_cursor* cur : Cursor to read from
+ * @param HASH_NODE* nsnode : HASH_NODE to be populated with NS info
+ * @param marfs_ns* pnamespace : Parent namespace reference of the new namespace
+ * @param marfs_repo* prepo : Parent repo reference of the new namespace
+ * @return int : Zero on success, or -1 on failure
+ */
+int snapshot_getns( snapshot_cursor* cur, HASH_NODE* nsnode, marfs_ns* pnamespace, marfs_repo* prepo ) {
+   uint64_t type;
+   if ( snapshot_getval( cur, &(type) ) ) { return -1; }
+   if ( type > SNAPSHOT_GNS ) {
+      LOG( LOG_ERR, "Encountered unrecognized snapshot NS type: %llu\n", (unsigned long long)type );
+      errno = EINVAL;
+      return -1;
+   }
+   nsnode->name = snapshot_getstr( cur );
+   if ( nsnode->name == NULL ) { return -1; }
+   nsnode->weight = 0;
+   marfs_ns* ns = malloc( sizeof( marfs_ns ) );
+   if ( ns == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate space for namespace \"%s\"\n", nsnode->name );
+      free( nsnode->name );
+      return -1;
+   }
+   nsnode->content = ns;
+   ns->idstr = NULL;
+   ns->prepo = ( type == SNAPSHOT_RNS ) ? NULL : prepo;
+   ns->pnamespace = pnamespace;
+   ns->subspaces = NULL;
+   ns->subnodes = NULL;
+   ns->subnodecount = 0;
+   ns->ghtarget = ( type == SNAPSHOT_GNS ) ? ns : NULL;
+   ns->ghsource = NULL;
+   ns->ghviews = NULL;
+   ns->ghnext = NULL;
+   ns->ghrefs = 0;
+   uint64_t fquota, dquota, iperms, bperms, subcount;
+   if ( (ns->idstr = snapshot_getstr( cur )) == NULL  ||
+        snapshot_getval( cur, &(fquota) )  ||
+        snapshot_getval( cur, &(dquota) )  ||
+        snapshot_getval( cur, &(iperms) )  ||
+        snapshot_getval( cur, &(bperms) )  ||
+        snapshot_getcount( cur, &(subcount), sizeof(uint64_t) ) ) {
+      LOG( LOG_ERR, "Failed to read info of NS \"%s\"\n", nsnode->name );
+      if ( ns->idstr ) { free( ns->idstr ); }
+      free( ns );
+      free( nsnode->name );
+      return -1;
+   }
+   ns->fquota = fquota;
+   ns->dquota = dquota;
+   ns->iperms = (ns_perms)iperms;
+   ns->bperms = (ns_perms)bperms;
+   if ( subcount ) {
+      if ( type != SNAPSHOT_NS ) {
+         LOG( LOG_ERR, "Remote/Ghost NS \"%s\" has forbidden child namespaces\n", nsnode->name );
+         errno = EINVAL;
+         free_namespace( nsnode );
+         return -1;
+      }
+      ns->subnodes = malloc( sizeof( HASH_NODE ) * subcount );
+      if ( ns->subnodes == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate space for subspace list of NS \"%s\"\n", nsnode->name );
+         free_namespace( nsnode );
+         return -1;
+      }
+      for ( ; ns->subnodecount < subcount; ns->subnodecount++ ) {
+         if ( snapshot_getns( cur, ns->subnodes + ns->subnodecount, ns, prepo ) ) {
+            LOG( LOG_ERR, "Failed to read subspace %zu of NS \"%s\"\n", ns->subnodecount, nsnode->name );
+            break;
+         }
+      }
+      if ( ns->subnodecount == subcount ) {
+         ns->subspaces = hash_init( ns->subnodes, ns->subnodecount, 1 );
+         if ( ns->subspaces == NULL ) {
+            LOG( LOG_ERR, "Failed to create the subspace table of NS \"%s\"\n", nsnode->name );
+         }
+      }
+      if ( ns->subspaces == NULL ) {
+         // free_namespace() relies upon the subspace table, so clean up manually
+         while ( ns->subnodecount ) {
+            ns->subnodecount--;
+            free_namespace( ns->subnodes + ns->subnodecount );
+         }
+         free( ns->subnodes );
+         ns->subnodes = NULL;
+         free_namespace( nsnode );
+         return -1;
+      }
+   }
+   return 0;
+}
+
+/**
+ * Read the next repo from a snapshot cursor
+ * @param snapshot_cursor* cur : Cursor to read from
+ * @param marfs_repo* repo : Repo to be populated
+ * @return int : Zero on success, or -1 on failure
+ */
+int snapshot_getrepo( snapshot_cursor* cur, marfs_repo* repo ) {
+   // NULL out all repo values, allowing free_repo() to clean up at any point
+   memset( repo, 0, sizeof( marfs_repo ) );
+   if ( (repo->name = snapshot_getstr( cur )) == NULL ) { return -1; }
+   marfs_ds* ds = &(repo->datascheme);
+   marfs_ms* ms = &(repo->metascheme);
+   uint64_t N, E, O, partsz, objfiles, objsize, compression, complevel, readcache, cachesize;
+   ne_location maxloc = { .pod = 0, .cap = 0, .scatter = 0 };
+   if ( snapshot_getval( cur, &(N) )  ||
+        snapshot_getval( cur, &(E) )  ||
+        snapshot_getval( cur, &(O) )  ||
+        snapshot_getval( cur, &(partsz) )  ||
+        snapshot_getval( cur, &(objfiles) )  ||
+        snapshot_getval( cur, &(objsize) )  ||
+        snapshot_getval( cur, &(compression) )  ||
+        snapshot_getval( cur, &(complevel) )  ||
+        snapshot_getval( cur, &(readcache) )  ||
+        (ds->cachepath = snapshot_getstr( cur )) == NULL  ||
+        snapshot_getval( cur, &(cachesize) )  ||
+        snapshot_getdist( cur, &(maxloc.pod), &(ds->podtable) )  ||
+        snapshot_getdist( cur, &(maxloc.cap), &(ds->captable) )  ||
+        snapshot_getdist( cur, &(maxloc.scatter), &(ds->scattertable) ) ) {
+      LOG( LOG_ERR, "Failed to read datascheme info of the \"%s\" repo\n", repo->name );
+      free_repo( repo );
+      return -1;
+   }
+   ds->protection.N = (int)N;
+   ds->protection.E = (int)E;
+   ds->protection.O = (int)O;
+   ds->protection.partsz = partsz;
+   ds->objfiles = objfiles;
+   ds->objsize = objsize;
+   if ( compression > FTAG_COMPRESS_MAX ) {
+      LOG( LOG_ERR, "Unrecognized compression type of the \"%s\" repo: %llu\n", repo->name, (unsigned long long)compression );
+      free_repo( repo );
+      errno = EINVAL;
+      return -1;
+   }
+   ds->compression = (FTAG_COMPRESSION)compression;
+   ds->complevel = (int)complevel;
+   ds->readcache = readcache;
+   ds->cachesize = cachesize;
+   if ( *(ds->cachepath) == '\0' ) {
+      free( ds->cachepath );
+      ds->cachepath = NULL;
+   }
+   // decrement node counts to get actual max values
+   if ( maxloc.pod ) { maxloc.pod--; }
+   if ( maxloc.cap ) { maxloc.cap--; }
+   if ( maxloc.scatter ) { maxloc.scatter--; }
+   xmlDoc* daldoc = snapshot_getxml( cur );
+   if ( daldoc == NULL ) {
+      LOG( LOG_ERR, "Failed to read the DAL definition of the \"%s\" repo\n", repo->name );
+      free_repo( repo );
+      return -1;
+   }
+   ds->nectxt = ne_init( xmlDocGetRootElement( daldoc ), maxloc, ds->protection.N + ds->protection.E );
+   xmlFreeDoc( daldoc );
+   if ( ds->nectxt == NULL ) {
+      LOG( LOG_ERR, "Failed to initialize an NE context for the \"%s\" repo\n", repo->name );
+      free_repo( repo );
+      return -1;
+   }
+   if ( ds->cachepath  &&  (ds->cache = datacache_init( ds->cachepath, ds->cachesize, ds->nectxt )) == NULL ) {
+      LOG( LOG_ERR, "Failed to initialize the local object cache of the \"%s\" repo\n", repo->name );
+      free_repo( repo );
+      return -1;
+   }
+   uint64_t directread, refbreadth, refdepth, refdigits, nscount;
+   if ( snapshot_getval( cur, &(directread) )  ||
+        snapshot_getval( cur, &(refbreadth) )  ||
+        snapshot_getval( cur, &(refdepth) )  ||
+        snapshot_getval( cur, &(refdigits) ) ) {
+      LOG( LOG_ERR, "Failed to read metascheme info of the \"%s\" repo\n", repo->name );
+      free_repo( repo );
+      return -1;
+   }
+   ms->directread = (char)directread;
+   ms->refbreadth = (int)refbreadth;
+   ms->refdepth = (int)refdepth;
+   ms->refdigits = (int)refdigits;
+   if ( ms->refbreadth ) {
+      ms->reftable = config_genreftable( &(ms->refnodes), &(ms->refnodecount), ms->refbreadth, ms->refdepth, ms->refdigits );
+      if ( ms->reftable == NULL ) {
+         LOG( LOG_ERR, "Failed to generate the reference table of the \"%s\" repo\n", repo->name );
+         free_repo( repo );
+         return -1;
+      }
+   }
+   xmlDoc* mdaldoc = snapshot_getxml( cur );
+   if ( mdaldoc == NULL ) {
+      LOG( LOG_ERR, "Failed to read the MDAL definition of the \"%s\" repo\n", repo->name );
+      free_repo( repo );
+      return -1;
+   }
+   ms->mdal = init_mdal( xmlDocGetRootElement( mdaldoc ) );
+   xmlFreeDoc( mdaldoc );
+   if ( ms->mdal == NULL ) {
+      LOG( LOG_ERR, "Failed to initialize the MDAL of the \"%s\" repo\n", repo->name );
+      free_repo( repo );
+      return -1;
+   }
+   if ( snapshot_getcount( cur, &(nscount), sizeof(uint64_t) ) ) {
+      LOG( LOG_ERR, "Failed to read the NS count of the \"%s\" repo\n", repo->name );
+      free_repo( repo );
+      return -1;
+   }
+   if ( nscount ) {
+      ms->nslist = malloc( sizeof(HASH_NODE) * nscount );
+      if ( ms->nslist == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate the NS list of the \"%s\" repo\n", repo->name );
+         free_repo( repo );
+         return -1;
+      }
+      for ( ; ms->nscount < nscount; ms->nscount++ ) {
+         if ( snapshot_getns( cur, ms->nslist + ms->nscount, NULL, repo ) ) {
+            LOG( LOG_ERR, "Failed to read NS %d of the \"%s\" repo\n", ms->nscount, repo->name );
+            free_repo( repo );
+            return -1;
+         }
+      }
+   }
+   return 0;
+}
+
+/**
+ * Generate the default snapshot path of the given config file
+ * @param const char* cpath : Path of the config file
+ * @return char* : Newly allocated snapshot path, or NULL on failure
+ */
+char* snapshot_defaultpath( const char* cpath ) {
+   size_t pathlen = strlen( cpath ) + strlen( CONFIG_SNAPSHOT_SUFFIX );
+   char* snappath = malloc( sizeof(char) * (pathlen + 1) );
+   if ( snappath == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a snapshot path for config \"%s\"\n", cpath );
+      return NULL;
+   }
+   snprintf( snappath, pathlen + 1, "%s%s", cpath, CONFIG_SNAPSHOT_SUFFIX );
+   return snappath;
+}
+
+/**
+ * Produce config structures from a previously compiled snapshot
+ * NOTE -- the produced structures have not yet been passed through establish_nsrefs()
+ * @param const char* cpath : Path of the config file the snapshot must match
+ * @param const char* snappath : Path of the snapshot file ( if NULL, the default path is used )
+ * @return marfs_config* : Reference to the new config structures, or NULL on failure
+ *                         NOTE -- errno will be set to ENOENT, if no snapshot exists, or
+ *                                 ESTALE, if the snapshot does not match the config file
+ */
+marfs_config* snapshot_load( const char* cpath, const char* snappath ) {
+   char* defpath = NULL;
+   if ( snappath == NULL ) {
+      if ( (defpath = snapshot_defaultpath( cpath )) == NULL ) { return NULL; }
+      snappath = defpath;
+   }
+   int fd = open( snappath, O_RDONLY );
+   if ( fd < 0 ) {
+      LOG( LOG_INFO, "No usable config snapshot: \"%s\" ( %s )\n", snappath, strerror(errno) );
+      if ( defpath ) { free( defpath ); }
+      return NULL;
+   }
+   struct stat stval;
+   if ( fstat( fd, &(stval) )  ||  stval.st_size < sizeof( snapshot_header ) ) {
+      LOG( LOG_WARNING, "Config snapshot is too short to be valid: \"%s\"\n", snappath );
+      close( fd );
+      if ( defpath ) { free( defpath ); }
+      errno = EINVAL;
+      return NULL;
+   }
+   char* mapping = mmap( NULL, stval.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+   close( fd );
+   if ( mapping == MAP_FAILED ) {
+      LOG( LOG_ERR, "Failed to map config snapshot: \"%s\" ( %s )\n", snappath, strerror(errno) );
+      if ( defpath ) { free( defpath ); }
+      return NULL;
+   }
+   // validate the snapshot header and content
+   snapshot_header header;
+   memcpy( &(header), mapping, sizeof( snapshot_header ) );
+   snapshot_cursor cur = { .data = mapping + sizeof( snapshot_header ),
+                           .len = stval.st_size - sizeof( snapshot_header ),
+                           .offset = 0 };
+   if ( memcmp( header.magic, SNAPSHOT_MAGIC, sizeof( header.magic ) )  ||
+        header.version != SNAPSHOT_VERSION  ||
+        header.byteorder != SNAPSHOT_BYTEORDER  ||
+        header.bodysize != cur.len  ||
+        header.bodysum != snapshot_checksum( cur.data, cur.len ) ) {
+      LOG( LOG_WARNING, "Config snapshot is invalid or of an incompatible version: \"%s\"\n", snappath );
+      munmap( mapping, stval.st_size );
+      if ( defpath ) { free( defpath ); }
+      errno = EINVAL;
+      return NULL;
+   }
+   // the XML config remains authoritative, so verify that it is unchanged
+   size_t xmllen = 0;
+   char* xmlbuf = snapshot_readfile( cpath, &(xmllen) );
+   if ( xmlbuf == NULL  ||  xmllen != header.xmlsize  ||  snapshot_checksum( xmlbuf, xmllen ) != header.xmlsum ) {
+      LOG( LOG_WARNING, "Config snapshot \"%s\" does not match the content of \"%s\"\n", snappath, cpath );
+      if ( xmlbuf ) { free( xmlbuf ); }
+      munmap( mapping, stval.st_size );
+      if ( defpath ) { free( defpath ); }
+      errno = ESTALE;
+      return NULL;
+   }
+   free( xmlbuf );
+   // allocate the top-level config struct
+   marfs_config* config = malloc( sizeof( struct marfs_config_struct ) );
+   if ( config == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new marfs_config struct\n" );
+      munmap( mapping, stval.st_size );
+      if ( defpath ) { free( defpath ); }
+      return NULL;
+   }
+   config->rootns = NULL;
+   config->repocount = 0;
+   config->repolist = NULL;
+   config->ctag = strdup( "UNKNOWN" ); // default to unknown client
+   config->version = snapshot_getstr( &(cur) );
+   config->mountpoint = snapshot_getstr( &(cur) );
+   uint64_t repocnt = 0;
+   if ( config->ctag == NULL  ||  config->version == NULL  ||  config->mountpoint == NULL  ||
+        snapshot_getcount( &(cur), &(repocnt), sizeof(uint64_t) )  ||  repocnt < 1  ||
+        (config->repolist = malloc( sizeof( struct marfs_repo_struct ) * repocnt )) == NULL ) {
+      LOG( LOG_ERR, "Failed to read required config values from snapshot: \"%s\"\n", snappath );
+      if ( config->version ) { free( config->version ); }
+      if ( config->mountpoint ) { free( config->mountpoint ); }
+      if ( config->ctag ) { free( config->ctag ); }
+      free( config );
+      munmap( mapping, stval.st_size );
+      if ( defpath ) { free( defpath ); }
+      return NULL;
+   }
+   for ( ; config->repocount < repocnt; config->repocount++ ) {
+      if ( snapshot_getrepo( &(cur), config->repolist + config->repocount ) ) {
+         LOG( LOG_ERR, "Failed to read repo %d from snapshot: \"%s\"\n", config->repocount, snappath );
+         config_term( config );
+         munmap( mapping, stval.st_size );
+         if ( defpath ) { free( defpath ); }
+         xmlCleanupParser();
+         return NULL;
+      }
+   }
+   xmlCleanupParser();
+   munmap( mapping, stval.st_size );
+   if ( cur.offset != cur.len ) {
+      LOG( LOG_ERR, "Encountered %zu trailing bytes in snapshot: \"%s\"\n", cur.len - cur.offset, snappath );
+      config_term( config );
+      if ( defpath ) { free( defpath ); }
+      errno = EINVAL;
+      return NULL;
+   }
+   LOG( LOG_INFO, "Loaded config structures from snapshot: \"%s\"\n", snappath );
+   if ( defpath ) { free( defpath ); }
+   return config;
+}
+
+/**
+ * Parse the given config file, producing config structures
+ * NOTE -- the produced structures have not yet been passed through establish_nsrefs()
+ * @param const char* cpath : Path of the config file to be parsed
+ * @param const char* xmlbuf : Content of the config file ( if NULL, the file will be read directly )
+ * @param size_t xmllen : Length of the config file content
+ * @param snapshot_buffer* snap : Snapshot buffer to be populated with the parsed config info
+ *                                ( may be NULL, if no snapshot is being produced )
+ * @return marfs_config* : Reference to the new config structures, or NULL on failure
+ */
+marfs_config* parse_config( const char* cpath, const char* xmlbuf, size_t xmllen, snapshot_buffer* snap ) {
+   // attempt to parse the given config file into an xmlDoc
+   xmlDoc* doc = NULL;
+   if ( xmlbuf ) { doc = xmlReadMemory( xmlbuf, (int)xmllen, cpath, NULL, XML_PARSE_NOBLANKS ); }
+   else { doc = xmlReadFile( cpath, NULL, XML_PARSE_NOBLANKS ); }
+   if ( doc == NULL ) {
+      LOG( LOG_ERR, "Failed to parse the given XML config file: \"%s\"\n", cpath );
+      xmlCleanupParser();
+      errno = EINVAL;
+      return NULL;
+   }
+   // get the root element node
+   xmlNode* root_element = xmlDocGetRootElement(doc);
+
+   // skip any number of comment nodes
+   while ( root_element  &&  root_element->type == XML_COMMENT_NODE ) {
+      root_element = root_element->next;
+   }
+
+   // verify we actually found a root element
+   if ( root_element == NULL ) {
+      LOG( LOG_ERR, "Failed to locate non-comment root element of the given XML config\n" );
+      xmlFreeDoc(doc);
+      xmlCleanupParser();
+      return NULL;
+   }
+
+   // verify the marfs_config root element
+   if ( root_element->type != XML_ELEMENT_NODE  ||  strcmp( (char*)(root_element->name), "marfs_config" ) ) {
+      LOG( LOG_ERR, "Root element of config file is not 'marfs_config'\n" );
+      xmlFreeDoc(doc);
+      xmlCleanupParser();
       return NULL;
    }
 
@@ -2719,6 +3697,21 @@ marfs_config* config_init( const char* cpath ) {
    // populate some initial config vals
    config->rootns = NULL;
 
+   // record top-level values into the snapshot, if requested
+   if ( snap  &&  ( snapshot_putstr( snap, config->version )  ||
+                    snapshot_putstr( snap, config->mountpoint )  ||
+                    snapshot_putval( snap, repocnt ) ) ) {
+      LOG( LOG_ERR, "Failed to record top-level config values into snapshot\n" );
+      free( config->version );
+      free( config->mountpoint );
+      free( config->ctag );
+      free( config->repolist );
+      free( config );
+      xmlFreeDoc(doc);
+      xmlCleanupParser();
+      return NULL;
+   }
+
    // allocate and populate all repos
    xmlNode* reponode = root_element->children;
    for ( config->repocount = 0; reponode; reponode = reponode->next ) {
@@ -2734,6 +3727,14 @@ marfs_config* config_init( const char* cpath ) {
             return NULL;
          }
          config->repocount++;
+         // record the new repo into the snapshot, if requested
+         if ( snap  &&  snapshot_putrepo( snap, config->repolist + (config->repocount - 1), doc, reponode ) ) {
+            LOG( LOG_ERR, "Failed to record repo %d into snapshot\n", config->repocount - 1 );
+            config_term( config );
+            xmlFreeDoc(doc);
+            xmlCleanupParser();
+            return NULL;
+         }
          if ( config->repocount == repocnt ) { break; }
       }
    }
@@ -2746,6 +3747,444 @@ marfs_config* config_init( const char* cpath ) {
    */
    xmlCleanupParser();
 
+   return config;
+}
+
+
+//   -------------   VERIFY FUNCTIONS    -------------
+
+/*
+ * PARALLEL VERIFICATION
+ *
+ * config_verifyparallel() traverses the NS hierarchy from a single thread, as each NS must be
+ * created before any of its subspaces or reference dirs.  All other work is handed off to a pool
+ * of verify threads, as a queue of independent tasks :
+ *    VERIFY_MDALSEC  - MDAL security check of a single repo
+ *    VERIFY_NECTXT   - LibNE ctxt check of a single repo
+ *    VERIFY_REFTREE  - creation / verification of a contiguous range of reference dirs of a NS
+ * Reference dir ranges are split along the top-level subtrees of the reference tree, so that
+ * separate tasks rarely contend over the same intermediate dirs.  All REFTREE tasks of a NS
+ * share a single verify_nsinfo ( and MDAL_CTXT ), the last of which is responsible for
+ * reporting any NS errors and cleaning up the shared state.
+ * With a thread count of one, all tasks are simply executed in order by the traversing thread.
+ */
+
+#define VERIFY_REFCHUNK 64  // minimum count of reference dirs per REFTREE task
+
+typedef enum {
+   VERIFY_MDALSEC,
+   VERIFY_NECTXT,
+   VERIFY_REFTREE
+} verify_tasktype;
+
+typedef struct verify_nsinfo_struct {
+   char*       nspath;   // path of the target NS
+   MDAL        mdal;     // MDAL of the target NS
+   MDAL_CTXT   nsctxt;   // MDAL_CTXT of the target NS ( shared by all REFTREE tasks )
+   size_t      refs;     // count of outstanding references to this structure
+   char        anyerror; // flag indicating that some reference dir could not be verified
+} verify_nsinfo;
+
+typedef struct verify_task_struct {
+   verify_tasktype type;
+   marfs_repo*     repo;     // target repo ( for VERIFY_MDALSEC / VERIFY_NECTXT )
+   verify_nsinfo*  nsinfo;   // target NS ( for VERIFY_REFTREE )
+   size_t          refstart; // first reference node index ( for VERIFY_REFTREE )
+   size_t          refend;   // final reference node index + 1 ( for VERIFY_REFTREE )
+   struct verify_task_struct* next;
+} verify_task;
+
+typedef struct verify_state_struct {
+   pthread_mutex_t lock;
+   pthread_cond_t  cond;     // signaled whenever tasks are enqueued or the queue is closed
+   verify_task*    head;
+   verify_task*    tail;
+   char            closed;   // flag indicating that no further tasks will be enqueued
+   char            fix;      // flag indicating that problems should be corrected
+   char            fatal;    // flag indicating that a task has failed outright
+   int             errcount; // count of uncorrected errors encountered
+   size_t          refsqueued;  // count of reference dirs queued for verification
+   size_t          refsdone;    // count of reference dirs verified
+   size_t          progressmark;// refsdone value at which to next report progress
+   unsigned int    threadcount; // count of active verify threads ( zero -> serial execution )
+   pthread_t*      threads;
+} verify_state;
+
+/**
+ * Verify a single reference dir path, creating any missing components if requested
+ * @param MDAL mdal : MDAL of the NS containing the reference dir
+ * @param MDAL_CTXT nsctxt : MDAL_CTXT of the NS containing the reference dir
+ * @param const char* refname : Path of the reference dir
+ * @param char fix : If non-zero, attempt to create any missing path components
+ * @return int : Zero on success, or -1 if the reference dir could not be verified
+ */
+int verify_refdir( MDAL mdal, MDAL_CTXT nsctxt, const char* refname, char fix ) {
+   int mkdirres = 0;
+   char* rparse = strdup( refname );
+   char* rfullpath = rparse;
+   if ( rparse == NULL ) {
+      LOG( LOG_ERR, "Failed to duplicate reference string: \"%s\"\n", refname );
+      return -1;
+   }
+   //LOG( LOG_INFO, "Verifying refdir: \"%s\"\n", rfullpath );
+   errno = 0;
+   while ( mkdirres == 0  &&  rparse != NULL ) {
+      // iterate ahead in the stream, tokenizing into intermediate path components
+      while ( 1 ) {
+         // cut string to next dir comp
+         if ( *rparse == '/' ) {
+            *rparse = '\0';
+            // ignore any final, empty path component
+            if ( *(rparse + 1) == '\0' ) { rparse = NULL; }
+            break;
+         }
+         // end of str, prepare to exit
+         if ( *rparse == '\0' ) { rparse = NULL; break; }
+         rparse++;
+      }
+      char statref = 1;
+      if ( fix ) {
+         // isssue the createrefdir op
+         if ( rparse ) {
+            // create all intermediate dirs with global execute access
+            mkdirres = mdal->createrefdir( nsctxt, rfullpath, S_IRWXU | S_IXOTH );
+         }
+         else {
+            // create the final dir with full global access
+            mkdirres = mdal->createrefdir( nsctxt, rfullpath, S_IRWXU | S_IWOTH | S_IXOTH );
+         }
+         // ignore any EEXIST errors, and stat the target instead
+         if ( mkdirres  &&  errno == EEXIST ) {
+            mkdirres = 0;
+            errno = 0;
+         }
+         else { statref = 0; }
+      }
+      if ( statref ) {
+         // stat the reference dir
+         struct stat stval;
+         mkdirres = mdal->statref( nsctxt, rfullpath, &(stval) );
+         if ( mkdirres == 0 ) {
+            if ( rparse ) {
+               // check for any group/other perms besides global execute
+               if ( stval.st_mode & S_IRWXG  ||
+                    stval.st_mode & S_IROTH  ||
+                    stval.st_mode & S_IWOTH  ||
+                    !(stval.st_mode & S_IXOTH) ) {
+                  LOG( LOG_ERR, "Intermediate dir has unexpected perms: \"%s\"\n", rfullpath );
+                  mkdirres = -1;
+               }
+            }
+            else {
+               // check for write/execute global perms
+               if ( stval.st_mode & S_IROTH  ||
+                    !(stval.st_mode & S_IWOTH)  ||
+                    !(stval.st_mode & S_IXOTH) ) {
+                  LOG( LOG_ERR, "Terminating dir has unexpected perms: \"%s\"\n", rfullpath );
+                  mkdirres = -1;
+               }
+            }
+         }
+      }
+      // if we cut the string short, we need to undo that and progress to the next str comp
+      if ( rparse ) { *rparse = '/'; rparse++; }
+   }
+   if ( mkdirres ) { // check for error conditions ( except EEXIST )
+      LOG( LOG_ERR, "Failed to verify refdir: \"%s\"\n", rfullpath );
+   }
+   // cleanup after ourselves
+   free( rfullpath ); // done with this reference path
+   return ( mkdirres ) ? -1 : 0;
+}
+
+/**
+ * Release a reference to the given verify_nsinfo, reporting any errors and cleaning up the
+ *  structure if this was the final reference
+ * @param verify_state* state : Verify state to report errors to
+ * @param verify_nsinfo* nsinfo : Verify_nsinfo to be released
+ */
+void verify_releasens( verify_state* state, verify_nsinfo* nsinfo ) {
+   pthread_mutex_lock( &(state->lock) );
+   nsinfo->refs--;
+   char lastref = ( nsinfo->refs == 0 ) ? 1 : 0;
+   if ( lastref  &&  nsinfo->anyerror ) { state->errcount++; }
+   pthread_mutex_unlock( &(state->lock) );
+   if ( !(lastref) ) { return; }
+   if ( nsinfo->anyerror ) {
+      LOG( LOG_ERR, "Failed to create all ref dirs for NS: \"%s\"\n", nsinfo->nspath );
+   }
+   if ( nsinfo->nsctxt  &&  nsinfo->mdal->destroyctxt( nsinfo->nsctxt ) ) {
+      // just warn if we can't clean this up
+      LOG( LOG_WARNING, "Failed to destory MDAL_CTXT of NS \"%s\"\n", nsinfo->nspath );
+   }
+   free( nsinfo->nspath );
+   free( nsinfo );
+}
+
+/**
+ * Execute the given verify task
+ * NOTE -- the task structure will be freed by this function
+ * @param verify_state* state : Verify state to report results to
+ * @param verify_task* task : Task to be executed
+ */
+void verify_runtask( verify_state* state, verify_task* task ) {
+   // check if a previous task has already failed outright
+   pthread_mutex_lock( &(state->lock) );
+   char skip = state->fatal;
+   pthread_mutex_unlock( &(state->lock) );
+   int verres = 0;
+   size_t refsverified = 0;
+   if ( !(skip) ) {
+      switch ( task->type ) {
+         case VERIFY_MDALSEC: {
+            MDAL repomdal = task->repo->metascheme.mdal;
+            verres = repomdal->checksec( repomdal->ctxt, state->fix );
+            if ( verres < 0 ) {
+               LOG( LOG_ERR, "Failed to verify the MDAL security of repo: \"%s\" (%s)\n",
+                             task->repo->name, strerror(errno) );
+            }
+            else if ( verres ) {
+               LOG( LOG_INFO, "MDAL of repo \"%s\" has %d uncorrected security errors\n",
+                              task->repo->name, verres );
+            }
+            break;
+         }
+         case VERIFY_NECTXT:
+            verres = ne_verify( task->repo->datascheme.nectxt, state->fix );
+            if ( verres < 0 ) {
+               LOG( LOG_ERR, "Failed to verify ne_ctxt of repo: \"%s\" (%s)\n",
+                             task->repo->name, strerror(errno) );
+            }
+            else if ( verres ) {
+               LOG( LOG_INFO, "ne_ctxt of repo \"%s\" encountered %d errors\n",
+                              task->repo->name, verres );
+            }
+            break;
+         case VERIFY_REFTREE: {
+            verify_nsinfo* nsinfo = task->nsinfo;
+            HASH_NODE* refnodes = task->repo->metascheme.refnodes;
+            char anyerror = 0;
+            size_t curref = task->refstart;
+            for ( ; curref < task->refend; curref++ ) {
+               if ( verify_refdir( nsinfo->mdal, nsinfo->nsctxt, refnodes[curref].name, state->fix ) ) {
+                  anyerror = 1;
+               }
+               refsverified++;
+            }
+            verres = 0; // errors are reported by the final reference to this NS
+            if ( anyerror ) {
+               pthread_mutex_lock( &(state->lock) );
+               nsinfo->anyerror = 1;
+               pthread_mutex_unlock( &(state->lock) );
+            }
+            break;
+         }
+      }
+   }
+   // record the result of this task
+   pthread_mutex_lock( &(state->lock) );
+   if ( verres < 0 ) { state->fatal = 1; }
+   else if ( verres ) { state->errcount++; }
+   state->refsdone += refsverified;
+   if ( refsverified  &&  state->refsdone >= state->progressmark ) {
+      LOG( LOG_INFO, "Verified %zu of %zu queued reference dirs\n", state->refsdone, state->refsqueued );
+      state->progressmark = state->refsdone + ( VERIFY_REFCHUNK * 64 );
+   }
+   pthread_mutex_unlock( &(state->lock) );
+   if ( task->type == VERIFY_REFTREE ) { verify_releasens( state, task->nsinfo ); }
+   free( task );
+}
+
+/**
+ * Verify thread behavior, executing queued tasks until the queue is closed and empty
+ * @param void* arg : Reference to the shared verify_state
+ * @return void* : Always NULL
+ */
+void* verify_thread( void* arg ) {
+   verify_state* state = (verify_state*)arg;
+   while ( 1 ) {
+      pthread_mutex_lock( &(state->lock) );
+      while ( state->head == NULL  &&  !(state->closed) ) {
+         pthread_cond_wait( &(state->cond), &(state->lock) );
+      }
+      verify_task* task = state->head;
+      if ( task == NULL ) {
+         // queue is closed and empty, so we're done
+         pthread_mutex_unlock( &(state->lock) );
+         break;
+      }
+      state->head = task->next;
+      if ( state->head == NULL ) { state->tail = NULL; }
+      pthread_mutex_unlock( &(state->lock) );
+      verify_runtask( state, task );
+   }
+   return NULL;
+}
+
+/**
+ * Submit a new task for execution
+ * NOTE -- if no verify threads are running, the task is executed immediately
+ * @param verify_state* state : Verify state to submit to
+ * @param verify_tasktype type : Type of the new task
+ * @param marfs_repo* repo : Target repo of the new task
+ * @param verify_nsinfo* nsinfo : Target NS of the new task ( REFTREE only, and a reference
+ *                                to this structure will be taken by the task )
+ * @param size_t refstart : First reference node index of the new task ( REFTREE only )
+ * @param size_t refend : Final reference node index + 1 of the new task ( REFTREE only )
+ * @return int : Zero on success, or -1 on failure
+ */
+int verify_submit( verify_state* state, verify_tasktype type, marfs_repo* repo, verify_nsinfo* nsinfo,
+                   size_t refstart, size_t refend ) {
+   verify_task* task = malloc( sizeof( struct verify_task_struct ) );
+   if ( task == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new verify task\n" );
+      return -1;
+   }
+   task->type = type;
+   task->repo = repo;
+   task->nsinfo = nsinfo;
+   task->refstart = refstart;
+   task->refend = refend;
+   task->next = NULL;
+   pthread_mutex_lock( &(state->lock) );
+   if ( nsinfo ) { nsinfo->refs++; }
+   state->refsqueued += ( refend - refstart );
+   if ( state->threadcount == 0 ) {
+      pthread_mutex_unlock( &(state->lock) );
+      verify_runtask( state, task );
+      return 0;
+   }
+   if ( state->tail ) { state->tail->next = task; }
+   else { state->head = task; }
+   state->tail = task;
+   pthread_cond_signal( &(state->cond) );
+   pthread_mutex_unlock( &(state->lock) );
+   return 0;
+}
+
+/**
+ * Split the reference tree of the given NS into REFTREE tasks, and submit them for execution
+ * NOTE -- the caller's reference to the nsinfo structure is always released by this function
+ * @param verify_state* state : Verify state to submit to
+ * @param marfs_repo* repo : Parent repo of the target NS
+ * @param verify_nsinfo* nsinfo : Target NS
+ * @return int : Zero on success, or -1 on failure
+ */
+int verify_submitreftree( verify_state* state, marfs_repo* repo, verify_nsinfo* nsinfo ) {
+   HASH_NODE* refnodes = repo->metascheme.refnodes;
+   size_t refcount = repo->metascheme.refnodecount;
+   size_t refstart = 0;
+   size_t curref = 0;
+   int retval = 0;
+   for ( ; curref < refcount; curref++ ) {
+      // only break between ranges at the start of a new top-level subtree
+      if ( curref - refstart >= VERIFY_REFCHUNK ) {
+         const char* prevname = refnodes[curref - 1].name;
+         const char* curname = refnodes[curref].name;
+         size_t toplen = strcspn( curname, "/" );
+         if ( strncmp( prevname, curname, toplen ) != 0  ||  prevname[toplen] != '/' ) {
+            if ( verify_submit( state, VERIFY_REFTREE, repo, nsinfo, refstart, curref ) ) {
+               retval = -1;
+               break;
+            }
+            refstart = curref;
+         }
+      }
+   }
+   if ( retval == 0  &&  refstart < refcount  &&
+        verify_submit( state, VERIFY_REFTREE, repo, nsinfo, refstart, refcount ) ) {
+      retval = -1;
+   }
+   verify_releasens( state, nsinfo );
+   return retval;
+}
+
+/**
+ * Initialize a verify state, starting the requested count of verify threads
+ * @param verify_state* state : Verify state to be initialized
+ * @param unsigned int threads : Count of verify threads to run ( <= 1 indicates serial execution )
+ * @param char fix : If non-zero, verify tasks will attempt to correct any problems encountered
+ * @return int : Zero on success, or -1 on failure
+ */
+int verify_init( verify_state* state, unsigned int threads, char fix ) {
+   bzero( state, sizeof( struct verify_state_struct ) );
+   state->fix = fix;
+   state->progressmark = VERIFY_REFCHUNK * 64;
+   if ( pthread_mutex_init( &(state->lock), NULL ) ) {
+      LOG( LOG_ERR, "Failed to initialize verify state lock\n" );
+      return -1;
+   }
+   if ( pthread_cond_init( &(state->cond), NULL ) ) {
+      LOG( LOG_ERR, "Failed to initialize verify state condition\n" );
+      pthread_mutex_destroy( &(state->lock) );
+      return -1;
+   }
+   if ( threads <= 1 ) { return 0; }
+   state->threads = calloc( threads, sizeof( pthread_t ) );
+   if ( state->threads == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate verify thread list\n" );
+      pthread_cond_destroy( &(state->cond) );
+      pthread_mutex_destroy( &(state->lock) );
+      return -1;
+   }
+   for ( ; state->threadcount < threads; state->threadcount++ ) {
+      if ( pthread_create( state->threads + state->threadcount, NULL, verify_thread, state ) ) {
+         // just proceed with however many threads we have
+         LOG( LOG_WARNING, "Failed to start verify thread %u of %u\n", state->threadcount + 1, threads );
+         break;
+      }
+   }
+   LOG( LOG_INFO, "Started %u verify threads\n", state->threadcount );
+   return 0;
+}
+
+/**
+ * Close the task queue of the given verify state, wait for all verify threads to complete, and
+ *  cleanup the state
+ * @param verify_state* state : Verify state to be terminated
+ * @return int : Count of uncorrected errors encountered, or -1 if a failure occurred
+ */
+int verify_term( verify_state* state ) {
+   pthread_mutex_lock( &(state->lock) );
+   state->closed = 1;
+   pthread_cond_broadcast( &(state->cond) );
+   pthread_mutex_unlock( &(state->lock) );
+   unsigned int curthread = 0;
+   for ( ; curthread < state->threadcount; curthread++ ) {
+      pthread_join( state->threads[curthread], NULL );
+   }
+   if ( state->threads ) { free( state->threads ); }
+   pthread_cond_destroy( &(state->cond) );
+   pthread_mutex_destroy( &(state->lock) );
+   if ( state->fatal ) { return -1; }
+   return state->errcount;
+}
+
+
+//   -------------   EXTERNAL FUNCTIONS    -------------
+
+/**
+ * Initialize memory structures based on the given config file
+ * NOTE -- If a current snapshot of the config exists ( see config_compile() ), at the
+ *         default snapshot path, it will be loaded in place of parsing the XML content.
+ * @param const char* cpath : Path of the config file to be parsed
+ * @return marfs_config* : Reference to the newly populated config structures
+ */
+marfs_config* config_init( const char* cpath ) {
+   // Initialize the libxml library and check potential API mismatches between 
+   // the version it was compiled for and the actual shared library used.
+   LIBXML_TEST_VERSION
+
+   // prefer a precompiled snapshot, falling back to a full parse of the XML
+   marfs_config* config = snapshot_load( cpath, NULL );
+   if ( config == NULL ) {
+      if ( errno != ENOENT ) {
+         LOG( LOG_WARNING, "Ignoring unusable snapshot of config \"%s\"\n", cpath );
+      }
+      config = parse_config( cpath, NULL, 0, NULL );
+      if ( config == NULL ) { return NULL; }
+   }
+
    // iterate over all namespaces and establish hierarchy
    if ( establish_nsrefs( config ) ) {
       LOG( LOG_ERR, "Failed to establish all NS references\n" );
@@ -2756,6 +4195,109 @@ marfs_config* config_init( const char* cpath ) {
    return config;
 }
 
+/**
+ * Compile the given config file into a binary snapshot
+ * @param const char* cpath : Path of the config file to be compiled
+ * @param const char* snappath : Path of the snapshot file to be produced
+ *                               ( if NULL, the config path plus CONFIG_SNAPSHOT_SUFFIX is used )
+ * @return int : Zero on success, or -1 on failure
+ */
+int config_compile( const char* cpath, const char* snappath ) {
+   LIBXML_TEST_VERSION
+
+   char* defpath = NULL;
+   if ( snappath == NULL ) {
+      if ( (defpath = snapshot_defaultpath( cpath )) == NULL ) { return -1; }
+      snappath = defpath;
+   }
+   // read in the config file, so that parsed and checksummed content are identical
+   size_t xmllen = 0;
+   char* xmlbuf = snapshot_readfile( cpath, &(xmllen) );
+   if ( xmlbuf == NULL ) {
+      LOG( LOG_ERR, "Failed to read config file: \"%s\"\n", cpath );
+      if ( defpath ) { free( defpath ); }
+      return -1;
+   }
+   snapshot_header header;
+   memcpy( header.magic, SNAPSHOT_MAGIC, sizeof( header.magic ) );
+   header.version = SNAPSHOT_VERSION;
+   header.byteorder = SNAPSHOT_BYTEORDER;
+   header.xmlsize = xmllen;
+   header.xmlsum = snapshot_checksum( xmlbuf, xmllen );
+   snapshot_buffer snap = { .data = NULL, .len = 0, .alloc = 0 };
+   marfs_config* config = parse_config( cpath, xmlbuf, xmllen, &(snap) );
+   free( xmlbuf );
+   if ( config == NULL ) {
+      LOG( LOG_ERR, "Failed to parse config file: \"%s\"\n", cpath );
+      if ( snap.data ) { free( snap.data ); }
+      if ( defpath ) { free( defpath ); }
+      return -1;
+   }
+   // never produce a snapshot of a config with an invalid NS hierarchy
+   int retval = establish_nsrefs( config );
+   if ( retval ) { LOG( LOG_ERR, "Failed to establish all NS references\n" ); }
+   if ( config_term( config ) ) {
+      LOG( LOG_WARNING, "Failed to terminate parsed config structures\n" );
+   }
+   if ( retval ) {
+      free( snap.data );
+      if ( defpath ) { free( defpath ); }
+      return -1;
+   }
+   header.bodysize = snap.len;
+   header.bodysum = snapshot_checksum( snap.data, snap.len );
+   // write out to a temporary file, then rename into place, so readers never see a partial snapshot
+   size_t tmplen = strlen( snappath ) + 5;
+   char* tmppath = malloc( sizeof(char) * (tmplen + 1) );
+   if ( tmppath == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a temporary snapshot path\n" );
+      free( snap.data );
+      if ( defpath ) { free( defpath ); }
+      return -1;
+   }
+   snprintf( tmppath, tmplen + 1, "%s.tmp", snappath );
+   int fd = open( tmppath, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+   if ( fd < 0 ) {
+      LOG( LOG_ERR, "Failed to open snapshot output file: \"%s\" ( %s )\n", tmppath, strerror(errno) );
+      free( tmppath );
+      free( snap.data );
+      if ( defpath ) { free( defpath ); }
+      return -1;
+   }
+   size_t written = 0;
+   while ( written < sizeof( snapshot_header ) + snap.len ) {
+      const char* src = ( written < sizeof( snapshot_header ) ) ? ((char*)&(header)) + written :
+                                                                   snap.data + ( written - sizeof( snapshot_header ) );
+      size_t srclen = ( written < sizeof( snapshot_header ) ) ? sizeof( snapshot_header ) - written :
+                                                               snap.len - ( written - sizeof( snapshot_header ) );
+      ssize_t writeres = write( fd, src, srclen );
+      if ( writeres < 0 ) {
+         if ( errno == EINTR ) { continue; }
+         LOG( LOG_ERR, "Failed to write to snapshot output file: \"%s\" ( %s )\n", tmppath, strerror(errno) );
+         retval = -1;
+         break;
+      }
+      written += writeres;
+   }
+   free( snap.data );
+   if ( retval == 0  &&  fsync( fd ) ) {
+      LOG( LOG_ERR, "Failed to sync snapshot output file: \"%s\" ( %s )\n", tmppath, strerror(errno) );
+      retval = -1;
+   }
+   if ( close( fd ) ) {
+      LOG( LOG_ERR, "Failed to close snapshot output file: \"%s\" ( %s )\n", tmppath, strerror(errno) );
+      retval = -1;
+   }
+   if ( retval == 0  &&  rename( tmppath, snappath ) ) {
+      LOG( LOG_ERR, "Failed to rename snapshot output file to \"%s\" ( %s )\n", snappath, strerror(errno) );
+      retval = -1;
+   }
+   if ( retval ) { unlink( tmppath ); }
+   free( tmppath );
+   if ( defpath ) { free( defpath ); }
+   return retval;
+}
+
 /**
  * Destroy the given config structures
  * @param marfs_config* config : Reference to the config to be destroyed
@@ -2797,68 +4339,22 @@ marfs_ns* config_duplicatensref( marfs_ns* ns ) {
       errno = EINVAL;
       return NULL;
    }
-   // copy the NS
-   if ( !(ns->ghsource) ) {
-      // super simple for non-ghosts
-      return ns;
-   }
-   // for ghosts, we must create a dynamically allocated NS copy
-   marfs_ns* ghcopy = malloc( sizeof( struct marfs_namespace_struct ) );
-   if ( ghcopy == NULL ) {
-      LOG( LOG_ERR, "Failed to allocate GhostNS copy\n" );
-      return NULL;
-   }
-   ghcopy->idstr = strdup( ns->idstr );
-   if ( ghcopy->idstr == NULL ) {
-      LOG( LOG_ERR, "Failed to duplicate GhostNS idstring from source\n" );
-      free( ghcopy );
-      return NULL;
-   }
-   ghcopy->fquota = ns->fquota;
-   ghcopy->dquota = ns->dquota;
-   ghcopy->iperms = ns->iperms;
-   ghcopy->bperms = ns->bperms;
-   ghcopy->prepo = ns->prepo;
-   ghcopy->pnamespace = ns->pnamespace;
-   ghcopy->subnodecount = ns->subnodecount;
-   ghcopy->ghtarget = ns->ghtarget;
-   ghcopy->ghsource = ns->ghsource;
-   ghcopy->subnodes = malloc( sizeof( HASH_NODE ) * ghcopy->subnodecount );
-   if ( ghcopy->subnodes == NULL ) {
-      LOG( LOG_ERR, "Failed to allocate GhostNS copy subnodes\n" );
-      free( ghcopy->idstr );
-      free( ghcopy );
-      return NULL;
-   }
-   size_t nodeindex = 0;
-   for ( ; nodeindex < ghcopy->subnodecount; nodeindex++ ) {
-      HASH_NODE* curnode = ghcopy->subnodes + nodeindex;
-      curnode->name = (ns->subnodes + nodeindex)->name;
-      curnode->weight = (ns->subnodes + nodeindex)->weight;
-      curnode->content = (ns->subnodes + nodeindex)->content;
-   }
-   ghcopy->subspaces = hash_init( ghcopy->subnodes, ghcopy->subnodecount, 1 );
-   if ( ghcopy->subspaces == NULL ) {
-      LOG( LOG_ERR, "Failed to initialize subspaces table of GhostNS copy\n" );
-      free( ghcopy->subnodes );
-      free( ghcopy->idstr );
-      free( ghcopy );
-      return NULL;
+   // views of GhostNSs are shared, so just take an additional reference
+   if ( ns->ghsource ) {
+      __atomic_add_fetch( &(ns->ghrefs), 1, __ATOMIC_RELAXED );
    }
-   // finally, provide the copy
-   return ghcopy;
+   return ns;
 }
 
 /**
- * Potentially free the given NS ( only if it is an allocated ghostNS )
- * @param marfs_ns* ns : Namespace to be freed
+ * Release the given NS reference ( only meaningful for views of a GhostNS )
+ * NOTE -- GhostNS views persist until the GhostNS itself is freed ( see config_term() ),
+ *         so this never frees any memory
+ * @param marfs_ns* ns : Namespace reference to be released
  */
 void config_destroynsref( marfs_ns* ns ) {
    if ( ns  &&  ns->ghsource ) {
-      if ( ns->subspaces ) { hash_term( ns->subspaces, NULL, NULL ); }
-      if ( ns->subnodes ) { free( ns->subnodes ); }
-      if ( ns->idstr ) { free( ns->idstr ); }
-      free( ns );
+      __atomic_sub_fetch( &(ns->ghrefs), 1, __ATOMIC_RELEASE );
    }
 }
 
@@ -3157,6 +4653,23 @@ HASH_TABLE config_genreftable( HASH_NODE** refnodes, size_t* refnodecount, size_
  * @return int : A count of uncorrected errors encountered, or -1 if a failure occurred
  */
 int config_verify( marfs_config* config, const char* tgtNS, char MDALcheck, char NEcheck, char recurse, char fix ) {
+   return config_verifyparallel( config, tgtNS, MDALcheck, NEcheck, recurse, fix, 1 );
+}
+
+/**
+ * Equivalent to config_verify(), but with repo checks and reference dir verification spread
+ *  across the specified count of threads
+ * @param marfs_config* config : Reference to the config to be validated
+ * @param const char* tgtNS : Path of the NS to be verified
+ * @param char MDALcheck : If non-zero, the MDAL security and reference dirs of each encountered NS will be verified
+ * @param char NEcheck : If non-zero, the LibNE ctxt of each encountered NS will be verified
+ * @param char recurse : If non-zero, children of the target NS will also be verified
+ * @param char fix : If non-zero, attempt to correct any problems encountered
+ * @param unsigned int threads : Count of verification threads to use ( <= 1 indicates serial verification )
+ * @return int : A count of uncorrected errors encountered, or -1 if a failure occurred
+ */
+int config_verifyparallel( marfs_config* config, const char* tgtNS, char MDALcheck, char NEcheck, char recurse, char fix,
+                           unsigned int threads ) {
 
    // check for NULL refs
    if ( config == NULL ) {
@@ -3239,12 +4752,28 @@ int config_verify( marfs_config* config, const char* tgtNS, char MDALcheck, char
    // zero out our umask value, to avoid improper perms
    mode_t oldmask = umask(0);
 
+   // start up our verify threads
+   verify_state vstate;
+   if ( verify_init( &(vstate), threads, fix ) ) {
+      LOG( LOG_ERR, "Failed to initialize verify state\n" );
+      umask(oldmask); // reset umask
+      free( vrepos );
+      free( nsiterlist );
+      return -1;
+   }
+
    // traverse the entire NS hierarchy, creating any missing NSs and reference dirs
    int errcount = 0;
+   char fatal = 0;
    size_t curdepth = 1;
    size_t nscount = 0;
    char createcurrent = 1;
    while ( curdepth ) {
+      // abort early, if any verify task has failed outright
+      pthread_mutex_lock( &(vstate.lock) );
+      fatal = vstate.fatal;
+      pthread_mutex_unlock( &(vstate.lock) );
+      if ( fatal ) { break; }
       if ( createcurrent ) {
          nscount++;
          int olderr = errno;
@@ -3252,46 +4781,19 @@ int config_verify( marfs_config* config, const char* tgtNS, char MDALcheck, char
          MDAL curmdal = pos.ns->prepo->metascheme.mdal;
          MDAL_CTXT nsctxt = NULL;
          // potentially verify the MDAL / libNE context of this NS's parent repo
-         char checkmdalsec = MDALcheck;
-         char checklibne = NEcheck;
+         char checkrepo = ( MDALcheck  ||  NEcheck ) ? 1 : 0;
          size_t repoiter = 0;
-         for ( ; ( repoiter < vrepocnt )  &&  ( checkmdalsec  ||  checklibne ); repoiter++ ) {
-            if ( pos.ns->prepo == vrepos[repoiter] ) { // don't reverify a repo we've already seen
-               checkmdalsec = 0;
-               checklibne = 0;
-            }
-         }
-         if ( checkmdalsec ) {
-            int verres = curmdal->checksec( curmdal->ctxt, fix );
-            if ( verres < 0 ) {
-               LOG( LOG_ERR, "Failed to verify the MDAL security of repo: \"%s\" (%s)\n",
-                             pos.ns->prepo->name, strerror(errno) );
-               free( vrepos );
-               free( nsiterlist );
-               return -1;
-            }
-            else if ( verres ) {
-               LOG( LOG_INFO, "MDAL of repo \"%s\" has %d uncorrected security errors\n",
-                              pos.ns->prepo->name, verres );
-               errcount++;
-            }
+         for ( ; ( repoiter < vrepocnt )  &&  checkrepo; repoiter++ ) {
+            if ( pos.ns->prepo == vrepos[repoiter] ) { checkrepo = 0; } // don't reverify a repo we've already seen
          }
-         if ( checklibne ) {
-            int verres = ne_verify( pos.ns->prepo->datascheme.nectxt, fix );
-            if ( verres < 0 ) {
-               LOG( LOG_ERR, "Failed to verify ne_ctxt of repo: \"%s\" (%s)\n",
-                             pos.ns->prepo->name, strerror(errno) );
-               free( vrepos );
-               free( nsiterlist );
-               return -1;
-            }
-            else if ( verres ) {
-               LOG( LOG_INFO, "ne_ctxt of repo \"%s\" encountered %d errors\n",
-                              pos.ns->prepo->name, verres );
-               errcount++;
+         if ( checkrepo ) {
+            // MDAL and libNE checks of the repo are independent of one another
+            if ( ( MDALcheck  &&  verify_submit( &(vstate), VERIFY_MDALSEC, pos.ns->prepo, NULL, 0, 0 ) )  ||
+                 ( NEcheck  &&  verify_submit( &(vstate), VERIFY_NECTXT, pos.ns->prepo, NULL, 0, 0 ) ) ) {
+               LOG( LOG_ERR, "Failed to submit verification of repo: \"%s\"\n", pos.ns->prepo->name );
+               fatal = 1;
+               break;
             }
-         }
-         if ( checkmdalsec  ||  checklibne ) {
             // mark this repo as verified
             vrepos[vrepocnt] = pos.ns->prepo;
             vrepocnt++;
@@ -3317,121 +4819,34 @@ int config_verify( marfs_config* config, const char* tgtNS, char MDALcheck, char
          //    skip this if we're in ThE gHoSt DiMeNsIoN!!!!
          //    OR if MDAL checks were entirely skipped
          else if ( !(pos.ns->ghsource)  &&  MDALcheck ){
-            size_t curref = 0;
-            char anyerror = 0;
-            for ( ; curref < pos.ns->prepo->metascheme.refnodecount; curref++ ) {
-               int mkdirres = 0;
-               char* rparse = strdup( pos.ns->prepo->metascheme.refnodes[curref].name );
-               char* rfullpath = rparse;
-               if ( rparse == NULL ) {
-                  LOG( LOG_ERR, "Failed to duplicate reference string: \"%s\"\n", pos.ns->prepo->metascheme.refnodes[curref].name );
-                  anyerror = 1;
-                  continue;
-               }
-               //LOG( LOG_INFO, "Verifying refdir: \"%s\"\n", rfullpath );
-               errno = 0;
-               while ( mkdirres == 0  &&  rparse != NULL ) {
-                  // iterate ahead in the stream, tokenizing into intermediate path components
-                  while ( 1 ) {
-                     // cut string to next dir comp
-                     if ( *rparse == '/' ) {
-                        *rparse = '\0';
-                        // ignore any final, empty path component
-                        if ( *(rparse + 1) == '\0' ) { rparse = NULL; }
-                        break;
-                     }
-                     // end of str, prepare to exit
-                     if ( *rparse == '\0' ) { rparse = NULL; break; }
-                     rparse++;
-                  }
-                  if ( fix ) {
-                     // isssue the createrefdir op
-                     if ( rparse ) {
-                        // create all intermediate dirs with global execute access
-                        mkdirres = curmdal->createrefdir( nsctxt, rfullpath, S_IRWXU | S_IXOTH );
-                     }
-                     else {
-                        // create the final dir with full global access
-                        mkdirres = curmdal->createrefdir( nsctxt, rfullpath, S_IRWXU | S_IWOTH | S_IXOTH );
-                     }
-                     // ignore any EEXIST errors, and stat the target instead
-                     if ( mkdirres  &&  errno == EEXIST ) {
-                        mkdirres = 0;
-                        errno = 0;
-                        // stat the reference dir
-                        struct stat stval;
-                        mkdirres = curmdal->statref( nsctxt, rfullpath, &(stval) );
-                        if ( mkdirres == 0 ) {
-                           if ( rparse ) {
-                              // check for any group/other perms besides global execute
-                              if ( stval.st_mode & S_IRWXG  ||
-                                   stval.st_mode & S_IROTH  ||
-                                   stval.st_mode & S_IWOTH  ||
-                                   !(stval.st_mode & S_IXOTH) ) {
-                                 LOG( LOG_ERR, "Intermediate dir has unexpected perms: \"%s\"\n", rfullpath );
-                                 mkdirres = -1;
-                              }
-                           }
-                           else {
-                              // check for write/execute global perms
-                              if ( stval.st_mode & S_IROTH  ||
-                                   !(stval.st_mode & S_IWOTH)  ||
-                                   !(stval.st_mode & S_IXOTH) ) {
-                                 LOG( LOG_ERR, "Terminating dir has unexpected perms: \"%s\"\n", rfullpath );
-                                 mkdirres = -1;
-                              }
-                           }
-                        }
-                     }
-                  }
-                  else {
-                     // stat the reference dir
-                     struct stat stval;
-                     mkdirres = curmdal->statref( nsctxt, rfullpath, &(stval) );
-                     if ( mkdirres == 0 ) {
-                        if ( rparse ) {
-                           // check for any group/other perms besides global execute
-                           if ( stval.st_mode & S_IRWXG  ||
-                                stval.st_mode & S_IROTH  ||
-                                stval.st_mode & S_IWOTH  ||
-                                !(stval.st_mode & S_IXOTH) ) {
-                              LOG( LOG_ERR, "Intermediate dir has unexpected perms: \"%s\"\n", rfullpath );
-                              mkdirres = -1;
-                           }
-                        }
-                        else {
-                           // check for write/execute global perms
-                           if ( stval.st_mode & S_IROTH  ||
-                                !(stval.st_mode & S_IWOTH)  ||
-                                !(stval.st_mode & S_IXOTH) ) {
-                              LOG( LOG_ERR, "Terminating dir has unexpected perms: \"%s\"\n", rfullpath );
-                              mkdirres = -1;
-                           }
-                        }
-                     }
-                  }
-                  // if we cut the string short, we need to undo that and progress to the next str comp
-                  if ( rparse ) { *rparse = '/'; rparse++; }
-               }
-               if ( mkdirres ) { // check for error conditions ( except EEXIST )
-                  LOG( LOG_ERR, "Failed to verify refdir: \"%s\"\n", rfullpath );
-                  anyerror = 1;
-               }
-               // cleanup after ourselves
-               free( rfullpath ); // done with this reference path
-            }
-            if ( anyerror ) {
+            verify_nsinfo* nsinfo = malloc( sizeof( struct verify_nsinfo_struct ) );
+            if ( nsinfo == NULL ) {
+               LOG( LOG_ERR, "Failed to allocate verify info for NS: \"%s\"\n", nspath );
                errcount++;
-               LOG( LOG_ERR, "Failed to create all ref dirs for NS: \"%s\"\n", nspath );
             }
-            else { errno = olderr; }
+            else {
+               // hand off our NS path and ctxt to the reference tree tasks
+               nsinfo->nspath = nspath;
+               nsinfo->mdal = curmdal;
+               nsinfo->nsctxt = nsctxt;
+               nsinfo->refs = 1;
+               nsinfo->anyerror = 0;
+               nspath = NULL;
+               nsctxt = NULL;
+               if ( verify_submitreftree( &(vstate), pos.ns->prepo, nsinfo ) ) {
+                  LOG( LOG_ERR, "Failed to submit all ref dirs of NS: \"%s\"\n", pos.ns->idstr );
+                  fatal = 1;
+               }
+               else { errno = olderr; }
+            }
          }
          // cleanup after ourselves
          if ( nsctxt  &&  curmdal->destroyctxt( nsctxt ) ) {
             // just warn if we can't clean this up
             LOG( LOG_WARNING, "Failed to destory MDAL_CTXT of NS \"%s\"\n", nspath );
          }
-         free( nspath );
+         if ( nspath ) { free( nspath ); }
+         if ( fatal ) { break; }
       }
 
       // quit out here, if not recursing
@@ -3443,23 +4858,21 @@ int config_verify( marfs_config* config, const char* tgtNS, char MDALcheck, char
          marfs_ns* newnstgt = (marfs_ns*)( pos.ns->subnodes[ nsiterlist[curdepth - 1] ].content );
          if ( config_enterns( &pos, newnstgt, pos.ns->subnodes[ nsiterlist[curdepth - 1] ].name, 0, 0 ) ) {
             LOG( LOG_ERR, "Failed to transition position into subspace: \"%s\"\n", newnstgt->idstr );
-            umask(oldmask); // reset umask
-            free( vrepos );
-            free( nsiterlist );
-            return -1;
+            fatal = 1;
+            break;
          }
          LOG( LOG_INFO, "Incrementing iterator for parent ( index = %zu / iter = %zu )\n",
                         curdepth - 1, nsiterlist[ curdepth - 1 ] + 1 );
          nsiterlist[ curdepth - 1 ]++; // increment our iterator at this depth
          curdepth++;
          if ( curdepth >= curiteralloc ) {
-            nsiterlist = realloc( nsiterlist, sizeof(size_t) * ( curiteralloc + 1024 ) );
-            if ( nsiterlist == NULL ) {
+            size_t* newiterlist = realloc( nsiterlist, sizeof(size_t) * ( curiteralloc + 1024 ) );
+            if ( newiterlist == NULL ) {
                LOG( LOG_ERR, "Failed to allocate extended NS iterator list\n" );
-               umask(oldmask); // reset umask
-               free( vrepos );
-               return -1;
+               fatal = 1;
+               break;
             }
+            nsiterlist = newiterlist;
             curiteralloc += 1024;
          }
          nsiterlist[ curdepth - 1 ] = 0; // zero out our next iterator
@@ -3469,21 +4882,27 @@ int config_verify( marfs_config* config, const char* tgtNS, char MDALcheck, char
          // proceed back up to the parent of this space
          if ( config_enterns( &pos, pos.ns->pnamespace, "..", 1, 0 ) < 0 ) {
             LOG( LOG_ERR, "Failed to transition to the parent of current NS\n" );
-            umask(oldmask); // reset umask
-            free( vrepos );
-            free( nsiterlist );
-            return -1;
+            fatal = 1;
+            break;
          }
          curdepth--;
          createcurrent = 0; // the parent space has already been verified
       }
    }
-   // we've finally traversed the entire NS tree
-   LOG( LOG_INFO, "Traversed %zu namespaces with %zu encountered errors\n", nscount, errcount );
-
+   // wait for all outstanding verification tasks to complete
+   int verifyres = verify_term( &(vstate) );
    free( nsiterlist );
    free( vrepos );
    umask(oldmask); // reset umask
+   if ( fatal  ||  verifyres < 0 ) {
+      LOG( LOG_ERR, "Verification aborted after traversing %zu namespaces\n", nscount );
+      config_abandonposition( &pos );
+      return -1;
+   }
+   errcount += verifyres;
+   // we've finally traversed the entire NS tree
+   LOG( LOG_INFO, "Traversed %zu namespaces with %d encountered errors\n", nscount, errcount );
+
    // abandon our position
    config_abandonposition( &pos );
    return errcount;
@@ -60,9 +60,12 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 
 #include "hash/hash.h"
 #include "mdal/mdal.h"
+#include "datacache/datacache.h"
+#include "tagging/tagging.h"
 #include <ne.h>
 
 #define CONFIG_CTAG_LENGTH 32
+#define CONFIG_SNAPSHOT_SUFFIX ".snap"
 
 typedef struct marfs_repo_struct marfs_repo;
 typedef struct marfs_namespace_struct marfs_ns;
@@ -93,6 +96,9 @@ typedef struct marfs_namespace_struct {
    // GhostNS-specific info
    marfs_ns*   ghtarget;     // target NS of this ghost ( NULL for non-ghost NS )
    marfs_ns*   ghsource;     // reference to the original ghost NS instance ( NULL for all but active ghosts )
+   marfs_ns*   ghviews;      // list of shared active views of this ghost NS ( NULL for all but ghosts )
+   marfs_ns*   ghnext;       // next view in the 'ghviews' list of the original ghost ( active ghosts only )
+   size_t      ghrefs;       // count of outstanding references to this view ( active ghosts only )
 } marfs_ns;
 // NOTE -- namespaces will be wrapped in HASH_NODES for use in HASH_TABLEs
 //         the HASH_NODE struct will provide the name string of the namespace
@@ -103,6 +109,12 @@ typedef struct marfs_datascheme_struct {
    ne_ctxt    nectxt;        // LibNE context reference for data access
    size_t     objfiles;      // maximum count of files per data object (zero if no limit)
    size_t     objsize;       // maximum data object size (zero if no limit)
+   FTAG_COMPRESSION compression; // compression type applied to new data objects
+   int        complevel;     // compression level (zero for the default of the compression type)
+   size_t     readcache;     // count of idle object handles cached per READ stream (zero to disable)
+   char*      cachepath;     // local data object cache directory (NULL to disable)
+   size_t     cachesize;     // maximum total size of the local data object cache
+   DATACACHE  cache;         // local data object cache reference (NULL if disabled)
    HASH_TABLE podtable;      // hash table for object POD postion
    HASH_TABLE captable;      // hash table for object CAP position
    HASH_TABLE scattertable;  // hash table for object SCATTER position
@@ -147,11 +159,24 @@ typedef struct marfs_position_struct {
 
 /**
  * Initialize memory structures based on the given config file
+ * NOTE -- If a current snapshot of the config exists ( see config_compile() ), at the
+ *         default snapshot path, it will be loaded in place of parsing the XML content.
  * @param const char* cpath : Path of the config file to be parsed
  * @return marfs_config* : Reference to the newly populated config structures
  */
 marfs_config* config_init( const char* cpath );
 
+/**
+ * Compile the given config file into a binary snapshot
+ * NOTE -- The snapshot records a checksum of the config file content.  Any later change to
+ *         the config file will cause config_init() to ignore the snapshot and parse the XML.
+ * @param const char* cpath : Path of the config file to be compiled
+ * @param const char* snappath : Path of the snapshot file to be produced
+ *                               ( if NULL, the config path plus CONFIG_SNAPSHOT_SUFFIX is used )
+ * @return int : Zero on success, or -1 on failure
+ */
+int config_compile( const char* cpath, const char* snappath );
+
 /**
  * Destroy the given config structures
  * @param marfs_config* config : Reference to the config to be destroyed
@@ -161,14 +186,16 @@ int config_term( marfs_config* config );
 
 /**
  * Duplicate the reference to a given NS
+ * NOTE -- Active ghost NS views are shared between all positions targeting the same ghost
+ *         and target pair, so duplication of those only increments a reference count.
  * @param marfs_ns* ns : NS ref to duplicate
  * @return marfs_ns* : Duplicated ref, or NULL on error
  */
 marfs_ns* config_duplicatensref( marfs_ns* ns );
 
 /**
- * Potentially free the given NS ( only if it is an allocated ghostNS )
- * @param marfs_ns* ns : Namespace to be freed
+ * Release the given NS reference ( only meaningful for active ghost NS views )
+ * @param marfs_ns* ns : Namespace reference to be released
  */
 void config_destroynsref( marfs_ns* ns );
 
@@ -227,6 +254,21 @@ HASH_TABLE config_genreftable( HASH_NODE** refnodes, size_t* refnodecount, size_
  */
 int config_verify( marfs_config* config, const char* tgtNS, char MDALcheck, char NEcheck, char recurse, char fix );
 
+/**
+ * Equivalent to config_verify(), but with repo checks and reference dir verification spread
+ *  across the specified count of threads
+ * @param marfs_config* config : Reference to the config to be validated
+ * @param const char* tgtNS : Path of the NS to be verified
+ * @param char MDALcheck : If non-zero, the MDAL security and reference dirs of each encountered NS will be verified
+ * @param char NEcheck : If non-zero, the LibNE ctxt of each encountered NS will be verified
+ * @param char recurse : If non-zero, children of the target NS will also be verified
+ * @param char fix : If non-zero, attempt to correct any problems encountered
+ * @param unsigned int threads : Count of verification threads to use ( <= 1 indicates serial verification )
+ * @return int : A count of uncorrected errors encountered, or -1 if a failure occurred
+ */
+int config_verifyparallel( marfs_config* config, const char* tgtNS, char MDALcheck, char NEcheck, char recurse, char fix,
+                           unsigned int threads );
+
 /**
  * Traverse the given path, idetifying a final NS target and resulting subpath
  * @param marfs_config* config : Config reference
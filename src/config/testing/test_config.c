@@ -396,6 +396,12 @@ int main(int argc, char **argv)
    newrepo.datascheme.nectxt = NULL;
    newrepo.datascheme.objfiles = 1;
    newrepo.datascheme.objsize = 0;
+   newrepo.datascheme.compression = FTAG_COMPRESS_NONE;
+   newrepo.datascheme.complevel = 0;
+   newrepo.datascheme.readcache = 0;
+   newrepo.datascheme.cachepath = NULL;
+   newrepo.datascheme.cachesize = 0;
+   newrepo.datascheme.cache = NULL;
    newrepo.datascheme.podtable = NULL;
    newrepo.datascheme.captable = NULL;
    newrepo.datascheme.scattertable = NULL;
@@ -432,6 +438,19 @@ int main(int argc, char **argv)
       printf( "unexpected objsize value for datascheme: %zu\n", ds->objsize );
       return -1;
    }
+   if ( ds->compression != FTAG_COMPRESS_ZLIB  ||  ds->complevel != 3 ) {
+      printf( "unexpected compression values for datascheme: (type=%d,level=%d)\n", (int)ds->compression, ds->complevel );
+      return -1;
+   }
+   if ( ds->readcache != 4 ) {
+      printf( "unexpected readcache value for datascheme: %zu\n", ds->readcache );
+      return -1;
+   }
+   if ( ds->cachepath == NULL  ||  strcmp( ds->cachepath, "./test_config_topdir/cache_root" )  ||
+        ds->cachesize != 1073741824ULL  ||  ds->cache == NULL ) {
+      printf( "unexpected localcache values for datascheme\n" );
+      return -1;
+   }
    if ( ds->podtable == NULL  ||  ds->captable == NULL  ||  ds->scattertable == NULL ) {
       printf( "not all pod/cap/scatter tables were initialized for datascheme\n" );
       return -1;
@@ -553,6 +572,79 @@ int main(int argc, char **argv)
       printf( "Config validation failure\n" );
       return -1;
    }
+   // re-verify the same namespaces in parallel, without any fixes
+   if ( config_verifyparallel(config,"/campaign/",1,1,1,0,4) ) {
+      printf( "Parallel config validation failure\n" );
+      return -1;
+   }
+
+   // compile a config snapshot, and verify that it reproduces the same structures
+   if ( config_compile( "./testing/config.xml", "./test_config_snapshot" ) ) {
+      printf( "Failed to compile a config snapshot\n" );
+      return -1;
+   }
+   marfs_config* snapconfig = snapshot_load( "./testing/config.xml", "./test_config_snapshot" );
+   if ( snapconfig == NULL  ||  establish_nsrefs( snapconfig ) ) {
+      printf( "Failed to load the config snapshot\n" );
+      return -1;
+   }
+   if ( strcmp( snapconfig->version, config->version )  ||
+        strcmp( snapconfig->mountpoint, config->mountpoint )  ||
+        snapconfig->repocount != config->repocount ) {
+      printf( "Config snapshot has unexpected top-level values\n" );
+      return -1;
+   }
+   int repoindex = 0;
+   for ( ; repoindex < config->repocount; repoindex++ ) {
+      marfs_repo* origrepo = config->repolist + repoindex;
+      marfs_repo* snaprepo = snapconfig->repolist + repoindex;
+      if ( strcmp( snaprepo->name, origrepo->name )  ||
+           snaprepo->datascheme.protection.N != origrepo->datascheme.protection.N  ||
+           snaprepo->datascheme.protection.E != origrepo->datascheme.protection.E  ||
+           snaprepo->datascheme.protection.partsz != origrepo->datascheme.protection.partsz  ||
+           snaprepo->datascheme.objfiles != origrepo->datascheme.objfiles  ||
+           snaprepo->datascheme.objsize != origrepo->datascheme.objsize  ||
+           snaprepo->datascheme.compression != origrepo->datascheme.compression  ||
+           snaprepo->datascheme.complevel != origrepo->datascheme.complevel  ||
+           snaprepo->datascheme.cachesize != origrepo->datascheme.cachesize  ||
+           ( snaprepo->datascheme.cachepath == NULL ) != ( origrepo->datascheme.cachepath == NULL )  ||
+           ( snaprepo->datascheme.cache == NULL ) != ( origrepo->datascheme.cache == NULL )  ||
+           snaprepo->metascheme.directread != origrepo->metascheme.directread  ||
+           snaprepo->metascheme.refnodecount != origrepo->metascheme.refnodecount  ||
+           snaprepo->metascheme.nscount != origrepo->metascheme.nscount ) {
+         printf( "Config snapshot has unexpected values for repo \"%s\"\n", origrepo->name );
+         return -1;
+      }
+      // object placement must be identical
+      HASH_NODE* orignode = NULL;
+      HASH_NODE* snapnode = NULL;
+      if ( hash_lookup( origrepo->datascheme.podtable, "snapshot-test-object", &(orignode) ) < 0  ||
+           hash_lookup( snaprepo->datascheme.podtable, "snapshot-test-object", &(snapnode) ) < 0  ||
+           strcmp( orignode->name, snapnode->name ) ) {
+         printf( "Config snapshot has a differing pod distribution for repo \"%s\"\n", origrepo->name );
+         return -1;
+      }
+   }
+   HASH_NODE* snapgransom = NULL;
+   if ( strcmp( snapconfig->rootns->idstr, config->rootns->idstr )  ||
+        snapconfig->rootns->subnodecount != config->rootns->subnodecount  ||
+        hash_lookup( snapconfig->rootns->subspaces, "gransom-allocation", &(snapgransom) )  ||
+        strcmp( ((marfs_ns*)snapgransom->content)->idstr, "exampleREPO|/gransom-allocation" )  ||
+        ((marfs_ns*)snapgransom->content)->subnodecount != 2 ) {
+      printf( "Config snapshot has an unexpected NS hierarchy\n" );
+      return -1;
+   }
+   if ( config_term( snapconfig ) ) {
+      printf( "Failed to terminate the snapshot config\n" );
+      return -1;
+   }
+   // a snapshot of different content must be rejected
+   errno = 0;
+   if ( snapshot_load( "./testing/test_config.c", "./test_config_snapshot" )  ||  errno != ESTALE ) {
+      printf( "Failed to reject a mismatched config snapshot\n" );
+      return -1;
+   }
+   unlink( "./test_config_snapshot" );
 
    // test NS identification
    // 1st shift -- TGT = "gransom-allocation/notaNS"
@@ -657,6 +749,70 @@ int main(int argc, char **argv)
       return -1;
    }
 
+   // test GhostNS view sharing
+   marfs_position ghpos = { .depth = 0, .ns = NULL, .ctxt = NULL };
+   if ( config_duplicateposition( &(pos), &(ghpos) ) ) {
+      printf( "Failed to duplicate position for GhostNS shifts\n" );
+      return -1;
+   }
+   if ( snprintf( xmlbuffer, 1024, "root-ghost/gransom-allocation/tgtfile" ) < 1 ) {
+      printf( "Failed to populate 1st GhostNS shift path\n" );
+      return -1;
+   }
+   if ( (shiftres = config_shiftns( config, &(ghpos), xmlbuffer )) == NULL  ||  strcmp( shiftres, "tgtfile" ) ) {
+      printf( "Failure of 1st GhostNS shift: \"%s\"\n", xmlbuffer );
+      return -1;
+   }
+   marfs_ns* ghview = ghpos.ns;
+   if ( ghview->ghsource == NULL  ||  ghview->ghrefs != 1  ||
+        strcmp( ghview->idstr, "3+2repo|/root-ghost/gransom-allocation" ) ) {
+      printf( "Unexpected GhostNS view following 1st GhostNS shift: \"%s\" (refs=%zu)\n", ghview->idstr, ghview->ghrefs );
+      return -1;
+   }
+   marfs_position ghdup = { .depth = 0, .ns = NULL, .ctxt = NULL };
+   if ( config_duplicateposition( &(ghpos), &(ghdup) ) ) {
+      printf( "Failed to duplicate GhostNS position\n" );
+      return -1;
+   }
+   if ( ghdup.ns != ghview  ||  ghview->ghrefs != 2 ) {
+      printf( "GhostNS position duplicate does not share the original view (refs=%zu)\n", ghview->ghrefs );
+      return -1;
+   }
+   // ascending then descending again should return us to the same view
+   if ( snprintf( xmlbuffer, 1024, "../gransom-allocation/tgtfile" ) < 1 ) {
+      printf( "Failed to populate 2nd GhostNS shift path\n" );
+      return -1;
+   }
+   if ( (shiftres = config_shiftns( config, &(ghdup), xmlbuffer )) == NULL  ||  strcmp( shiftres, "tgtfile" ) ) {
+      printf( "Failure of 2nd GhostNS shift: \"%s\"\n", xmlbuffer );
+      return -1;
+   }
+   if ( ghdup.ns != ghview  ||  ghview->ghrefs != 2 ) {
+      printf( "GhostNS view was not reused following 2nd GhostNS shift (refs=%zu)\n", ghview->ghrefs );
+      return -1;
+   }
+   // exiting the GhostNS should release our view reference
+   if ( snprintf( xmlbuffer, 1024, "../../tgtfile" ) < 1 ) {
+      printf( "Failed to populate 3rd GhostNS shift path\n" );
+      return -1;
+   }
+   if ( (shiftres = config_shiftns( config, &(ghdup), xmlbuffer )) == NULL  ||  strcmp( shiftres, "tgtfile" ) ) {
+      printf( "Failure of 3rd GhostNS shift: \"%s\"\n", xmlbuffer );
+      return -1;
+   }
+   if ( ghdup.ns != config->rootns  ||  ghview->ghrefs != 1 ) {
+      printf( "Unexpected state following exit of GhostNS (refs=%zu)\n", ghview->ghrefs );
+      return -1;
+   }
+   if ( config_abandonposition( &(ghdup) )  ||  config_abandonposition( &(ghpos) ) ) {
+      printf( "Failed to abandon GhostNS positions\n" );
+      return -1;
+   }
+   if ( ghview->ghrefs ) {
+      printf( "GhostNS view retains %zu references after all positions were abandoned\n", ghview->ghrefs );
+      return -1;
+   }
+
 
    // test full path traversal ( no link-check )
    // 1st -- TGT = "/campaign/rootNSfile"
@@ -1067,6 +1223,7 @@ int main(int argc, char **argv)
    }
 
    // delete dal/mdal dir structure
+   rmdir( "./test_config_topdir/cache_root" );
    rmdir( "./test_config_topdir/dal_root" );
    rmdir( "./test_config_topdir/mdal_root" );
    rmdir( "./test_config_topdir" );
@@ -85,11 +85,13 @@ int main(int argc, const char** argv) {
    char necheck = 0;
    char recurse = 0;
    char fix = 0;
+   char compile = 0;
+   unsigned int threads = 1;
 
    // parse all position-independent arguments
    char pr_usage = 0;
    int c;
-   while ((c = getopt(argc, (char* const*)argv, "c:n:u:mdrfah")) != -1) {
+   while ((c = getopt(argc, (char* const*)argv, "c:n:u:t:mdrfaCh")) != -1) {
       switch (c) {
       case 'c':
          config_path = optarg;
@@ -100,6 +102,16 @@ int main(int argc, const char** argv) {
       case 'u':
          user_name = optarg;
          break;
+      case 't': {
+         char* endptr = NULL;
+         unsigned long parsethreads = strtoul( optarg, &(endptr), 10 );
+         if ( *optarg == '\0'  ||  *endptr != '\0'  ||  parsethreads == 0  ||  parsethreads > 1024 ) {
+            printf( OUTPREFX "ERROR: Invalid thread count value: \"%s\"\n", optarg );
+            return -1;
+         }
+         threads = (unsigned int)parsethreads;
+         break;
+      }
       case 'm':
          mdalcheck = 1;
          break;
@@ -118,6 +130,9 @@ int main(int argc, const char** argv) {
          recurse = 1;
          fix = 1;
          break;
+      case 'C':
+         compile = 1;
+         break;
       case '?':
          printf( OUTPREFX "ERROR: Unrecognized cmdline argument: \'%c\'\n", optopt );
       case 'h':
@@ -132,15 +147,18 @@ int main(int argc, const char** argv) {
    // check if we need to print usage info
    if (pr_usage) {
       printf(OUTPREFX "Usage info --\n");
-      printf(OUTPREFX "%s [-c configpath] [-n namespace] [-u username] [-m] [-d] [-r] [-f] [-a] [-h]\n", PROGNAME);
+      printf(OUTPREFX "%s [-c configpath] [-n namespace] [-u username] [-t threads] [-m] [-d] [-r] [-f] [-a] [-C] [-h]\n", PROGNAME);
       printf(OUTPREFX "   -c : Path of the MarFS config file ( will use MARFS_CONFIG_PATH env var, if omitted )\n");
       printf(OUTPREFX "   -n : NS target to be verified ( will assume rootNS, \".\", if omitted )\n");
       printf(OUTPREFX "   -u : Username to switch to prior to verification\n");
+      printf(OUTPREFX "   -t : Count of threads to verify with ( MDAL, LibNE, and reference dir checks run in parallel )\n");
       printf(OUTPREFX "   -m : Verify the MDAL security of encoutered namespaces\n");
       printf(OUTPREFX "   -d : Verify the DAL / LibNE Ctxt of encoutered namespaces\n");
       printf(OUTPREFX "   -r : Recurse through subspaces of the target NS\n");
       printf(OUTPREFX "   -f : Attempt to correct encountered problems ( otherwise, just note and complain )\n");
       printf(OUTPREFX "   -a : Equivalent to specifying '-m', '-d', '-r', and '-f'\n");
+      printf(OUTPREFX "   -C : Compile a binary snapshot of the config ( \"<configpath>%s\" ), if verification succeeds\n", CONFIG_SNAPSHOT_SUFFIX);
+      printf(OUTPREFX "        Clients will load this snapshot in place of parsing the config, until the config is altered\n");
       printf(OUTPREFX "   -h : Print this usage info\n");
       return -1;
    }
@@ -194,7 +212,7 @@ int main(int argc, const char** argv) {
    }
 
    // verify the config
-   int verres = config_verify(config, ns_path, mdalcheck, necheck, recurse, fix);
+   int verres = config_verifyparallel(config, ns_path, mdalcheck, necheck, recurse, fix, threads);
    if ( config_term(config) ) {
       printf(OUTPREFX "WARNING: Failed to properly terminate MarFS config ( %s )\n", strerror(errno));
    }
@@ -207,6 +225,15 @@ int main(int argc, const char** argv) {
    }
    else {
       printf(OUTPREFX "Config Verified\n");
+      // only produce snapshots of verified configs
+      if ( compile ) {
+         if ( config_compile( config_path, NULL ) ) {
+            printf(OUTPREFX "ERROR: Failed to compile a snapshot of config: \"%s\" ( %s )\n",
+               config_path, strerror(errno));
+            return -1;
+         }
+         printf(OUTPREFX "Config Snapshot Written: \"%s%s\"\n", config_path, CONFIG_SNAPSHOT_SUFFIX);
+      }
    }
    return verres;
 }
@@ -0,0 +1,803 @@
+/*
+Copyright (c) 2015, Los Alamos National Security, LLC
+All rights reserved.
+
+Copyright 2015.  Los Alamos National Security, LLC. This software was
+produced under U.S. Government contract DE-AC52-06NA25396 for Los
+Alamos National Laboratory (LANL), which is operated by Los Alamos
+National Security, LLC for the U.S. Department of Energy. The
+U.S. Government has rights to use, reproduce, and distribute this
+software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL SECURITY,
+LLC MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY
+FOR THE USE OF THIS SOFTWARE.  If software is modified to produce
+derivative works, such modified software should be clearly marked, so
+as not to confuse it with the version available from LANL.
+ 
+Additionally, redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the following
+conditions are met: 1. Redistributions of source code must retain the
+above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of Los Alamos National Security, LLC, Los Alamos
+National Laboratory, LANL, the U.S. Government, nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL LOS
+ALAMOS NATIONAL SECURITY, LLC OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-----
+NOTE:
+-----
+MarFS is released under the BSD license.
+
+MarFS was reviewed and released by LANL under Los Alamos Computer Code
+identifier: LA-CC-15-039.
+
+MarFS uses libaws4c for Amazon S3 object communication. The original version
+is at https://aws.amazon.com/code/Amazon-S3/2601 and under the LGPL license.
+LANL added functionality to the original work. The original work plus
+LANL contributions is found at https://github.com/jti-lanl/aws4c.
+
+GNU licenses can be found at http://www.gnu.org/licenses/.
+*/
+
+#include "marfs_auto_config.h"
+#ifdef DEBUG_DATACACHE
+#define DEBUG DEBUG_DATACACHE
+#elif (defined DEBUG_ALL)
+#define DEBUG DEBUG_ALL
+#endif
+#define LOG_PREFIX "datacache"
+
+#include <logging.h>
+#include "datacache.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+//   -------------   INTERNAL DEFINITIONS    -------------
+
+#define DATACACHE_BUCKETS 4096
+#define DATACACHE_FILLBUF ( 1024 * 1024 )
+#define DATACACHE_FILLPREFIX ".fill."
+
+typedef enum {
+   CACHE_FILLING = 0, // copy is being produced by the fill thread ( on no queue )
+   CACHE_PROBATION,   // resident, but not referenced since being filled
+   CACHE_PROTECTED,   // resident, and referenced at least once since being filled
+   CACHE_REJECTED     // not resident, as the object exceeded the size limit
+} datacache_state;
+
+typedef struct datacache_entry_struct {
+   char*           name;     // encoded object name ( file name within the cache dir )
+   size_t          size;     // size of the cached copy
+   datacache_state state;
+   char            stale;    // set if a FILLING entry was invalidated, prior to completion
+   struct datacache_entry_struct* hashnext;
+   struct datacache_entry_struct* prev;  // toward the queue head ( more recent )
+   struct datacache_entry_struct* next;  // toward the queue tail ( less recent )
+} datacache_entry;
+
+typedef struct datacache_queue_struct {
+   datacache_entry* head;
+   datacache_entry* tail;
+   size_t           count;
+   size_t           bytes;
+} datacache_queue;
+
+typedef struct datacache_fillreq_struct {
+   datacache_entry* entry;   // FILLING entry to be populated ( owned by the index )
+   char*            objname;
+   ne_location      location;
+   ne_erasure       erasure;
+   struct datacache_fillreq_struct* next;
+} datacache_fillreq;
+
+struct datacache_struct {
+   pthread_mutex_t    lock;
+   pthread_cond_t     fillcond;
+   char*              path;
+   int                dirfd;
+   size_t             maxsize;
+   ne_ctxt            nectxt;
+   datacache_entry*   buckets[DATACACHE_BUCKETS];
+   datacache_queue    probation;
+   datacache_queue    protected;
+   datacache_queue    rejected;
+   datacache_fillreq* pendhead;
+   datacache_fillreq* pendtail;
+   size_t             pendcount;
+   size_t             fillcount; // counter for unique fill file names
+   char               fillstarted;
+   char               terminate;
+   pthread_t          filler;
+};
+
+typedef struct datacache_scanent_struct {
+   char*  name;
+   size_t size;
+   time_t atime;
+} datacache_scanent;
+
+/**
+ * Produce the cache file name of the given object name
+ * NOTE -- '%' and '/' chars, as well as any leading '.', are percent-encoded
+ * @param const char* objname : Object name to be encoded
+ * @return char* : Newly allocated file name, or NULL on failure
+ *                 ( errno will be set to ENAMETOOLONG if the name cannot be cached )
+ */
+static char* encodename( const char* objname ) {
+   size_t len = 0;
+   const char* parse = objname;
+   for ( ; *parse != '\0'; parse++ ) {
+      if ( *parse == '%'  ||  *parse == '/'  ||  ( parse == objname  &&  *parse == '.' ) ) { len += 3; }
+      else { len++; }
+   }
+   if ( len == 0  ||  len > NAME_MAX ) {
+      errno = ( len ) ? ENAMETOOLONG : EINVAL;
+      return NULL;
+   }
+   char* name = malloc( sizeof(char) * (len + 1) );
+   if ( name == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate space for the cache name of object \"%s\"\n", objname );
+      return NULL;
+   }
+   char* output = name;
+   for ( parse = objname; *parse != '\0'; parse++ ) {
+      if ( *parse == '%'  ||  *parse == '/'  ||  ( parse == objname  &&  *parse == '.' ) ) {
+         snprintf( output, 4, "%%%02X", (unsigned int)(unsigned char)*parse );
+         output += 3;
+      }
+      else { *output = *parse; output++; }
+   }
+   *output = '\0';
+   return name;
+}
+
+/**
+ * Identify the hash bucket of the given cache file name
+ * @param const char* name : Encoded object name
+ * @return size_t : Bucket index
+ */
+static size_t bucketof( const char* name ) {
+   uint64_t hashval = 14695981039346656037ULL; // FNV-1a
+   for ( ; *name != '\0'; name++ ) {
+      hashval ^= (unsigned char)*name;
+      hashval *= 1099511628211ULL;
+   }
+   return (size_t)( hashval % DATACACHE_BUCKETS );
+}
+
+/**
+ * Locate the index entry of the given cache file name
+ * NOTE -- caller must hold the cache lock
+ * @param DATACACHE cache : DATACACHE to search
+ * @param const char* name : Encoded object name
+ * @return datacache_entry* : Located entry, or NULL if none exists
+ */
+static datacache_entry* findentry( DATACACHE cache, const char* name ) {
+   datacache_entry* entry = cache->buckets[ bucketof( name ) ];
+   for ( ; entry; entry = entry->hashnext ) {
+      if ( strcmp( entry->name, name ) == 0 ) { return entry; }
+   }
+   return NULL;
+}
+
+/**
+ * Identify the queue associated with the given entry's state
+ * @param DATACACHE cache : DATACACHE containing the entry
+ * @param datacache_entry* entry : Entry to identify the queue of
+ * @return datacache_queue* : Associated queue, or NULL for FILLING entries
+ */
+static datacache_queue* queueof( DATACACHE cache, datacache_entry* entry ) {
+   switch ( entry->state ) {
+      case CACHE_PROBATION: return &(cache->probation);
+      case CACHE_PROTECTED: return &(cache->protected);
+      case CACHE_REJECTED:  return &(cache->rejected);
+      default: return NULL;
+   }
+}
+
+/**
+ * Insert the given entry at the head of the queue associated with its state
+ * @param DATACACHE cache : DATACACHE containing the entry
+ * @param datacache_entry* entry : Entry to be inserted
+ */
+static void queuepush( DATACACHE cache, datacache_entry* entry ) {
+   datacache_queue* queue = queueof( cache, entry );
+   if ( queue == NULL ) { return; }
+   entry->prev = NULL;
+   entry->next = queue->head;
+   if ( queue->head ) { queue->head->prev = entry; }
+   else { queue->tail = entry; }
+   queue->head = entry;
+   queue->count++;
+   queue->bytes += entry->size;
+}
+
+/**
+ * Remove the given entry from the queue associated with its state
+ * @param DATACACHE cache : DATACACHE containing the entry
+ * @param datacache_entry* entry : Entry to be removed
+ */
+static void queueunlink( DATACACHE cache, datacache_entry* entry ) {
+   datacache_queue* queue = queueof( cache, entry );
+   if ( queue == NULL ) { return; }
+   if ( entry->prev ) { entry->prev->next = entry->next; }
+   else { queue->head = entry->next; }
+   if ( entry->next ) { entry->next->prev = entry->prev; }
+   else { queue->tail = entry->prev; }
+   entry->prev = NULL;
+   entry->next = NULL;
+   queue->count--;
+   queue->bytes -= entry->size;
+}
+
+/**
+ * Insert a new entry into the index
+ * NOTE -- caller must hold the cache lock
+ * @param DATACACHE cache : DATACACHE to insert into
+ * @param char* name : Encoded object name ( ownership is transferred to the entry )
+ * @param size_t size : Size of the cached copy
+ * @param datacache_state state : Initial state of the entry
+ * @return datacache_entry* : The new entry, or NULL on failure
+ */
+static datacache_entry* insertentry( DATACACHE cache, char* name, size_t size, datacache_state state ) {
+   datacache_entry* entry = calloc( 1, sizeof( struct datacache_entry_struct ) );
+   if ( entry == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new cache entry for \"%s\"\n", name );
+      return NULL;
+   }
+   entry->name = name;
+   entry->size = ( state == CACHE_REJECTED ) ? 0 : size;
+   entry->state = state;
+   size_t bucket = bucketof( name );
+   entry->hashnext = cache->buckets[bucket];
+   cache->buckets[bucket] = entry;
+   queuepush( cache, entry );
+   return entry;
+}
+
+/**
+ * Remove the given entry from the index, and free it
+ * NOTE -- caller must hold the cache lock
+ * @param DATACACHE cache : DATACACHE containing the entry
+ * @param datacache_entry* entry : Entry to be removed
+ */
+static void removeentry( DATACACHE cache, datacache_entry* entry ) {
+   queueunlink( cache, entry );
+   datacache_entry** ref = cache->buckets + bucketof( entry->name );
+   for ( ; *ref; ref = &((*ref)->hashnext) ) {
+      if ( *ref == entry ) { *ref = entry->hashnext; break; }
+   }
+   free( entry->name );
+   free( entry );
+}
+
+/**
+ * Evict cached copies until the cache is within its size bound, and cap the size of the
+ * protected queue to allow newly filled objects a chance at promotion
+ * NOTE -- caller must hold the cache lock
+ * @param DATACACHE cache : DATACACHE to be trimmed
+ * @param datacache_entry* exempt : Entry which should not be evicted ( may be NULL )
+ */
+static void trimcache( DATACACHE cache, datacache_entry* exempt ) {
+   while ( cache->protected.bytes > ( cache->maxsize / 4 ) * 3 ) {
+      datacache_entry* demote = cache->protected.tail;
+      queueunlink( cache, demote );
+      demote->state = CACHE_PROBATION;
+      queuepush( cache, demote );
+   }
+   while ( cache->probation.bytes + cache->protected.bytes > cache->maxsize ) {
+      datacache_entry* victim = cache->probation.tail;
+      if ( victim == exempt ) { victim = victim->prev; }
+      if ( victim == NULL ) { victim = cache->protected.tail; }
+      if ( victim == NULL ) { break; } // only the exempt entry remains
+      LOG( LOG_INFO, "Evicting cached copy \"%s\" ( %zu bytes )\n", victim->name, victim->size );
+      if ( unlinkat( cache->dirfd, victim->name, 0 )  &&  errno != ENOENT ) {
+         LOG( LOG_WARNING, "Failed to unlink cached copy \"%s\" (%s)\n", victim->name, strerror(errno) );
+      }
+      removeentry( cache, victim );
+   }
+   while ( cache->rejected.count > DATACACHE_MAXREJECTS ) {
+      removeentry( cache, cache->rejected.tail );
+   }
+}
+
+/**
+ * Copy the content of the given object into a new fill file of the cache directory
+ * @param DATACACHE cache : DATACACHE to be filled
+ * @param datacache_fillreq* req : Fill request to be processed
+ * @param char* fillname : String to be populated with the fill file name
+ * @param size_t* size : Reference to be populated with the size of the copy
+ * @return int : Zero on success, 1 if the object exceeded the size limit, or -1 on failure
+ *               ( the fill file is unlinked in all but the success case )
+ */
+static int copyobject( DATACACHE cache, datacache_fillreq* req, char* fillname, size_t* size ) {
+   pthread_mutex_lock( &(cache->lock) );
+   snprintf( fillname, NAME_MAX + 1, "%s%d.%zu", DATACACHE_FILLPREFIX, (int)getpid(), cache->fillcount++ );
+   pthread_mutex_unlock( &(cache->lock) );
+   int fillfd = openat( cache->dirfd, fillname, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR );
+   if ( fillfd < 0 ) {
+      LOG( LOG_ERR, "Failed to create fill file \"%s\" (%s)\n", fillname, strerror(errno) );
+      return -1;
+   }
+   char* buffer = malloc( DATACACHE_FILLBUF );
+   ne_handle handle = NULL;
+   if ( buffer ) { handle = ne_open( cache->nectxt, req->objname, req->location, req->erasure, NE_RDALL ); }
+   if ( handle == NULL ) {
+      LOG( LOG_ERR, "Failed to open object \"%s\" for cache fill\n", req->objname );
+      if ( buffer ) { free( buffer ); }
+      close( fillfd );
+      unlinkat( cache->dirfd, fillname, 0 );
+      return -1;
+   }
+   size_t limit = cache->maxsize / DATACACHE_MAXFRACTION;
+   int retval = 0;
+   *size = 0;
+   while ( retval == 0 ) {
+      ssize_t readres = ne_read( handle, buffer, DATACACHE_FILLBUF );
+      if ( readres == 0 ) { break; }
+      if ( readres < 0 ) {
+         LOG( LOG_ERR, "Failed to read object \"%s\" at offset %zu\n", req->objname, *size );
+         retval = -1;
+         break;
+      }
+      *size += readres;
+      if ( *size > limit ) {
+         LOG( LOG_INFO, "Object \"%s\" exceeds the cachable size limit of %zu bytes\n", req->objname, limit );
+         retval = 1;
+         break;
+      }
+      size_t written = 0;
+      while ( written < (size_t)readres ) {
+         ssize_t writeres = write( fillfd, buffer + written, readres - written );
+         if ( writeres <= 0 ) {
+            LOG( LOG_ERR, "Failed to write to fill file \"%s\" (%s)\n", fillname, strerror(errno) );
+            retval = -1;
+            break;
+         }
+         written += writeres;
+      }
+      // don't hold up termination for the sake of a large object
+      pthread_mutex_lock( &(cache->lock) );
+      if ( cache->terminate  &&  retval == 0 ) { retval = -1; }
+      pthread_mutex_unlock( &(cache->lock) );
+   }
+   free( buffer );
+   if ( ne_close( handle, NULL, NULL ) < 0 ) {
+      LOG( LOG_WARNING, "Failed to close object \"%s\" after cache fill\n", req->objname );
+   }
+   if ( close( fillfd )  &&  retval == 0 ) {
+      LOG( LOG_ERR, "Failed to close fill file \"%s\" (%s)\n", fillname, strerror(errno) );
+      retval = -1;
+   }
+   if ( retval ) { unlinkat( cache->dirfd, fillname, 0 ); }
+   return retval;
+}
+
+/**
+ * Fill thread behavior : process queued fill requests until the cache is terminated
+ * @param void* arg : DATACACHE to be filled
+ * @return void* : Always NULL
+ */
+static void* fillthread( void* arg ) {
+   DATACACHE cache = (DATACACHE)arg;
+   char fillname[NAME_MAX + 1];
+   pthread_mutex_lock( &(cache->lock) );
+   while ( 1 ) {
+      while ( cache->terminate == 0  &&  cache->pendhead == NULL ) {
+         pthread_cond_wait( &(cache->fillcond), &(cache->lock) );
+      }
+      if ( cache->terminate ) { break; }
+      datacache_fillreq* req = cache->pendhead;
+      cache->pendhead = req->next;
+      if ( cache->pendhead == NULL ) { cache->pendtail = NULL; }
+      cache->pendcount--;
+      pthread_mutex_unlock( &(cache->lock) );
+
+      size_t size = 0;
+      int copyres = copyobject( cache, req, fillname, &(size) );
+
+      pthread_mutex_lock( &(cache->lock) );
+      datacache_entry* entry = req->entry;
+      if ( copyres == 0  &&  ( entry->stale  ||  cache->terminate ) ) {
+         LOG( LOG_INFO, "Discarding fill of invalidated object \"%s\"\n", req->objname );
+         unlinkat( cache->dirfd, fillname, 0 );
+         copyres = -1;
+      }
+      if ( copyres == 0  &&  renameat( cache->dirfd, fillname, cache->dirfd, entry->name ) ) {
+         LOG( LOG_ERR, "Failed to rename fill file \"%s\" to \"%s\" (%s)\n", fillname, entry->name, strerror(errno) );
+         unlinkat( cache->dirfd, fillname, 0 );
+         copyres = -1;
+      }
+      if ( copyres == 0 ) {
+         LOG( LOG_INFO, "Cached object \"%s\" ( %zu bytes )\n", req->objname, size );
+         entry->size = size;
+         entry->state = CACHE_PROBATION;
+         queuepush( cache, entry );
+      }
+      else if ( copyres > 0  &&  entry->stale == 0 ) {
+         entry->state = CACHE_REJECTED;
+         queuepush( cache, entry );
+      }
+      else { removeentry( cache, entry ); }
+      trimcache( cache, ( copyres == 0 ) ? entry : NULL );
+      free( req->objname );
+      free( req );
+   }
+   pthread_mutex_unlock( &(cache->lock) );
+   return NULL;
+}
+
+/**
+ * Comparison function for sorting scanned cache files by increasing access time
+ */
+static int scancompare( const void* a, const void* b ) {
+   const datacache_scanent* enta = (const datacache_scanent*)a;
+   const datacache_scanent* entb = (const datacache_scanent*)b;
+   if ( enta->atime < entb->atime ) { return -1; }
+   if ( enta->atime > entb->atime ) { return 1; }
+   return 0;
+}
+
+/**
+ * Index all complete object copies already present in the cache directory, and remove
+ * any orphaned fill files
+ * @param DATACACHE cache : DATACACHE to be populated
+ * @return int : Zero on success, or -1 on failure
+ */
+static int scancache( DATACACHE cache ) {
+   int scanfd = dup( cache->dirfd );
+   DIR* dir = ( scanfd < 0 ) ? NULL : fdopendir( scanfd );
+   if ( dir == NULL ) {
+      LOG( LOG_ERR, "Failed to open cache directory \"%s\" for scanning\n", cache->path );
+      if ( scanfd >= 0 ) { close( scanfd ); }
+      return -1;
+   }
+   rewinddir( dir );
+   datacache_scanent* ents = NULL;
+   size_t entcount = 0;
+   size_t entalloc = 0;
+   time_t now = time( NULL );
+   int retval = 0;
+   struct dirent* dent;
+   while ( ( dent = readdir( dir ) ) != NULL ) {
+      struct stat stval;
+      if ( *(dent->d_name) == '.'  &&
+           strncmp( dent->d_name, DATACACHE_FILLPREFIX, strlen( DATACACHE_FILLPREFIX ) ) ) {
+         continue; // skip '.', '..', and any other hidden file
+      }
+      if ( fstatat( cache->dirfd, dent->d_name, &(stval), AT_SYMLINK_NOFOLLOW )  ||  !S_ISREG( stval.st_mode ) ) {
+         continue;
+      }
+      if ( *(dent->d_name) == '.' ) {
+         // fill files may belong to another active process, so only remove old ones
+         if ( now - stval.st_mtime > DATACACHE_STALEFILL ) {
+            LOG( LOG_INFO, "Removing orphaned fill file \"%s\"\n", dent->d_name );
+            unlinkat( cache->dirfd, dent->d_name, 0 );
+         }
+         continue;
+      }
+      if ( entcount == entalloc ) {
+         entalloc = ( entalloc ) ? entalloc * 2 : 64;
+         datacache_scanent* newents = realloc( ents, sizeof( datacache_scanent ) * entalloc );
+         if ( newents == NULL ) {
+            LOG( LOG_ERR, "Failed to expand cache scan list to %zu entries\n", entalloc );
+            retval = -1;
+            break;
+         }
+         ents = newents;
+      }
+      ents[entcount].name = strdup( dent->d_name );
+      if ( ents[entcount].name == NULL ) {
+         LOG( LOG_ERR, "Failed to duplicate cache file name \"%s\"\n", dent->d_name );
+         retval = -1;
+         break;
+      }
+      ents[entcount].size = stval.st_size;
+      ents[entcount].atime = stval.st_atime;
+      entcount++;
+   }
+   closedir( dir );
+   // insert entries from least to most recently accessed, so the latter end up at the head
+   if ( entcount ) { qsort( ents, entcount, sizeof( datacache_scanent ), scancompare ); }
+   size_t index = 0;
+   for ( ; index < entcount; index++ ) {
+      if ( retval == 0  &&  insertentry( cache, ents[index].name, ents[index].size, CACHE_PROBATION ) ) { continue; }
+      free( ents[index].name );
+      retval = -1;
+   }
+   if ( ents ) { free( ents ); }
+   if ( retval == 0 ) {
+      LOG( LOG_INFO, "Indexed %zu existing cached objects ( %zu bytes )\n", entcount, cache->probation.bytes );
+      trimcache( cache, NULL );
+   }
+   return retval;
+}
+
+
+//   -------------   EXTERNAL FUNCTIONS    -------------
+
+/**
+ * Initialize a DATACACHE, rooted at the given directory
+ * NOTE -- Any complete object copies already present in the directory will be indexed
+ *         ( most recently used first, based upon access time ), then trimmed to size.
+ * @param const char* path : Path of the cache directory ( created, if absent )
+ * @param size_t maxsize : Maximum total size of all cached objects
+ * @param ne_ctxt nectxt : LibNE context to be used for filling the cache
+ * @return DATACACHE : Reference to the new DATACACHE, or NULL on failure
+ */
+DATACACHE datacache_init( const char* path, size_t maxsize, ne_ctxt nectxt ) {
+   // check for invalid args
+   if ( path == NULL  ||  maxsize == 0 ) {
+      LOG( LOG_ERR, "Received a NULL path or zero size value\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   if ( mkdir( path, S_IRWXU )  &&  errno != EEXIST ) {
+      LOG( LOG_ERR, "Failed to create cache directory \"%s\" (%s)\n", path, strerror(errno) );
+      return NULL;
+   }
+   DATACACHE cache = calloc( 1, sizeof( struct datacache_struct ) );
+   if ( cache == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new DATACACHE\n" );
+      return NULL;
+   }
+   cache->maxsize = maxsize;
+   cache->nectxt = nectxt;
+   if ( ( cache->path = strdup( path ) ) == NULL ) {
+      LOG( LOG_ERR, "Failed to duplicate cache path \"%s\"\n", path );
+      free( cache );
+      return NULL;
+   }
+   if ( ( cache->dirfd = open( path, O_RDONLY | O_DIRECTORY | O_CLOEXEC ) ) < 0 ) {
+      LOG( LOG_ERR, "Failed to open cache directory \"%s\" (%s)\n", path, strerror(errno) );
+      free( cache->path );
+      free( cache );
+      return NULL;
+   }
+   if ( pthread_mutex_init( &(cache->lock), NULL ) ) {
+      LOG( LOG_ERR, "Failed to initialize DATACACHE lock\n" );
+      close( cache->dirfd );
+      free( cache->path );
+      free( cache );
+      return NULL;
+   }
+   if ( pthread_cond_init( &(cache->fillcond), NULL ) ) {
+      LOG( LOG_ERR, "Failed to initialize DATACACHE condition\n" );
+      pthread_mutex_destroy( &(cache->lock) );
+      close( cache->dirfd );
+      free( cache->path );
+      free( cache );
+      return NULL;
+   }
+   if ( scancache( cache ) ) {
+      LOG( LOG_ERR, "Failed to index existing content of cache directory \"%s\"\n", path );
+      datacache_term( cache );
+      return NULL;
+   }
+   return cache;
+}
+
+/**
+ * Terminate the given DATACACHE, abandoning any pending fill requests
+ * NOTE -- Cached object copies are left in place, for use by later instances.
+ * @param DATACACHE cache : DATACACHE to be terminated
+ * @return int : Zero on success, or -1 on failure
+ */
+int datacache_term( DATACACHE cache ) {
+   // check for invalid args
+   if ( cache == NULL ) {
+      LOG( LOG_ERR, "Received a NULL DATACACHE reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   int retval = 0;
+   pthread_mutex_lock( &(cache->lock) );
+   cache->terminate = 1;
+   pthread_cond_broadcast( &(cache->fillcond) );
+   pthread_mutex_unlock( &(cache->lock) );
+   if ( cache->fillstarted  &&  pthread_join( cache->filler, NULL ) ) {
+      LOG( LOG_ERR, "Failed to join the DATACACHE fill thread\n" );
+      retval = -1;
+   }
+   while ( cache->pendhead ) {
+      datacache_fillreq* req = cache->pendhead;
+      cache->pendhead = req->next;
+      free( req->objname );
+      free( req );
+   }
+   size_t bucket = 0;
+   for ( ; bucket < DATACACHE_BUCKETS; bucket++ ) {
+      while ( cache->buckets[bucket] ) {
+         datacache_entry* entry = cache->buckets[bucket];
+         cache->buckets[bucket] = entry->hashnext;
+         free( entry->name );
+         free( entry );
+      }
+   }
+   pthread_cond_destroy( &(cache->fillcond) );
+   pthread_mutex_destroy( &(cache->lock) );
+   close( cache->dirfd );
+   free( cache->path );
+   free( cache );
+   return retval;
+}
+
+/**
+ * Open the cached copy of the given object
+ * NOTE -- The returned descriptor remains valid, even if the cached copy is later evicted.
+ * @param DATACACHE cache : DATACACHE to be referenced
+ * @param const char* objname : Name of the data object
+ * @return int : Read-only file descriptor of the cached copy, or -1 on failure
+ *               ( errno will be set to ENOENT if the object is not currently cached )
+ */
+int datacache_open( DATACACHE cache, const char* objname ) {
+   // check for invalid args
+   if ( cache == NULL  ||  objname == NULL ) {
+      LOG( LOG_ERR, "Received a NULL DATACACHE or object name reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   char* name = encodename( objname );
+   if ( name == NULL ) {
+      if ( errno == ENAMETOOLONG ) { errno = ENOENT; }
+      return -1;
+   }
+   pthread_mutex_lock( &(cache->lock) );
+   datacache_entry* entry = findentry( cache, name );
+   if ( entry == NULL  ||  ( entry->state != CACHE_PROBATION  &&  entry->state != CACHE_PROTECTED ) ) {
+      pthread_mutex_unlock( &(cache->lock) );
+      free( name );
+      errno = ENOENT;
+      return -1;
+   }
+   free( name );
+   int fd = openat( cache->dirfd, entry->name, O_RDONLY | O_CLOEXEC );
+   if ( fd < 0 ) {
+      if ( errno == ENOENT ) {
+         // the copy was removed out from under us ( likely by another process )
+         LOG( LOG_INFO, "Dropping index entry of vanished copy \"%s\"\n", entry->name );
+         removeentry( cache, entry );
+      }
+      else {
+         LOG( LOG_ERR, "Failed to open cached copy \"%s\" (%s)\n", entry->name, strerror(errno) );
+      }
+      int olderrno = errno;
+      pthread_mutex_unlock( &(cache->lock) );
+      errno = olderrno;
+      return -1;
+   }
+   // any reference promotes the entry to the head of the protected queue
+   queueunlink( cache, entry );
+   entry->state = CACHE_PROTECTED;
+   queuepush( cache, entry );
+   trimcache( cache, NULL );
+   pthread_mutex_unlock( &(cache->lock) );
+   return fd;
+}
+
+/**
+ * Request that the given object be asynchronously copied into the cache
+ * NOTE -- This is a no-op for objects which are already cached, already being filled,
+ *         or have previously been found to be too large to cache.
+ * @param DATACACHE cache : DATACACHE to be referenced
+ * @param const char* objname : Name of the data object
+ * @param ne_location location : Location of the data object
+ * @param ne_erasure erasure : Erasure structure of the data object
+ * @return int : Zero if the request was queued or ignored, or -1 on failure
+ */
+int datacache_fill( DATACACHE cache, const char* objname, ne_location location, ne_erasure erasure ) {
+   // check for invalid args
+   if ( cache == NULL  ||  objname == NULL ) {
+      LOG( LOG_ERR, "Received a NULL DATACACHE or object name reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   char* name = encodename( objname );
+   if ( name == NULL ) {
+      if ( errno == ENAMETOOLONG ) { return 0; } // simply not cachable
+      return -1;
+   }
+   pthread_mutex_lock( &(cache->lock) );
+   if ( cache->terminate  ||  cache->pendcount >= DATACACHE_MAXPENDING  ||  findentry( cache, name ) ) {
+      pthread_mutex_unlock( &(cache->lock) );
+      free( name );
+      return 0;
+   }
+   datacache_fillreq* req = calloc( 1, sizeof( struct datacache_fillreq_struct ) );
+   if ( req == NULL  ||  ( req->objname = strdup( objname ) ) == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a fill request for object \"%s\"\n", objname );
+      pthread_mutex_unlock( &(cache->lock) );
+      if ( req ) { free( req ); }
+      free( name );
+      return -1;
+   }
+   req->location = location;
+   req->erasure = erasure;
+   if ( ( req->entry = insertentry( cache, name, 0, CACHE_FILLING ) ) == NULL ) {
+      pthread_mutex_unlock( &(cache->lock) );
+      free( req->objname );
+      free( req );
+      free( name );
+      return -1;
+   }
+   if ( cache->fillstarted == 0 ) {
+      if ( pthread_create( &(cache->filler), NULL, fillthread, cache ) ) {
+         LOG( LOG_ERR, "Failed to start the DATACACHE fill thread\n" );
+         removeentry( cache, req->entry );
+         pthread_mutex_unlock( &(cache->lock) );
+         free( req->objname );
+         free( req );
+         return -1;
+      }
+      cache->fillstarted = 1;
+   }
+   if ( cache->pendtail ) { cache->pendtail->next = req; }
+   else { cache->pendhead = req; }
+   cache->pendtail = req;
+   cache->pendcount++;
+   pthread_cond_signal( &(cache->fillcond) );
+   pthread_mutex_unlock( &(cache->lock) );
+   return 0;
+}
+
+/**
+ * Remove any cached copy of the given object
+ * NOTE -- This removes the copy from the cache directory itself, and is thus effective even
+ *         against copies indexed by other processes sharing the same directory.
+ * @param DATACACHE cache : DATACACHE to be referenced
+ * @param const char* objname : Name of the data object
+ * @return int : Zero on success ( including if no copy existed ), or -1 on failure
+ */
+int datacache_invalidate( DATACACHE cache, const char* objname ) {
+   // check for invalid args
+   if ( cache == NULL  ||  objname == NULL ) {
+      LOG( LOG_ERR, "Received a NULL DATACACHE or object name reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   char* name = encodename( objname );
+   if ( name == NULL ) {
+      if ( errno == ENAMETOOLONG ) { return 0; } // could never have been cached
+      return -1;
+   }
+   int retval = 0;
+   pthread_mutex_lock( &(cache->lock) );
+   datacache_entry* entry = findentry( cache, name );
+   if ( entry  &&  entry->state == CACHE_FILLING ) { entry->stale = 1; }
+   else if ( entry ) { removeentry( cache, entry ); }
+   if ( unlinkat( cache->dirfd, name, 0 )  &&  errno != ENOENT ) {
+      LOG( LOG_ERR, "Failed to unlink cached copy \"%s\" (%s)\n", name, strerror(errno) );
+      retval = -1;
+   }
+   pthread_mutex_unlock( &(cache->lock) );
+   free( name );
+   return retval;
+}
+
@@ -0,0 +1,135 @@
+#ifndef _DATACACHE_H
+#define _DATACACHE_H
+/*
+Copyright (c) 2015, Los Alamos National Security, LLC
+All rights reserved.
+
+Copyright 2015.  Los Alamos National Security, LLC. This software was
+produced under U.S. Government contract DE-AC52-06NA25396 for Los
+Alamos National Laboratory (LANL), which is operated by Los Alamos
+National Security, LLC for the U.S. Department of Energy. The
+U.S. Government has rights to use, reproduce, and distribute this
+software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL SECURITY,
+LLC MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY
+FOR THE USE OF THIS SOFTWARE.  If software is modified to produce
+derivative works, such modified software should be clearly marked, so
+as not to confuse it with the version available from LANL.
+ 
+Additionally, redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the following
+conditions are met: 1. Redistributions of source code must retain the
+above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of Los Alamos National Security, LLC, Los Alamos
+National Laboratory, LANL, the U.S. Government, nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL LOS
+ALAMOS NATIONAL SECURITY, LLC OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-----
+NOTE:
+-----
+MarFS is released under the BSD license.
+
+MarFS was reviewed and released by LANL under Los Alamos Computer Code
+identifier: LA-CC-15-039.
+
+MarFS uses libaws4c for Amazon S3 object communication. The original version
+is at https://aws.amazon.com/code/Amazon-S3/2601 and under the LGPL license.
+LANL added functionality to the original work. The original work plus
+LANL contributions is found at https://github.com/jti-lanl/aws4c.
+
+GNU licenses can be found at http://www.gnu.org/licenses/.
+*/
+
+#include <ne.h>
+
+// A DATACACHE is a size-bounded directory of complete data object copies, intended to reside
+// on node-local flash.  Cached files are named by the erasure object name, which already
+// embeds the ctag and streamid of the writing stream.  As MarFS never rewrites the content
+// of an existing object name, a cached copy remains valid until that object is deleted.
+//
+// Residency follows a simplified 2Q policy : newly filled objects enter a FIFO 'probation'
+// queue, and only objects referenced again while resident are promoted into an LRU
+// 'protected' queue.  Eviction always prefers the probation queue, so a single large scan
+// cannot flush the hot set.
+//
+// NOTE -- The size bound is tracked per-process.  Multiple processes sharing a single cache
+//         directory will each enforce that bound against their own view of its content.
+
+#define DATACACHE_MAXFRACTION 4    // objects larger than 1/N of the cache size are never cached
+#define DATACACHE_MAXPENDING  64   // maximum count of queued fill requests
+#define DATACACHE_MAXREJECTS  1024 // count of oversized object names remembered, to avoid refills
+#define DATACACHE_STALEFILL   3600 // age ( seconds ) beyond which an orphaned fill file is removed
+
+typedef struct datacache_struct* DATACACHE;
+
+/**
+ * Initialize a DATACACHE, rooted at the given directory
+ * NOTE -- Any complete object copies already present in the directory will be indexed
+ *         ( most recently used first, based upon access time ), then trimmed to size.
+ * @param const char* path : Path of the cache directory ( created, if absent )
+ * @param size_t maxsize : Maximum total size of all cached objects
+ * @param ne_ctxt nectxt : LibNE context to be used for filling the cache
+ * @return DATACACHE : Reference to the new DATACACHE, or NULL on failure
+ */
+DATACACHE datacache_init( const char* path, size_t maxsize, ne_ctxt nectxt );
+
+/**
+ * Terminate the given DATACACHE, abandoning any pending fill requests
+ * NOTE -- Cached object copies are left in place, for use by later instances.
+ * @param DATACACHE cache : DATACACHE to be terminated
+ * @return int : Zero on success, or -1 on failure
+ */
+int datacache_term( DATACACHE cache );
+
+/**
+ * Open the cached copy of the given object
+ * NOTE -- The returned descriptor remains valid, even if the cached copy is later evicted.
+ * @param DATACACHE cache : DATACACHE to be referenced
+ * @param const char* objname : Name of the data object
+ * @return int : Read-only file descriptor of the cached copy, or -1 on failure
+ *               ( errno will be set to ENOENT if the object is not currently cached )
+ */
+int datacache_open( DATACACHE cache, const char* objname );
+
+/**
+ * Request that the given object be asynchronously copied into the cache
+ * NOTE -- This is a no-op for objects which are already cached, already being filled,
+ *         or have previously been found to be too large to cache.
+ * @param DATACACHE cache : DATACACHE to be referenced
+ * @param const char* objname : Name of the data object
+ * @param ne_location location : Location of the data object
+ * @param ne_erasure erasure : Erasure structure of the data object
+ * @return int : Zero if the request was queued or ignored, or -1 on failure
+ */
+int datacache_fill( DATACACHE cache, const char* objname, ne_location location, ne_erasure erasure );
+
+/**
+ * Remove any cached copy of the given object
+ * NOTE -- This removes the copy from the cache directory itself, and is thus effective even
+ *         against copies indexed by other processes sharing the same directory.
+ * @param DATACACHE cache : DATACACHE to be referenced
+ * @param const char* objname : Name of the data object
+ * @return int : Zero on success ( including if no copy existed ), or -1 on failure
+ */
+int datacache_invalidate( DATACACHE cache, const char* objname );
+
+#endif // _DATACACHE_H
+
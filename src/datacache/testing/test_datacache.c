@@ -0,0 +1,262 @@
+/*
+Copyright (c) 2015, Los Alamos National Security, LLC
+All rights reserved.
+
+Copyright 2015.  Los Alamos National Security, LLC. This software was
+produced under U.S. Government contract DE-AC52-06NA25396 for Los
+Alamos National Laboratory (LANL), which is operated by Los Alamos
+National Security, LLC for the U.S. Department of Energy. The
+U.S. Government has rights to use, reproduce, and distribute this
+software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL SECURITY,
+LLC MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY
+FOR THE USE OF THIS SOFTWARE.  If software is modified to produce
+derivative works, such modified software should be clearly marked, so
+as not to confuse it with the version available from LANL.
+ 
+Additionally, redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the following
+conditions are met: 1. Redistributions of source code must retain the
+above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of Los Alamos National Security, LLC, Los Alamos
+National Laboratory, LANL, the U.S. Government, nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL LOS
+ALAMOS NATIONAL SECURITY, LLC OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-----
+NOTE:
+-----
+MarFS is released under the BSD license.
+
+MarFS was reviewed and released by LANL under Los Alamos Computer Code
+identifier: LA-CC-15-039.
+
+MarFS uses libaws4c for Amazon S3 object communication. The original version
+is at https://aws.amazon.com/code/Amazon-S3/2601 and under the LGPL license.
+LANL added functionality to the original work. The original work plus
+LANL contributions is found at https://github.com/jti-lanl/aws4c.
+
+GNU licenses can be found at http://www.gnu.org/licenses/.
+*/
+
+#include "datacache/datacache.c"
+
+#include <sys/time.h>
+
+#define TESTDIR "./test_datacache_topdir"
+
+/**
+ * Create a cache file of the given size and access time
+ */
+int mkcachefile( const char* name, size_t size, time_t atime ) {
+   char path[1024];
+   snprintf( path, 1024, "%s/%s", TESTDIR, name );
+   int fd = open( path, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR );
+   if ( fd < 0 ) {
+      printf( "failed to create cache file \"%s\"\n", path );
+      return -1;
+   }
+   char buf[100];
+   memset( buf, (int)(*name), 100 );
+   while ( size ) {
+      size_t towrite = ( size > 100 ) ? 100 : size;
+      if ( write( fd, buf, towrite ) != towrite ) {
+         printf( "failed to write to cache file \"%s\"\n", path );
+         close( fd );
+         return -1;
+      }
+      size -= towrite;
+   }
+   close( fd );
+   struct timespec times[2] = { { .tv_sec = atime, .tv_nsec = 0 }, { .tv_sec = atime, .tv_nsec = 0 } };
+   if ( utimensat( AT_FDCWD, path, times, 0 ) ) {
+      printf( "failed to set times of cache file \"%s\"\n", path );
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Check whether the given object is currently cached
+ */
+int iscached( DATACACHE cache, const char* objname ) {
+   int fd = datacache_open( cache, objname );
+   if ( fd < 0 ) { return 0; }
+   close( fd );
+   return 1;
+}
+
+int main( int argc, char** argv ) {
+
+   // NOTE -- I'm ignoring memory leaks for error conditions
+   //         which result in immediate termination
+
+   // verify name encoding
+   char* name = encodename( ".some/obj%name" );
+   if ( name == NULL  ||  strcmp( name, "%2Esome%2Fobj%25name" ) ) {
+      printf( "unexpected encoding of object name: \"%s\"\n", ( name ) ? name : "NULL" );
+      return -1;
+   }
+   free( name );
+
+   // populate a cache dir with some existing content
+   if ( mkdir( TESTDIR, S_IRWXU ) ) {
+      printf( "failed to create test dir\n" );
+      return -1;
+   }
+   time_t now = time( NULL );
+   if ( mkcachefile( "obj|s1|0", 100, now - 40 )  ||
+        mkcachefile( "obj|s1|1", 100, now - 30 )  ||
+        mkcachefile( "obj|s1|2", 100, now - 20 )  ||
+        mkcachefile( "obj|s1|3", 100, now - 10 )  ||
+        mkcachefile( ".fill.1.0", 100, now - ( DATACACHE_STALEFILL * 2 ) )  ||
+        mkcachefile( ".fill.1.1", 100, now ) ) {
+      return -1;
+   }
+   DATACACHE cache = datacache_init( TESTDIR, 400, NULL );
+   if ( cache == NULL ) {
+      printf( "failed to initialize the data cache\n" );
+      return -1;
+   }
+   if ( cache->probation.count != 4  ||  cache->probation.bytes != 400  ||
+        strcmp( cache->probation.tail->name, "obj|s1|0" ) ) {
+      printf( "unexpected initial cache index state\n" );
+      return -1;
+   }
+   if ( access( TESTDIR "/.fill.1.0", F_OK ) == 0  ||  access( TESTDIR "/.fill.1.1", F_OK ) ) {
+      printf( "unexpected handling of fill files\n" );
+      return -1;
+   }
+
+   // read back a cached object
+   int fd = datacache_open( cache, "obj|s1|1" );
+   if ( fd < 0 ) {
+      printf( "failed to open cached object\n" );
+      return -1;
+   }
+   char buf[200];
+   if ( pread( fd, buf, 200, 0 ) != 100  ||  buf[0] != 'o'  ||  buf[99] != 'o' ) {
+      printf( "unexpected content of cached object\n" );
+      return -1;
+   }
+   close( fd );
+   if ( cache->protected.count != 1  ||  cache->protected.head->state != CACHE_PROTECTED ) {
+      printf( "referenced object was not promoted\n" );
+      return -1;
+   }
+   if ( datacache_open( cache, "obj|s1|9" ) >= 0  ||  errno != ENOENT ) {
+      printf( "unexpected result of opening a missing object\n" );
+      return -1;
+   }
+
+   // a newly filled object should evict the oldest unreferenced object, not the promoted one
+   if ( mkcachefile( "obj|s2|0", 100, now ) ) { return -1; }
+   pthread_mutex_lock( &(cache->lock) );
+   name = strdup( "obj|s2|0" );
+   datacache_entry* entry = insertentry( cache, name, 100, CACHE_PROBATION );
+   if ( entry == NULL ) {
+      printf( "failed to insert a new cache entry\n" );
+      return -1;
+   }
+   trimcache( cache, entry );
+   pthread_mutex_unlock( &(cache->lock) );
+   if ( iscached( cache, "obj|s1|0" )  ||  access( TESTDIR "/obj|s1|0", F_OK ) == 0 ) {
+      printf( "oldest unreferenced object was not evicted\n" );
+      return -1;
+   }
+   if ( !(iscached( cache, "obj|s1|1" ))  ||  !(iscached( cache, "obj|s2|0" )) ) {
+      printf( "an unexpected object was evicted\n" );
+      return -1;
+   }
+
+   // the protected queue should never consume the entire cache
+   if ( !(iscached( cache, "obj|s1|2" ))  ||  !(iscached( cache, "obj|s1|3" )) ) {
+      printf( "failed to promote remaining objects\n" );
+      return -1;
+   }
+   if ( cache->protected.bytes > 300  ||  cache->probation.count != 1 ) {
+      printf( "protected queue exceeds its size limit\n" );
+      return -1;
+   }
+
+   // rejected objects should be ignored by later fill requests
+   ne_location location = { .pod = 0, .cap = 0, .scatter = 0 };
+   ne_erasure erasure = { .N = 1, .E = 0, .O = 0, .partsz = 1024 };
+   pthread_mutex_lock( &(cache->lock) );
+   if ( insertentry( cache, strdup( "big|s3|0" ), 0, CACHE_REJECTED ) == NULL ) {
+      printf( "failed to insert a rejected cache entry\n" );
+      return -1;
+   }
+   pthread_mutex_unlock( &(cache->lock) );
+   if ( datacache_fill( cache, "big|s3|0", location, erasure )  ||  cache->pendcount  ||  cache->fillstarted ) {
+      printf( "unexpected fill request for a rejected object\n" );
+      return -1;
+   }
+   if ( iscached( cache, "big|s3|0" ) ) {
+      printf( "rejected object appears to be cached\n" );
+      return -1;
+   }
+
+   // invalidation should remove both the index entry and the cached copy
+   if ( datacache_invalidate( cache, "obj|s1|2" )  ||  datacache_invalidate( cache, "obj|s9|0" ) ) {
+      printf( "failed to invalidate cached objects\n" );
+      return -1;
+   }
+   if ( iscached( cache, "obj|s1|2" )  ||  access( TESTDIR "/obj|s1|2", F_OK ) == 0 ) {
+      printf( "invalidated object is still cached\n" );
+      return -1;
+   }
+
+   // externally removed copies should be dropped from the index
+   if ( unlink( TESTDIR "/obj|s1|3" )  ||  iscached( cache, "obj|s1|3" ) ) {
+      printf( "externally removed object is still cached\n" );
+      return -1;
+   }
+
+   // a new instance should pick up the remaining content
+   if ( datacache_term( cache ) ) {
+      printf( "failed to terminate the data cache\n" );
+      return -1;
+   }
+   cache = datacache_init( TESTDIR, 400, NULL );
+   if ( cache == NULL ) {
+      printf( "failed to reinitialize the data cache\n" );
+      return -1;
+   }
+   if ( !(iscached( cache, "obj|s1|1" ))  ||  !(iscached( cache, "obj|s2|0" ))  ||  cache->probation.count  ||
+        cache->protected.count != 2 ) {
+      printf( "reinitialized cache has unexpected content\n" );
+      return -1;
+   }
+   if ( datacache_term( cache ) ) {
+      printf( "failed to terminate the reinitialized data cache\n" );
+      return -1;
+   }
+
+   // cleanup
+   if ( unlink( TESTDIR "/obj|s1|1" )  ||  unlink( TESTDIR "/obj|s2|0" )  ||
+        unlink( TESTDIR "/.fill.1.1" )  ||  rmdir( TESTDIR ) ) {
+      printf( "failed to cleanup test dir\n" );
+      return -1;
+   }
+
+   return 0;
+}
+
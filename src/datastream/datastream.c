@@ -67,9 +67,11 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 
 #include <logging.h>
 #include "datastream.h"
+#include "stats/stats.h"
 #include "general_include/numdigits.h"
 
 #include <time.h>
+#include <unistd.h>
 
 
 //   -------------   INTERNAL DEFINITIONS    -------------
@@ -78,6 +80,22 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 #define INITIAL_FILE_ALLOC 64
 #define FILE_ALLOC_MULT     2
 
+// scratch arena allocations are aligned to this boundary
+#define ARENA_ALIGN        16
+#define ARENA_INITIAL_SIZE 4096
+
+typedef struct datastream_arena_overflow_struct {
+   struct datastream_arena_overflow_struct* next;
+   size_t size;
+} DATASTREAM_ARENA_OVERFLOW;
+#define ARENA_OVERFLOW_HEADER ( ( sizeof(DATASTREAM_ARENA_OVERFLOW) + (ARENA_ALIGN - 1) ) & ~((size_t)ARENA_ALIGN - 1) )
+
+typedef struct datastream_arena_mark_struct {
+   size_t used;
+   size_t demand;
+   void*  overflow;
+} DATASTREAM_ARENA_MARK;
+
 
 typedef struct datastream_position_struct {
    size_t totaloffset;      // offset from beginning of file ( SEEK_SET w/ this val would be no-op; includes 'fake' data )
@@ -91,9 +109,297 @@ typedef struct datastream_position_struct {
                             //   Note -- this changes per-file, within the same object ( recovFinfoLength differs )
 } DATASTREAM_POSITION;
 
+struct datastream_pread_struct {
+   const marfs_ds* ds;      // data scheme of the target file
+   FTAG        ftag;        // private copy of the target FTAG ( objno / offset track the read position )
+   size_t      recoveryheaderlen;
+   size_t      dataperobj;  // maximum amount of the file's data stored in each data object
+   size_t      count;       // bytes of actual data remaining to be read
+   size_t      zerotailbytes; // bytes of 'fake' data ( zero-fill, from truncate ) to append
+   ne_handle   datahandle;  // handle of the current data object ( NULL if none )
+   int         cachefd;     // local cache copy of the current data object ( -1 if unused )
+   COMPRESS_HANDLE comphandle; // decompression layer over datahandle / cachefd ( NULL if uncompressed )
+};
+
 
 //   -------------   INTERNAL FUNCTIONS    -------------
 
+/**
+ * Allocate scratch space from the given arena
+ * NOTE -- If 'arena' is NULL, this is equivalent to malloc().  Otherwise, the returned
+ *         space remains valid until the arena is released to a mark preceding this call.
+ * @param DATASTREAM_ARENA* arena : Arena to allocate from ( may be NULL )
+ * @param size_t size : Number of bytes to allocate
+ * @return void* : Reference to the allocated space, or NULL on failure
+ */
+void* arena_alloc(DATASTREAM_ARENA* arena, size_t size) {
+   if (arena == NULL) {
+      return malloc(size);
+   }
+   size_t alignsize = (size + (ARENA_ALIGN - 1)) & ~((size_t)ARENA_ALIGN - 1);
+   if (alignsize < size) {
+      LOG(LOG_ERR, "Arena allocation size of %zu is too large\n", size);
+      errno = ENOMEM;
+      return NULL;
+   }
+   // lazily allocate our primary block, sized to cover all previously observed demand
+   if (arena->block == NULL  &&  arena->demand == 0) {
+      size_t blocksize = (arena->peak > ARENA_INITIAL_SIZE) ? arena->peak : ARENA_INITIAL_SIZE;
+      arena->block = malloc(blocksize);
+      if (arena->block) {
+         arena->size = blocksize;
+         arena->used = 0;
+      }
+   }
+   void* retval = NULL;
+   if (arena->block  &&  (arena->size - arena->used) >= alignsize) {
+      retval = arena->block + arena->used;
+      arena->used += alignsize;
+   }
+   else {
+      // the primary block is exhausted ( or unavailable ), so fall back to an individual allocation
+      DATASTREAM_ARENA_OVERFLOW* overflow = malloc(ARENA_OVERFLOW_HEADER + alignsize);
+      if (overflow == NULL) {
+         LOG(LOG_ERR, "Failed to allocate %zu bytes of arena overflow space\n", alignsize);
+         return NULL;
+      }
+      overflow->next = arena->overflow;
+      overflow->size = alignsize;
+      arena->overflow = overflow;
+      retval = ((char*)overflow) + ARENA_OVERFLOW_HEADER;
+   }
+   arena->demand += alignsize;
+   if (arena->demand > arena->peak) {
+      arena->peak = arena->demand;
+   }
+   return retval;
+}
+
+/**
+ * Free scratch space previously allocated via arena_alloc()
+ * NOTE -- This is a no-op for non-NULL arenas, which only release space via arena_release()
+ * @param DATASTREAM_ARENA* arena : Arena the space was allocated from ( may be NULL )
+ * @param void* ptr : Reference to the space to be freed
+ */
+void arena_free(DATASTREAM_ARENA* arena, void* ptr) {
+   if (arena == NULL) {
+      free(ptr);
+   }
+}
+
+/**
+ * Identify the current allocation position of the given arena
+ * @param DATASTREAM_ARENA* arena : Arena to be marked
+ * @return DATASTREAM_ARENA_MARK : Mark value, for later use with arena_release()
+ */
+DATASTREAM_ARENA_MARK arena_mark(DATASTREAM_ARENA* arena) {
+   DATASTREAM_ARENA_MARK mark = {
+      .used = arena->used,
+      .demand = arena->demand,
+      .overflow = arena->overflow
+   };
+   return mark;
+}
+
+/**
+ * Release all arena allocations made since the given mark was produced
+ * @param DATASTREAM_ARENA* arena : Arena to be released
+ * @param DATASTREAM_ARENA_MARK mark : Mark value, produced by arena_mark()
+ */
+void arena_release(DATASTREAM_ARENA* arena, DATASTREAM_ARENA_MARK mark) {
+   while (arena->overflow != mark.overflow) {
+      DATASTREAM_ARENA_OVERFLOW* overflow = arena->overflow;
+      arena->overflow = overflow->next;
+      free(overflow);
+   }
+   arena->used = mark.used;
+   arena->demand = mark.demand;
+   // once completely empty, regrow the primary block if we previously had to overflow it
+   if (arena->demand == 0  &&  arena->peak > arena->size) {
+      free(arena->block);
+      arena->block = NULL;
+      arena->size = 0;
+   }
+}
+
+/**
+ * Free all space associated with the given arena
+ * @param DATASTREAM_ARENA* arena : Arena to be destroyed
+ */
+void arena_destroy(DATASTREAM_ARENA* arena) {
+   DATASTREAM_ARENA_MARK empty = { .used = 0, .demand = 0, .overflow = NULL };
+   arena_release(arena, empty);
+   if (arena->block) {
+      free(arena->block);
+   }
+   arena->block = NULL;
+   arena->size = 0;
+   arena->peak = 0;
+}
+
+/**
+ * Generate a reference path for the given FTAG
+ * @param FTAG* ftag : Reference to the FTAG value to generate an rpath for
+ * @param HASH_TABLE reftable : Reference position hash table to be used
+ * @param DATASTREAM_ARENA* arena : Arena to allocate from ( if NULL, malloc() is used )
+ * @return char* : Reference to the newly generated reference path, or NULL on failure
+ *                 NOTE -- returned path must be released via arena_free()
+ */
+char* genrpath(FTAG* ftag, HASH_TABLE reftable, DATASTREAM_ARENA* arena) {
+   // generate the meta reference name of this file
+   size_t rnamelen = ftag_metatgt(ftag, NULL, 0);
+   if (rnamelen < 1) {
+      LOG(LOG_ERR, "Failed to generate file meta reference name\n");
+      return NULL;
+   }
+   char* refname = arena_alloc(arena, sizeof(char) * (rnamelen + 1));
+   if (refname == NULL) {
+      LOG(LOG_ERR, "Failed to allocate a temporary meta reference string\n");
+      return NULL;
+   }
+   if (ftag_metatgt(ftag, refname, rnamelen + 1) != rnamelen) {
+      LOG(LOG_ERR, "Inconsistent length of file meta reference string\n");
+      arena_free(arena, refname);
+      return NULL;
+   }
+   // determine the target reference path of this file
+   HASH_NODE* noderef = NULL;
+   if (hash_lookup(reftable, refname, &(noderef)) < 0) {
+      LOG(LOG_ERR, "Failed to identify reference path for metaname \"%s\"\n", refname);
+      arena_free(arena, refname);
+      return NULL;
+   }
+   // populate the complete rpath
+   size_t rpathlen = strlen(noderef->name) + strlen(refname);
+   char* rpath = arena_alloc(arena, sizeof(char) * (rpathlen + 1));
+   if (rpath == NULL) {
+      LOG(LOG_ERR, "Failed to allocate rpath string\n");
+      arena_free(arena, refname);
+      return NULL;
+   }
+   if (snprintf(rpath, rpathlen + 1, "%s%s", noderef->name, refname) != rpathlen) {
+      LOG(LOG_ERR, "Failed to populate rpath string\n");
+      arena_free(arena, refname);
+      arena_free(arena, rpath);
+      errno = EFAULT;
+      return NULL;
+   }
+   arena_free(arena, refname); // done with this tmp string
+   return rpath;
+}
+
+/**
+ * Generate data object target info based on the given FTAG and datascheme references
+ * @param FTAG* ftag : Reference to the FTAG value to generate target info for
+ * @param const marfs_ds* ds : Reference to the current MarFS data scheme
+ * @param char** objectname : Reference to a char* to be populated with the object name
+ * @param ne_erasure* erasure : Reference to an ne_erasure struct to be populated with
+ *                              object erasure info
+ * @param ne_location* location : Reference to an ne_location struct to be populated with
+ *                                object location info
+ * @param DATASTREAM_ARENA* arena : Arena to allocate the object name from ( if NULL, malloc() is used )
+ * @return int : Zero on success, or -1 on failure
+ */
+int objtarget(FTAG* ftag, const marfs_ds* ds, char** objectname, ne_erasure* erasure, ne_location* location, DATASTREAM_ARENA* arena) {
+   // check for invalid args
+   if (ftag == NULL) {
+      LOG(LOG_ERR, "Received a NULL FTAG reference\n");
+      errno = EINVAL;
+      return -1;
+   }
+   if (ds == NULL) {
+      LOG(LOG_ERR, "Received a NULL marfs_ds reference\n");
+      errno = EINVAL;
+      return -1;
+   }
+   if (objectname == NULL) {
+      LOG(LOG_ERR, "Received a NULL objname reference\n");
+      errno = EINVAL;
+      return -1;
+   }
+   if (erasure == NULL) {
+      LOG(LOG_ERR, "Received a NULL ne_erasure reference\n");
+      errno = EINVAL;
+      return -1;
+   }
+   if (location == NULL) {
+      LOG(LOG_ERR, "Received a NULL ne_location reference\n");
+      errno = EINVAL;
+      return -1;
+   }
+   // find the length of the current object name
+   ssize_t objnamelen = ftag_datatgt(ftag, NULL, 0);
+   if (objnamelen <= 0) {
+      LOG(LOG_ERR, "Failed to determine object path from current ftag\n");
+      return -1;
+   }
+   // allocate a new string, and populate it with the object name
+   char* objname = arena_alloc(arena, sizeof(char) * (objnamelen + 1));
+   if (objname == NULL) {
+      LOG(LOG_ERR, "Failed to allocate space for new object name\n");
+      return -1;
+   }
+   if (objnamelen != ftag_datatgt(ftag, objname, objnamelen + 1)) {
+      LOG(LOG_ERR, "Ftag producing inconsistent object name string\n");
+      arena_free(arena, objname);
+      return -1;
+   }
+
+   // identify the pod/cap/scatter values for the current object
+   ne_location tmplocation = { .pod = -1, .cap = -1, .scatter = -1 };
+   int iteration = 0;
+   for (; iteration < 3; iteration++) {
+      // determine which table we are currently pulling from
+      HASH_TABLE curtable = ds->scattertable;
+      int* tgtval = &(tmplocation.scatter);
+      if (iteration < 1) {
+         curtable = ds->podtable;
+         tgtval = &(tmplocation.pod);
+      }
+      else if (iteration < 2) {
+         curtable = ds->captable;
+         tgtval = &(tmplocation.cap);
+      }
+      // hash our object name, to identify a target node
+      HASH_NODE* node = NULL;
+      if (hash_lookup(curtable, objname, &node) < 0) {
+         LOG(LOG_ERR, "Failed to lookup %s location for new object \"%s\"\n",
+            (iteration < 1) ? "pod" : (iteration < 2) ? "cap" : "scatter",
+            objname);
+         arena_free(arena, objname);
+         return -1;
+      }
+      // parse our nodename, to produce an integer value
+      char* endptr = NULL;
+      unsigned long long parseval = strtoull(node->name, &(endptr), 10);
+      if (*endptr != '\0' || parseval >= INT_MAX) {
+         LOG(LOG_ERR, "Failed to parse %s value of \"%s\" for new object \"%s\"\n",
+            (iteration < 1) ? "pod" : (iteration < 2) ? "cap" : "scatter",
+            node->name, objname);
+         arena_free(arena, objname);
+         return -1;
+      }
+      // assign the parsed value to the appropriate var
+      *tgtval = (int)parseval;
+   }
+
+   // identify the erasure scheme
+   ne_erasure tmperasure = ftag->protection;
+   tmperasure.O = (int)(hash_rangevalue(objname, tmperasure.N + tmperasure.E)); // produce tmperasure offset value
+   LOG(LOG_INFO, "Object: \"%s\"\n", objname);
+   LOG(LOG_INFO, "Position: pod%d, cap%d, scatter%d\n",
+      tmplocation.pod, tmplocation.cap, tmplocation.scatter);
+   LOG(LOG_INFO, "Erasure: N=%d,E=%d,O=%d,psz=%zu\n",
+      tmperasure.N, tmperasure.E, tmperasure.O, tmperasure.partsz);
+
+   // populate all return structs
+   *objectname = objname;
+   *erasure = tmperasure;
+   *location = tmplocation;
+
+   return 0;
+}
+
 /**
  * Generate a new Stream ID string and recovery header size based on that ID
  * @param char** streamid : Reference to be populated with the Stream ID string
@@ -150,7 +456,8 @@ int genstreamid(char* ctag, const marfs_ns* ns, char** streamid, size_t* rheader
       .majorversion = RECOVERY_CURRENT_MAJORVERSION,
       .minorversion = RECOVERY_CURRENT_MINORVERSION,
       .ctag = ctag,
-      .streamid = newstreamid
+      .streamid = newstreamid,
+      .compression = ns->prepo->datascheme.compression
    };
    size_t newrecoveryheaderlen = recovery_headertostr(&(header), NULL, 0);
    if (newrecoveryheaderlen < 1) {
@@ -227,9 +534,30 @@ void freestream(DATASTREAM stream) {
    // shorthand references
    const marfs_ms* ms = &(stream->ns->prepo->metascheme);
    // abort any data handle
+   if (stream->comphandle) {
+      compress_abort(stream->comphandle);
+   }
    if (stream->datahandle && ne_abort(stream->datahandle)) {
       LOG(LOG_WARNING, "Failed to abort stream datahandle\n");
    }
+   // close any local cache copy
+   if (stream->cachefd >= 0 && close(stream->cachefd)) {
+      LOG(LOG_WARNING, "Failed to close stream cache copy\n");
+   }
+   // abort any cached data handles
+   if (stream->objcache) {
+      size_t index = 0;
+      for (; index < stream->objcachesize; index++) {
+         DATASTREAM_CACHEDOBJ* cached = stream->objcache + index;
+         if (cached->comphandle) {
+            compress_abort(cached->comphandle);
+         }
+         if (cached->handle && ne_abort(cached->handle)) {
+            LOG(LOG_WARNING, "Failed to abort cached handle for object %zu\n", cached->objno);
+         }
+      }
+      free(stream->objcache);
+   }
    // free any string elements
    if (stream->ctag) {
       free(stream->ctag);
@@ -249,6 +577,7 @@ void freestream(DATASTREAM stream) {
    if (stream->finfo.path) {
       free(stream->finfo.path);
    }
+   arena_destroy(&(stream->arena));
    // iterate over all file references and clean them up
    if (stream->files) {
       size_t curfile = 0;
@@ -304,7 +633,7 @@ size_t allocfiles(STREAMFILE** files, size_t current, size_t max) {
  * @param STREAMFILE* file : Reference to the STREAMFILE to have its FTAG updated
  * @return int : Zero on success, -1 if a failure occurred
  */
-int putftag(DATASTREAM stream, STREAMFILE* file) {
+static int untimed_putftag(DATASTREAM stream, STREAMFILE* file) {
    // shorthand references
    const marfs_ms* ms = &(stream->ns->prepo->metascheme);
    // populate the ftag string format
@@ -346,6 +675,16 @@ int putftag(DATASTREAM stream, STREAMFILE* file) {
    return 0;
 }
 
+/**
+ * Timed wrapper for untimed_putftag() ( see above )
+ */
+int putftag(DATASTREAM stream, STREAMFILE* file) {
+   uint64_t statstart = stats_start();
+   int retval = untimed_putftag(stream, file);
+   stats_record(STATS_DS_PUTFTAG, statstart, 0, (retval != 0));
+   return retval;
+}
+
 /**
  * Retrieve a given STREAMFILE's FTAG attribute
  * @param DATASTREAM stream : Current DATASTREAM
@@ -396,42 +735,6 @@ int getftag(DATASTREAM stream, STREAMFILE* file) {
    return 0;
 }
 
-/**
- * Link the given reference path to the given target path, potentially unlinking an
- * existing target
- * @param DATASTREAM stream : Current DATASTREAM
- * @param const char* refpath : Reference path to be linked from
- * @param const char* tgtpath : Target path to be linked to
- * @param MDAL_CTXT ctxt : Current MDAL_CTXT
- * @return int : Zero on success, -1 on failure
- */
-int linkfile(DATASTREAM stream, const char* refpath, const char* tgtpath, MDAL_CTXT ctxt) {
-   // shorthand references
-   const marfs_ms* ms = &(stream->ns->prepo->metascheme);
-   // attempt to link the specified file to the specified user path
-   if (ms->mdal->linkref(ctxt, 0, refpath, tgtpath)) {
-      // if we got EEXIST, attempt to unlink the existing target and retry
-      if (errno != EEXIST) {
-         // any non-EEXIST error is fatal
-         LOG(LOG_ERR, "Failed to link reference file to final location\n");
-         return -1;
-      }
-      else if (ms->mdal->unlink(ctxt, tgtpath) && errno != ENOENT) {
-         // ENOENT would indicate that another proc has unlinked the conflicting file for us
-         //   Otherwise, we have to fail
-         LOG(LOG_ERR, "Failed to unlink existing file: \"%s\"\n", tgtpath);
-         return -1;
-      }
-      else if (ms->mdal->linkref(ctxt, 0, refpath, tgtpath)) {
-         // This indicates either we're racing with another proc, or something more unusual
-         //   Just fail out with whatever errno we get from flink()
-         LOG(LOG_ERR, "Failed to link reference file to final location after retry\n");
-         return -1;
-      }
-   }
-   return 0;
-}
-
 /**
  * Populate the given RECOVERY_FINFO struct with values based on the given STREAMFILE
  * @param DATASTREAM stream : Current DATASTREAM
@@ -501,6 +804,63 @@ int genrecoveryinfo(DATASTREAM stream, RECOVERY_FINFO* finfo, STREAMFILE* file,
    return 0;
 }
 
+// argument struct for populatefile()
+struct populatefile_args {
+   DATASTREAM stream;
+   STREAMFILE* file;
+   RECOVERY_FINFO* finfo;
+   const char* path;
+};
+
+/**
+ * Populate recovery info and attach an initial FTAG to a newly created ( not yet visible ) file
+ * NOTE -- This function is intended for use as a 'populate' callback of the MDAL createref() func
+ * @param MDAL_FHANDLE fh : MDAL_WRITE handle of the new file
+ * @param void* arg : Reference to a populatefile_args struct
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int populatefile(MDAL_FHANDLE fh, void* arg) {
+   struct populatefile_args* args = (struct populatefile_args*)arg;
+   DATASTREAM stream = args->stream;
+   STREAMFILE* newfile = args->file;
+   newfile->metahandle = fh;
+
+   // identify file recovery info
+   if (genrecoveryinfo(stream, args->finfo, newfile, args->path)) {
+      LOG(LOG_ERR, "Failed to populate recovery info for file: \"%s\"\n", args->path);
+      return -1;
+   }
+
+   // ensure the recovery info size is compatible with the current object size
+   if (newfile->ftag.objsize && (stream->recoveryheaderlen + newfile->ftag.recoverybytes) >= newfile->ftag.objsize) {
+      LOG(LOG_ERR, "Recovery info size of new file is incompatible with current object size\n");
+      errno = ENAMETOOLONG; // this is most likely an issue with path length
+      return -1;
+   }
+
+   // ensure that the current object still has space remaining for this file
+   if (newfile->ftag.objsize && (newfile->ftag.objsize - stream->offset) < newfile->ftag.recoverybytes) {
+      // we're too far into the current obj to fit any more data
+      LOG(LOG_INFO, "Shifting to new object, as current can't hold recovery info\n");
+      newfile->ftag.objno++;
+      newfile->ftag.offset = stream->recoveryheaderlen;
+   }
+   else if (newfile->ftag.objfiles && stream->curfile >= newfile->ftag.objfiles) {
+      // there are too many files in the current obj to fit this one
+      LOG(LOG_INFO, "Shifting to new object, as current can't hold another file\n");
+      newfile->ftag.objno++;
+      newfile->ftag.offset = stream->recoveryheaderlen;
+   }
+
+   // attach updated ftag value to the new file
+   if (putftag(stream, newfile)) {
+      LOG(LOG_ERR, "Failed to initialize FTAG value on target file\n");
+      return -1;
+   }
+
+   return 0;
+}
+
 /**
  * Create a new file at the current ( 'curfile' ) STREAMFILE reference position
  * @param DATASTREAM stream : Current DATASTREAM
@@ -525,6 +885,7 @@ int create_new_file(DATASTREAM stream, const char* path, MDAL_CTXT ctxt, mode_t
       .ftag.streamid = stream->streamid,
       .ftag.objfiles = ds->objfiles,
       .ftag.objsize = ds->objsize,
+      .ftag.compression = ds->compression,
       .ftag.refbreadth = ms->refbreadth,
       .ftag.refdepth = ms->refdepth,
       .ftag.refdigits = ms->refdigits,
@@ -545,18 +906,29 @@ int create_new_file(DATASTREAM stream, const char* path, MDAL_CTXT ctxt, mode_t
    };
 
    // establish a reference path for the new file
-   char* newrpath = datastream_genrpath(&(newfile.ftag), stream->ns->prepo->metascheme.reftable);
+   DATASTREAM_ARENA_MARK arenamark = arena_mark(&(stream->arena));
+   char* newrpath = genrpath(&(newfile.ftag), stream->ns->prepo->metascheme.reftable, &(stream->arena));
    if (newrpath == NULL) {
       LOG(LOG_ERR, "Failed to identify reference path for stream\n");
+      arena_release(&(stream->arena), arenamark);
       if (errno == EBADFD) {
          errno = ENOMSG;
       } // don't allow our reserved EBADFD value
       return -1;
    }
 
-   // create the reference file, ensuring we don't collide with an existing reference
-   newfile.metahandle = ms->mdal->openref(ctxt, newrpath, O_CREAT | O_EXCL | O_WRONLY, mode);
-   if (newfile.metahandle == NULL) {
+   // create the reference file, populate its FTAG, and link it into the user namespace
+   //   NOTE -- the MDAL will only expose the new file once populatefile() has completed,
+   //           so no other proc should ever observe a reference lacking an FTAG
+   RECOVERY_FINFO newfinfo = {.path = NULL};
+   struct populatefile_args popargs =
+   {
+      .stream = stream,
+      .file = &(newfile),
+      .finfo = &(newfinfo),
+      .path = path
+   };
+   if (ms->mdal->createref(ctxt, newrpath, mode, path, populatefile, &(popargs)) == NULL) {
       LOG(LOG_ERR, "Failed to create reference meta file: \"%s\"\n", newrpath);
       // a BUSY error is more indicative of the real problem
       if (errno == EEXIST) {
@@ -566,64 +938,10 @@ int create_new_file(DATASTREAM stream, const char* path, MDAL_CTXT ctxt, mode_t
       else if (errno == EBADFD) {
          errno = ENOMSG;
       }
-      free(newrpath);
-      return -1;
-   }
-
-   // identify file recovery info
-   RECOVERY_FINFO newfinfo;
-   if (genrecoveryinfo(stream, &(newfinfo), &(newfile), path)) {
-      LOG(LOG_ERR, "Failed to populate recovery info for file: \"%s\"\n", path);
-      ms->mdal->unlinkref(ctxt, newrpath);
-      free(newrpath);
-      if (errno == EBADFD) {
-         errno = ENOMSG;
-      } // don't allow our reserved EBADFD value
-      return -1;
-   }
-
-   // ensure the recovery info size is compatible with the current object size
-   if (newfile.ftag.objsize && (stream->recoveryheaderlen + newfile.ftag.recoverybytes) >= newfile.ftag.objsize) {
-      LOG(LOG_ERR, "Recovery info size of new file is incompatible with current object size\n");
-      ms->mdal->unlinkref(ctxt, newrpath);
-      free(newrpath);
-      errno = ENAMETOOLONG; // this is most likely an issue with path length
-      return -1;
-   }
-
-   // ensure that the current object still has space remaining for this file
-   if (newfile.ftag.objsize && (newfile.ftag.objsize - stream->offset) < newfile.ftag.recoverybytes) {
-      // we're too far into the current obj to fit any more data
-      LOG(LOG_INFO, "Shifting to new object, as current can't hold recovery info\n");
-      newfile.ftag.objno++;
-      newfile.ftag.offset = stream->recoveryheaderlen;
-   }
-   else if (newfile.ftag.objfiles && stream->curfile >= newfile.ftag.objfiles) {
-      // there are too many files in the current obj to fit this one
-      LOG(LOG_INFO, "Shifting to new object, as current can't hold another file\n");
-      newfile.ftag.objno++;
-      newfile.ftag.offset = stream->recoveryheaderlen;
-   }
-
-   // attach updated ftag value to the new file
-   if (putftag(stream, &(newfile))) {
-      LOG(LOG_ERR, "Failed to initialize FTAG value on target file\n");
-      ms->mdal->unlinkref(ctxt, newrpath);
-      free(newrpath);
-      if (errno == EBADFD) {
-         errno = ENOMSG;
-      } // don't allow our reserved EBADFD value
-      return -1;
-   }
-
-   // link the new file into the user namespace
-   if (linkfile(stream, newrpath, path, ctxt)) {
-      LOG(LOG_ERR, "Failed to link reference file to target user path: \"%s\"\n", path);
-      ms->mdal->unlinkref(ctxt, newrpath);
-      free(newrpath);
-      if (errno == EBADFD) {
-         errno = ENOMSG;
-      } // don't allow our reserved EBADFD value
+      if (newfinfo.path) {
+         free(newfinfo.path);
+      }
+      arena_release(&(stream->arena), arenamark);
       return -1;
    }
 
@@ -634,14 +952,14 @@ int create_new_file(DATASTREAM stream, const char* path, MDAL_CTXT ctxt, mode_t
          LOG(LOG_ERR, "Failed to expand file list allocation\n");
          stream->filealloc = stream->curfile - 1;
          ms->mdal->unlinkref(ctxt, newrpath);
-         free(newrpath);
+         arena_release(&(stream->arena), arenamark);
          if (errno == EBADFD) {
             errno = ENOMSG;
          } // don't allow our reserved EBADFD value
          return -1;
       }
    }
-   free(newrpath); // finally done with rpath
+   arena_release(&(stream->arena), arenamark); // finally done with rpath
 
    // update the stream with new file information
    stream->files[stream->curfile] = newfile;
@@ -751,7 +1069,8 @@ int open_existing_file(DATASTREAM stream, const char* path, char rpathflag, MDAL
       .majorversion = RECOVERY_CURRENT_MAJORVERSION,
       .minorversion = RECOVERY_CURRENT_MINORVERSION,
       .ctag = curfile->ftag.ctag,
-      .streamid = curfile->ftag.streamid
+      .streamid = curfile->ftag.streamid,
+      .compression = curfile->ftag.compression
    };
    size_t recoveryheaderlen = recovery_headertostr(&(header), NULL, 0);
    if (recoveryheaderlen < 1) {
@@ -893,6 +1212,7 @@ int open_repack_file(DATASTREAM stream, const char* path, MDAL_CTXT ctxt) {
    curfile->ftag.streamid = stream->streamid;
    curfile->ftag.objfiles = ds->objfiles;
    curfile->ftag.objsize = ds->objsize;
+   curfile->ftag.compression = ds->compression;
    curfile->ftag.refbreadth = ms->refbreadth;
    curfile->ftag.refdepth = ms->refdepth;
    curfile->ftag.refdigits = ms->refdigits;
@@ -1021,7 +1341,8 @@ int open_repack_file(DATASTREAM stream, const char* path, MDAL_CTXT ctxt) {
          .majorversion = RECOVERY_CURRENT_MAJORVERSION,
          .minorversion = RECOVERY_CURRENT_MINORVERSION,
          .ctag = curfile->ftag.ctag,
-         .streamid = curfile->ftag.streamid
+         .streamid = curfile->ftag.streamid,
+         .compression = curfile->ftag.compression
       };
       size_t recoveryheaderlen = recovery_headertostr(&(header), NULL, 0);
       if (recoveryheaderlen < 1) {
@@ -1040,15 +1361,180 @@ int open_repack_file(DATASTREAM stream, const char* path, MDAL_CTXT ctxt) {
    return 0;
 }
 
+/**
+ * Seek the current raw data object reference of the given DATASTREAM to the given offset
+ * NOTE -- this ignores any compression of the object ( see seek_current_obj() )
+ * @param void* arg : Current DATASTREAM
+ * @param off_t offset : Target physical offset within the data object
+ * @return off_t : Resulting offset, or -1 on failure
+ */
+static off_t rawseek_current_obj(void* arg, off_t offset) {
+   DATASTREAM stream = (DATASTREAM)arg;
+   if (stream->cachefd >= 0) {
+      return lseek(stream->cachefd, offset, SEEK_SET);
+   }
+   return ne_seek(stream->datahandle, offset);
+}
+
+/**
+ * Seek the current raw data object reference of the given DATASTREAM to the given offset
+ * within the compressed frames of the object ( used as a COMPRESS_IO function )
+ * NOTE -- frames begin immediately following the uncompressed recovery header
+ * @param void* arg : Current DATASTREAM
+ * @param off_t offset : Target physical offset, relative to the first frame
+ * @return off_t : Resulting offset, or -1 on failure
+ */
+static off_t rawseekframes_current_obj(void* arg, off_t offset) {
+   DATASTREAM stream = (DATASTREAM)arg;
+   off_t seekres = rawseek_current_obj(arg, offset + stream->recoveryheaderlen);
+   if (seekres < 0) {
+      return -1;
+   }
+   return seekres - stream->recoveryheaderlen;
+}
+
+/**
+ * Read from the current raw data object reference of the given DATASTREAM
+ * NOTE -- this ignores any compression of the object ( see read_current_obj() )
+ * @param void* arg : Current DATASTREAM
+ * @param void* buf : Buffer to be populated
+ * @param size_t count : Number of bytes to be read
+ * @return ssize_t : Number of bytes read, or -1 on failure
+ */
+static ssize_t rawread_current_obj(void* arg, void* buf, size_t count) {
+   DATASTREAM stream = (DATASTREAM)arg;
+   if (stream->cachefd < 0) {
+      return ne_read(stream->datahandle, buf, count);
+   }
+   // unlike ne_read(), local reads may return short, so fill as much of the buffer as possible
+   size_t readbytes = 0;
+   while (readbytes < count) {
+      ssize_t readres = read(stream->cachefd, (char*)buf + readbytes, count - readbytes);
+      if (readres < 0) {
+         return -1;
+      }
+      if (readres == 0) {
+         break;
+      }
+      readbytes += readres;
+   }
+   return readbytes;
+}
+
+/**
+ * Write to the current raw data object reference of the given DATASTREAM
+ * NOTE -- this ignores any compression of the object ( see write_current_obj() )
+ * @param void* arg : Current DATASTREAM
+ * @param const void* buf : Buffer to be written
+ * @param size_t count : Number of bytes to be written
+ * @return ssize_t : Number of bytes written, or -1 on failure
+ */
+static ssize_t rawwrite_current_obj(void* arg, const void* buf, size_t count) {
+   DATASTREAM stream = (DATASTREAM)arg;
+   return ne_write(stream->datahandle, buf, count);
+}
+
+/**
+ * Seek the current data object reference of the given DATASTREAM to the given offset
+ * @param DATASTREAM stream : Current DATASTREAM
+ * @param off_t offset : Target offset within the ( uncompressed ) data object
+ * @return off_t : Resulting offset, or -1 on failure
+ */
+static off_t seek_current_obj(DATASTREAM stream, off_t offset) {
+   if (stream->comphandle) {
+      // the compressed content of the object only begins following the recovery header
+      if (offset < (off_t)stream->recoveryheaderlen) {
+         LOG(LOG_ERR, "Cannot seek to offset %zd, within the recovery header of a compressed object\n", offset);
+         errno = EINVAL;
+         return -1;
+      }
+      off_t seekres = compress_seek(stream->comphandle, offset - stream->recoveryheaderlen);
+      if (seekres < 0) {
+         return -1;
+      }
+      return seekres + stream->recoveryheaderlen;
+   }
+   return rawseek_current_obj(stream, offset);
+}
+
+/**
+ * Read from the current data object reference of the given DATASTREAM
+ * @param DATASTREAM stream : Current DATASTREAM
+ * @param void* buf : Buffer to be populated
+ * @param size_t count : Number of bytes to be read
+ * @return ssize_t : Number of bytes read, or -1 on failure
+ */
+static ssize_t read_current_obj(DATASTREAM stream, void* buf, size_t count) {
+   if (stream->comphandle) {
+      return compress_read(stream->comphandle, buf, count);
+   }
+   return rawread_current_obj(stream, buf, count);
+}
+
+/**
+ * Write to the current data object reference of the given DATASTREAM
+ * @param DATASTREAM stream : Current DATASTREAM
+ * @param const void* buf : Buffer to be written
+ * @param size_t count : Number of bytes to be written
+ * @return ssize_t : Number of bytes written, or -1 on failure
+ */
+static ssize_t write_current_obj(DATASTREAM stream, const void* buf, size_t count) {
+   if (stream->comphandle) {
+      return compress_write(stream->comphandle, buf, count);
+   }
+   return rawwrite_current_obj(stream, buf, count);
+}
+
+/**
+ * Abandon the current data object reference of the given DATASTREAM, without syncing
+ * @param DATASTREAM stream : Current DATASTREAM
+ */
+static void abort_current_obj(DATASTREAM stream) {
+   if (stream->comphandle) {
+      compress_abort(stream->comphandle);
+      stream->comphandle = NULL;
+   }
+   if (stream->cachefd >= 0) {
+      close(stream->cachefd);
+      stream->cachefd = -1;
+   }
+   if (stream->datahandle) {
+      ne_abort(stream->datahandle);
+      stream->datahandle = NULL;
+   }
+}
+
 /**
  * Open the current data object of the given DATASTREAM
  * @param DATASTREAM stream : Current DATASTREAM
  * @return int : Zero on success, or -1 on failure
  */
-int open_current_obj(DATASTREAM stream) {
+static int untimed_open_current_obj(DATASTREAM stream) {
    // shorthand references
    const marfs_ds* ds = &(stream->ns->prepo->datascheme);
 
+   // check for a cached handle of the target object
+   if (stream->type == READ_STREAM) {
+      size_t index = 0;
+      for (; index < stream->objcachesize; index++) {
+         DATASTREAM_CACHEDOBJ* cached = stream->objcache + index;
+         if (cached->handle && cached->objno == stream->objno) {
+            LOG(LOG_INFO, "Reusing cached handle for object %zu\n", stream->objno);
+            stream->datahandle = cached->handle;
+            stream->comphandle = cached->comphandle;
+            cached->handle = NULL;
+            cached->comphandle = NULL;
+            // the cached handle may be positioned anywhere within the object
+            if (stream->offset != seek_current_obj(stream, stream->offset)) {
+               LOG(LOG_ERR, "Failed to seek to offset %zu of cached object %zu\n", stream->offset, stream->objno);
+               abort_current_obj(stream);
+               return -1;
+            }
+            return 0;
+         }
+      }
+   }
+
    // find the length of the current object name
    FTAG tgttag = stream->files[stream->curfile].ftag;
    tgttag.objno = stream->objno; // we actually want the stream object number
@@ -1058,15 +1544,28 @@ int open_current_obj(DATASTREAM stream) {
    char* objname = NULL;
    ne_erasure erasure;
    ne_location location;
-   if (datastream_objtarget(&(tgttag), ds, &(objname), &(erasure), &(location))) {
+   if (objtarget(&(tgttag), ds, &(objname), &(erasure), &(location), &(stream->arena))) {
       LOG(LOG_ERR, "Failed to identify the current object target\n");
       return -1;
    }
 
    // open a handle for the new object
    if (stream->type == READ_STREAM) {
-      LOG(LOG_INFO, "Opening object for READ: \"%s\"\n", objname);
-      stream->datahandle = ne_open(ds->nectxt, objname, location, erasure, NE_RDALL);
+      // prefer any local cache copy of the object
+      if (ds->cache) {
+         stream->cachefd = datacache_open(ds->cache, objname);
+         if (stream->cachefd >= 0) {
+            LOG(LOG_INFO, "Opening cached copy of object for READ: \"%s\"\n", objname);
+         }
+         // populate the cache for later reads ( a failure here need not fail this one )
+         else if (datacache_fill(ds->cache, objname, location, erasure)) {
+            LOG(LOG_WARNING, "Failed to request a cache fill of object \"%s\"\n", objname);
+         }
+      }
+      if (stream->cachefd < 0) {
+         LOG(LOG_INFO, "Opening object for READ: \"%s\"\n", objname);
+         stream->datahandle = ne_open(ds->nectxt, objname, location, erasure, NE_RDALL);
+      }
    }
    else {
       if (stream->type == CREATE_STREAM  ||  stream->type == REPACK_STREAM) {
@@ -1083,22 +1582,36 @@ int open_current_obj(DATASTREAM stream) {
       LOG(LOG_INFO, "Opening object for WRITE: \"%s\"\n", objname);
       stream->datahandle = ne_open(ds->nectxt, objname, location, erasure, NE_WRALL);
    }
-   if (stream->datahandle == NULL) {
+   if (stream->datahandle == NULL && stream->cachefd < 0) {
       LOG(LOG_ERR, "Failed to open object \"%s\"\n", objname);
-      free(objname);
       return -1;
    }
-   free(objname); // done with object name
+
+   // layer decompression / compression over the object, if necessary
+   if (tgttag.compression != FTAG_COMPRESS_NONE) {
+      COMPRESS_IO io =
+      {
+         .arg = stream,
+         .read = rawread_current_obj,
+         .write = rawwrite_current_obj,
+         .seek = rawseekframes_current_obj
+      };
+      stream->comphandle = compress_open(tgttag.compression, ds->complevel, (stream->type != READ_STREAM), &(io));
+      if (stream->comphandle == NULL) {
+         LOG(LOG_ERR, "Failed to initialize compression of object \"%s\"\n", objname);
+         abort_current_obj(stream);
+         return -1;
+      }
+   }
 
    if (stream->type == READ_STREAM) {
       // if we're reading, we may need to seek to a specific offset
       if (stream->offset) {
          LOG(LOG_INFO, "Seeking to offset %zd of object %zu\n",
             stream->offset, stream->objno);
-         if (stream->offset != ne_seek(stream->datahandle, stream->offset)) {
+         if (stream->offset != seek_current_obj(stream, stream->offset)) {
             LOG(LOG_ERR, "Failed to seek to offset %zu of object %zu\n", stream->offset, stream->objno);
-            ne_abort(stream->datahandle);
-            stream->datahandle = NULL;
+            abort_current_obj(stream);
             return -1;
          }
       }
@@ -1108,8 +1621,7 @@ int open_current_obj(DATASTREAM stream) {
       if (stream->offset != stream->recoveryheaderlen) {
          LOG(LOG_ERR, "Stream offset does not match recovery header length of %zu\n",
             stream->recoveryheaderlen);
-         ne_abort(stream->datahandle);
-         stream->datahandle = NULL;
+         abort_current_obj(stream);
          return -1;
       }
 
@@ -1119,37 +1631,67 @@ int open_current_obj(DATASTREAM stream) {
          .majorversion = RECOVERY_CURRENT_MAJORVERSION,
          .minorversion = RECOVERY_CURRENT_MINORVERSION,
          .ctag = stream->ctag,
-         .streamid = stream->streamid
+         .streamid = stream->streamid,
+         .compression = tgttag.compression
       };
-      char* recovheader = malloc(sizeof(char) * (stream->recoveryheaderlen + 1));
+      char* recovheader = arena_alloc(&(stream->arena), sizeof(char) * (stream->recoveryheaderlen + 1));
       if (recovheader == NULL) {
          LOG(LOG_ERR, "Failed to allocate space for recovery header string\n");
-         ne_abort(stream->datahandle);
-         stream->datahandle = NULL;
+         abort_current_obj(stream);
          return -1;
       }
       if (recovery_headertostr(&(header), recovheader, stream->recoveryheaderlen + 1) != stream->recoveryheaderlen) {
          LOG(LOG_ERR, "Recovery header string has inconsistent length (expected %zu)\n",
             stream->recoveryheaderlen);
-         ne_abort(stream->datahandle);
-         stream->datahandle = NULL;
-         free(recovheader);
+         abort_current_obj(stream);
          errno = EFAULT;
          return -1;
       }
-      if (ne_write(stream->datahandle, recovheader, stream->recoveryheaderlen) != stream->recoveryheaderlen) {
+      // NOTE -- the header is never compressed, allowing recovery to identify the compression type
+      if (rawwrite_current_obj(stream, recovheader, stream->recoveryheaderlen) != stream->recoveryheaderlen) {
          LOG(LOG_ERR, "Failed to write recovery header to new data object\n");
-         ne_abort(stream->datahandle);
-         stream->datahandle = NULL;
-         free(recovheader);
+         abort_current_obj(stream);
          return -1;
       }
-      free(recovheader); // done with recovery header string
    }
 
    return 0;
 }
 
+/**
+ * Timed wrapper for untimed_open_current_obj() ( see above )
+ * NOTE -- all arena space allocated by the open is released here
+ */
+int open_current_obj(DATASTREAM stream) {
+   uint64_t statstart = stats_start();
+   DATASTREAM_ARENA_MARK arenamark = arena_mark(&(stream->arena));
+   int retval = untimed_open_current_obj(stream);
+   arena_release(&(stream->arena), arenamark); // release all scratch space of the open op
+   stats_record(STATS_DS_OPENOBJ, statstart, 0, (retval != 0));
+   return retval;
+}
+
+/**
+ * Discard the local cache copy of the current object of the given READ DATASTREAM, ensuring
+ * that the next open of that object will target the data object itself
+ * @param DATASTREAM stream : Current DATASTREAM
+ */
+static void discard_cached_obj(DATASTREAM stream) {
+   const marfs_ds* ds = &(stream->ns->prepo->datascheme);
+   abort_current_obj(stream);
+   DATASTREAM_ARENA_MARK arenamark = arena_mark(&(stream->arena));
+   FTAG tgttag = stream->files[stream->curfile].ftag;
+   tgttag.objno = stream->objno;
+   char* objname = NULL;
+   ne_erasure erasure;
+   ne_location location;
+   if (objtarget(&(tgttag), ds, &(objname), &(erasure), &(location), &(stream->arena)) ||
+       datacache_invalidate(ds->cache, objname)) {
+      LOG(LOG_WARNING, "Failed to invalidate cached copy of object %zu\n", stream->objno);
+   }
+   arena_release(&(stream->arena), arenamark);
+}
+
 /**
  * Close the current DATASTERAM object reference, potentially populating a rebuild string
  * @param DATASTREAM stream : Current DATASTREAM
@@ -1159,7 +1701,25 @@ int open_current_obj(DATASTREAM stream) {
  *                             ( to avoid generating a new one for rebuild marker creation )
  * @return int : Zero on success, or -1 on failure
  */
-int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
+static int untimed_close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
+   if (stream->comphandle) {
+      // output any buffered content, prior to closing the object itself
+      int compres = compress_close(stream->comphandle);
+      stream->comphandle = NULL;
+      if (compres) {
+         LOG(LOG_ERR, "Failed to output compressed content of object %zu\n", curftag->objno);
+         abort_current_obj(stream);
+         return -1;
+      }
+   }
+   if (stream->cachefd >= 0) {
+      // a local cache copy carries no erasure state to be checked
+      if (close(stream->cachefd)) {
+         LOG(LOG_WARNING, "Failed to close cached copy of object %zu\n", curftag->objno);
+      }
+      stream->cachefd = -1;
+      return 0;
+   }
    ne_state objstate = {
       .versz = 0,
       .blocksz = 0,
@@ -1169,18 +1729,14 @@ int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
       .csum = NULL };
    MDAL mdal = stream->ns->prepo->metascheme.mdal;
    size_t stripewidth = curftag->protection.N + curftag->protection.E;
-   objstate.data_status = calloc(sizeof(char), stripewidth);
-   objstate.meta_status = calloc(sizeof(char), stripewidth);
+   objstate.data_status = arena_alloc(&(stream->arena), sizeof(char) * stripewidth);
+   objstate.meta_status = arena_alloc(&(stream->arena), sizeof(char) * stripewidth);
    if (objstate.data_status == NULL || objstate.meta_status == NULL) {
       LOG(LOG_ERR, "Failed to allocate data object status arrays\n");
-      if (objstate.data_status) {
-         free(objstate.data_status);
-      }
-      if (objstate.meta_status) {
-         free(objstate.meta_status);
-      }
       return -1;
    }
+   bzero(objstate.data_status, sizeof(char) * stripewidth);
+   bzero(objstate.meta_status, sizeof(char) * stripewidth);
    int closeres = 0;
    if (stream->datahandle != NULL) {
       closeres = ne_close(stream->datahandle, NULL, &(objstate));
@@ -1193,26 +1749,16 @@ int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
       size_t rtagstrlen = rtag_tostr(&(objstate), stripewidth, NULL, 0);
       if (rtagstrlen == 0) {
          LOG(LOG_ERR, "Failed to identify rebuild tag length\n");
-         free(objstate.data_status);
-         free(objstate.meta_status);
          return -1;
       }
-      if ((rtagstr = (char*)malloc(sizeof(char) * (rtagstrlen + 1))) == NULL) {
+      if ((rtagstr = (char*)arena_alloc(&(stream->arena), sizeof(char) * (rtagstrlen + 1))) == NULL) {
          LOG(LOG_ERR, "Failed to allocate space for rebuild tag string\n");
-         free(objstate.data_status);
-         free(objstate.meta_status);
          return -1;
       }
       if (rtag_tostr(&(objstate), stripewidth, rtagstr, rtagstrlen + 1) != rtagstrlen) {
          LOG(LOG_ERR, "Rebuild tag has inconsistent length\n");
-         free(objstate.data_status);
-         free(objstate.meta_status);
-         free(rtagstr);
          return -1;
       }
-      // object state has been encoded into our rtag string
-      free(objstate.data_status);
-      free(objstate.meta_status);
 
       // identify the appropraite rebuild marker name
       char* rmarkstr = NULL;
@@ -1220,19 +1766,15 @@ int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
       if (rmarkstrlen < 1) {
          LOG(LOG_ERR, "Failed to identify rebuild marker path of file %zu\n",
             curftag->fileno);
-         free(rtagstr);
          return -1;
       }
-      if ((rmarkstr = (char*)malloc(sizeof(char) * (rmarkstrlen + 1))) == NULL) {
+      if ((rmarkstr = (char*)arena_alloc(&(stream->arena), sizeof(char) * (rmarkstrlen + 1))) == NULL) {
          LOG(LOG_ERR, "Failed to allocate rebuild marker string of length %zu\n",
             rmarkstrlen + 1);
-         free(rtagstr);
          return -1;
       }
       if (ftag_rebuildmarker(curftag, rmarkstr, rmarkstrlen + 1) != rmarkstrlen) {
          LOG(LOG_ERR, "Rebuild marker string has an inconsistent length\n");
-         free(rmarkstr);
-         free(rtagstr);
          return -1;
       }
 
@@ -1243,34 +1785,24 @@ int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
       if (hash_lookup(stream->ns->prepo->metascheme.reftable, rmarkstr, &(noderef)) < 0) {
          LOG(LOG_ERR, "Failed to identify reference path for rebuild marker \"%s\"\n",
             rmarkstr);
-         free(rmarkstr);
-         free(rtagstr);
          return -1;
       }
       rpathlen = strlen(noderef->name) + rmarkstrlen;
-      rpath = malloc(sizeof(char) * (rpathlen + 1));
+      rpath = arena_alloc(&(stream->arena), sizeof(char) * (rpathlen + 1));
       if (rpath == NULL) {
          LOG(LOG_ERR, "Failed to allocate rebuild marker reference string\n");
-         free(rmarkstr);
-         free(rtagstr);
          return -1;
       }
       if (snprintf(rpath, rpathlen + 1, "%s%s", noderef->name, rmarkstr) != rpathlen) {
          LOG(LOG_ERR, "Failed to populate rebuild marker reference path\n");
-         free(rpath);
-         free(rmarkstr);
-         free(rtagstr);
          errno = EFAULT;
          return -1;
       }
-      free(rmarkstr);
 
       // identify the rpath of the problem file
-      char* filerpath = datastream_genrpath( curftag, stream->ns->prepo->metascheme.reftable );
+      char* filerpath = genrpath( curftag, stream->ns->prepo->metascheme.reftable, &(stream->arena) );
       if ( filerpath == NULL ) {
          LOG( LOG_ERR, "Failed to identify the rpath of the problem file\n" );
-         free( rpath );
-         free(rtagstr);
          errno = EFAULT;
          return -1;
       }
@@ -1283,9 +1815,6 @@ int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
          char* nspath = NULL;
          if (config_nsinfo(stream->ns->idstr, NULL, &(nspath))) {
             LOG(LOG_ERR, "Failed to identify path of NS: \"%s\"\n", stream->ns->idstr);
-            free(filerpath);
-            free(rpath);
-            free(rtagstr);
             return -1;
          }
          mdalctxt = mdal->newctxt(nspath, stream->ns->prepo->metascheme.mdal->ctxt);
@@ -1293,9 +1822,6 @@ int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
          if (mdalctxt == NULL) {
             LOG(LOG_ERR, "Failed to create new MDAL_CTXT for NS: \"%s\"\n",
                stream->ns->idstr);
-            free(filerpath);
-            free(rpath);
-            free(rtagstr);
             return -1;
          }
       }
@@ -1308,9 +1834,6 @@ int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
          }
          else {
             LOG( LOG_ERR, "Failed to link problem file ( \"%s\" ) to rebuild marker location ( \"%s\" )\n", filerpath, rpath );
-            free(filerpath);
-            free(rpath);
-            free(rtagstr);
             if (releasectxt) {
                mdal->destroyctxt(mdalctxt);
             }
@@ -1318,26 +1841,21 @@ int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
          }
       }
       errno = olderrno;
-      free(filerpath);
       MDAL_FHANDLE rhandle = mdal->openref(mdalctxt, rpath, O_WRONLY, 0);
       if (rhandle == NULL) {
          LOG(LOG_ERR, "Failed to open handle for rebuild marker: \"%s\"\n", rpath);
-         free(rpath);
-         free(rtagstr);
          if (releasectxt) {
             mdal->destroyctxt(mdalctxt);
          }
          return -1;
       }
       LOG(LOG_INFO, "Opened rebuild marker: \"%s\"\n", rpath);
-      free(rpath);
 
       // identify the rebuild tag name
       char* rtagname = rtag_getname( curftag->objno );
       if ( rtagname == NULL ) {
          LOG( LOG_ERR, "Failed to identify RTAG name for object %zu\n", curftag->objno );
          mdal->close(rhandle);
-         free(rtagstr);
          if (releasectxt) {
             mdal->destroyctxt(mdalctxt);
          }
@@ -1352,7 +1870,6 @@ int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
          LOG(LOG_INFO, "Attached RTAG: %s=\"%s\"\n", rtagname, rtagstr);
       }
       free(rtagname);
-      free(rtagstr);
 
       // close the rebuild marker
       if (mdal->close(rhandle)) {
@@ -1365,8 +1882,6 @@ int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
       errno = olderrno;
    }
    else {
-      free(objstate.data_status);
-      free(objstate.meta_status);
       if (closeres < 0) {
          LOG(LOG_ERR, "ne_close() indicates failure for object %zu\n", curftag->objno);
          return -1;
@@ -1379,6 +1894,116 @@ int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
    return 0;
 }
 
+/**
+ * Timed wrapper for untimed_close_current_obj() ( see above )
+ * NOTE -- all arena space allocated by the close is released here
+ */
+int close_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
+   uint64_t statstart = stats_start();
+   DATASTREAM_ARENA_MARK arenamark = arena_mark(&(stream->arena));
+   int retval = untimed_close_current_obj(stream, curftag, mdalctxt);
+   arena_release(&(stream->arena), arenamark); // release all scratch space of the close op
+   stats_record(STATS_DS_CLOSEOBJ, statstart, 0, (retval != 0));
+   return retval;
+}
+
+/**
+ * Move the current data object handle of the given READ DATASTREAM into the stream's
+ * object handle cache, closing the least recently used cached handle if no slot is free
+ * NOTE -- if the stream has no object handle cache, this is equivalent to close_current_obj()
+ * @param DATASTREAM stream : Current DATASTREAM
+ * @param FTAG* curftag : Reference to the FTAG value associated with the current object
+ * @param MDAL_CTXT mdalctxt : Optional reference to an MDAL_CTXT for the current NS
+ *                             ( to avoid generating a new one for rebuild marker creation )
+ * @return int : Zero on success, or -1 on failure
+ */
+int park_current_obj(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
+   if (stream->objcachesize == 0 || stream->datahandle == NULL) {
+      return close_current_obj(stream, curftag, mdalctxt);
+   }
+   // identify a free slot or, failing that, the least recently used one
+   DATASTREAM_CACHEDOBJ* slot = stream->objcache;
+   size_t index = 0;
+   for (; index < stream->objcachesize; index++) {
+      DATASTREAM_CACHEDOBJ* cached = stream->objcache + index;
+      if (cached->handle == NULL) {
+         slot = cached;
+         break;
+      }
+      if (cached->lastuse < slot->lastuse) {
+         slot = cached;
+      }
+   }
+   if (slot->handle) {
+      // close the evicted handle in place of the current one
+      LOG(LOG_INFO, "Evicting cached handle for object %zu\n", slot->objno);
+      ne_handle parkhandle = stream->datahandle;
+      COMPRESS_HANDLE parkcomphandle = stream->comphandle;
+      FTAG evictftag = *curftag;
+      evictftag.objno = slot->objno;
+      stream->datahandle = slot->handle;
+      stream->comphandle = slot->comphandle;
+      slot->handle = NULL;
+      slot->comphandle = NULL;
+      int closeres = close_current_obj(stream, &(evictftag), mdalctxt);
+      stream->datahandle = parkhandle;
+      stream->comphandle = parkcomphandle;
+      if (closeres) {
+         LOG(LOG_ERR, "Failed to close evicted handle for object %zu\n", evictftag.objno);
+         return -1;
+      }
+   }
+   LOG(LOG_INFO, "Caching handle for object %zu\n", curftag->objno);
+   slot->handle = stream->datahandle;
+   slot->comphandle = stream->comphandle;
+   slot->objno = curftag->objno;
+   slot->lastuse = ++(stream->objcacheuses);
+   stream->datahandle = NULL;
+   stream->comphandle = NULL;
+   return 0;
+}
+
+/**
+ * Close all cached data object handles of the given READ DATASTREAM
+ * NOTE -- cached handles are only ever associated with the current stream file, so this
+ *         must be called prior to moving the stream to a new file
+ * @param DATASTREAM stream : Current DATASTREAM
+ * @param FTAG* curftag : Reference to the FTAG value of the current stream file
+ * @param MDAL_CTXT mdalctxt : Optional reference to an MDAL_CTXT for the current NS
+ *                             ( to avoid generating a new one for rebuild marker creation )
+ * @return int : Zero on success, or -1 if any handle failed to close
+ */
+int flush_cached_objs(DATASTREAM stream, FTAG* curftag, MDAL_CTXT mdalctxt) {
+   int retval = 0;
+   // hide the current object reference, so that only the cached handles are closed
+   ne_handle curhandle = stream->datahandle;
+   int curcachefd = stream->cachefd;
+   COMPRESS_HANDLE curcomphandle = stream->comphandle;
+   stream->cachefd = -1;
+   stream->comphandle = NULL;
+   size_t index = 0;
+   for (; index < stream->objcachesize; index++) {
+      DATASTREAM_CACHEDOBJ* cached = stream->objcache + index;
+      if (cached->handle == NULL) {
+         continue;
+      }
+      FTAG cachedftag = *curftag;
+      cachedftag.objno = cached->objno;
+      stream->datahandle = cached->handle;
+      stream->comphandle = cached->comphandle;
+      cached->handle = NULL;
+      cached->comphandle = NULL;
+      if (close_current_obj(stream, &(cachedftag), mdalctxt)) {
+         LOG(LOG_ERR, "Failed to close cached handle for object %zu\n", cached->objno);
+         retval = -1;
+      }
+   }
+   stream->datahandle = curhandle;
+   stream->cachefd = curcachefd;
+   stream->comphandle = curcomphandle;
+   return retval;
+}
+
 /**
  * Generate a new DATASTREAM of the given type and the given initial target file
  * @param STREAM_TYPE type : Type of the DATASTREAM to be created
@@ -1420,6 +2045,11 @@ DATASTREAM genstream(STREAM_TYPE type, const char* path, char rpathflag, marfs_p
    stream->offset = 0; // redefined below
    stream->excessoffset = 0;
    stream->datahandle = NULL;
+   stream->cachefd = -1;
+   stream->comphandle = NULL;
+   stream->objcache = NULL; // redefined below
+   stream->objcachesize = 0;
+   stream->objcacheuses = 0;
    stream->files = NULL; // redefined below
    stream->curfile = 0;
    stream->filealloc = 0; // redefined below
@@ -1427,6 +2057,12 @@ DATASTREAM genstream(STREAM_TYPE type, const char* path, char rpathflag, marfs_p
    stream->ftagstrsize = 512;
    stream->finfostr = malloc(sizeof(char) * 512);
    stream->finfostrlen = 512;
+   stream->arena.block = NULL; // allocated on first use
+   stream->arena.size = 0;
+   stream->arena.used = 0;
+   stream->arena.demand = 0;
+   stream->arena.peak = 0;
+   stream->arena.overflow = NULL;
    // zero out all recovery finfo values; those will be populated later, if needed
    stream->finfo.inode = 0;
    stream->finfo.mode = 0;
@@ -1443,6 +2079,16 @@ DATASTREAM genstream(STREAM_TYPE type, const char* path, char rpathflag, marfs_p
       freestream(stream);
       return NULL;
    }
+   // READ streams may hold onto a number of idle object handles
+   if (type == READ_STREAM && ds->readcache) {
+      stream->objcache = calloc(ds->readcache, sizeof(DATASTREAM_CACHEDOBJ));
+      if (stream->objcache == NULL) {
+         LOG(LOG_ERR, "Failed to allocate space for a %zu entry object handle cache\n", ds->readcache);
+         freestream(stream);
+         return NULL;
+      }
+      stream->objcachesize = ds->readcache;
+   }
 
    // allocate our first file reference(s)
    if (type == READ_STREAM || type == EDIT_STREAM) {
@@ -1468,6 +2114,7 @@ DATASTREAM genstream(STREAM_TYPE type, const char* path, char rpathflag, marfs_p
    curfile->ftag.streamid = stream->streamid;
    curfile->ftag.objfiles = ds->objfiles;
    curfile->ftag.objsize = ds->objsize;
+   curfile->ftag.compression = ds->compression;
    curfile->ftag.refbreadth = ms->refbreadth;
    curfile->ftag.refdepth = ms->refdepth;
    curfile->ftag.refdigits = ms->refdigits;
@@ -1717,7 +2364,7 @@ int putfinfo(DATASTREAM stream) {
    if ( stream->type == REPACK_STREAM ) { stream->finfo.size = origfinfosize; } // restore this value for repack
    // Note -- previous writes should have ensured we have at least 'recoverybytes' of
    //         available spaece to write out the recovery string
-   if (ne_write(stream->datahandle, stream->finfostr, recoverybytes) != recoverybytes) {
+   if (write_current_obj(stream, stream->finfostr, recoverybytes) != recoverybytes) {
       LOG(LOG_ERR, "Failed to store file recovery info to data object\n");
       return -1;
    }
@@ -1996,46 +2643,7 @@ int completefile(DATASTREAM stream, STREAMFILE* file) {
  *                 NOTE -- returned path must be freed by caller
  */
 char* datastream_genrpath(FTAG* ftag, HASH_TABLE reftable) {
-   // generate the meta reference name of this file
-   size_t rnamelen = ftag_metatgt(ftag, NULL, 0);
-   if (rnamelen < 1) {
-      LOG(LOG_ERR, "Failed to generate file meta reference name\n");
-      return NULL;
-   }
-   char* refname = malloc(sizeof(char) * (rnamelen + 1));
-   if (refname == NULL) {
-      LOG(LOG_ERR, "Failed to allocate a temporary meta reference string\n");
-      return NULL;
-   }
-   if (ftag_metatgt(ftag, refname, rnamelen + 1) != rnamelen) {
-      LOG(LOG_ERR, "Inconsistent length of file meta reference string\n");
-      free(refname);
-      return NULL;
-   }
-   // determine the target reference path of this file
-   HASH_NODE* noderef = NULL;
-   if (hash_lookup(reftable, refname, &(noderef)) < 0) {
-      LOG(LOG_ERR, "Failed to identify reference path for metaname \"%s\"\n", refname);
-      free(refname);
-      return NULL;
-   }
-   // populate the complete rpath
-   size_t rpathlen = strlen(noderef->name) + strlen(refname);
-   char* rpath = malloc(sizeof(char) * (rpathlen + 1));
-   if (rpath == NULL) {
-      LOG(LOG_ERR, "Failed to allocate rpath string\n");
-      free(refname);
-      return NULL;
-   }
-   if (snprintf(rpath, rpathlen + 1, "%s%s", noderef->name, refname) != rpathlen) {
-      LOG(LOG_ERR, "Failed to populate rpath string\n");
-      free(refname);
-      free(rpath);
-      errno = EFAULT;
-      return NULL;
-   }
-   free(refname); // done with this tmp string
-   return rpath;
+   return genrpath(ftag, reftable, NULL);
 }
 
 /**
@@ -2050,103 +2658,7 @@ char* datastream_genrpath(FTAG* ftag, HASH_TABLE reftable) {
  * @return int : Zero on success, or -1 on failure
  */
 int datastream_objtarget(FTAG* ftag, const marfs_ds* ds, char** objectname, ne_erasure* erasure, ne_location* location) {
-   // check for invalid args
-   if (ftag == NULL) {
-      LOG(LOG_ERR, "Received a NULL FTAG reference\n");
-      errno = EINVAL;
-      return -1;
-   }
-   if (ds == NULL) {
-      LOG(LOG_ERR, "Received a NULL marfs_ds reference\n");
-      errno = EINVAL;
-      return -1;
-   }
-   if (objectname == NULL) {
-      LOG(LOG_ERR, "Received a NULL objname reference\n");
-      errno = EINVAL;
-      return -1;
-   }
-   if (erasure == NULL) {
-      LOG(LOG_ERR, "Received a NULL ne_erasure reference\n");
-      errno = EINVAL;
-      return -1;
-   }
-   if (location == NULL) {
-      LOG(LOG_ERR, "Received a NULL ne_location reference\n");
-      errno = EINVAL;
-      return -1;
-   }
-   // find the length of the current object name
-   ssize_t objnamelen = ftag_datatgt(ftag, NULL, 0);
-   if (objnamelen <= 0) {
-      LOG(LOG_ERR, "Failed to determine object path from current ftag\n");
-      return -1;
-   }
-   // allocate a new string, and populate it with the object name
-   char* objname = malloc(sizeof(char) * (objnamelen + 1));
-   if (objname == NULL) {
-      LOG(LOG_ERR, "Failed to allocate space for new object name\n");
-      return -1;
-   }
-   if (objnamelen != ftag_datatgt(ftag, objname, objnamelen + 1)) {
-      LOG(LOG_ERR, "Ftag producing inconsistent object name string\n");
-      free(objname);
-      return -1;
-   }
-
-   // identify the pod/cap/scatter values for the current object
-   ne_location tmplocation = { .pod = -1, .cap = -1, .scatter = -1 };
-   int iteration = 0;
-   for (; iteration < 3; iteration++) {
-      // determine which table we are currently pulling from
-      HASH_TABLE curtable = ds->scattertable;
-      int* tgtval = &(tmplocation.scatter);
-      if (iteration < 1) {
-         curtable = ds->podtable;
-         tgtval = &(tmplocation.pod);
-      }
-      else if (iteration < 2) {
-         curtable = ds->captable;
-         tgtval = &(tmplocation.cap);
-      }
-      // hash our object name, to identify a target node
-      HASH_NODE* node = NULL;
-      if (hash_lookup(curtable, objname, &node) < 0) {
-         LOG(LOG_ERR, "Failed to lookup %s location for new object \"%s\"\n",
-            (iteration < 1) ? "pod" : (iteration < 2) ? "cap" : "scatter",
-            objname);
-         free(objname);
-         return -1;
-      }
-      // parse our nodename, to produce an integer value
-      char* endptr = NULL;
-      unsigned long long parseval = strtoull(node->name, &(endptr), 10);
-      if (*endptr != '\0' || parseval >= INT_MAX) {
-         LOG(LOG_ERR, "Failed to parse %s value of \"%s\" for new object \"%s\"\n",
-            (iteration < 1) ? "pod" : (iteration < 2) ? "cap" : "scatter",
-            node->name, objname);
-         free(objname);
-         return -1;
-      }
-      // assign the parsed value to the appropriate var
-      *tgtval = (int)parseval;
-   }
-
-   // identify the erasure scheme
-   ne_erasure tmperasure = ftag->protection;
-   tmperasure.O = (int)(hash_rangevalue(objname, tmperasure.N + tmperasure.E)); // produce tmperasure offset value
-   LOG(LOG_INFO, "Object: \"%s\"\n", objname);
-   LOG(LOG_INFO, "Position: pod%d, cap%d, scatter%d\n",
-      tmplocation.pod, tmplocation.cap, tmplocation.scatter);
-   LOG(LOG_INFO, "Erasure: N=%d,E=%d,O=%d,psz=%zu\n",
-      tmperasure.N, tmperasure.E, tmperasure.O, tmperasure.partsz);
-
-   // populate all return structs
-   *objectname = objname;
-   *erasure = tmperasure;
-   *location = tmplocation;
-
-   return 0;
+   return objtarget(ftag, ds, objectname, erasure, location, NULL);
 }
 
 /**
@@ -2388,6 +2900,17 @@ int datastream_open(DATASTREAM* stream, STREAM_TYPE type, const char* path, marf
             return -1;
          }
          STREAMFILE* newfile = newstream->files + newstream->curfile;
+         // cached handles are specific to the old file, so close them out
+         FTAG cacheftag = curfile->ftag;
+         if (flush_cached_objs(newstream, &(cacheftag), pos->ctxt)) {
+            LOG(LOG_ERR, "Failed to close cached data handles of old stream file\n");
+            free(curfile->ftag.ctag);
+            free(curfile->ftag.streamid);
+            freestream(newstream);
+            *stream = NULL;
+            errno = EBADFD;
+            return -1;
+         }
          // check if our old stream targets the same object
          if (strcmp(curfile->ftag.streamid, newfile->ftag.streamid) ||
             strcmp(curfile->ftag.ctag, newfile->ftag.ctag) ||
@@ -2410,10 +2933,12 @@ int datastream_open(DATASTREAM* stream, STREAM_TYPE type, const char* path, marf
                return -1;
             }
          }
-         else {
+         else if (newstream->datahandle || newstream->cachefd >= 0) {
+            // NOTE -- if the object was never opened ( e.g. only zero-length files were read ),
+            //         it will simply be opened at the new offset by the next read
             LOG(LOG_INFO, "Seeking to %zu of existing object handle\n",
                newfile->ftag.offset);
-            if (ne_seek(newstream->datahandle, newfile->ftag.offset) != newfile->ftag.offset) {
+            if (seek_current_obj(newstream, newfile->ftag.offset) != newfile->ftag.offset) {
                LOG(LOG_ERR, "Failed to seek to %zu of existing object handle\n",
                   newfile->ftag.offset);
                free(curfile->ftag.ctag);
@@ -2535,6 +3060,17 @@ int datastream_scan(DATASTREAM* stream, const char* refpath, marfs_position* pos
             return -1;
          }
          STREAMFILE* newfile = newstream->files + newstream->curfile;
+         // cached handles are specific to the old file, so close them out
+         FTAG cacheftag = curfile->ftag;
+         if (flush_cached_objs(newstream, &(cacheftag), pos->ctxt)) {
+            LOG(LOG_ERR, "Failed to close cached data handles of old stream file\n");
+            free(curfile->ftag.ctag);
+            free(curfile->ftag.streamid);
+            freestream(newstream);
+            *stream = NULL;
+            errno = EBADFD;
+            return -1;
+         }
          // check if our old stream targets the same object
          if (strcmp(curfile->ftag.streamid, newfile->ftag.streamid) ||
             strcmp(curfile->ftag.ctag, newfile->ftag.ctag) ||
@@ -2557,10 +3093,12 @@ int datastream_scan(DATASTREAM* stream, const char* refpath, marfs_position* pos
                return -1;
             }
          }
-         else {
+         else if (newstream->datahandle || newstream->cachefd >= 0) {
+            // NOTE -- if the object was never opened ( e.g. only zero-length files were read ),
+            //         it will simply be opened at the new offset by the next read
             LOG(LOG_INFO, "Seeking to %zu of existing object handle\n",
                newfile->ftag.offset);
-            if (ne_seek(newstream->datahandle, newfile->ftag.offset) != newfile->ftag.offset) {
+            if (seek_current_obj(newstream, newfile->ftag.offset) != newfile->ftag.offset) {
                LOG(LOG_ERR, "Failed to seek to %zu of existing object handle\n",
                   newfile->ftag.offset);
                free(curfile->ftag.ctag);
@@ -3119,7 +3657,11 @@ int datastream_release(DATASTREAM* stream) {
    FTAG curftag = curfile->ftag;
    curftag.objno = tgtstream->objno;
    curftag.offset = tgtstream->offset;
-   if (close_current_obj(tgtstream, &(curftag), NULL)) {
+   if (flush_cached_objs(tgtstream, &(curftag), NULL)) {
+      LOG(LOG_ERR, "Close failure for cached object handles\n");
+      abortflag = 1;
+   }
+   else if (close_current_obj(tgtstream, &(curftag), NULL)) {
       LOG(LOG_ERR, "Close failure for object %zu\n", tgtstream->objno);
       abortflag = 1;
    }
@@ -3213,7 +3755,8 @@ int datastream_close(DATASTREAM* stream) {
    FTAG curftag = curfile->ftag;
    curftag.objno = tgtstream->objno;
    curftag.offset = tgtstream->offset;
-   if (close_current_obj(tgtstream, &(curftag), NULL)) {
+   if (flush_cached_objs(tgtstream, &(curftag), NULL) ||
+      close_current_obj(tgtstream, &(curftag), NULL)) {
       LOG(LOG_ERR, "Failure during close of object %zu\n", tgtstream->objno);
       freestream(tgtstream);
       *stream = NULL; // unsafe to reuse this stream
@@ -3323,11 +3866,11 @@ ssize_t datastream_read(DATASTREAM* stream, void* buf, size_t count) {
       // calculate how much data we can read from the current data object
       size_t toread = streampos.dataperobj - (tgtstream->offset - tgtstream->recoveryheaderlen);
       if (toread == 0) {
-         // close the previous data handle
+         // close ( or cache ) the previous data handle
          FTAG curftag = curfile->ftag;
          curftag.objno = tgtstream->objno;
          curftag.offset = tgtstream->offset;
-         if (close_current_obj(tgtstream, &(curftag), NULL)) {
+         if (park_current_obj(tgtstream, &(curftag), NULL)) {
             // NOTE -- this doesn't necessarily have to be a fatal error on read.
             //         However, I really don't want us to ignore this sort of thing,
             //         as it could indicate imminent data loss ( corrupt object which
@@ -3351,7 +3894,7 @@ ssize_t datastream_read(DATASTREAM* stream, void* buf, size_t count) {
          toread = count;
       }
       // open the current data object, if necessary
-      if (tgtstream->datahandle == NULL) {
+      if (tgtstream->datahandle == NULL && tgtstream->cachefd < 0) {
          LOG(LOG_INFO, "Opening object %zu\n", tgtstream->objno);
          if (open_current_obj(tgtstream)) {
             LOG(LOG_ERR, "Failed to open data object %zu\n", tgtstream->objno);
@@ -3360,7 +3903,14 @@ ssize_t datastream_read(DATASTREAM* stream, void* buf, size_t count) {
       }
       // perform the actual read op
       LOG(LOG_INFO, "Reading %zu bytes from object %zu\n", toread, tgtstream->objno);
-      ssize_t readres = ne_read(tgtstream->datahandle, buf, toread);
+      ssize_t readres = read_current_obj(tgtstream, buf, toread);
+      if (readres <= 0 && tgtstream->cachefd >= 0) {
+         // never fail a read due to a bad cache copy, just fall back to the object itself
+         LOG(LOG_WARNING, "Read failure in cached copy of object %zu at offset %zu ( res = %zd )\n",
+            tgtstream->objno, tgtstream->offset, readres);
+         discard_cached_obj(tgtstream);
+         continue;
+      }
       if (readres <= 0) {
          LOG(LOG_ERR, "Read failure in object %zu at offset %zu ( res = %zd )\n",
             tgtstream->objno, tgtstream->offset, readres);
@@ -3384,6 +3934,326 @@ ssize_t datastream_read(DATASTREAM* stream, void* buf, size_t count) {
    return readbytes;
 }
 
+/**
+ * Read from the raw data object referenced by the given DATASTREAM_PREAD
+ * NOTE -- this ignores any compression of the object ( used as a COMPRESS_IO function )
+ * @param void* arg : Current DATASTREAM_PREAD
+ * @param void* buf : Buffer to be populated
+ * @param size_t count : Number of bytes to be read
+ * @return ssize_t : Number of bytes read, or -1 on failure
+ */
+static ssize_t rawread_pread_obj(void* arg, void* buf, size_t count) {
+   DATASTREAM_PREAD req = (DATASTREAM_PREAD)arg;
+   if (req->cachefd < 0) {
+      return ne_read(req->datahandle, buf, count);
+   }
+   // unlike ne_read(), local reads may return short, so fill as much of the buffer as possible
+   size_t readbytes = 0;
+   while (readbytes < count) {
+      ssize_t readres = read(req->cachefd, (char*)buf + readbytes, count - readbytes);
+      if (readres < 0) {
+         return -1;
+      }
+      if (readres == 0) {
+         break;
+      }
+      readbytes += readres;
+   }
+   return readbytes;
+}
+
+/**
+ * Seek the raw data object referenced by the given DATASTREAM_PREAD
+ * NOTE -- this ignores any compression of the object ( used as a COMPRESS_IO function )
+ * @param void* arg : Current DATASTREAM_PREAD
+ * @param off_t offset : Target offset within the raw data object
+ * @return off_t : Resulting offset, or -1 on failure
+ */
+static off_t rawseek_pread_obj(void* arg, off_t offset) {
+   DATASTREAM_PREAD req = (DATASTREAM_PREAD)arg;
+   if (req->cachefd >= 0) {
+      return lseek(req->cachefd, offset, SEEK_SET);
+   }
+   return ne_seek(req->datahandle, offset);
+}
+
+/**
+ * Seek the raw data object referenced by the given DATASTREAM_PREAD to the given offset
+ * within its compressed frames ( used as a COMPRESS_IO function )
+ * NOTE -- frames begin immediately following the uncompressed recovery header
+ * @param void* arg : Current DATASTREAM_PREAD
+ * @param off_t offset : Target physical offset, relative to the first frame
+ * @return off_t : Resulting offset, or -1 on failure
+ */
+static off_t rawseekframes_pread_obj(void* arg, off_t offset) {
+   DATASTREAM_PREAD req = (DATASTREAM_PREAD)arg;
+   off_t seekres = rawseek_pread_obj(arg, offset + req->recoveryheaderlen);
+   if (seekres < 0) {
+      return -1;
+   }
+   return seekres - req->recoveryheaderlen;
+}
+
+/**
+ * Close any data object handles of the given DATASTREAM_PREAD
+ * NOTE -- Unlike close_current_obj(), no rebuild marker is generated for an object which
+ *         is found to be damaged.  Such objects are left for the resource manager to find.
+ * @param DATASTREAM_PREAD req : Current DATASTREAM_PREAD
+ */
+static void close_pread_obj(DATASTREAM_PREAD req) {
+   if (req->comphandle) {
+      compress_abort(req->comphandle);
+      req->comphandle = NULL;
+   }
+   if (req->cachefd >= 0) {
+      close(req->cachefd);
+      req->cachefd = -1;
+   }
+   if (req->datahandle) {
+      int closeres = ne_close(req->datahandle, NULL, NULL);
+      if (closeres > 0) {
+         LOG(LOG_WARNING, "Object %zu of stream \"%s\" was read with errors\n", req->ftag.objno, req->ftag.streamid);
+      }
+      else if (closeres < 0) {
+         LOG(LOG_WARNING, "Failed to close object %zu of stream \"%s\"\n", req->ftag.objno, req->ftag.streamid);
+      }
+      req->datahandle = NULL;
+   }
+}
+
+/**
+ * Open the data object referenced by the given DATASTREAM_PREAD, at its current FTAG offset
+ * @param DATASTREAM_PREAD req : Current DATASTREAM_PREAD
+ * @param char usecache : If non-zero, a local cache copy of the object may be opened instead
+ * @return int : Zero on success, or -1 on failure
+ */
+static int open_pread_obj(DATASTREAM_PREAD req, char usecache) {
+   char* objname = NULL;
+   ne_erasure erasure;
+   ne_location location;
+   if (objtarget(&(req->ftag), req->ds, &(objname), &(erasure), &(location), NULL)) {
+      LOG(LOG_ERR, "Failed to identify data object %zu\n", req->ftag.objno);
+      return -1;
+   }
+   if (usecache && req->ds->cache) {
+      req->cachefd = datacache_open(req->ds->cache, objname);
+   }
+   if (req->cachefd < 0) {
+      LOG(LOG_INFO, "Opening object for PREAD: \"%s\"\n", objname);
+      req->datahandle = ne_open(req->ds->nectxt, objname, location, erasure, NE_RDALL);
+      if (req->datahandle == NULL) {
+         LOG(LOG_ERR, "Failed to open object \"%s\"\n", objname);
+         free(objname);
+         return -1;
+      }
+   }
+   if (req->ftag.compression != FTAG_COMPRESS_NONE) {
+      COMPRESS_IO io =
+      {
+         .arg = req,
+         .read = rawread_pread_obj,
+         .write = NULL,
+         .seek = rawseekframes_pread_obj
+      };
+      req->comphandle = compress_open(req->ftag.compression, 0, 0, &(io));
+      if (req->comphandle == NULL) {
+         LOG(LOG_ERR, "Failed to initialize decompression of object \"%s\"\n", objname);
+         free(objname);
+         close_pread_obj(req);
+         return -1;
+      }
+   }
+   free(objname);
+   // the compressed content of the object only begins following the recovery header
+   off_t seekres = (req->comphandle) ? compress_seek(req->comphandle, req->ftag.offset - req->recoveryheaderlen) +
+                                          (off_t)req->recoveryheaderlen :
+                                       rawseek_pread_obj(req, req->ftag.offset);
+   if (seekres != req->ftag.offset) {
+      LOG(LOG_ERR, "Failed to seek to offset %zu of object %zu\n", req->ftag.offset, req->ftag.objno);
+      close_pread_obj(req);
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Free the given DATASTREAM_PREAD, without performing the read
+ * @param DATASTREAM_PREAD req : DATASTREAM_PREAD to be freed
+ */
+void datastream_preadfree(DATASTREAM_PREAD req) {
+   if (req == NULL) {
+      return;
+   }
+   close_pread_obj(req);
+   if (req->ftag.ctag) {
+      free(req->ftag.ctag);
+   }
+   if (req->ftag.streamid) {
+      free(req->ftag.streamid);
+   }
+   free(req);
+}
+
+/**
+ * Capture all info required to read the given range of the file currently referenced by
+ * the given READ DATASTREAM, such that the read may be performed independently of the stream
+ * NOTE -- The position of the stream is unaffected.  This call must be serialized with any
+ *         other ops against the same stream, but the resulting DATASTREAM_PREAD may then be
+ *         executed ( see datastream_pread() ) concurrently with any other op.
+ * @param DATASTREAM* stream : Reference to the READ DATASTREAM to be read from
+ * @param off_t offset : Offset of the read, relative to the start of the file
+ * @param size_t count : Number of bytes to be read
+ * @return DATASTREAM_PREAD : Reference to the new read request, or NULL on failure
+ */
+DATASTREAM_PREAD datastream_preadprep(DATASTREAM* stream, off_t offset, size_t count) {
+   // check for invalid args
+   if (stream == NULL || *stream == NULL) {
+      LOG(LOG_ERR, "Received a NULL stream reference\n");
+      errno = EINVAL;
+      return NULL;
+   }
+   DATASTREAM tgtstream = *stream;
+   if (tgtstream->type != READ_STREAM) {
+      LOG(LOG_ERR, "Provided stream does not support reading\n");
+      errno = EINVAL;
+      return NULL;
+   }
+   if (count > SSIZE_MAX) {
+      LOG(LOG_ERR, "Provided byte count exceeds max return value: %zu\n", count);
+      errno = EINVAL;
+      return NULL;
+   }
+   // identify the target position
+   STREAMFILE* curfile = tgtstream->files + tgtstream->curfile;
+   DATASTREAM_POSITION tgtpos = {
+      .totaloffset = 0,
+      .dataremaining = 0,
+      .excessremaining = 0,
+      .objno = 0,
+      .offset = 0,
+      .excessoffset = 0,
+      .dataperobj = 0
+   };
+   if (offset > (off_t)tgtstream->finfo.size) {
+      // as with pread(), a read beyond EOF simply produces no data
+      LOG(LOG_INFO, "Read offset %zd exceeds file size, reducing to %zu\n", offset, tgtstream->finfo.size);
+      offset = tgtstream->finfo.size;
+      count = 0;
+   }
+   if (gettargets(tgtstream, offset, SEEK_SET, &(tgtpos))) {
+      LOG(LOG_ERR, "Failed to identify position vals of file %zu\n", curfile->ftag.fileno);
+      return NULL;
+   }
+   DATASTREAM_PREAD req = calloc(1, sizeof(struct datastream_pread_struct));
+   if (req == NULL) {
+      LOG(LOG_ERR, "Failed to allocate a new DATASTREAM_PREAD\n");
+      return NULL;
+   }
+   req->ds = &(tgtstream->ns->prepo->datascheme);
+   req->recoveryheaderlen = tgtstream->recoveryheaderlen;
+   req->dataperobj = tgtpos.dataperobj;
+   req->datahandle = NULL;
+   req->cachefd = -1;
+   req->comphandle = NULL;
+   // duplicate the FTAG, so that the request outlives any change to the stream
+   req->ftag = curfile->ftag;
+   req->ftag.ctag = NULL;
+   req->ftag.streamid = NULL;
+   if ((req->ftag.ctag = strdup(curfile->ftag.ctag)) == NULL ||
+       (req->ftag.streamid = strdup(curfile->ftag.streamid)) == NULL) {
+      LOG(LOG_ERR, "Failed to duplicate FTAG strings of file %zu\n", curfile->ftag.fileno);
+      datastream_preadfree(req);
+      return NULL;
+   }
+   req->ftag.objno = tgtpos.objno;
+   req->ftag.offset = tgtpos.offset;
+   // reduce read request to account for file limits
+   if (count > tgtpos.dataremaining + tgtpos.excessremaining) {
+      count = tgtpos.dataremaining + tgtpos.excessremaining;
+      LOG(LOG_INFO, "Read request exceeds file bounds, resizing to %zu bytes\n", count);
+   }
+   if (count > tgtpos.dataremaining) {
+      req->zerotailbytes = count - tgtpos.dataremaining;
+      count = tgtpos.dataremaining;
+   }
+   req->count = count;
+   return req;
+}
+
+/**
+ * Perform the given positional read, via its own data object handles, and free the request
+ * NOTE -- Any number of these may safely execute concurrently, against the same or
+ *         different files ( see datastream_preadprep() ).
+ * @param DATASTREAM_PREAD req : Read request to be performed ( always freed by this call )
+ * @param void* buf : Reference to the buffer to be populated with read data
+ * @return ssize_t : Number of bytes read, or -1 on failure
+ */
+ssize_t datastream_pread(DATASTREAM_PREAD req, void* buf) {
+   if (req == NULL) {
+      LOG(LOG_ERR, "Received a NULL DATASTREAM_PREAD reference\n");
+      errno = EINVAL;
+      return -1;
+   }
+   // retrieve data until we no longer can
+   size_t readbytes = 0;
+   char usecache = 1;
+   while (req->count) {
+      // calculate how much data we can read from the current data object
+      size_t toread = req->dataperobj - (req->ftag.offset - req->recoveryheaderlen);
+      if (toread == 0) {
+         // progress to the next data object
+         close_pread_obj(req);
+         req->ftag.objno++;
+         req->ftag.offset = req->recoveryheaderlen;
+         toread = req->dataperobj;
+         usecache = 1;
+      }
+      if (toread > req->count) {
+         toread = req->count;
+      }
+      // open the current data object, if necessary
+      if (req->datahandle == NULL && req->cachefd < 0) {
+         if (open_pread_obj(req, usecache)) {
+            LOG(LOG_ERR, "Failed to open data object %zu\n", req->ftag.objno);
+            break;
+         }
+      }
+      ssize_t readres = (req->comphandle) ? compress_read(req->comphandle, buf, toread) :
+                                            rawread_pread_obj(req, buf, toread);
+      if (readres <= 0 && req->cachefd >= 0) {
+         // never fail a read due to a bad cache copy, just fall back to the object itself
+         LOG(LOG_WARNING, "Read failure in cached copy of object %zu at offset %zu ( res = %zd )\n",
+            req->ftag.objno, req->ftag.offset, readres);
+         close_pread_obj(req);
+         usecache = 0;
+         continue;
+      }
+      if (readres <= 0) {
+         LOG(LOG_ERR, "Read failure in object %zu at offset %zu ( res = %zd )\n",
+            req->ftag.objno, req->ftag.offset, readres);
+         break;
+      }
+      buf += readres;
+      req->count -= readres;
+      readbytes += readres;
+      req->ftag.offset += readres;
+   }
+   if (req->count) {
+      // a short read is only reported as such, if we managed to read anything at all
+      int olderrno = errno;
+      datastream_preadfree(req);
+      errno = olderrno;
+      return (readbytes) ? readbytes : -1;
+   }
+   // append zero bytes to account for file truncated beyond data length
+   if (req->zerotailbytes) {
+      bzero(buf, req->zerotailbytes);
+      readbytes += req->zerotailbytes;
+   }
+   datastream_preadfree(req);
+   return readbytes;
+}
+
 /**
  * Write to the file currently referenced by the given EDIT or CREATE DATASTREAM
  * @param DATASTREAM* stream : Reference to the DATASTREAM to be written to
@@ -3523,7 +4393,7 @@ ssize_t datastream_write(DATASTREAM* stream, const void* buf, size_t count) {
          }
       }
       // perform the actual write op
-      ssize_t writeres = ne_write(tgtstream->datahandle, buf, towrite);
+      ssize_t writeres = write_current_obj(tgtstream, buf, towrite);
       if (writeres <= 0) {
          LOG(LOG_ERR, "Write failure in object %zu at offset %zu\n",
             tgtstream->objno, tgtstream->offset);
@@ -3715,7 +4585,7 @@ off_t datastream_seek(DATASTREAM* stream, off_t offset, int whence) {
       return -1;
    }
    // check if we will be switching to a new data object and need to close the old handle
-   if (tgtstream->objno != streampos.objno && tgtstream->datahandle != NULL) {
+   if (tgtstream->objno != streampos.objno && (tgtstream->datahandle != NULL || tgtstream->cachefd >= 0)) {
       // check if we need to output recovery info to the current obj
       if (tgtstream->type == EDIT_STREAM) {
          // if we have a current data handle, need to output trailing recov info
@@ -3727,11 +4597,11 @@ off_t datastream_seek(DATASTREAM* stream, off_t offset, int whence) {
          }
          tgtstream->finfo.eof = 0; // unset the EOF flag, as it no longer applies
       }
-      // close any existing object handle
+      // close ( or, for READ streams, cache ) any existing object handle
       FTAG curftag = curfile->ftag;
       curftag.objno = tgtstream->objno;
       curftag.offset = tgtstream->offset;
-      if (close_current_obj(tgtstream, &(curftag), NULL)) {
+      if (park_current_obj(tgtstream, &(curftag), NULL)) {
          LOG(LOG_ERR, "Failed to close old stream data handle for object %zu\n", tgtstream->objno);
          freestream(tgtstream);
          *stream = NULL;
@@ -3740,8 +4610,8 @@ off_t datastream_seek(DATASTREAM* stream, off_t offset, int whence) {
       }
    }
    // if we have an open object, seek it to the appropriate offset
-   if (tgtstream->datahandle != NULL &&
-      ne_seek(tgtstream->datahandle, streampos.offset) != streampos.offset) {
+   if ((tgtstream->datahandle != NULL || tgtstream->cachefd >= 0) &&
+      seek_current_obj(tgtstream, streampos.offset) != streampos.offset) {
       LOG(LOG_ERR, "Failed to seek to offset %zu of object %zu\n",
          streampos.offset, streampos.objno);
       freestream(tgtstream);
@@ -4094,7 +4964,7 @@ int datastream_recoveryinfo(DATASTREAM* stream, RECOVERY_FINFO* recovinfo) {
    }
 
    // open the current data object, if necessary
-   if (tgtstream->datahandle == NULL) {
+   if (tgtstream->datahandle == NULL && tgtstream->cachefd < 0) {
       LOG(LOG_INFO, "Opening object %zu\n", tgtstream->objno);
       if (open_current_obj(tgtstream)) {
          LOG(LOG_ERR, "Failed to open data object %zu\n", tgtstream->objno);
@@ -4107,7 +4977,7 @@ int datastream_recoveryinfo(DATASTREAM* stream, RECOVERY_FINFO* recovinfo) {
    if (tgtoffset - tgtstream->recoveryheaderlen > streampos.dataperobj) {
       tgtoffset = tgtstream->recoveryheaderlen + streampos.dataperobj;
    }
-   off_t seekres = ne_seek(tgtstream->datahandle, tgtoffset);
+   off_t seekres = seek_current_obj(tgtstream, tgtoffset);
    if (seekres != tgtoffset) {
       LOG(LOG_ERR, "Failed to seek to offset %zu in object %zu\n",
          tgtoffset, tgtstream->objno);
@@ -4122,7 +4992,7 @@ int datastream_recoveryinfo(DATASTREAM* stream, RECOVERY_FINFO* recovinfo) {
 
    // read recovery info
    LOG(LOG_INFO, "Reading recovery info from object %zu\n", tgtstream->objno);
-   ssize_t readres = ne_read(tgtstream->datahandle, infobuf, curfile->ftag.recoverybytes);
+   ssize_t readres = read_current_obj(tgtstream, infobuf, curfile->ftag.recoverybytes);
    if (readres <= 0) {
       LOG(LOG_ERR, "Read failure in object %zu at offset %zu ( res = %zd )\n",
          tgtstream->objno, tgtstream->offset, readres);
@@ -4131,12 +5001,11 @@ int datastream_recoveryinfo(DATASTREAM* stream, RECOVERY_FINFO* recovinfo) {
    }
 
    // seek back to original position
-   seekres = ne_seek(tgtstream->datahandle, streampos.offset);
+   seekres = seek_current_obj(tgtstream, streampos.offset);
    if (seekres != streampos.offset) {
       LOG(LOG_ERR, "Failed to return seek to offset %zu in object %zu. Closing handle!\n",
          streampos.offset, tgtstream->objno);
-      ne_close(tgtstream->datahandle, NULL, NULL);
-      tgtstream->datahandle = NULL;
+      abort_current_obj(tgtstream);
    }
 
    // parse info string
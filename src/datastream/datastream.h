@@ -59,6 +59,7 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 */
 
 #include "config/config.h"
+#include "compress/compress.h"
 #include "recovery/recovery.h"
 #include "tagging/tagging.h"
 
@@ -76,6 +77,22 @@ typedef struct streamfile_struct {
    char            dotimes;
 } STREAMFILE;
 
+typedef struct datastream_cachedobj_struct {
+   ne_handle   handle;   // idle handle of a previously read data object ( NULL if slot is unused )
+   COMPRESS_HANDLE comphandle; // compression layer over that handle ( NULL for uncompressed objects )
+   size_t      objno;    // object number referenced by the handle
+   size_t      lastuse;  // stream-local use counter value, for LRU eviction
+} DATASTREAM_CACHEDOBJ;
+
+typedef struct datastream_arena_struct {
+   char*       block;    // primary scratch allocation block
+   size_t      size;     // total size of the primary block
+   size_t      used;     // bytes of the primary block currently allocated
+   size_t      demand;   // total bytes currently allocated ( including overflow )
+   size_t      peak;     // maximum 'demand' value since the primary block was last sized
+   void*       overflow; // list of allocations which did not fit within the primary block
+} DATASTREAM_ARENA;
+
 typedef struct datastream_struct {
    // Stream Info
    STREAM_TYPE type;
@@ -89,6 +106,12 @@ typedef struct datastream_struct {
    size_t      offset;
    size_t      excessoffset;
    ne_handle   datahandle;
+   int         cachefd;  // local cache copy of the current READ object, in place of datahandle ( -1 if unused )
+   COMPRESS_HANDLE comphandle; // compression layer over datahandle / cachefd ( NULL for uncompressed objects )
+   // Cached Object Handles ( READ streams only )
+   DATASTREAM_CACHEDOBJ* objcache;
+   size_t      objcachesize;
+   size_t      objcacheuses;
    // Per-File Info
    STREAMFILE* files;
    size_t      curfile;
@@ -99,8 +122,11 @@ typedef struct datastream_struct {
    size_t      ftagstrsize;
    char* finfostr;
    size_t finfostrlen;
+   DATASTREAM_ARENA arena; // scratch space for strings/arrays which don't outlive a single op
 }*DATASTREAM;
 
+typedef struct datastream_pread_struct* DATASTREAM_PREAD;
+
 /**
  * Generate a reference path for the given FTAG
  * @param FTAG* ftag : Reference to the FTAG value to generate an rpath for
@@ -241,6 +267,35 @@ int datastream_close(DATASTREAM* stream);
  */
 ssize_t datastream_read(DATASTREAM* stream, void* buffer, size_t count);
 
+/**
+ * Capture all info required to read the given range of the file currently referenced by
+ * the given READ DATASTREAM, such that the read may be performed independently of the stream
+ * NOTE -- The position of the stream is unaffected.  This call must be serialized with any
+ *         other ops against the same stream, but the resulting DATASTREAM_PREAD may then be
+ *         executed ( see datastream_pread() ) concurrently with any other op.
+ * @param DATASTREAM* stream : Reference to the READ DATASTREAM to be read from
+ * @param off_t offset : Offset of the read, relative to the start of the file
+ * @param size_t count : Number of bytes to be read
+ * @return DATASTREAM_PREAD : Reference to the new read request, or NULL on failure
+ */
+DATASTREAM_PREAD datastream_preadprep(DATASTREAM* stream, off_t offset, size_t count);
+
+/**
+ * Perform the given positional read, via its own data object handles, and free the request
+ * NOTE -- Any number of these may safely execute concurrently, against the same or
+ *         different files ( see datastream_preadprep() ).
+ * @param DATASTREAM_PREAD req : Read request to be performed ( always freed by this call )
+ * @param void* buf : Reference to the buffer to be populated with read data
+ * @return ssize_t : Number of bytes read, or -1 on failure
+ */
+ssize_t datastream_pread(DATASTREAM_PREAD req, void* buf);
+
+/**
+ * Free the given DATASTREAM_PREAD, without performing the read
+ * @param DATASTREAM_PREAD req : DATASTREAM_PREAD to be freed
+ */
+void datastream_preadfree(DATASTREAM_PREAD req);
+
 /**
  * Write to the file currently referenced by the given EDIT or CREATE DATASTREAM
  * @param DATASTREAM* stream : Reference to the DATASTREAM to be written to
@@ -741,7 +741,8 @@ int obj_command(marfs_config* config, char* config_path, walkerstate* state, cha
       .majorversion = RECOVERY_CURRENT_MAJORVERSION,
       .minorversion = RECOVERY_CURRENT_MINORVERSION,
       .ctag = state->ftag.ctag,
-      .streamid = state->ftag.streamid
+      .streamid = state->ftag.streamid,
+      .compression = state->ftag.compression
    };
    size_t headerlen = recovery_headertostr(&(header), NULL, 0);
    if (headerlen < 1) {
@@ -891,7 +892,8 @@ int bounds_command(marfs_config* config, walkerstate* state, char* args) {
       .majorversion = RECOVERY_CURRENT_MAJORVERSION,
       .minorversion = RECOVERY_CURRENT_MINORVERSION,
       .ctag = state->ftag.ctag,
-      .streamid = state->ftag.streamid
+      .streamid = state->ftag.streamid,
+      .compression = state->ftag.compression
    };
    size_t headerlen = recovery_headertostr(&(header), NULL, 0);
    if (headerlen < 1) {
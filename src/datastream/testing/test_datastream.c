@@ -118,6 +118,32 @@ int main(int argc, char **argv)
    // NOTE -- I'm ignoring memory leaks for error conditions 
    //         which result in immediate termination
 
+   // verify scratch arena behavior, prior to any stream use
+   DATASTREAM_ARENA arena = { .block = NULL, .size = 0, .used = 0, .demand = 0, .peak = 0, .overflow = NULL };
+   DATASTREAM_ARENA_MARK emptymark = arena_mark( &(arena) );
+   char* smallalloc = arena_alloc( &(arena), 10 );
+   DATASTREAM_ARENA_MARK smallmark = arena_mark( &(arena) );
+   char* largealloc = arena_alloc( &(arena), ARENA_INITIAL_SIZE * 2 ); // must overflow the initial block
+   if ( smallalloc == NULL  ||  largealloc == NULL  ||  arena.overflow == NULL  ||  ((uintptr_t)largealloc % ARENA_ALIGN) ) {
+      printf( "unexpected result of initial arena allocations\n" );
+      return -1;
+   }
+   snprintf( smallalloc, 10, "arenatest" );
+   memset( largealloc, 0, ARENA_INITIAL_SIZE * 2 );
+   arena_release( &(arena), smallmark );
+   if ( arena.overflow  ||  arena.demand != ARENA_ALIGN  ||  strcmp( smallalloc, "arenatest" ) ) {
+      printf( "arena release to a mark did not preserve prior allocations\n" );
+      return -1;
+   }
+   arena_release( &(arena), emptymark );
+   // once empty, the arena should regrow to cover all previous demand without overflowing
+   largealloc = arena_alloc( &(arena), ARENA_INITIAL_SIZE * 2 );
+   if ( largealloc == NULL  ||  arena.overflow  ||  largealloc != arena.block ) {
+      printf( "arena failed to regrow its primary block\n" );
+      return -1;
+   }
+   arena_destroy( &(arena) );
+
    // Initialize the libxml lib and check for API mismatches
    LIBXML_TEST_VERSION
 
@@ -481,6 +507,57 @@ int main(int argc, char **argv)
       printf( "unexpected res for read3 from 'file3' of no-pack: %zd (%s)\n", iores, strerror(errno) );
       return -1;
    }
+   // alternate reads between data objects, which should reuse cached object handles
+   if ( stream->objcachesize != 2 ) {
+      printf( "unexpected object cache size for 'file3' of no-pack: %zu\n", stream->objcachesize );
+      return -1;
+   }
+   size_t firstobj = stream->files->ftag.objno;
+   if ( datastream_seek( &(stream), 1024, SEEK_SET ) != 1024 ) {
+      printf( "failed to seek to first object of 'file3' of no-pack\n" );
+      return -1;
+   }
+   if ( datastream_read( &(stream), databuf, 1024 ) != 1024 ) {
+      printf( "failed to read first object of 'file3' of no-pack\n" );
+      return -1;
+   }
+   if ( datastream_seek( &(stream), 1048576 + 1024, SEEK_SET ) != 1048576 + 1024 ) {
+      printf( "failed to seek to second object of 'file3' of no-pack\n" );
+      return -1;
+   }
+   if ( datastream_read( &(stream), databuf, 1024 ) != 1024 ) {
+      printf( "failed to read second object of 'file3' of no-pack\n" );
+      return -1;
+   }
+   if ( datastream_seek( &(stream), 2048, SEEK_SET ) != 2048 ) {
+      printf( "failed to seek back to first object of 'file3' of no-pack\n" );
+      return -1;
+   }
+   if ( stream->datahandle != NULL  ||  stream->objno != firstobj ) {
+      printf( "unexpected object state after seek back to first object of 'file3' of no-pack\n" );
+      return -1;
+   }
+   size_t cacheindex = 0;
+   for ( ; cacheindex < stream->objcachesize; cacheindex++ ) {
+      if ( stream->objcache[cacheindex].handle  &&  stream->objcache[cacheindex].objno == firstobj ) { break; }
+   }
+   if ( cacheindex == stream->objcachesize ) {
+      printf( "first object of 'file3' of no-pack is absent from the object cache\n" );
+      return -1;
+   }
+   iores = datastream_read( &(stream), databuf, 1024 );
+   if ( iores != 1024 ) {
+      printf( "unexpected res for cached read from 'file3' of no-pack: %zd (%s)\n", iores, strerror(errno) );
+      return -1;
+   }
+   if ( memcmp( zeroarray, databuf, iores ) ) {
+      printf( "unexpected content of cached read from 'file3' of no-pack\n" );
+      return -1;
+   }
+   if ( stream->objcache[cacheindex].handle != NULL ) {
+      printf( "cached handle of 'file3' of no-pack was not consumed by read\n" );
+      return -1;
+   }
    if ( datastream_close( &(stream) ) ) {
       printf( "failed to close no-pack read stream\n" );
       return -1;
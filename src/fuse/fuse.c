@@ -83,6 +83,8 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 #endif
 
 #define CONFIGVER_FNAME "/.configver"
+#define STATS_FNAME "/.marfsstats"
+#define READDIR_BATCH 64 // count of entries ( w/ attributes ) retrieved per marfs_readdirplus() call
 
 #define CTXT (marfs_ctxt)(fuse_get_context()->private_data)
 
@@ -206,6 +208,11 @@ int fuse_create(const char *path, mode_t mode, struct fuse_file_info *ffi)
     return -EPERM;
   }
 
+  if (!strcmp(path, STATS_FNAME)) {
+    LOG( LOG_ERR, "Cannot create reserved stats file \"%s\"\n", STATS_FNAME );
+    return -EPERM;
+  }
+
   struct user_ctxt_struct u_ctxt;
   memset(&u_ctxt, 0, sizeof(struct user_ctxt_struct));
   enter_user(&u_ctxt, fuse_get_context()->uid, fuse_get_context()->gid, 1);
@@ -230,7 +237,7 @@ int fuse_flush(const char *path, struct fuse_file_info *ffi)
 {
   LOG(LOG_INFO, "%s\n", path);
 
-  if (!ffi->fh  &&  strcmp(path, CONFIGVER_FNAME))
+  if (!ffi->fh  &&  strcmp(path, CONFIGVER_FNAME)  &&  strcmp(path, STATS_FNAME))
   {
     if (!strcmp(path, CONFIGVER_FNAME)) {
       return 0;
@@ -312,6 +319,18 @@ int fuse_getattr(const char *path, struct stat *statbuf)
     return 0;
   }
 
+  if (!strcmp(path, STATS_FNAME)) {
+    // NOTE -- this size is only a snapshot; the file is opened 'direct_io' so reads may exceed it
+    statbuf->st_uid = getuid();
+    statbuf->st_gid = getgid();
+    statbuf->st_atime = time( NULL );
+    statbuf->st_mtime = time( NULL );
+    statbuf->st_mode = S_IFREG | 0444;
+    statbuf->st_nlink = 1;
+    statbuf->st_size = marfs_getstats(CTXT, NULL, 0);
+    return 0;
+  }
+
   struct user_ctxt_struct u_ctxt;
   memset(&u_ctxt, 0, sizeof(struct user_ctxt_struct));
   enter_user(&u_ctxt, fuse_get_context()->uid, fuse_get_context()->gid, 1);
@@ -334,8 +353,8 @@ int fuse_getxattr(const char *path, const char *name, char *value, size_t size)
 {
   LOG(LOG_INFO, "%s -- %s\n", path, name);
 
-  if (!strcmp(path, CONFIGVER_FNAME)) {
-    LOG( LOG_INFO, "Faking absent \"%s\" xattr for reserved config ver file\n", name );
+  if (!strcmp(path, CONFIGVER_FNAME)  ||  !strcmp(path, STATS_FNAME)) {
+    LOG( LOG_INFO, "Faking absent \"%s\" xattr for reserved file \"%s\"\n", name, path );
     return -ENOATTR;
   }
 
@@ -411,6 +430,11 @@ int fuse_link(const char *oldpath, const char *newpath)
     return -EPERM;
   }
 
+  if (!strcmp(newpath, STATS_FNAME)) {
+    LOG(LOG_ERR, "cannot link over reserved stats file\n");
+    return -EPERM;
+  }
+
   struct user_ctxt_struct u_ctxt;
   memset(&u_ctxt, 0, sizeof(struct user_ctxt_struct));
   enter_user(&u_ctxt, fuse_get_context()->uid, fuse_get_context()->gid, 1);
@@ -435,8 +459,8 @@ int fuse_listxattr(const char *path, char *list, size_t size)
 {
   LOG(LOG_INFO, "%s\n", path);
 
-  if (!strcmp(path, CONFIGVER_FNAME)) {
-    LOG( LOG_INFO, "Faking lack of all xattrs for reserved config ver file\n" );
+  if (!strcmp(path, CONFIGVER_FNAME)  ||  !strcmp(path, STATS_FNAME)) {
+    LOG( LOG_INFO, "Faking lack of all xattrs for reserved file \"%s\"\n", path );
     return 0;
   }
 
@@ -547,6 +571,17 @@ int fuse_open(const char *path, struct fuse_file_info *ffi)
     return 0;
   }
 
+  if (!strcmp(path, STATS_FNAME)) {
+    if (flags == MARFS_WRITE) {
+      LOG( LOG_ERR, "Cannot open stats file \"%s\" for write\n", STATS_FNAME );
+      return -EPERM;
+    }
+    // stats content changes constantly, so bypass the page cache and our reported size
+    ffi->direct_io = 1;
+    ffi->fh = (uint64_t)0;
+    return 0;
+  }
+
   struct user_ctxt_struct u_ctxt;
   memset(&u_ctxt, 0, sizeof(struct user_ctxt_struct));
   enter_user(&u_ctxt, fuse_get_context()->uid, fuse_get_context()->gid, 1);
@@ -634,6 +669,29 @@ int fuse_read(const char *path, char *buf, size_t size, off_t offset, struct fus
       }
       return ret;
     }
+    else if (!strcmp(path, STATS_FNAME)) {
+      // Read the current op stats report
+      LOG(LOG_INFO, "STATS-READ of %zubytes from %s at offset %zd\n", size, path, offset);
+      size_t statlen = marfs_getstats(CTXT, NULL, 0);
+      if (statlen == 0) {
+        return (errno) ? -errno : -ENOMSG;
+      }
+      // leave some headroom, as values may grow between calls
+      size_t statalloc = statlen + 1024;
+      char* statbuf = malloc(statalloc);
+      if (statbuf == NULL) {
+        LOG(LOG_ERR, "Failed to allocate stats buffer of %zu bytes\n", statalloc);
+        return -ENOMEM;
+      }
+      statlen = marfs_getstats(CTXT, statbuf, statalloc);
+      if (statlen >= statalloc) { statlen = statalloc - 1; }
+      if (offset < statlen) {
+        ret = (statlen - offset) < size ? (statlen - offset) : size;
+        memcpy(buf, statbuf + offset, ret);
+      }
+      free(statbuf);
+      return ret;
+    }
     else {
       LOG(LOG_ERR, "missing file descriptor\n");
       return -EBADF;
@@ -671,25 +729,31 @@ int fuse_readdir(const char *path, void *buf, fuse_fill_dir_t filler, off_t offs
     return -EBADF;
   }
 
-  struct dirent *de;
+  marfs_direntplus entries[READDIR_BATCH];
 
   struct user_ctxt_struct u_ctxt;
   memset(&u_ctxt, 0, sizeof(struct user_ctxt_struct));
   enter_user(&u_ctxt, fuse_get_context()->uid, fuse_get_context()->gid, 1);
   int cachederrno = errno; // cache and potentially reset errno
 
+  // pull entries in batches, handing their attributes to FUSE along with each name
   errno = 0;
-  while ((de = marfs_readdir((marfs_dhandle)ffi->fh)) != NULL)
+  ssize_t entcount;
+  while ((entcount = marfs_readdirplus((marfs_dhandle)ffi->fh, entries, READDIR_BATCH)) > 0)
   {
-    if (filler(buf, de->d_name, NULL, 0))
+    ssize_t entindex;
+    for (entindex = 0; entindex < entcount; entindex++)
     {
-      LOG(LOG_ERR, "%s\n", ENOMEM);
-      exit_user(&u_ctxt);
-      return -ENOMEM;
+      if (filler(buf, entries[entindex].dent.d_name, &(entries[entindex].st), 0))
+      {
+        LOG(LOG_ERR, "%s\n", strerror(ENOMEM));
+        exit_user(&u_ctxt);
+        return -ENOMEM;
+      }
     }
   }
   int ret = 0;
-  if ( errno != 0 ) {
+  if ( entcount < 0 ) {
     LOG( LOG_ERR, "Detected errno value post-readdir (%s)\n", strerror(errno) );
     ret = -errno;
   }
@@ -734,6 +798,10 @@ int fuse_release(const char *path, struct fuse_file_info *ffi)
       LOG(LOG_INFO, "No-Op for config version file \"%s\"\n", CONFIGVER_FNAME);
       return 0;
     }
+    if (!strcmp(path, STATS_FNAME)) {
+      LOG(LOG_INFO, "No-Op for stats file \"%s\"\n", STATS_FNAME);
+      return 0;
+    }
     LOG(LOG_ERR, "missing file descriptor\n");
     return -EBADF;
   }
@@ -850,6 +918,11 @@ int fuse_rename(const char *oldpath, const char *newpath)
     return -EPERM;
   }
 
+  if (!strcmp(newpath, STATS_FNAME)  ||  !strcmp(oldpath, STATS_FNAME)) {
+    LOG( LOG_ERR, "Cannot target reserved stats path with a rename op\n" );
+    return -EPERM;
+  }
+
   struct user_ctxt_struct u_ctxt;
   memset(&u_ctxt, 0, sizeof(struct user_ctxt_struct));
   enter_user(&u_ctxt, fuse_get_context()->uid, fuse_get_context()->gid, 1);
@@ -975,7 +1048,7 @@ int fuse_symlink(const char *target, const char *linkname)
 {
   LOG(LOG_INFO, "%s %s\n", target, linkname);
 
-  if (!strcmp(linkname, CONFIGVER_FNAME)) {
+  if (!strcmp(linkname, CONFIGVER_FNAME)  ||  !strcmp(linkname, STATS_FNAME)) {
     return -EPERM;
   }
 
@@ -74,6 +74,7 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 #include <math.h>
 
 #include "hash.h"
+#include "stats/stats.h"
 
 //   -------------   INTERNAL DEFINITIONS    -------------
 
@@ -82,6 +83,10 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 
 #define TARGET_NODE_COUNT 50000
 
+#define RADIX_SORT_THRESHOLD 4096 // vnode count at which a radix sort is used in place of qsort()
+#define RADIX_BITS 16             // bits of the leading ID value sorted per radix pass ( must divide 64 evenly )
+#define RADIX_BUCKETS ( 1 << RADIX_BITS )
+
 typedef struct virtual_node_struct {
    uint64_t   id[2];             // ID value of this virtual node
    size_t     nodenum;           // location of the real node, which this virtual node corresponds to
@@ -147,6 +152,72 @@ static int compare_nodes(const void *a, const void *b) {
 }
 
 
+// populate the given buffer with the decimal string of the given value ( no NULL-terminator ), returning its length
+static inline int format_index( char* buf, size_t value ) {
+   char digits[24];
+   int len = 0;
+   do {
+      digits[len++] = '0' + (char)( value % 10 );
+      value /= 10;
+   } while ( value );
+   int index = 0;
+   for ( ; index < len; index++ ) { buf[index] = digits[len - 1 - index]; }
+   return len;
+}
+
+// sort virtual nodes into the order imposed by compare_nodes()
+static int sort_vnodes( VIRTUAL_NODE* vnodes, size_t count ) {
+   if ( count < RADIX_SORT_THRESHOLD ) {
+      qsort( vnodes, count, sizeof( struct virtual_node_struct ), compare_nodes );
+      return 0;
+   }
+   // LSD radix sort on the leading ID value
+   VIRTUAL_NODE* tmpnodes = malloc( sizeof( struct virtual_node_struct ) * count );
+   size_t* offsets = malloc( sizeof( size_t ) * RADIX_BUCKETS );
+   if ( tmpnodes == NULL  ||  offsets == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate space for sorting %zu virtual nodes\n", count );
+      if ( tmpnodes ) { free( tmpnodes ); }
+      if ( offsets ) { free( offsets ); }
+      return -1;
+   }
+   VIRTUAL_NODE* src = vnodes;
+   VIRTUAL_NODE* dst = tmpnodes;
+   int shift = 0;
+   for ( ; shift < 64; shift += RADIX_BITS ) {
+      memset( offsets, 0, sizeof( size_t ) * RADIX_BUCKETS );
+      size_t index = 0;
+      for ( ; index < count; index++ ) { offsets[ ( src[index].id[0] >> shift ) & ( RADIX_BUCKETS - 1 ) ]++; }
+      size_t total = 0;
+      for ( index = 0; index < RADIX_BUCKETS; index++ ) {
+         size_t bucketcount = offsets[index];
+         offsets[index] = total;
+         total += bucketcount;
+      }
+      for ( index = 0; index < count; index++ ) {
+         dst[ offsets[ ( src[index].id[0] >> shift ) & ( RADIX_BUCKETS - 1 ) ]++ ] = src[index];
+      }
+      VIRTUAL_NODE* swap = src;
+      src = dst;
+      dst = swap;
+   }
+   if ( src != vnodes ) { memcpy( vnodes, src, sizeof( struct virtual_node_struct ) * count ); }
+   free( tmpnodes );
+   free( offsets );
+   // runs of matching leading ID values ( vanishingly rare ) must still be ordered by the remaining fields
+   size_t runstart = 0;
+   size_t index = 1;
+   for ( ; index <= count; index++ ) {
+      if ( index == count  ||  vnodes[index].id[0] != vnodes[runstart].id[0] ) {
+         if ( index - runstart > 1 ) {
+            qsort( vnodes + runstart, index - runstart, sizeof( struct virtual_node_struct ), compare_nodes );
+         }
+         runstart = index;
+      }
+   }
+   return 0;
+}
+
+
 //   -------------   EXTERNAL FUNCTIONS    -------------
 
 /**
@@ -271,18 +342,17 @@ HASH_TABLE hash_init( HASH_NODE* nodes, size_t count, char directlookup ) {
    for ( curnode = 0; curnode < count; curnode++ ) {
       if ( nodes[curnode].weight ) {
          // if we have a weight value, create weight*weightratio virtual nodes
+         // each is named "<node-name>-<vnode-index>", but only the index suffix changes between them
+         size_t namelen = strlen( nodes[curnode].name );
+         memcpy( vnodename, nodes[curnode].name, namelen );
+         vnodename[namelen] = '-';
+         char* suffix = vnodename + namelen + 1;
          size_t tmpvnode = 0;
          for ( ; tmpvnode < ( nodes[curnode].weight * weightratio ); tmpvnode++ ) {
             table->vnodes[curvnode + tmpvnode].nodenum = curnode;
-            int pval = snprintf( vnodename, maxname + maxdigits + 2, "%s-%zu", nodes[curnode].name, tmpvnode );
-            if ( pval < 0  ||  pval >= ( maxname + maxdigits + 2 ) ) {
-               LOG( LOG_ERR, "Failed to generate vnode name string (%d--digits%d/name%d)\n", pval, maxdigits, maxname );
-               free( vnodename );
-               free( table->vnodes );
-               free( table );
-               return NULL;
-            }
-            identifier( vnodename, table->vnodes[curvnode + tmpvnode].id );
+            int suffixlen = format_index( suffix, tmpvnode );
+            MurmurHash3_x64_128( vnodename, (int)( namelen + 1 + suffixlen ), KEY_SEED,
+                                 table->vnodes[curvnode + tmpvnode].id );
          }
          LOG( LOG_INFO, "Created %zu vnodes referencing node %zu\n", tmpvnode, curnode );
          curvnode += tmpvnode;
@@ -299,7 +369,12 @@ HASH_TABLE hash_init( HASH_NODE* nodes, size_t count, char directlookup ) {
 
    // sort all virtual nodes
    LOG( LOG_INFO, "Sorting virtual nodes\n" );
-   qsort(table->vnodes, table->vnodecount, sizeof( struct virtual_node_struct ), compare_nodes);
+   if ( sort_vnodes( table->vnodes, table->vnodecount ) ) {
+      LOG( LOG_ERR, "Failed to sort virtual nodes\n" );
+      free( table->vnodes );
+      free( table );
+      return NULL;
+   }
 
    // initialize iterator values
    table->curnode = 0;
@@ -356,16 +431,19 @@ int hash_term( HASH_TABLE table, HASH_NODE** nodes, size_t* count ) {
  *         same node.
  */
 int hash_lookup( HASH_TABLE table, const char* target, HASH_NODE** node ) {
+   uint64_t statstart = stats_start();
    // check for a NULL table
    if ( table == NULL ) {
       LOG( LOG_ERR, "Received a NULL HASH_TABLE reference\n" );
       errno = EINVAL;
+      stats_record( STATS_HASH_LOOKUP, statstart, 0, 1 );
       return -1;
    }
    // check for NULL target
    if ( target == NULL ) {
       LOG( LOG_ERR, "Received a NULL target string\n" );
       errno = EINVAL;
+      stats_record( STATS_HASH_LOOKUP, statstart, 0, 1 );
       return -1;
    }
 
@@ -467,13 +545,14 @@ int hash_lookup( HASH_TABLE table, const char* target, HASH_NODE** node ) {
    }
    // map the resulting virtual node to the actual node
    *node = table->nodes + table->vnodes[curnode].nodenum;
+   stats_record( STATS_HASH_LOOKUP, statstart, 0, 0 );
    return retval;
 }
 
 /**
  * From the most recently accessed HASH_NODE, iterate over all remaining HASH_NODE 
  * entries in the given table
- * WARNING : This function is NOT thread safe
+ * WARNING : This function is NOT thread safe ( see hash_iternext() for an alternative )
  * @param HASH_TABLE table : Table on which to iterate
  * @param HASH_NODE** node : Reference to a HASH_NODE* to be populated with the 
  *                           corresponding HASH_NODE reference
@@ -524,6 +603,75 @@ int hash_reset( HASH_TABLE table ) {
    return 0;
 }
 
+/**
+ * Initialize the given HASH_ITER, such that it will traverse every HASH_NODE of the given table
+ * NOTE -- As each HASH_ITER holds its own position, any number of them may be used to
+ *         iterate over the same table concurrently ( tables are never modified by lookups
+ *         or HASH_ITER iteration ).
+ * @param HASH_TABLE table : Table to be iterated over
+ * @param HASH_ITER* iter : Reference to the HASH_ITER to be initialized
+ * @return int : 0 on success, or -1 on failure
+ */
+int hash_iterinit( HASH_TABLE table, HASH_ITER* iter ) {
+   // check for NULL args
+   if ( table == NULL  ||  iter == NULL ) {
+      LOG( LOG_ERR, "Received a NULL HASH_TABLE / HASH_ITER reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   iter->table = table;
+   iter->position = 0;
+   return 0;
+}
+
+/**
+ * Produce the next HASH_NODE of the given HASH_ITER
+ * @param HASH_ITER* iter : HASH_ITER to progress
+ * @param HASH_NODE** node : Reference to a HASH_NODE* to be populated with the
+ *                           corresponding HASH_NODE reference
+ * @return int : 1, if a new HASH_NODE reference was produced
+ *               0, if no HASH_NODE references remain
+ *               -1, if a failure occurred
+ */
+int hash_iternext( HASH_ITER* iter, HASH_NODE** node ) {
+   // check for NULL args
+   if ( iter == NULL  ||  iter->table == NULL ) {
+      LOG( LOG_ERR, "Received a NULL / uninitialized HASH_ITER reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // check if iteration is complete
+   if ( iter->position >= iter->table->nodecount ) {
+      *node = NULL;
+      return 0;
+   }
+   *node = iter->table->nodes + iter->position;
+   iter->position++;
+   return 1;
+}
+
+/**
+ * Produce a view of the complete HASH_NODE list of the given table
+ * NOTE -- The produced list remains valid until the table is destroyed, and must not be
+ *         modified or freed by the caller.
+ * @param HASH_TABLE table : Table to produce the node list of
+ * @param HASH_NODE** nodes : Reference to a HASH_NODE* to be populated with the node list
+ * @param size_t* count : Reference to a size_t value to be populated with the length of
+ *                        the node list
+ * @return int : 0 on success, or -1 on failure
+ */
+int hash_nodes( HASH_TABLE table, HASH_NODE** nodes, size_t* count ) {
+   // check for a NULL table
+   if ( table == NULL ) {
+      LOG( LOG_ERR, "Received a NULL HASH_TABLE reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   *nodes = table->nodes;
+   *count = table->nodecount;
+   return 0;
+}
+
 
 // POLYHASH implementation
 // NOTE -- not currently in use, just here for potential future reference
@@ -68,6 +68,11 @@ typedef struct hash_node_struct {
    void*       content;
 } HASH_NODE;
 
+typedef struct hash_iter_struct {
+   HASH_TABLE table;    // table being iterated over
+   size_t     position; // index of the next node to be produced
+} HASH_ITER;
+
 /**
  * Produces a randomized integer value, between zero and maxval-1 (inclusive), 
  * which can be reproducibly generated from the given string and max values.
@@ -140,7 +145,7 @@ int hash_lookup( HASH_TABLE table, const char* target, HASH_NODE** node );
 /**
  * From the most recently accessed HASH_NODE, iterate over all remaining HASH_NODE
  * entries in the given table
- * WARNING : This function is NOT thread safe
+ * WARNING : This function is NOT thread safe ( see hash_iternext() for an alternative )
  * @param HASH_TABLE table : Table on which to iterate
  * @param HASH_NODE** node : Reference to a HASH_NODE* to be populated with the
  *                           corresponding HASH_NODE reference
@@ -158,5 +163,39 @@ int hash_iterate( HASH_TABLE table, HASH_NODE** node );
  */
 int hash_reset( HASH_TABLE table );
 
+/**
+ * Initialize the given HASH_ITER, such that it will traverse every HASH_NODE of the given table
+ * NOTE -- As each HASH_ITER holds its own position, any number of them may be used to
+ *         iterate over the same table concurrently ( tables are never modified by lookups
+ *         or HASH_ITER iteration ).
+ * @param HASH_TABLE table : Table to be iterated over
+ * @param HASH_ITER* iter : Reference to the HASH_ITER to be initialized
+ * @return int : 0 on success, or -1 on failure
+ */
+int hash_iterinit( HASH_TABLE table, HASH_ITER* iter );
+
+/**
+ * Produce the next HASH_NODE of the given HASH_ITER
+ * @param HASH_ITER* iter : HASH_ITER to progress
+ * @param HASH_NODE** node : Reference to a HASH_NODE* to be populated with the
+ *                           corresponding HASH_NODE reference
+ * @return int : 1, if a new HASH_NODE reference was produced
+ *               0, if no HASH_NODE references remain
+ *               -1, if a failure occurred
+ */
+int hash_iternext( HASH_ITER* iter, HASH_NODE** node );
+
+/**
+ * Produce a view of the complete HASH_NODE list of the given table
+ * NOTE -- The produced list remains valid until the table is destroyed, and must not be
+ *         modified or freed by the caller.
+ * @param HASH_TABLE table : Table to produce the node list of
+ * @param HASH_NODE** nodes : Reference to a HASH_NODE* to be populated with the node list
+ * @param size_t* count : Reference to a size_t value to be populated with the length of
+ *                        the node list
+ * @return int : 0 on success, or -1 on failure
+ */
+int hash_nodes( HASH_TABLE table, HASH_NODE** nodes, size_t* count );
+
 #endif // _HASH_H
 
@@ -60,6 +60,7 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 
 #include <unistd.h>
 #include <stdio.h>
+#include <time.h>
 // directly including the C file allows more flexibility for these tests
 #include "hash/hash.c"
 
@@ -183,6 +184,72 @@ int main(int argc, char **argv)
    }
    // free the nodelist itself
    free( noderef );
+
+   // verify that sorting a large vnode list matches the standard ordering ( including duplicate leading IDs )
+   size_t vcount = RADIX_SORT_THRESHOLD * 4;
+   VIRTUAL_NODE* vlist = malloc( sizeof( struct virtual_node_struct ) * vcount );
+   VIRTUAL_NODE* qlist = malloc( sizeof( struct virtual_node_struct ) * vcount );
+   if ( vlist == NULL  ||  qlist == NULL ) {
+      printf( "failed to allocate vnode lists\n" );
+      return -1;
+   }
+   srand( 17 );
+   size_t vindex = 0;
+   for ( ; vindex < vcount; vindex++ ) {
+      vlist[vindex].id[0] = (uint64_t)( rand() % ( vcount / 2 ) ) * 0x9E3779B97F4A7C15ULL;
+      vlist[vindex].id[1] = (uint64_t)( rand() % 4 );
+      vlist[vindex].nodenum = (size_t)( rand() % 8 );
+   }
+   memcpy( qlist, vlist, sizeof( struct virtual_node_struct ) * vcount );
+   qsort( qlist, vcount, sizeof( struct virtual_node_struct ), compare_nodes );
+   if ( sort_vnodes( vlist, vcount ) ) {
+      printf( "failed to sort vnode list\n" );
+      return -1;
+   }
+   if ( memcmp( vlist, qlist, sizeof( struct virtual_node_struct ) * vcount ) ) {
+      printf( "sorted vnode list does not match the standard ordering\n" );
+      return -1;
+   }
+   free( vlist );
+   free( qlist );
+
+   // time construction of a large distribution table
+   nodecount = 1000;
+   nodelist = malloc( sizeof(HASH_NODE) * nodecount );
+   if ( nodelist == NULL ) {
+      printf( "failed to allocate large node list\n" );
+      return -1;
+   }
+   for ( i = 0; i < nodecount; i++ ) {
+      nodelist[i].name = malloc( sizeof(char) * 60 );
+      if ( nodelist[i].name == NULL ) {
+         printf( "failed to allocate name string for large node %d\n", i );
+         return -1;
+      }
+      snprintf( nodelist[i].name, 60, "ref%d", i );
+      nodelist[i].weight = 1;
+      nodelist[i].content = NULL;
+   }
+   struct timespec start;
+   struct timespec end;
+   clock_gettime( CLOCK_MONOTONIC, &start );
+   int buildcount = 10;
+   for ( i = 0; i < buildcount; i++ ) {
+      disttable = hash_init( nodelist, nodecount, 0 );
+      if ( disttable == NULL ) {
+         printf( "failed to initialize large distribution table %d\n", i );
+         return -1;
+      }
+      if ( hash_term( disttable, &(noderef), &(retcount) ) ) {
+         printf( "failed to terminate large distribution table %d\n", i );
+         return -1;
+      }
+   }
+   clock_gettime( CLOCK_MONOTONIC, &end );
+   double elapsedms = ( ( end.tv_sec - start.tv_sec ) * 1000.0 ) + ( ( end.tv_nsec - start.tv_nsec ) / 1000000.0 );
+   printf( "Built %d tables of %zu nodes in an average of %.3f ms\n", buildcount, nodecount, elapsedms / buildcount );
+   for ( i = 0; i < nodecount; i++ ) { free( nodelist[i].name ); }
+   free( nodelist );
    free( nodename );
 
    return 0;
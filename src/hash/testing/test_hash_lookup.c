@@ -134,6 +134,53 @@ int main(int argc, char **argv)
       }
    }
 
+   // interleave a pair of external iterators, confirming that each holds its own position
+   HASH_ITER iterA;
+   HASH_ITER iterB;
+   if ( hash_iterinit( lookuptable, &(iterA) )  ||  hash_iterinit( lookuptable, &(iterB) ) ) {
+      printf( "failed to initialize external iterators\n" );
+      return -1;
+   }
+   HASH_NODE* noderefB = NULL;
+   if ( hash_iternext( &(iterB), &(noderefB) ) != 1 ) {
+      printf( "failed to progress iterB to its first node\n" );
+      return -1;
+   }
+   for ( i = 0; i < (nodecount + 2); i++ ) {
+      int ires = hash_iternext( &(iterA), &(noderef) );
+      int iresB = hash_iternext( &(iterB), &(noderefB) );
+      if ( i >= nodecount ) {
+         if ( ires  ||  iresB ) {
+            printf( "expected return of external iteration completion: %d / %d\n", ires, iresB );
+            return -1;
+         }
+         continue;
+      }
+      snprintf( nodename, 60, "node%d", i );
+      if ( ires != 1  ||  strcmp( nodename, noderef->name ) ) {
+         printf( "expected iterA to produce node%d (res = %d)\n", i, ires );
+         return -1;
+      }
+      if ( i + 1 < nodecount ) {
+         snprintf( nodename, 60, "node%d", i + 1 );
+         if ( iresB != 1  ||  strcmp( nodename, noderefB->name ) ) {
+            printf( "expected iterB to produce node%d (res = %d)\n", i + 1, iresB );
+            return -1;
+         }
+      }
+      else if ( iresB ) {
+         printf( "expected iterB to complete after node%d (res = %d)\n", i, iresB );
+         return -1;
+      }
+   }
+   // confirm the bulk node view
+   HASH_NODE* nodeview = NULL;
+   size_t viewcount = 0;
+   if ( hash_nodes( lookuptable, &(nodeview), &(viewcount) )  ||  nodeview != nodelist  ||  viewcount != nodecount ) {
+      printf( "unexpected node view of lookup table ( %zu nodes )\n", viewcount );
+      return -1;
+   }
+
    // reach into the hash table structure itself, and manually force an ID collision case
    uint64_t oldid[2];
    oldid[0] = lookuptable->vnodes[1].id[0];
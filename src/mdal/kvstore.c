@@ -0,0 +1,1113 @@
+/*
+Copyright (c) 2015, Los Alamos National Security, LLC
+All rights reserved.
+
+Copyright 2015.  Los Alamos National Security, LLC. This software was
+produced under U.S. Government contract DE-AC52-06NA25396 for Los
+Alamos National Laboratory (LANL), which is operated by Los Alamos
+National Security, LLC for the U.S. Department of Energy. The
+U.S. Government has rights to use, reproduce, and distribute this
+software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL SECURITY,
+LLC MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY
+FOR THE USE OF THIS SOFTWARE.  If software is modified to produce
+derivative works, such modified software should be clearly marked, so
+as not to confuse it with the version available from LANL.
+ 
+Additionally, redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the following
+conditions are met: 1. Redistributions of source code must retain the
+above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of Los Alamos National Security, LLC, Los Alamos
+National Laboratory, LANL, the U.S. Government, nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL LOS
+ALAMOS NATIONAL SECURITY, LLC OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-----
+NOTE:
+-----
+MarFS is released under the BSD license.
+
+MarFS was reviewed and released by LANL under Los Alamos Computer Code
+identifier: LA-CC-15-039.
+
+MarFS uses libaws4c for Amazon S3 object communication. The original version
+is at https://aws.amazon.com/code/Amazon-S3/2601 and under the LGPL license.
+LANL added functionality to the original work. The original work plus
+LANL contributions is found at https://github.com/jti-lanl/aws4c.
+
+GNU licenses can be found at http://www.gnu.org/licenses/.
+*/
+
+#include "marfs_auto_config.h"
+#ifdef DEBUG_MDAL
+#define DEBUG DEBUG_MDAL
+#elif (defined DEBUG_ALL)
+#define DEBUG DEBUG_ALL
+#endif
+#define LOG_PREFIX "kvstore"
+#include <logging.h>
+
+#include "kvstore.h"
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+
+
+//   -------------   INTERNAL DEFINITIONS    -------------
+
+#define KVSTORE_MAGIC 0x4d4b5642          // "MKVB" batch header identifier
+#define KVSTORE_TOMBSTONE UINT32_MAX      // value length of a deletion record
+#define KVSTORE_MAXLEVEL 24               // max height of the skiplist index
+#define KVSTORE_COMPACT_MIN (1024 * 1024) // min count of superseded log bytes, prior to compaction
+#define KVSTORE_BATCH_TARGET (1024 * 1024) // target size of each batch written by compaction
+#define KVSTORE_RECSIZE(keylen,vallen) ( 2 * sizeof(uint32_t) + (keylen) + (vallen) )
+
+typedef struct kvstore_batch_header_struct {
+   uint32_t magic;    // KVSTORE_MAGIC
+   uint32_t count;    // count of records in the batch
+   uint64_t length;   // total length of the records following this header
+   uint32_t checksum; // checksum of the record bytes
+   uint32_t reserved;
+} kvbatch;
+
+typedef struct kvstore_node_struct {
+   char*    key;
+   size_t   keylen;
+   off_t    valoff;  // log offset of the committed value
+   uint32_t vallen;  // length of the value
+   char*    pendval; // value set by the active transaction ( NULL, if committed )
+   size_t   pendop;  // index of the transaction op which produced the pending value
+   off_t    newoff;  // log offset of the value, within a compacted log
+   int      level;
+   struct kvstore_node_struct* next[];
+} kvnode;
+
+typedef struct kvstore_op_struct {
+   char*    key;
+   size_t   keylen;
+   char*    val;
+   uint32_t vallen;  // KVSTORE_TOMBSTONE, for deletions
+} kvop;
+
+typedef struct kvstore_struct {
+   char*    path;      // path of the log file
+   int      logfd;     // handle of the log file
+   ino_t    logino;    // inode of the log file ( used to detect compaction by other procs )
+   int      lockfd;    // handle of the lock file
+   off_t    loadedoff; // log offset following the last applied batch
+   off_t    deadbytes; // count of superseded log bytes
+   size_t   keycount;  // count of keys in the index
+   kvnode*  head;      // skiplist index of all keys
+   int      level;     // current max level of the index
+   unsigned int seed;  // random seed for index level generation
+   pthread_mutex_t lock;
+   char     lockinit;  // flag indicating that our mutex has been initialized
+   char     txn;       // active transaction type ( 0 - none, 1 - read, 2 - write )
+   kvop*    ops;       // list of operations in the active transaction
+   size_t   opcount;
+   size_t   opalloc;
+   off_t    txndead;   // count of log bytes which will be superseded by the active transaction
+} *KVSTORE;
+
+
+//   -------------   INTERNAL FUNCTIONS    -------------
+
+/**
+ * Produce a checksum of the given buffer
+ * @param const char* buf : Buffer to checksum
+ * @param size_t len : Length of the buffer
+ * @return uint32_t : Checksum value
+ */
+uint32_t kvchecksum( const char* buf, size_t len ) {
+   // 32-bit FNV-1a
+   uint32_t sum = 2166136261U;
+   size_t index = 0;
+   for ( ; index < len; index++ ) {
+      sum ^= (unsigned char)buf[index];
+      sum *= 16777619U;
+   }
+   return sum;
+}
+
+/**
+ * Compare an index key to the given string
+ * @param kvnode* node : Node to compare ( NULL is treated as the end of the index )
+ * @param const char* key : Key to compare against
+ * @return int : Less than, equal to, or greater than zero, if the node key is ordered
+ *               before, equal to, or after the given key ( respectively )
+ */
+int kvcompare( kvnode* node, const char* key ) {
+   if ( node == NULL ) { return 1; }
+   return strcmp( node->key, key );
+}
+
+/**
+ * Locate the first index node with a key >= the given key
+ * @param KVSTORE store : Store to search
+ * @param const char* key : Key to search for
+ * @param kvnode** prev : Array of KVSTORE_MAXLEVEL node refs to be populated with the
+ *                        preceding node at each level ( may be NULL )
+ * @return kvnode* : Located node, or NULL if all keys are ordered before the given key
+ */
+kvnode* kvfind( KVSTORE store, const char* key, kvnode** prev ) {
+   kvnode* node = store->head;
+   int level = store->level - 1;
+   for ( ; level >= 0; level-- ) {
+      while ( kvcompare( node->next[level], key ) < 0 ) { node = node->next[level]; }
+      if ( prev ) { prev[level] = node; }
+   }
+   return node->next[0];
+}
+
+/**
+ * Allocate a new index node
+ * @param int level : Level of the new node
+ * @param const char* key : Key of the new node ( NULL for the head node )
+ * @param size_t keylen : Length of the key
+ * @return kvnode* : New node, or NULL if a failure occurred
+ */
+kvnode* kvnewnode( int level, const char* key, size_t keylen ) {
+   kvnode* node = calloc( 1, sizeof( struct kvstore_node_struct ) + ( sizeof(kvnode*) * level ) );
+   if ( node == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new index node\n" );
+      return NULL;
+   }
+   node->level = level;
+   if ( key ) {
+      node->key = malloc( sizeof(char) * (keylen + 1) );
+      if ( node->key == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate a key string of length %zu\n", keylen );
+         free( node );
+         return NULL;
+      }
+      memcpy( node->key, key, keylen );
+      node->key[keylen] = '\0';
+      node->keylen = keylen;
+   }
+   return node;
+}
+
+/**
+ * Insert a new key into the index
+ * @param KVSTORE store : Store to insert into
+ * @param const char* key : Key to be inserted ( must not already exist )
+ * @param size_t keylen : Length of the key
+ * @param kvnode** prev : Preceding nodes of the key, at each level ( see kvfind() )
+ * @return kvnode* : New index node, or NULL if a failure occurred
+ */
+kvnode* kvinsert( KVSTORE store, const char* key, size_t keylen, kvnode** prev ) {
+   int level = 1;
+   while ( level < KVSTORE_MAXLEVEL  &&  ( rand_r( &(store->seed) ) & 3 ) == 0 ) { level++; }
+   kvnode* node = kvnewnode( level, key, keylen );
+   if ( node == NULL ) { return NULL; }
+   for ( ; store->level < level; store->level++ ) { prev[store->level] = store->head; }
+   int index = 0;
+   for ( ; index < level; index++ ) {
+      node->next[index] = prev[index]->next[index];
+      prev[index]->next[index] = node;
+   }
+   store->keycount++;
+   return node;
+}
+
+/**
+ * Remove the given node from the index
+ * @param KVSTORE store : Store to remove from
+ * @param kvnode* node : Node to be removed
+ * @param kvnode** prev : Preceding nodes of the key, at each level ( see kvfind() )
+ */
+void kvremove( KVSTORE store, kvnode* node, kvnode** prev ) {
+   int index = 0;
+   for ( ; index < node->level; index++ ) {
+      if ( prev[index]->next[index] == node ) { prev[index]->next[index] = node->next[index]; }
+   }
+   while ( store->level > 1  &&  store->head->next[store->level - 1] == NULL ) { store->level--; }
+   store->keycount--;
+   if ( node->pendval ) { free( node->pendval ); }
+   free( node->key );
+   free( node );
+}
+
+/**
+ * Free all entries of the index
+ * @param KVSTORE store : Store to be reset
+ */
+void kvresetindex( KVSTORE store ) {
+   kvnode* node = store->head->next[0];
+   while ( node ) {
+      kvnode* next = node->next[0];
+      if ( node->pendval ) { free( node->pendval ); }
+      free( node->key );
+      free( node );
+      node = next;
+   }
+   memset( store->head->next, 0, sizeof(kvnode*) * KVSTORE_MAXLEVEL );
+   store->level = 1;
+   store->keycount = 0;
+   store->loadedoff = 0;
+   store->deadbytes = 0;
+}
+
+/**
+ * Free all operations of the active transaction
+ * @param KVSTORE store : Store to clear the transaction of
+ */
+void kvclearops( KVSTORE store ) {
+   size_t index = 0;
+   for ( ; index < store->opcount; index++ ) {
+      free( store->ops[index].key );
+      if ( store->ops[index].val ) { free( store->ops[index].val ); }
+   }
+   store->opcount = 0;
+   store->txndead = 0;
+}
+
+/**
+ * Check for any intact batch following the given log offset
+ * @param KVSTORE store : Store to be searched
+ * @param off_t offset : Log offset of the damaged content ( search begins at the following byte )
+ * @param off_t logsize : Current size of the log
+ * @return int : One if an intact batch follows, zero if not, or -1 if a failure occurred
+ */
+int kvfindbatch( KVSTORE store, off_t offset, off_t logsize ) {
+   size_t taillen = logsize - offset;
+   char* tail = malloc( taillen );
+   if ( tail == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a buffer for %zu bytes of trailing log content\n", taillen );
+      return -1;
+   }
+   if ( pread( store->logfd, tail, taillen, offset ) != (ssize_t)taillen ) {
+      LOG( LOG_ERR, "Failed to read trailing log content at offset %zd\n", (ssize_t)offset );
+      free( tail );
+      return -1;
+   }
+   size_t pos = 1;
+   for ( ; pos + sizeof(kvbatch) <= taillen; pos++ ) {
+      kvbatch header;
+      memcpy( &(header), tail + pos, sizeof(kvbatch) );
+      if ( header.magic == KVSTORE_MAGIC  &&  header.length <= taillen - pos - sizeof(kvbatch)  &&
+           kvchecksum( tail + pos + sizeof(kvbatch), header.length ) == header.checksum ) {
+         LOG( LOG_INFO, "Found an intact batch at offset %zd\n", (ssize_t)(offset + pos) );
+         free( tail );
+         return 1;
+      }
+   }
+   free( tail );
+   return 0;
+}
+
+/**
+ * Apply all complete batches appended to the log since it was last read
+ * NOTE -- Reading stops at a torn final batch ( one which runs past the end of the log,
+ *         or which fails its checksum with no intact batch following ).  Such content
+ *         will be overwritten by the next commit.  Damaged content followed by intact
+ *         batches is never discarded, and results in an EBADMSG failure.
+ * @param KVSTORE store : Store to be updated
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvreplay( KVSTORE store ) {
+   struct stat logstat;
+   if ( fstat( store->logfd, &(logstat) ) ) {
+      LOG( LOG_ERR, "Failed to stat log file: \"%s\"\n", store->path );
+      return -1;
+   }
+   kvnode* prev[KVSTORE_MAXLEVEL];
+   while ( store->loadedoff + (off_t)sizeof(kvbatch) <= logstat.st_size ) {
+      // read in the next batch header
+      kvbatch header;
+      if ( pread( store->logfd, &(header), sizeof(kvbatch), store->loadedoff ) != sizeof(kvbatch) ) {
+         LOG( LOG_ERR, "Failed to read batch header at offset %zd\n", (ssize_t)store->loadedoff );
+         return -1;
+      }
+      off_t payloadoff = store->loadedoff + sizeof(kvbatch);
+      if ( header.magic != KVSTORE_MAGIC ) {
+         // an unrecognized header is only acceptable as the remnant of an interrupted final write
+         int found = kvfindbatch( store, store->loadedoff, logstat.st_size );
+         if ( found ) {
+            if ( found > 0 ) {
+               LOG( LOG_ERR, "Log is damaged at offset %zd, with intact batches following\n", (ssize_t)store->loadedoff );
+               errno = EBADMSG;
+            }
+            return -1;
+         }
+         LOG( LOG_WARNING, "Ignoring torn log content following offset %zd\n", (ssize_t)store->loadedoff );
+         break;
+      }
+      if ( header.length > (uint64_t)(logstat.st_size - payloadoff) ) {
+         LOG( LOG_WARNING, "Ignoring incomplete log content following offset %zd\n", (ssize_t)store->loadedoff );
+         break;
+      }
+      char* payload = malloc( header.length + 1 );
+      if ( payload == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate a batch buffer of %zu bytes\n", (size_t)header.length );
+         return -1;
+      }
+      if ( pread( store->logfd, payload, header.length, payloadoff ) != (ssize_t)header.length ) {
+         LOG( LOG_ERR, "Failed to read batch content at offset %zd\n", (ssize_t)payloadoff );
+         free( payload );
+         return -1;
+      }
+      if ( kvchecksum( payload, header.length ) != header.checksum ) {
+         free( payload );
+         if ( payloadoff + (off_t)header.length != logstat.st_size ) {
+            // only the final batch of the log may be torn
+            LOG( LOG_ERR, "Log is damaged at offset %zd, with content following\n", (ssize_t)store->loadedoff );
+            errno = EBADMSG;
+            return -1;
+         }
+         LOG( LOG_WARNING, "Ignoring torn final batch at offset %zd\n", (ssize_t)store->loadedoff );
+         break;
+      }
+      // apply each record of the batch
+      char* parse = payload;
+      char* end = payload + header.length;
+      uint32_t reccount = 0;
+      for ( ; reccount < header.count; reccount++ ) {
+         uint32_t lens[2];
+         if ( parse + sizeof(lens) > end ) { break; }
+         memcpy( lens, parse, sizeof(lens) );
+         size_t vallen = ( lens[1] == KVSTORE_TOMBSTONE ) ? 0 : lens[1];
+         if ( lens[0] == 0  ||  (size_t)(end - parse) < KVSTORE_RECSIZE( lens[0], vallen ) ) { break; }
+         char* key = parse + sizeof(lens);
+         char tmpchar = key[lens[0]];
+         key[lens[0]] = '\0'; // temporarily terminate the key string
+         kvnode* node = kvfind( store, key, prev );
+         if ( kvcompare( node, key ) ) { node = NULL; }
+         if ( node ) { store->deadbytes += KVSTORE_RECSIZE( node->keylen, node->vallen ); }
+         if ( lens[1] == KVSTORE_TOMBSTONE ) {
+            if ( node ) { kvremove( store, node, prev ); }
+            store->deadbytes += KVSTORE_RECSIZE( lens[0], 0 );
+         }
+         else {
+            if ( node == NULL  &&  (node = kvinsert( store, key, lens[0], prev )) == NULL ) {
+               LOG( LOG_ERR, "Failed to insert a new index entry\n" );
+               free( payload );
+               return -1;
+            }
+            node->valoff = payloadoff + ( (key + lens[0]) - payload );
+            node->vallen = lens[1];
+         }
+         key[lens[0]] = tmpchar;
+         parse += KVSTORE_RECSIZE( lens[0], vallen );
+      }
+      free( payload );
+      if ( reccount != header.count ) {
+         LOG( LOG_ERR, "Encountered a malformed batch at offset %zd\n", (ssize_t)store->loadedoff );
+         errno = EBADMSG;
+         return -1;
+      }
+      store->loadedoff = payloadoff + header.length;
+   }
+   return 0;
+}
+
+/**
+ * Reopen the log file, reloading the index if another process has replaced the log
+ * @param KVSTORE store : Store to be refreshed
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvrefresh( KVSTORE store ) {
+   struct stat pathstat;
+   if ( stat( store->path, &(pathstat) ) ) {
+      LOG( LOG_ERR, "Failed to stat log path: \"%s\"\n", store->path );
+      return -1;
+   }
+   if ( pathstat.st_ino != store->logino ) {
+      // the log has been compacted by another process
+      LOG( LOG_INFO, "Reloading replaced log file: \"%s\"\n", store->path );
+      int newfd = open( store->path, O_RDWR );
+      if ( newfd < 0 ) {
+         LOG( LOG_ERR, "Failed to open replaced log file: \"%s\"\n", store->path );
+         return -1;
+      }
+      close( store->logfd );
+      store->logfd = newfd;
+      store->logino = pathstat.st_ino;
+      kvresetindex( store );
+   }
+   return kvreplay( store );
+}
+
+/**
+ * Sync the parent directory of the given log path, ensuring that the log's directory entry is durable
+ * @param const char* path : Path of the log file
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvsyncparent( const char* path ) {
+   char* parent = strdup( path );
+   if ( parent == NULL ) {
+      LOG( LOG_ERR, "Failed to duplicate log path: \"%s\"\n", path );
+      return -1;
+   }
+   char* sep = strrchr( parent, '/' );
+   if ( sep == parent ) { *(sep + 1) = '\0'; }
+   else if ( sep ) { *sep = '\0'; }
+   else { parent[0] = '.'; parent[1] = '\0'; }
+   int dfd = open( parent, O_RDONLY | O_DIRECTORY );
+   if ( dfd < 0 ) {
+      LOG( LOG_ERR, "Failed to open parent dir of log file: \"%s\"\n", parent );
+      free( parent );
+      return -1;
+   }
+   if ( fsync( dfd ) ) {
+      LOG( LOG_ERR, "Failed to sync parent dir of log file: \"%s\"\n", parent );
+      int errorval = errno;
+      close( dfd );
+      free( parent );
+      errno = errorval;
+      return -1;
+   }
+   close( dfd );
+   free( parent );
+   return 0;
+}
+
+/**
+ * Rewrite the log of the given store, omitting all superseded records
+ * NOTE -- The caller must hold an exclusive lock on the store
+ * @param KVSTORE store : Store to compact
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvcompact( KVSTORE store ) {
+   size_t pathlen = strlen( store->path );
+   char* cpath = malloc( sizeof(char) * (pathlen + 9) );
+   if ( cpath == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate compaction path string\n" );
+      return -1;
+   }
+   snprintf( cpath, pathlen + 9, "%s.compact", store->path );
+   int cfd = open( cpath, O_CREAT | O_TRUNC | O_RDWR, S_IRUSR | S_IWUSR );
+   if ( cfd < 0 ) {
+      LOG( LOG_ERR, "Failed to open compaction file: \"%s\"\n", cpath );
+      free( cpath );
+      return -1;
+   }
+   char* batch = NULL;
+   size_t batchalloc = 0;
+   off_t coff = 0;
+   char failed = 0;
+   kvnode* node = store->head->next[0];
+   while ( node  &&  !(failed) ) {
+      // pack as many records as fit within a single batch
+      size_t batchlen = sizeof(kvbatch);
+      kvbatch header = { .magic = KVSTORE_MAGIC, .count = 0, .length = 0, .checksum = 0, .reserved = 0 };
+      for ( ; node  &&  batchlen < KVSTORE_BATCH_TARGET; node = node->next[0] ) {
+         size_t reclen = KVSTORE_RECSIZE( node->keylen, node->vallen );
+         if ( batchlen + reclen > batchalloc ) {
+            size_t newalloc = batchlen + reclen + KVSTORE_BATCH_TARGET;
+            char* newbatch = realloc( batch, newalloc );
+            if ( newbatch == NULL ) {
+               LOG( LOG_ERR, "Failed to allocate a compaction batch of %zu bytes\n", newalloc );
+               failed = 1;
+               break;
+            }
+            batch = newbatch;
+            batchalloc = newalloc;
+         }
+         uint32_t lens[2] = { node->keylen, node->vallen };
+         memcpy( batch + batchlen, lens, sizeof(lens) );
+         memcpy( batch + batchlen + sizeof(lens), node->key, node->keylen );
+         char* valptr = batch + batchlen + sizeof(lens) + node->keylen;
+         if ( pread( store->logfd, valptr, node->vallen, node->valoff ) != node->vallen ) {
+            LOG( LOG_ERR, "Failed to read the value of key \"%s\"\n", node->key );
+            failed = 1;
+            break;
+         }
+         node->newoff = coff + ( valptr - batch );
+         batchlen += reclen;
+         header.count++;
+      }
+      if ( failed ) { break; }
+      header.length = batchlen - sizeof(kvbatch);
+      header.checksum = kvchecksum( batch + sizeof(kvbatch), header.length );
+      memcpy( batch, &(header), sizeof(kvbatch) );
+      if ( pwrite( cfd, batch, batchlen, coff ) != (ssize_t)batchlen ) {
+         LOG( LOG_ERR, "Failed to write compaction batch at offset %zd\n", (ssize_t)coff );
+         failed = 1;
+         break;
+      }
+      coff += batchlen;
+   }
+   if ( batch ) { free( batch ); }
+   if ( failed ) {
+      close( cfd );
+      unlink( cpath );
+      free( cpath );
+      return -1;
+   }
+   // replace the original log
+   struct stat cstat;
+   if ( fsync( cfd )  ||  fstat( cfd, &(cstat) )  ||  rename( cpath, store->path ) ) {
+      LOG( LOG_ERR, "Failed to replace log file with compacted copy: \"%s\"\n", cpath );
+      close( cfd );
+      unlink( cpath );
+      free( cpath );
+      return -1;
+   }
+   free( cpath );
+   close( store->logfd );
+   store->logfd = cfd;
+   if ( kvsyncparent( store->path ) ) {
+      LOG( LOG_WARNING, "Failed to sync directory entry of compacted log: \"%s\"\n", store->path );
+   }
+   store->logino = cstat.st_ino;
+   store->loadedoff = coff;
+   store->deadbytes = 0;
+   for ( node = store->head->next[0]; node; node = node->next[0] ) { node->valoff = node->newoff; }
+   LOG( LOG_INFO, "Compacted log \"%s\" to %zd bytes\n", store->path, (ssize_t)coff );
+   return 0;
+}
+
+/**
+ * Write all operations of the active transaction to the log
+ * NOTE -- The caller must hold an exclusive lock on the store
+ * @param KVSTORE store : Store to commit
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvcommit( KVSTORE store ) {
+   if ( store->opcount == 0 ) { return 0; }
+   // serialize all operations into a single batch
+   size_t batchlen = sizeof(kvbatch);
+   size_t index = 0;
+   for ( ; index < store->opcount; index++ ) {
+      kvop* op = store->ops + index;
+      batchlen += KVSTORE_RECSIZE( op->keylen, ( op->vallen == KVSTORE_TOMBSTONE ) ? 0 : op->vallen );
+   }
+   char* batch = malloc( batchlen );
+   if ( batch == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a batch buffer of %zu bytes\n", batchlen );
+      return -1;
+   }
+   char* fill = batch + sizeof(kvbatch);
+   for ( index = 0; index < store->opcount; index++ ) {
+      kvop* op = store->ops + index;
+      uint32_t lens[2] = { op->keylen, op->vallen };
+      memcpy( fill, lens, sizeof(lens) );
+      fill += sizeof(lens);
+      memcpy( fill, op->key, op->keylen );
+      fill += op->keylen;
+      if ( op->vallen != KVSTORE_TOMBSTONE ) {
+         memcpy( fill, op->val, op->vallen );
+         fill += op->vallen;
+      }
+   }
+   kvbatch header = { .magic = KVSTORE_MAGIC, .count = store->opcount, .length = batchlen - sizeof(kvbatch), .reserved = 0 };
+   header.checksum = kvchecksum( batch + sizeof(kvbatch), header.length );
+   memcpy( batch, &(header), sizeof(kvbatch) );
+   // discard any torn content at the end of the log ( see kvreplay() ), then append our batch
+   struct stat logstat;
+   if ( fstat( store->logfd, &(logstat) ) ) {
+      LOG( LOG_ERR, "Failed to stat log file: \"%s\"\n", store->path );
+      free( batch );
+      return -1;
+   }
+   if ( logstat.st_size > store->loadedoff  &&  ftruncate( store->logfd, store->loadedoff ) ) {
+      LOG( LOG_ERR, "Failed to truncate incomplete log content at offset %zd\n", (ssize_t)store->loadedoff );
+      free( batch );
+      return -1;
+   }
+   if ( pwrite( store->logfd, batch, batchlen, store->loadedoff ) != (ssize_t)batchlen ) {
+      LOG( LOG_ERR, "Failed to append a batch of %zu bytes to the log\n", batchlen );
+      int errorval = errno;
+      if ( ftruncate( store->logfd, store->loadedoff ) ) {
+         LOG( LOG_WARNING, "Failed to truncate partial batch from the log\n" );
+      }
+      free( batch );
+      errno = errorval;
+      return -1;
+   }
+   free( batch );
+   // ensure the batch is durable, before exposing it as committed
+   if ( fdatasync( store->logfd ) ) {
+      LOG( LOG_ERR, "Failed to sync a batch of %zu bytes to the log\n", batchlen );
+      int errorval = errno;
+      if ( ftruncate( store->logfd, store->loadedoff ) ) {
+         LOG( LOG_WARNING, "Failed to truncate unsynced batch from the log\n" );
+      }
+      errno = errorval;
+      return -1;
+   }
+   // update our index to reference the committed values
+   kvnode* prev[KVSTORE_MAXLEVEL];
+   off_t valoff = store->loadedoff + sizeof(kvbatch);
+   for ( index = 0; index < store->opcount; index++ ) {
+      kvop* op = store->ops + index;
+      valoff += 2 * sizeof(uint32_t) + op->keylen;
+      if ( op->vallen == KVSTORE_TOMBSTONE ) { continue; }
+      kvnode* node = kvfind( store, op->key, prev );
+      if ( kvcompare( node, op->key ) == 0  &&  node->pendval  &&  node->pendop == index ) {
+         free( node->pendval );
+         node->pendval = NULL;
+         node->valoff = valoff;
+         node->vallen = op->vallen;
+      }
+      valoff += op->vallen;
+   }
+   store->loadedoff += batchlen;
+   store->deadbytes += store->txndead;
+   return 0;
+}
+
+/**
+ * Record a new operation within the active transaction
+ * @param KVSTORE store : Store to record the operation within
+ * @param const char* key : Key of the operation
+ * @param size_t keylen : Length of the key
+ * @param const void* val : Value of the operation ( NULL, for deletions )
+ * @param uint32_t vallen : Length of the value ( KVSTORE_TOMBSTONE, for deletions )
+ * @return kvop* : Reference to the new operation, or NULL if a failure occurred
+ */
+kvop* kvaddop( KVSTORE store, const char* key, size_t keylen, const void* val, uint32_t vallen ) {
+   if ( store->opcount == store->opalloc ) {
+      size_t newalloc = ( store->opalloc ) ? store->opalloc * 2 : 16;
+      kvop* newops = realloc( store->ops, sizeof(kvop) * newalloc );
+      if ( newops == NULL ) {
+         LOG( LOG_ERR, "Failed to expand transaction op list to %zu entries\n", newalloc );
+         return NULL;
+      }
+      store->ops = newops;
+      store->opalloc = newalloc;
+   }
+   kvop* op = store->ops + store->opcount;
+   op->key = strdup( key );
+   op->keylen = keylen;
+   op->val = NULL;
+   op->vallen = vallen;
+   if ( op->key == NULL ) {
+      LOG( LOG_ERR, "Failed to duplicate key string\n" );
+      return NULL;
+   }
+   if ( val ) {
+      op->val = malloc( vallen + 1 );
+      if ( op->val == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate a value buffer of %u bytes\n", vallen );
+         free( op->key );
+         return NULL;
+      }
+      memcpy( op->val, val, vallen );
+   }
+   store->opcount++;
+   return op;
+}
+
+
+//   -------------   EXTERNAL FUNCTIONS    -------------
+
+/**
+ * Open the KVSTORE at the given location
+ * @param const char* path : Path of the log file of the store
+ *                           NOTE -- the store will also make use of "<path>.lock"
+ *                                   and "<path>.compact" files
+ * @param char create : If non-zero, the store will be created, if it does not yet exist
+ * @return KVSTORE : Reference to the open KVSTORE, or NULL if a failure occurred
+ */
+KVSTORE kvstore_open( const char* path, char create ) {
+   // check for NULL path
+   if ( path == NULL ) {
+      LOG( LOG_ERR, "Received a NULL path value\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   KVSTORE store = calloc( 1, sizeof( struct kvstore_struct ) );
+   if ( store == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new KVSTORE struct\n" );
+      return NULL;
+   }
+   store->logfd = -1;
+   store->lockfd = -1;
+   store->level = 1;
+   store->seed = (unsigned int)( time(NULL) ^ getpid() );
+   store->path = strdup( path );
+   store->head = kvnewnode( KVSTORE_MAXLEVEL, NULL, 0 );
+   size_t pathlen = strlen( path );
+   char* lockpath = malloc( sizeof(char) * (pathlen + 6) );
+   if ( store->path == NULL  ||  store->head == NULL  ||  lockpath == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate KVSTORE path strings and index\n" );
+      if ( lockpath ) { free( lockpath ); }
+      kvstore_close( store );
+      return NULL;
+   }
+   snprintf( lockpath, pathlen + 6, "%s.lock", path );
+   int oflags = ( create ) ? O_RDWR | O_CREAT : O_RDWR;
+   store->lockfd = open( lockpath, oflags, S_IRUSR | S_IWUSR );
+   if ( store->lockfd < 0 ) {
+      LOG( LOG_ERR, "Failed to open lock file: \"%s\"\n", lockpath );
+      free( lockpath );
+      kvstore_close( store );
+      return NULL;
+   }
+   free( lockpath );
+   // hold a lock, while we open and load the log
+   if ( flock( store->lockfd, LOCK_SH ) ) {
+      LOG( LOG_ERR, "Failed to acquire lock for KVSTORE: \"%s\"\n", path );
+      kvstore_close( store );
+      return NULL;
+   }
+   struct stat logstat;
+   store->logfd = open( path, oflags, S_IRUSR | S_IWUSR );
+   if ( store->logfd < 0  ||  fstat( store->logfd, &(logstat) ) ) {
+      LOG( LOG_ERR, "Failed to open log file: \"%s\"\n", path );
+      flock( store->lockfd, LOCK_UN );
+      kvstore_close( store );
+      return NULL;
+   }
+   store->logino = logstat.st_ino;
+   // if we may have just created the log, ensure its directory entry is durable
+   if ( create  &&  logstat.st_size == 0  &&  kvsyncparent( path ) ) {
+      LOG( LOG_ERR, "Failed to sync directory entry of log file: \"%s\"\n", path );
+      flock( store->lockfd, LOCK_UN );
+      kvstore_close( store );
+      return NULL;
+   }
+   if ( kvreplay( store ) ) {
+      LOG( LOG_ERR, "Failed to load log file: \"%s\"\n", path );
+      flock( store->lockfd, LOCK_UN );
+      kvstore_close( store );
+      return NULL;
+   }
+   flock( store->lockfd, LOCK_UN );
+   if ( pthread_mutex_init( &(store->lock), NULL ) ) {
+      LOG( LOG_ERR, "Failed to initialize KVSTORE lock\n" );
+      kvstore_close( store );
+      return NULL;
+   }
+   store->lockinit = 1;
+   return store;
+}
+
+/**
+ * Close the given KVSTORE
+ * @param KVSTORE store : Store to be closed
+ *                        NOTE -- any uncommitted transaction will be aborted
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvstore_close( KVSTORE store ) {
+   // check for NULL store
+   if ( store == NULL ) {
+      LOG( LOG_ERR, "Received a NULL KVSTORE reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( store->txn ) {
+      LOG( LOG_WARNING, "Aborting active transaction of KVSTORE: \"%s\"\n", store->path );
+      kvstore_end( store, 0 );
+   }
+   if ( store->lockinit ) { pthread_mutex_destroy( &(store->lock) ); }
+   kvclearops( store );
+   if ( store->ops ) { free( store->ops ); }
+   if ( store->head ) {
+      kvresetindex( store );
+      free( store->head );
+   }
+   int retval = 0;
+   if ( store->logfd >= 0  &&  close( store->logfd ) ) { retval = -1; }
+   if ( store->lockfd >= 0  &&  close( store->lockfd ) ) { retval = -1; }
+   if ( store->path ) { free( store->path ); }
+   free( store );
+   return retval;
+}
+
+/**
+ * Destroy the files of the KVSTORE at the given location
+ * NOTE -- This will fail with errno=ENOTEMPTY if any keys remain in the store.
+ *         The caller must ensure that no other handles to the store remain open.
+ * @param const char* path : Path of the log file of the store
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvstore_destroy( const char* path ) {
+   KVSTORE store = kvstore_open( path, 0 );
+   if ( store == NULL ) {
+      LOG( LOG_ERR, "Failed to open KVSTORE: \"%s\"\n", path );
+      return -1;
+   }
+   if ( store->keycount ) {
+      LOG( LOG_ERR, "Cannot destroy KVSTORE with %zu remaining keys: \"%s\"\n", store->keycount, path );
+      kvstore_close( store );
+      errno = ENOTEMPTY;
+      return -1;
+   }
+   kvstore_close( store );
+   size_t pathlen = strlen( path );
+   char* subpath = malloc( sizeof(char) * (pathlen + 9) );
+   if ( subpath == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate KVSTORE path string\n" );
+      return -1;
+   }
+   snprintf( subpath, pathlen + 9, "%s.compact", path );
+   unlink( subpath ); // ignore any error from this leftover file
+   if ( unlink( path ) ) {
+      LOG( LOG_ERR, "Failed to unlink log file: \"%s\"\n", path );
+      free( subpath );
+      return -1;
+   }
+   snprintf( subpath, pathlen + 9, "%s.lock", path );
+   if ( unlink( subpath ) ) {
+      LOG( LOG_ERR, "Failed to unlink lock file: \"%s\"\n", subpath );
+      free( subpath );
+      return -1;
+   }
+   free( subpath );
+   return 0;
+}
+
+/**
+ * Begin a transaction on the given KVSTORE
+ * NOTE -- All other KVSTORE operations must be issued within a transaction, and only a
+ *         single transaction may be active for a given KVSTORE handle at a time ( this
+ *         call will block until any other transaction completes ).
+ * @param KVSTORE store : Store to begin the transaction on
+ * @param char write : If non-zero, the transaction may modify the store
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvstore_begin( KVSTORE store, char write ) {
+   // check for NULL store
+   if ( store == NULL ) {
+      LOG( LOG_ERR, "Received a NULL KVSTORE reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( pthread_mutex_lock( &(store->lock) ) ) {
+      LOG( LOG_ERR, "Failed to acquire KVSTORE lock\n" );
+      return -1;
+   }
+   if ( flock( store->lockfd, ( write ) ? LOCK_EX : LOCK_SH ) ) {
+      LOG( LOG_ERR, "Failed to acquire lock for KVSTORE: \"%s\"\n", store->path );
+      pthread_mutex_unlock( &(store->lock) );
+      return -1;
+   }
+   // catch up on any changes made by other processes
+   if ( kvrefresh( store ) ) {
+      LOG( LOG_ERR, "Failed to refresh KVSTORE: \"%s\"\n", store->path );
+      flock( store->lockfd, LOCK_UN );
+      pthread_mutex_unlock( &(store->lock) );
+      return -1;
+   }
+   store->txn = ( write ) ? 2 : 1;
+   return 0;
+}
+
+/**
+ * End the active transaction of the given KVSTORE
+ * @param KVSTORE store : Store to end the transaction of
+ * @param char commit : If non-zero, all changes of the transaction will be committed;
+ *                      otherwise, they will be discarded
+ * @return int : Zero on success, or -1 if a failure occurred
+ *               NOTE -- on failure, the changes of the transaction are discarded, but the
+ *                       transaction will still be ended
+ */
+int kvstore_end( KVSTORE store, char commit ) {
+   // check for NULL store
+   if ( store == NULL ) {
+      LOG( LOG_ERR, "Received a NULL KVSTORE reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( store->txn == 0 ) {
+      LOG( LOG_ERR, "No active transaction for KVSTORE: \"%s\"\n", store->path );
+      errno = EINVAL;
+      return -1;
+   }
+   int retval = 0;
+   if ( store->opcount ) {
+      if ( commit  &&  kvcommit( store ) == 0 ) {
+         // rewrite the log, once superseded records dominate it
+         if ( store->deadbytes > KVSTORE_COMPACT_MIN  &&  store->deadbytes > store->loadedoff / 2  &&
+              kvcompact( store ) ) {
+            LOG( LOG_WARNING, "Failed to compact KVSTORE: \"%s\"\n", store->path );
+         }
+      }
+      else {
+         // discard all uncommitted changes, by reloading the index from the log
+         if ( commit ) {
+            LOG( LOG_ERR, "Failed to commit transaction of KVSTORE: \"%s\"\n", store->path );
+            retval = -1;
+         }
+         int errorval = errno;
+         kvresetindex( store );
+         if ( kvreplay( store ) ) {
+            LOG( LOG_ERR, "Failed to reload KVSTORE: \"%s\"\n", store->path );
+            retval = -1;
+         }
+         errno = errorval;
+      }
+      kvclearops( store );
+   }
+   store->txn = 0;
+   flock( store->lockfd, LOCK_UN );
+   pthread_mutex_unlock( &(store->lock) );
+   return retval;
+}
+
+/**
+ * Retrieve the value of the given key
+ * @param KVSTORE store : Store to retrieve from
+ * @param const char* key : Key to retrieve
+ * @param void* buf : Buffer to be populated with the value ( may be NULL, if size is zero )
+ * @param size_t size : Size of the provided buffer
+ * @return ssize_t : Length of the value, or -1 if a failure occurred ( errno=ENOENT, if the
+ *                   key does not exist )
+ *                   NOTE -- if the returned length is greater than the provided buffer size,
+ *                           the buffer will not have been populated
+ */
+ssize_t kvstore_get( KVSTORE store, const char* key, void* buf, size_t size ) {
+   // check for NULL store
+   if ( store == NULL  ||  key == NULL  ||  store->txn == 0 ) {
+      LOG( LOG_ERR, "Received a NULL KVSTORE/key reference or no active transaction\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   kvnode* node = kvfind( store, key, NULL );
+   if ( kvcompare( node, key ) ) {
+      errno = ENOENT;
+      return -1;
+   }
+   if ( node->vallen > size ) { return node->vallen; }
+   if ( node->pendval ) {
+      memcpy( buf, node->pendval, node->vallen );
+   }
+   else if ( node->vallen  &&  pread( store->logfd, buf, node->vallen, node->valoff ) != node->vallen ) {
+      LOG( LOG_ERR, "Failed to read value of key \"%s\"\n", key );
+      return -1;
+   }
+   return node->vallen;
+}
+
+/**
+ * Set the value of the given key ( write transactions only )
+ * @param KVSTORE store : Store to modify
+ * @param const char* key : Key to be set
+ * @param const void* val : Value to be associated with the key
+ * @param size_t len : Length of the value
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvstore_put( KVSTORE store, const char* key, const void* val, size_t len ) {
+   // check for NULL store
+   if ( store == NULL  ||  key == NULL  ||  *key == '\0'  ||  store->txn != 2  ||
+        len >= KVSTORE_TOMBSTONE  ||  ( val == NULL  &&  len ) ) {
+      LOG( LOG_ERR, "Received invalid args or no active write transaction\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   size_t keylen = strlen( key );
+   kvop* op = kvaddop( store, key, keylen, ( len ) ? val : "", len );
+   if ( op == NULL ) {
+      LOG( LOG_ERR, "Failed to record put of key \"%s\"\n", key );
+      return -1;
+   }
+   kvnode* prev[KVSTORE_MAXLEVEL];
+   kvnode* node = kvfind( store, key, prev );
+   if ( kvcompare( node, key ) ) {
+      node = kvinsert( store, key, keylen, prev );
+      if ( node == NULL ) {
+         LOG( LOG_ERR, "Failed to insert index entry for key \"%s\"\n", key );
+         store->opcount--;
+         free( op->key );
+         free( op->val );
+         return -1;
+      }
+   }
+   else {
+      // the previous value of this key will be superseded
+      store->txndead += KVSTORE_RECSIZE( keylen, node->vallen );
+      if ( node->pendval ) { free( node->pendval ); }
+   }
+   // the index takes a reference to a copy of the value
+   node->pendval = malloc( len + 1 );
+   if ( node->pendval == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate pending value of key \"%s\"\n", key );
+      kvremove( store, node, prev );
+      store->opcount--;
+      free( op->key );
+      free( op->val );
+      return -1;
+   }
+   memcpy( node->pendval, op->val, len );
+   node->vallen = len;
+   node->pendop = store->opcount - 1;
+   return 0;
+}
+
+/**
+ * Remove the given key ( write transactions only )
+ * @param KVSTORE store : Store to modify
+ * @param const char* key : Key to be removed
+ * @return int : Zero on success, or -1 if a failure occurred ( errno=ENOENT, if the key
+ *               does not exist )
+ */
+int kvstore_delete( KVSTORE store, const char* key ) {
+   // check for NULL store
+   if ( store == NULL  ||  key == NULL  ||  store->txn != 2 ) {
+      LOG( LOG_ERR, "Received a NULL KVSTORE/key reference or no active write transaction\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   kvnode* prev[KVSTORE_MAXLEVEL];
+   kvnode* node = kvfind( store, key, prev );
+   if ( kvcompare( node, key ) ) {
+      errno = ENOENT;
+      return -1;
+   }
+   size_t keylen = strlen( key );
+   if ( kvaddop( store, key, keylen, NULL, KVSTORE_TOMBSTONE ) == NULL ) {
+      LOG( LOG_ERR, "Failed to record deletion of key \"%s\"\n", key );
+      return -1;
+   }
+   // both the previous value and the deletion record itself will be superseded
+   store->txndead += KVSTORE_RECSIZE( keylen, node->vallen ) + KVSTORE_RECSIZE( keylen, 0 );
+   kvremove( store, node, prev );
+   return 0;
+}
+
+/**
+ * Identify the first key following the given position, in sorted ( strcmp ) order
+ * @param KVSTORE store : Store to search
+ * @param const char* from : Starting position of the search ( NULL to start from the first key )
+ * @param char inclusive : If non-zero, a key exactly matching 'from' may be returned
+ * @param char* buf : Buffer to be populated with the resulting key
+ * @param size_t size : Size of the provided buffer
+ * @return ssize_t : Length of the resulting key, zero if no further keys exist, or -1 if a
+ *                   failure occurred
+ *                   NOTE -- if the returned length is >= the provided buffer size, the
+ *                           buffer will not have been populated
+ */
+ssize_t kvstore_nextkey( KVSTORE store, const char* from, char inclusive, char* buf, size_t size ) {
+   // check for NULL store
+   if ( store == NULL  ||  store->txn == 0 ) {
+      LOG( LOG_ERR, "Received a NULL KVSTORE reference or no active transaction\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   kvnode* node = ( from ) ? kvfind( store, from, NULL ) : store->head->next[0];
+   if ( from  &&  !(inclusive)  &&  kvcompare( node, from ) == 0 ) { node = node->next[0]; }
+   if ( node == NULL ) { return 0; }
+   if ( node->keylen < size ) { memcpy( buf, node->key, node->keylen + 1 ); }
+   return node->keylen;
+}
+
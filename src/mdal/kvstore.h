@@ -0,0 +1,170 @@
+#ifndef _KVSTORE_H
+#define _KVSTORE_H
+/*
+Copyright (c) 2015, Los Alamos National Security, LLC
+All rights reserved.
+
+Copyright 2015.  Los Alamos National Security, LLC. This software was
+produced under U.S. Government contract DE-AC52-06NA25396 for Los
+Alamos National Laboratory (LANL), which is operated by Los Alamos
+National Security, LLC for the U.S. Department of Energy. The
+U.S. Government has rights to use, reproduce, and distribute this
+software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL SECURITY,
+LLC MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY
+FOR THE USE OF THIS SOFTWARE.  If software is modified to produce
+derivative works, such modified software should be clearly marked, so
+as not to confuse it with the version available from LANL.
+ 
+Additionally, redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the following
+conditions are met: 1. Redistributions of source code must retain the
+above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of Los Alamos National Security, LLC, Los Alamos
+National Laboratory, LANL, the U.S. Government, nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL LOS
+ALAMOS NATIONAL SECURITY, LLC OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-----
+NOTE:
+-----
+MarFS is released under the BSD license.
+
+MarFS was reviewed and released by LANL under Los Alamos Computer Code
+identifier: LA-CC-15-039.
+
+MarFS uses libaws4c for Amazon S3 object communication. The original version
+is at https://aws.amazon.com/code/Amazon-S3/2601 and under the LGPL license.
+LANL added functionality to the original work. The original work plus
+LANL contributions is found at https://github.com/jti-lanl/aws4c.
+
+GNU licenses can be found at http://www.gnu.org/licenses/.
+*/
+
+#include <stdlib.h>
+#include <sys/types.h>
+
+// An embedded, log-structured key/value store.
+// All records reside in a single append-only log file, with a sorted in-memory index of
+// committed keys.  Changes are grouped into transactions, each of which is appended to the
+// log as a single checksummed batch ( a partially written batch is ignored on replay ).
+// Multiple processes may safely share a store : each transaction holds a flock() on a
+// companion lock file, then catches up on any batches appended by other processes.
+// Once the log is dominated by superseded records, it is rewritten in place.
+
+typedef struct kvstore_struct* KVSTORE;
+
+/**
+ * Open the KVSTORE at the given location
+ * @param const char* path : Path of the log file of the store
+ *                           NOTE -- the store will also make use of "<path>.lock"
+ *                                   and "<path>.compact" files
+ * @param char create : If non-zero, the store will be created, if it does not yet exist
+ * @return KVSTORE : Reference to the open KVSTORE, or NULL if a failure occurred
+ */
+KVSTORE kvstore_open( const char* path, char create );
+
+/**
+ * Close the given KVSTORE
+ * @param KVSTORE store : Store to be closed
+ *                        NOTE -- any uncommitted transaction will be aborted
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvstore_close( KVSTORE store );
+
+/**
+ * Destroy the files of the KVSTORE at the given location
+ * NOTE -- This will fail with errno=ENOTEMPTY if any keys remain in the store.
+ *         The caller must ensure that no other handles to the store remain open.
+ * @param const char* path : Path of the log file of the store
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvstore_destroy( const char* path );
+
+/**
+ * Begin a transaction on the given KVSTORE
+ * NOTE -- All other KVSTORE operations must be issued within a transaction, and only a
+ *         single transaction may be active for a given KVSTORE handle at a time ( this
+ *         call will block until any other transaction completes ).
+ * @param KVSTORE store : Store to begin the transaction on
+ * @param char write : If non-zero, the transaction may modify the store
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvstore_begin( KVSTORE store, char write );
+
+/**
+ * End the active transaction of the given KVSTORE
+ * @param KVSTORE store : Store to end the transaction of
+ * @param char commit : If non-zero, all changes of the transaction will be committed;
+ *                      otherwise, they will be discarded
+ * @return int : Zero on success, or -1 if a failure occurred
+ *               NOTE -- on failure, the changes of the transaction are discarded, but the
+ *                       transaction will still be ended
+ */
+int kvstore_end( KVSTORE store, char commit );
+
+/**
+ * Retrieve the value of the given key
+ * @param KVSTORE store : Store to retrieve from
+ * @param const char* key : Key to retrieve
+ * @param void* buf : Buffer to be populated with the value ( may be NULL, if size is zero )
+ * @param size_t size : Size of the provided buffer
+ * @return ssize_t : Length of the value, or -1 if a failure occurred ( errno=ENOENT, if the
+ *                   key does not exist )
+ *                   NOTE -- if the returned length is greater than the provided buffer size,
+ *                           the buffer will not have been populated
+ */
+ssize_t kvstore_get( KVSTORE store, const char* key, void* buf, size_t size );
+
+/**
+ * Set the value of the given key ( write transactions only )
+ * @param KVSTORE store : Store to modify
+ * @param const char* key : Key to be set
+ * @param const void* val : Value to be associated with the key
+ * @param size_t len : Length of the value
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int kvstore_put( KVSTORE store, const char* key, const void* val, size_t len );
+
+/**
+ * Remove the given key ( write transactions only )
+ * @param KVSTORE store : Store to modify
+ * @param const char* key : Key to be removed
+ * @return int : Zero on success, or -1 if a failure occurred ( errno=ENOENT, if the key
+ *               does not exist )
+ */
+int kvstore_delete( KVSTORE store, const char* key );
+
+/**
+ * Identify the first key following the given position, in sorted ( strcmp ) order
+ * @param KVSTORE store : Store to search
+ * @param const char* from : Starting position of the search ( NULL to start from the first key )
+ * @param char inclusive : If non-zero, a key exactly matching 'from' may be returned
+ * @param char* buf : Buffer to be populated with the resulting key
+ * @param size_t size : Size of the provided buffer
+ * @return ssize_t : Length of the resulting key, zero if no further keys exist, or -1 if a
+ *                   failure occurred
+ *                   NOTE -- if the returned length is >= the provided buffer size, the
+ *                           buffer will not have been populated
+ */
+ssize_t kvstore_nextkey( KVSTORE store, const char* from, char inclusive, char* buf, size_t size );
+
+#endif // _KVSTORE_H
+
@@ -109,6 +109,9 @@ MDAL init_mdal( xmlNode* mdal_conf_root ) {
    if (  strncasecmp( (char*)typetxt->content, "posix", 6 ) == 0 ) {
       return posix_mdal_init( mdal_conf_root->children );
    }
+   else if (  strncasecmp( (char*)typetxt->content, "posixkv", 8 ) == 0 ) {
+      return posixkv_mdal_init( mdal_conf_root->children );
+   }
 
    // if no MDAL found, return NULL
    LOG( LOG_ERR, "failed to identify an MDAL of type: \"%s\"\n", typetxt->content );
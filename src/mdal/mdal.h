@@ -353,6 +353,26 @@ typedef struct MDAL_struct {
     */
    MDAL_FHANDLE (*openref) ( const MDAL_CTXT ctxt, const char* rpath, int flags, mode_t mode );
 
+   /**
+    * Create a new file at the specified reference path and link it into the user namespace
+    * NOTE -- The new file will not be visible, at either path, until the 'populate' function
+    *         has successfully completed.  This allows the caller to attach metadata ( such as
+    *         xattrs ) to the file without any other process observing a partial state.
+    *         Any existing file at 'userpath' will be replaced.  If this function fails, no
+    *         trace of the new file will remain.  The rpath must not already exist.
+    * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+    * @param const char* rpath : String reference path of the new file
+    * @param mode_t mode : Mode value for file creation (see the 'open()' syscall 'mode' value for full info)
+    * @param const char* userpath : User-visible path at which to link the new file
+    * @param int (*populate)( MDAL_FHANDLE fh, void* arg ) : Function to be called on the new file
+    *                                                        prior to it becoming visible
+    *                                                        ( may be NULL )
+    * @param void* arg : Argument to be passed to the populate function
+    * @return MDAL_FHANDLE : An MDAL_WRITE handle for the new file, or NULL if a failure occurred
+    */
+   MDAL_FHANDLE (*createref) ( const MDAL_CTXT ctxt, const char* rpath, mode_t mode, const char* userpath,
+                               int (*populate)( MDAL_FHANDLE fh, void* arg ), void* arg );
+
 
    // Scanner Functions
 
@@ -479,6 +499,19 @@ typedef struct MDAL_struct {
     */
    struct dirent* (*readdir) ( MDAL_DHANDLE dh );
 
+   /**
+    * Iterate to the next entry of an open directory handle, also retrieving stat info for that entry
+    * NOTE -- The entry is stat'd relative to the open directory, without following symlinks.
+    *         Entries which are removed prior to being stat'd are silently skipped.
+    *         Calls to this function may be freely intermixed with calls to readdir().
+    * @param MDAL_DHANDLE dh : MDAL_DHANDLE to read from
+    * @param struct stat* st : Stat structure to be populated with info for the returned entry
+    * @return struct dirent* : Reference to the next dirent struct, or NULL w/ errno unset
+    *                          if all entries have been read, or NULL w/ errno set if a
+    *                          failure occurred
+    */
+   struct dirent* (*readdirplus) ( MDAL_DHANDLE dh, struct stat* st );
+
    /**
     * Close the given directory handle
     * @param MDAL_DHANDLE dh : MDAL_DHANDLE to close
@@ -768,6 +801,7 @@ typedef struct MDAL_struct {
 
 // Forward decls of specific MDAL initializations
 MDAL posix_mdal_init( xmlNode* posix_mdal_conf_root );
+MDAL posixkv_mdal_init( xmlNode* posixkv_mdal_conf_root );
 
 
 // Function to provide specific MDAL initialization calls based on name
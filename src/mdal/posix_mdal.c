@@ -59,6 +59,10 @@ LANL contributions is found at https://github.com/jti-lanl/aws4c.
 GNU licenses can be found at http://www.gnu.org/licenses/.
 */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // for O_TMPFILE and AT_EMPTY_PATH
+#endif
+
 #include "marfs_auto_config.h"
 #ifdef DEBUG_MDAL
 #define DEBUG DEBUG_MDAL
@@ -76,6 +80,10 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 #include <dirent.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
 
 
 //   -------------    POSIX DEFINITIONS    -------------
@@ -87,6 +95,7 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 #define PMDAL_DUSE PMDAL_PREFX"datasize"
 #define PMDAL_IUSE PMDAL_PREFX"inodecount"
 #define PMDAL_XATTR "user."PMDAL_PREFX
+#define PMDAL_SHARDS PMDAL_PREFX"shardspaces" // subdir of non-primary roots, holding hosted NS dirs
 
 
 //   -------------    POSIX STRUCTURES    -------------
@@ -103,10 +112,18 @@ typedef struct posixmdal_file_handle_struct {
    int        fd; // File handle
 }* POSIX_FHANDLE;
 
+typedef struct posix_mdal_shards_struct {
+   int     count;     // Count of metadata roots ( the primary 'ns_root' plus all 'ns_shard' roots )
+   int*    rootfds;   // Dir handles of each root ( index zero is the primary root )
+   char**  rootpaths; // Absolute paths of each root
+}* POSIX_MDAL_SHARDS;
+
 typedef struct posix_mdal_context_struct {
    int refd;   // Dir handle for NS ref tree ( or the secure root, if NS hasn't been set )
    int pathd;  // Dir handle of the user tree for the current NS ( or -1, if NS hasn't been set )
    dev_t dev;  // Device ID value associated with this context ( try to avoid accessing a non-marfs path )
+   POSIX_MDAL_SHARDS shards; // Multi-root info, owned by the MDAL itself ( NULL if single-root )
+   char* nsabs; // Absolute path of the current NS ( only tracked for multi-root MDALs )
 }* POSIX_MDAL_CTXT;
    
 
@@ -185,6 +202,191 @@ size_t namespacepath( const char* nspath, char* newpath, size_t newlen ) {
 }
 
 
+/**
+ * Produce the normalized, absolute form of the given NS path
+ * @param POSIX_MDAL_CTXT pctxt : Context the NS path is relative to
+ * @param const char* ns : NS path
+ * @return char* : Absolute NS path ( "/." for the root NS ), or NULL if a failure occurred
+ *                 NOTE -- returned string must be freed by caller
+ */
+char* absolutens( POSIX_MDAL_CTXT pctxt, const char* ns ) {
+   // identify the base path of our output
+   const char* base = "";
+   if ( *ns == '/' ) {
+      if ( pctxt->pathd >= 0 ) {
+         LOG( LOG_ERR, "Absolute NS paths can only be used from a CTXT with no NS set\n" );
+         errno = EINVAL;
+         return NULL;
+      }
+   }
+   else {
+      if ( pctxt->pathd < 0  ||  pctxt->nsabs == NULL ) {
+         LOG( LOG_ERR, "Relative NS paths can only be used from a CTXT with a NS set\n" );
+         errno = EINVAL;
+         return NULL;
+      }
+      base = pctxt->nsabs;
+   }
+   // the result can never exceed the length of the two strings combined
+   size_t alloclen = strlen( base ) + strlen( ns ) + 3;
+   char* absns = malloc( sizeof(char) * alloclen );
+   if ( absns == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate absolute path string for NS: \"%s\"\n", ns );
+      return NULL;
+   }
+   size_t abslen = 0;
+   // append each element of both the base and NS strings
+   const char* parse = base;
+   int pass = 0;
+   for ( ; pass < 2; pass++ ) {
+      if ( pass ) { parse = ns; }
+      while ( *parse != '\0' ) {
+         while ( *parse == '/' ) { parse++; }
+         const char* elemref = parse;
+         size_t elemlen = 0;
+         while ( *parse != '/'  &&  *parse != '\0' ) { parse++; elemlen++; }
+         if ( elemlen == 0  ||  ( elemlen == 1  &&  *elemref == '.' ) ) {
+            continue; // no change to the current path
+         }
+         if ( elemlen == 2  &&  strncmp( elemref, "..", 2 ) == 0 ) {
+            if ( abslen == 0 ) {
+               LOG( LOG_ERR, "NS path \"%s\" traverses above the root NS\n", ns );
+               free( absns );
+               errno = EINVAL;
+               return NULL;
+            }
+            // remove the previous path element
+            while ( abslen  &&  absns[abslen - 1] != '/' ) { abslen--; }
+            abslen--;
+            continue;
+         }
+         absns[abslen] = '/';
+         memcpy( absns + abslen + 1, elemref, elemlen );
+         abslen += elemlen + 1;
+      }
+   }
+   if ( abslen == 0 ) {
+      // the root NS is represented as "/."
+      absns[0] = '/';
+      absns[1] = '.';
+      abslen = 2;
+   }
+   absns[abslen] = '\0';
+   return absns;
+}
+
+/**
+ * Identify the metadata root which should host the given NS
+ * NOTE -- A NS assigned to the primary root ( index zero ) is simply created within the
+ *         subspace dir of its parent, and will therefore reside with that parent NS.
+ * @param POSIX_MDAL_SHARDS shards : Multi-root info of the MDAL
+ * @param const char* absns : Absolute NS path ( see absolutens() )
+ * @return int : Index of the root which should host the NS
+ */
+int namespacehome( POSIX_MDAL_SHARDS shards, const char* absns ) {
+   // the root NS anchors the entire hierarchy, and so must reside on the primary root
+   if ( strcmp( absns, "/." ) == 0 ) { return 0; }
+   // FNV-1a hash of the NS path
+   uint64_t hashval = 14695981039346656037ULL;
+   for ( ; *absns != '\0'; absns++ ) {
+      hashval ^= (unsigned char)(*absns);
+      hashval *= 1099511628211ULL;
+   }
+   return (int)( hashval % (uint64_t)shards->count );
+}
+
+/**
+ * Generate the posix path of the given NS, and identify the dir that path is relative to
+ * NOTE -- For multi-root MDALs, all NS paths are translated to absolute paths and resolved
+ *         via the primary root.  Subspaces residing on other roots are reached via symlinks
+ *         in the subspace dir of their parent NS.
+ * @param POSIX_MDAL_CTXT pctxt : Context the NS path is relative to
+ * @param const char* ns : NS path
+ * @param size_t extra : Count of additional chars to allocate beyond the end of the path
+ * @param char** nspath : Reference to be populated with the generated path
+ *                        NOTE -- returned string must be freed by caller
+ *                                absolute paths will retain a leading '/' char
+ * @param int* basefd : Reference to be populated with the dir the path is relative to
+ * @return size_t : Length of the generated path, or zero if a failure occurred
+ */
+size_t resolvenamespace( POSIX_MDAL_CTXT pctxt, const char* ns, size_t extra, char** nspath, int* basefd ) {
+   const char* tgtns = ns;
+   char* absns = NULL;
+   if ( pctxt->shards ) {
+      // multi-root MDALs always operate on absolute NS paths
+      absns = absolutens( pctxt, ns );
+      if ( absns == NULL ) {
+         LOG( LOG_ERR, "Failed to identify absolute path of NS: \"%s\"\n", ns );
+         return 0;
+      }
+      tgtns = absns;
+   }
+   // create the corresponding posix path for the target NS
+   size_t nspathlen = namespacepath( tgtns, NULL, 0 );
+   if ( nspathlen == 0 ) {
+      LOG( LOG_ERR, "Failed to identify corresponding path for NS: \"%s\"\n", ns );
+      if ( absns ) { free( absns ); }
+      return 0;
+   }
+   char* newpath = malloc( sizeof(char) * (nspathlen + 1 + extra) );
+   if ( !(newpath) ) {
+      LOG( LOG_ERR, "Failed to allocate path string for NS: \"%s\"\n", ns );
+      if ( absns ) { free( absns ); }
+      return 0;
+   }
+   if ( namespacepath( tgtns, newpath, nspathlen + 1 ) != nspathlen ) {
+      LOG( LOG_ERR, "Inconsistent path generation for NS: \"%s\"\n", ns );
+      free( newpath );
+      if ( absns ) { free( absns ); }
+      return 0;
+   }
+   if ( absns ) {
+      // all multi-root paths are resolved via the primary root
+      free( absns );
+      *basefd = pctxt->shards->rootfds[0];
+      *nspath = newpath;
+      return nspathlen;
+   }
+   // abort if the CTXT isn't in an appropriate state
+   if ( *newpath == '/' ) {
+      // ensure the refd is set to the secureroot dir
+      if ( pctxt->pathd >= 0 ) {
+         LOG( LOG_ERR, "Absolute NS paths can only be used from a CTXT with no NS set\n" );
+         errno = EINVAL;
+         free( newpath );
+         return 0;
+      }
+   }
+   else {
+      // ensure the refd is set to an actual reference dir
+      if ( pctxt->pathd < 0 ) {
+         LOG( LOG_ERR, "Relative NS paths can only be used from a CTXT with a NS set\n" );
+         errno = EINVAL;
+         free( newpath );
+         return 0;
+      }
+   }
+   *basefd = pctxt->refd;
+   *nspath = newpath;
+   return nspathlen;
+}
+
+/**
+ * Free the given multi-root info struct
+ * @param POSIX_MDAL_SHARDS shards : Multi-root info to be freed
+ */
+void freeshards( POSIX_MDAL_SHARDS shards ) {
+   int index = 0;
+   for ( ; index < shards->count; index++ ) {
+      if ( shards->rootfds  &&  shards->rootfds[index] >= 0 ) { close( shards->rootfds[index] ); }
+      if ( shards->rootpaths  &&  shards->rootpaths[index] ) { free( shards->rootpaths[index] ); }
+   }
+   if ( shards->rootfds ) { free( shards->rootfds ); }
+   if ( shards->rootpaths ) { free( shards->rootpaths ); }
+   free( shards );
+}
+
+
 /**
  * Identify if the given xattr name is targeting a reserved value
  * @param const char* name : Xattr name string
@@ -279,6 +481,7 @@ int posixmdal_destroyctxt ( MDAL_CTXT ctxt ) {
       LOG( LOG_ERR, "Failed to close some dir references\n" );
       errorflag = 1;
    }
+   if ( pctxt->nsabs ) { free( pctxt->nsabs ); }
    free( pctxt );
    if ( errorflag ) {
       return -1;
@@ -316,6 +519,15 @@ MDAL_CTXT posixmdal_dupctxt ( const MDAL_CTXT ctxt ) {
       return NULL;
    }
    dupctxt->dev = pctxt->dev;
+   dupctxt->shards = pctxt->shards;
+   dupctxt->nsabs = NULL;
+   if ( pctxt->nsabs  &&  (dupctxt->nsabs = strdup( pctxt->nsabs )) == NULL ) {
+      LOG( LOG_ERR, "Failed to duplicate NS path of ctxt\n" );
+      close( dupctxt->refd );
+      if ( dupctxt->pathd >= 0 ) { close( dupctxt->pathd ); }
+      free( dupctxt );
+      return NULL;
+   }
    return (MDAL_CTXT) dupctxt;
 }
 
@@ -336,41 +548,29 @@ int posixmdal_cleanup( MDAL mdal ) {
    }
    // destroy the MDAL_CTXT struct
    int retval = 0;
+   POSIX_MDAL_SHARDS shards = ((POSIX_MDAL_CTXT)mdal->ctxt)->shards;
    if ( posixmdal_destroyctxt( mdal->ctxt ) ) {
       LOG( LOG_ERR, "Failed to destroy the MDAL_CTXT reference\n" );
       retval = -1;
    }
+   // destroy any multi-root info ( all other CTXTs must have been destroyed by now )
+   if ( shards ) { freeshards( shards ); }
    // free the entire MDAL
    free( mdal );
    return retval;
 }
 
 /**
- * Verify security of the given MDAL_CTXT
- * @param const MDAL_CTXT ctxt : MDAL_CTXT for which to verify security
- *                               NOTE -- this ctxt CANNOT be associated with a NS target
- *                                       ( it must be freshly initialized )
+ * Verify security of the given MDAL root dir
+ * @param int rootfd : Root dir for which to verify security
  * @param char fix : If non-zero, attempt to correct any problems encountered
  * @return int : A count of uncorrected security issues, or -1 if a failure occurred
  */
-int posixmdal_checksec( const MDAL_CTXT ctxt, char fix ) {
-   // check for NULL ctxt
-   if ( !(ctxt) ) {
-      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
-      errno = EINVAL;
-      return -1;
-   }
-   POSIX_MDAL_CTXT pctxt = (POSIX_MDAL_CTXT) ctxt;
-   // verify that this CTXT doesn't have a NS target
-   if ( pctxt->pathd >= 0 ) {
-      LOG( LOG_ERR, "Cannot verify the security of a CTXT after it has been associated with a NS target\n" );
-      errno = EINVAL;
-      return -1;
-   }
-   // stat the CTXT root dir
+int checkrootsec( int rootfd, char fix ) {
+   // stat the root dir
    struct stat pstat;
-   if ( fstatat( pctxt->refd, ".", &pstat, 0 ) ) {
-      LOG( LOG_ERR, "Failed to stat the root dir of the given MDAL_CTXT\n" );
+   if ( fstatat( rootfd, ".", &pstat, 0 ) ) {
+      LOG( LOG_ERR, "Failed to stat the given root dir\n" );
       return -1;
    }
    // set up our parent string
@@ -381,7 +581,7 @@ int posixmdal_checksec( const MDAL_CTXT ctxt, char fix ) {
       return -1;
    }
    size_t pstrlen = 0;
-   // iterate up from the CTXT root dir, potentially to the FS root
+   // iterate up from the root dir, potentially to the FS root
    char foundsecdir = 0;
    dev_t prevdev = pstat.st_dev;
    ino_t previno = pstat.st_ino;
@@ -408,7 +608,7 @@ int posixmdal_checksec( const MDAL_CTXT ctxt, char fix ) {
       }
       pstrlen += 3;
       // stat the next parent dir
-      if ( fstatat( pctxt->refd, parentstr, &pstat, 0 ) ) {
+      if ( fstatat( rootfd, parentstr, &pstat, 0 ) ) {
          LOG( LOG_ERR, "Failed to stat parent dir: \"%s\"\n", parentstr );
          free( parentstr );
          return -1;
@@ -431,12 +631,12 @@ int posixmdal_checksec( const MDAL_CTXT ctxt, char fix ) {
       if ( fix ) {
          // attempt to chown/chmod the direct parent to appropriate perms
          LOG( LOG_INFO, "Chowning \"..\" to current UID/GID\n" );
-         if ( fchownat( pctxt->refd, "..", uid, gid, 0 ) ) {
+         if ( fchownat( rootfd, "..", uid, gid, 0 ) ) {
             LOG( LOG_ERR, "Failed to chown \"..\" to current UID/GID\n" );
             return 1;
          }
          LOG( LOG_INFO, "Chmoding \"..\" to 0700 mode\n" );
-         if ( fchmodat( pctxt->refd, "..", 0700, 0 ) ) {
+         if ( fchmodat( rootfd, "..", 0700, 0 ) ) {
             LOG( LOG_ERR, "Failed to chmod \"..\" to 0700 mode\n" );
             return 1;
          }
@@ -450,6 +650,44 @@ int posixmdal_checksec( const MDAL_CTXT ctxt, char fix ) {
 }
 
 
+/**
+ * Verify security of the given MDAL_CTXT
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT for which to verify security
+ *                               NOTE -- this ctxt CANNOT be associated with a NS target
+ *                                       ( it must be freshly initialized )
+ * @param char fix : If non-zero, attempt to correct any problems encountered
+ * @return int : A count of uncorrected security issues, or -1 if a failure occurred
+ */
+int posixmdal_checksec( const MDAL_CTXT ctxt, char fix ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIX_MDAL_CTXT pctxt = (POSIX_MDAL_CTXT) ctxt;
+   // verify that this CTXT doesn't have a NS target
+   if ( pctxt->pathd >= 0 ) {
+      LOG( LOG_ERR, "Cannot verify the security of a CTXT after it has been associated with a NS target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // verify the root dir of this CTXT
+   int retval = checkrootsec( pctxt->refd, fix );
+   if ( retval < 0  ||  pctxt->shards == NULL ) { return retval; }
+   // verify any additional roots
+   int index = 1;
+   for ( ; index < pctxt->shards->count; index++ ) {
+      int rootres = checkrootsec( pctxt->shards->rootfds[index], fix );
+      if ( rootres < 0 ) {
+         LOG( LOG_ERR, "Failed to verify security of root: \"%s\"\n", pctxt->shards->rootpaths[index] );
+         return -1;
+      }
+      retval += rootres;
+   }
+   return retval;
+}
+
 // Namespace Functions
 
 /**
@@ -467,47 +705,25 @@ int posixmdal_setnamespace( MDAL_CTXT ctxt, const char* ns ) {
    }
    POSIX_MDAL_CTXT pctxt = (POSIX_MDAL_CTXT) ctxt;
    // create the corresponding posix path for the target NS
-   size_t nspathlen = namespacepath( ns, NULL, 0 );
-   if ( nspathlen == 0 ) {
-      LOG( LOG_ERR, "Failed to identify corresponding path for NS: \"%s\"\n", ns );
-      return -1;
-   }
-   char* nspath = malloc( sizeof(char) * (nspathlen + 1) );
-   if ( !(nspath) ) {
-      LOG( LOG_ERR, "Failed to allocate path string for NS: \"%s\"\n", ns );
+   int basefd = -1;
+   char* nspath = NULL;
+   if ( resolvenamespace( pctxt, ns, 0, &(nspath), &(basefd) ) == 0 ) {
+      LOG( LOG_ERR, "Failed to resolve path of NS: \"%s\"\n", ns );
       return -1;
    }
-   if ( namespacepath( ns, nspath, nspathlen + 1 ) != nspathlen ) {
-      LOG( LOG_ERR, "Inconsistent path generation for NS: \"%s\"\n", ns );
+   // track the absolute NS path of multi-root ctxts
+   char* newnsabs = NULL;
+   if ( pctxt->shards  &&  (newnsabs = absolutens( pctxt, ns )) == NULL ) {
+      LOG( LOG_ERR, "Failed to identify absolute path of NS: \"%s\"\n", ns );
       free( nspath );
       return -1;
    }
    // open the new path dir, according to the target NS path
-   int newpath;
-   if ( *nspath == '/' ) {
-      // ensure the refd is set to the secureroot dir
-      if ( pctxt->pathd >= 0 ) {
-         LOG( LOG_ERR, "Absolute NS paths can only be used from a CTXT with no NS set\n" );
-         errno = EINVAL;
-         free( nspath );
-         return -1;
-      }
-      // absoulute paths are opened via the root dir (skipping the leading '/')
-      newpath = openat( pctxt->refd, (nspath + 1), O_RDONLY );
-   }
-   else {
-      // ensure the refd is set to an actual reference dir
-      if ( pctxt->pathd < 0 ) {
-         LOG( LOG_ERR, "Relative NS paths can only be used from a CTXT with a NS set\n" );
-         errno = EINVAL;
-         free( nspath );
-         return -1;
-      }
-      // relative paths are opened via the ref dir of the basectxt
-      newpath = openat( pctxt->refd, nspath, O_RDONLY );
-   }
+   //   NOTE -- absolute paths are opened via the root dir (skipping the leading '/')
+   int newpath = openat( basefd, (*nspath == '/') ? (nspath + 1) : nspath, O_RDONLY );
    if ( newpath < 0 ) {
       LOG( LOG_ERR, "Failed to open the user path dir: \"%s\"\n", nspath );
+      if ( newnsabs ) { free( newnsabs ); }
       free( nspath );
       return -1;
    }
@@ -516,6 +732,7 @@ int posixmdal_setnamespace( MDAL_CTXT ctxt, const char* ns ) {
    int newref = openat( newpath, PMDAL_REF, O_RDONLY );
    if ( newref < 0 ) {
       LOG( LOG_ERR, "Failed to open the ref dir of NS \"%s\"\n", ns );
+      if ( newnsabs ) { free( newnsabs ); }
       close( newpath );
       return -1;
    }
@@ -523,6 +740,7 @@ int posixmdal_setnamespace( MDAL_CTXT ctxt, const char* ns ) {
    struct stat stval;
    if ( fstat( newref, &(stval) ) ) {
       LOG( LOG_ERR, "Failed to stat reference dir of NS \"%s\"\n", ns );
+      if ( newnsabs ) { free( newnsabs ); }
       close( newref );
       close( newpath );
       return -1;
@@ -538,6 +756,8 @@ int posixmdal_setnamespace( MDAL_CTXT ctxt, const char* ns ) {
    }
    pctxt->refd = newref; // update the context structure
    pctxt->dev = stval.st_dev;
+   if ( pctxt->nsabs ) { free( pctxt->nsabs ); }
+   pctxt->nsabs = newnsabs;
    return 0;
 }
 
@@ -562,19 +782,10 @@ MDAL_CTXT posixmdal_newctxt ( const char* ns, const MDAL_CTXT basectxt ) {
    }
    POSIX_MDAL_CTXT pbasectxt = (POSIX_MDAL_CTXT) basectxt;
    // create the corresponding posix path for the target NS
-   size_t nspathlen = namespacepath( ns, NULL, 0 );
-   if ( nspathlen == 0 ) {
-      LOG( LOG_ERR, "Failed to identify corresponding path for NS: \"%s\"\n", ns );
-      return NULL;
-   }
-   char* nspath = malloc( sizeof(char) * (nspathlen + 1) );
-   if ( !(nspath) ) {
-      LOG( LOG_ERR, "Failed to allocate path string for NS: \"%s\"\n", ns );
-      return NULL;
-   }
-   if ( namespacepath( ns, nspath, nspathlen + 1 ) != nspathlen ) {
-      LOG( LOG_ERR, "Inconsistent path generation for NS: \"%s\"\n", ns );
-      free( nspath );
+   int basefd = -1;
+   char* nspath = NULL;
+   if ( resolvenamespace( pbasectxt, ns, 0, &(nspath), &(basefd) ) == 0 ) {
+      LOG( LOG_ERR, "Failed to resolve path of NS: \"%s\"\n", ns );
       return NULL;
    }
    // create a new ctxt structure
@@ -584,33 +795,21 @@ MDAL_CTXT posixmdal_newctxt ( const char* ns, const MDAL_CTXT basectxt ) {
       free( nspath );
       return NULL;
    }
-   // open the path dir, according to the target NS path
-   if ( *nspath == '/' ) {
-      // ensure the pbasectxt is set to the secureroot dir
-      if ( pbasectxt->pathd >= 0 ) {
-         LOG( LOG_ERR, "Absolute NS paths can only be used from a CTXT with no NS set\n" );
-         errno = EINVAL;
-         free( newctxt );
-         free( nspath );
-         return NULL;
-      }
-      // absoulute paths are opened via the root dir (skipping the leading '/')
-      newctxt->pathd = openat( pbasectxt->refd, (nspath + 1), O_RDONLY );
-   }
-   else {
-      // ensure the refd is set to an actual reference dir
-      if ( pbasectxt->pathd < 0 ) {
-         LOG( LOG_ERR, "Relative NS paths can only be used from a CTXT with a NS set\n" );
-         errno = EINVAL;
-         free( newctxt );
-         free( nspath );
-         return NULL;
-      }
-      // relative paths are opened via the ref dir of the pbasectxt
-      newctxt->pathd = openat( pbasectxt->refd, nspath, O_RDONLY );
+   newctxt->shards = pbasectxt->shards;
+   newctxt->nsabs = NULL;
+   // track the absolute NS path of multi-root ctxts
+   if ( newctxt->shards  &&  (newctxt->nsabs = absolutens( pbasectxt, ns )) == NULL ) {
+      LOG( LOG_ERR, "Failed to identify absolute path of NS: \"%s\"\n", ns );
+      free( newctxt );
+      free( nspath );
+      return NULL;
    }
+   // open the path dir, according to the target NS path
+   //   NOTE -- absolute paths are opened via the root dir (skipping the leading '/')
+   newctxt->pathd = openat( basefd, (*nspath == '/') ? (nspath + 1) : nspath, O_RDONLY );
    if ( newctxt->pathd < 0 ) {
       LOG( LOG_ERR, "Failed to open the user path dir: \"%s\"\n", nspath );
+      if ( newctxt->nsabs ) { free( newctxt->nsabs ); }
       free( newctxt );
       free( nspath );
       return NULL;
@@ -621,6 +820,7 @@ MDAL_CTXT posixmdal_newctxt ( const char* ns, const MDAL_CTXT basectxt ) {
    if ( newctxt->refd < 0 ) {
       LOG( LOG_ERR, "Failed to open the reference dir of NS \"%s\"\n", ns );
       close( newctxt->pathd );
+      if ( newctxt->nsabs ) { free( newctxt->nsabs ); }
       free( newctxt );
       return NULL;
    }
@@ -629,6 +829,7 @@ MDAL_CTXT posixmdal_newctxt ( const char* ns, const MDAL_CTXT basectxt ) {
       LOG( LOG_ERR, "Failed to stat reference dir of NS \"%s\"\n", ns );
       close( newctxt->refd );
       close( newctxt->pathd );
+      if ( newctxt->nsabs ) { free( newctxt->nsabs ); }
       free( newctxt );
       return NULL;
    }
@@ -660,19 +861,10 @@ MDAL_CTXT posixmdal_newsplitctxt ( const char* pathns, const MDAL_CTXT pathctxt,
    POSIX_MDAL_CTXT ppathctxt = (POSIX_MDAL_CTXT) pathctxt;
    POSIX_MDAL_CTXT prefctxt = (POSIX_MDAL_CTXT) refctxt;
    // create the corresponding posix path for the path NS
-   size_t nspathlen = namespacepath( pathns, NULL, 0 );
-   if ( nspathlen == 0 ) {
-      LOG( LOG_ERR, "Failed to identify corresponding path for NS: \"%s\"\n", pathns );
-      return NULL;
-   }
-   char* nspath = malloc( sizeof(char) * (nspathlen + 1) );
-   if ( !(nspath) ) {
-      LOG( LOG_ERR, "Failed to allocate path string for NS: \"%s\"\n", pathns );
-      return NULL;
-   }
-   if ( namespacepath( pathns, nspath, nspathlen + 1 ) != nspathlen ) {
-      LOG( LOG_ERR, "Inconsistent path generation for NS: \"%s\"\n", pathns );
-      free( nspath );
+   int basefd = -1;
+   char* nspath = NULL;
+   if ( resolvenamespace( ppathctxt, pathns, 0, &(nspath), &(basefd) ) == 0 ) {
+      LOG( LOG_ERR, "Failed to resolve path of NS: \"%s\"\n", pathns );
       return NULL;
    }
    // create a new ctxt structure
@@ -682,31 +874,11 @@ MDAL_CTXT posixmdal_newsplitctxt ( const char* pathns, const MDAL_CTXT pathctxt,
       free( nspath );
       return NULL;
    }
+   newctxt->shards = ppathctxt->shards;
+   newctxt->nsabs = NULL;
    // open the path dir, according to the target NS path
-   if ( *nspath == '/' ) {
-      // ensure the ppathctxt is set to the secureroot dir
-      if ( ppathctxt->pathd >= 0 ) {
-         LOG( LOG_ERR, "Absolute NS paths can only be used from a CTXT with no NS set\n" );
-         errno = EINVAL;
-         free( newctxt );
-         free( nspath );
-         return NULL;
-      }
-      // absoulute paths are opened via the root dir (skipping the leading '/')
-      newctxt->pathd = openat( ppathctxt->refd, (nspath + 1), O_RDONLY );
-   }
-   else {
-      // ensure the refd is set to an actual reference dir
-      if ( ppathctxt->pathd < 0 ) {
-         LOG( LOG_ERR, "Relative NS paths can only be used from a CTXT with a NS set\n" );
-         errno = EINVAL;
-         free( newctxt );
-         free( nspath );
-         return NULL;
-      }
-      // relative paths are opened via the ref dir of the pbasectxt
-      newctxt->pathd = openat( ppathctxt->refd, nspath, O_RDONLY );
-   }
+   //   NOTE -- absolute paths are opened via the root dir (skipping the leading '/')
+   newctxt->pathd = openat( basefd, (*nspath == '/') ? (nspath + 1) : nspath, O_RDONLY );
    if ( newctxt->pathd < 0 ) {
       LOG( LOG_ERR, "Failed to open the user path dir: \"%s\"\n", nspath );
       free( newctxt );
@@ -726,23 +898,9 @@ MDAL_CTXT posixmdal_newsplitctxt ( const char* pathns, const MDAL_CTXT pathctxt,
    free( nspath ); // done with this path
 
    // create the corresponding posix path for the ref NS
-   nspathlen = namespacepath( refns, NULL, 0 );
+   size_t nspathlen = resolvenamespace( prefctxt, refns, 1 + strlen(PMDAL_REF), &(nspath), &(basefd) );
    if ( nspathlen == 0 ) {
-      LOG( LOG_ERR, "Failed to identify corresponding path for NS: \"%s\"\n", refns );
-      close( newctxt->pathd );
-      free( newctxt );
-      return NULL;
-   }
-   nspath = malloc( sizeof(char) * (nspathlen + 2 + strlen(PMDAL_REF)) );
-   if ( !(nspath) ) {
-      LOG( LOG_ERR, "Failed to allocate path string for NS: \"%s\"\n", refns );
-      close( newctxt->pathd );
-      free( newctxt );
-      return NULL;
-   }
-   if ( namespacepath( refns, nspath, nspathlen + 1 ) != nspathlen ) {
-      LOG( LOG_ERR, "Inconsistent path generation for NS: \"%s\"\n", refns );
-      free( nspath );
+      LOG( LOG_ERR, "Failed to resolve path of NS: \"%s\"\n", refns );
       close( newctxt->pathd );
       free( newctxt );
       return NULL;
@@ -755,32 +913,8 @@ MDAL_CTXT posixmdal_newsplitctxt ( const char* pathns, const MDAL_CTXT pathctxt,
       return NULL;
    }
    // open the ref dir, according to the target NS path
-   if ( *nspath == '/' ) {
-      // ensure the prefctxt is set to the secureroot dir
-      if ( prefctxt->pathd >= 0 ) {
-         LOG( LOG_ERR, "Absolute NS paths can only be used from a CTXT with no NS set\n" );
-         errno = EINVAL;
-         free( nspath );
-         close( newctxt->pathd );
-         free( newctxt );
-         return NULL;
-      }
-      // absoulute paths are opened via the root dir (skipping the leading '/')
-      newctxt->refd = openat( prefctxt->refd, (nspath + 1), O_RDONLY );
-   }
-   else {
-      // ensure the refd is set to an actual reference dir
-      if ( prefctxt->pathd < 0 ) {
-         LOG( LOG_ERR, "Relative NS paths can only be used from a CTXT with a NS set\n" );
-         errno = EINVAL;
-         free( nspath );
-         close( newctxt->pathd );
-         free( newctxt );
-         return NULL;
-      }
-      // relative paths are opened via the ref dir of the pbasectxt
-      newctxt->refd = openat( prefctxt->refd, nspath, O_RDONLY );
-   }
+   //   NOTE -- absolute paths are opened via the root dir (skipping the leading '/')
+   newctxt->refd = openat( basefd, (*nspath == '/') ? (nspath + 1) : nspath, O_RDONLY );
    if ( newctxt->refd < 0 ) {
       LOG( LOG_ERR, "Failed to open the ref dir: \"%s\"\n", nspath );
       free( nspath );
@@ -808,10 +942,57 @@ MDAL_CTXT posixmdal_newsplitctxt ( const char* pathns, const MDAL_CTXT pathctxt,
       errno = EXDEV;
       return NULL;
    }
+   // track the absolute NS path of multi-root ctxts, according to the user path NS
+   if ( newctxt->shards  &&  (newctxt->nsabs = absolutens( ppathctxt, pathns )) == NULL ) {
+      LOG( LOG_ERR, "Failed to identify absolute path of NS: \"%s\"\n", pathns );
+      close( newctxt->refd );
+      close( newctxt->pathd );
+      free( newctxt );
+      return NULL;
+   }
    newctxt->dev = stval.st_dev;
    return (MDAL_CTXT) newctxt;
 }
 
+/**
+ * Create all directories along the given path ( ignoring any which already exist )
+ * @param int basefd : Dir handle the path is relative to
+ * @param char* path : Path to be created
+ *                     NOTE -- this string will be temporarily modified, but is restored on exit
+ * @param char makefinal : If zero, the final component of the path will not be created
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int createdirpath( int basefd, char* path, char makefinal ) {
+   int mkdirres = 0;
+   char* nsparse = path;
+   errno = 0;
+   while ( mkdirres == 0  &&  nsparse != NULL ) {
+      // iterate ahead in the stream, tokenizing into intermediate path components
+      while ( 1 ) {
+         if ( *nsparse == '/' ) { *nsparse = '\0'; break; } // cut string to next dir comp
+         if ( *nsparse == '\0' ) { nsparse = NULL; break; } // end of str, prepare to exit
+         nsparse++;
+      }
+      // isssue the mkdir op
+      if ( nsparse ) {
+         // create all intermediate dirs with global access
+         LOG( LOG_INFO, "Attempting to create dir: \"%s\"\n", path );
+         mkdirres = mkdirat( basefd, path, S_IRWXU | S_IXOTH );
+      }
+      else if ( makefinal ) {
+         // create the final dir with user-only access
+         LOG( LOG_INFO, "Attempting to create dir: \"%s\"\n", path );
+         mkdirres = mkdirat( basefd, path, S_IRWXU );
+      }
+      // ignore any EEXIST errors, at this point
+      if ( mkdirres  &&  errno == EEXIST ) { mkdirres = 0; errno = 0; }
+      // if we cut the string short, we need to undo that and progress to the next str comp
+      if ( nsparse ) { *nsparse = '/'; nsparse++; }
+   }
+   if ( mkdirres ) { return -1; }
+   return 0;
+}
+
 /**
  * Create the specified namespace root structures ( reference tree is not created by this func! )
  * @param MDAL_CTXT ctxt : Current MDAL context
@@ -827,92 +1008,155 @@ int posixmdal_createnamespace( MDAL_CTXT ctxt, const char* ns ) {
    }
    POSIX_MDAL_CTXT pctxt = (POSIX_MDAL_CTXT) ctxt;
    // create the corresponding posix path for the target NS
-   size_t nspathlen = namespacepath( ns, NULL, 0 );
+   int basefd = -1;
+   char* nspath = NULL;
+   size_t nspathlen = resolvenamespace( pctxt, ns, 1 + PMDAL_SUBSTRLEN, &(nspath), &(basefd) ); // leave room for ref suffix
    if ( nspathlen == 0 ) {
-      LOG( LOG_ERR, "Failed to identify corresponding path for NS: \"%s\"\n", ns );
-      return -1;
-   }
-   char* nspath = malloc( sizeof(char) * (nspathlen + 2 + PMDAL_SUBSTRLEN) ); // leave room for ref or path suffix
-   if ( !(nspath) ) {
-      LOG( LOG_ERR, "Failed to allocate path string for NS: \"%s\"\n", ns );
-      return -1;
-   }
-   if ( namespacepath( ns, nspath, nspathlen + 1 ) != nspathlen ) {
-      LOG( LOG_ERR, "Inconsistent path generation for NS: \"%s\"\n", ns );
-      free( nspath );
+      LOG( LOG_ERR, "Failed to resolve path of NS: \"%s\"\n", ns );
       return -1;
    }
-   // identify the target path and abort if the CTXT isn't in an appropriate state
    char* nstruepath = nspath;
-   if ( *nspath == '/' ) {
-      // ensure the refd is set to the secureroot dir
-      if ( pctxt->pathd >= 0 ) {
-         LOG( LOG_ERR, "Absolute NS paths can only be used from a CTXT with no NS set\n" );
-         errno = EINVAL;
+   if ( *nspath == '/' ) { nstruepath = nspath + 1; } // need to skip the initial '/' char
+   // identify the root which should host this NS
+   int home = 0;
+   if ( pctxt->shards ) {
+      char* absns = absolutens( pctxt, ns );
+      if ( absns == NULL ) {
+         LOG( LOG_ERR, "Failed to identify absolute path of NS: \"%s\"\n", ns );
          free( nspath );
          return -1;
       }
-      nstruepath = nspath + 1; // need to skip the initial '/' char
-   }
-   else {
-      // ensure the refd is set to an actual reference dir
-      if ( pctxt->pathd < 0 ) {
-         LOG( LOG_ERR, "Relative NS paths can only be used from a CTXT with a NS set\n" );
-         errno = EINVAL;
+      home = namespacehome( pctxt->shards, absns );
+      LOG( LOG_INFO, "NS \"%s\" will be hosted by metadata root %d\n", absns, home );
+      free( absns );
+   }
+   if ( home == 0 ) {
+      // attempt to create the target directory
+      if ( createdirpath( basefd, nstruepath, 1 ) ) {
+         LOG( LOG_ERR, "Failed to create path to NS root: \"%s\"\n", nspath );
          free( nspath );
          return -1;
       }
-   }
-   // attempt to create the target directory
-   int mkdirres = 0;
-   char* nsparse = nstruepath;
-   errno = 0;
-   while ( mkdirres == 0  &&  nsparse != NULL ) {
-      // iterate ahead in the stream, tokenizing into intermediate path components
-      while ( 1 ) {
-         if ( *nsparse == '/' ) { *nsparse = '\0'; break; } // cut string to next dir comp
-         if ( *nsparse == '\0' ) { nsparse = NULL; break; } // end of str, prepare to exit
-         nsparse++;
-      }
-      // isssue the mkdir op
-      LOG( LOG_INFO, "Attempting to create dir: \"%s\"\n", nstruepath );
-      if ( nsparse ) {
-         // create all intermediate dirs with global access
-         mkdirres = mkdirat( pctxt->refd, nstruepath, S_IRWXU | S_IXOTH );
+      // construct the path of the reference subdir
+      if ( snprintf( nspath + nspathlen, 2 + strlen(PMDAL_REF), "/%s", PMDAL_REF ) >= 
+            2 + strlen(PMDAL_REF) ) {
+         LOG( LOG_ERR, "Failed to properly generate the path of the ref subdir of NS:\"%s\"\n", ns );
+         free( nspath );
+         return -1;
       }
-      else {
-         // create the final dir with user-only access
-         mkdirres = mkdirat( pctxt->refd, nstruepath, S_IRWXU );
+      // attempt to create the ref subdir
+      LOG( LOG_INFO, "Attempting to create ref dir: \"%s\"\n", nstruepath );
+      if ( mkdirat( basefd, nstruepath, S_IRWXU | S_IXOTH | S_IROTH ) ) {
+         // here, we actually want to report EEXIST
+         LOG( LOG_ERR, "Failed to create NS ref path: \"%s\"\n", nspath );
+         free( nspath );
+         return -1;
       }
-      // ignore any EEXIST errors, at this point
-      if ( mkdirres  &&  errno == EEXIST ) { mkdirres = 0; errno = 0; }
-      // if we cut the string short, we need to undo that and progress to the next str comp
-      if ( nsparse ) { *nsparse = '/'; nsparse++; }
+      free( nspath );
+      return 0;
    }
-   if ( mkdirres ) { // check for error conditions ( except EEXIST )
-      LOG( LOG_ERR, "Failed to create path to NS root: \"%s\"\n", nspath );
+   // this NS will be hosted on another root, below that root's shard subdir
+   int homefd = pctxt->shards->rootfds[home];
+   size_t hostlen = strlen(PMDAL_SHARDS) + nspathlen + 2 + PMDAL_SUBSTRLEN;
+   char* hostpath = malloc( sizeof(char) * hostlen );
+   if ( hostpath == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate host path string for NS: \"%s\"\n", ns );
       free( nspath );
       return -1;
    }
-   // construct the path of the reference subdir
-   if ( snprintf( nspath + nspathlen, 2 + strlen(PMDAL_REF), "/%s", PMDAL_REF ) >= 
-         2 + strlen(PMDAL_REF) ) {
-      LOG( LOG_ERR, "Failed to properly generate the path of the ref subdir of NS:\"%s\"\n", ns );
+   size_t hostpathlen = snprintf( hostpath, hostlen, "%s%s", PMDAL_SHARDS, nspath );
+   if ( createdirpath( homefd, hostpath, 1 ) ) {
+      LOG( LOG_ERR, "Failed to create host path of NS on root %d: \"%s\"\n", home, hostpath );
+      free( hostpath );
       free( nspath );
       return -1;
    }
    // attempt to create the ref subdir
-   LOG( LOG_INFO, "Attempting to create ref dir: \"%s\"\n", nstruepath );
-   if ( mkdirat( pctxt->refd, nstruepath, S_IRWXU | S_IXOTH | S_IROTH ) ) {
+   snprintf( hostpath + hostpathlen, hostlen - hostpathlen, "/%s", PMDAL_REF );
+   LOG( LOG_INFO, "Attempting to create ref dir on root %d: \"%s\"\n", home, hostpath );
+   if ( mkdirat( homefd, hostpath, S_IRWXU | S_IXOTH | S_IROTH ) ) {
       // here, we actually want to report EEXIST
-      LOG( LOG_ERR, "Failed to create NS ref path: \"%s\"\n", nspath );
+      LOG( LOG_ERR, "Failed to create NS ref path on root %d: \"%s\"\n", home, hostpath );
+      free( hostpath );
+      free( nspath );
+      return -1;
+   }
+   hostpath[hostpathlen] = '\0';
+   // link the hosted NS into its parent, on the primary root
+   size_t tgtlen = strlen( pctxt->shards->rootpaths[home] ) + hostpathlen + 2;
+   char* linktgt = malloc( sizeof(char) * tgtlen );
+   if ( linktgt == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate link target string for NS: \"%s\"\n", ns );
+      snprintf( hostpath + hostpathlen, hostlen - hostpathlen, "/%s", PMDAL_REF );
+      unlinkat( homefd, hostpath, AT_REMOVEDIR );
+      free( hostpath );
+      free( nspath );
+      return -1;
+   }
+   snprintf( linktgt, tgtlen, "%s/%s", pctxt->shards->rootpaths[home], hostpath );
+   if ( createdirpath( basefd, nstruepath, 0 )  ||  symlinkat( linktgt, basefd, nstruepath ) ) {
+      LOG( LOG_ERR, "Failed to link NS path \"%s\" to host path \"%s\"\n", nspath, linktgt );
+      int errorval = errno;
+      snprintf( hostpath + hostpathlen, hostlen - hostpathlen, "/%s", PMDAL_REF );
+      unlinkat( homefd, hostpath, AT_REMOVEDIR );
+      hostpath[hostpathlen] = '\0';
+      unlinkat( homefd, hostpath, AT_REMOVEDIR );
+      free( linktgt );
+      free( hostpath );
       free( nspath );
+      errno = errorval;
       return -1;
    }
+   free( linktgt );
+   free( hostpath );
    free( nspath );
    return 0;
 }
 
+/**
+ * Remove the subspace, reference, and root dirs of a NS
+ * @param int basefd : Dir handle the path is relative to
+ * @param char* nspath : Path of the NS root dir
+ *                       NOTE -- this string must have room for PMDAL_SUBSTRLEN + 1 additional
+ *                               chars, which will be temporarily modified
+ * @param size_t nspathlen : Length of the NS root path
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int removenamespacedirs( int basefd, char* nspath, size_t nspathlen ) {
+   // append the subpath dir name
+   if ( snprintf( nspath + nspathlen, 2 + strlen(PMDAL_SUBSP), "/%s", PMDAL_SUBSP ) != 
+         1 + strlen(PMDAL_SUBSP) ) {
+      LOG( LOG_ERR, "Failed to properly generate the location of the subspace subdir of NS: \"%s\"\n", nspath );
+      return -1;
+   }
+   // attempt to unlink the subspace subdir
+   errno = 0;
+   if ( unlinkat( basefd, nspath, AT_REMOVEDIR )  &&  errno != ENOENT ) { // ignore error from non-existent subspace dir
+      LOG( LOG_ERR, "Failed to unlink NS subspace path: \"%s\"\n", nspath );
+      nspath[nspathlen] = '\0';
+      return -1;
+   }
+   // construct the path of the reference subdir
+   if ( snprintf( nspath + nspathlen, 2 + strlen(PMDAL_REF), "/%s", PMDAL_REF ) != 
+         1 + strlen(PMDAL_REF) ) {
+      LOG( LOG_ERR, "Failed to properly generate the path of the ref subdir of NS: \"%s\"\n", nspath );
+      return -1;
+   }
+   // attempt to unlink the ref subdir
+   if ( unlinkat( basefd, nspath, AT_REMOVEDIR ) ) {
+      LOG( LOG_ERR, "Failed to unlink NS ref subdir: \"%s\"\n", nspath );
+      nspath[nspathlen] = '\0';
+      return -1;
+   }
+   // attempt to unlink the NS root dir
+   nspath[nspathlen] = '\0'; // use NULL-term to truncate off the ref path
+   if ( unlinkat( basefd, nspath, AT_REMOVEDIR ) ) {
+      LOG( LOG_ERR, "Failed to unlink NS root path: \"%s\"\n", nspath );
+      return -1;
+   }
+   return 0;
+}
+
 /**
  * Destroy the specified namespace root structures
  * NOTE -- This operation will fail with errno=ENOTEMPTY if files/dirs persist in the 
@@ -931,92 +1175,53 @@ int posixmdal_destroynamespace ( const MDAL_CTXT ctxt, const char* ns ) {
    }
    POSIX_MDAL_CTXT pctxt = (POSIX_MDAL_CTXT) ctxt;
    // create the corresponding posix path for the target NS
-   size_t nspathlen = namespacepath( ns, NULL, 0 );
+   int basefd = -1;
+   char* nspath = NULL;
+   size_t nspathlen = resolvenamespace( pctxt, ns, 1 + PMDAL_SUBSTRLEN, &(nspath), &(basefd) ); // leave room for ref suffix
    if ( nspathlen == 0 ) {
-      LOG( LOG_ERR, "Failed to identify corresponding path for NS: \"%s\"\n", ns );
-      return -1;
-   }
-   char* nspath = malloc( sizeof(char) * (nspathlen + 2 + PMDAL_SUBSTRLEN) ); // leave room for ref suffix
-   if ( !(nspath) ) {
-      LOG( LOG_ERR, "Failed to allocate path string for NS: \"%s\"\n", ns );
-      return -1;
-   }
-   if ( namespacepath( ns, nspath, nspathlen + 1 ) != nspathlen ) {
-      LOG( LOG_ERR, "Inconsistent path generation for NS: \"%s\"\n", ns );
-      free( nspath );
-      return -1;
-   }
-   // append the subpath dir name
-   if ( snprintf( nspath + nspathlen, 2 + strlen(PMDAL_SUBSP), "/%s", PMDAL_SUBSP ) != 
-         1 + strlen(PMDAL_SUBSP) ) {
-      LOG( LOG_ERR, "Failed to properly generate the location of the subspace subdir of NS:\"%s\"\n", ns );
-      free( nspath );
+      LOG( LOG_ERR, "Failed to resolve path of NS: \"%s\"\n", ns );
       return -1;
    }
-   // attempt to unlink the subspace subdir
-   int unlinkres;
-   errno = 0;
-   if ( *nspath == '/' ) {
-      // ensure the refd is set to the secureroot dir
-      if ( pctxt->pathd >= 0 ) {
-         LOG( LOG_ERR, "Absolute NS paths can only be used from a CTXT with no NS set\n" );
-         errno = EINVAL;
+   char* nstruepath = nspath;
+   size_t truelen = nspathlen;
+   if ( *nspath == '/' ) { nstruepath = nspath + 1; truelen--; } // need to skip the initial '/' char
+   // check for a NS hosted on another root
+   struct stat stval;
+   if ( pctxt->shards  &&  fstatat( basefd, nstruepath, &(stval), AT_SYMLINK_NOFOLLOW ) == 0  &&
+        S_ISLNK(stval.st_mode) ) {
+      char* hostpath = malloc( sizeof(char) * (PATH_MAX + 2 + PMDAL_SUBSTRLEN) );
+      if ( hostpath == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate host path string for NS: \"%s\"\n", ns );
          free( nspath );
          return -1;
       }
-      unlinkres = unlinkat( pctxt->refd, nspath + 1, AT_REMOVEDIR );
-   }
-   else {
-      // ensure the refd is set to an actual reference dir
-      if ( pctxt->pathd < 0 ) {
-         LOG( LOG_ERR, "Relative NS paths can only be used from a CTXT with a NS set\n" );
-         errno = EINVAL;
+      ssize_t hostpathlen = readlinkat( basefd, nstruepath, hostpath, PATH_MAX );
+      if ( hostpathlen <= 0  ||  hostpathlen >= PATH_MAX ) {
+         LOG( LOG_ERR, "Failed to read host path of NS: \"%s\"\n", ns );
+         free( hostpath );
+         free( nspath );
+         return -1;
+      }
+      hostpath[hostpathlen] = '\0';
+      // remove the hosted dirs, then the link to them
+      if ( removenamespacedirs( AT_FDCWD, hostpath, hostpathlen ) ) {
+         LOG( LOG_ERR, "Failed to remove hosted dirs of NS: \"%s\"\n", ns );
+         free( hostpath );
+         free( nspath );
+         return -1;
+      }
+      free( hostpath );
+      if ( unlinkat( basefd, nstruepath, 0 ) ) {
+         LOG( LOG_ERR, "Failed to unlink NS host link: \"%s\"\n", nspath );
          free( nspath );
          return -1;
       }
-      unlinkres = unlinkat( pctxt->refd, nspath, AT_REMOVEDIR );
-   }
-   if ( unlinkres  &&  errno != ENOENT ) { // ignore error from non-existent subspace dir
-      LOG( LOG_ERR, "Failed to unlink NS subspace path: \"%s\"\n", nspath );
-      free( nspath );
-      return -1;
-   }
-   // construct the path of the reference subdir
-   if ( snprintf( nspath + nspathlen, 2 + strlen(PMDAL_REF), "/%s", PMDAL_REF ) != 
-         1 + strlen(PMDAL_REF) ) {
-      LOG( LOG_ERR, "Failed to properly generate the path of the ref subdir of NS:\"%s\"\n", ns );
-      free( nspath );
-      return -1;
-   }
-   // attempt to unlink the ref subdir
-   if ( *nspath == '/' ) {
-      // no need to double check state of pathd
-      unlinkres = unlinkat( pctxt->refd, nspath + 1, AT_REMOVEDIR );
-   }
-   else {
-      unlinkres = unlinkat( pctxt->refd, nspath, AT_REMOVEDIR );
-   }
-   if ( unlinkres ) {
-      LOG( LOG_ERR, "Failed to unlink NS ref subdir: \"%s\"\n", nspath );
-      free( nspath );
-      return -1;
-   }
-   // attempt to unlink the NS root dir
-   *(nspath + nspathlen) = '\0'; // use NULL-term to truncate off the ref path
-   if ( *nspath == '/' ) {
-      // no need to double check state of pathd
-      unlinkres = unlinkat( pctxt->refd, nspath + 1, AT_REMOVEDIR );
-   }
-   else {
-      unlinkres = unlinkat( pctxt->refd, nspath, AT_REMOVEDIR );
-   }
-   if ( unlinkres ) {
-      LOG( LOG_ERR, "Failed to unlink NS root path: \"%s\"\n", nspath );
       free( nspath );
-      return -1;
+      return 0;
    }
+   int retval = removenamespacedirs( basefd, nstruepath, truelen );
    free( nspath );
-   return 0;
+   return retval;
 }
 
 /**
@@ -1034,44 +1239,16 @@ MDAL_DHANDLE posixmdal_opendirnamespace( const MDAL_CTXT ctxt, const char* ns )
    }
    POSIX_MDAL_CTXT pctxt = (POSIX_MDAL_CTXT) ctxt;
    // create the corresponding posix path for the target NS
-   size_t nspathlen = namespacepath( ns, NULL, 0 );
-   if ( nspathlen == 0 ) {
-      LOG( LOG_ERR, "Failed to identify corresponding path for NS: \"%s\"\n", ns );
-      return NULL;
-   }
-   char* nspath = malloc( sizeof(char) * (nspathlen + 1) );
-   if ( !(nspath) ) {
-      LOG( LOG_ERR, "Failed to allocate path string for NS: \"%s\"\n", ns );
-      return NULL;
-   }
-   if ( namespacepath( ns, nspath, nspathlen + 1 ) != nspathlen ) {
-      LOG( LOG_ERR, "Inconsistent path generation for NS: \"%s\"\n", ns );
-      free( nspath );
+   int basefd = -1;
+   char* nspath = NULL;
+   if ( resolvenamespace( pctxt, ns, 0, &(nspath), &(basefd) ) == 0 ) {
+      LOG( LOG_ERR, "Failed to resolve path of NS: \"%s\"\n", ns );
       return NULL;
    }
-   // identify the target path and abort it the CTXT isn't in an appropriate state
    char* nstruepath = nspath;
-   if ( *nspath == '/' ) {
-      // ensure the refd is set to the secureroot dir
-      if ( pctxt->pathd >= 0 ) {
-         LOG( LOG_ERR, "Absolute NS paths can only be used from a CTXT with no NS set\n" );
-         errno = EINVAL;
-         free( nspath );
-         return NULL;
-      }
-      nstruepath = nspath + 1; // need to skip the initial '/' char
-   }
-   else {
-      // ensure the refd is set to an actual reference dir
-      if ( pctxt->pathd < 0 ) {
-         LOG( LOG_ERR, "Relative NS paths can only be used from a CTXT with a NS set\n" );
-         errno = EINVAL;
-         free( nspath );
-         return NULL;
-      }
-   }
+   if ( *nspath == '/' ) { nstruepath = nspath + 1; } // need to skip the initial '/' char
    // open the target
-   int dfd = openat( pctxt->refd, nstruepath, O_RDONLY | O_DIRECTORY );
+   int dfd = openat( basefd, nstruepath, O_RDONLY | O_DIRECTORY );
    if ( dfd < 0 ) {
       LOG( LOG_ERR, "Failed to open the target path: \"%s\"\n", nstruepath );
       free( nspath );
@@ -1118,44 +1295,16 @@ int posixmdal_accessnamespace (const MDAL_CTXT ctxt, const char* ns, int mode, i
    }
    POSIX_MDAL_CTXT pctxt = (POSIX_MDAL_CTXT) ctxt;
    // create the corresponding posix path for the target NS
-   size_t nspathlen = namespacepath( ns, NULL, 0 );
-   if ( nspathlen == 0 ) {
-      LOG( LOG_ERR, "Failed to identify corresponding path for NS: \"%s\"\n", ns );
-      return -1;
-   }
-   char* nspath = malloc( sizeof(char) * (nspathlen + 1) );
-   if ( !(nspath) ) {
-      LOG( LOG_ERR, "Failed to allocate path string for NS: \"%s\"\n", ns );
-      return -1;
-   }
-   if ( namespacepath( ns, nspath, nspathlen + 1 ) != nspathlen ) {
-      LOG( LOG_ERR, "Inconsistent path generation for NS: \"%s\"\n", ns );
-      free( nspath );
+   int basefd = -1;
+   char* nspath = NULL;
+   if ( resolvenamespace( pctxt, ns, 0, &(nspath), &(basefd) ) == 0 ) {
+      LOG( LOG_ERR, "Failed to resolve path of NS: \"%s\"\n", ns );
       return -1;
    }
-   // identify the target path and abort it the CTXT isn't in an appropriate state
    char* nstruepath = nspath;
-   if ( *nspath == '/' ) {
-      // ensure the refd is set to the secureroot dir
-      if ( pctxt->pathd >= 0 ) {
-         LOG( LOG_ERR, "Absolute NS paths can only be used from a CTXT with no NS set\n" );
-         errno = EINVAL;
-         free( nspath );
-         return -1;
-      }
-      nstruepath = nspath + 1; // need to skip the initial '/' char
-   }
-   else {
-      // ensure the refd is set to an actual reference dir
-      if ( pctxt->pathd < 0 ) {
-         LOG( LOG_ERR, "Relative NS paths can only be used from a CTXT with a NS set\n" );
-         errno = EINVAL;
-         free( nspath );
-         return -1;
-      }
-   }
+   if ( *nspath == '/' ) { nstruepath = nspath + 1; } // need to skip the initial '/' char
    // perform the access() op against the namespace path ( ignoring SYMLINK_NOFOLLOW )
-   int retval = faccessat( pctxt->refd, nstruepath, mode, flags & ~(AT_SYMLINK_NOFOLLOW) );
+   int retval = faccessat( basefd, nstruepath, mode, flags & ~(AT_SYMLINK_NOFOLLOW) );
    free( nspath );
    return retval;
 }
@@ -1176,44 +1325,16 @@ int posixmdal_statnamespace (const MDAL_CTXT ctxt, const char* ns, struct stat *
    }
    POSIX_MDAL_CTXT pctxt = (POSIX_MDAL_CTXT) ctxt;
    // create the corresponding posix path for the target NS
-   size_t nspathlen = namespacepath( ns, NULL, 0 );
-   if ( nspathlen == 0 ) {
-      LOG( LOG_ERR, "Failed to identify corresponding path for NS: \"%s\"\n", ns );
-      return -1;
-   }
-   char* nspath = malloc( sizeof(char) * (nspathlen + 1) );
-   if ( !(nspath) ) {
-      LOG( LOG_ERR, "Failed to allocate path string for NS: \"%s\"\n", ns );
+   int basefd = -1;
+   char* nspath = NULL;
+   if ( resolvenamespace( pctxt, ns, 0, &(nspath), &(basefd) ) == 0 ) {
+      LOG( LOG_ERR, "Failed to resolve path of NS: \"%s\"\n", ns );
       return -1;
    }
-   if ( namespacepath( ns, nspath, nspathlen + 1 ) != nspathlen ) {
-      LOG( LOG_ERR, "Inconsistent path generation for NS: \"%s\"\n", ns );
-      free( nspath );
-      return -1;
-   }
-   // identify the target path and abort it the CTXT isn't in an appropriate state
    char* nstruepath = nspath;
-   if ( *nspath == '/' ) {
-      // ensure the refd is set to the secureroot dir
-      if ( pctxt->pathd >= 0 ) {
-         LOG( LOG_ERR, "Absolute NS paths can only be used from a CTXT with no NS set\n" );
-         errno = EINVAL;
-         free( nspath );
-         return -1;
-      }
-      nstruepath = nspath + 1; // need to skip the initial '/' char
-   }
-   else {
-      // ensure the refd is set to an actual reference dir
-      if ( pctxt->pathd < 0 ) {
-         LOG( LOG_ERR, "Relative NS paths can only be used from a CTXT with a NS set\n" );
-         errno = EINVAL;
-         free( nspath );
-         return -1;
-      }
-   }
+   if ( *nspath == '/' ) { nstruepath = nspath + 1; } // need to skip the initial '/' char
    // perform the stat() op against the namespace path ( always follow symlinks )
-   int retval = fstatat( pctxt->refd, nstruepath, buf, 0 );
+   int retval = fstatat( basefd, nstruepath, buf, 0 );
    // adjust stat link vals to ignore MDAL subdirs
    if ( retval == 0 ) {
       buf->st_nlink -= 2; // subspaces and references
@@ -1241,44 +1362,16 @@ int posixmdal_chmodnamespace (const MDAL_CTXT ctxt, const char* ns, mode_t mode)
    }
    POSIX_MDAL_CTXT pctxt = (POSIX_MDAL_CTXT) ctxt;
    // create the corresponding posix path for the target NS
-   size_t nspathlen = namespacepath( ns, NULL, 0 );
-   if ( nspathlen == 0 ) {
-      LOG( LOG_ERR, "Failed to identify corresponding path for NS: \"%s\"\n", ns );
-      return -1;
-   }
-   char* nspath = malloc( sizeof(char) * (nspathlen + 1) );
-   if ( !(nspath) ) {
-      LOG( LOG_ERR, "Failed to allocate path string for NS: \"%s\"\n", ns );
-      return -1;
-   }
-   if ( namespacepath( ns, nspath, nspathlen + 1 ) != nspathlen ) {
-      LOG( LOG_ERR, "Inconsistent path generation for NS: \"%s\"\n", ns );
-      free( nspath );
+   int basefd = -1;
+   char* nspath = NULL;
+   if ( resolvenamespace( pctxt, ns, 0, &(nspath), &(basefd) ) == 0 ) {
+      LOG( LOG_ERR, "Failed to resolve path of NS: \"%s\"\n", ns );
       return -1;
    }
-   // identify the target path and abort it the CTXT isn't in an appropriate state
    char* nstruepath = nspath;
-   if ( *nspath == '/' ) {
-      // ensure the refd is set to the secureroot dir
-      if ( pctxt->pathd >= 0 ) {
-         LOG( LOG_ERR, "Absolute NS paths can only be used from a CTXT with no NS set\n" );
-         errno = EINVAL;
-         free( nspath );
-         return -1;
-      }
-      nstruepath = nspath + 1; // need to skip the initial '/' char
-   }
-   else {
-      // ensure the refd is set to an actual reference dir
-      if ( pctxt->pathd < 0 ) {
-         LOG( LOG_ERR, "Relative NS paths can only be used from a CTXT with a NS set\n" );
-         errno = EINVAL;
-         free( nspath );
-         return -1;
-      }
-   }
+   if ( *nspath == '/' ) { nstruepath = nspath + 1; } // need to skip the initial '/' char
    // perform the chmod() op against the namespace path ( always follow symlinks )
-   int retval = fchmodat( pctxt->refd, nstruepath, mode, 0 );
+   int retval = fchmodat( basefd, nstruepath, mode, 0 );
    free( nspath );
    return retval;
 }
@@ -1300,44 +1393,16 @@ int posixmdal_chownnamespace (const MDAL_CTXT ctxt, const char* ns, uid_t uid, g
    }
    POSIX_MDAL_CTXT pctxt = (POSIX_MDAL_CTXT) ctxt;
    // create the corresponding posix path for the target NS
-   size_t nspathlen = namespacepath( ns, NULL, 0 );
-   if ( nspathlen == 0 ) {
-      LOG( LOG_ERR, "Failed to identify corresponding path for NS: \"%s\"\n", ns );
-      return -1;
-   }
-   char* nspath = malloc( sizeof(char) * (nspathlen + 1) );
-   if ( !(nspath) ) {
-      LOG( LOG_ERR, "Failed to allocate path string for NS: \"%s\"\n", ns );
-      return -1;
-   }
-   if ( namespacepath( ns, nspath, nspathlen + 1 ) != nspathlen ) {
-      LOG( LOG_ERR, "Inconsistent path generation for NS: \"%s\"\n", ns );
-      free( nspath );
+   int basefd = -1;
+   char* nspath = NULL;
+   if ( resolvenamespace( pctxt, ns, 0, &(nspath), &(basefd) ) == 0 ) {
+      LOG( LOG_ERR, "Failed to resolve path of NS: \"%s\"\n", ns );
       return -1;
    }
-   // identify the target path and abort it the CTXT isn't in an appropriate state
    char* nstruepath = nspath;
-   if ( *nspath == '/' ) {
-      // ensure the refd is set to the secureroot dir
-      if ( pctxt->pathd >= 0 ) {
-         LOG( LOG_ERR, "Absolute NS paths can only be used from a CTXT with no NS set\n" );
-         errno = EINVAL;
-         free( nspath );
-         return -1;
-      }
-      nstruepath = nspath + 1; // need to skip the initial '/' char
-   }
-   else {
-      // ensure the refd is set to an actual reference dir
-      if ( pctxt->pathd < 0 ) {
-         LOG( LOG_ERR, "Relative NS paths can only be used from a CTXT with a NS set\n" );
-         errno = EINVAL;
-         free( nspath );
-         return -1;
-      }
-   }
+   if ( *nspath == '/' ) { nstruepath = nspath + 1; } // need to skip the initial '/' char
    // perform the chown() op against the namespace path ( always follow symlinks )
-   int retval = fchownat( pctxt->refd, nstruepath, uid, gid, 0 );
+   int retval = fchownat( basefd, nstruepath, uid, gid, 0 );
    free( nspath );
    return retval;
 }
@@ -1782,6 +1847,160 @@ MDAL_FHANDLE posixmdal_openref ( const MDAL_CTXT ctxt, const char* rpath, int fl
    return (MDAL_FHANDLE) fhandle;
 }
 
+/**
+ * Link an anonymous (O_TMPFILE) file into the reference tree
+ * @param POSIX_MDAL_CTXT pctxt : Context to operate relative to
+ * @param int fd : File descriptor of the anonymous file
+ * @param const char* rpath : Reference path at which to link the file
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int posixmdal_linkanon( POSIX_MDAL_CTXT pctxt, int fd, const char* rpath ) {
+#ifdef AT_EMPTY_PATH
+   // first, attempt a direct link of the FD ( requires CAP_DAC_READ_SEARCH on some kernels )
+   if ( linkat( fd, "", pctxt->refd, rpath, AT_EMPTY_PATH ) == 0 ) { return 0; }
+   if ( errno != ENOENT  &&  errno != EPERM ) {
+      LOG( LOG_ERR, "Failed to link anonymous file to rpath \"%s\"\n", rpath );
+      return -1;
+   }
+#endif
+   // fall back to linking via the procfs reference
+   char procpath[64];
+   snprintf( procpath, sizeof(procpath), "/proc/self/fd/%d", fd );
+   if ( linkat( AT_FDCWD, procpath, pctxt->refd, rpath, AT_SYMLINK_FOLLOW ) ) {
+      LOG( LOG_ERR, "Failed to link anonymous file to rpath \"%s\" via \"%s\"\n", rpath, procpath );
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Abort an in-progress createref() op, removing any trace of the new file
+ * @param POSIX_MDAL_CTXT pctxt : Context to operate relative to
+ * @param POSIX_FHANDLE fhandle : Handle of the new file ( will be freed )
+ * @param const char* rpath : Reference path of the new file
+ * @param char anonymous : If non-zero, the file has not yet been linked to the rpath
+ */
+static void posixmdal_abortcreate( POSIX_MDAL_CTXT pctxt, POSIX_FHANDLE fhandle, const char* rpath, char anonymous ) {
+   int errorval = errno;
+   if ( !(anonymous) ) {
+      // we created a visible reference path, which must be removed
+      unlinkat( pctxt->refd, rpath, 0 );
+   }
+   // an anonymous file will simply vanish on close
+   close( fhandle->fd );
+   free( fhandle );
+   errno = errorval;
+}
+
+/**
+ * Create a new file at the specified reference path and link it into the user namespace
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* rpath : String reference path of the new file
+ * @param mode_t mode : Mode value for file creation (see the 'open()' syscall 'mode' value for full info)
+ * @param const char* userpath : User-visible path at which to link the new file
+ * @param int (*populate)( MDAL_FHANDLE fh, void* arg ) : Function to be called on the new file
+ *                                                        prior to it becoming visible
+ * @param void* arg : Argument to be passed to the populate function
+ * @return MDAL_FHANDLE : An MDAL_WRITE handle for the new file, or NULL if a failure occurred
+ */
+MDAL_FHANDLE posixmdal_createref ( const MDAL_CTXT ctxt, const char* rpath, mode_t mode, const char* userpath,
+                                   int (*populate)( MDAL_FHANDLE fh, void* arg ), void* arg ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   POSIX_MDAL_CTXT pctxt = (POSIX_MDAL_CTXT) ctxt;
+   // check for a valid NS path dir
+   if ( pctxt->pathd < 0 ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   // allocate a new FHANDLE ref
+   POSIX_FHANDLE fhandle = malloc( sizeof(struct posixmdal_file_handle_struct) );
+   if ( fhandle == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate space for a new FHANDLE struct\n" );
+      return NULL;
+   }
+   char anonymous = 0;
+   fhandle->fd = -1;
+#ifdef O_TMPFILE
+   // identify the parent dir of the reference path
+   const char* parent = ".";
+   char* parentdup = NULL;
+   const char* lastsep = strrchr( rpath, '/' );
+   if ( lastsep ) {
+      parentdup = strndup( rpath, (size_t)(lastsep - rpath) + 1 );
+      if ( parentdup == NULL ) {
+         LOG( LOG_ERR, "Failed to duplicate parent path of rpath \"%s\"\n", rpath );
+         free( fhandle );
+         return NULL;
+      }
+      parent = parentdup;
+   }
+   // create an anonymous file, which cannot be seen by anyone until we link it
+   fhandle->fd = openat( pctxt->refd, parent, O_TMPFILE | O_WRONLY, mode );
+   if ( fhandle->fd >= 0 ) { anonymous = 1; }
+   else if ( errno != EOPNOTSUPP  &&  errno != EISDIR  &&  errno != EINVAL ) {
+      LOG( LOG_ERR, "Failed to open anonymous file below ref dir \"%s\"\n", parent );
+      free( parentdup );
+      free( fhandle );
+      return NULL;
+   }
+   else {
+      LOG( LOG_INFO, "Anonymous files are unsupported below \"%s\", falling back to visible creation\n", parent );
+   }
+   free( parentdup );
+#endif
+   if ( !(anonymous) ) {
+      // fall back to exclusive creation of the reference path itself
+      fhandle->fd = openat( pctxt->refd, rpath, O_CREAT | O_EXCL | O_WRONLY, mode );
+      if ( fhandle->fd < 0 ) {
+         LOG( LOG_ERR, "Failed to create reference path: \"%s\"\n", rpath );
+         free( fhandle );
+         return NULL;
+      }
+   }
+   // allow the caller to populate the file
+   if ( populate  &&  populate( (MDAL_FHANDLE) fhandle, arg ) ) {
+      LOG( LOG_ERR, "Populate function failed for new rpath: \"%s\"\n", rpath );
+      posixmdal_abortcreate( pctxt, fhandle, rpath, anonymous );
+      return NULL;
+   }
+   // if necessary, link the anonymous file into the reference tree
+   if ( anonymous ) {
+      if ( posixmdal_linkanon( pctxt, fhandle->fd, rpath ) ) {
+         posixmdal_abortcreate( pctxt, fhandle, rpath, anonymous );
+         return NULL;
+      }
+      anonymous = 0; // the reference path now exists
+   }
+   // link the file into the user namespace, replacing any existing target
+   //    NOTE -- only a single replacement is attempted, so that a concurrent creator of
+   //            the same NS path cannot livelock us
+   if ( linkat( pctxt->refd, rpath, pctxt->pathd, userpath, 0 ) ) {
+      if ( errno != EEXIST ) {
+         LOG( LOG_ERR, "Failed to link rpath \"%s\" to NS path \"%s\"\n", rpath, userpath );
+         posixmdal_abortcreate( pctxt, fhandle, rpath, anonymous );
+         return NULL;
+      }
+      LOG( LOG_INFO, "Replacing existing NS path \"%s\"\n", userpath );
+      if ( unlinkat( pctxt->pathd, userpath, 0 )  &&  errno != ENOENT ) {
+         LOG( LOG_ERR, "Failed to unlink existing NS path \"%s\"\n", userpath );
+         posixmdal_abortcreate( pctxt, fhandle, rpath, anonymous );
+         return NULL;
+      }
+      if ( linkat( pctxt->refd, rpath, pctxt->pathd, userpath, 0 ) ) {
+         LOG( LOG_ERR, "Failed to link rpath \"%s\" to NS path \"%s\" after replacing the previous target\n", rpath, userpath );
+         posixmdal_abortcreate( pctxt, fhandle, rpath, anonymous ); // preserves errno ( EEXIST, if we lost a race )
+         return NULL;
+      }
+   }
+   return (MDAL_FHANDLE) fhandle;
+}
+
 
 // Scanner Functions
 
@@ -2312,6 +2531,53 @@ struct dirent* posixmdal_readdir( MDAL_DHANDLE dh ) {
 }
 
 
+/**
+ * Iterate to the next entry of an open directory handle, also retrieving stat info for that entry
+ * NOTE -- glibc's readdir() already pulls entries from the kernel in bulk ( via getdents64 ),
+ *         so the win here is stat'ing relative to the open dir fd, rather than resolving a
+ *         full path per entry.  Sharing the DIR stream keeps this safe to mix with readdir().
+ * @param MDAL_DHANDLE dh : MDAL_DHANDLE to read from
+ * @param struct stat* st : Stat structure to be populated with info for the returned entry
+ * @return struct dirent* : Reference to the next dirent struct, or NULL w/ errno unset if all 
+ *                          entries have been read, or NULL w/ errno set if a failure occurred
+ */
+struct dirent* posixmdal_readdirplus( MDAL_DHANDLE dh, struct stat* st ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_DHANDLE reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   if ( !(st) ) {
+      LOG( LOG_ERR, "Received a NULL stat struct reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   POSIX_DHANDLE pdh = (POSIX_DHANDLE) dh;
+   int dfd = dirfd( pdh->dirp );
+   if ( dfd < 0 ) {
+      LOG( LOG_ERR, "Failed to identify the FD of the given MDAL_DHANDLE\n" );
+      return NULL;
+   }
+   int cachederrno = errno;
+   while ( 1 ) {
+      errno = 0;
+      struct dirent* entry = readdir( pdh->dirp );
+      if ( entry == NULL ) { return NULL; } // EOF or failure, either way errno is already set
+      if ( fstatat( dfd, entry->d_name, st, AT_SYMLINK_NOFOLLOW ) == 0 ) {
+         errno = cachederrno;
+         return entry;
+      }
+      if ( errno != ENOENT ) {
+         LOG( LOG_ERR, "Failed to stat dir entry: \"%s\" ( %s )\n", entry->d_name, strerror(errno) );
+         return NULL;
+      }
+      // the entry was removed out from under us, so just skip it
+      LOG( LOG_INFO, "Skipping vanished dir entry: \"%s\"\n", entry->d_name );
+   }
+}
+
+
 /**
  * Close the given directory handle
  * @param MDAL_DHANDLE dh : MDAL_DHANDLE to close
@@ -3155,6 +3421,79 @@ int posixmdal_utimens ( MDAL_CTXT ctxt, const char* path, const struct timespec
 }
 
 
+/**
+ * Initialize multi-root info for a posix MDAL
+ * @param const char* rootpath : Path of the primary 'ns_root' dir
+ * @param int rootfd : Open dir handle of the primary root
+ * @param xmlNode* shardnode : First XML node which may define an 'ns_shard' root
+ * @param int shardcount : Count of 'ns_shard' nodes
+ * @return POSIX_MDAL_SHARDS : New multi-root info, or NULL if a failure occurred
+ */
+POSIX_MDAL_SHARDS initshards( const char* rootpath, int rootfd, xmlNode* shardnode, int shardcount ) {
+   POSIX_MDAL_SHARDS shards = malloc( sizeof( struct posix_mdal_shards_struct ) );
+   if ( shards == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate multi-root info struct\n" );
+      return NULL;
+   }
+   shards->count = shardcount + 1;
+   shards->rootfds = malloc( sizeof(int) * shards->count );
+   shards->rootpaths = calloc( shards->count, sizeof(char*) );
+   if ( shards->rootfds == NULL  ||  shards->rootpaths == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate lists of %d metadata roots\n", shards->count );
+      if ( shards->rootfds ) { free( shards->rootfds ); }
+      if ( shards->rootpaths ) { free( shards->rootpaths ); }
+      free( shards );
+      return NULL;
+   }
+   int index = 0;
+   for ( ; index < shards->count; index++ ) { shards->rootfds[index] = -1; }
+   // populate the primary root
+   shards->rootfds[0] = dup( rootfd );
+   shards->rootpaths[0] = realpath( rootpath, NULL );
+   if ( shards->rootfds[0] < 0  ||  shards->rootpaths[0] == NULL ) {
+      LOG( LOG_ERR, "Failed to duplicate primary root: \"%s\"\n", rootpath );
+      freeshards( shards );
+      return NULL;
+   }
+   // populate each additional root
+   index = 1;
+   for ( ; shardnode  &&  index < shards->count; shardnode = shardnode->next ) {
+      if ( shardnode->type != XML_ELEMENT_NODE  ||  strncmp( (char*)shardnode->name, "ns_shard", 9 ) ) {
+         continue; // ignore unrecognized nodes
+      }
+      if ( shardnode->children == NULL  ||  shardnode->children->type != XML_TEXT_NODE ) {
+         LOG( LOG_ERR, "the \"ns_shard\" node is expected to contain a path string\n" );
+         freeshards( shards );
+         errno = EINVAL;
+         return NULL;
+      }
+      const char* shardpath = (const char*) shardnode->children->content;
+      shards->rootpaths[index] = realpath( shardpath, NULL );
+      if ( shards->rootpaths[index] == NULL ) {
+         LOG( LOG_ERR, "Failed to identify absolute path of 'ns_shard' directory: \"%s\"\n", shardpath );
+         freeshards( shards );
+         return NULL;
+      }
+      shards->rootfds[index] = open( shards->rootpaths[index], O_RDONLY );
+      if ( shards->rootfds[index] < 0 ) {
+         LOG( LOG_ERR, "Failed to open the target 'ns_shard' directory: \"%s\"\n", shardpath );
+         freeshards( shards );
+         return NULL;
+      }
+      // verify the target is a dir
+      struct stat dirstat;
+      if ( fstat( shards->rootfds[index], &(dirstat) )  ||  !(S_ISDIR(dirstat.st_mode)) ) {
+         LOG( LOG_ERR, "Could not verify target is a directory: \"%s\"\n", shardpath );
+         freeshards( shards );
+         errno = ENOTDIR;
+         return NULL;
+      }
+      index++;
+   }
+   return shards;
+}
+
+
 //   -------------    POSIX INITIALIZATION    -------------
 
 MDAL posix_mdal_init( xmlNode* root ) {
@@ -3180,6 +3519,9 @@ MDAL posix_mdal_init( xmlNode* root ) {
          pctxt->pathd = -1;
          // initialize the dev to an arbitrary value
          pctxt->dev = 0;
+         // initialize as a single-root MDAL
+         pctxt->shards = NULL;
+         pctxt->nsabs = NULL;
 
          // open the directory specified by the node content
          char* nsrootpath = strdup( (char*) root->children->content );
@@ -3200,13 +3542,32 @@ MDAL posix_mdal_init( xmlNode* root ) {
             close( rootfd );
             return NULL;
          }
-         free( nsrootpath ); // done with the nsroot string
          pctxt->refd = rootfd; // populate out root dir reference
 
+         // check for any additional metadata roots
+         int shardcount = 0;
+         xmlNode* shardnode = root->next;
+         for ( ; shardnode; shardnode = shardnode->next ) {
+            if ( shardnode->type == XML_ELEMENT_NODE  &&  strncmp( (char*)shardnode->name, "ns_shard", 9 ) == 0 ) {
+               shardcount++;
+            }
+         }
+         if ( shardcount ) {
+            pctxt->shards = initshards( nsrootpath, rootfd, root->next, shardcount );
+            if ( pctxt->shards == NULL ) {
+               LOG( LOG_ERR, "Failed to initialize %d additional metadata roots\n", shardcount );
+               free( nsrootpath );
+               posixmdal_destroyctxt( pctxt );
+               return NULL;
+            }
+         }
+         free( nsrootpath ); // done with the nsroot string
+
          // allocate and populate a new MDAL structure
          MDAL pmdal = malloc( sizeof( struct MDAL_struct ) );
          if ( pmdal == NULL ) {
             LOG( LOG_ERR, "failed to allocate space for an MDAL_struct\n" );
+            if ( pctxt->shards ) { freeshards( pctxt->shards ); }
             posixmdal_destroyctxt( pctxt );
             return NULL; // malloc will set errno
          }
@@ -3238,6 +3599,7 @@ MDAL posix_mdal_init( xmlNode* root ) {
          pmdal->unlinkref = posixmdal_unlinkref;
          pmdal->statref = posixmdal_statref;
          pmdal->openref = posixmdal_openref;
+         pmdal->createref = posixmdal_createref;
          pmdal->openscanner = posixmdal_openscanner;
          pmdal->closescanner = posixmdal_closescanner;
          pmdal->scan = posixmdal_scan;
@@ -3251,6 +3613,7 @@ MDAL posix_mdal_init( xmlNode* root ) {
          pmdal->dremovexattr = posixmdal_dremovexattr;
          pmdal->dlistxattr = posixmdal_dlistxattr;
          pmdal->readdir = posixmdal_readdir;
+         pmdal->readdirplus = posixmdal_readdirplus;
          pmdal->closedir = posixmdal_closedir;
          pmdal->open = posixmdal_open;
          pmdal->close = posixmdal_close;
@@ -0,0 +1,3647 @@
+
+/*
+Copyright (c) 2015, Los Alamos National Security, LLC
+All rights reserved.
+
+Copyright 2015.  Los Alamos National Security, LLC. This software was produced
+under U.S. Government contract DE-AC52-06NA25396 for Los Alamos National
+Laboratory (LANL), which is operated by Los Alamos National Security, LLC for
+the U.S. Department of Energy. The U.S. Government has rights to use, reproduce,
+and distribute this software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL
+SECURITY, LLC MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY
+FOR THE USE OF THIS SOFTWARE.  If software is modified to produce derivative
+works, such modified software should be clearly marked, so as not to confuse it
+with the version available from LANL.
+ 
+Additionally, redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+3. Neither the name of Los Alamos National Security, LLC, Los Alamos National
+Laboratory, LANL, the U.S. Government, nor the names of its contributors may be
+used to endorse or promote products derived from this software without specific
+prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL LOS ALAMOS NATIONAL SECURITY, LLC OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-----
+NOTE:
+-----
+Although these files reside in a seperate repository, they fall under the MarFS copyright and license.
+
+MarFS is released under the BSD license.
+
+MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier:
+LA-CC-15-039.
+
+These erasure utilites make use of the Intel Intelligent Storage
+Acceleration Library (Intel ISA-L), which can be found at
+https://github.com/01org/isa-l and is under its own license.
+
+MarFS uses libaws4c for Amazon S3 object communication. The original version
+is at https://aws.amazon.com/code/Amazon-S3/2601 and under the LGPL license.
+LANL added functionality to the original work. The original work plus
+LANL contributions is found at https://github.com/jti-lanl/aws4c.
+
+GNU licenses can be found at http://www.gnu.org/licenses/.
+*/
+
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "marfs_auto_config.h"
+#ifdef DEBUG_MDAL
+#define DEBUG DEBUG_MDAL
+#elif (defined DEBUG_ALL)
+#define DEBUG DEBUG_ALL
+#endif
+#define LOG_PREFIX "posixkv_mdal"
+#include <logging.h>
+
+#include "mdal.h"
+#include "kvstore.h"
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <time.h>
+#include <pthread.h>
+
+
+// The PosixKV MDAL is a variant of the Posix MDAL, which retains the Posix layout for
+// namespaces and user trees, but which moves the entire reference tree of each NS into an
+// embedded KVSTORE ( stored at "<NS ref dir>/MDAL_refstore" ).
+// Each reference file is a single store record, holding all attributes, xattrs, and content
+// of the file.  A reference path is instead linked into the user tree as a placeholder
+// symlink ( "MDAL_kvinode:<inode number>" ), which this MDAL transparently resolves.
+// As a result :
+//    - a file creation costs a single store transaction, plus the placeholder symlink
+//    - reference scanners are range scans over sorted store keys
+//    - reference xattr retrieval is a single point lookup
+// Placeholder link counts are always updated in an order which may leak a reference ( to be
+// found by the resource manager ) but which will never free a still linked inode.
+
+
+//   -------------    POSIXKV DEFINITIONS    -------------
+
+#define PKV_PREFX "MDAL_"
+#define PKV_REF PKV_PREFX"reference"   // NOTE -- these must match the layout of the Posix MDAL
+#define PKV_SUBSP PKV_PREFX"subspaces"
+#define PKV_XATTR "user."PKV_PREFX
+#define PKV_STOREFILE PKV_PREFX"refstore"
+#define PKV_LINK PKV_PREFX"kvinode:"    // placeholder symlink target prefix
+#define PKV_LINKLEN ( sizeof(PKV_LINK) - 1 + 16 ) // prefix + 16 hex digits
+#define PKV_ENTRY "E/"                 // key prefix of reference tree entries
+#define PKV_INODE "I/"                 // key prefix of inode records
+#define PKV_NEXTINO "N"                // key of the inode number counter
+#define PKV_INOKEYLEN ( 2 + 16 + 1 )
+#define PKV_SCANBATCH 128              // count of scanner entries retrieved per transaction
+#define PKV_MAXDATA ( 64 * 1024 * 1024 ) // maximum content length of store files
+
+
+//   -------------    POSIXKV STRUCTURES    -------------
+
+typedef struct posixkv_entry_struct {
+   char     type;  // 'F' - file, 'D' - dir
+   char     pad[3];
+   uint32_t mode;  // mode of the entry ( dirs only )
+   uint32_t uid;
+   uint32_t gid;
+   int64_t  mtime;
+   uint64_t ino;   // inode number of the entry ( files only )
+} pkventry;
+
+typedef struct posixkv_inode_header_struct {
+   uint32_t mode;
+   uint32_t uid;
+   uint32_t gid;
+   uint32_t nlink;    // count of ref entries plus user tree placeholders
+   int64_t  size;
+   int64_t  times[6]; // atime, mtime, ctime ( sec / nsec pairs )
+   uint32_t xattrlen; // length of the xattr list ( { namelen, vallen, name\0, value } records )
+   uint32_t datalen;  // length of file content ( <= size, the remainder is sparse )
+} pkvheader;
+
+typedef struct posixkv_inode_struct {
+   pkvheader hdr;
+   char*     xattrs;
+   char*     data;
+} pkvinode;
+
+typedef struct posixkv_store_struct {
+   char*     nsabs;  // absolute path of the NS
+   char*     path;   // path of the store log file
+   KVSTORE   kv;
+   dev_t     dev;    // device ID reported for all inodes of this store
+   size_t    refcnt; // count of active ctxt / handle references
+   struct posixkv_store_struct* next;
+}* PKV_STORE;
+
+typedef struct posixkv_info_struct {
+   MDAL      posix;    // the underlying Posix MDAL
+   char*     rootpath; // absolute path of the primary 'ns_root'
+   mode_t    umask;    // file creation mask of this process ( captured at init )
+   pthread_mutex_t lock;
+   PKV_STORE stores;   // list of all opened stores ( retained until cleanup )
+}* PKV_INFO;
+
+typedef struct posixkv_context_struct {
+   MDAL_CTXT inner; // Posix MDAL ctxt
+   PKV_INFO  info;
+   char*     nsabs; // absolute path of the current NS ( or NULL, if NS hasn't been set )
+   PKV_STORE store; // store of the reference tree of the current NS ( or NULL )
+}* POSIXKV_CTXT;
+
+typedef struct posixkv_directory_handle_struct {
+   MDAL_DHANDLE pdh;   // Posix MDAL dir handle
+   MDAL_CTXT    ctxt;  // Posix MDAL ctxt the dir was opened relative to ( NULL, for NS dirs )
+   char*        path;  // path of the dir, relative to that ctxt
+   PKV_STORE    store; // store of placeholders within this dir ( NULL, for NS dirs )
+   PKV_INFO     info;
+}* PKV_DHANDLE;
+
+typedef struct posixkv_scanner_struct {
+   PKV_INFO  info;
+   PKV_STORE store;
+   char*     prefix;     // key prefix of all entries of the scanned dir
+   size_t    prefixlen;
+   char*     cursor;     // key position of the next batch of entries
+   size_t    cursorsize;
+   char*     keybuf;     // buffer for retrieved keys
+   size_t    keysize;
+   char      inclusive;  // if the cursor key itself is a valid result
+   char      done;       // if all entries have been retrieved
+   struct dirent batch[PKV_SCANBATCH]; // entries retrieved by a single store transaction
+   int       batchcount;
+   int       batchindex;
+}* PKV_SCANNER;
+
+typedef struct posixkv_file_handle_struct {
+   MDAL_FHANDLE pfh;   // Posix MDAL file handle ( for files not backed by a store )
+   PKV_STORE    store;
+   PKV_INFO     info;
+   uint64_t     ino;
+   int          flags;
+   off_t        offset;
+   pkvinode     cache;     // last observed state of the inode
+   char         anonymous; // if set, the cached state is the sole copy of the inode
+}* PKV_FHANDLE;
+
+
+// forward decls of Posix MDAL internals which this MDAL reuses
+int posixmdal_pathfilter( const char* path );
+int xattrfilter( const char* name, char hidden );
+
+
+//   -------------    POSIXKV INTERNAL FUNCTIONS    -------------
+
+/**
+ * Produce the normalized, absolute form of the given NS path
+ * @param const char* base : Absolute path of the current NS ( or NULL, if none is set )
+ * @param const char* ns : NS path
+ * @return char* : Absolute NS path ( "/." for the root NS ), or NULL if a failure occurred
+ *                 NOTE -- returned string must be freed by caller
+ */
+static char* pkvabsolutens( const char* base, const char* ns ) {
+   if ( *ns != '/' ) {
+      if ( base == NULL ) {
+         LOG( LOG_ERR, "Relative NS paths can only be used from a CTXT with a NS set\n" );
+         errno = EINVAL;
+         return NULL;
+      }
+   }
+   else { base = ""; }
+   size_t alloclen = strlen( base ) + strlen( ns ) + 3;
+   char* absns = malloc( sizeof(char) * alloclen );
+   if ( absns == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate absolute path string for NS: \"%s\"\n", ns );
+      return NULL;
+   }
+   size_t abslen = 0;
+   const char* parse = base;
+   int pass;
+   for ( pass = 0; pass < 2; pass++ ) {
+      while ( *parse != '\0' ) {
+         while ( *parse == '/' ) { parse++; }
+         const char* elem = parse;
+         while ( *parse != '\0'  &&  *parse != '/' ) { parse++; }
+         size_t elemlen = (size_t)(parse - elem);
+         if ( elemlen == 0  ||  ( elemlen == 1  &&  *elem == '.' ) ) { continue; }
+         if ( elemlen == 2  &&  strncmp( elem, "..", 2 ) == 0 ) {
+            // strip the final element, if any ( the root NS is its own parent )
+            while ( abslen  &&  absns[abslen - 1] != '/' ) { abslen--; }
+            if ( abslen ) { abslen--; }
+            continue;
+         }
+         absns[abslen] = '/';
+         memcpy( absns + abslen + 1, elem, elemlen );
+         abslen += elemlen + 1;
+      }
+      parse = ns;
+   }
+   if ( abslen == 0 ) { absns[abslen++] = '/'; absns[abslen++] = '.'; }
+   absns[abslen] = '\0';
+   return absns;
+}
+
+/**
+ * Produce the path of the store of the given NS
+ * @param const char* rootpath : Path of the primary 'ns_root'
+ * @param const char* nsabs : Absolute NS path
+ * @return char* : Path of the store log file, or NULL if a failure occurred
+ *                 NOTE -- returned string must be freed by caller
+ */
+static char* pkvstorepath( const char* rootpath, const char* nsabs ) {
+   // every NS element translates to a subspace dir, plus the element itself
+   size_t elemcount = 0;
+   const char* parse = nsabs;
+   for ( ; *parse != '\0'; parse++ ) { if ( *parse == '/' ) { elemcount++; } }
+   size_t alloclen = strlen( rootpath ) + strlen( nsabs ) + ( elemcount * ( strlen(PKV_SUBSP) + 1 ) ) +
+                     strlen( PKV_REF ) + strlen( PKV_STOREFILE ) + 3;
+   char* path = malloc( sizeof(char) * alloclen );
+   if ( path == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate store path string for NS: \"%s\"\n", nsabs );
+      return NULL;
+   }
+   size_t pathlen = snprintf( path, alloclen, "%s", rootpath );
+   parse = nsabs;
+   while ( *parse != '\0' ) {
+      while ( *parse == '/' ) { parse++; }
+      const char* elem = parse;
+      while ( *parse != '\0'  &&  *parse != '/' ) { parse++; }
+      int elemlen = (int)(parse - elem);
+      if ( elemlen == 0  ||  ( elemlen == 1  &&  *elem == '.' ) ) { continue; }
+      pathlen += snprintf( path + pathlen, alloclen - pathlen, "/%s/%.*s", PKV_SUBSP, elemlen, elem );
+   }
+   snprintf( path + pathlen, alloclen - pathlen, "/%s/%s", PKV_REF, PKV_STOREFILE );
+   return path;
+}
+
+/**
+ * Acquire a reference to the store of the given NS, opening it if necessary
+ * @param PKV_INFO info : MDAL info reference
+ * @param const char* nsabs : Absolute NS path
+ * @return PKV_STORE : Referenced store, or NULL if a failure occurred
+ */
+static PKV_STORE pkvacquirestore( PKV_INFO info, const char* nsabs ) {
+   if ( pthread_mutex_lock( &(info->lock) ) ) {
+      LOG( LOG_ERR, "Failed to acquire MDAL store lock\n" );
+      return NULL;
+   }
+   PKV_STORE store = info->stores;
+   for ( ; store; store = store->next ) {
+      if ( strcmp( store->nsabs, nsabs ) == 0 ) {
+         store->refcnt++;
+         pthread_mutex_unlock( &(info->lock) );
+         return store;
+      }
+   }
+   store = malloc( sizeof( struct posixkv_store_struct ) );
+   if ( store == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new store struct\n" );
+      pthread_mutex_unlock( &(info->lock) );
+      return NULL;
+   }
+   store->nsabs = strdup( nsabs );
+   store->path = pkvstorepath( info->rootpath, nsabs );
+   if ( store->nsabs == NULL  ||  store->path == NULL ) {
+      LOG( LOG_ERR, "Failed to populate store strings for NS: \"%s\"\n", nsabs );
+      free( store->nsabs );
+      free( store->path );
+      free( store );
+      pthread_mutex_unlock( &(info->lock) );
+      return NULL;
+   }
+   store->kv = kvstore_open( store->path, 1 );
+   struct stat stval;
+   if ( store->kv == NULL  ||  stat( store->path, &(stval) ) ) {
+      LOG( LOG_ERR, "Failed to open reference store of NS \"%s\": \"%s\"\n", nsabs, store->path );
+      if ( store->kv ) { kvstore_close( store->kv ); }
+      free( store->nsabs );
+      free( store->path );
+      free( store );
+      pthread_mutex_unlock( &(info->lock) );
+      return NULL;
+   }
+   store->dev = stval.st_dev;
+   store->refcnt = 1;
+   store->next = info->stores;
+   info->stores = store;
+   pthread_mutex_unlock( &(info->lock) );
+   return store;
+}
+
+/**
+ * Release a reference to the given store
+ * NOTE -- unreferenced stores remain open, for reuse, until the MDAL is cleaned up
+ * @param PKV_INFO info : MDAL info reference
+ * @param PKV_STORE store : Store to release
+ */
+static void pkvreleasestore( PKV_INFO info, PKV_STORE store ) {
+   if ( store == NULL ) { return; }
+   pthread_mutex_lock( &(info->lock) );
+   store->refcnt--;
+   pthread_mutex_unlock( &(info->lock) );
+}
+
+/**
+ * Destroy the store at the given location, so long as no entries or inodes remain
+ * @param const char* path : Path of the store log file
+ * @return int : Zero on success, or -1 if a failure occurred ( errno=ENOTEMPTY, if the
+ *               store is still in use )
+ */
+static int pkvdestroystore( const char* path ) {
+   KVSTORE kv = kvstore_open( path, 0 );
+   if ( kv == NULL ) { return -1; }
+   if ( kvstore_begin( kv, 1 ) ) {
+      kvstore_close( kv );
+      return -1;
+   }
+   // the inode counter sorts after all entry and inode keys, and is the only key to discard
+   char key[PKV_INOKEYLEN];
+   ssize_t res = kvstore_nextkey( kv, NULL, 1, key, PKV_INOKEYLEN );
+   int retval = 0;
+   if ( res > 0 ) {
+      if ( res >= PKV_INOKEYLEN  ||  strcmp( key, PKV_NEXTINO ) ) { errno = ENOTEMPTY; retval = -1; }
+      else { retval = kvstore_delete( kv, PKV_NEXTINO ); }
+   }
+   else if ( res < 0 ) { retval = -1; }
+   if ( kvstore_end( kv, ( retval == 0 ) )  ||  retval ) {
+      LOG( LOG_ERR, "Failed to verify that store is unused: \"%s\"\n", path );
+      kvstore_close( kv );
+      return -1;
+   }
+   if ( kvstore_close( kv ) ) { return -1; }
+   return kvstore_destroy( path );
+}
+
+/**
+ * Produce the store entry key of the given reference path
+ * @param const char* rpath : Reference path
+ * @param char child : If non-zero, produce the key prefix of all children of the path instead
+ * @return char* : Entry key string, or NULL if a failure occurred
+ *                 NOTE -- returned string must be freed by caller
+ */
+static char* pkventrykey( const char* rpath, char child ) {
+   size_t alloclen = strlen( PKV_ENTRY ) + strlen( rpath ) + 2;
+   char* key = malloc( sizeof(char) * alloclen );
+   if ( key == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate key string for rpath: \"%s\"\n", rpath );
+      return NULL;
+   }
+   size_t keylen = snprintf( key, alloclen, "%s", PKV_ENTRY );
+   const char* parse = rpath;
+   while ( *parse != '\0' ) {
+      while ( *parse == '/' ) { parse++; }
+      const char* elem = parse;
+      while ( *parse != '\0'  &&  *parse != '/' ) { parse++; }
+      size_t elemlen = (size_t)(parse - elem);
+      if ( elemlen == 0  ||  ( elemlen == 1  &&  *elem == '.' ) ) { continue; }
+      if ( elemlen == 2  &&  strncmp( elem, "..", 2 ) == 0 ) {
+         LOG( LOG_ERR, "Reference paths may not contain parent references: \"%s\"\n", rpath );
+         free( key );
+         errno = EINVAL;
+         return NULL;
+      }
+      if ( keylen != strlen( PKV_ENTRY ) ) { key[keylen++] = '/'; }
+      memcpy( key + keylen, elem, elemlen );
+      keylen += elemlen;
+   }
+   if ( child  &&  keylen != strlen( PKV_ENTRY ) ) { key[keylen++] = '/'; }
+   key[keylen] = '\0';
+   return key;
+}
+
+/**
+ * Produce the store inode key of the given inode number
+ * @param uint64_t ino : Inode number
+ * @param char* key : Buffer of at least PKV_INOKEYLEN chars
+ */
+static void pkvinodekey( uint64_t ino, char* key ) {
+   snprintf( key, PKV_INOKEYLEN, "%s%016llx", PKV_INODE, (unsigned long long)ino );
+}
+
+/**
+ * Retrieve the entry of the given key ( within an active transaction )
+ * @param KVSTORE kv : Store to retrieve from
+ * @param const char* key : Entry key ( PKV_ENTRY alone is treated as the root dir )
+ * @param pkventry* entry : Entry to be populated
+ * @return int : Zero on success, or -1 if a failure occurred ( errno=ENOENT, if missing )
+ */
+static int pkvgetentry( KVSTORE kv, const char* key, pkventry* entry ) {
+   if ( strcmp( key, PKV_ENTRY ) == 0 ) {
+      // the root of the reference tree always exists
+      bzero( entry, sizeof( pkventry ) );
+      entry->type = 'D';
+      entry->mode = S_IFDIR | 0700;
+      return 0;
+   }
+   ssize_t res = kvstore_get( kv, key, entry, sizeof( pkventry ) );
+   if ( res < 0 ) { return -1; }
+   if ( res != sizeof( pkventry ) ) {
+      LOG( LOG_ERR, "Entry \"%s\" has an unexpected length of %zd\n", key, res );
+      errno = EIO;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Verify that the parent of the given entry key is an existing dir ( within an active transaction )
+ * @param KVSTORE kv : Store to check
+ * @param const char* key : Entry key
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int pkvcheckparent( KVSTORE kv, char* key ) {
+   char* lastsep = strrchr( key + strlen( PKV_ENTRY ), '/' );
+   if ( lastsep == NULL ) { return 0; } // parent is the root dir
+   *lastsep = '\0';
+   pkventry parent;
+   int res = pkvgetentry( kv, key, &(parent) );
+   *lastsep = '/';
+   if ( res ) { return -1; }
+   if ( parent.type != 'D' ) { errno = ENOTDIR; return -1; }
+   return 0;
+}
+
+/**
+ * Identify the first key following the given position, growing the provided buffer as needed
+ * @param KVSTORE kv : Store to search
+ * @param const char* from : Starting position of the search
+ * @param char inclusive : If non-zero, a key exactly matching 'from' may be returned
+ * @param char** buf : Reference to a dynamically allocated buffer to be populated
+ * @param size_t* size : Reference to the allocated size of that buffer
+ * @return ssize_t : Length of the resulting key, zero if no further keys exist, or -1 if a
+ *                   failure occurred
+ */
+static ssize_t pkvnextkey( KVSTORE kv, const char* from, char inclusive, char** buf, size_t* size ) {
+   ssize_t res = kvstore_nextkey( kv, from, inclusive, *buf, *size );
+   if ( res >= 0  &&  (size_t)res >= *size ) {
+      char* newbuf = malloc( sizeof(char) * (res + 1) );
+      if ( newbuf == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate a key buffer of length %zd\n", res + 1 );
+         return -1;
+      }
+      res = kvstore_nextkey( kv, from, inclusive, newbuf, res + 1 );
+      free( *buf );
+      *buf = newbuf;
+      *size = res + 1;
+   }
+   return res;
+}
+
+/**
+ * Free the content of the given inode
+ * @param pkvinode* inode : Inode to be freed
+ */
+static void pkvinodefree( pkvinode* inode ) {
+   free( inode->xattrs );
+   free( inode->data );
+   inode->xattrs = NULL;
+   inode->data = NULL;
+}
+
+/**
+ * Initialize a new, empty inode
+ * @param pkvinode* inode : Inode to be initialized
+ * @param mode_t mode : Mode of the new inode
+ * @param mode_t mask : File creation mask to be applied to that mode
+ */
+static void pkvinodeinit( pkvinode* inode, mode_t mode, mode_t mask ) {
+   bzero( inode, sizeof( pkvinode ) );
+   inode->hdr.mode = S_IFREG | ( mode & 07777 & ~(mask) );
+   inode->hdr.uid = geteuid();
+   inode->hdr.gid = getegid();
+   struct timespec now;
+   clock_gettime( CLOCK_REALTIME, &(now) );
+   int index;
+   for ( index = 0; index < 6; index += 2 ) {
+      inode->hdr.times[index] = now.tv_sec;
+      inode->hdr.times[index + 1] = now.tv_nsec;
+   }
+}
+
+/**
+ * Produce a duplicate of the given inode
+ * @param pkvinode* dst : Inode to be populated
+ * @param const pkvinode* src : Inode to be duplicated
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int pkvinodecopy( pkvinode* dst, const pkvinode* src ) {
+   dst->hdr = src->hdr;
+   dst->xattrs = NULL;
+   dst->data = NULL;
+   if ( src->hdr.xattrlen ) {
+      dst->xattrs = malloc( src->hdr.xattrlen );
+      if ( dst->xattrs == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate inode xattr list\n" );
+         return -1;
+      }
+      memcpy( dst->xattrs, src->xattrs, src->hdr.xattrlen );
+   }
+   if ( src->hdr.datalen ) {
+      dst->data = malloc( src->hdr.datalen );
+      if ( dst->data == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate inode data buffer\n" );
+         pkvinodefree( dst );
+         return -1;
+      }
+      memcpy( dst->data, src->data, src->hdr.datalen );
+   }
+   return 0;
+}
+
+/**
+ * Retrieve the given inode ( within an active transaction )
+ * @param KVSTORE kv : Store to retrieve from
+ * @param uint64_t ino : Inode number
+ * @param pkvinode* inode : Inode to be populated
+ * @return int : Zero on success, or -1 if a failure occurred ( errno=ENOENT, if missing )
+ */
+static int pkvinodeload( KVSTORE kv, uint64_t ino, pkvinode* inode ) {
+   char key[PKV_INOKEYLEN];
+   pkvinodekey( ino, key );
+   ssize_t reclen = kvstore_get( kv, key, NULL, 0 );
+   if ( reclen < 0 ) { return -1; }
+   char* record = malloc( reclen );
+   if ( record == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a record buffer of %zd bytes\n", reclen );
+      return -1;
+   }
+   if ( kvstore_get( kv, key, record, reclen ) != reclen  ||  reclen < sizeof( pkvheader ) ) {
+      LOG( LOG_ERR, "Failed to retrieve record of inode %llu\n", (unsigned long long)ino );
+      free( record );
+      errno = EIO;
+      return -1;
+   }
+   memcpy( &(inode->hdr), record, sizeof( pkvheader ) );
+   if ( sizeof( pkvheader ) + (size_t)inode->hdr.xattrlen + (size_t)inode->hdr.datalen != (size_t)reclen ) {
+      LOG( LOG_ERR, "Record of inode %llu has an inconsistent length\n", (unsigned long long)ino );
+      free( record );
+      errno = EIO;
+      return -1;
+   }
+   inode->xattrs = NULL;
+   inode->data = NULL;
+   pkvinode ref = { .hdr = inode->hdr, .xattrs = record + sizeof( pkvheader ),
+                    .data = record + sizeof( pkvheader ) + inode->hdr.xattrlen };
+   int retval = pkvinodecopy( inode, &(ref) );
+   free( record );
+   return retval;
+}
+
+/**
+ * Store the given inode ( within an active write transaction )
+ * @param KVSTORE kv : Store to modify
+ * @param uint64_t ino : Inode number
+ * @param const pkvinode* inode : Inode to be stored
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int pkvinodesave( KVSTORE kv, uint64_t ino, const pkvinode* inode ) {
+   size_t reclen = sizeof( pkvheader ) + inode->hdr.xattrlen + inode->hdr.datalen;
+   char* record = malloc( reclen );
+   if ( record == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a record buffer of %zu bytes\n", reclen );
+      return -1;
+   }
+   memcpy( record, &(inode->hdr), sizeof( pkvheader ) );
+   if ( inode->hdr.xattrlen ) { memcpy( record + sizeof( pkvheader ), inode->xattrs, inode->hdr.xattrlen ); }
+   if ( inode->hdr.datalen ) {
+      memcpy( record + sizeof( pkvheader ) + inode->hdr.xattrlen, inode->data, inode->hdr.datalen );
+   }
+   char key[PKV_INOKEYLEN];
+   pkvinodekey( ino, key );
+   int retval = kvstore_put( kv, key, record, reclen );
+   free( record );
+   return retval;
+}
+
+/**
+ * Allocate a new inode number ( within an active write transaction )
+ * @param KVSTORE kv : Store to allocate from
+ * @return uint64_t : New inode number, or zero if a failure occurred
+ */
+static uint64_t pkvnewino( KVSTORE kv ) {
+   uint64_t ino = 0;
+   ssize_t res = kvstore_get( kv, PKV_NEXTINO, &(ino), sizeof( uint64_t ) );
+   if ( res < 0 ) {
+      if ( errno != ENOENT ) { return 0; }
+      ino = 1;
+   }
+   else if ( res != sizeof( uint64_t ) ) {
+      LOG( LOG_ERR, "Inode counter has an unexpected length of %zd\n", res );
+      errno = EIO;
+      return 0;
+   }
+   uint64_t next = ino + 1;
+   if ( kvstore_put( kv, PKV_NEXTINO, &(next), sizeof( uint64_t ) ) ) { return 0; }
+   return ino;
+}
+
+/**
+ * Update the change time ( and optionally the modification time ) of the given inode
+ * @param pkvinode* inode : Inode to update
+ * @param char modify : If non-zero, the modification time will be updated as well
+ */
+static void pkvinodetouch( pkvinode* inode, char modify ) {
+   struct timespec now;
+   clock_gettime( CLOCK_REALTIME, &(now) );
+   inode->hdr.times[4] = now.tv_sec;
+   inode->hdr.times[5] = now.tv_nsec;
+   if ( modify ) {
+      inode->hdr.times[2] = now.tv_sec;
+      inode->hdr.times[3] = now.tv_nsec;
+   }
+}
+
+/**
+ * Apply the given timestamps to the given inode ( see utimensat() for value semantics )
+ * @param pkvinode* inode : Inode to update
+ * @param const struct timespec times[2] : New atime / mtime values ( may be NULL )
+ */
+static void pkvinodetimes( pkvinode* inode, const struct timespec times[2] ) {
+   struct timespec now;
+   clock_gettime( CLOCK_REALTIME, &(now) );
+   int index;
+   for ( index = 0; index < 2; index++ ) {
+      struct timespec tval = now;
+      if ( times ) {
+         if ( times[index].tv_nsec == UTIME_OMIT ) { continue; }
+         if ( times[index].tv_nsec != UTIME_NOW ) { tval = times[index]; }
+      }
+      inode->hdr.times[index * 2] = tval.tv_sec;
+      inode->hdr.times[(index * 2) + 1] = tval.tv_nsec;
+   }
+   inode->hdr.times[4] = now.tv_sec;
+   inode->hdr.times[5] = now.tv_nsec;
+}
+
+/**
+ * Populate a stat buffer from the given inode
+ * @param PKV_STORE store : Store of the inode
+ * @param uint64_t ino : Inode number
+ * @param const pkvinode* inode : Inode to report
+ * @param struct stat* st : Stat buffer to be populated
+ */
+static void pkvinodestat( PKV_STORE store, uint64_t ino, const pkvinode* inode, struct stat* st ) {
+   bzero( st, sizeof( struct stat ) );
+   st->st_dev = store->dev;
+   st->st_ino = ino;
+   st->st_mode = inode->hdr.mode;
+   st->st_nlink = inode->hdr.nlink;
+   st->st_uid = inode->hdr.uid;
+   st->st_gid = inode->hdr.gid;
+   st->st_size = inode->hdr.size;
+   st->st_blksize = 4096;
+   st->st_blocks = ( sizeof( pkvheader ) + inode->hdr.xattrlen + inode->hdr.datalen + 511 ) / 512;
+   st->st_atim.tv_sec = inode->hdr.times[0];
+   st->st_atim.tv_nsec = inode->hdr.times[1];
+   st->st_mtim.tv_sec = inode->hdr.times[2];
+   st->st_mtim.tv_nsec = inode->hdr.times[3];
+   st->st_ctim.tv_sec = inode->hdr.times[4];
+   st->st_ctim.tv_nsec = inode->hdr.times[5];
+}
+
+/**
+ * Populate a stat buffer from the given dir entry
+ * @param PKV_STORE store : Store of the entry
+ * @param const pkventry* entry : Dir entry to report
+ * @param struct stat* st : Stat buffer to be populated
+ */
+static void pkventrystat( PKV_STORE store, const pkventry* entry, struct stat* st ) {
+   bzero( st, sizeof( struct stat ) );
+   st->st_dev = store->dev;
+   st->st_mode = entry->mode;
+   st->st_nlink = 2;
+   st->st_uid = entry->uid;
+   st->st_gid = entry->gid;
+   st->st_blksize = 4096;
+   st->st_atim.tv_sec = entry->mtime;
+   st->st_mtim.tv_sec = entry->mtime;
+   st->st_ctim.tv_sec = entry->mtime;
+}
+
+/**
+ * Produce the full stored name of the given xattr
+ * @param char hidden : If non-zero, the name is that of a hidden xattr
+ * @param const char* name : Name of the xattr
+ * @return char* : Stored name of the xattr, or NULL if a failure occurred
+ *                 NOTE -- returned string must be freed by caller
+ */
+static char* pkvxattrname( char hidden, const char* name ) {
+   if ( !(hidden)  &&  xattrfilter( name, 0 ) ) {
+      LOG( LOG_ERR, "Xattr has a reserved name string: \"%s\"\n", name );
+      errno = EPERM;
+      return NULL;
+   }
+   size_t alloclen = strlen( name ) + strlen( PKV_XATTR ) + 1;
+   char* fullname = malloc( sizeof(char) * alloclen );
+   if ( fullname == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate an xattr name string\n" );
+      return NULL;
+   }
+   snprintf( fullname, alloclen, "%s%s", ( hidden ) ? PKV_XATTR : "", name );
+   return fullname;
+}
+
+/**
+ * Locate the record of the given xattr within the given inode
+ * @param const pkvinode* inode : Inode to search
+ * @param const char* name : Full name of the xattr
+ * @param size_t* reclen : Reference to be populated with the length of the matching record
+ * @return ssize_t : Offset of the matching record, or -1 if no match was found
+ */
+static ssize_t pkvxattrfind( const pkvinode* inode, const char* name, size_t* reclen ) {
+   size_t offset = 0;
+   while ( offset + ( 2 * sizeof(uint32_t) ) <= inode->hdr.xattrlen ) {
+      uint32_t lens[2];
+      memcpy( lens, inode->xattrs + offset, sizeof( lens ) );
+      *reclen = sizeof( lens ) + lens[0] + lens[1];
+      if ( strcmp( inode->xattrs + offset + sizeof( lens ), name ) == 0 ) { return offset; }
+      offset += *reclen;
+   }
+   return -1;
+}
+
+/**
+ * Retrieve the value of the given xattr of the given inode ( see fgetxattr() )
+ * @param const pkvinode* inode : Inode to retrieve from
+ * @param const char* name : Full name of the xattr
+ * @param void* value : Buffer to be populated with the value
+ * @param size_t size : Size of that buffer
+ * @return ssize_t : Length of the value, or -1 if a failure occurred
+ */
+static ssize_t pkvxattrget( const pkvinode* inode, const char* name, void* value, size_t size ) {
+   size_t reclen;
+   ssize_t offset = pkvxattrfind( inode, name, &(reclen) );
+   if ( offset < 0 ) { errno = ENODATA; return -1; }
+   uint32_t lens[2];
+   memcpy( lens, inode->xattrs + offset, sizeof( lens ) );
+   if ( size == 0 ) { return lens[1]; }
+   if ( size < lens[1] ) { errno = ERANGE; return -1; }
+   memcpy( value, inode->xattrs + offset + sizeof( lens ) + lens[0], lens[1] );
+   return lens[1];
+}
+
+/**
+ * Remove the given xattr of the given inode
+ * @param pkvinode* inode : Inode to modify
+ * @param const char* name : Full name of the xattr
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int pkvxattrremove( pkvinode* inode, const char* name ) {
+   size_t reclen;
+   ssize_t offset = pkvxattrfind( inode, name, &(reclen) );
+   if ( offset < 0 ) { errno = ENODATA; return -1; }
+   memmove( inode->xattrs + offset, inode->xattrs + offset + reclen, inode->hdr.xattrlen - ( offset + reclen ) );
+   inode->hdr.xattrlen -= reclen;
+   return 0;
+}
+
+/**
+ * Set the value of the given xattr of the given inode ( see fsetxattr() )
+ * @param pkvinode* inode : Inode to modify
+ * @param const char* name : Full name of the xattr
+ * @param const void* value : Value of the xattr
+ * @param size_t size : Length of that value
+ * @param int flags : XATTR_CREATE / XATTR_REPLACE flags
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int pkvxattrset( pkvinode* inode, const char* name, const void* value, size_t size, int flags ) {
+   size_t reclen;
+   ssize_t offset = pkvxattrfind( inode, name, &(reclen) );
+   if ( offset >= 0  &&  ( flags & XATTR_CREATE ) ) { errno = EEXIST; return -1; }
+   if ( offset < 0  &&  ( flags & XATTR_REPLACE ) ) { errno = ENODATA; return -1; }
+   uint32_t lens[2] = { strlen( name ) + 1, size };
+   size_t newlen = inode->hdr.xattrlen + sizeof( lens ) + lens[0] + lens[1];
+   if ( offset >= 0 ) { newlen -= reclen; }
+   char* newxattrs = malloc( newlen );
+   if ( newxattrs == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new xattr list of %zu bytes\n", newlen );
+      return -1;
+   }
+   size_t outlen = inode->hdr.xattrlen;
+   if ( offset >= 0 ) {
+      // omit the previous value of the xattr
+      memcpy( newxattrs, inode->xattrs, offset );
+      memcpy( newxattrs + offset, inode->xattrs + offset + reclen, inode->hdr.xattrlen - ( offset + reclen ) );
+      outlen -= reclen;
+   }
+   else if ( outlen ) { memcpy( newxattrs, inode->xattrs, outlen ); }
+   memcpy( newxattrs + outlen, lens, sizeof( lens ) );
+   memcpy( newxattrs + outlen + sizeof( lens ), name, lens[0] );
+   if ( size ) { memcpy( newxattrs + outlen + sizeof( lens ) + lens[0], value, size ); }
+   free( inode->xattrs );
+   inode->xattrs = newxattrs;
+   inode->hdr.xattrlen = newlen;
+   return 0;
+}
+
+/**
+ * List the xattrs of the given inode ( see flistxattr() )
+ * @param const pkvinode* inode : Inode to list
+ * @param char hidden : If non-zero, only list hidden xattrs ( omitting the reserved prefix );
+ *                      otherwise, only list non-hidden xattrs
+ * @param char* buf : Buffer to be populated with the list of xattr names
+ * @param size_t size : Size of that buffer
+ * @return ssize_t : Length of the list, or -1 if a failure occurred
+ */
+static ssize_t pkvxattrlist( const pkvinode* inode, char hidden, char* buf, size_t size ) {
+   size_t listlen = 0;
+   size_t offset = 0;
+   while ( offset + ( 2 * sizeof(uint32_t) ) <= inode->hdr.xattrlen ) {
+      uint32_t lens[2];
+      memcpy( lens, inode->xattrs + offset, sizeof( lens ) );
+      const char* name = inode->xattrs + offset + sizeof( lens );
+      offset += sizeof( lens ) + lens[0] + lens[1];
+      if ( xattrfilter( name, hidden ) ) { continue; }
+      if ( hidden ) { name += strlen( PKV_XATTR ); }
+      size_t namelen = strlen( name ) + 1;
+      if ( size ) {
+         if ( listlen + namelen > size ) { errno = ERANGE; return -1; }
+         memcpy( buf + listlen, name, namelen );
+      }
+      listlen += namelen;
+   }
+   return listlen;
+}
+
+/**
+ * Modify the link count of the given inode, freeing it once no links remain
+ * ( within an active write transaction )
+ * @param KVSTORE kv : Store of the inode
+ * @param uint64_t ino : Inode number
+ * @param int delta : Link count modification
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int pkvlinkcount( KVSTORE kv, uint64_t ino, int delta ) {
+   pkvinode inode;
+   if ( pkvinodeload( kv, ino, &(inode) ) ) {
+      LOG( LOG_ERR, "Failed to load inode %llu\n", (unsigned long long)ino );
+      return -1;
+   }
+   int retval = 0;
+   if ( (int64_t)inode.hdr.nlink + delta <= 0 ) {
+      LOG( LOG_INFO, "Freeing unlinked inode %llu\n", (unsigned long long)ino );
+      char key[PKV_INOKEYLEN];
+      pkvinodekey( ino, key );
+      retval = kvstore_delete( kv, key );
+   }
+   else {
+      inode.hdr.nlink += delta;
+      pkvinodetouch( &(inode), 0 );
+      retval = pkvinodesave( kv, ino, &(inode) );
+   }
+   pkvinodefree( &(inode) );
+   return retval;
+}
+
+/**
+ * Modify the link count of the given inode, as a standalone transaction
+ * @param PKV_STORE store : Store of the inode
+ * @param uint64_t ino : Inode number
+ * @param int delta : Link count modification
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int pkvlinkcounttxn( PKV_STORE store, uint64_t ino, int delta ) {
+   if ( kvstore_begin( store->kv, 1 ) ) {
+      LOG( LOG_ERR, "Failed to begin a transaction on store: \"%s\"\n", store->path );
+      return -1;
+   }
+   int retval = pkvlinkcount( store->kv, ino, delta );
+   if ( kvstore_end( store->kv, ( retval == 0 ) )  ||  retval ) {
+      LOG( LOG_ERR, "Failed to update link count of inode %llu\n", (unsigned long long)ino );
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Check if the given user path is a store placeholder
+ * @param PKV_INFO info : MDAL info reference
+ * @param MDAL_CTXT inner : Posix MDAL ctxt to operate relative to
+ * @param const char* path : User path to check
+ * @param uint64_t* ino : Reference to be populated with the inode number of the placeholder
+ * @return int : 1 if the path is a placeholder, 0 if not ( or if it could not be read )
+ */
+static int pkvplaceholder( PKV_INFO info, MDAL_CTXT inner, const char* path, uint64_t* ino ) {
+   char linkbuf[PKV_LINKLEN + 1];
+   int origerrno = errno;
+   ssize_t res = info->posix->readlink( inner, path, linkbuf, PKV_LINKLEN + 1 );
+   errno = origerrno; // any error will be reported by the actual op
+   if ( res != PKV_LINKLEN  ||  strncmp( linkbuf, PKV_LINK, strlen( PKV_LINK ) ) ) { return 0; }
+   linkbuf[PKV_LINKLEN] = '\0';
+   char* endptr = NULL;
+   unsigned long long parseval = strtoull( linkbuf + strlen( PKV_LINK ), &(endptr), 16 );
+   if ( endptr == NULL  ||  *endptr != '\0' ) { return 0; }
+   *ino = (uint64_t)parseval;
+   return 1;
+}
+
+/**
+ * Produce a new file handle for the given inode
+ * @param PKV_INFO info : MDAL info reference
+ * @param PKV_STORE store : Store of the inode ( a new reference will be acquired )
+ * @param uint64_t ino : Inode number
+ * @param int flags : Open flags of the handle
+ * @return PKV_FHANDLE : New file handle, or NULL if a failure occurred
+ */
+static PKV_FHANDLE pkvnewfhandle( PKV_INFO info, PKV_STORE store, uint64_t ino, int flags ) {
+   PKV_FHANDLE fh = calloc( 1, sizeof( struct posixkv_file_handle_struct ) );
+   if ( fh == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new file handle\n" );
+      return NULL;
+   }
+   if ( store ) {
+      pthread_mutex_lock( &(info->lock) );
+      store->refcnt++;
+      pthread_mutex_unlock( &(info->lock) );
+   }
+   fh->store = store;
+   fh->info = info;
+   fh->ino = ino;
+   fh->flags = flags;
+   return fh;
+}
+
+/**
+ * Free the given file handle
+ * @param PKV_FHANDLE fh : File handle to be freed
+ */
+static void pkvfreefhandle( PKV_FHANDLE fh ) {
+   pkvreleasestore( fh->info, fh->store );
+   pkvinodefree( &(fh->cache) );
+   free( fh );
+}
+
+/**
+ * Begin an operation on the inode of the given store-backed file handle
+ * NOTE -- for an inode which is still linked, this leaves a store transaction active
+ * @param PKV_FHANDLE fh : File handle to operate on
+ * @param char write : If non-zero, the operation may modify the inode
+ * @param pkvinode* inode : Inode to be populated with the current state
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int pkvfhbegin( PKV_FHANDLE fh, char write, pkvinode* inode ) {
+   if ( !(fh->anonymous) ) {
+      if ( kvstore_begin( fh->store->kv, write ) ) {
+         LOG( LOG_ERR, "Failed to begin a transaction on store: \"%s\"\n", fh->store->path );
+         return -1;
+      }
+      if ( pkvinodeload( fh->store->kv, fh->ino, inode ) == 0 ) { return 0; }
+      int origerrno = errno;
+      kvstore_end( fh->store->kv, 0 );
+      if ( origerrno != ENOENT ) {
+         LOG( LOG_ERR, "Failed to load inode %llu\n", (unsigned long long)fh->ino );
+         errno = origerrno;
+         return -1;
+      }
+      // just as with an unlinked posix file, the handle remains usable
+      LOG( LOG_INFO, "Inode %llu has been freed, continuing with cached state\n", (unsigned long long)fh->ino );
+      fh->anonymous = 1;
+   }
+   return pkvinodecopy( inode, &(fh->cache) );
+}
+
+/**
+ * Complete an operation on the inode of the given store-backed file handle
+ * @param PKV_FHANDLE fh : File handle to operate on
+ * @param pkvinode* inode : Resulting inode state ( consumed by this function )
+ * @param char modified : If non-zero, the modified inode will be stored
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int pkvfhend( PKV_FHANDLE fh, pkvinode* inode, char modified ) {
+   int retval = 0;
+   if ( !(fh->anonymous) ) {
+      if ( modified  &&  pkvinodesave( fh->store->kv, fh->ino, inode ) ) { retval = -1; }
+      if ( kvstore_end( fh->store->kv, ( modified  &&  retval == 0 ) ) ) { retval = -1; }
+   }
+   if ( retval ) {
+      LOG( LOG_ERR, "Failed to store inode %llu\n", (unsigned long long)fh->ino );
+      pkvinodefree( inode );
+      return -1;
+   }
+   pkvinodefree( &(fh->cache) );
+   fh->cache = *inode;
+   return 0;
+}
+
+/**
+ * Begin an operation on the given inode, as a standalone transaction
+ * @param PKV_STORE store : Store of the inode
+ * @param uint64_t ino : Inode number
+ * @param char write : If non-zero, the operation may modify the inode
+ * @param pkvinode* inode : Inode to be populated with the current state
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int pkvinodebegin( PKV_STORE store, uint64_t ino, char write, pkvinode* inode ) {
+   if ( kvstore_begin( store->kv, write ) ) {
+      LOG( LOG_ERR, "Failed to begin a transaction on store: \"%s\"\n", store->path );
+      return -1;
+   }
+   if ( pkvinodeload( store->kv, ino, inode ) ) {
+      LOG( LOG_ERR, "Failed to load inode %llu\n", (unsigned long long)ino );
+      int origerrno = errno;
+      kvstore_end( store->kv, 0 );
+      errno = origerrno;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Complete an operation on the given inode
+ * @param PKV_STORE store : Store of the inode
+ * @param uint64_t ino : Inode number
+ * @param pkvinode* inode : Resulting inode state ( freed by this function )
+ * @param char modified : If non-zero, the modified inode will be stored
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int pkvinodeend( PKV_STORE store, uint64_t ino, pkvinode* inode, char modified ) {
+   int retval = 0;
+   if ( modified  &&  pkvinodesave( store->kv, ino, inode ) ) { retval = -1; }
+   if ( kvstore_end( store->kv, ( modified  &&  retval == 0 ) ) ) { retval = -1; }
+   if ( retval ) { LOG( LOG_ERR, "Failed to store inode %llu\n", (unsigned long long)ino ); }
+   pkvinodefree( inode );
+   return retval;
+}
+
+/**
+ * Produce a new dir handle wrapping the given Posix MDAL dir handle
+ * @param PKV_INFO info : MDAL info reference
+ * @param MDAL_DHANDLE pdh : Posix MDAL dir handle
+ * @param POSIXKV_CTXT pctxt : Ctxt the dir was opened relative to ( NULL, for NS dirs )
+ * @param const char* path : Path of the dir, relative to that ctxt
+ * @return PKV_DHANDLE : New dir handle, or NULL if a failure occurred
+ */
+static PKV_DHANDLE pkvnewdhandle( PKV_INFO info, MDAL_DHANDLE pdh, POSIXKV_CTXT pctxt, const char* path ) {
+   PKV_DHANDLE dh = calloc( 1, sizeof( struct posixkv_directory_handle_struct ) );
+   if ( dh == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new dir handle\n" );
+      return NULL;
+   }
+   dh->pdh = pdh;
+   dh->info = info;
+   if ( pctxt ) {
+      dh->path = strdup( path );
+      dh->ctxt = info->posix->dupctxt( pctxt->inner );
+      if ( dh->path == NULL  ||  dh->ctxt == NULL ) {
+         LOG( LOG_ERR, "Failed to duplicate dir handle state\n" );
+         if ( dh->ctxt ) { info->posix->destroyctxt( dh->ctxt ); }
+         free( dh->path );
+         free( dh );
+         return NULL;
+      }
+      dh->store = pctxt->store;
+      if ( dh->store ) {
+         pthread_mutex_lock( &(info->lock) );
+         dh->store->refcnt++;
+         pthread_mutex_unlock( &(info->lock) );
+      }
+   }
+   return dh;
+}
+
+/**
+ * Free the given dir handle ( but not the wrapped Posix MDAL handle )
+ * @param PKV_DHANDLE dh : Dir handle to be freed
+ */
+static void pkvfreedhandle( PKV_DHANDLE dh ) {
+   if ( dh->ctxt ) { dh->info->posix->destroyctxt( dh->ctxt ); }
+   pkvreleasestore( dh->info, dh->store );
+   free( dh->path );
+   free( dh );
+}
+
+/**
+ * Resolve the given dir entry, if it is a placeholder
+ * @param PKV_DHANDLE dh : Dir handle the entry was read from
+ * @param const char* name : Name of the entry
+ * @param uint64_t* ino : Reference to be populated with the inode number of the placeholder
+ * @return int : 1 if the entry is a placeholder, 0 if not
+ */
+static int pkvdirplaceholder( PKV_DHANDLE dh, const char* name, uint64_t* ino ) {
+   if ( dh->ctxt == NULL  ||  dh->store == NULL ) { return 0; }
+   size_t alloclen = strlen( dh->path ) + strlen( name ) + 2;
+   char* path = malloc( sizeof(char) * alloclen );
+   if ( path == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a path string for dir entry: \"%s\"\n", name );
+      return 0;
+   }
+   snprintf( path, alloclen, "%s/%s", dh->path, name );
+   int retval = pkvplaceholder( dh->info, dh->ctxt, path, ino );
+   free( path );
+   return retval;
+}
+
+/**
+ * Open the reference file of the given entry key
+ * @param PKV_INFO info : MDAL info reference
+ * @param PKV_STORE store : Store of the entry
+ * @param const char* key : Entry key
+ * @param int flags : Flags specifying behavior ( see the 'open()' syscall 'flags' value for full info )
+ * @param mode_t mode : Mode value for file creation
+ * @return PKV_FHANDLE : New file handle, or NULL if a failure occurred
+ */
+static PKV_FHANDLE pkvopenkey( PKV_INFO info, PKV_STORE store, char* key, int flags, mode_t mode ) {
+   char write = ( ( flags & O_CREAT )  ||  ( ( flags & O_TRUNC )  &&  ( flags & O_ACCMODE ) != O_RDONLY ) );
+   if ( kvstore_begin( store->kv, write ) ) {
+      LOG( LOG_ERR, "Failed to begin a transaction on store: \"%s\"\n", store->path );
+      return NULL;
+   }
+   pkvinode inode;
+   uint64_t ino = 0;
+   char modified = 0;
+   pkventry entry;
+   if ( pkvgetentry( store->kv, key, &(entry) ) ) {
+      if ( errno != ENOENT  ||  !(flags & O_CREAT) ) {
+         kvstore_end( store->kv, 0 );
+         return NULL;
+      }
+      // create a new inode, and link it to the entry
+      if ( pkvcheckparent( store->kv, key )  ||  (ino = pkvnewino( store->kv )) == 0 ) {
+         LOG( LOG_ERR, "Failed to prepare for the creation of entry: \"%s\"\n", key );
+         kvstore_end( store->kv, 0 );
+         return NULL;
+      }
+      pkvinodeinit( &(inode), mode, info->umask );
+      inode.hdr.nlink = 1;
+      bzero( &(entry), sizeof( pkventry ) );
+      entry.type = 'F';
+      entry.ino = ino;
+      if ( kvstore_put( store->kv, key, &(entry), sizeof( pkventry ) ) ) {
+         LOG( LOG_ERR, "Failed to store new entry: \"%s\"\n", key );
+         kvstore_end( store->kv, 0 );
+         return NULL;
+      }
+      modified = 1;
+   }
+   else {
+      if ( ( flags & O_CREAT )  &&  ( flags & O_EXCL ) ) {
+         kvstore_end( store->kv, 0 );
+         errno = EEXIST;
+         return NULL;
+      }
+      if ( entry.type == 'D' ) {
+         kvstore_end( store->kv, 0 );
+         errno = EISDIR;
+         return NULL;
+      }
+      ino = entry.ino;
+      if ( pkvinodeload( store->kv, ino, &(inode) ) ) {
+         LOG( LOG_ERR, "Failed to load inode %llu of entry \"%s\"\n", (unsigned long long)ino, key );
+         kvstore_end( store->kv, 0 );
+         return NULL;
+      }
+   }
+   if ( write  &&  ( flags & O_TRUNC )  &&  ( inode.hdr.size  ||  inode.hdr.datalen ) ) {
+      inode.hdr.size = 0;
+      inode.hdr.datalen = 0;
+      pkvinodetouch( &(inode), 1 );
+      modified = 1;
+   }
+   if ( modified  &&  pkvinodesave( store->kv, ino, &(inode) ) ) {
+      LOG( LOG_ERR, "Failed to store inode %llu of entry \"%s\"\n", (unsigned long long)ino, key );
+      pkvinodefree( &(inode) );
+      kvstore_end( store->kv, 0 );
+      return NULL;
+   }
+   if ( kvstore_end( store->kv, modified ) ) {
+      LOG( LOG_ERR, "Failed to complete open of entry \"%s\"\n", key );
+      pkvinodefree( &(inode) );
+      return NULL;
+   }
+   PKV_FHANDLE fh = pkvnewfhandle( info, store, ino, flags );
+   if ( fh == NULL ) {
+      pkvinodefree( &(inode) );
+      return NULL;
+   }
+   fh->cache = inode;
+   return fh;
+}
+
+/**
+ * Unlink the reference file of the given entry key
+ * @param PKV_STORE store : Store of the entry
+ * @param const char* key : Entry key
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int pkvunlinkkey( PKV_STORE store, const char* key ) {
+   if ( kvstore_begin( store->kv, 1 ) ) {
+      LOG( LOG_ERR, "Failed to begin a transaction on store: \"%s\"\n", store->path );
+      return -1;
+   }
+   pkventry entry;
+   if ( pkvgetentry( store->kv, key, &(entry) ) ) {
+      kvstore_end( store->kv, 0 );
+      return -1;
+   }
+   if ( entry.type == 'D' ) {
+      kvstore_end( store->kv, 0 );
+      errno = EISDIR;
+      return -1;
+   }
+   if ( kvstore_delete( store->kv, key )  ||
+        ( pkvlinkcount( store->kv, entry.ino, -1 )  &&  errno != ENOENT ) ) {
+      LOG( LOG_ERR, "Failed to unlink entry: \"%s\"\n", key );
+      kvstore_end( store->kv, 0 );
+      return -1;
+   }
+   return kvstore_end( store->kv, 1 );
+}
+
+/**
+ * Stat the reference file or dir of the given entry key
+ * @param PKV_STORE store : Store of the entry
+ * @param const char* key : Entry key
+ * @param struct stat* st : Stat buffer to be populated
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int pkvstatkey( PKV_STORE store, const char* key, struct stat* st ) {
+   if ( kvstore_begin( store->kv, 0 ) ) {
+      LOG( LOG_ERR, "Failed to begin a transaction on store: \"%s\"\n", store->path );
+      return -1;
+   }
+   pkventry entry;
+   if ( pkvgetentry( store->kv, key, &(entry) ) ) {
+      kvstore_end( store->kv, 0 );
+      return -1;
+   }
+   if ( entry.type == 'D' ) { pkventrystat( store, &(entry), st ); }
+   else {
+      pkvinode inode;
+      if ( pkvinodeload( store->kv, entry.ino, &(inode) ) ) {
+         LOG( LOG_ERR, "Failed to load inode %llu of entry \"%s\"\n", (unsigned long long)entry.ino, key );
+         kvstore_end( store->kv, 0 );
+         return -1;
+      }
+      pkvinodestat( store, entry.ino, &(inode), st );
+      pkvinodefree( &(inode) );
+   }
+   return kvstore_end( store->kv, 0 );
+}
+
+/**
+ * Retrieve the next batch of entries for the given scanner
+ * @param PKV_SCANNER scanner : Scanner to retrieve entries for
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+static int pkvscanbatch( PKV_SCANNER scanner ) {
+   KVSTORE kv = scanner->store->kv;
+   scanner->batchcount = 0;
+   scanner->batchindex = 0;
+   if ( kvstore_begin( kv, 0 ) ) {
+      LOG( LOG_ERR, "Failed to begin a transaction on store: \"%s\"\n", scanner->store->path );
+      return -1;
+   }
+   while ( scanner->batchcount < PKV_SCANBATCH ) {
+      ssize_t res = pkvnextkey( kv, scanner->cursor, scanner->inclusive, &(scanner->keybuf), &(scanner->keysize) );
+      if ( res < 0 ) {
+         LOG( LOG_ERR, "Failed to retrieve key following \"%s\"\n", scanner->cursor );
+         kvstore_end( kv, 0 );
+         return -1;
+      }
+      if ( res == 0  ||  strncmp( scanner->keybuf, scanner->prefix, scanner->prefixlen ) ) {
+         scanner->done = 1;
+         break;
+      }
+      // the retrieved key becomes our new cursor
+      char* tmpbuf = scanner->cursor;
+      size_t tmpsize = scanner->cursorsize;
+      scanner->cursor = scanner->keybuf;
+      scanner->cursorsize = scanner->keysize;
+      scanner->keybuf = tmpbuf;
+      scanner->keysize = tmpsize;
+      scanner->inclusive = 0;
+      char* name = scanner->cursor + scanner->prefixlen;
+      char* sep = strchr( name, '/' );
+      if ( sep ) {
+         // skip over all entries nested below this subdir, by seeking just beyond them
+         *sep = '/' + 1;
+         *(sep + 1) = '\0';
+         scanner->inclusive = 1;
+         continue;
+      }
+      pkventry entry;
+      if ( pkvgetentry( kv, scanner->cursor, &(entry) ) ) {
+         LOG( LOG_ERR, "Failed to retrieve entry: \"%s\"\n", scanner->cursor );
+         kvstore_end( kv, 0 );
+         return -1;
+      }
+      if ( strlen( name ) >= sizeof( scanner->batch[0].d_name ) ) {
+         LOG( LOG_WARNING, "Skipping entry with an excessively long name: \"%s\"\n", scanner->cursor );
+         continue;
+      }
+      struct dirent* dent = scanner->batch + scanner->batchcount;
+      bzero( dent, sizeof( struct dirent ) );
+      dent->d_ino = entry.ino;
+      dent->d_type = ( entry.type == 'D' ) ? DT_DIR : DT_REG;
+      dent->d_reclen = sizeof( struct dirent );
+      snprintf( dent->d_name, sizeof( dent->d_name ), "%s", name );
+      scanner->batchcount++;
+   }
+   return kvstore_end( kv, 0 );
+}
+
+/**
+ * Produce the entry key of the given path, relative to the dir of the given scanner
+ * @param PKV_SCANNER scanner : Scanner to produce a key for
+ * @param const char* spath : Path, relative to the scanned dir
+ * @return char* : Entry key, or NULL if a failure occurred
+ *                 NOTE -- returned string must be freed by caller
+ */
+static char* pkvscannerkey( PKV_SCANNER scanner, const char* spath ) {
+   const char* dirpath = scanner->prefix + strlen( PKV_ENTRY );
+   size_t alloclen = strlen( dirpath ) + strlen( spath ) + 1;
+   char* rpath = malloc( sizeof(char) * alloclen );
+   if ( rpath == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a path string for scanner entry: \"%s\"\n", spath );
+      return NULL;
+   }
+   snprintf( rpath, alloclen, "%s%s", dirpath, spath );
+   char* key = pkventrykey( rpath, 0 );
+   free( rpath );
+   return key;
+}
+
+
+//   -------------    POSIXKV IMPLEMENTATION    -------------
+
+// Path Filter
+
+/**
+ * Identify and reject any paths targeting reserved names
+ * @param const char* path : Path to verify
+ * @return : Zero if the path is acceptable, -1 if not
+ */
+int posixkvmdal_pathfilter( const char* path ) {
+   return posixmdal_pathfilter( path );
+}
+
+
+// Management Functions
+
+/**
+ * Destroy a given MDAL_CTXT ( such as following a dupctxt call )
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to be freed
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_destroyctxt ( MDAL_CTXT ctxt ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   int retval = pctxt->info->posix->destroyctxt( pctxt->inner );
+   pkvreleasestore( pctxt->info, pctxt->store );
+   free( pctxt->nsabs );
+   free( pctxt );
+   return retval;
+}
+
+/**
+ * Duplicate the given MDAL_CTXT
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to be duplicated
+ * @return MDAL_CTXT : Reference to the duplicate MDAL_CTXT, or NULL if an error occurred
+ */
+MDAL_CTXT posixkvmdal_dupctxt ( const MDAL_CTXT ctxt ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   POSIXKV_CTXT dupctxt = calloc( 1, sizeof( struct posixkv_context_struct ) );
+   if ( dupctxt == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new ctxt struct\n" );
+      return NULL;
+   }
+   dupctxt->info = pctxt->info;
+   if ( pctxt->nsabs  &&  (dupctxt->nsabs = strdup( pctxt->nsabs )) == NULL ) {
+      LOG( LOG_ERR, "Failed to duplicate NS path of ctxt\n" );
+      free( dupctxt );
+      return NULL;
+   }
+   dupctxt->inner = pctxt->info->posix->dupctxt( pctxt->inner );
+   if ( dupctxt->inner == NULL ) {
+      LOG( LOG_ERR, "Failed to duplicate Posix MDAL ctxt\n" );
+      free( dupctxt->nsabs );
+      free( dupctxt );
+      return NULL;
+   }
+   if ( pctxt->store ) {
+      pthread_mutex_lock( &(pctxt->info->lock) );
+      pctxt->store->refcnt++;
+      pthread_mutex_unlock( &(pctxt->info->lock) );
+      dupctxt->store = pctxt->store;
+   }
+   return (MDAL_CTXT) dupctxt;
+}
+
+/**
+ * Cleanup all structes and state associated with the given MDAL
+ * @param MDAL mdal : MDAL to be freed
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int posixkvmdal_cleanup( MDAL mdal ) {
+   // check for NULL mdal
+   if ( !(mdal) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) mdal->ctxt;
+   PKV_INFO info = pctxt->info;
+   int retval = 0;
+   // the root ctxt wraps that of the Posix MDAL, which is freed by its own cleanup
+   if ( info->posix->cleanup( info->posix ) ) {
+      LOG( LOG_ERR, "Failed to cleanup the Posix MDAL\n" );
+      retval = -1;
+   }
+   pkvreleasestore( info, pctxt->store );
+   free( pctxt->nsabs );
+   free( pctxt );
+   while ( info->stores ) {
+      PKV_STORE store = info->stores;
+      info->stores = store->next;
+      if ( store->refcnt ) {
+         LOG( LOG_WARNING, "Closing store with %zu remaining references: \"%s\"\n", store->refcnt, store->path );
+      }
+      if ( kvstore_close( store->kv ) ) {
+         LOG( LOG_ERR, "Failed to close store: \"%s\"\n", store->path );
+         retval = -1;
+      }
+      free( store->nsabs );
+      free( store->path );
+      free( store );
+   }
+   pthread_mutex_destroy( &(info->lock) );
+   free( info->rootpath );
+   free( info );
+   free( mdal );
+   return retval;
+}
+
+/**
+ * Verify security of the given MDAL_CTXT
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT for which to verify security
+ *                               NOTE -- this ctxt CANNOT have a NS target
+ *                               ( it must be freshly initialized )
+ * @param char fix : If non-zero, attempt to correct any problems encountered
+ * @return int : A count of uncorrected security issues, or -1 if a failure occurred
+ */
+int posixkvmdal_checksec( const MDAL_CTXT ctxt, char fix ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   return pctxt->info->posix->checksec( pctxt->inner, fix );
+}
+
+
+// Namespace Functions
+
+/**
+ * Set the namespace of the given MDAL_CTXT
+ * @param MDAL_CTXT ctxt : Context to set the namespace of
+ * @param const char* ns : Name of the namespace to set
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_setnamespace( MDAL_CTXT ctxt, const char* ns ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   char* newabs = pkvabsolutens( pctxt->nsabs, ns );
+   if ( newabs == NULL ) {
+      LOG( LOG_ERR, "Failed to identify absolute path of NS: \"%s\"\n", ns );
+      return -1;
+   }
+   if ( pctxt->info->posix->setnamespace( pctxt->inner, ns ) ) {
+      LOG( LOG_ERR, "Failed to set Posix MDAL NS: \"%s\"\n", ns );
+      free( newabs );
+      return -1;
+   }
+   PKV_STORE newstore = pkvacquirestore( pctxt->info, newabs );
+   if ( newstore == NULL ) {
+      // NOTE -- the Posix ctxt has already moved, so this ctxt is no longer usable
+      LOG( LOG_ERR, "Failed to acquire reference store of NS: \"%s\"\n", newabs );
+      free( newabs );
+      return -1;
+   }
+   pkvreleasestore( pctxt->info, pctxt->store );
+   free( pctxt->nsabs );
+   pctxt->store = newstore;
+   pctxt->nsabs = newabs;
+   return 0;
+}
+
+/**
+ * Create a new MDAL_CTXT reference, targeting the specified NS, but with a reference tree
+ * targeting a second NS
+ * @param const char* pathns : Name of the namespace for the new MDAL_CTXT to target
+ * @param const MDAL_CTXT pathctxt : Ctxt the pathns is relative to
+ * @param const char* refns : Name of the namespace for the reference tree of the new MDAL_CTXT
+ * @param const MDAL_CTXT refctxt : Ctxt the refns is relative to
+ * @return MDAL_CTXT : Reference to the new MDAL_CTXT, or NULL if an error occurred
+ */
+MDAL_CTXT posixkvmdal_newsplitctxt ( const char* pathns, const MDAL_CTXT pathctxt, const char* refns, const MDAL_CTXT refctxt ) {
+   // check for NULL ctxts
+   if ( !(pathctxt)  ||  !(refctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   POSIXKV_CTXT ppathctxt = (POSIXKV_CTXT) pathctxt;
+   POSIXKV_CTXT prefctxt = (POSIXKV_CTXT) refctxt;
+   PKV_INFO info = ppathctxt->info;
+   POSIXKV_CTXT newctxt = calloc( 1, sizeof( struct posixkv_context_struct ) );
+   if ( newctxt == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new ctxt struct\n" );
+      return NULL;
+   }
+   newctxt->info = info;
+   newctxt->nsabs = pkvabsolutens( ppathctxt->nsabs, pathns );
+   char* refabs = pkvabsolutens( prefctxt->nsabs, refns );
+   if ( newctxt->nsabs == NULL  ||  refabs == NULL ) {
+      LOG( LOG_ERR, "Failed to identify absolute paths of NS \"%s\" / ref NS \"%s\"\n", pathns, refns );
+      free( newctxt->nsabs );
+      free( refabs );
+      free( newctxt );
+      return NULL;
+   }
+   if ( pathns == refns  &&  pathctxt == refctxt ) {
+      newctxt->inner = info->posix->newctxt( pathns, ppathctxt->inner );
+   }
+   else {
+      newctxt->inner = info->posix->newsplitctxt( pathns, ppathctxt->inner, refns, prefctxt->inner );
+   }
+   if ( newctxt->inner == NULL ) {
+      LOG( LOG_ERR, "Failed to create Posix MDAL ctxt for NS \"%s\" / ref NS \"%s\"\n", pathns, refns );
+      free( newctxt->nsabs );
+      free( refabs );
+      free( newctxt );
+      return NULL;
+   }
+   newctxt->store = pkvacquirestore( info, refabs );
+   free( refabs );
+   if ( newctxt->store == NULL ) {
+      LOG( LOG_ERR, "Failed to acquire reference store of NS: \"%s\"\n", refns );
+      posixkvmdal_destroyctxt( newctxt );
+      return NULL;
+   }
+   return (MDAL_CTXT) newctxt;
+}
+
+/**
+ * Create a new MDAL_CTXT reference, targeting the specified NS
+ * @param const char* ns : Name of the namespace for the new MDAL_CTXT to target
+ * @param const MDAL_CTXT basectxt : The new MDAL_CTXT will be created relative to this one
+ * @return MDAL_CTXT : Reference to the new MDAL_CTXT, or NULL if an error occurred
+ */
+MDAL_CTXT posixkvmdal_newctxt ( const char* ns, const MDAL_CTXT basectxt ) {
+   return posixkvmdal_newsplitctxt( ns, basectxt, ns, basectxt );
+}
+
+/**
+ * Create the specified namespace root structures
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* ns : Name of the namespace to be created
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_createnamespace( const MDAL_CTXT ctxt, const char* ns ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   // NOTE -- the store of the new NS will be created on first use
+   return pctxt->info->posix->createnamespace( pctxt->inner, ns );
+}
+
+/**
+ * Destroy the specified namespace root structures
+ * NOTE -- This operation will fail with errno=ENOTEMPTY if files/dirs persist in the
+ *         namespace or if inode / data usage values are non-zero for the namespace.
+ *         This includes files/dirs within the reference tree.
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* ns : Name of the namespace to be deleted
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_destroynamespace( const MDAL_CTXT ctxt, const char* ns ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   PKV_INFO info = pctxt->info;
+   char* absns = pkvabsolutens( pctxt->nsabs, ns );
+   if ( absns == NULL ) {
+      LOG( LOG_ERR, "Failed to identify absolute path of NS: \"%s\"\n", ns );
+      return -1;
+   }
+   char* storepath = pkvstorepath( info->rootpath, absns );
+   if ( storepath == NULL ) {
+      free( absns );
+      return -1;
+   }
+   // close any cached handle for the store
+   pthread_mutex_lock( &(info->lock) );
+   PKV_STORE* prevref = &(info->stores);
+   PKV_STORE store = info->stores;
+   for ( ; store; prevref = &(store->next), store = store->next ) {
+      if ( strcmp( store->nsabs, absns ) == 0 ) { break; }
+   }
+   if ( store ) {
+      if ( store->refcnt ) {
+         LOG( LOG_ERR, "Cannot destroy NS \"%s\", as its reference store is still in use\n", absns );
+         pthread_mutex_unlock( &(info->lock) );
+         free( storepath );
+         free( absns );
+         errno = EBUSY;
+         return -1;
+      }
+      *prevref = store->next;
+      kvstore_close( store->kv );
+      free( store->nsabs );
+      free( store->path );
+      free( store );
+   }
+   pthread_mutex_unlock( &(info->lock) );
+   free( absns );
+   // remove the store, which fails if any reference entries remain
+   if ( pkvdestroystore( storepath )  &&  errno != ENOENT ) {
+      LOG( LOG_ERR, "Failed to destroy reference store: \"%s\"\n", storepath );
+      free( storepath );
+      return -1;
+   }
+   free( storepath );
+   return info->posix->destroynamespace( pctxt->inner, ns );
+}
+
+/**
+ * Open a directory handle for the specified NS
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* ns : Name of the namespace target
+ * @return MDAL_DHANDLE : Open directory handle, or NULL if a failure occurred
+ */
+MDAL_DHANDLE posixkvmdal_opendirnamespace( const MDAL_CTXT ctxt, const char* ns ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   MDAL_DHANDLE pdh = pctxt->info->posix->opendirnamespace( pctxt->inner, ns );
+   if ( pdh == NULL ) { return NULL; }
+   PKV_DHANDLE dh = pkvnewdhandle( pctxt->info, pdh, NULL, NULL );
+   if ( dh == NULL ) {
+      pctxt->info->posix->closedir( pdh );
+      return NULL;
+   }
+   return (MDAL_DHANDLE) dh;
+}
+
+/**
+ * Check access to the specified NS
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* ns : Name of the namespace target
+ * @param int mode : F_OK, or a bitwise OR of R_OK/W_OK/X_OK
+ * @param int flags : A bitwise OR of AT_EACCESS and/or AT_SYMLINK_NOFOLLOW
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_accessnamespace( const MDAL_CTXT ctxt, const char* ns, int mode, int flags ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   return pctxt->info->posix->accessnamespace( pctxt->inner, ns, mode, flags );
+}
+
+/**
+ * Stat the specified NS
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* ns : Name of the namespace target
+ * @param struct stat* buf : Stat buffer to be populated
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_statnamespace( const MDAL_CTXT ctxt, const char* ns, struct stat* buf ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   return pctxt->info->posix->statnamespace( pctxt->inner, ns, buf );
+}
+
+/**
+ * Edit the mode of the specified NS
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* ns : Name of the namespace target
+ * @param mode_t mode : New mode value for the NS
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_chmodnamespace( const MDAL_CTXT ctxt, const char* ns, mode_t mode ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   return pctxt->info->posix->chmodnamespace( pctxt->inner, ns, mode );
+}
+
+/**
+ * Edit the ownership of the specified NS
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* ns : Name of the namespace target
+ * @param uid_t uid : New owner value for the NS
+ * @param gid_t gid : New group value for the NS
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_chownnamespace( const MDAL_CTXT ctxt, const char* ns, uid_t uid, gid_t gid ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   return pctxt->info->posix->chownnamespace( pctxt->inner, ns, uid, gid );
+}
+
+
+// Usage Functions
+
+/**
+ * Set data usage value for the current namespace
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param off_t bytes : Number of bytes used by the namespace
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int posixkvmdal_setdatausage( const MDAL_CTXT ctxt, off_t bytes ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   return pctxt->info->posix->setdatausage( pctxt->inner, bytes );
+}
+
+/**
+ * Retrieve the data usage value of the current namespace
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @return off_t : Number of bytes used by the namespace
+ */
+off_t posixkvmdal_getdatausage( const MDAL_CTXT ctxt ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   return pctxt->info->posix->getdatausage( pctxt->inner );
+}
+
+/**
+ * Set the inode usage value of the current namespace
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param off_t files : Number of inodes used by the namespace
+ * @return int : Zero on success, -1 if a failure occurred
+ */
+int posixkvmdal_setinodeusage( const MDAL_CTXT ctxt, off_t files ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   return pctxt->info->posix->setinodeusage( pctxt->inner, files );
+}
+
+/**
+ * Retrieve the inode usage value of the current namespace
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @return off_t : Number of inodes used by the current namespace
+ */
+off_t posixkvmdal_getinodeusage( const MDAL_CTXT ctxt ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   return pctxt->info->posix->getinodeusage( pctxt->inner );
+}
+
+
+// Reference Path Functions
+
+/**
+ * Create the specified reference directory
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* refdir : Path of the ref dir to be created
+ * @param mode_t mode : Mode value for the new dir
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_createrefdir( const MDAL_CTXT ctxt, const char* refdir, mode_t mode ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   // check for a valid NS target
+   if ( pctxt->store == NULL ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   char* key = pkventrykey( refdir, 0 );
+   if ( key == NULL ) { return -1; }
+   KVSTORE kv = pctxt->store->kv;
+   if ( kvstore_begin( kv, 1 ) ) {
+      LOG( LOG_ERR, "Failed to begin a transaction on store: \"%s\"\n", pctxt->store->path );
+      free( key );
+      return -1;
+   }
+   pkventry entry;
+   if ( pkvgetentry( kv, key, &(entry) ) == 0 ) {
+      kvstore_end( kv, 0 );
+      free( key );
+      errno = EEXIST;
+      return -1;
+   }
+   if ( errno != ENOENT  ||  pkvcheckparent( kv, key ) ) {
+      LOG( LOG_ERR, "Failed to verify target of ref dir creation: \"%s\"\n", refdir );
+      kvstore_end( kv, 0 );
+      free( key );
+      return -1;
+   }
+   bzero( &(entry), sizeof( pkventry ) );
+   entry.type = 'D';
+   entry.mode = S_IFDIR | ( mode & 07777 & ~(pctxt->info->umask) );
+   entry.uid = geteuid();
+   entry.gid = getegid();
+   entry.mtime = time( NULL );
+   int retval = kvstore_put( kv, key, &(entry), sizeof( pkventry ) );
+   if ( kvstore_end( kv, ( retval == 0 ) )  ||  retval ) {
+      LOG( LOG_ERR, "Failed to create ref dir: \"%s\"\n", refdir );
+      retval = -1;
+   }
+   free( key );
+   return retval;
+}
+
+/**
+ * Destroy the specified reference directory
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* refdir : Path of the ref dir to be destroyed
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_destroyrefdir( const MDAL_CTXT ctxt, const char* refdir ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   // check for a valid NS target
+   if ( pctxt->store == NULL ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   char* key = pkventrykey( refdir, 1 );
+   if ( key == NULL ) { return -1; }
+   size_t keylen = strlen( key );
+   if ( keylen == strlen( PKV_ENTRY ) ) {
+      LOG( LOG_ERR, "Cannot destroy the root of the reference tree\n" );
+      free( key );
+      errno = EBUSY;
+      return -1;
+   }
+   KVSTORE kv = pctxt->store->kv;
+   if ( kvstore_begin( kv, 1 ) ) {
+      LOG( LOG_ERR, "Failed to begin a transaction on store: \"%s\"\n", pctxt->store->path );
+      free( key );
+      return -1;
+   }
+   // check for any children of the dir
+   char* childkey = NULL;
+   size_t childsize = 0;
+   ssize_t res = pkvnextkey( kv, key, 1, &(childkey), &(childsize) );
+   if ( res < 0  ||  ( res  &&  strncmp( childkey, key, keylen ) == 0 ) ) {
+      if ( res > 0 ) { errno = ENOTEMPTY; }
+      LOG( LOG_ERR, "Failed to verify that ref dir is empty: \"%s\"\n", refdir );
+      kvstore_end( kv, 0 );
+      free( childkey );
+      free( key );
+      return -1;
+   }
+   free( childkey );
+   key[keylen - 1] = '\0'; // strip the trailing '/' of the child prefix
+   pkventry entry;
+   int retval = pkvgetentry( kv, key, &(entry) );
+   if ( retval == 0  &&  entry.type != 'D' ) { errno = ENOTDIR; retval = -1; }
+   if ( retval == 0 ) { retval = kvstore_delete( kv, key ); }
+   if ( kvstore_end( kv, ( retval == 0 ) )  ||  retval ) {
+      LOG( LOG_ERR, "Failed to destroy ref dir: \"%s\"\n", refdir );
+      retval = -1;
+   }
+   free( key );
+   return retval;
+}
+
+/**
+ * Hardlink the specified reference path to the specified user path
+ * NOTE -- user paths are linked via a placeholder symlink, resolved by this MDAL
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param char interref : Flag indicating that the destination will be another reference path
+ * @param const char* oldrpath : Reference path of the existing file target
+ * @param const char* newpath : Path at which to create the hardlink
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_linkref( const MDAL_CTXT ctxt, char interref, const char* oldrpath, const char* newpath ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   // check for a valid NS target
+   if ( pctxt->store == NULL ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   char* oldkey = pkventrykey( oldrpath, 0 );
+   if ( oldkey == NULL ) { return -1; }
+   char* newkey = NULL;
+   if ( interref  &&  (newkey = pkventrykey( newpath, 0 )) == NULL ) {
+      free( oldkey );
+      return -1;
+   }
+   KVSTORE kv = pctxt->store->kv;
+   if ( kvstore_begin( kv, 1 ) ) {
+      LOG( LOG_ERR, "Failed to begin a transaction on store: \"%s\"\n", pctxt->store->path );
+      free( newkey );
+      free( oldkey );
+      return -1;
+   }
+   pkventry entry;
+   int retval = pkvgetentry( kv, oldkey, &(entry) );
+   if ( retval == 0  &&  entry.type == 'D' ) { errno = EPERM; retval = -1; }
+   if ( retval == 0  &&  interref ) {
+      pkventry tgtentry;
+      if ( pkvgetentry( kv, newkey, &(tgtentry) ) == 0 ) { errno = EEXIST; retval = -1; }
+      else if ( errno != ENOENT  ||  pkvcheckparent( kv, newkey ) ) { retval = -1; }
+      else { retval = kvstore_put( kv, newkey, &(entry), sizeof( pkventry ) ); }
+   }
+   // NOTE -- the link count is always incremented prior to the creation of a placeholder
+   if ( retval == 0 ) { retval = pkvlinkcount( kv, entry.ino, 1 ); }
+   if ( kvstore_end( kv, ( retval == 0 ) )  ||  retval ) {
+      LOG( LOG_ERR, "Failed to link rpath \"%s\" to %s \"%s\"\n", oldrpath, (interref) ? "rpath" : "NS path", newpath );
+      free( newkey );
+      free( oldkey );
+      return -1;
+   }
+   free( newkey );
+   free( oldkey );
+   if ( interref ) { return 0; }
+   char target[PKV_LINKLEN + 1];
+   snprintf( target, PKV_LINKLEN + 1, "%s%016llx", PKV_LINK, (unsigned long long)entry.ino );
+   if ( pctxt->info->posix->symlink( pctxt->inner, target, newpath ) ) {
+      LOG( LOG_ERR, "Failed to create placeholder for rpath \"%s\" at NS path \"%s\"\n", oldrpath, newpath );
+      int origerrno = errno;
+      pkvlinkcounttxn( pctxt->store, entry.ino, -1 );
+      errno = origerrno;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Rename the specified reference path to a new reference path
+ * NOTE -- reference dirs cannot be renamed by this MDAL
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* from : String path of the reference
+ * @param const char* to : Destination string reference path
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_renameref( const MDAL_CTXT ctxt, const char* from, const char* to ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   // check for a valid NS target
+   if ( pctxt->store == NULL ) {
+      LOG( LOG_ERR, "Receieved an MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   char* fromkey = pkventrykey( from, 0 );
+   char* tokey = pkventrykey( to, 0 );
+   if ( fromkey == NULL  ||  tokey == NULL ) {
+      free( fromkey );
+      free( tokey );
+      return -1;
+   }
+   KVSTORE kv = pctxt->store->kv;
+   if ( kvstore_begin( kv, 1 ) ) {
+      LOG( LOG_ERR, "Failed to begin a transaction on store: \"%s\"\n", pctxt->store->path );
+      free( fromkey );
+      free( tokey );
+      return -1;
+   }
+   pkventry entry;
+   pkventry tgtentry;
+   int retval = pkvgetentry( kv, fromkey, &(entry) );
+   if ( retval == 0  &&  entry.type == 'D' ) {
+      LOG( LOG_ERR, "Renaming of reference dirs is unsupported\n" );
+      errno = ENOTSUP;
+      retval = -1;
+   }
+   if ( retval == 0  &&  pkvgetentry( kv, tokey, &(tgtentry) ) == 0 ) {
+      // replace the existing target
+      if ( tgtentry.type == 'D' ) { errno = EISDIR; retval = -1; }
+      else if ( tgtentry.ino != entry.ino ) { retval = pkvlinkcount( kv, tgtentry.ino, -1 ); }
+   }
+   else if ( retval == 0  &&  ( errno != ENOENT  ||  pkvcheckparent( kv, tokey ) ) ) { retval = -1; }
+   if ( retval == 0  &&  strcmp( fromkey, tokey ) ) {
+      retval = kvstore_put( kv, tokey, &(entry), sizeof( pkventry ) );
+      if ( retval == 0 ) { retval = kvstore_delete( kv, fromkey ); }
+   }
+   if ( kvstore_end( kv, ( retval == 0 ) )  ||  retval ) {
+      LOG( LOG_ERR, "Failed to rename rpath \"%s\" to \"%s\"\n", from, to );
+      retval = -1;
+   }
+   free( fromkey );
+   free( tokey );
+   return retval;
+}
+
+/**
+ * Unlink the specified file reference path
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* rpath : String path of the reference to unlink
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_unlinkref( const MDAL_CTXT ctxt, const char* rpath ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   // check for a valid NS target
+   if ( pctxt->store == NULL ) {
+      LOG( LOG_ERR, "Receieved an MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   char* key = pkventrykey( rpath, 0 );
+   if ( key == NULL ) { return -1; }
+   int retval = pkvunlinkkey( pctxt->store, key );
+   free( key );
+   return retval;
+}
+
+/**
+ * Stat the specified reference path
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* rpath : String path of the reference to stat
+ * @param struct stat* buf : Stat buffer to be populated
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_statref( const MDAL_CTXT ctxt, const char* rpath, struct stat* buf ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   // check for a valid NS target
+   if ( pctxt->store == NULL ) {
+      LOG( LOG_ERR, "Receieved an MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   char* key = pkventrykey( rpath, 0 );
+   if ( key == NULL ) { return -1; }
+   int retval = pkvstatkey( pctxt->store, key, buf );
+   free( key );
+   return retval;
+}
+
+/**
+ * Open a file handle for the specified reference path
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* rpath : String path of the reference to open
+ * @param int flags : Flags specifying behavior (see the 'open()' syscall 'flags' value for full info)
+ * @param mode_t mode : Mode value for file creation (see the 'open()' syscall 'mode' value for full info)
+ * @return MDAL_FHANDLE : An MDAL_READ handle for the target file, or NULL if a failure occurred
+ */
+MDAL_FHANDLE posixkvmdal_openref( const MDAL_CTXT ctxt, const char* rpath, int flags, mode_t mode ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   // check for a valid NS target
+   if ( pctxt->store == NULL ) {
+      LOG( LOG_ERR, "Receieved an MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   char* key = pkventrykey( rpath, 0 );
+   if ( key == NULL ) { return NULL; }
+   PKV_FHANDLE fh = pkvopenkey( pctxt->info, pctxt->store, key, flags, mode );
+   if ( fh == NULL ) { LOG( LOG_ERR, "Failed to open rpath: \"%s\"\n", rpath ); }
+   free( key );
+   return (MDAL_FHANDLE) fh;
+}
+
+/**
+ * Create a new file at the specified reference path and link it into the user namespace
+ * NOTE -- The new file is populated entirely in memory, then made visible at both paths
+ *         by a single store transaction, followed by the creation of its user placeholder.
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* rpath : String reference path of the new file
+ * @param mode_t mode : Mode value for file creation (see the 'open()' syscall 'mode' value for full info)
+ * @param const char* userpath : User-visible path at which to link the new file
+ * @param int (*populate)( MDAL_FHANDLE fh, void* arg ) : Function to be called on the new file
+ *                                                        prior to it becoming visible
+ *                                                        ( may be NULL )
+ * @param void* arg : Argument to be passed to the populate function
+ * @return MDAL_FHANDLE : An MDAL_WRITE handle for the new file, or NULL if a failure occurred
+ */
+MDAL_FHANDLE posixkvmdal_createref( const MDAL_CTXT ctxt, const char* rpath, mode_t mode, const char* userpath,
+                                    int (*populate)( MDAL_FHANDLE fh, void* arg ), void* arg ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   // check for a valid NS target
+   if ( pctxt->store == NULL ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   char* key = pkventrykey( rpath, 0 );
+   if ( key == NULL ) { return NULL; }
+   // populate an anonymous, in-memory inode
+   PKV_FHANDLE fh = pkvnewfhandle( pctxt->info, pctxt->store, 0, O_WRONLY );
+   if ( fh == NULL ) {
+      free( key );
+      return NULL;
+   }
+   fh->anonymous = 1;
+   pkvinodeinit( &(fh->cache), mode, pctxt->info->umask );
+   if ( populate  &&  populate( (MDAL_FHANDLE) fh, arg ) ) {
+      LOG( LOG_ERR, "Populate function failed for new rpath: \"%s\"\n", rpath );
+      pkvfreefhandle( fh );
+      free( key );
+      return NULL;
+   }
+   // store the inode and its reference entry, with an additional link for the placeholder
+   KVSTORE kv = pctxt->store->kv;
+   if ( kvstore_begin( kv, 1 ) ) {
+      LOG( LOG_ERR, "Failed to begin a transaction on store: \"%s\"\n", pctxt->store->path );
+      pkvfreefhandle( fh );
+      free( key );
+      return NULL;
+   }
+   pkventry entry;
+   int retval = 0;
+   if ( pkvgetentry( kv, key, &(entry) ) == 0 ) { errno = EEXIST; retval = -1; }
+   else if ( errno != ENOENT  ||  pkvcheckparent( kv, key ) ) { retval = -1; }
+   else if ( (fh->ino = pkvnewino( kv )) == 0 ) { retval = -1; }
+   if ( retval == 0 ) {
+      fh->cache.hdr.nlink = 2;
+      bzero( &(entry), sizeof( pkventry ) );
+      entry.type = 'F';
+      entry.ino = fh->ino;
+      retval = pkvinodesave( kv, fh->ino, &(fh->cache) );
+      if ( retval == 0 ) { retval = kvstore_put( kv, key, &(entry), sizeof( pkventry ) ); }
+   }
+   if ( kvstore_end( kv, ( retval == 0 ) )  ||  retval ) {
+      LOG( LOG_ERR, "Failed to store new rpath: \"%s\"\n", rpath );
+      pkvfreefhandle( fh );
+      free( key );
+      return NULL;
+   }
+   fh->anonymous = 0;
+   // link the file into the user namespace, replacing any existing target
+   char target[PKV_LINKLEN + 1];
+   snprintf( target, PKV_LINKLEN + 1, "%s%016llx", PKV_LINK, (unsigned long long)fh->ino );
+   MDAL posix = pctxt->info->posix;
+   while ( posix->symlink( pctxt->inner, target, userpath ) ) {
+      uint64_t oldino;
+      char oldplaceholder = 0;
+      if ( errno == EEXIST ) {
+         LOG( LOG_INFO, "Replacing existing NS path \"%s\"\n", userpath );
+         oldplaceholder = pkvplaceholder( pctxt->info, pctxt->inner, userpath, &(oldino) );
+      }
+      if ( errno != EEXIST  ||  ( posix->unlink( pctxt->inner, userpath )  &&  errno != ENOENT ) ) {
+         LOG( LOG_ERR, "Failed to link rpath \"%s\" to NS path \"%s\"\n", rpath, userpath );
+         int origerrno = errno;
+         if ( kvstore_begin( kv, 1 ) == 0 ) {
+            retval = kvstore_delete( kv, key );
+            char inokey[PKV_INOKEYLEN];
+            pkvinodekey( fh->ino, inokey );
+            if ( retval == 0 ) { retval = kvstore_delete( kv, inokey ); }
+            kvstore_end( kv, ( retval == 0 ) );
+         }
+         pkvfreefhandle( fh );
+         free( key );
+         errno = origerrno;
+         return NULL;
+      }
+      if ( oldplaceholder  &&  pkvlinkcounttxn( pctxt->store, oldino, -1 ) ) {
+         LOG( LOG_WARNING, "Failed to decrement link count of replaced inode %llu\n", (unsigned long long)oldino );
+      }
+   }
+   free( key );
+   return (MDAL_FHANDLE) fh;
+}
+
+
+// Scanner Functions
+
+/**
+ * Open a reference scanner for the given location of the current namespace
+ * @param const MDAL_CTXT ctxt : Current MDAL context
+ * @param const char* rpath : Reference location to scan
+ * @return MDAL_SCANNER : Newly opened reference scanner
+ */
+MDAL_SCANNER posixkvmdal_openscanner( const MDAL_CTXT ctxt, const char* rpath ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   // check for a valid NS target
+   if ( pctxt->store == NULL ) {
+      LOG( LOG_ERR, "Receieved a MDAL_CTXT with no namespace target\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   PKV_SCANNER scanner = calloc( 1, sizeof( struct posixkv_scanner_struct ) );
+   if ( scanner == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new scanner struct\n" );
+      return NULL;
+   }
+   scanner->prefix = pkventrykey( rpath, 1 );
+   if ( scanner->prefix == NULL ) {
+      free( scanner );
+      return NULL;
+   }
+   scanner->prefixlen = strlen( scanner->prefix );
+   scanner->cursor = strdup( scanner->prefix );
+   if ( scanner->cursor == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate scanner cursor\n" );
+      free( scanner->prefix );
+      free( scanner );
+      return NULL;
+   }
+   scanner->cursorsize = scanner->prefixlen + 1;
+   scanner->inclusive = 1;
+   // verify that the target is an existing dir
+   int retval = kvstore_begin( pctxt->store->kv, 0 );
+   if ( retval == 0 ) {
+      pkventry entry;
+      if ( scanner->prefixlen > strlen( PKV_ENTRY ) ) { scanner->prefix[scanner->prefixlen - 1] = '\0'; }
+      retval = pkvgetentry( pctxt->store->kv, scanner->prefix, &(entry) );
+      if ( retval == 0  &&  entry.type != 'D' ) { errno = ENOTDIR; retval = -1; }
+      if ( scanner->prefixlen > strlen( PKV_ENTRY ) ) { scanner->prefix[scanner->prefixlen - 1] = '/'; }
+      kvstore_end( pctxt->store->kv, 0 );
+   }
+   if ( retval ) {
+      LOG( LOG_ERR, "Failed to verify target of scanner: \"%s\"\n", rpath );
+      free( scanner->cursor );
+      free( scanner->prefix );
+      free( scanner );
+      return NULL;
+   }
+   scanner->info = pctxt->info;
+   scanner->store = pctxt->store;
+   pthread_mutex_lock( &(pctxt->info->lock) );
+   scanner->store->refcnt++;
+   pthread_mutex_unlock( &(pctxt->info->lock) );
+   return (MDAL_SCANNER) scanner;
+}
+
+/**
+ * Close a given reference scanner
+ * @param MDAL_SCANNER scanner : Reference scanner to be closed
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_closescanner( MDAL_SCANNER scanner ) {
+   // check for a NULL scanner
+   if ( !(scanner) ) {
+      LOG( LOG_ERR, "Received a NULL scanner reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_SCANNER pscanner = (PKV_SCANNER) scanner;
+   pkvreleasestore( pscanner->info, pscanner->store );
+   free( pscanner->keybuf );
+   free( pscanner->cursor );
+   free( pscanner->prefix );
+   free( pscanner );
+   return 0;
+}
+
+/**
+ * Iterate over a reference scanner
+ * NOTE -- entries are retrieved in sorted batches, each via a single store transaction
+ * @param MDAL_SCANNER scanner : Reference scanner to iterate over
+ * @return struct dirent* : Reference to a directory entry, or NULL if the end of the
+ *                          scanner was reached or an error occurred
+ */
+struct dirent* posixkvmdal_scan( MDAL_SCANNER scanner ) {
+   // check for a NULL scanner
+   if ( !(scanner) ) {
+      LOG( LOG_ERR, "Received a NULL scanner reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   PKV_SCANNER pscanner = (PKV_SCANNER) scanner;
+   if ( pscanner->batchindex >= pscanner->batchcount ) {
+      if ( pscanner->done ) { return NULL; }
+      int origerrno = errno;
+      if ( pkvscanbatch( pscanner ) ) {
+         LOG( LOG_ERR, "Failed to retrieve the next batch of scanner entries\n" );
+         return NULL;
+      }
+      errno = origerrno; // reaching the end of the scanner is not an error
+      if ( pscanner->batchcount == 0 ) { return NULL; }
+   }
+   return pscanner->batch + (pscanner->batchindex++);
+}
+
+/**
+ * Open a file, relative to a given reference scanner
+ * @param MDAL_SCANNER scanner : Reference scanner to open relative to
+ * @param const char* spath : Relative path of the target file from the scanner
+ * @return MDAL_FHANDLE : An MDAL_READ handle for the target file, or NULL if a failure occurred
+ */
+MDAL_FHANDLE posixkvmdal_sopen( MDAL_SCANNER scanner, const char* spath ) {
+   // check for a NULL scanner
+   if ( !(scanner) ) {
+      LOG( LOG_ERR, "Received a NULL scanner reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   PKV_SCANNER pscanner = (PKV_SCANNER) scanner;
+   char* key = pkvscannerkey( pscanner, spath );
+   if ( key == NULL ) { return NULL; }
+   PKV_FHANDLE fh = pkvopenkey( pscanner->info, pscanner->store, key, O_RDONLY, 0 );
+   free( key );
+   return (MDAL_FHANDLE) fh;
+}
+
+/**
+ * Unlink a file, relative to a given reference scanner
+ * @param MDAL_SCANNER scanner : Reference scanner to unlink relative to
+ * @param const char* spath : Relative path of the target file from the scanner
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_sunlink( MDAL_SCANNER scanner, const char* spath ) {
+   // check for a NULL scanner
+   if ( !(scanner) ) {
+      LOG( LOG_ERR, "Received a NULL scanner reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_SCANNER pscanner = (PKV_SCANNER) scanner;
+   char* key = pkvscannerkey( pscanner, spath );
+   if ( key == NULL ) { return -1; }
+   int retval = pkvunlinkkey( pscanner->store, key );
+   free( key );
+   return retval;
+}
+
+/**
+ * Stat a file, relative to a given reference scanner
+ * @param MDAL_SCANNER scanner : Reference scanner to stat relative to
+ * @param const char* spath : Relative path of the target file from the scanner
+ * @param struct stat* buf : Stat buffer to be populated
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_sstat( MDAL_SCANNER scanner, const char* spath, struct stat* buf ) {
+   // check for a NULL scanner
+   if ( !(scanner) ) {
+      LOG( LOG_ERR, "Received a NULL scanner reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_SCANNER pscanner = (PKV_SCANNER) scanner;
+   char* key = pkvscannerkey( pscanner, spath );
+   if ( key == NULL ) { return -1; }
+   int retval = pkvstatkey( pscanner->store, key, buf );
+   free( key );
+   return retval;
+}
+
+
+// DIR Handle Functions
+
+/**
+ * Open a directory, relative to the given MDAL_CTXT
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : Relative path of the target directory from the ctxt
+ * @return MDAL_DHANDLE : Open directory handle, or NULL if a failure occurred
+ */
+MDAL_DHANDLE posixkvmdal_opendir( const MDAL_CTXT ctxt, const char* path ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   MDAL_DHANDLE pdh = pctxt->info->posix->opendir( pctxt->inner, path );
+   if ( pdh == NULL ) { return NULL; }
+   PKV_DHANDLE dh = pkvnewdhandle( pctxt->info, pdh, pctxt, path );
+   if ( dh == NULL ) {
+      pctxt->info->posix->closedir( pdh );
+      return NULL;
+   }
+   return (MDAL_DHANDLE) dh;
+}
+
+/**
+ * Set the specified directory as the new target of the given MDAL_CTXT
+ * @param MDAL_CTXT ctxt : MDAL_CTXT to update
+ * @param MDAL_DHANDLE dh : Directory handle to use as the new ctxt target
+ *                          NOTE -- this handle will be consumed by this function
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_chdir( MDAL_CTXT ctxt, MDAL_DHANDLE dh ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_DHANDLE reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_DHANDLE pdh = (PKV_DHANDLE) dh;
+   if ( pctxt->info->posix->chdir( pctxt->inner, pdh->pdh ) ) { return -1; }
+   pkvfreedhandle( pdh );
+   return 0;
+}
+
+/**
+ * Set an xattr on the dir referenced by the given directory handle
+ * @param MDAL_DHANDLE dh : Directory handle to operate on
+ * @param char hidden : A non-zero value indicates to store this as a 'hidden' MDAL value
+ * @param const char* name : String name of the xattr to set
+ * @param const void* value : Buffer containing the value of the xattr
+ * @param size_t size : Size of the value buffer
+ * @param int flags : Zero value    - create or replace the xattr
+ *                    XATTR_CREATE  - create the xattr only (fail if xattr exists)
+ *                    XATTR_REPLACE - replace the xattr only (fail if xattr missing)
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_dsetxattr( MDAL_DHANDLE dh, char hidden, const char* name, const void* value, size_t size, int flags ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL dir handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_DHANDLE pdh = (PKV_DHANDLE) dh;
+   return pdh->info->posix->dsetxattr( pdh->pdh, hidden, name, value, size, flags );
+}
+
+/**
+ * Retrieve an xattr from the dir referenced by the given directory handle
+ * @param MDAL_DHANDLE dh : Directory handle to operate on
+ * @param char hidden : A non-zero value indicates to retrieve a 'hidden' MDAL value
+ * @param const char* name : String name of the xattr to retrieve
+ * @param void* value : Buffer to be populated with the xattr value
+ * @param size_t size : Size of the target buffer
+ * @return ssize_t : Size of the returned xattr value, or -1 if a failure occurred
+ */
+ssize_t posixkvmdal_dgetxattr( MDAL_DHANDLE dh, char hidden, const char* name, void* value, size_t size ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL dir handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_DHANDLE pdh = (PKV_DHANDLE) dh;
+   return pdh->info->posix->dgetxattr( pdh->pdh, hidden, name, value, size );
+}
+
+/**
+ * Remove an xattr from the dir referenced by the given directory handle
+ * @param MDAL_DHANDLE dh : Directory handle to operate on
+ * @param char hidden : A non-zero value indicates to remove a 'hidden' MDAL value
+ * @param const char* name : String name of the xattr to remove
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_dremovexattr( MDAL_DHANDLE dh, char hidden, const char* name ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL dir handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_DHANDLE pdh = (PKV_DHANDLE) dh;
+   return pdh->info->posix->dremovexattr( pdh->pdh, hidden, name );
+}
+
+/**
+ * List all xattr names from the dir referenced by the given directory handle
+ * @param MDAL_DHANDLE dh : Directory handle to operate on
+ * @param char hidden : A non-zero value indicates to list 'hidden' MDAL xattrs
+ *                      ( normal xattrs excluded )
+ * @param char* buf : Buffer to be populated with xattr names
+ * @param size_t size : Size of the target buffer
+ * @return ssize_t : Size of the returned xattr name list, or -1 if a failure occurred
+ */
+ssize_t posixkvmdal_dlistxattr( MDAL_DHANDLE dh, char hidden, char* buf, size_t size ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL dir handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_DHANDLE pdh = (PKV_DHANDLE) dh;
+   return pdh->info->posix->dlistxattr( pdh->pdh, hidden, buf, size );
+}
+
+/**
+ * Iterate to the next entry of an open directory handle
+ * NOTE -- placeholder entries are reported as regular files
+ * @param MDAL_DHANDLE dh : MDAL_DHANDLE to read from
+ * @return struct dirent* : Reference to the next directory entry, or NULL if the end of the
+ *                          directory was reached or an error occurred
+ */
+struct dirent* posixkvmdal_readdir( MDAL_DHANDLE dh ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL dir handle reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   PKV_DHANDLE pdh = (PKV_DHANDLE) dh;
+   struct dirent* dent = pdh->info->posix->readdir( pdh->pdh );
+   uint64_t ino;
+   if ( dent  &&  dent->d_type == DT_LNK  &&  pkvdirplaceholder( pdh, dent->d_name, &(ino) ) ) {
+      dent->d_type = DT_REG;
+   }
+   return dent;
+}
+
+/**
+ * Iterate to the next entry of an open directory handle, also retrieving attributes
+ * NOTE -- placeholder entries report the attributes of their store inode
+ * @param MDAL_DHANDLE dh : MDAL_DHANDLE to read from
+ * @param struct stat* st : Stat buffer to be populated with the attributes of the entry
+ * @return struct dirent* : Reference to the next directory entry, or NULL if the end of the
+ *                          directory was reached or an error occurred
+ */
+struct dirent* posixkvmdal_readdirplus( MDAL_DHANDLE dh, struct stat* st ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL dir handle reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   PKV_DHANDLE pdh = (PKV_DHANDLE) dh;
+   struct dirent* dent = pdh->info->posix->readdirplus( pdh->pdh, st );
+   uint64_t ino;
+   if ( dent  &&  S_ISLNK( st->st_mode )  &&  pkvdirplaceholder( pdh, dent->d_name, &(ino) ) ) {
+      pkvinode inode;
+      if ( kvstore_begin( pdh->store->kv, 0 ) == 0 ) {
+         if ( pkvinodeload( pdh->store->kv, ino, &(inode) ) == 0 ) {
+            pkvinodestat( pdh->store, ino, &(inode), st );
+            dent->d_type = DT_REG;
+            pkvinodefree( &(inode) );
+         }
+         else { LOG( LOG_WARNING, "Failed to load inode of placeholder: \"%s\"\n", dent->d_name ); }
+         kvstore_end( pdh->store->kv, 0 );
+      }
+   }
+   return dent;
+}
+
+/**
+ * Close the given directory handle
+ * @param MDAL_DHANDLE dh : MDAL_DHANDLE to close
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_closedir( MDAL_DHANDLE dh ) {
+   // check for a NULL dir handle
+   if ( !(dh) ) {
+      LOG( LOG_ERR, "Received a NULL dir handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_DHANDLE pdh = (PKV_DHANDLE) dh;
+   int retval = pdh->info->posix->closedir( pdh->pdh );
+   pkvfreedhandle( pdh );
+   return retval;
+}
+
+
+// FILE Handle Functions
+
+/**
+ * Open a file, relative to the given MDAL_CTXT
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : Relative path to the target file from the ctxt
+ * @param int flags : Flags specifying behavior (see the 'open()' syscall 'flags' value for full info)
+ *                    Note -- This function CANNOT create new files ( O_CREAT is forbidden )
+ * @return MDAL_FHANDLE : An MDAL_FHANDLE reference, or NULL if a failure occurred
+ */
+MDAL_FHANDLE posixkvmdal_open( const MDAL_CTXT ctxt, const char* path, int flags ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   uint64_t ino;
+   if ( pctxt->store  &&  !(flags & O_CREAT)  &&  pkvplaceholder( pctxt->info, pctxt->inner, path, &(ino) ) ) {
+      PKV_FHANDLE fh = pkvnewfhandle( pctxt->info, pctxt->store, ino, flags );
+      if ( fh == NULL ) { return NULL; }
+      // populate our initial inode state
+      pkvinode inode;
+      char truncate = ( ( flags & O_TRUNC )  &&  ( flags & O_ACCMODE ) != O_RDONLY );
+      if ( pkvfhbegin( fh, truncate, &(inode) ) ) {
+         LOG( LOG_ERR, "Failed to retrieve inode of placeholder: \"%s\"\n", path );
+         pkvfreefhandle( fh );
+         return NULL;
+      }
+      if ( truncate ) {
+         inode.hdr.size = 0;
+         inode.hdr.datalen = 0;
+         pkvinodetouch( &(inode), 1 );
+      }
+      if ( pkvfhend( fh, &(inode), truncate ) ) {
+         pkvfreefhandle( fh );
+         return NULL;
+      }
+      return (MDAL_FHANDLE) fh;
+   }
+   MDAL_FHANDLE pfh = pctxt->info->posix->open( pctxt->inner, path, flags );
+   if ( pfh == NULL ) { return NULL; }
+   PKV_FHANDLE fh = pkvnewfhandle( pctxt->info, NULL, 0, flags );
+   if ( fh == NULL ) {
+      pctxt->info->posix->close( pfh );
+      return NULL;
+   }
+   fh->pfh = pfh;
+   return (MDAL_FHANDLE) fh;
+}
+
+/**
+ * Close the given MDAL_FHANDLE
+ * @param MDAL_FHANDLE fh : File handle to be closed
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_close( MDAL_FHANDLE fh ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_FHANDLE pfh = (PKV_FHANDLE) fh;
+   int retval = 0;
+   if ( pfh->pfh ) { retval = pfh->info->posix->close( pfh->pfh ); }
+   pkvfreefhandle( pfh );
+   return retval;
+}
+
+/**
+ * Write data to the given MDAL_FHANDLE
+ * @param MDAL_FHANDLE fh : File handle to be written to
+ * @param const void* buf : Buffer containing the data to be written
+ * @param size_t count : Number of data bytes contained within the buffer
+ * @return ssize_t : Number of bytes written, or -1 if a failure occurred
+ */
+ssize_t posixkvmdal_write( MDAL_FHANDLE fh, const void* buf, size_t count ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_FHANDLE pfh = (PKV_FHANDLE) fh;
+   if ( pfh->pfh ) { return pfh->info->posix->write( pfh->pfh, buf, count ); }
+   if ( ( pfh->flags & O_ACCMODE ) == O_RDONLY ) {
+      LOG( LOG_ERR, "Cannot write to a read-only file handle\n" );
+      errno = EBADF;
+      return -1;
+   }
+   pkvinode inode;
+   if ( pkvfhbegin( pfh, 1, &(inode) ) ) { return -1; }
+   off_t offset = ( pfh->flags & O_APPEND ) ? inode.hdr.size : pfh->offset;
+   if ( offset + count > PKV_MAXDATA ) {
+      LOG( LOG_ERR, "Write would exceed the maximum content length of store files\n" );
+      pkvfhend( pfh, &(inode), 0 );
+      errno = EFBIG;
+      return -1;
+   }
+   if ( offset + count > inode.hdr.datalen ) {
+      char* newdata = realloc( inode.data, offset + count );
+      if ( newdata == NULL ) {
+         LOG( LOG_ERR, "Failed to expand file content to %zu bytes\n", (size_t)(offset + count) );
+         pkvfhend( pfh, &(inode), 0 );
+         return -1;
+      }
+      if ( offset > inode.hdr.datalen ) { bzero( newdata + inode.hdr.datalen, offset - inode.hdr.datalen ); }
+      inode.data = newdata;
+      inode.hdr.datalen = offset + count;
+   }
+   memcpy( inode.data + offset, buf, count );
+   if ( offset + count > inode.hdr.size ) { inode.hdr.size = offset + count; }
+   pkvinodetouch( &(inode), 1 );
+   if ( pkvfhend( pfh, &(inode), 1 ) ) { return -1; }
+   pfh->offset = offset + count;
+   return count;
+}
+
+/**
+ * Read data from the given MDAL_FHANDLE
+ * @param MDAL_FHANDLE fh : File handle to be read from
+ * @param void* buf : Buffer to be populated with read data
+ * @param size_t count : Number of bytes to be read
+ * @return ssize_t : Number of bytes read, or -1 if a failure occurred
+ */
+ssize_t posixkvmdal_read( MDAL_FHANDLE fh, void* buf, size_t count ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_FHANDLE pfh = (PKV_FHANDLE) fh;
+   if ( pfh->pfh ) { return pfh->info->posix->read( pfh->pfh, buf, count ); }
+   pkvinode inode;
+   if ( pkvfhbegin( pfh, 0, &(inode) ) ) { return -1; }
+   size_t readcnt = 0;
+   if ( pfh->offset < inode.hdr.size ) {
+      readcnt = inode.hdr.size - pfh->offset;
+      if ( readcnt > count ) { readcnt = count; }
+      // content beyond the stored data is sparse
+      size_t datacnt = 0;
+      if ( pfh->offset < inode.hdr.datalen ) {
+         datacnt = inode.hdr.datalen - pfh->offset;
+         if ( datacnt > readcnt ) { datacnt = readcnt; }
+         memcpy( buf, inode.data + pfh->offset, datacnt );
+      }
+      bzero( (char*)buf + datacnt, readcnt - datacnt );
+   }
+   if ( pkvfhend( pfh, &(inode), 0 ) ) { return -1; }
+   pfh->offset += readcnt;
+   return readcnt;
+}
+
+/**
+ * Truncate the file referenced by the given MDAL_FHANDLE
+ * @param MDAL_FHANDLE fh : File handle to be truncated
+ * @param off_t length : File length to truncate to
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_ftruncate( MDAL_FHANDLE fh, off_t length ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_FHANDLE pfh = (PKV_FHANDLE) fh;
+   if ( pfh->pfh ) { return pfh->info->posix->ftruncate( pfh->pfh, length ); }
+   if ( length < 0 ) { errno = EINVAL; return -1; }
+   if ( ( pfh->flags & O_ACCMODE ) == O_RDONLY ) {
+      LOG( LOG_ERR, "Cannot truncate a read-only file handle\n" );
+      errno = EBADF;
+      return -1;
+   }
+   pkvinode inode;
+   if ( pkvfhbegin( pfh, 1, &(inode) ) ) { return -1; }
+   inode.hdr.size = length;
+   if ( inode.hdr.datalen > length ) { inode.hdr.datalen = length; }
+   pkvinodetouch( &(inode), 1 );
+   return pkvfhend( pfh, &(inode), 1 );
+}
+
+/**
+ * Seek to the specified position in the file referenced by the given MDAL_FHANDLE
+ * @param MDAL_FHANDLE fh : File handle to seek
+ * @param off_t offset : Offset for the seek
+ * @param int whence : Flag defining seek start location ( see 'lseek()' syscall manpage )
+ * @return off_t : Resulting offset within the file, or -1 if a failure occurred
+ */
+off_t posixkvmdal_lseek( MDAL_FHANDLE fh, off_t offset, int whence ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_FHANDLE pfh = (PKV_FHANDLE) fh;
+   if ( pfh->pfh ) { return pfh->info->posix->lseek( pfh->pfh, offset, whence ); }
+   off_t base = 0;
+   if ( whence == SEEK_CUR ) { base = pfh->offset; }
+   else if ( whence == SEEK_END ) {
+      pkvinode inode;
+      if ( pkvfhbegin( pfh, 0, &(inode) ) ) { return -1; }
+      base = inode.hdr.size;
+      if ( pkvfhend( pfh, &(inode), 0 ) ) { return -1; }
+   }
+   else if ( whence != SEEK_SET ) { errno = EINVAL; return -1; }
+   if ( base + offset < 0 ) { errno = EINVAL; return -1; }
+   pfh->offset = base + offset;
+   return pfh->offset;
+}
+
+/**
+ * Set an xattr on the file referenced by the given MDAL_FHANDLE
+ * @param MDAL_FHANDLE fh : File handle for which to set the xattr
+ * @param char hidden : A non-zero value indicates to store this as a 'hidden' MDAL value
+ * @param const char* name : String name of the xattr to set
+ * @param const void* value : Buffer containing the value of the xattr
+ * @param size_t size : Size of the value buffer
+ * @param int flags : Zero value    - create or replace the xattr
+ *                    XATTR_CREATE  - create the xattr only (fail if xattr exists)
+ *                    XATTR_REPLACE - replace the xattr only (fail if xattr missing)
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_fsetxattr( MDAL_FHANDLE fh, char hidden, const char* name, const void* value, size_t size, int flags ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_FHANDLE pfh = (PKV_FHANDLE) fh;
+   if ( pfh->pfh ) { return pfh->info->posix->fsetxattr( pfh->pfh, hidden, name, value, size, flags ); }
+   char* fullname = pkvxattrname( hidden, name );
+   if ( fullname == NULL ) { return -1; }
+   pkvinode inode;
+   if ( pkvfhbegin( pfh, 1, &(inode) ) ) {
+      free( fullname );
+      return -1;
+   }
+   int retval = pkvxattrset( &(inode), fullname, value, size, flags );
+   if ( retval ) {
+      LOG( LOG_ERR, "fsetxattr failure for \"%s\" value (%s)\n", fullname, strerror(errno) );
+      int origerrno = errno;
+      pkvfhend( pfh, &(inode), 0 );
+      errno = origerrno;
+   }
+   else {
+      pkvinodetouch( &(inode), 0 );
+      retval = pkvfhend( pfh, &(inode), 1 );
+   }
+   free( fullname );
+   return retval;
+}
+
+/**
+ * Retrieve the specified xattr from the file referenced by the given MDAL_FHANDLE
+ * @param MDAL_FHANDLE fh : File handle for which to retrieve the xattr
+ * @param char hidden : A non-zero value indicates to retrieve a 'hidden' MDAL value
+ * @param const char* name : String name of the xattr to retrieve
+ * @param void* value : Buffer to be populated with the xattr value
+ * @param size_t size : Size of the target buffer
+ * @return ssize_t : Size of the returned xattr value, or -1 if a failure occurred
+ */
+ssize_t posixkvmdal_fgetxattr( MDAL_FHANDLE fh, char hidden, const char* name, void* value, size_t size ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_FHANDLE pfh = (PKV_FHANDLE) fh;
+   if ( pfh->pfh ) { return pfh->info->posix->fgetxattr( pfh->pfh, hidden, name, value, size ); }
+   char* fullname = pkvxattrname( hidden, name );
+   if ( fullname == NULL ) { return -1; }
+   pkvinode inode;
+   if ( pkvfhbegin( pfh, 0, &(inode) ) ) {
+      free( fullname );
+      return -1;
+   }
+   ssize_t retval = pkvxattrget( &(inode), fullname, value, size );
+   int origerrno = errno;
+   if ( pkvfhend( pfh, &(inode), 0 ) ) { retval = -1; }
+   else { errno = origerrno; }
+   free( fullname );
+   return retval;
+}
+
+/**
+ * Remove the specified xattr from the file referenced by the given MDAL_FHANDLE
+ * @param MDAL_FHANDLE fh : File handle for which to remove the xattr
+ * @param char hidden : A non-zero value indicates to remove a 'hidden' MDAL value
+ * @param const char* name : String name of the xattr to remove
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_fremovexattr( MDAL_FHANDLE fh, char hidden, const char* name ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_FHANDLE pfh = (PKV_FHANDLE) fh;
+   if ( pfh->pfh ) { return pfh->info->posix->fremovexattr( pfh->pfh, hidden, name ); }
+   char* fullname = pkvxattrname( hidden, name );
+   if ( fullname == NULL ) { return -1; }
+   pkvinode inode;
+   if ( pkvfhbegin( pfh, 1, &(inode) ) ) {
+      free( fullname );
+      return -1;
+   }
+   int retval = pkvxattrremove( &(inode), fullname );
+   if ( retval ) {
+      int origerrno = errno;
+      pkvfhend( pfh, &(inode), 0 );
+      errno = origerrno;
+   }
+   else {
+      pkvinodetouch( &(inode), 0 );
+      retval = pkvfhend( pfh, &(inode), 1 );
+   }
+   free( fullname );
+   return retval;
+}
+
+/**
+ * List all xattr names from the file referenced by the given MDAL_FHANDLE
+ * @param MDAL_FHANDLE fh : File handle for which to list xattrs
+ * @param char hidden : A non-zero value indicates to list 'hidden' MDAL xattrs
+ *                      ( normal xattrs excluded )
+ * @param char* buf : Buffer to be populated with xattr names
+ * @param size_t size : Size of the target buffer
+ * @return ssize_t : Size of the returned xattr name list, or -1 if a failure occurred
+ */
+ssize_t posixkvmdal_flistxattr( MDAL_FHANDLE fh, char hidden, char* buf, size_t size ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_FHANDLE pfh = (PKV_FHANDLE) fh;
+   if ( pfh->pfh ) { return pfh->info->posix->flistxattr( pfh->pfh, hidden, buf, size ); }
+   pkvinode inode;
+   if ( pkvfhbegin( pfh, 0, &(inode) ) ) { return -1; }
+   ssize_t retval = pkvxattrlist( &(inode), hidden, buf, size );
+   int origerrno = errno;
+   if ( pkvfhend( pfh, &(inode), 0 ) ) { retval = -1; }
+   else { errno = origerrno; }
+   return retval;
+}
+
+/**
+ * Perform a stat operation on the file referenced by the given MDAL_FHANDLE
+ * @param MDAL_FHANDLE fh : File handle to stat
+ * @param struct stat* buf : Reference to a stat buffer to be populated
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_fstat( MDAL_FHANDLE fh, struct stat* buf ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_FHANDLE pfh = (PKV_FHANDLE) fh;
+   if ( pfh->pfh ) { return pfh->info->posix->fstat( pfh->pfh, buf ); }
+   pkvinode inode;
+   if ( pkvfhbegin( pfh, 0, &(inode) ) ) { return -1; }
+   pkvinodestat( pfh->store, pfh->ino, &(inode), buf );
+   if ( pfh->anonymous ) { buf->st_nlink = 0; }
+   return pkvfhend( pfh, &(inode), 0 );
+}
+
+/**
+ * Update the timestamps of the target file
+ * @param MDAL_FHANDLE fh : File handle on which to set timestamps
+ * @param const struct timespec times[2] : Struct references for new times
+ *                                         times[0] - atime values
+ *                                         times[1] - mtime values
+ *                                         (see man utimensat for struct reference)
+ * @return int : Zero value on success, or -1 if a failure occurred
+ */
+int posixkvmdal_futimens( MDAL_FHANDLE fh, const struct timespec times[2] ) {
+   // check for a NULL file handle
+   if ( !(fh) ) {
+      LOG( LOG_ERR, "Received a NULL file handle reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   PKV_FHANDLE pfh = (PKV_FHANDLE) fh;
+   if ( pfh->pfh ) { return pfh->info->posix->futimens( pfh->pfh, times ); }
+   pkvinode inode;
+   if ( pkvfhbegin( pfh, 1, &(inode) ) ) { return -1; }
+   pkvinodetimes( &(inode), times );
+   return pkvfhend( pfh, &(inode), 1 );
+}
+
+
+// Path Functions
+
+/**
+ * Check access to the specified file
+ * NOTE -- access to placeholders is evaluated against the attributes of their store inode
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the target file
+ * @param int mode : F_OK - check for file existence
+ *                      or a bitwise OR of the following...
+ *                   R_OK - check for read access
+ *                   W_OK - check for write access
+ *                   X_OK - check for execute access
+ * @param int flags : A bitwise OR of the following...
+ *                    AT_EACCESS - Perform access checks using effective uid/gid
+ *                    AT_SYMLINK_NOFOLLOW - do not dereference a symlink target
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_access( const MDAL_CTXT ctxt, const char* path, int mode, int flags ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   uint64_t ino;
+   if ( pctxt->store == NULL  ||  !(pkvplaceholder( pctxt->info, pctxt->inner, path, &(ino) )) ) {
+      return pctxt->info->posix->access( pctxt->inner, path, mode, flags );
+   }
+   pkvinode inode;
+   if ( pkvinodebegin( pctxt->store, ino, 0, &(inode) ) ) { return -1; }
+   pkvheader hdr = inode.hdr;
+   pkvinodeend( pctxt->store, ino, &(inode), 0 );
+   if ( mode == F_OK ) { return 0; }
+   uid_t uid = ( flags & AT_EACCESS ) ? geteuid() : getuid();
+   gid_t gid = ( flags & AT_EACCESS ) ? getegid() : getgid();
+   int need = ( ( mode & R_OK ) ? 4 : 0 ) | ( ( mode & W_OK ) ? 2 : 0 ) | ( ( mode & X_OK ) ? 1 : 0 );
+   int have = hdr.mode & 07;
+   if ( uid == 0 ) {
+      // root is only restricted by a complete lack of execute permission
+      have = ( hdr.mode & 0111 ) ? 7 : 6;
+   }
+   else if ( uid == hdr.uid ) { have = ( hdr.mode >> 6 ) & 07; }
+   else {
+      char member = ( gid == hdr.gid );
+      gid_t groups[NGROUPS_MAX];
+      int groupcnt = getgroups( NGROUPS_MAX, groups );
+      int index;
+      for ( index = 0; !(member)  &&  index < groupcnt; index++ ) {
+         if ( groups[index] == hdr.gid ) { member = 1; }
+      }
+      if ( member ) { have = ( hdr.mode >> 3 ) & 07; }
+   }
+   if ( ( have & need ) != need ) {
+      errno = EACCES;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Create a new filesystem node
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the new file
+ * @param mode_t mode : Mode value of the new file ( see the 'mknod()' syscall for details )
+ * @param dev_t dev : Device value of the new file ( see the 'mknod()' syscall for details )
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_mknod( const MDAL_CTXT ctxt, const char* path, mode_t mode, dev_t dev ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   return pctxt->info->posix->mknod( pctxt->inner, path, mode, dev );
+}
+
+/**
+ * Edit the mode of the specified file
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the target file
+ * @param mode_t mode : New mode value for the file (see inode man page)
+ * @param int flags : A bitwise OR of the following...
+ *                    AT_SYMLINK_NOFOLLOW - do not dereference a symlink target
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_chmod( const MDAL_CTXT ctxt, const char* path, mode_t mode, int flags ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   uint64_t ino;
+   if ( pctxt->store == NULL  ||  !(pkvplaceholder( pctxt->info, pctxt->inner, path, &(ino) )) ) {
+      return pctxt->info->posix->chmod( pctxt->inner, path, mode, flags );
+   }
+   pkvinode inode;
+   if ( pkvinodebegin( pctxt->store, ino, 1, &(inode) ) ) { return -1; }
+   inode.hdr.mode = S_IFREG | ( mode & 07777 );
+   pkvinodetouch( &(inode), 0 );
+   return pkvinodeend( pctxt->store, ino, &(inode), 1 );
+}
+
+/**
+ * Edit the ownership and group of the specified file
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the target file
+ * @param uid_t owner : New owner
+ * @param gid_t group : New group
+ * @param int flags : A bitwise OR of the following...
+ *                    AT_SYMLINK_NOFOLLOW - do not dereference a symlink target
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_chown( const MDAL_CTXT ctxt, const char* path, uid_t owner, gid_t group, int flags ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   uint64_t ino;
+   if ( pctxt->store == NULL  ||  !(pkvplaceholder( pctxt->info, pctxt->inner, path, &(ino) )) ) {
+      return pctxt->info->posix->chown( pctxt->inner, path, owner, group, flags );
+   }
+   pkvinode inode;
+   if ( pkvinodebegin( pctxt->store, ino, 1, &(inode) ) ) { return -1; }
+   if ( owner != (uid_t)-1 ) { inode.hdr.uid = owner; }
+   if ( group != (gid_t)-1 ) { inode.hdr.gid = group; }
+   pkvinodetouch( &(inode), 0 );
+   return pkvinodeend( pctxt->store, ino, &(inode), 1 );
+}
+
+/**
+ * Stat the specified file
+ * NOTE -- placeholders report the attributes of their store inode
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the target file
+ * @param struct stat* st : Stat structure to be populated
+ * @param int flags : A bitwise OR of the following...
+ *                    AT_SYMLINK_NOFOLLOW - do not dereference a symlink target
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_stat( const MDAL_CTXT ctxt, const char* path, struct stat* st, int flags ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   MDAL posix = pctxt->info->posix;
+   if ( posix->stat( pctxt->inner, path, st, flags | AT_SYMLINK_NOFOLLOW ) ) { return -1; }
+   if ( !(S_ISLNK( st->st_mode )) ) { return 0; }
+   uint64_t ino;
+   if ( pctxt->store  &&  pkvplaceholder( pctxt->info, pctxt->inner, path, &(ino) ) ) {
+      pkvinode inode;
+      if ( pkvinodebegin( pctxt->store, ino, 0, &(inode) ) ) { return -1; }
+      pkvinodestat( pctxt->store, ino, &(inode), st );
+      return pkvinodeend( pctxt->store, ino, &(inode), 0 );
+   }
+   if ( flags & AT_SYMLINK_NOFOLLOW ) { return 0; }
+   return posix->stat( pctxt->inner, path, st, flags );
+}
+
+/**
+ * Create a hardlink
+ * NOTE -- placeholders may only be linked within the same reference store
+ * @param const MDAL_CTXT oldctxt : MDAL_CTXT to operate relative to for the 'oldpath'
+ * @param const char* oldpath : String path of the target file
+ * @param const MDAL_CTXT newctxt : MDAL_CTXT to operate relative to for the 'newpath'
+ * @param const char* newpath : String path of the new hardlink
+ * @param int flags : A bitwise OR of the following...
+ *                    AT_SYMLINK_FOLLOW - if 'oldpath' is a symlink, dereference it
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_link( const MDAL_CTXT oldctxt, const char* oldpath, const MDAL_CTXT newctxt, const char* newpath, int flags ) {
+   // check for NULL ctxts
+   if ( !(oldctxt)  ||  !(newctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT poldctxt = (POSIXKV_CTXT) oldctxt;
+   POSIXKV_CTXT pnewctxt = (POSIXKV_CTXT) newctxt;
+   MDAL posix = poldctxt->info->posix;
+   uint64_t ino;
+   if ( poldctxt->store == NULL  ||  !(pkvplaceholder( poldctxt->info, poldctxt->inner, oldpath, &(ino) )) ) {
+      return posix->link( poldctxt->inner, oldpath, pnewctxt->inner, newpath, flags );
+   }
+   if ( poldctxt->store != pnewctxt->store ) {
+      LOG( LOG_ERR, "Cannot link a placeholder into a NS with a different reference store\n" );
+      errno = EXDEV;
+      return -1;
+   }
+   // NOTE -- the link count is always incremented prior to the creation of a placeholder
+   if ( pkvlinkcounttxn( poldctxt->store, ino, 1 ) ) { return -1; }
+   if ( posix->link( poldctxt->inner, oldpath, pnewctxt->inner, newpath, 0 ) ) {
+      int origerrno = errno;
+      pkvlinkcounttxn( poldctxt->store, ino, -1 );
+      errno = origerrno;
+      return -1;
+   }
+   return 0;
+}
+
+/**
+ * Create the specified directory
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the new directory
+ * @param mode_t mode : Mode value of the new directory (see inode man page)
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_mkdir( const MDAL_CTXT ctxt, const char* path, mode_t mode ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   return pctxt->info->posix->mkdir( pctxt->inner, path, mode );
+}
+
+/**
+ * Delete the specified directory
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the target directory
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_rmdir( const MDAL_CTXT ctxt, const char* path ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   return pctxt->info->posix->rmdir( pctxt->inner, path );
+}
+
+/**
+ * Read the target path of the specified symlink
+ * NOTE -- placeholders are reported as regular files ( errno=EINVAL )
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the target symlink
+ * @param char* buf : Buffer to be populated with the link value
+ * @param size_t size : Size of the target buffer
+ * @return ssize_t : Size of the link target string, or -1 if a failure occurred
+ */
+ssize_t posixkvmdal_readlink( const MDAL_CTXT ctxt, const char* path, char* buf, size_t size ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   uint64_t ino;
+   if ( pkvplaceholder( pctxt->info, pctxt->inner, path, &(ino) ) ) {
+      errno = EINVAL;
+      return -1;
+   }
+   return pctxt->info->posix->readlink( pctxt->inner, path, buf, size );
+}
+
+/**
+ * Rename the specified target to a new path
+ * NOTE -- placeholders may only be renamed within the same reference store
+ * @param const MDAL_CTXT fromctxt : MDAL_CTXT to operate relative to for the 'from' path
+ * @param const char* from : String path of the target
+ * @param const MDAL_CTXT toctxt : MDAL_CTXT to operate relative to for the 'to' path
+ * @param const char* to : Destination string path
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_rename( const MDAL_CTXT fromctxt, const char* from, const MDAL_CTXT toctxt, const char* to ) {
+   // check for NULL ctxts
+   if ( !(fromctxt)  ||  !(toctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pfromctxt = (POSIXKV_CTXT) fromctxt;
+   POSIXKV_CTXT ptoctxt = (POSIXKV_CTXT) toctxt;
+   uint64_t fromino;
+   uint64_t toino;
+   char fromph = ( pfromctxt->store  &&  pkvplaceholder( pfromctxt->info, pfromctxt->inner, from, &(fromino) ) );
+   if ( fromph  &&  pfromctxt->store != ptoctxt->store ) {
+      LOG( LOG_ERR, "Cannot rename a placeholder into a NS with a different reference store\n" );
+      errno = EXDEV;
+      return -1;
+   }
+   char toph = ( ptoctxt->store  &&  pkvplaceholder( ptoctxt->info, ptoctxt->inner, to, &(toino) ) );
+   if ( pfromctxt->info->posix->rename( pfromctxt->inner, from, ptoctxt->inner, to ) ) { return -1; }
+   // a replaced placeholder is no longer linked
+   if ( toph  &&  !( fromph  &&  fromino == toino )  &&  pkvlinkcounttxn( ptoctxt->store, toino, -1 ) ) {
+      LOG( LOG_WARNING, "Failed to decrement link count of replaced inode %llu\n", (unsigned long long)toino );
+   }
+   return 0;
+}
+
+/**
+ * Return statvfs (filesystem) info for the current namespace
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to retrieve info for
+ * @param struct statvfs* buf : Reference to the statvfs structure to be populated
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_statvfs( const MDAL_CTXT ctxt, struct statvfs* buf ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   return pctxt->info->posix->statvfs( pctxt->inner, buf );
+}
+
+/**
+ * Create a symlink
+ * NOTE -- symlinks may not target the reserved placeholder prefix
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* target : String path for the link to target
+ * @param const char* linkname : String path of the new link
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_symlink( const MDAL_CTXT ctxt, const char* target, const char* linkname ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   if ( strncmp( target, PKV_LINK, strlen( PKV_LINK ) ) == 0 ) {
+      LOG( LOG_ERR, "Symlink target has a reserved prefix: \"%s\"\n", target );
+      errno = EPERM;
+      return -1;
+   }
+   return pctxt->info->posix->symlink( pctxt->inner, target, linkname );
+}
+
+/**
+ * Unlink the specified file
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the target file
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int posixkvmdal_unlink( const MDAL_CTXT ctxt, const char* path ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   uint64_t ino;
+   char placeholder = ( pctxt->store  &&  pkvplaceholder( pctxt->info, pctxt->inner, path, &(ino) ) );
+   if ( pctxt->info->posix->unlink( pctxt->inner, path ) ) { return -1; }
+   // NOTE -- the link count is only decremented after the placeholder is removed
+   if ( placeholder  &&  pkvlinkcounttxn( pctxt->store, ino, -1 )  &&  errno != ENOENT ) {
+      LOG( LOG_WARNING, "Failed to decrement link count of inode %llu\n", (unsigned long long)ino );
+   }
+   return 0;
+}
+
+/**
+ * Update the timestamps of the target file
+ * @param const MDAL_CTXT ctxt : MDAL_CTXT to operate relative to
+ * @param const char* path : String path of the target file
+ * @param const struct timespec times[2] : Struct references for new times
+ *                                         times[0] - atime values
+ *                                         times[1] - mtime values
+ *                                         (see man utimensat for struct reference)
+ * @param int flags : A bitwise OR of the following...
+ *                    AT_SYMLINK_NOFOLLOW - do not dereference a symlink target
+ * @return int : Zero value on success, or -1 if a failure occurred
+ */
+int posixkvmdal_utimens( MDAL_CTXT ctxt, const char* path, const struct timespec times[2], int flags ) {
+   // check for NULL ctxt
+   if ( !(ctxt) ) {
+      LOG( LOG_ERR, "Received a NULL MDAL_CTXT reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   POSIXKV_CTXT pctxt = (POSIXKV_CTXT) ctxt;
+   uint64_t ino;
+   if ( pctxt->store == NULL  ||  !(pkvplaceholder( pctxt->info, pctxt->inner, path, &(ino) )) ) {
+      return pctxt->info->posix->utimens( pctxt->inner, path, times, flags );
+   }
+   pkvinode inode;
+   if ( pkvinodebegin( pctxt->store, ino, 1, &(inode) ) ) { return -1; }
+   pkvinodetimes( &(inode), times );
+   return pkvinodeend( pctxt->store, ino, &(inode), 1 );
+}
+
+
+//   -------------    INITIALIZATION    -------------
+
+/**
+ * Initialize a PosixKV MDAL, from the same config structure as the Posix MDAL
+ * @param xmlNode* root : Initial 'ns_root' node of the MDAL config
+ * @return MDAL : Reference to the new MDAL, or NULL if a failure occurred
+ */
+MDAL posixkv_mdal_init( xmlNode* root ) {
+   // all config validation is left to the Posix MDAL
+   MDAL posix = posix_mdal_init( root );
+   if ( posix == NULL ) {
+      LOG( LOG_ERR, "Failed to initialize the underlying Posix MDAL\n" );
+      return NULL;
+   }
+   PKV_INFO info = calloc( 1, sizeof( struct posixkv_info_struct ) );
+   if ( info == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate MDAL info struct\n" );
+      posix->cleanup( posix );
+      return NULL;
+   }
+   info->posix = posix;
+   // store paths must remain valid regardless of our working dir
+   info->rootpath = realpath( (char*)root->children->content, NULL );
+   if ( info->rootpath == NULL ) {
+      LOG( LOG_ERR, "Failed to identify the absolute path of the 'ns_root': \"%s\"\n", (char*)root->children->content );
+      free( info );
+      posix->cleanup( posix );
+      return NULL;
+   }
+   info->umask = umask( 0 );
+   umask( info->umask );
+   if ( pthread_mutex_init( &(info->lock), NULL ) ) {
+      LOG( LOG_ERR, "Failed to initialize MDAL store lock\n" );
+      free( info->rootpath );
+      free( info );
+      posix->cleanup( posix );
+      return NULL;
+   }
+   POSIXKV_CTXT pctxt = calloc( 1, sizeof( struct posixkv_context_struct ) );
+   MDAL pkvmdal = malloc( sizeof( struct MDAL_struct ) );
+   if ( pctxt == NULL  ||  pkvmdal == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate MDAL structures\n" );
+      free( pctxt );
+      free( pkvmdal );
+      pthread_mutex_destroy( &(info->lock) );
+      free( info->rootpath );
+      free( info );
+      posix->cleanup( posix );
+      return NULL;
+   }
+   pctxt->inner = posix->ctxt;
+   pctxt->info = info;
+   pkvmdal->name = "posixkv";
+   pkvmdal->ctxt = (MDAL_CTXT) pctxt;
+   pkvmdal->pathfilter = posixkvmdal_pathfilter;
+   pkvmdal->destroyctxt = posixkvmdal_destroyctxt;
+   pkvmdal->dupctxt = posixkvmdal_dupctxt;
+   pkvmdal->cleanup = posixkvmdal_cleanup;
+   pkvmdal->checksec = posixkvmdal_checksec;
+   pkvmdal->setnamespace = posixkvmdal_setnamespace;
+   pkvmdal->newctxt = posixkvmdal_newctxt;
+   pkvmdal->newsplitctxt = posixkvmdal_newsplitctxt;
+   pkvmdal->createnamespace = posixkvmdal_createnamespace;
+   pkvmdal->destroynamespace = posixkvmdal_destroynamespace;
+   pkvmdal->opendirnamespace = posixkvmdal_opendirnamespace;
+   pkvmdal->accessnamespace = posixkvmdal_accessnamespace;
+   pkvmdal->statnamespace = posixkvmdal_statnamespace;
+   pkvmdal->chmodnamespace = posixkvmdal_chmodnamespace;
+   pkvmdal->chownnamespace = posixkvmdal_chownnamespace;
+   pkvmdal->setdatausage = posixkvmdal_setdatausage;
+   pkvmdal->getdatausage = posixkvmdal_getdatausage;
+   pkvmdal->setinodeusage = posixkvmdal_setinodeusage;
+   pkvmdal->getinodeusage = posixkvmdal_getinodeusage;
+   pkvmdal->createrefdir = posixkvmdal_createrefdir;
+   pkvmdal->destroyrefdir = posixkvmdal_destroyrefdir;
+   pkvmdal->linkref = posixkvmdal_linkref;
+   pkvmdal->renameref = posixkvmdal_renameref;
+   pkvmdal->unlinkref = posixkvmdal_unlinkref;
+   pkvmdal->statref = posixkvmdal_statref;
+   pkvmdal->openref = posixkvmdal_openref;
+   pkvmdal->createref = posixkvmdal_createref;
+   pkvmdal->openscanner = posixkvmdal_openscanner;
+   pkvmdal->closescanner = posixkvmdal_closescanner;
+   pkvmdal->scan = posixkvmdal_scan;
+   pkvmdal->sopen = posixkvmdal_sopen;
+   pkvmdal->sunlink = posixkvmdal_sunlink;
+   pkvmdal->sstat = posixkvmdal_sstat;
+   pkvmdal->opendir = posixkvmdal_opendir;
+   pkvmdal->chdir = posixkvmdal_chdir;
+   pkvmdal->dsetxattr = posixkvmdal_dsetxattr;
+   pkvmdal->dgetxattr = posixkvmdal_dgetxattr;
+   pkvmdal->dremovexattr = posixkvmdal_dremovexattr;
+   pkvmdal->dlistxattr = posixkvmdal_dlistxattr;
+   pkvmdal->readdir = posixkvmdal_readdir;
+   pkvmdal->readdirplus = posixkvmdal_readdirplus;
+   pkvmdal->closedir = posixkvmdal_closedir;
+   pkvmdal->open = posixkvmdal_open;
+   pkvmdal->close = posixkvmdal_close;
+   pkvmdal->write = posixkvmdal_write;
+   pkvmdal->read = posixkvmdal_read;
+   pkvmdal->ftruncate = posixkvmdal_ftruncate;
+   pkvmdal->lseek = posixkvmdal_lseek;
+   pkvmdal->fsetxattr = posixkvmdal_fsetxattr;
+   pkvmdal->fgetxattr = posixkvmdal_fgetxattr;
+   pkvmdal->fremovexattr = posixkvmdal_fremovexattr;
+   pkvmdal->flistxattr = posixkvmdal_flistxattr;
+   pkvmdal->fstat = posixkvmdal_fstat;
+   pkvmdal->futimens = posixkvmdal_futimens;
+   pkvmdal->access = posixkvmdal_access;
+   pkvmdal->mknod = posixkvmdal_mknod;
+   pkvmdal->chmod = posixkvmdal_chmod;
+   pkvmdal->chown = posixkvmdal_chown;
+   pkvmdal->stat = posixkvmdal_stat;
+   pkvmdal->link = posixkvmdal_link;
+   pkvmdal->mkdir = posixkvmdal_mkdir;
+   pkvmdal->rmdir = posixkvmdal_rmdir;
+   pkvmdal->readlink = posixkvmdal_readlink;
+   pkvmdal->rename = posixkvmdal_rename;
+   pkvmdal->statvfs = posixkvmdal_statvfs;
+   pkvmdal->symlink = posixkvmdal_symlink;
+   pkvmdal->unlink = posixkvmdal_unlink;
+   pkvmdal->utimens = posixkvmdal_utimens;
+   return pkvmdal;
+}
+
@@ -0,0 +1,343 @@
+/*
+Copyright (c) 2015, Los Alamos National Security, LLC
+All rights reserved.
+
+Copyright 2015.  Los Alamos National Security, LLC. This software was produced
+under U.S. Government contract DE-AC52-06NA25396 for Los Alamos National
+Laboratory (LANL), which is operated by Los Alamos National Security, LLC for
+the U.S. Department of Energy. The U.S. Government has rights to use, reproduce,
+and distribute this software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL
+SECURITY, LLC MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY
+FOR THE USE OF THIS SOFTWARE.  If software is modified to produce derivative
+works, such modified software should be clearly marked, so as not to confuse it
+with the version available from LANL.
+
+Additionally, redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+3. Neither the name of Los Alamos National Security, LLC, Los Alamos National
+Laboratory, LANL, the U.S. Government, nor the names of its contributors may be
+used to endorse or promote products derived from this software without specific
+prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL LOS ALAMOS NATIONAL SECURITY, LLC OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-----
+NOTE:
+-----
+Although these files reside in a seperate repository, they fall under the MarFS copyright and license.
+
+MarFS is released under the BSD license.
+
+MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier:
+LA-CC-15-039.
+
+These erasure utilites make use of the Intel Intelligent Storage
+Acceleration Library (Intel ISA-L), which can be found at
+https://github.com/01org/isa-l and is under its own license.
+
+MarFS uses libaws4c for Amazon S3 object communication. The original version
+is at https://aws.amazon.com/code/Amazon-S3/2601 and under the LGPL license.
+LANL added functionality to the original work. The original work plus
+LANL contributions is found at https://github.com/jti-lanl/aws4c.
+
+GNU licenses can be found at http://www.gnu.org/licenses/.
+*/
+
+#include <unistd.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+// directly including the C file allows more flexibility for these tests
+#include "mdal/kvstore.c"
+
+#define TEST_PATH "./test_kvstore_log"
+#define DAMAGED_PATH "./test_kvstore_damaged"
+#define KEY_COUNT 1000
+
+int main(int argc, char **argv)
+{
+   // NOTE -- I'm ignoring memory leaks for error contions which result in immediate termination
+
+   // verify that a missing store is not created implicitly
+   errno = 0;
+   if ( kvstore_open( TEST_PATH, 0 ) != NULL  ||  errno != ENOENT ) {
+      printf( "expected ENOENT for open of a nonexistent store\n" );
+      return -1;
+   }
+   KVSTORE store = kvstore_open( TEST_PATH, 1 );
+   if ( store == NULL ) {
+      printf( "failed to create store\n" );
+      return -1;
+   }
+
+   // populate a set of keys, in reverse order
+   char key[64];
+   char val[64];
+   int index;
+   if ( kvstore_begin( store, 1 ) ) {
+      printf( "failed to begin initial write transaction\n" );
+      return -1;
+   }
+   for ( index = KEY_COUNT - 1; index >= 0; index-- ) {
+      snprintf( key, 64, "key%04d", index );
+      snprintf( val, 64, "val%d", index );
+      if ( kvstore_put( store, key, val, strlen(val) + 1 ) ) {
+         printf( "failed to put \"%s\"\n", key );
+         return -1;
+      }
+   }
+   // uncommitted values should be visible within the transaction
+   if ( kvstore_get( store, "key0010", val, 64 ) != 6  ||  strcmp( val, "val10" ) ) {
+      printf( "unexpected pending value of key0010: \"%s\"\n", val );
+      return -1;
+   }
+   if ( kvstore_end( store, 1 ) ) {
+      printf( "failed to commit initial write transaction\n" );
+      return -1;
+   }
+
+   // discard a transaction, and verify it has no effect
+   if ( kvstore_begin( store, 1 )  ||  kvstore_delete( store, "key0000" )  ||
+        kvstore_put( store, "key0001", "bogus", 6 )  ||  kvstore_put( store, "newkey", "bogus", 6 ) ) {
+      printf( "failed to issue discarded transaction\n" );
+      return -1;
+   }
+   if ( kvstore_end( store, 0 ) ) {
+      printf( "failed to discard transaction\n" );
+      return -1;
+   }
+
+   // delete every other key
+   if ( kvstore_begin( store, 1 ) ) {
+      printf( "failed to begin delete transaction\n" );
+      return -1;
+   }
+   for ( index = 1; index < KEY_COUNT; index += 2 ) {
+      snprintf( key, 64, "key%04d", index );
+      if ( kvstore_delete( store, key ) ) {
+         printf( "failed to delete \"%s\"\n", key );
+         return -1;
+      }
+   }
+   errno = 0;
+   if ( kvstore_delete( store, "key0001" ) == 0  ||  errno != ENOENT ) {
+      printf( "expected ENOENT for repeated delete of key0001\n" );
+      return -1;
+   }
+   if ( kvstore_end( store, 1 ) ) {
+      printf( "failed to commit delete transaction\n" );
+      return -1;
+   }
+
+   // verify state via a second handle, which must replay the log
+   KVSTORE second = kvstore_open( TEST_PATH, 0 );
+   if ( second == NULL ) {
+      printf( "failed to open second store handle\n" );
+      return -1;
+   }
+   if ( kvstore_begin( second, 0 ) ) {
+      printf( "failed to begin read transaction\n" );
+      return -1;
+   }
+   ssize_t keylen = kvstore_nextkey( second, NULL, 0, key, 64 );
+   for ( index = 0; index < KEY_COUNT; index += 2 ) {
+      char expkey[64];
+      snprintf( expkey, 64, "key%04d", index );
+      if ( keylen != strlen(expkey)  ||  strcmp( key, expkey ) ) {
+         printf( "unexpected key following index %d: \"%s\"\n", index, key );
+         return -1;
+      }
+      snprintf( expkey, 64, "val%d", index );
+      if ( kvstore_get( second, key, val, 64 ) != strlen(expkey) + 1  ||  strcmp( val, expkey ) ) {
+         printf( "unexpected value of key \"%s\": \"%s\"\n", key, val );
+         return -1;
+      }
+      char prevkey[64];
+      snprintf( prevkey, 64, "%s", key );
+      keylen = kvstore_nextkey( second, prevkey, 0, key, 64 );
+   }
+   if ( keylen != 0 ) {
+      printf( "unexpected trailing key: \"%s\"\n", key );
+      return -1;
+   }
+   errno = 0;
+   if ( kvstore_get( second, "newkey", NULL, 0 ) >= 0  ||  errno != ENOENT ) {
+      printf( "expected ENOENT for get of discarded key\n" );
+      return -1;
+   }
+   if ( kvstore_nextkey( second, "key0001", 1, key, 64 ) != 7  ||  strcmp( key, "key0002" ) ) {
+      printf( "unexpected inclusive key following \"key0001\": \"%s\"\n", key );
+      return -1;
+   }
+   if ( kvstore_get( second, "key0002", val, 2 ) != 5 ) {
+      printf( "expected value length for undersized buffer\n" );
+      return -1;
+   }
+   if ( kvstore_end( second, 0 ) ) {
+      printf( "failed to end read transaction\n" );
+      return -1;
+   }
+
+   // append a partial batch, as if a writer had crashed, and verify it is ignored
+   int logfd = open( TEST_PATH, O_WRONLY | O_APPEND );
+   if ( logfd < 0  ||  write( logfd, "MKVB-partial", 12 ) != 12  ||  close( logfd ) ) {
+      printf( "failed to append partial batch\n" );
+      return -1;
+   }
+   if ( kvstore_begin( store, 1 )  ||  kvstore_put( store, "key0001", "restored", 9 )  ||  kvstore_end( store, 1 ) ) {
+      printf( "failed to write following a partial batch\n" );
+      return -1;
+   }
+   if ( kvstore_begin( second, 0 )  ||  kvstore_get( second, "key0001", val, 64 ) != 9  ||
+        strcmp( val, "restored" )  ||  kvstore_end( second, 0 ) ) {
+      printf( "second handle failed to observe value written after a partial batch\n" );
+      return -1;
+   }
+
+   // repeatedly overwrite a large value, to trigger compaction
+   char* bigval = malloc( 64 * 1024 );
+   if ( bigval == NULL ) {
+      printf( "failed to allocate large value\n" );
+      return -1;
+   }
+   struct stat logstat;
+   for ( index = 0; index < 64; index++ ) {
+      memset( bigval, 'a' + (index % 26), 64 * 1024 );
+      if ( kvstore_begin( store, 1 )  ||  kvstore_put( store, "bigkey", bigval, 64 * 1024 )  ||
+           kvstore_end( store, 1 ) ) {
+         printf( "failed to write large value %d\n", index );
+         return -1;
+      }
+   }
+   if ( stat( TEST_PATH, &(logstat) )  ||  logstat.st_size > 4 * 1024 * 1024 ) {
+      printf( "log was not compacted ( %zd bytes )\n", (ssize_t)logstat.st_size );
+      return -1;
+   }
+   // the second handle must follow the compacted log
+   if ( kvstore_begin( second, 0 )  ||  kvstore_get( second, "bigkey", bigval, 64 * 1024 ) != 64 * 1024  ||
+        bigval[100] != 'a' + (63 % 26)  ||  kvstore_get( second, "key0998", val, 64 ) != 7  ||
+        kvstore_end( second, 0 ) ) {
+      printf( "second handle failed to observe compacted log\n" );
+      return -1;
+   }
+   free( bigval );
+   if ( kvstore_close( second ) ) {
+      printf( "failed to close second handle\n" );
+      return -1;
+   }
+
+   // remove all keys, then destroy the store
+   errno = 0;
+   if ( kvstore_destroy( TEST_PATH ) == 0  ||  errno != ENOTEMPTY ) {
+      printf( "expected ENOTEMPTY for destroy of a populated store\n" );
+      return -1;
+   }
+   if ( kvstore_begin( store, 1 ) ) {
+      printf( "failed to begin final write transaction\n" );
+      return -1;
+   }
+   while ( kvstore_nextkey( store, NULL, 0, key, 64 ) > 0 ) {
+      if ( kvstore_delete( store, key ) ) {
+         printf( "failed to delete \"%s\"\n", key );
+         return -1;
+      }
+   }
+   if ( kvstore_end( store, 1 )  ||  kvstore_close( store ) ) {
+      printf( "failed to commit final write transaction\n" );
+      return -1;
+   }
+   if ( kvstore_destroy( TEST_PATH ) ) {
+      printf( "failed to destroy store\n" );
+      return -1;
+   }
+
+   // populate a fresh store with one batch per key
+   store = kvstore_open( DAMAGED_PATH, 1 );
+   if ( store == NULL ) {
+      printf( "failed to create damaged store\n" );
+      return -1;
+   }
+   for ( index = 0; index < 3; index++ ) {
+      snprintf( key, 64, "dmg%d", index );
+      if ( kvstore_begin( store, 1 )  ||  kvstore_put( store, key, "v0", 3 )  ||  kvstore_end( store, 1 ) ) {
+         printf( "failed to write \"%s\"\n", key );
+         return -1;
+      }
+   }
+   if ( kvstore_close( store ) ) {
+      printf( "failed to close damaged store\n" );
+      return -1;
+   }
+   off_t batchlen = sizeof(kvbatch) + KVSTORE_RECSIZE( 4, 3 );
+   // corrupt the final batch, as if its write had been torn, and verify it is replaced by the next commit
+   logfd = open( DAMAGED_PATH, O_WRONLY );
+   if ( logfd < 0  ||  pwrite( logfd, "X", 1, (2 * batchlen) + sizeof(kvbatch) + 8 ) != 1  ||  close( logfd ) ) {
+      printf( "failed to corrupt final batch\n" );
+      return -1;
+   }
+   store = kvstore_open( DAMAGED_PATH, 0 );
+   if ( store == NULL ) {
+      printf( "failed to open store with a torn final batch\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( kvstore_begin( store, 1 )  ||  kvstore_get( store, "dmg1", val, 64 ) != 3  ||
+        kvstore_get( store, "dmg2", val, 64 ) >= 0  ||  errno != ENOENT  ||
+        kvstore_put( store, "dmg3", "v0", 3 )  ||  kvstore_end( store, 1 )  ||  kvstore_close( store ) ) {
+      printf( "unexpected state following a torn final batch\n" );
+      return -1;
+   }
+   if ( stat( DAMAGED_PATH, &(logstat) )  ||  logstat.st_size != 3 * batchlen ) {
+      printf( "torn final batch was not replaced ( %zd bytes )\n", (ssize_t)logstat.st_size );
+      return -1;
+   }
+   // corrupt the first batch, and verify the store refuses to load, rather than discarding later batches
+   logfd = open( DAMAGED_PATH, O_WRONLY );
+   if ( logfd < 0  ||  pwrite( logfd, "X", 1, sizeof(kvbatch) + 8 ) != 1  ||  close( logfd ) ) {
+      printf( "failed to corrupt first batch\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( kvstore_open( DAMAGED_PATH, 0 ) != NULL  ||  errno != EBADMSG ) {
+      printf( "expected EBADMSG for open of a store damaged ahead of intact batches\n" );
+      return -1;
+   }
+   // damage to a batch header must be detected in the same way
+   logfd = open( DAMAGED_PATH, O_WRONLY );
+   if ( logfd < 0  ||  pwrite( logfd, "X", 1, batchlen ) != 1  ||  close( logfd ) ) {
+      printf( "failed to corrupt second batch header\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( kvstore_open( DAMAGED_PATH, 0 ) != NULL  ||  errno != EBADMSG ) {
+      printf( "expected EBADMSG for open of a store with a damaged batch header\n" );
+      return -1;
+   }
+   struct stat damagedstat;
+   if ( stat( DAMAGED_PATH, &(damagedstat) )  ||  damagedstat.st_size != logstat.st_size ) {
+      printf( "damaged log was truncated ( %zd bytes )\n", (ssize_t)damagedstat.st_size );
+      return -1;
+   }
+   if ( unlink( DAMAGED_PATH )  ||  unlink( DAMAGED_PATH ".lock" ) ) {
+      printf( "failed to remove damaged store\n" );
+      return -1;
+   }
+
+   return 0;
+}
+
@@ -65,6 +65,11 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 // directly including the C file allows more flexibility for these tests
 #include "mdal/posix_mdal.c"
 
+// createref() populate function, which attaches a hidden xattr ( or fails, if arg is NULL )
+int populatexattr( MDAL_FHANDLE fh, void* arg ) {
+   if ( arg == NULL ) { errno = EPERM; return -1; }
+   return posixmdal_fsetxattr( fh, 1, "popname", (char*)arg, strlen( (char*)arg ) + 1, XATTR_CREATE );
+}
 
 int main(int argc, char **argv)
 {
@@ -380,6 +385,31 @@ int main(int argc, char **argv)
       printf( "userfile stat does not match reference stat\n" );
       return -1;
    }
+   // list the NS root with stat info, and verify the userfile entry matches as well
+   MDAL_DHANDLE nsdir = mdal->opendir( rootctxt, "." );
+   if ( !(nsdir) ) {
+      printf( "failed to open a dir handle for the NS root\n" );
+      return -1;
+   }
+   char founduserfile = 0;
+   errno = 0;
+   while ( (entry = mdal->readdirplus( nsdir, &(verstat) )) != NULL ) {
+      if ( strncmp( "userfile", entry->d_name, 9 ) == 0 ) {
+         if ( memcmp( &(verstat), &(stbuf), sizeof(struct stat) ) ) {
+            printf( "readdirplus stat does not match reference stat for userfile\n" );
+            return -1;
+         }
+         founduserfile = 1;
+      }
+   }
+   if ( errno  ||  !(founduserfile) ) {
+      printf( "failed to locate userfile via readdirplus\n" );
+      return -1;
+   }
+   if ( mdal->closedir( nsdir ) ) {
+      printf( "failed to close the NS root dir handle\n" );
+      return -1;
+   }
    // seek to EOF minus 8, and verify the CONTENT string
    if ( mdal->lseek( sfh, 10234, SEEK_SET ) != 10234 ) {
       printf( "failed to seek to 10234 of scanner reffile\n" );
@@ -463,6 +493,61 @@ int main(int argc, char **argv)
       return -1;
    }
 
+   // a failed populate should leave no trace of the new file
+   if ( mdal->createref( rootctxt, "ref0/createfile", S_IRWXU, "createfile", populatexattr, NULL ) != NULL ) {
+      printf( "createref unexpectedly succeeded with a failing populate func\n" );
+      return -1;
+   }
+   if ( mdal->statref( rootctxt, "ref0/createfile", &(verstat) ) == 0  ||
+        mdal->stat( rootctxt, "createfile", &(verstat), AT_SYMLINK_NOFOLLOW ) == 0 ) {
+      printf( "failed createref left behind a visible file\n" );
+      return -1;
+   }
+   // create a new reference file, replacing the existing userfile link
+   MDAL_FHANDLE createfh = mdal->createref( rootctxt, "ref0/createfile", S_IRWXU, "userfile", populatexattr, "popcontent" );
+   if ( createfh == NULL ) {
+      printf( "failed to create \"ref0/createfile\" via createref\n" );
+      return -1;
+   }
+   if ( mdal->write( createfh, "CREATED", (sizeof(char) * 8) ) != (sizeof(char) * 8) ) {
+      printf( "unexpected return for write of \"CREATED\" to createfile\n" );
+      return -1;
+   }
+   if ( mdal->close( createfh ) ) {
+      printf( "failed to close createfile\n" );
+      return -1;
+   }
+   // verify that the ref and user paths now both target the new file
+   struct stat createstat;
+   if ( mdal->statref( rootctxt, "ref0/createfile", &(createstat) )  ||
+        mdal->stat( rootctxt, "userfile", &(verstat), AT_SYMLINK_NOFOLLOW ) ) {
+      printf( "failed to stat createfile paths\n" );
+      return -1;
+   }
+   if ( createstat.st_ino != verstat.st_ino  ||  createstat.st_nlink != 2  ||  createstat.st_size != 8 ) {
+      printf( "userfile does not reference the new createfile\n" );
+      return -1;
+   }
+   // verify the populated xattr value
+   createfh = mdal->openref( rootctxt, "ref0/createfile", O_RDONLY, 0 );
+   if ( createfh == NULL ) {
+      printf( "failed to reopen createfile\n" );
+      return -1;
+   }
+   char popval[16] = {0};
+   if ( mdal->fgetxattr( createfh, 1, "popname", popval, sizeof(popval) ) != 11  ||  strcmp( popval, "popcontent" ) ) {
+      printf( "unexpected popname xattr value on createfile: \"%s\"\n", popval );
+      return -1;
+   }
+   if ( mdal->close( createfh ) ) {
+      printf( "failed to close reopened createfile\n" );
+      return -1;
+   }
+   if ( mdal->unlinkref( rootctxt, "ref0/createfile" ) ) {
+      printf( "failed to unlink createfile\n" );
+      return -1;
+   }
+
    // unlink the reference file path
    if ( mdal->unlinkref( rootctxt, "ref0/reffile" ) ) {
       printf( "failed to unlink reffile\n" );
@@ -0,0 +1,310 @@
+/*
+Copyright (c) 2015, Los Alamos National Security, LLC
+All rights reserved.
+
+Copyright 2015.  Los Alamos National Security, LLC. This software was produced
+under U.S. Government contract DE-AC52-06NA25396 for Los Alamos National
+Laboratory (LANL), which is operated by Los Alamos National Security, LLC for
+the U.S. Department of Energy. The U.S. Government has rights to use, reproduce,
+and distribute this software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL
+SECURITY, LLC MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY
+FOR THE USE OF THIS SOFTWARE.  If software is modified to produce derivative
+works, such modified software should be clearly marked, so as not to confuse it
+with the version available from LANL.
+
+Additionally, redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+3. Neither the name of Los Alamos National Security, LLC, Los Alamos National
+Laboratory, LANL, the U.S. Government, nor the names of its contributors may be
+used to endorse or promote products derived from this software without specific
+prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL LOS ALAMOS NATIONAL SECURITY, LLC OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-----
+NOTE:
+-----
+Although these files reside in a seperate repository, they fall under the MarFS copyright and license.
+
+MarFS is released under the BSD license.
+
+MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier:
+LA-CC-15-039.
+
+These erasure utilites make use of the Intel Intelligent Storage
+Acceleration Library (Intel ISA-L), which can be found at
+https://github.com/01org/isa-l and is under its own license.
+
+MarFS uses libaws4c for Amazon S3 object communication. The original version
+is at https://aws.amazon.com/code/Amazon-S3/2601 and under the LGPL license.
+LANL added functionality to the original work. The original work plus
+LANL contributions is found at https://github.com/jti-lanl/aws4c.
+
+GNU licenses can be found at http://www.gnu.org/licenses/.
+*/
+
+
+#include <unistd.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+// directly including the C file allows more flexibility for these tests
+#include "mdal/posix_mdal.c"
+
+#define NS_COUNT 8
+
+int main(int argc, char **argv)
+{
+   // NOTE -- I'm ignoring memory leaks for error contions which result in immediate termination
+
+   // test absolute NS path generation
+   struct posix_mdal_context_struct absctxt = { .refd = -1, .pathd = -1, .shards = NULL, .nsabs = NULL };
+   char* absns = absolutens( &(absctxt), "/////.//" );
+   if ( absns == NULL  ||  strcmp( absns, "/." ) ) {
+      printf( "unexpected absolute path for \"/.\": \"%s\"\n", (absns) ? absns : "NULL" );
+      return -1;
+   }
+   free( absns );
+   absctxt.pathd = 0;
+   absctxt.nsabs = "/a/b";
+   absns = absolutens( &(absctxt), "../c//d/" );
+   if ( absns == NULL  ||  strcmp( absns, "/a/c/d" ) ) {
+      printf( "unexpected absolute path for \"../c//d/\": \"%s\"\n", (absns) ? absns : "NULL" );
+      return -1;
+   }
+   free( absns );
+   absns = absolutens( &(absctxt), "../.." );
+   if ( absns == NULL  ||  strcmp( absns, "/." ) ) {
+      printf( "unexpected absolute path for \"../..\": \"%s\"\n", (absns) ? absns : "NULL" );
+      return -1;
+   }
+   free( absns );
+   errno = 0;
+   if ( absolutens( &(absctxt), "../../.." ) != NULL  ||  errno != EINVAL ) {
+      printf( "expected EINVAL for NS path above the root NS\n" );
+      return -1;
+   }
+
+   // create the subdirs to be used by this test
+   errno = 0;
+   if ( mkdir( "test_posix_mdal_shard_root", S_IRWXU )  &&  errno != EEXIST ) {
+      printf( "failed to produce nsroot subdir\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mkdir( "test_posix_mdal_shard_1", S_IRWXU )  &&  errno != EEXIST ) {
+      printf( "failed to produce first shard subdir\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mkdir( "test_posix_mdal_shard_2", S_IRWXU )  &&  errno != EEXIST ) {
+      printf( "failed to produce second shard subdir\n" );
+      return -1;
+   }
+
+   // Initialize the libxml lib and check for API mismatches
+   LIBXML_TEST_VERSION
+
+   // open the test config file and produce an XML tree
+   xmlDoc* doc = xmlReadFile("./testing/posix_sharded_config.xml", NULL, XML_PARSE_NOBLANKS);
+   if (doc == NULL) {
+      printf("could not parse file %s\n", "./testing/posix_sharded_config.xml");
+      return -1;
+   }
+   xmlNode* root_element = xmlDocGetRootElement(doc);
+
+   // Initialize a posix mdal instance
+   MDAL mdal = init_mdal( root_element );
+   if ( mdal == NULL ) {
+      printf( "failed to initialize posix mdal\n" );
+      return -1;
+   }
+
+   // free the xml doc and cleanup parser vars
+   xmlFreeDoc(doc);
+   xmlCleanupParser();
+
+   // verify our multi-root info
+   POSIX_MDAL_CTXT pctxt = (POSIX_MDAL_CTXT) mdal->ctxt;
+   if ( pctxt->shards == NULL  ||  pctxt->shards->count != 3 ) {
+      printf( "expected an MDAL with 3 metadata roots\n" );
+      return -1;
+   }
+
+   // create a root NS
+   if ( mdal->createnamespace( mdal->ctxt, "/." ) ) {
+      printf( "failed to create namespace \"/.\"\n" );
+      return -1;
+   }
+
+   // create a number of subspaces, and verify that some are hosted on other roots
+   int hostcounts[3] = {0};
+   char nsname[32];
+   char linkpath[128];
+   char* shardns = NULL;
+   int index = 0;
+   for ( ; index < NS_COUNT; index++ ) {
+      snprintf( nsname, 32, "/subsp%d", index );
+      if ( mdal->createnamespace( mdal->ctxt, nsname ) ) {
+         printf( "failed to create %s\n", nsname );
+         return -1;
+      }
+      int home = namespacehome( pctxt->shards, nsname );
+      hostcounts[home]++;
+      snprintf( linkpath, 128, "test_posix_mdal_shard_root/%s/subsp%d", PMDAL_SUBSP, index );
+      struct stat stval;
+      if ( lstat( linkpath, &(stval) ) ) {
+         printf( "failed to stat the NS path of %s\n", nsname );
+         return -1;
+      }
+      if ( (home != 0) != (S_ISLNK(stval.st_mode) != 0) ) {
+         printf( "%s was not hosted by root %d\n", nsname, home );
+         return -1;
+      }
+      if ( home  &&  shardns == NULL ) { shardns = strdup( nsname ); }
+   }
+   if ( shardns == NULL ) {
+      printf( "no NS was hosted by an additional root\n" );
+      return -1;
+   }
+
+   // create a nested subspace of a hosted NS
+   snprintf( nsname, 32, "%s/nested", shardns );
+   if ( mdal->createnamespace( mdal->ctxt, nsname ) ) {
+      printf( "failed to create %s\n", nsname );
+      return -1;
+   }
+   // verify EEXIST case
+   errno = 0;
+   if ( mdal->createnamespace( mdal->ctxt, shardns ) == 0  ||  errno != EEXIST ) {
+      printf( "expected EEXIST for recreation of %s\n", shardns );
+      return -1;
+   }
+
+   // create a new context, referencing the hosted NS
+   MDAL_CTXT shardctxt = mdal->newctxt( shardns, mdal->ctxt );
+   if ( shardctxt == NULL ) {
+      printf( "failed to create new ctxt referencing %s\n", shardns );
+      return -1;
+   }
+   if ( mdal->createrefdir( shardctxt, "ref0", S_IRWXU ) ) {
+      printf( "failed to create ref0 for %s\n", shardns );
+      return -1;
+   }
+   MDAL_FHANDLE fh = mdal->openref( shardctxt, "ref0/reffile", O_CREAT | O_WRONLY, S_IRWXU );
+   if ( fh == NULL ) {
+      printf( "failed to create ref0/reffile in %s\n", shardns );
+      return -1;
+   }
+   if ( mdal->close( fh ) ) {
+      printf( "failed to close ref0/reffile\n" );
+      return -1;
+   }
+   if ( mdal->linkref( shardctxt, 0, "ref0/reffile", "userfile" ) ) {
+      printf( "failed to link ref0/reffile to userfile\n" );
+      return -1;
+   }
+   struct stat stval;
+   if ( mdal->stat( shardctxt, "userfile", &(stval), 0 )  ||  stval.st_nlink != 2 ) {
+      printf( "failed to stat userfile\n" );
+      return -1;
+   }
+
+   // verify relative NS ops from the hosted NS
+   if ( mdal->statnamespace( shardctxt, "nested", &(stval) ) ) {
+      printf( "failed to stat nested NS relative to %s\n", shardns );
+      return -1;
+   }
+   MDAL_CTXT nestedctxt = mdal->newctxt( "nested", shardctxt );
+   if ( nestedctxt == NULL ) {
+      printf( "failed to create new ctxt referencing nested NS\n" );
+      return -1;
+   }
+   if ( mdal->setnamespace( nestedctxt, "../.." ) ) {
+      printf( "failed to set nested ctxt to the root NS\n" );
+      return -1;
+   }
+   if ( mdal->statnamespace( nestedctxt, shardns + 1, &(stval) ) ) {
+      printf( "failed to stat %s relative to the root NS\n", shardns );
+      return -1;
+   }
+   if ( mdal->setnamespace( nestedctxt, shardns + 1 ) ) {
+      printf( "failed to set nested ctxt back to %s\n", shardns );
+      return -1;
+   }
+   if ( mdal->stat( nestedctxt, "userfile", &(stval), 0 ) ) {
+      printf( "failed to stat userfile via the nested ctxt\n" );
+      return -1;
+   }
+   if ( mdal->destroyctxt( nestedctxt ) ) {
+      printf( "failed to destroy nested ctxt\n" );
+      return -1;
+   }
+
+   // cleanup all previous state
+   if ( mdal->unlink( shardctxt, "userfile" ) ) {
+      printf( "failed to unlink userfile\n" );
+      return -1;
+   }
+   if ( mdal->unlinkref( shardctxt, "ref0/reffile" ) ) {
+      printf( "failed to unlink ref0/reffile\n" );
+      return -1;
+   }
+   if ( mdal->destroyrefdir( shardctxt, "ref0" ) ) {
+      printf( "failed to destroy ref0\n" );
+      return -1;
+   }
+   if ( mdal->destroyctxt( shardctxt ) ) {
+      printf( "failed to destroy shardctxt\n" );
+      return -1;
+   }
+   snprintf( nsname, 32, "%s/nested", shardns );
+   if ( mdal->destroynamespace( mdal->ctxt, nsname ) ) {
+      printf( "failed to destroy %s\n", nsname );
+      return -1;
+   }
+   for ( index = 0; index < NS_COUNT; index++ ) {
+      snprintf( nsname, 32, "/subsp%d", index );
+      if ( mdal->destroynamespace( mdal->ctxt, nsname ) ) {
+         printf( "failed to destroy %s\n", nsname );
+         return -1;
+      }
+   }
+   free( shardns );
+   mdal->destroynamespace( mdal->ctxt, "/." ); // expected to fail
+
+   // free the mdal itself
+   mdal->cleanup( mdal );
+
+   // cleanup the root dirs
+   rmdir( "./test_posix_mdal_shard_root" );
+   for ( index = 1; index < 3; index++ ) {
+      snprintf( linkpath, 128, "./test_posix_mdal_shard_%d/%s/%s", index, PMDAL_SHARDS, PMDAL_SUBSP );
+      rmdir( linkpath );
+      snprintf( linkpath, 128, "./test_posix_mdal_shard_%d/%s", index, PMDAL_SHARDS );
+      rmdir( linkpath );
+      snprintf( linkpath, 128, "./test_posix_mdal_shard_%d", index );
+      if ( rmdir( linkpath ) ) {
+         printf( "failed to remove shard dir: \"%s\"\n", linkpath );
+         return -1;
+      }
+   }
+
+   return 0;
+}
+
@@ -0,0 +1,531 @@
+/*
+Copyright (c) 2015, Los Alamos National Security, LLC
+All rights reserved.
+
+Copyright 2015.  Los Alamos National Security, LLC. This software was produced
+under U.S. Government contract DE-AC52-06NA25396 for Los Alamos National
+Laboratory (LANL), which is operated by Los Alamos National Security, LLC for
+the U.S. Department of Energy. The U.S. Government has rights to use, reproduce,
+and distribute this software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL
+SECURITY, LLC MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY
+FOR THE USE OF THIS SOFTWARE.  If software is modified to produce derivative
+works, such modified software should be clearly marked, so as not to confuse it
+with the version available from LANL.
+
+Additionally, redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+1. Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+3. Neither the name of Los Alamos National Security, LLC, Los Alamos National
+Laboratory, LANL, the U.S. Government, nor the names of its contributors may be
+used to endorse or promote products derived from this software without specific
+prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL LOS ALAMOS NATIONAL SECURITY, LLC OR
+CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-----
+NOTE:
+-----
+Although these files reside in a seperate repository, they fall under the MarFS copyright and license.
+
+MarFS is released under the BSD license.
+
+MarFS was reviewed and released by LANL under Los Alamos Computer Code identifier:
+LA-CC-15-039.
+
+These erasure utilites make use of the Intel Intelligent Storage
+Acceleration Library (Intel ISA-L), which can be found at
+https://github.com/01org/isa-l and is under its own license.
+
+MarFS uses libaws4c for Amazon S3 object communication. The original version
+is at https://aws.amazon.com/code/Amazon-S3/2601 and under the LGPL license.
+LANL added functionality to the original work. The original work plus
+LANL contributions is found at https://github.com/jti-lanl/aws4c.
+
+GNU licenses can be found at http://www.gnu.org/licenses/.
+*/
+
+#include <unistd.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+// directly including the C file allows more flexibility for these tests
+#include "mdal/posixkv_mdal.c"
+
+#define SCAN_FILES 300
+
+// createref() populate function, which attaches a hidden xattr ( or fails, if arg is NULL )
+int populatexattr( MDAL_FHANDLE fh, void* arg ) {
+   if ( arg == NULL ) { errno = EPERM; return -1; }
+   return posixkvmdal_fsetxattr( fh, 1, "popname", (char*)arg, strlen( (char*)arg ) + 1, XATTR_CREATE );
+}
+
+// retrieve the link count of the given reference path ( or -1, on failure )
+int refnlink( MDAL mdal, MDAL_CTXT ctxt, const char* rpath ) {
+   struct stat stval;
+   if ( mdal->statref( ctxt, rpath, &(stval) ) ) { return -1; }
+   return (int)stval.st_nlink;
+}
+
+int main(int argc, char **argv)
+{
+   // NOTE -- I'm ignoring memory leaks for error contions which result in immediate termination
+
+   // test the NS / reference path normalization
+   char* strval = pkvabsolutens( "/a/b", "../c/./d//" );
+   if ( strval == NULL  ||  strcmp( strval, "/a/c/d" ) ) {
+      printf( "unexpected absolute NS path: \"%s\"\n", strval );
+      return -1;
+   }
+   free( strval );
+   strval = pkvabsolutens( NULL, "/.." );
+   if ( strval == NULL  ||  strcmp( strval, "/." ) ) {
+      printf( "unexpected absolute root NS path: \"%s\"\n", strval );
+      return -1;
+   }
+   free( strval );
+   strval = pkvstorepath( "/root", "/a/b" );
+   if ( strval == NULL  ||  strcmp( strval, "/root/"PKV_SUBSP"/a/"PKV_SUBSP"/b/"PKV_REF"/"PKV_STOREFILE ) ) {
+      printf( "unexpected store path: \"%s\"\n", strval );
+      return -1;
+   }
+   free( strval );
+   strval = pkventrykey( "./ref0//sub/", 1 );
+   if ( strval == NULL  ||  strcmp( strval, PKV_ENTRY"ref0/sub/" ) ) {
+      printf( "unexpected entry key: \"%s\"\n", strval );
+      return -1;
+   }
+   free( strval );
+   errno = 0;
+   if ( pkventrykey( "ref0/../escape", 0 ) != NULL  ||  errno != EINVAL ) {
+      printf( "expected EINVAL for rpath with parent reference\n" );
+      return -1;
+   }
+
+   // create a subdir to be used by this test
+   errno = 0;
+   if ( mkdir( "test_posixkv_mdal_nsroot", S_IRWXU )  &&  errno != EEXIST ) {
+      printf( "failed to produce nsroot subdir\n" );
+      return -1;
+   }
+
+   // Initialize the libxml lib and check for API mismatches
+   LIBXML_TEST_VERSION
+
+   // open the test config file and produce an XML tree
+   xmlDoc* doc = xmlReadFile("./testing/posixkv_config.xml", NULL, XML_PARSE_NOBLANKS);
+   if (doc == NULL) {
+      printf("could not parse file %s\n", "./testing/posixkv_config.xml");
+      return -1;
+   }
+   xmlNode* root_element = xmlDocGetRootElement(doc);
+
+   // Initialize a posixkv mdal instance
+   MDAL mdal = init_mdal( root_element );
+   if ( mdal == NULL  ||  strcmp( mdal->name, "posixkv" ) ) {
+      printf( "failed to initialize posixkv mdal\n" );
+      return -1;
+   }
+
+   // free the xml doc and cleanup parser vars
+   xmlFreeDoc(doc);
+   xmlCleanupParser();
+
+   // create a root NS and a subspace
+   if ( mdal->createnamespace( mdal->ctxt, "/." ) ) {
+      printf( "failed to create namespace \"/.\"\n" );
+      return -1;
+   }
+   if ( mdal->createnamespace( mdal->ctxt, "/subsp" ) ) {
+      printf( "failed to create subsp\n" );
+      return -1;
+   }
+
+   // create a new context, referencing the root NS
+   MDAL_CTXT rootctxt = mdal->newctxt( "/.", mdal->ctxt );
+   if ( rootctxt == NULL ) {
+      printf( "failed to create new ctxt referencing \"/.\"\n" );
+      return -1;
+   }
+
+   // create reference dirs for this NS
+   if ( mdal->createrefdir( rootctxt, "ref0", S_IRWXU ) ) {
+      printf( "failed to create ref0 for the rootNS\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mdal->createrefdir( rootctxt, "ref0", S_IRWXU ) == 0  ||  errno != EEXIST ) {
+      printf( "expected EEXIST for repeated creation of ref0\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mdal->createrefdir( rootctxt, "missing/sub", S_IRWXU ) == 0  ||  errno != ENOENT ) {
+      printf( "expected ENOENT for creation of a ref dir with a missing parent\n" );
+      return -1;
+   }
+   if ( mdal->createrefdir( rootctxt, "ref0/sub", S_IRWXU ) ) {
+      printf( "failed to create ref0/sub\n" );
+      return -1;
+   }
+
+   // create a reference file, with xattrs and sparse content
+   MDAL_FHANDLE reffh = mdal->openref( rootctxt, "ref0/reffile", O_CREAT | O_EXCL | O_WRONLY, S_IRWXU );
+   if ( reffh == NULL ) {
+      printf( "failed to create ref0/reffile\n" );
+      return -1;
+   }
+   if ( mdal->fsetxattr( reffh, 1, "tag", "tagval", 7, XATTR_CREATE ) ) {
+      printf( "failed to set hidden xattr of reffile\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mdal->fsetxattr( reffh, 0, PKV_XATTR"tag", "bad", 4, 0 ) == 0  ||  errno != EPERM ) {
+      printf( "expected EPERM for reserved xattr name\n" );
+      return -1;
+   }
+   if ( mdal->fsetxattr( reffh, 0, "user.a", "aval", 5, 0 ) ) {
+      printf( "failed to set visible xattr of reffile\n" );
+      return -1;
+   }
+   if ( mdal->ftruncate( reffh, 1048576 ) ) {
+      printf( "failed to truncate reffile\n" );
+      return -1;
+   }
+   if ( mdal->write( reffh, "data", 4 ) != 4 ) {
+      printf( "failed to write to reffile\n" );
+      return -1;
+   }
+   if ( mdal->close( reffh ) ) {
+      printf( "failed to close reffile\n" );
+      return -1;
+   }
+
+   // link the reference file into the user tree
+   if ( mdal->linkref( rootctxt, 0, "ref0/reffile", "userfile" ) ) {
+      printf( "failed to link reffile to userfile\n" );
+      return -1;
+   }
+   struct stat stval;
+   if ( mdal->stat( rootctxt, "userfile", &(stval), 0 ) ) {
+      printf( "failed to stat userfile\n" );
+      return -1;
+   }
+   if ( !(S_ISREG(stval.st_mode))  ||  stval.st_size != 1048576  ||  stval.st_nlink != 2 ) {
+      printf( "unexpected stat values for userfile\n" );
+      return -1;
+   }
+   if ( mdal->access( rootctxt, "userfile", R_OK | W_OK, AT_EACCESS ) ) {
+      printf( "failed to verify access to userfile\n" );
+      return -1;
+   }
+   errno = 0;
+   char linkbuf[64];
+   if ( mdal->readlink( rootctxt, "userfile", linkbuf, 64 ) >= 0  ||  errno != EINVAL ) {
+      printf( "expected EINVAL for readlink of placeholder\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mdal->symlink( rootctxt, PKV_LINK"0000000000000001", "fakefile" ) == 0  ||  errno != EPERM ) {
+      printf( "expected EPERM for symlink to reserved target\n" );
+      return -1;
+   }
+
+   // verify content and xattrs via the user path
+   MDAL_FHANDLE userfh = mdal->open( rootctxt, "userfile", O_RDONLY );
+   if ( userfh == NULL ) {
+      printf( "failed to open userfile\n" );
+      return -1;
+   }
+   char xattrval[16];
+   if ( mdal->fgetxattr( userfh, 1, "tag", xattrval, 16 ) != 7  ||  strcmp( xattrval, "tagval" ) ) {
+      printf( "unexpected hidden xattr value of userfile\n" );
+      return -1;
+   }
+   char listbuf[32];
+   if ( mdal->flistxattr( userfh, 1, listbuf, 32 ) != 4  ||  strcmp( listbuf, "tag" ) ) {
+      printf( "unexpected hidden xattr list of userfile\n" );
+      return -1;
+   }
+   if ( mdal->flistxattr( userfh, 0, listbuf, 32 ) != 7  ||  strcmp( listbuf, "user.a" ) ) {
+      printf( "unexpected visible xattr list of userfile\n" );
+      return -1;
+   }
+   char readbuf[4096];
+   if ( mdal->read( userfh, readbuf, 4096 ) != 4096  ||  strncmp( readbuf, "data", 4 )  ||  readbuf[4]  ||  readbuf[4095] ) {
+      printf( "unexpected content of userfile\n" );
+      return -1;
+   }
+   if ( mdal->lseek( userfh, -10, SEEK_END ) != 1048566  ||  mdal->read( userfh, readbuf, 4096 ) != 10 ) {
+      printf( "unexpected content at the tail of userfile\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mdal->write( userfh, "data", 4 ) >= 0  ||  errno != EBADF ) {
+      printf( "expected EBADF for write to read-only handle\n" );
+      return -1;
+   }
+   if ( mdal->close( userfh ) ) {
+      printf( "failed to close userfile\n" );
+      return -1;
+   }
+
+   // replace the user path with a newly created file
+   errno = 0;
+   if ( mdal->createref( rootctxt, "ref0/failfile", S_IRWXU, "failuser", populatexattr, NULL ) != NULL ) {
+      printf( "expected failure of createref with failing populate function\n" );
+      return -1;
+   }
+   if ( mdal->statref( rootctxt, "ref0/failfile", &(stval) ) == 0  ||  mdal->stat( rootctxt, "failuser", &(stval), 0 ) == 0 ) {
+      printf( "failed createref left a trace\n" );
+      return -1;
+   }
+   MDAL_FHANDLE createfh = mdal->createref( rootctxt, "ref0/createfile", S_IRWXU, "userfile", populatexattr, "popval" );
+   if ( createfh == NULL ) {
+      printf( "failed to createref ref0/createfile\n" );
+      return -1;
+   }
+   if ( mdal->ftruncate( createfh, 100 ) ) {
+      printf( "failed to truncate createfile\n" );
+      return -1;
+   }
+   if ( mdal->close( createfh ) ) {
+      printf( "failed to close createfile\n" );
+      return -1;
+   }
+   if ( refnlink( mdal, rootctxt, "ref0/reffile" ) != 1  ||  refnlink( mdal, rootctxt, "ref0/createfile" ) != 2 ) {
+      printf( "unexpected link counts following createref\n" );
+      return -1;
+   }
+   if ( mdal->stat( rootctxt, "userfile", &(stval), 0 )  ||  stval.st_size != 100 ) {
+      printf( "unexpected stat values for replaced userfile\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mdal->createref( rootctxt, "ref0/createfile", S_IRWXU, "otheruser", NULL, NULL ) != NULL  ||  errno != EEXIST ) {
+      printf( "expected EEXIST for createref of existing rpath\n" );
+      return -1;
+   }
+
+   // populate a nested ref dir
+   int index;
+   char rpath[64];
+   for ( index = 0; index < SCAN_FILES; index++ ) {
+      snprintf( rpath, 64, "ref0/sub/nested%d", index );
+      MDAL_FHANDLE nestfh = mdal->openref( rootctxt, rpath, O_CREAT | O_WRONLY, S_IRWXU );
+      if ( nestfh == NULL  ||  mdal->close( nestfh ) ) {
+         printf( "failed to create \"%s\"\n", rpath );
+         return -1;
+      }
+   }
+
+   // scan the top level ref dir, which should omit nested entries
+   MDAL_SCANNER scanner = mdal->openscanner( rootctxt, "ref0" );
+   if ( scanner == NULL ) {
+      printf( "failed to open scanner for ref0\n" );
+      return -1;
+   }
+   const char* expnames[3] = { "createfile", "reffile", "sub" };
+   const unsigned char exptypes[3] = { DT_REG, DT_REG, DT_DIR };
+   struct dirent* dent;
+   index = 0;
+   while ( (dent = mdal->scan( scanner )) != NULL ) {
+      if ( index >= 3  ||  strcmp( dent->d_name, expnames[index] )  ||  dent->d_type != exptypes[index] ) {
+         printf( "unexpected scanner entry %d: \"%s\"\n", index, dent->d_name );
+         return -1;
+      }
+      index++;
+   }
+   if ( index != 3 ) {
+      printf( "scanner of ref0 produced %d entries\n", index );
+      return -1;
+   }
+   if ( mdal->sstat( scanner, "reffile", &(stval) )  ||  stval.st_size != 1048576 ) {
+      printf( "failed to sstat reffile\n" );
+      return -1;
+   }
+   MDAL_FHANDLE scanfh = mdal->sopen( scanner, "createfile" );
+   if ( scanfh == NULL  ||  mdal->fgetxattr( scanfh, 1, "popname", xattrval, 16 ) != 7  ||  strcmp( xattrval, "popval" ) ) {
+      printf( "failed to retrieve populated xattr via scanner\n" );
+      return -1;
+   }
+   if ( mdal->close( scanfh ) ) {
+      printf( "failed to close scanner file handle\n" );
+      return -1;
+   }
+   if ( mdal->closescanner( scanner ) ) {
+      printf( "failed to close scanner for ref0\n" );
+      return -1;
+   }
+
+   // scan and remove all nested entries, across multiple batches
+   scanner = mdal->openscanner( rootctxt, "ref0/sub" );
+   if ( scanner == NULL ) {
+      printf( "failed to open scanner for ref0/sub\n" );
+      return -1;
+   }
+   index = 0;
+   while ( (dent = mdal->scan( scanner )) != NULL ) {
+      if ( strncmp( dent->d_name, "nested", 6 )  ||  mdal->sunlink( scanner, dent->d_name ) ) {
+         printf( "failed to unlink scanner entry: \"%s\"\n", dent->d_name );
+         return -1;
+      }
+      index++;
+   }
+   if ( index != SCAN_FILES ) {
+      printf( "scanner of ref0/sub produced %d entries\n", index );
+      return -1;
+   }
+   if ( mdal->closescanner( scanner ) ) {
+      printf( "failed to close scanner for ref0/sub\n" );
+      return -1;
+   }
+
+   // verify that the user tree reports placeholders as files
+   MDAL_DHANDLE dh = mdal->opendir( rootctxt, "." );
+   if ( dh == NULL ) {
+      printf( "failed to open root NS dir\n" );
+      return -1;
+   }
+   char founduser = 0;
+   while ( (dent = mdal->readdirplus( dh, &(stval) )) != NULL ) {
+      if ( strcmp( dent->d_name, "userfile" ) == 0 ) {
+         if ( dent->d_type != DT_REG  ||  !(S_ISREG(stval.st_mode))  ||  stval.st_size != 100 ) {
+            printf( "unexpected readdirplus values for userfile\n" );
+            return -1;
+         }
+         founduser = 1;
+      }
+   }
+   if ( !(founduser)  ||  mdal->closedir( dh ) ) {
+      printf( "failed to locate userfile via readdirplus\n" );
+      return -1;
+   }
+
+   // link counts should track user hardlinks
+   if ( mdal->link( rootctxt, "userfile", rootctxt, "userlink", 0 ) ) {
+      printf( "failed to link userfile\n" );
+      return -1;
+   }
+   if ( refnlink( mdal, rootctxt, "ref0/createfile" ) != 3 ) {
+      printf( "unexpected link count following link\n" );
+      return -1;
+   }
+   if ( mdal->chmod( rootctxt, "userlink", S_IRUSR, 0 )  ||  mdal->stat( rootctxt, "userfile", &(stval), 0 )  ||
+        ( stval.st_mode & 07777 ) != S_IRUSR ) {
+      printf( "failed to chmod userlink\n" );
+      return -1;
+   }
+   if ( mdal->unlink( rootctxt, "userlink" )  ||  refnlink( mdal, rootctxt, "ref0/createfile" ) != 2 ) {
+      printf( "unexpected link count following unlink of userlink\n" );
+      return -1;
+   }
+
+   // an open handle should survive the removal of all links
+   if ( mdal->unlinkref( rootctxt, "ref0/createfile" ) ) {
+      printf( "failed to unlink createfile\n" );
+      return -1;
+   }
+   userfh = mdal->open( rootctxt, "userfile", O_RDONLY );
+   if ( userfh == NULL ) {
+      printf( "failed to open userfile following unlinkref\n" );
+      return -1;
+   }
+   if ( mdal->unlink( rootctxt, "userfile" ) ) {
+      printf( "failed to unlink userfile\n" );
+      return -1;
+   }
+   if ( mdal->fgetxattr( userfh, 1, "popname", xattrval, 16 ) != 7  ||  mdal->fstat( userfh, &(stval) )  ||  stval.st_nlink ) {
+      printf( "unexpected state of unlinked userfile handle\n" );
+      return -1;
+   }
+   if ( mdal->close( userfh ) ) {
+      printf( "failed to close unlinked userfile\n" );
+      return -1;
+   }
+
+   // rename and remove the remaining reference file
+   if ( mdal->renameref( rootctxt, "ref0/reffile", "ref0/sub/renamed" ) ) {
+      printf( "failed to rename reffile\n" );
+      return -1;
+   }
+   if ( mdal->unlinkref( rootctxt, "ref0/sub/renamed" ) ) {
+      printf( "failed to unlink renamed reffile\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mdal->destroyrefdir( rootctxt, "ref0" ) == 0  ||  errno != ENOTEMPTY ) {
+      printf( "expected ENOTEMPTY for destroy of ref0\n" );
+      return -1;
+   }
+   if ( mdal->destroyrefdir( rootctxt, "ref0/sub" )  ||  mdal->destroyrefdir( rootctxt, "ref0" ) ) {
+      printf( "failed to destroy ref dirs\n" );
+      return -1;
+   }
+
+   // placeholders cannot move between reference stores
+   MDAL_CTXT subctxt = mdal->newctxt( "subsp", rootctxt );
+   if ( subctxt == NULL ) {
+      printf( "failed to create new ctxt referencing subsp\n" );
+      return -1;
+   }
+   if ( mdal->createrefdir( subctxt, "ref1", S_IRWXU ) ) {
+      printf( "failed to create ref1 for subsp\n" );
+      return -1;
+   }
+   MDAL_FHANDLE subfh = mdal->createref( subctxt, "ref1/subfile", S_IRWXU, "subfile", NULL, NULL );
+   if ( subfh == NULL  ||  mdal->close( subfh ) ) {
+      printf( "failed to create ref1/subfile\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mdal->rename( subctxt, "subfile", rootctxt, "movedfile" ) == 0  ||  errno != EXDEV ) {
+      printf( "expected EXDEV for rename of placeholder between NSes\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( mdal->destroynamespace( rootctxt, "subsp" ) == 0  ||  errno != EBUSY ) {
+      printf( "expected EBUSY for destroy of subsp with an active ctxt\n" );
+      return -1;
+   }
+   if ( mdal->unlink( subctxt, "subfile" )  ||  mdal->unlinkref( subctxt, "ref1/subfile" )  ||
+        mdal->destroyrefdir( subctxt, "ref1" ) ) {
+      printf( "failed to cleanup subsp content\n" );
+      return -1;
+   }
+   if ( mdal->destroyctxt( subctxt ) ) {
+      printf( "failed to destroy subctxt\n" );
+      return -1;
+   }
+   if ( mdal->destroynamespace( rootctxt, "subsp" ) ) {
+      printf( "failed to destroy subsp\n" );
+      return -1;
+   }
+
+   // cleanup all previous state
+   if ( mdal->destroyctxt( rootctxt ) ) {
+      printf( "failed to destroy rootctxt\n" );
+      return -1;
+   }
+   mdal->destroynamespace( mdal->ctxt, "/." ); // expected to fail
+
+   // free the mdal itself
+   mdal->cleanup( mdal );
+
+   // cleanup the root dir
+   rmdir( "./test_posixkv_mdal_nsroot" );
+
+   return 0;
+}
@@ -68,10 +68,12 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 
 #include <logging.h>
 #include "recovery.h"
+#include "compress/compress.h"
 #include "general_include/numdigits.h"
 
 #include <errno.h>
 #include <stdlib.h>
+#include <string.h>
 
 //   -------------   INTERNAL DEFINITIONS    -------------
 
@@ -82,8 +84,15 @@ typedef struct recovery_struct {
    RECOVERY_FINFO* fileinfo;
    void** filebuffers;
    size_t* buffersizes;
+   void* decoded; // decompressed content of the current object ( NULL if uncompressed )
 }* RECOVERY;
 
+typedef struct recovery_objref_struct {
+   const char* buffer;
+   size_t size;
+   size_t pos;
+} recovery_objref;
+
 
 //   -------------   INTERNAL FUNCTIONS    -------------
 
@@ -186,13 +195,36 @@ void* parse_recov_header( void* headerbuf, size_t bufsize, RECOVERY_HEADER* head
       return NULL;
    }
    parseval = strtoull( parse, &(endptr), 10 );
-   if ( *endptr != '|'  ||  parseval > UINT_MAX ) {
+   if ( ( *endptr != '|'  &&  *endptr != '-' )  ||  parseval > UINT_MAX ) {
       LOG( LOG_ERR, "Failed to parse the RECOVERY_HEADER minor version number\n" );
       errno = EINVAL;
       return NULL;
    }
    header->minorversion = parseval;
    bufsize -= ( endptr - parse ) + 1;
+   header->compression = FTAG_COMPRESS_NONE; // compression value is optional
+   if ( *endptr == '-' ) {
+      // parse the compression type
+      parse = endptr + 1; // skip the '-' seperator
+      if ( bufsize < 3  ||  *parse != 'C' ) {
+         LOG( LOG_ERR, "Failed to parse the RECOVERY_HEADER compression type\n" );
+         errno = EINVAL;
+         return NULL;
+      }
+      parseval = strtoull( parse + 1, &(endptr), 10 );
+      if ( *endptr != '|'  ||  endptr == parse + 1  ||  ( endptr - parse ) >= bufsize ) {
+         LOG( LOG_ERR, "Failed to parse the RECOVERY_HEADER compression type\n" );
+         errno = EINVAL;
+         return NULL;
+      }
+      if ( parseval == FTAG_COMPRESS_NONE  ||  parseval > FTAG_COMPRESS_MAX ) {
+         LOG( LOG_ERR, "Unrecognized RECOVERY_HEADER compression type: %llu\n", parseval );
+         errno = EINVAL;
+         return NULL;
+      }
+      header->compression = (FTAG_COMPRESSION)parseval;
+      bufsize -= ( endptr - parse ) + 1;
+   }
    parse = endptr + 1; // skip the '|' seperator
    // parse the client tag string
    char* ctagstart = parse;
@@ -524,6 +556,69 @@ void* parse_recov_finfo( void* finfobuf, size_t bufsize, RECOVERY_FINFO* finfo )
    return parse + (taillen - 1);
 }
 
+ssize_t objref_read( void* arg, void* buf, size_t count ) {
+   recovery_objref* objref = (recovery_objref*)arg;
+   size_t remaining = ( objref->pos < objref->size ) ? objref->size - objref->pos : 0;
+   if ( count > remaining ) { count = remaining; }
+   memcpy( buf, objref->buffer + objref->pos, count );
+   objref->pos += count;
+   return count;
+}
+
+off_t objref_seek( void* arg, off_t offset ) {
+   recovery_objref* objref = (recovery_objref*)arg;
+   if ( offset < 0 ) {
+      errno = EINVAL;
+      return -1;
+   }
+   objref->pos = offset;
+   return offset;
+}
+
+void* decode_object( FTAG_COMPRESSION type, void* framebuf, size_t framesize, size_t* decodedsize ) {
+   recovery_objref objref = {
+      .buffer = (const char*)framebuf,
+      .size = framesize,
+      .pos = 0
+   };
+   COMPRESS_IO io = {
+      .arg = &(objref),
+      .read = objref_read,
+      .write = NULL,
+      .seek = objref_seek
+   };
+   COMPRESS_HANDLE handle = compress_open( type, 0, 0, &(io) );
+   if ( handle == NULL ) {
+      LOG( LOG_ERR, "Failed to open a decompression handle for the object buffer\n" );
+      return NULL;
+   }
+   // decode the entire object, one logical block at a time
+   char* decoded = NULL;
+   size_t decodedlen = 0;
+   while ( 1 ) {
+      char* newdecoded = realloc( decoded, decodedlen + COMPRESS_BLOCKSIZE );
+      if ( newdecoded == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate %zu bytes of decoded object content\n", decodedlen + COMPRESS_BLOCKSIZE );
+         free( decoded );
+         compress_abort( handle );
+         return NULL;
+      }
+      decoded = newdecoded;
+      ssize_t readres = compress_read( handle, decoded + decodedlen, COMPRESS_BLOCKSIZE );
+      if ( readres < 0 ) {
+         LOG( LOG_ERR, "Failed to decode object content at logical offset %zu\n", decodedlen );
+         free( decoded );
+         compress_abort( handle );
+         return NULL;
+      }
+      decodedlen += readres;
+      if ( readres < COMPRESS_BLOCKSIZE ) { break; }
+   }
+   compress_close( handle );
+   *decodedsize = decodedlen;
+   return decoded;
+}
+
 int populate_recovery( RECOVERY recov, void* headerend, size_t objsize ) {
    // traverse files in reverse, populating references as we go
    recov->curfile = 0;
@@ -621,15 +716,34 @@ size_t recovery_headertostr( const RECOVERY_HEADER* header, char* tgtstr, size_t
       LOG( LOG_ERR, "Asked to populate a NULL tgtstr\n" );
       return 0;
    }
+   if ( header->compression > FTAG_COMPRESS_MAX ) {
+      LOG( LOG_ERR, "Cannot output string for unrecognized compression type: %d\n", (int)header->compression );
+      return 0;
+   }
    // construct the output string, tracking total length
-   int prres = snprintf( tgtstr, size, "%s%s%.*u.%.*u|%s|%s%s", 
-                         RECOVERY_MSGHEAD,
-                         RECOVERY_HEADER_TYPE,
-                         UINT_DIGITS, header->majorversion,
-                         UINT_DIGITS, header->minorversion,
-                         header->ctag,
-                         header->streamid,
-                         RECOVERY_MSGTAIL );
+   // NOTE -- compression info is omitted for uncompressed streams, for compatibility
+   int prres;
+   if ( header->compression == FTAG_COMPRESS_NONE ) {
+      prres = snprintf( tgtstr, size, "%s%s%.*u.%.*u|%s|%s%s", 
+                        RECOVERY_MSGHEAD,
+                        RECOVERY_HEADER_TYPE,
+                        UINT_DIGITS, header->majorversion,
+                        UINT_DIGITS, header->minorversion,
+                        header->ctag,
+                        header->streamid,
+                        RECOVERY_MSGTAIL );
+   }
+   else {
+      prres = snprintf( tgtstr, size, "%s%s%.*u.%.*u-C%d|%s|%s%s", 
+                        RECOVERY_MSGHEAD,
+                        RECOVERY_HEADER_TYPE,
+                        UINT_DIGITS, header->majorversion,
+                        UINT_DIGITS, header->minorversion,
+                        (int)header->compression,
+                        header->ctag,
+                        header->streamid,
+                        RECOVERY_MSGTAIL );
+   }
    if ( prres < 0 ) { return 0; }
    return (size_t)prres;
 }
@@ -746,6 +860,7 @@ RECOVERY recovery_init( void* objbuffer, size_t objsize, RECOVERY_HEADER* header
       header->minorversion = recov->header.minorversion;
       header->ctag = strdup( recov->header.ctag );
       header->streamid = strdup( recov->header.streamid );
+      header->compression = recov->header.compression;
       if ( header->ctag == NULL  ||  header->streamid == NULL ) {
          LOG( LOG_ERR, "Failed to duplicate header strings into caller struct\n" );
          if ( header->ctag ) { free( header->ctag ); }
@@ -759,16 +874,27 @@ RECOVERY recovery_init( void* objbuffer, size_t objsize, RECOVERY_HEADER* header
       }
    }
    objsize -= (( headerend - objbuffer ) + 1);
+   // decode any compressed content following the header
+   recov->decoded = NULL;
+   if ( recov->header.compression != FTAG_COMPRESS_NONE ) {
+      recov->decoded = decode_object( recov->header.compression, headerend + 1, objsize, &(objsize) );
+      if ( recov->decoded == NULL ) {
+         LOG( LOG_ERR, "Failed to decode compressed content of the object buffer\n" );
+      }
+      else { headerend = recov->decoded - 1; } // treat decoded content as immediately following the header
+   }
    // populate per-file info
    recov->filecount = 0;
    recov->fileinfo = NULL;
    recov->filebuffers = NULL;
    recov->buffersizes = NULL;
-   if ( populate_recovery( recov, headerend, objsize ) ) {
+   if ( ( recov->header.compression != FTAG_COMPRESS_NONE  &&  recov->decoded == NULL )  ||
+        populate_recovery( recov, headerend, objsize ) ) {
       LOG( LOG_ERR, "Failed to populate per-file recovery info\n" );
       if ( recov->fileinfo ) { free( recov->fileinfo ); }
       if ( recov->filebuffers ) { free( recov->filebuffers ); }
       if ( recov->buffersizes ) { free( recov->buffersizes ); }
+      if ( recov->decoded ) { free( recov->decoded ); }
       free( recov->header.ctag );
       free( recov->header.streamid );
       free( recov );
@@ -814,11 +940,14 @@ int recovery_cont( RECOVERY recovery, void* objbuffer, size_t objsize ) {
    // verify that header info hasn't changed in this new object
    if ( newheader.majorversion != recovery->header.majorversion ||
         newheader.minorversion != recovery->header.minorversion ||
+        newheader.compression != recovery->header.compression ||
         strcmp( newheader.ctag, recovery->header.ctag )  ||
         strcmp( newheader.streamid, recovery->header.streamid ) ) {
       LOG( LOG_ERR, "Header info differs in new object buffer\n" );
       free( newheader.ctag );
       free( newheader.streamid );
+      errno = EINVAL;
+      return -1;
    }
    // we're done with new header info
    free( newheader.ctag );
@@ -828,6 +957,19 @@ int recovery_cont( RECOVERY recovery, void* objbuffer, size_t objsize ) {
       free( recovery->fileinfo[ recovery->curfile - 1 ].path );
       recovery->curfile--;
    }
+   if ( recovery->decoded ) {
+      free( recovery->decoded );
+      recovery->decoded = NULL;
+   }
+   // decode any compressed content following the header
+   if ( recovery->header.compression != FTAG_COMPRESS_NONE ) {
+      recovery->decoded = decode_object( recovery->header.compression, headerend + 1, objsize, &(objsize) );
+      if ( recovery->decoded == NULL ) {
+         LOG( LOG_ERR, "Failed to decode compressed content of the object buffer\n" );
+         return -1;
+      }
+      headerend = recovery->decoded - 1; // treat decoded content as immediately following the header
+   }
    // populate per-file info
    if ( populate_recovery( recovery, headerend, objsize ) ) {
       LOG( LOG_ERR, "Failed to populate per-file recovery info\n" );
@@ -909,6 +1051,7 @@ int recovery_close( RECOVERY recovery ) {
    if ( recovery->fileinfo ) { free( recovery->fileinfo ); }
    if ( recovery->filebuffers ) { free( recovery->filebuffers ); }
    if ( recovery->buffersizes ) { free( recovery->buffersizes ); }
+   if ( recovery->decoded ) { free( recovery->decoded ); }
    free( recovery->header.ctag );
    free( recovery->header.streamid );
    free( recovery );
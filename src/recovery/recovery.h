@@ -63,17 +63,24 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 #define RECOVERY_CURRENT_MINORVERSION 1
 #define RECOVERY_MINORVERSION_PADDING 3
 
+#include "tagging/tagging.h"
+
 #include <sys/types.h>
 
 // ALTERING HEADER OR MSG STRUCTURE IS DANGEROUS, 
 // AS IT MAY HORRIBLY BREAK PREVIOUS RECOVERY INFO AND STREAM LOGIC
 #define RECOVERY_MSGHEAD "\nRECOV("
 #define RECOVERY_MSGTAIL ")\n"
+// NOTE -- The header itself is never compressed.  For a compressed stream, all object
+//         content following the header is stored as compressed frames ( see
+//         compress/compress.h ), and the header string records the compression type.
+//         That value is omitted for uncompressed streams, for compatibility.
 typedef struct recovery_header_struct {
    unsigned int majorversion;
    unsigned int minorversion;
    char* ctag;
    char* streamid;
+   FTAG_COMPRESSION compression;
 } RECOVERY_HEADER;
 #define RECOVERY_HEADER_TYPE "HEADER||"
 
@@ -133,6 +140,8 @@ int recovery_finfofromstr( RECOVERY_FINFO* finfo, char* srcstr, size_t len );
 /**
  * Initialize a RECOVERY reference for a data stream, based on the given object data, 
  * and populate a RECOVERY_HEADER reference with the stream info
+ * NOTE -- The object data is expected exactly as stored.  Any compressed content is
+ *         decoded by the RECOVERY reference itself.
  * @param void* objbuffer : Reference to the data content of an object to produce a 
  *                          recovery reference for
  * @param size_t objsize : Size of the previous data buffer argument
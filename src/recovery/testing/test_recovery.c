@@ -63,6 +63,24 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 // directly including the C file allows more flexibility for these tests
 #include "recovery/recovery.c"
 
+typedef struct testobj_struct {
+   char*  buffer;
+   size_t size;
+   size_t alloc;
+} testobj;
+
+ssize_t testobj_write( void* arg, const void* buf, size_t count ) {
+   testobj* obj = (testobj*)arg;
+   if ( obj->size + count > obj->alloc ) {
+      printf( "Compressed object content exceeds buffer of %zu bytes\n", obj->alloc );
+      errno = ENOSPC;
+      return -1;
+   }
+   memcpy( obj->buffer + obj->size, buf, count );
+   obj->size += count;
+   return count;
+}
+
 int main(int argc, char **argv)
 {
    // NOTE -- I'm ignoring memory leaks for error conditions 
@@ -495,6 +513,134 @@ int main(int argc, char **argv)
       return -1;
    }
 
+   free( cmpheader.ctag );
+   free( cmpheader.streamid );
+
+   // produce a header string for a compressed stream
+   header.compression = FTAG_COMPRESS_ZLIB;
+   size_t compheaderstrlen = recovery_headertostr( &(header), NULL, 0 );
+   if ( compheaderstrlen <= headerstrlen ) {
+      printf( "Unexpected length of compressed recovery header string: %zu\n", compheaderstrlen );
+      return -1;
+   }
+   char* compheaderstr = malloc( sizeof(char) * (compheaderstrlen + 1) );
+   if ( compheaderstr == NULL ) {
+      printf( "Failed to allocate space for compressed header string of length %zu\n", compheaderstrlen );
+      return -1;
+   }
+   if ( recovery_headertostr( &(header), compheaderstr, compheaderstrlen + 1 ) != compheaderstrlen ) {
+      printf( "Inconsistent length of compressed recovery header string\n" );
+      return -1;
+   }
+   printf( "Compressed Recovery Header String: \n\"%s\"\n", compheaderstr );
+   if ( parse_recov_header( compheaderstr, compheaderstrlen, &(cmpheader) ) !=
+         (compheaderstr + (compheaderstrlen - 1)) ) {
+      printf( "Failed to parse compressed header string\n" );
+      return -1;
+   }
+   if ( cmpheader.compression != FTAG_COMPRESS_ZLIB  ||
+        cmpheader.majorversion != header.majorversion  ||
+        cmpheader.minorversion != header.minorversion  ||
+        strcmp( cmpheader.ctag, header.ctag )  ||
+        strcmp( cmpheader.streamid, header.streamid ) ) {
+      printf( "Parsed compressed header has different values\n" );
+      return -1;
+   }
+   free( cmpheader.ctag );
+   free( cmpheader.streamid );
+
+   // produce a compressed object, with the same content following the header
+   testobj compobj = {
+      .buffer = malloc( objlen ),
+      .size = 0,
+      .alloc = objlen
+   };
+   if ( compobj.buffer == NULL ) {
+      printf( "Failed to allocate compressed object buffer of length %zu\n", objlen );
+      return -1;
+   }
+   memcpy( compobj.buffer, compheaderstr, compheaderstrlen ); // header is never compressed
+   compobj.size = compheaderstrlen;
+   COMPRESS_IO io = {
+      .arg = &(compobj),
+      .read = NULL,
+      .write = testobj_write,
+      .seek = NULL
+   };
+   COMPRESS_HANDLE comphandle = compress_open( FTAG_COMPRESS_ZLIB, 0, 1, &(io) );
+   if ( comphandle == NULL ) {
+      printf( "Failed to open a compression handle for the fake object\n" );
+      return -1;
+   }
+   if ( compress_write( comphandle, objbuffer + headerstrlen, objlen - headerstrlen ) != (objlen - headerstrlen) ) {
+      printf( "Failed to write compressed content of fake object\n" );
+      return -1;
+   }
+   if ( compress_close( comphandle ) ) {
+      printf( "Failed to close compression handle of fake object\n" );
+      return -1;
+   }
+   printf( "Compressed fake object from %zu to %zu bytes\n", objlen, compobj.size );
+   if ( compobj.size >= objlen ) {
+      printf( "Compressed fake object is no smaller than the original\n" );
+      return -1;
+   }
+
+   // initialize a recovery object against the compressed object
+   recov = recovery_init( compobj.buffer, compobj.size, &(cmpheader) );
+   if ( recov == NULL ) {
+      printf( "Failed to init recov against compressed fake object\n" );
+      return -1;
+   }
+   if ( cmpheader.compression != FTAG_COMPRESS_ZLIB ) {
+      printf( "Recovered header of compressed object has unexpected compression: %d\n", (int)cmpheader.compression );
+      return -1;
+   }
+   // iterate over files, verifying sizes and content ( repeating once, via recovery_cont() )
+   int iteration = 0;
+   for ( ; iteration < 2; iteration++ ) {
+      if ( iteration  &&  recovery_cont( recov, compobj.buffer, compobj.size ) ) {
+         printf( "Failed to continue recov of compressed object\n" );
+         return -1;
+      }
+      RECOVERY_FINFO* expected[3] = { &(finfo3), &(finfo2), &(finfo) };
+      size_t expectedsize[3] = { 10240, 0, 10485760 };
+      int index = 0;
+      for ( ; index < 3; index++ ) {
+         if ( recovery_nextfile( recov, &(cmpfinfo), &(databuf), &(bufsize) ) != 1 ) {
+            printf( "Failed to retrieve compressed finfo %d\n", index );
+            return -1;
+         }
+         if ( bufsize != expectedsize[index]  ||  memcmp( databuf, zerobuf, bufsize ) ) {
+            printf( "Unexpected data of compressed finfo %d: bufsize = %zu\n", index, bufsize );
+            return -1;
+         }
+         if ( cmpfinfo.inode != expected[index]->inode  ||
+              cmpfinfo.size != expected[index]->size  ||
+              cmpfinfo.eof != expected[index]->eof  ||
+              strcmp( cmpfinfo.path, expected[index]->path ) ) {
+            printf( "Recovered compressed finfo %d has unexpected values: path = \"%s\"\n", index, cmpfinfo.path );
+            return -1;
+         }
+         free( cmpfinfo.path );
+      }
+      if ( recovery_nextfile( recov, &(cmpfinfo), &(databuf), &(bufsize) ) != 0 ) {
+         printf( "Trailing file in recov of compressed object\n" );
+         return -1;
+      }
+   }
+   // an uncompressed object is not a continuation of this stream
+   if ( recovery_cont( recov, objbuffer, objlen ) == 0 ) {
+      printf( "Unexpected success of recovery_cont() with an uncompressed object\n" );
+      return -1;
+   }
+   if ( recovery_close( recov ) ) {
+      printf( "Failed to close recovery ref of compressed object\n" );
+      return -1;
+   }
+   free( compobj.buffer );
+   free( compheaderstr );
+
    // cleanup object refs
    free( finfo2.path );
    free( finfo3.path );
@@ -69,6 +69,7 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 #include "resourcelog.h"
 
 #include <pthread.h>
+#include <stdint.h>
 
 //   -------------   INTERNAL DEFINITIONS    -------------
 
@@ -78,6 +79,32 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
                                                       //    - only op starts, no completions
 #define MODIFY_LOG_PREFIX "RESOURCE-MODIFY-LOGFILE\n" // prefix for a 'modify'-log
                                                       //    - mix of op starts and completions
+#define OPINDEX_MIN_BUCKETS 1024 // minimum bucket count of each inprogress index table
+                                 //    tables are doubled whenever they average more than two entries per bucket
+
+typedef struct opstream_struct {
+   char*    streamid;              // stream ID shared by all ops of this list
+   uint64_t hashval;               // hash of the stream ID
+   opinfo*  ops;                   // list of inprogress ops on this stream ( most recently started first )
+   struct opstream_struct* hnext;  // next stream in the same index bucket
+} opstream;
+
+typedef struct opentry_struct {
+   opinfo*   op;                   // inprogress op
+   opinfo*   prev;                 // op preceeding this one in the stream list ( NULL if at the head )
+   opstream* stream;               // stream list containing this op
+   uint64_t  hashval;              // hash of ( streamid, fileno, objno, type )
+   struct opentry_struct* hnext;   // next entry in the same index bucket
+} opentry;
+
+typedef struct opindex_struct {
+   opstream** streams;     // stream lists, bucketed by streamid
+   size_t     streambuckets;
+   size_t     streamcount;
+   opentry**  entries;     // individual ops, bucketed by ( streamid, fileno, objno, type )
+   size_t     entrybuckets;
+   size_t     entrycount;
+}* OPINDEX;
 
 typedef struct resourcelog_struct {
    // synchronization and access control
@@ -88,13 +115,317 @@ typedef struct resourcelog_struct {
    // state info
    resourcelog_type     type;
    operation_summary summary;
-   HASH_TABLE        inprogress;  // left NULL for a 'record' log
+   OPINDEX           inprogress;  // left NULL for a read log
    int               logfile;
    char*             logfilepath;
 }*RESOURCELOG;
 
 //   -------------   INTERNAL FUNCTIONS    -------------
 
+/**
+ * Hash the given string ( FNV-1a )
+ * @param const char* str : String to be hashed
+ * @return uint64_t : Resulting hash value
+ */
+uint64_t opindex_strhash( const char* str ) {
+   uint64_t hashval = 14695981039346656037ULL;
+   for ( ; *str != '\0'; str++ ) {
+      hashval ^= (unsigned char)(*str);
+      hashval *= 1099511628211ULL;
+   }
+   return hashval;
+}
+
+/**
+ * Hash the identifying values of the given op
+ * @param uint64_t strhash : Hash of the op streamid ( see opindex_strhash() )
+ * @param const opinfo* op : Op to be hashed
+ * @return uint64_t : Resulting hash value
+ */
+uint64_t opindex_ophash( uint64_t strhash, const opinfo* op ) {
+   uint64_t hashval = strhash;
+   hashval = ( hashval ^ (uint64_t)op->ftag.fileno ) * 0x9E3779B97F4A7C15ULL;
+   hashval = ( hashval ^ (uint64_t)op->ftag.objno ) * 0x9E3779B97F4A7C15ULL;
+   hashval = ( hashval ^ (uint64_t)op->type ) * 0x9E3779B97F4A7C15ULL;
+   return hashval ^ ( hashval >> 29 );
+}
+
+/**
+ * Allocate a new, empty inprogress op index
+ * @param size_t buckets : Initial bucket count of the index tables ( rounded up to a power of two )
+ * @return OPINDEX : New index, or NULL on failure
+ */
+OPINDEX opindex_init( size_t buckets ) {
+   size_t realbuckets = OPINDEX_MIN_BUCKETS;
+   while ( realbuckets < buckets ) { realbuckets <<= 1; }
+   OPINDEX index = malloc( sizeof( struct opindex_struct ) );
+   if ( index == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate a new inprogress op index\n" );
+      return NULL;
+   }
+   index->streams = calloc( realbuckets, sizeof( opstream* ) );
+   index->entries = calloc( realbuckets, sizeof( opentry* ) );
+   if ( index->streams == NULL  ||  index->entries == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate %zu buckets of a new inprogress op index\n", realbuckets );
+      if ( index->streams ) { free( index->streams ); }
+      if ( index->entries ) { free( index->entries ); }
+      free( index );
+      return NULL;
+   }
+   index->streambuckets = realbuckets;
+   index->streamcount = 0;
+   index->entrybuckets = realbuckets;
+   index->entrycount = 0;
+   return index;
+}
+
+/**
+ * Destroy the given inprogress op index, freeing all remaining ops
+ * @param OPINDEX index : Index to be destroyed
+ */
+void opindex_term( OPINDEX index ) {
+   size_t bucket;
+   for ( bucket = 0; bucket < index->entrybuckets; bucket++ ) {
+      opentry* entry = index->entries[bucket];
+      while ( entry ) {
+         opentry* nextentry = entry->hnext;
+         free( entry );
+         entry = nextentry;
+      }
+   }
+   for ( bucket = 0; bucket < index->streambuckets; bucket++ ) {
+      opstream* stream = index->streams[bucket];
+      while ( stream ) {
+         opstream* nextstream = stream->hnext;
+         if ( stream->ops ) { resourcelog_freeopinfo( stream->ops ); }
+         free( stream->streamid );
+         free( stream );
+         stream = nextstream;
+      }
+   }
+   free( index->entries );
+   free( index->streams );
+   free( index );
+}
+
+/**
+ * Double the bucket count of the entry table of the given index, if it has become overloaded
+ * NOTE -- a failure to grow the table is not an error, it will just remain overloaded
+ * @param OPINDEX index : Index to be checked
+ */
+void opindex_growentries( OPINDEX index ) {
+   if ( index->entrycount <= 2 * index->entrybuckets ) { return; }
+   size_t newbuckets = index->entrybuckets << 1;
+   opentry** newentries = calloc( newbuckets, sizeof( opentry* ) );
+   if ( newentries == NULL ) {
+      LOG( LOG_WARNING, "Failed to expand inprogress op index to %zu entry buckets\n", newbuckets );
+      return;
+   }
+   size_t bucket;
+   for ( bucket = 0; bucket < index->entrybuckets; bucket++ ) {
+      opentry* entry = index->entries[bucket];
+      while ( entry ) {
+         opentry* nextentry = entry->hnext;
+         size_t newbucket = entry->hashval & ( newbuckets - 1 );
+         entry->hnext = newentries[newbucket];
+         newentries[newbucket] = entry;
+         entry = nextentry;
+      }
+   }
+   free( index->entries );
+   index->entries = newentries;
+   index->entrybuckets = newbuckets;
+}
+
+/**
+ * Double the bucket count of the stream table of the given index, if it has become overloaded
+ * NOTE -- a failure to grow the table is not an error, it will just remain overloaded
+ * @param OPINDEX index : Index to be checked
+ */
+void opindex_growstreams( OPINDEX index ) {
+   if ( index->streamcount <= 2 * index->streambuckets ) { return; }
+   size_t newbuckets = index->streambuckets << 1;
+   opstream** newstreams = calloc( newbuckets, sizeof( opstream* ) );
+   if ( newstreams == NULL ) {
+      LOG( LOG_WARNING, "Failed to expand inprogress op index to %zu stream buckets\n", newbuckets );
+      return;
+   }
+   size_t bucket;
+   for ( bucket = 0; bucket < index->streambuckets; bucket++ ) {
+      opstream* stream = index->streams[bucket];
+      while ( stream ) {
+         opstream* nextstream = stream->hnext;
+         size_t newbucket = stream->hashval & ( newbuckets - 1 );
+         stream->hnext = newstreams[newbucket];
+         newstreams[newbucket] = stream;
+         stream = nextstream;
+      }
+   }
+   free( index->streams );
+   index->streams = newstreams;
+   index->streambuckets = newbuckets;
+}
+
+/**
+ * Locate the most recently started inprogress op matching the streamid, fileno, objno, and type of the given op
+ * @param OPINDEX index : Index to search
+ * @param const opinfo* op : Op to be matched
+ * @return opentry* : Entry of the matching op, or NULL if none exists
+ */
+opentry* opindex_findop( OPINDEX index, const opinfo* op ) {
+   uint64_t hashval = opindex_ophash( opindex_strhash( op->ftag.streamid ), op );
+   opentry* entry = index->entries[ hashval & ( index->entrybuckets - 1 ) ];
+   for ( ; entry; entry = entry->hnext ) {
+      if ( entry->hashval == hashval  &&
+           entry->op->type == op->type  &&
+           entry->op->ftag.fileno == op->ftag.fileno  &&
+           entry->op->ftag.objno == op->ftag.objno  &&
+           strcmp( entry->op->ftag.streamid, op->ftag.streamid ) == 0 ) {
+         return entry;
+      }
+   }
+   return NULL;
+}
+
+/**
+ * Locate the index entry of exactly the given inprogress op
+ * @param OPINDEX index : Index to search
+ * @param const opinfo* op : Inprogress op to locate
+ * @param opentry*** entryref : Reference to be populated with the bucket slot referencing the entry
+ * @return opentry* : Entry of the given op, or NULL if it is not indexed
+ */
+opentry* opindex_entryof( OPINDEX index, const opinfo* op, opentry*** entryref ) {
+   uint64_t hashval = opindex_ophash( opindex_strhash( op->ftag.streamid ), op );
+   opentry** slot = &( index->entries[ hashval & ( index->entrybuckets - 1 ) ] );
+   for ( ; *slot; slot = &((*slot)->hnext) ) {
+      if ( (*slot)->op == op ) {
+         if ( entryref ) { *entryref = slot; }
+         return *slot;
+      }
+   }
+   return NULL;
+}
+
+/**
+ * Insert the given op chain at the head of the inprogress list of its stream
+ * @param OPINDEX index : Index to be updated
+ * @param opinfo* chain : Op chain to be inserted ( the index takes ownership of this chain )
+ * @param opinfo* finop : Final op of the given chain
+ * @return int : Zero on success, or -1 on failure ( chain remains owned by the caller )
+ */
+int opindex_insertchain( OPINDEX index, opinfo* chain, opinfo* finop ) {
+   // locate or create the stream list
+   uint64_t strhash = opindex_strhash( chain->ftag.streamid );
+   opstream** streamslot = &( index->streams[ strhash & ( index->streambuckets - 1 ) ] );
+   opstream* stream = *streamslot;
+   while ( stream  &&  ( stream->hashval != strhash  ||  strcmp( stream->streamid, chain->ftag.streamid ) ) ) {
+      stream = stream->hnext;
+   }
+   char newstream = 0;
+   if ( stream == NULL ) {
+      stream = malloc( sizeof( struct opstream_struct ) );
+      if ( stream == NULL  ||  (stream->streamid = strdup( chain->ftag.streamid )) == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate inprogress list of stream \"%s\"\n", chain->ftag.streamid );
+         if ( stream ) { free( stream ); }
+         return -1;
+      }
+      stream->hashval = strhash;
+      stream->ops = NULL;
+      newstream = 1;
+   }
+   // allocate all entries, prior to modifying the index
+   opentry* newentries = NULL;
+   opinfo* parseop = chain;
+   opinfo* prevop = NULL;
+   while ( prevop != finop ) {
+      opentry* entry = malloc( sizeof( struct opentry_struct ) );
+      if ( entry == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate inprogress index entry for op on stream \"%s\"\n", parseop->ftag.streamid );
+         while ( newentries ) {
+            entry = newentries->hnext;
+            free( newentries );
+            newentries = entry;
+         }
+         if ( newstream ) { free( stream->streamid ); free( stream ); }
+         return -1;
+      }
+      entry->op = parseop;
+      entry->prev = prevop;
+      entry->stream = stream;
+      entry->hashval = opindex_ophash( opindex_strhash( parseop->ftag.streamid ), parseop );
+      entry->hnext = newentries;
+      newentries = entry;
+      prevop = parseop;
+      parseop = parseop->next;
+   }
+   // stitch the chain onto the front of the stream list
+   if ( stream->ops ) {
+      opentry* headentry = opindex_entryof( index, stream->ops, NULL );
+      if ( headentry ) { headentry->prev = finop; }
+   }
+   finop->next = stream->ops;
+   stream->ops = chain;
+   if ( newstream ) {
+      stream->hnext = *streamslot;
+      *streamslot = stream;
+      index->streamcount++;
+   }
+   // index all new entries
+   while ( newentries ) {
+      opentry* entry = newentries;
+      newentries = entry->hnext;
+      size_t bucket = entry->hashval & ( index->entrybuckets - 1 );
+      entry->hnext = index->entries[bucket];
+      index->entries[bucket] = entry;
+      index->entrycount++;
+   }
+   opindex_growentries( index );
+   if ( newstream ) { opindex_growstreams( index ); }
+   return 0;
+}
+
+/**
+ * Remove a sequence of ops from the inprogress list of their stream
+ * @param OPINDEX index : Index to be updated
+ * @param opentry* firstentry : Entry of the first op of the sequence
+ * @param opinfo* lastop : Final op of the sequence
+ * @return opinfo* : The removed op sequence ( caller must free )
+ */
+opinfo* opindex_removerun( OPINDEX index, opentry* firstentry, opinfo* lastop ) {
+   opinfo* firstop = firstentry->op;
+   opinfo* prevop = firstentry->prev;
+   opstream* stream = firstentry->stream;
+   // pull the sequence out of the stream list
+   if ( prevop ) { prevop->next = lastop->next; }
+   else { stream->ops = lastop->next; }
+   if ( lastop->next ) {
+      opentry* nextentry = opindex_entryof( index, lastop->next, NULL );
+      if ( nextentry ) { nextentry->prev = prevop; }
+   }
+   lastop->next = NULL;
+   // drop all index entries of the sequence
+   opinfo* parseop = firstop;
+   for ( ; parseop; parseop = parseop->next ) {
+      opentry** slot = NULL;
+      opentry* entry = opindex_entryof( index, parseop, &(slot) );
+      if ( entry ) {
+         *slot = entry->hnext;
+         free( entry );
+         index->entrycount--;
+      }
+   }
+   // drop the stream list itself, if now empty
+   if ( stream->ops == NULL ) {
+      opstream** streamslot = &( index->streams[ stream->hashval & ( index->streambuckets - 1 ) ] );
+      while ( *streamslot != stream ) { streamslot = &((*streamslot)->hnext); }
+      *streamslot = stream->hnext;
+      free( stream->streamid );
+      free( stream );
+      index->streamcount--;
+   }
+   return firstop;
+}
+
 /**
  * Clean up the provided resourcelog ( lock must be held )
  * @param RESOURCELOG rsrclog : Reference to the resourcelog to be cleaned
@@ -102,17 +433,8 @@ typedef struct resourcelog_struct {
  *                       If zero, all state will be purged, but the struct can be reinitialized
  */
 void cleanuplog( RESOURCELOG rsrclog, char destroy ) {
-   HASH_NODE* nodelist = NULL;
-   size_t index = 0;
    if ( rsrclog->inprogress ) {
-      hash_term( rsrclog->inprogress, &nodelist, &index );
-      while ( index ) {
-         opinfo* opindex = (nodelist + index - 1)->content;
-         resourcelog_freeopinfo( opindex );
-         free( (nodelist + index - 1)->name );
-         index--;
-      }
-      free( nodelist );
+      opindex_term( rsrclog->inprogress );
       rsrclog->inprogress = NULL;
    }
    if ( rsrclog->logfilepath ) { free( rsrclog->logfilepath ); }
@@ -746,36 +1068,15 @@ int processopinfo( RESOURCELOG rsrclog, opinfo* newop, char* progressop, char* d
          return -1;
       }
    }
-   // map this operation into our inprogress hash table
-   HASH_NODE* node = NULL;
-   if ( hash_lookup( rsrclog->inprogress, newop->ftag.streamid, &node ) < 0 ) {
-      LOG( LOG_ERR, "Failed to map operation on \"%s\" into inprogress HASH_TABLE\n", newop->ftag.streamid );
-      return -1;
-   }
-   // traverse the attached operations, looking for a match
+   // look for an exact match ( streamid, type, fileno, objno ) in our inprogress index
+   opentry* entry = opindex_findop( rsrclog->inprogress, newop );
+   opinfo* opindex = NULL;
    char activealike = 0; // track if we have active ops of the same type in the same 'segment'
-   opinfo* opindex = node->content;
-   opinfo* prevop = NULL;
-   while ( opindex != NULL ) {
-      if ( strcmp( opindex->ftag.streamid, newop->ftag.streamid ) == 0 ) {
-         // check for exact match ( type, fileno, objno )
-         if ( (opindex->ftag.objno == newop->ftag.objno)  &&
-              (opindex->ftag.fileno == newop->ftag.fileno)  &&
-              (opindex->type == newop->type) ) {
-            break;
-         }
-         else if ( opindex->type == newop->type ) {
-            activealike = 1; // found an active op of the same type
-         }
-         else {
-            activealike = 0; // op 'segement' is broken, reset
-         }
-      }
-      else {
-         activealike = 0; // op 'segement' is broken, reset
-      }
-      prevop = opindex;
-      opindex = opindex->next;
+   if ( entry ) {
+      opindex = entry->op;
+      // an immediately preceeding op of the same type indicates the 'segment' is still active
+      if ( entry->prev  &&  entry->prev->type == newop->type  &&
+           strcmp( entry->prev->ftag.streamid, newop->ftag.streamid ) == 0 ) { activealike = 1; }
    }
    if ( opindex != NULL ) {
       // repeat of operation start can be ignored
@@ -848,18 +1149,8 @@ int processopinfo( RESOURCELOG rsrclog, opinfo* newop, char* progressop, char* d
             // decrement in-progress cnt
             rsrclog->outstandingcnt--;
          }
-         // ...and remove the matching op(s) from inprogress
-         if ( prevop ) {
-            // pull the matching ops out of the list
-            prevop->next = previndex->next;
-         }
-         else {
-            // no previous op means the matching op is the first one; just remove it
-            node->content = previndex->next;
-         }
-         // free the removed operation chain
-         previndex->next = NULL; // so we don't end up freeing any predecessors
-         resourcelog_freeopinfo( opindex );
+         // ...and remove ( then free ) the matching op(s) from inprogress
+         resourcelog_freeopinfo( opindex_removerun( rsrclog->inprogress, entry, previndex ) );
       }
       // a matching op means the parsed operation can be discarded
       // tell the caller to free their own op chain
@@ -873,8 +1164,10 @@ int processopinfo( RESOURCELOG rsrclog, opinfo* newop, char* progressop, char* d
       }
       if ( rsrclog->type == RESOURCE_MODIFY_LOG ) {
          // stitch the new op onto the front of our inprogress list
-         finop->next = node->content;
-         node->content = newop;
+         if ( opindex_insertchain( rsrclog->inprogress, newop, finop ) ) {
+            LOG( LOG_ERR, "Failed to insert new op on \"%s\" into inprogress index\n", newop->ftag.streamid );
+            return -1;
+         }
          // note that we have another op in flight
          rsrclog->outstandingcnt += oplength;
          // tell the caller NOT to free this chain
@@ -1428,38 +1721,10 @@ int resourcelog_init( RESOURCELOG* resourcelog, const char* logpath, resourcelog
          return -1;
       }
    }
-   // initialize our HASH_TABLE
-   HASH_NODE* nodelist = malloc( sizeof(HASH_NODE) * ns->prepo->metascheme.refnodecount );
-   if ( nodelist == NULL ) {
-      LOG( LOG_ERR, "Failed to allocate nodelist for in progress hash table\n" );
-      cleanuplog( rsrclog, 1 );
-      return -1;
-   }
-   size_t index = 0;
-   for ( ; index < ns->prepo->metascheme.refnodecount; index++ ) {
-      // initialize node list to mirror the reference nodes
-      (nodelist + index)->content = NULL;
-      (nodelist + index)->weight = (ns->prepo->metascheme.refnodes + index)->weight;
-      (nodelist + index)->name = strdup( (ns->prepo->metascheme.refnodes + index)->name );
-      if ( (nodelist + index)->name == NULL ) {
-         LOG( LOG_ERR, "Failed to allocate name of node %zu\n", index );
-         while ( index ) {
-            free( (nodelist + index - 1)->name );
-            index--;
-         }
-         free( nodelist );
-         cleanuplog( rsrclog, 1 );
-         return -1;
-      }
-   }
-   rsrclog->inprogress = hash_init( nodelist, ns->prepo->metascheme.refnodecount, 0 );
+   // initialize our inprogress index
+   rsrclog->inprogress = opindex_init( ns->prepo->metascheme.refnodecount );
    if ( rsrclog->inprogress == NULL ) {
-      LOG( LOG_ERR, "Failed to initialize inprogress hash table\n" );
-      while ( index ) {
-         free( (nodelist + index - 1)->name );
-         index--;
-      }
-      free( nodelist );
+      LOG( LOG_ERR, "Failed to initialize inprogress op index\n" );
       cleanuplog( rsrclog, 1 );
       return -1;
    }
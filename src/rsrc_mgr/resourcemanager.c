@@ -93,11 +93,13 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 #define DEFAULT_LOG_ROOT "/var/log/marfs-rman"
 #define MODIFY_ITERATION_PARENT "RMAN-MODIFY-RUNS"
 #define RECORD_ITERATION_PARENT "RMAN-RECORD-RUNS"
+#define CHECKPOINT_PARENT "RMAN-CHECKPOINTS"
 #define SUMMARY_FILENAME "summary.log"
 #define ITERATION_ARGS_FILE "PROGRAM-ARGUMENTS"
 #define ITERATION_STRING_LEN 128
 #define OLDLOG_PREALLOC 16  // pre-allocate space for 16 logfiles in the oldlogs hash table ( double from there, as needed )
 #define MAX_ERROR_BUFFER MAX_STR_BUFFER + 100  // define our error strings as slightly larger than the error message itself
+#define RANK_PIPELINE_DEPTH 2  // max requests outstanding to each worker rank ( current + prefetched next )
 
 typedef struct rmanstate_struct {
    // Per-Run Rank State
@@ -134,7 +136,10 @@ typedef struct rmanstate_struct {
    char        iteration[ITERATION_STRING_LEN];
    char*       execprevroot;
    char*       logroot;
+   char*       ckptroot;
    char*       preservelogtgt;
+   size_t      rpckbudget;
+   throttle_limits limits;
 } rmanstate;
 
 typedef enum {
@@ -166,6 +171,16 @@ typedef struct workresponse_struct {
    char                 errorstr[MAX_ERROR_BUFFER];
 } workresponse;
 
+typedef struct rankpipeline_struct {
+   workresponse response;    // buffer for the outstanding response receive
+   workrequest  requests[RANK_PIPELINE_DEPTH]; // buffers for outstanding request sends
+   MPI_Request  sendreqs[RANK_PIPELINE_DEPTH];
+   workrequest  lastsent;    // copy of the most recent request sent to the rank
+   size_t       sendcount;   // count of requests sent to the rank
+   size_t       inflight;    // count of requests sent, for which no response has been received
+   char         started;     // flag indicating that the startup response of the rank has been received
+} rankpipeline;
+
 typedef struct loginfo_struct {
    size_t nsindex;
    size_t logcount;
@@ -179,7 +194,8 @@ void print_usage_info() {
    printf( "\n"
            "marfs-rman [-c MarFS-Config-File] [-n MarFS-NS-Target] [-r] [-i Iteraion-Name] [-l Log-Root]\n"
            "           [-p Log-Pres-Root] [-d] [-X Execution-Target] [-Q] [-G] [-R] [-P] [-C]\n"
-           "           [-T Threshold-Values] [-L Rebuild-Location] [-h]\n"
+           "           [-T Threshold-Values] [-L Rebuild-Location] [-I Checkpoint-Age]\n"
+           "           [-B Repack-Budget] [-O Op-Rate-Limits] [-W Bandwidth-Limits] [-h]\n"
            "\n"
            " Arguments --\n"
            "  -c MarFS-Config-File : Specifies the path of the MarFS config file to use\n"
@@ -215,17 +231,98 @@ void print_usage_info() {
            "                                <Unit>       = 's' ( seconds ), 'm' ( minutes ),\n"
            "                                               'h' ( hours ), 'd' ( days )\n"
            "                                               ( assumed to be 's', if omitted )\n"
-           "  -L Rebuild-Location  : Specifies NE object location to target for rebuilds\n"
-           "                         (!!!CURRENTLY UNIMPLEMENTED!!!)\n"
+           "  -L Rebuild-Location  : Specifies NE object location to target for rebuilds ( implies\n"
+           "                         '-R' ).  All objects referenced by live files at this location\n"
+           "                         will be rebuilt, rather than only those with rebuild markers.\n"
+           "                         Value Format = [p<Pod>][-c<Cap>][-s<Scatter>]\n"
+           "                         ( omitted location values will match any value ).  If combined\n"
+           "                         with '-I', reference dirs left unchanged since their previous\n"
+           "                         GC, repack, or location-based sweep will have their rebuild\n"
+           "                         targets drawn from the object manifest of that sweep, rather\n"
+           "                         than walking their datastreams.\n"
+           "  -I Checkpoint-Age    : Specifies an incremental sweep.  Reference dirs which are\n"
+           "                         unchanged since a checkpoint no older than this value will\n"
+           "                         not be scanned, with their previous quota values carried\n"
+           "                         forward instead.  Value Format = <TimeThresh>[<Unit>]\n"
+           "                         ( see '-T' ).  Note that files unlinked from a skipped\n"
+           "                         reference dir will not be GCd until a full scan of it.\n"
+           "                         This argument is incompatible with '-d'.\n"
+           "  -B Repack-Budget     : Specifies the total bytes of live data which may be repacked\n"
+           "                         by this run ( requires '-P' ).  Repack candidates are ranked\n"
+           "                         by the objects they would free, per object of data rewritten,\n"
+           "                         and only the most beneficial are performed.  The budget is\n"
+           "                         divided evenly between all working ranks.\n"
+           "                         Value Format = <Bytes>[<Unit>]\n"
+           "                         Where, <Unit> = 'K', 'M', 'G', or 'T' ( binary multiples )\n"
+           "                         ( unlimited, if unspecified )\n"
+           "  -O Op-Rate-Limits    : Specifies the maximum rate of object operations at each storage\n"
+           "                         location ( pod and cap ), to limit interference with clients.\n"
+           "                         Value Format = <OpFlag><Rate>[-<OpFlag><Rate>]*\n"
+           "                         Where, <OpFlag> = 'G', 'R', or 'P' ( see prev args )\n"
+           "                                <Rate>   = Objects per second, across the entire run\n"
+           "                         ( all ops are unlimited, if unspecified )\n"
+           "  -W Bandwidth-Limits  : Specifies the maximum data rate of object operations at each\n"
+           "                         storage location ( see '-O' ).\n"
+           "                         Value Format = <OpFlag><Rate>[<Unit>][-<OpFlag><Rate>[<Unit>]]*\n"
+           "                         Where, <OpFlag> = 'R' or 'P' ( see prev args )\n"
+           "                                <Rate>   = Bytes per second, across the entire run\n"
+           "                                <Unit>   = 'K', 'M', 'G', or 'T' ( binary multiples )\n"
+           "                         ( all ops are unlimited, if unspecified )\n"
+           "                         Rate limits are divided evenly between all working ranks.\n"
            "  -h                   : Prints this usage info\n"
            "\n",
            DEFAULT_LOG_ROOT );
 }
 
+/**
+ * Parse a set of per-op rate limit values
+ * @param const char* valstr : String to be parsed ( <OpFlag><Rate>[<Unit>][-<OpFlag><Rate>[<Unit>]]* )
+ * @param size_t* rates : Array of THROTTLE_OPTYPES rates, to be populated with parsed values
+ * @param char units : If non-zero, binary unit suffixes ( 'K', 'M', 'G', or 'T' ) and byte rates are accepted;
+ *                     if zero, only op rates are accepted
+ * @return int : Zero on success, or -1 on failure
+ */
+int parse_ratelimits( const char* valstr, size_t* rates, char units ) {
+   if ( *valstr == '\0' ) { return -1; }
+   const char* parse = valstr;
+   while ( *parse != '\0' ) {
+      // check for an op type flag
+      operation_type type = MARFS_DELETE_REF_OP;
+      if ( *parse == 'G'  &&  !(units) ) { type = MARFS_DELETE_OBJ_OP; } // deletions transfer no data
+      else if ( *parse == 'R' ) { type = MARFS_REBUILD_OP; }
+      else if ( *parse == 'P' ) { type = MARFS_REPACK_OP; }
+      else { return -1; }
+      parse++;
+      // parse the expected numeric value trailing the type flag
+      if ( *parse < '0'  ||  *parse > '9' ) { return -1; }
+      char* endptr = NULL;
+      unsigned long long parseval = strtoull( parse, &(endptr), 10 );
+      if ( parseval == 0  ||  parseval == ULLONG_MAX  ||  endptr == NULL ) { return -1; }
+      unsigned long long unitmult = 1;
+      if ( units ) {
+         if ( *endptr == 'K' ) { unitmult = 1024ULL; endptr++; }
+         else if ( *endptr == 'M' ) { unitmult = 1024ULL * 1024; endptr++; }
+         else if ( *endptr == 'G' ) { unitmult = 1024ULL * 1024 * 1024; endptr++; }
+         else if ( *endptr == 'T' ) { unitmult = 1024ULL * 1024 * 1024 * 1024; endptr++; }
+      }
+      if ( ( *endptr != '-'  &&  *endptr != '\0' )  ||  parseval > SIZE_MAX / unitmult ) { return -1; }
+      rates[type] = (size_t)( parseval * unitmult );
+      // progress to the next value
+      parse = endptr;
+      if ( *parse == '-' ) {
+         parse++;
+         if ( *parse == '\0' ) { return -1; }
+      }
+   }
+   return 0;
+}
+
 void cleanupstate( rmanstate* rman, char abort ) {
    if ( rman ) {
       if ( rman->preservelogtgt ) { free( rman->preservelogtgt ); }
       if ( rman->logroot )        { free( rman->logroot ); }
+      if ( rman->ckptroot )       { free( rman->ckptroot ); }
+      if ( rman->gstate.ckptdir ) { free( rman->gstate.ckptdir ); }
       if ( rman->execprevroot )   { free( rman->execprevroot ); }
       if ( rman->summarylog )     { fclose( rman->summarylog ); }
       if ( rman->tq ) {
@@ -248,6 +345,8 @@ void cleanupstate( rmanstate* rman, char abort ) {
          tq_close( rman->tq );
       }
       if ( rman->gstate.rpst ) { repackstreamer_abort( rman->gstate.rpst ); }
+      if ( rman->gstate.rpolicy ) { repackpolicy_term( rman->gstate.rpolicy, NULL ); }
+      if ( rman->gstate.throttle ) { resourcethrottle_term( rman->gstate.throttle ); }
       if ( rman->gstate.rlog ) { resourcelog_abort( &(rman->gstate.rlog) ); }
       if ( rman->gstate.rinput ) { resourceinput_abort( &(rman->gstate.rinput) ); }
       if ( rman->gstate.pos.ns ) { config_abandonposition( &(rman->gstate.pos) ); }
@@ -386,8 +485,11 @@ int output_program_args( rmanstate* rman ) {
       fprintf( stderr, "ERROR: Failed to output REBUILD threshold to summary log\n" );
       return -1;
    }
-   if ( rman->gstate.lbrebuild ) {
-      // TODO
+   if ( rman->gstate.lbrebuild  &&
+        fprintf( rman->summarylog, "LOCATION=%d,%d,%d\n", rman->gstate.rebuildloc.pod,
+                 rman->gstate.rebuildloc.cap, rman->gstate.rebuildloc.scatter ) < 1 ) {
+      fprintf( stderr, "ERROR: Failed to output rebuild location to summary log\n" );
+      return -1;
    }
    if ( fprintf( rman->summarylog, "\n" ) < 1 ) {
       fprintf( stderr, "ERROR: Failed to output header separator summary log\n" );
@@ -420,6 +522,15 @@ int parse_program_args( rmanstate* rman, FILE* inputsummary ) {
       else if ( strncmp( readline, "DRY-RUN", linelen ) == 0 ) {
          rman->gstate.dryrun = 1;
       }
+      else if ( strncmp( readline, "LOCATION=", 9 ) == 0 ) {
+         if ( sscanf( readline + 9, "%d,%d,%d", &(rman->gstate.rebuildloc.pod),
+                      &(rman->gstate.rebuildloc.cap), &(rman->gstate.rebuildloc.scatter) ) != 3 ) {
+            fprintf( stderr, "ERROR: Failed to parse previous run's rebuild location: \"%s\"\n", readline );
+            free( readline );
+            return -1;
+         }
+         rman->gstate.lbrebuild = 1;
+      }
       else {
          // look for an '=' char
          char* parse = readline;
@@ -536,6 +647,21 @@ int setranktgt( rmanstate* rman, marfs_ns* ns, workresponse* response ) {
       return -1;
    }
    free( outlogpath );
+   // update our checkpoint dir
+   if ( rman->gstate.ckptdir ) { free( rman->gstate.ckptdir ); rman->gstate.ckptdir = NULL; }
+   if ( rman->ckptroot ) {
+      rman->gstate.ckptdir = resourcelog_genlogpath( 1, rman->ckptroot, CHECKPOINT_PARENT, ns, -1 );
+      if ( rman->gstate.ckptdir == NULL  ||
+           ( mkdir( rman->gstate.ckptdir, 0700 )  &&  errno != EEXIST ) ) {
+         LOG( LOG_ERR, "Failed to create checkpoint dir for NS \"%s\"\n", ns->idstr );
+         snprintf( response->errorstr, MAX_ERROR_BUFFER, "Failed to create checkpoint dir for NS \"%s\"\n", ns->idstr );
+         resourcelog_term( &(rman->gstate.rlog), NULL, 1 );
+         resourceinput_purge( &(rman->gstate.rinput), rman->gstate.numprodthreads );
+         resourceinput_term( &(rman->gstate.rinput) );
+         config_abandonposition( &(rman->gstate.pos) );
+         return -1;
+      }
+   }
    // update our repack streamer
    if ( (rman->gstate.rpst = repackstreamer_init()) == NULL ) {
       LOG( LOG_ERR, "Failed to initialize repack streamer\n" );
@@ -546,6 +672,9 @@ int setranktgt( rmanstate* rman, marfs_ns* ns, workresponse* response ) {
       config_abandonposition( &(rman->gstate.pos) );
       return -1;
    }
+   // deletion latency may differ between repos, so GC batching starts fresh for each NS
+   rman->gstate.delobjns = 0;
+   rman->gstate.delobjpkgs = 0;
    // kick off our worker threads
    TQ_Init_Opts tqopts = {
       .log_prefix = "RManWorker",
@@ -1182,15 +1311,12 @@ int handlerequest( rmanstate* rman, workrequest* request, workresponse* response
  * @param rmanstate* rman : Rank state
  * @param size_t ranknum : Responding rank number
  * @param workresponse* response : Response to process
- * @param workrequest* request : New request to populate
- * @return int : A positive value if a new request has been populated;
- *               0 if no request should be sent ( rank has exited, or hit a fatal error );
- *               -1 if a fatal error has occurred in this function itself ( invalid processing )
+ * @return int : Zero on success, or -1 if a fatal error has occurred in this function itself ( invalid processing )
  */
-int handleresponse( rmanstate* rman, size_t ranknum, workresponse* response, workrequest* request ) {
+int handleresponse( rmanstate* rman, size_t ranknum, workresponse* response ) {
    // check for a fatal error condition, as this overrides all other behaviors
    if ( response->fatalerror ) {
-      // note a fatalerror, and don't generate a request
+      // note a fatalerror, and don't generate any further requests
       fprintf( stderr, "ERROR: Rank %zu%s hit a fatal error condition\n"
                        "       All ranks will now attempt to terminate\n"
                        "       Work Type --\n"
@@ -1208,16 +1334,6 @@ int handleresponse( rmanstate* rman, size_t ranknum, workresponse* response, wor
       rman->terminatedworkers[ranknum] = 1;
       return 0;
    }
-   if ( rman->fatalerror  &&  (response->request.type != ABORT_WORK) ) {
-      // if we are in an error state, all ranks should be signaled to abort
-      LOG( LOG_INFO, "Signaling Rank %zu to Abort\n", ranknum );
-      request->type = ABORT_WORK;
-      request->nsindex = 0;
-      request->refdist = 0;
-      request->iteration[0] = '\0';
-      request->ranknum = 0;
-      return 1;
-   }
    // handle the response based on type
    if ( response->request.type == TERMINATE_WORK  ||  response->request.type == ABORT_WORK ) {
       // these simply indicate that the rank has terminated
@@ -1352,6 +1468,49 @@ int handleresponse( rmanstate* rman, size_t ranknum, workresponse* response, wor
          }
          free( outlogpath );
       } // end of response content processing
+      return 0;
+   }
+   else if ( response->request.type == NS_WORK  ||  response->request.type == RLOG_WORK ) {
+      // nothing to process, until the rank completes its work on the NS
+      return 0;
+   }
+
+   LOG( LOG_ERR, "Encountered unrecognized response type\n" );
+   fprintf( stderr, "ERROR: Encountered response to an unknown request type\n" );
+   rman->fatalerror = 1;
+   return -1;
+}
+
+/**
+ * Generate the next request for the given rank, following on from the previous request it was sent
+ * NOTE -- As ranks hold a prefetched request while processing their current one, this will
+ *         typically be called prior to receiving a response to the previous request.
+ * @param rmanstate* rman : Rank state
+ * @param size_t ranknum : Target rank number
+ * @param workrequest* prevrequest : Previous request sent to the rank
+ * @param workrequest* request : New request to populate
+ * @return int : A positive value if a new request has been populated;
+ *               0 if no request should be sent ( rank has exited, or will exit after the previous request );
+ *               -1 if a fatal error has occurred in this function itself ( invalid processing )
+ */
+int generaterequest( rmanstate* rman, size_t ranknum, workrequest* prevrequest, workrequest* request ) {
+   // ranks which have exited, or which are about to, require no further requests
+   if ( rman->terminatedworkers[ranknum]  ||
+        prevrequest->type == TERMINATE_WORK  ||  prevrequest->type == ABORT_WORK ) {
+      return 0;
+   }
+   if ( rman->fatalerror ) {
+      // if we are in an error state, all ranks should be signaled to abort
+      LOG( LOG_INFO, "Signaling Rank %zu to Abort\n", ranknum );
+      request->type = ABORT_WORK;
+      request->nsindex = 0;
+      request->refdist = 0;
+      request->iteration[0] = '\0';
+      request->ranknum = 0;
+      return 1;
+   }
+   // generate the request based on the previous type
+   if ( prevrequest->type == COMPLETE_WORK ) {
       // this rank needs work to process, with no preference for NS
       if ( rman->oldlogs ) {
          // start by checking for old resource logs to process
@@ -1458,14 +1617,14 @@ int handleresponse( rmanstate* rman, size_t ranknum, workresponse* response, wor
       request->type = TERMINATE_WORK;
       return 1;
    }
-   else if ( response->request.type == NS_WORK  ||  response->request.type == RLOG_WORK ) {
+   else if ( prevrequest->type == NS_WORK  ||  prevrequest->type == RLOG_WORK ) {
       // this rank needs work to process, specifically in the same NS
       if ( rman->oldlogs ) {
          // start by checking for old resource logs to process
          HASH_NODE* resnode = NULL;
-         if ( hash_lookup( rman->oldlogs, rman->nslist[response->request.nsindex]->idstr, &(resnode) ) ) {
+         if ( hash_lookup( rman->oldlogs, rman->nslist[prevrequest->nsindex]->idstr, &(resnode) ) ) {
             fprintf( stderr, "ERROR: Failure of hash_lookup() when looking for logfiles in NS \"%s\" for rank %zu\n",
-                             rman->nslist[response->request.nsindex]->idstr, ranknum );
+                             rman->nslist[prevrequest->nsindex]->idstr, ranknum );
             rman->fatalerror = 1;
             return -1;
          }
@@ -1486,33 +1645,33 @@ int handleresponse( rmanstate* rman, size_t ranknum, workresponse* response, wor
       if ( rman->execprevroot ) {
          // if we are picking up a previous run, this means no more work remains for the active NS at all
          LOG( LOG_INFO, "Signaling Rank %zu to complete and quiesce, as no resource logs remain in NS \"%s\"\n",
-              ranknum, rman->nslist[response->request.nsindex]->idstr );
-         *request = response->request; // populate request with active NS values
+              ranknum, rman->nslist[prevrequest->nsindex]->idstr );
+         *request = *(prevrequest); // populate request with active NS values
          request->type = COMPLETE_WORK;
          return 1;
       }
       // check for any remaining work in the rank's active NS
-      if ( rman->distributed[response->request.nsindex] < rman->workingranks ) {
+      if ( rman->distributed[prevrequest->nsindex] < rman->workingranks ) {
          request->type = NS_WORK;
-         request->nsindex = response->request.nsindex;
-         request->refdist = rman->distributed[response->request.nsindex];
+         request->nsindex = prevrequest->nsindex;
+         request->refdist = rman->distributed[prevrequest->nsindex];
          request->iteration[0] = '\0';
          request->ranknum = ranknum;
-         rman->distributed[response->request.nsindex]++; // note newly distributed range
+         rman->distributed[prevrequest->nsindex]++; // note newly distributed range
          LOG( LOG_INFO, "Passing out reference range %zu of NS \"%s\" to Rank %zu\n",
-              rman->distributed[response->request.nsindex], rman->nslist[response->request.nsindex]->idstr, ranknum );
+              rman->distributed[prevrequest->nsindex], rman->nslist[prevrequest->nsindex]->idstr, ranknum );
          return 1;
       }
       // all work in the active NS has been completed
       LOG( LOG_INFO, "Signaling Rank %zu to complete and quiesce, as no reference ranges remain in NS \"%s\"\n",
-           ranknum, rman->nslist[response->request.nsindex]->idstr );
-      *request = response->request; // populate request with active NS values
+           ranknum, rman->nslist[prevrequest->nsindex]->idstr );
+      *request = *(prevrequest); // populate request with active NS values
       request->type = COMPLETE_WORK;
       return 1;
    }
 
-   LOG( LOG_ERR, "Encountered unrecognized response type\n" );
-   fprintf( stderr, "ERROR: Encountered response to an unknown request type\n" );
+   LOG( LOG_ERR, "Encountered unrecognized previous request type\n" );
+   fprintf( stderr, "ERROR: Encountered an unknown type of previous request\n" );
    rman->fatalerror = 1;
    return -1;
 }
@@ -1521,67 +1680,195 @@ int handleresponse( rmanstate* rman, size_t ranknum, workresponse* response, wor
 //   -------------   CORE BEHAVIOR LOOPS   -------------
 
 /**
- * Manager rank behavior ( sending out requests, potentially processing them as well )
+ * Fill the request window of the given worker rank, sending out as many new requests as are appropriate
  * @param rmanstate* rman : Resource manager state
+ * @param rankpipeline* pipe : Pipeline state of the target rank
+ * @param size_t ranknum : Target rank number
  * @return int : Zero on success, or -1 on failure
  */
-int managerbehavior( rmanstate* rman ) {
-   // setup out response and request structs
-   workresponse response;
-   bzero( &(response), sizeof( struct workresponse_struct ) );
-   size_t respondingrank = 0;
-   workrequest  request;
-   bzero( &(request), sizeof( struct workrequest_struct ) );
-   if ( rman->totalranks == 1 ) {
-      // we need to fake our own 'startup' response
-      response.request.type = COMPLETE_WORK;
-      response.request.nsindex = rman->nscount;
+int fillpipeline( rmanstate* rman, rankpipeline* pipe, size_t ranknum ) {
+   while ( pipe->inflight < RANK_PIPELINE_DEPTH ) {
+      // make sure our previous use of this request buffer has completed
+      size_t slot = pipe->sendcount % RANK_PIPELINE_DEPTH;
+      if ( MPI_Wait( pipe->sendreqs + slot, MPI_STATUS_IGNORE ) ) {
+         LOG( LOG_ERR, "Failed to wait on a previous request to rank %zu\n", ranknum );
+         fprintf( stderr, "ERROR: Failed to complete an MPI request message\n" );
+         return -1;
+      }
+      // generate the next request, based on the last one sent
+      workrequest* request = pipe->requests + slot;
+      int genres = generaterequest( rman, ranknum, &(pipe->lastsent), request );
+      if ( genres < 0 ) {
+         fprintf( stderr, "Fatal error detected during request generation.  Program will terminate.\n" );
+         return -1;
+      }
+      if ( genres == 0 ) { break; } // no further requests for this rank
+      // send out the request via MPI to the rank
+      if ( MPI_Isend( request, sizeof(struct workrequest_struct), MPI_BYTE, ranknum, 0, MPI_COMM_WORLD, pipe->sendreqs + slot ) ) {
+         LOG( LOG_ERR, "Failed to send a request\n" );
+         fprintf( stderr, "ERROR: Failed to send an MPI request message\n" );
+         return -1;
+      }
+      pipe->lastsent = *(request);
+      pipe->sendcount++;
+      pipe->inflight++;
+   }
+   return 0;
+}
+
+/**
+ * Distribute all work to worker ranks, pipelining requests such that each worker always has its next
+ *  request on hand when it completes its current one
+ * NOTE -- Because requests are generated prior to receiving a response to the previous request,
+ *         the response of each rank to a COMPLETE_WORK request is processed only after that rank
+ *         may have begun on its next request.  This is safe, as a rank which has completed a NS
+ *         is never handed further work within that same NS.
+ * @param rmanstate* rman : Resource manager state
+ * @return int : Zero on success, or -1 on failure
+ */
+int distributework( rmanstate* rman ) {
+   // allocate pipeline state for all ranks
+   rankpipeline* pipes = calloc( rman->totalranks, sizeof( struct rankpipeline_struct ) );
+   MPI_Request* recvreqs = calloc( rman->totalranks, sizeof( MPI_Request ) );
+   int* readyranks = calloc( rman->totalranks, sizeof( int ) );
+   if ( pipes == NULL  ||  recvreqs == NULL  ||  readyranks == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate pipeline state for %zu ranks\n", rman->totalranks );
+      fprintf( stderr, "ERROR: Failed to allocate pipeline state for %zu ranks\n", rman->totalranks );
+      if ( pipes ) { free( pipes ); }
+      if ( recvreqs ) { free( recvreqs ); }
+      if ( readyranks ) { free( readyranks ); }
+      return -1;
+   }
+   // post a receive for the initial 'dummy' response of every worker
+   int retval = 0;
+   size_t ranknum = 0;
+   for ( ; ranknum < rman->totalranks; ranknum++ ) {
+      size_t slot = 0;
+      for ( ; slot < RANK_PIPELINE_DEPTH; slot++ ) { pipes[ranknum].sendreqs[slot] = MPI_REQUEST_NULL; }
+      // treat each rank as having been sent a 'startup' completion request
+      pipes[ranknum].lastsent.type = COMPLETE_WORK;
+      pipes[ranknum].lastsent.nsindex = rman->nscount;
+      recvreqs[ranknum] = MPI_REQUEST_NULL;
+      if ( ranknum == rman->ranknum ) { continue; } // we don't process work ourself
+      if ( MPI_Irecv( &(pipes[ranknum].response), sizeof( struct workresponse_struct ), MPI_BYTE, ranknum, MPI_ANY_TAG,
+                      MPI_COMM_WORLD, recvreqs + ranknum ) ) {
+         LOG( LOG_ERR, "Failed to post a receive for rank %zu\n", ranknum );
+         fprintf( stderr, "ERROR: Failed to receive an MPI response message\n" );
+         retval = -1;
+         break;
+      }
    }
    // loop until all workers have terminated
-   char workersrunning = 1;
+   char workersrunning = ( retval ) ? 0 : 1;
    while ( workersrunning ) {
-      // begin by getting a response from a worker via MPI
-      if ( rman->totalranks > 1 ) {
-         MPI_Status msgstatus;
-         if ( MPI_Recv( &(response), sizeof( struct workresponse_struct), MPI_BYTE, MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &(msgstatus) ) ) {
-            LOG( LOG_ERR, "Failed to recieve a response\n" );
-            fprintf( stderr, "ERROR: Failed to receive an MPI response message\n" );
-            return -1;
-         }
-         respondingrank = msgstatus.MPI_SOURCE;
+      // wait for responses from any number of workers
+      int readycount = 0;
+      if ( MPI_Waitsome( (int)rman->totalranks, recvreqs, &(readycount), readyranks, MPI_STATUSES_IGNORE ) ) {
+         LOG( LOG_ERR, "Failed to recieve a response\n" );
+         fprintf( stderr, "ERROR: Failed to receive an MPI response message\n" );
+         retval = -1;
+         break;
       }
-      // generate an appropriate request, based on response
-      int handleres = handleresponse( rman, respondingrank, &(response), &(request) );
-      if ( handleres < 0 ) {
-         fprintf( stderr, "Fatal error detected during response handling.  Program will terminate.\n" );
-         return -1;
+      if ( readycount == MPI_UNDEFINED ) {
+         LOG( LOG_ERR, "No active receives remain, despite running workers\n" );
+         fprintf( stderr, "ERROR: Lost track of running worker ranks\n" );
+         retval = -1;
+         break;
       }
-      // send out a new request, if appropriate
-      if ( handleres ) {
-         if ( rman->totalranks > 1 ) {
-            // send out the request via MPI to the responding rank
-            if ( MPI_Send( &(request), sizeof(struct workrequest_struct), MPI_BYTE, respondingrank, 0, MPI_COMM_WORLD ) ) {
-               LOG( LOG_ERR, "Failed to send a request\n" );
-               fprintf( stderr, "ERROR: Failed to send an MPI request message\n" );
-               return -1;
-            }
+      int readyindex = 0;
+      for ( ; readyindex < readycount; readyindex++ ) {
+         ranknum = (size_t)readyranks[readyindex];
+         rankpipeline* pipe = pipes + ranknum;
+         // note receipt of a response to one of our requests ( excluding the 'dummy' startup response )
+         if ( pipe->started ) { pipe->inflight--; }
+         pipe->started = 1;
+         // process the response content
+         if ( handleresponse( rman, ranknum, &(pipe->response) ) < 0 ) {
+            fprintf( stderr, "Fatal error detected during response handling.  Program will terminate.\n" );
+            retval = -1;
+            break;
          }
-         else {
-            // just process the new request ourself
-            if ( handlerequest( rman, &(request), &(response) ) < 0 ) {
-               fprintf( stderr, "ERROR: %s\nFatal error detected during local request processing.  Program will terminate.\n",
-                        response.errorstr );
-               return -1;
-            }
+         // top off the request window of this rank
+         if ( fillpipeline( rman, pipe, ranknum ) ) {
+            retval = -1;
+            break;
+         }
+         // wait for the next response, if the rank is still running
+         if ( rman->terminatedworkers[ranknum] == 0  &&
+              MPI_Irecv( &(pipe->response), sizeof( struct workresponse_struct ), MPI_BYTE, ranknum, MPI_ANY_TAG,
+                         MPI_COMM_WORLD, recvreqs + ranknum ) ) {
+            LOG( LOG_ERR, "Failed to post a receive for rank %zu\n", ranknum );
+            fprintf( stderr, "ERROR: Failed to receive an MPI response message\n" );
+            retval = -1;
+            break;
          }
       }
+      if ( retval ) { break; }
       // check worker states
       workersrunning = 0; // assume none, until found
-      size_t windex = ( rman->totalranks > 1 ) ? 1 : 0;
+      size_t windex = 1;
       for ( ; windex < rman->totalranks; windex++ ) {
          if ( rman->terminatedworkers[windex] == 0 ) { workersrunning = 1; break; }
       }
    }
+   // on success, all outstanding requests must have been received by now
+   if ( retval == 0 ) {
+      for ( ranknum = 0; ranknum < rman->totalranks; ranknum++ ) {
+         if ( MPI_Waitall( RANK_PIPELINE_DEPTH, pipes[ranknum].sendreqs, MPI_STATUSES_IGNORE ) ) {
+            LOG( LOG_ERR, "Failed to complete outstanding requests to rank %zu\n", ranknum );
+            fprintf( stderr, "ERROR: Failed to complete an MPI request message\n" );
+            retval = -1;
+            break;
+         }
+      }
+   }
+   // NOTE -- on failure, any outstanding messages are simply abandoned, as the program will abort
+   free( readyranks );
+   free( recvreqs );
+   if ( retval == 0 ) { free( pipes ); }
+   return retval;
+}
+
+/**
+ * Manager rank behavior ( sending out requests, potentially processing them as well )
+ * @param rmanstate* rman : Resource manager state
+ * @return int : Zero on success, or -1 on failure
+ */
+int managerbehavior( rmanstate* rman ) {
+   if ( rman->totalranks > 1 ) {
+      // distribute all work to our worker ranks
+      if ( distributework( rman ) ) { return -1; }
+   }
+   else {
+      // setup out response and request structs
+      workresponse response;
+      bzero( &(response), sizeof( struct workresponse_struct ) );
+      workrequest  request;
+      bzero( &(request), sizeof( struct workrequest_struct ) );
+      // we need to fake our own 'startup' response
+      response.request.type = COMPLETE_WORK;
+      response.request.nsindex = rman->nscount;
+      // loop until we have terminated
+      while ( rman->terminatedworkers[0] == 0 ) {
+         // process our previous response
+         if ( handleresponse( rman, 0, &(response) ) < 0 ) {
+            fprintf( stderr, "Fatal error detected during response handling.  Program will terminate.\n" );
+            return -1;
+         }
+         // generate an appropriate request, based on the previous one
+         int genres = generaterequest( rman, 0, &(response.request), &(request) );
+         if ( genres < 0 ) {
+            fprintf( stderr, "Fatal error detected during request generation.  Program will terminate.\n" );
+            return -1;
+         }
+         // just process the new request ourself
+         if ( genres  &&  handlerequest( rman, &(request), &(response) ) < 0 ) {
+            fprintf( stderr, "ERROR: %s\nFatal error detected during local request processing.  Program will terminate.\n",
+                     response.errorstr );
+            return -1;
+         }
+      }
+   }
    printf( "\n" );
    // loop over all namespaces
    size_t nsindex = 0;
@@ -1724,41 +2011,81 @@ int managerbehavior( rmanstate* rman ) {
  */
 int workerbehavior( rmanstate* rman ) {
    // setup out response and request structs
-   workresponse response;
-   bzero( &(response), sizeof( struct workresponse_struct ) );
-   workrequest  request;
-   bzero( &(request), sizeof( struct workrequest_struct ) );
+   // NOTE -- we alternate between two of each, so that one may be in flight while the other is in use
+   workresponse responses[2];
+   bzero( responses, sizeof( struct workresponse_struct ) * 2 );
+   workrequest  requests[2];
+   bzero( requests, sizeof( struct workrequest_struct ) * 2 );
+   MPI_Request sendreq = MPI_REQUEST_NULL;
+   MPI_Request recvreq = MPI_REQUEST_NULL;
    // we need to fake a 'startup' response
-   response.request.type = COMPLETE_WORK;
-   response.request.nsindex = rman->nscount;
-   // begin by sending a response
-   if ( MPI_Send( &(response), sizeof(struct workresponse_struct), MPI_BYTE, 0, 0, MPI_COMM_WORLD ) ) {
+   responses[1].request.type = COMPLETE_WORK;
+   responses[1].request.nsindex = rman->nscount;
+   // begin by sending a response, and waiting for our first request
+   if ( MPI_Isend( responses + 1, sizeof(struct workresponse_struct), MPI_BYTE, 0, 0, MPI_COMM_WORLD, &(sendreq) ) ) {
       LOG( LOG_ERR, "Failed to send initial 'dummy' response\n" );
       fprintf( stderr, "ERROR: Failed to send an initial MPI response message\n" );
       return -1;
    }
+   if ( MPI_Irecv( requests, sizeof( struct workrequest_struct), MPI_BYTE, 0, MPI_ANY_TAG, MPI_COMM_WORLD, &(recvreq) ) ) {
+      LOG( LOG_ERR, "Failed to post a receive for our initial request\n" );
+      fprintf( stderr, "ERROR: Failed to receive an MPI request message\n" );
+      MPI_Wait( &(sendreq), MPI_STATUS_IGNORE );
+      return -1;
+   }
    // loop until we process a TERMINATE request
    int handleres = 1;
+   size_t curslot = 0;
    while ( handleres ) {
-      // wait for a new request
-      if ( MPI_Recv( &(request), sizeof( struct workrequest_struct), MPI_BYTE, 0, MPI_ANY_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE ) ) {
+      // wait for our current request
+      if ( MPI_Wait( &(recvreq), MPI_STATUS_IGNORE ) ) {
          LOG( LOG_ERR, "Failed to recieve a new request\n" );
          fprintf( stderr, "ERROR: Failed to receive an MPI request message\n" );
+         MPI_Wait( &(sendreq), MPI_STATUS_IGNORE );
+         return -1;
+      }
+      workrequest* request = requests + curslot;
+      workresponse* response = responses + curslot;
+      // the manager will always follow up a non-terminal request, so prefetch that next request now
+      char finalreq = ( request->type == TERMINATE_WORK  ||  request->type == ABORT_WORK ) ? 1 : 0;
+      if ( !(finalreq)  &&
+           MPI_Irecv( requests + (curslot ^ 1), sizeof( struct workrequest_struct), MPI_BYTE, 0, MPI_ANY_TAG,
+                      MPI_COMM_WORLD, &(recvreq) ) ) {
+         LOG( LOG_ERR, "Failed to post a receive for our next request\n" );
+         fprintf( stderr, "ERROR: Failed to receive an MPI request message\n" );
+         MPI_Wait( &(sendreq), MPI_STATUS_IGNORE );
          return -1;
       }
       // generate an appropriate response
-      if ( (handleres = handlerequest( rman, &(request), &(response) )) < 0 ) {
-         LOG( LOG_ERR, "Fatal error detected during request processing: \"%s\"\n", response.errorstr );
+      handleres = handlerequest( rman, request, response );
+      // our previous response must be complete before we send out another
+      if ( MPI_Wait( &(sendreq), MPI_STATUS_IGNORE ) ) {
+         LOG( LOG_ERR, "Failed to complete a previous response\n" );
+         fprintf( stderr, "ERROR: Failed to send an MPI response message\n" );
+         return -1;
+      }
+      if ( handleres < 0 ) {
+         LOG( LOG_ERR, "Fatal error detected during request processing: \"%s\"\n", response->errorstr );
          // send out our response anyway, so the manger prints our error message
-         MPI_Send( &(response), sizeof(struct workresponse_struct), MPI_BYTE, 0, 0, MPI_COMM_WORLD );
+         MPI_Send( response, sizeof(struct workresponse_struct), MPI_BYTE, 0, 0, MPI_COMM_WORLD );
+         // consume our prefetched request, so that the manager's send can complete
+         if ( !(finalreq) ) { MPI_Wait( &(recvreq), MPI_STATUS_IGNORE ); }
          return -1;
       }
       // send out our response
-      if ( MPI_Send( &(response), sizeof(struct workresponse_struct), MPI_BYTE, 0, 0, MPI_COMM_WORLD ) ) {
+      if ( MPI_Isend( response, sizeof(struct workresponse_struct), MPI_BYTE, 0, 0, MPI_COMM_WORLD, &(sendreq) ) ) {
          LOG( LOG_ERR, "Failed to send a response\n" );
          fprintf( stderr, "ERROR: Failed to send an MPI response message\n" );
+         if ( !(finalreq) ) { MPI_Wait( &(recvreq), MPI_STATUS_IGNORE ); }
          return -1;
       }
+      curslot ^= 1;
+   }
+   // wait for our final response to complete
+   if ( MPI_Wait( &(sendreq), MPI_STATUS_IGNORE ) ) {
+      LOG( LOG_ERR, "Failed to complete our final response\n" );
+      fprintf( stderr, "ERROR: Failed to send an MPI response message\n" );
+      return -1;
    }
    // all work should now be complete
    return 0;
@@ -1795,11 +2122,12 @@ int main(int argc, char** argv) {
    time_t rbmthresh = currenttime.tv_sec - RB_M_THRESH;
    time_t rpthresh = currenttime.tv_sec - RP_THRESH;
    time_t clthresh = currenttime.tv_sec - CL_THRESH;
+   char incremental = 0;
 
    // parse all position-independent arguments
    char pr_usage = 0;
    int c;
-   while ((c = getopt(argc, (char* const*)argv, "c:n:ri:l:p:dX:QGRPCT:L:h")) != -1) {
+   while ((c = getopt(argc, (char* const*)argv, "c:n:ri:l:p:dX:QGRPCT:L:I:B:O:W:h")) != -1) {
       switch (c) {
       case 'c':
          config_path = optarg;
@@ -1907,6 +2235,95 @@ int main(int argc, char** argv) {
          }
          break;
          }
+      case 'L':
+         {
+         // omitted location values will match any value
+         rman.gstate.rebuildloc.pod = -1;
+         rman.gstate.rebuildloc.cap = -1;
+         rman.gstate.rebuildloc.scatter = -1;
+         char* locparse = optarg;
+         char foundlval = 0;
+         while ( *locparse != '\0' ) {
+            if ( *locparse == '-' ) { locparse++; continue; } // ignore '-' chars
+            // parse the expected numeric value trailing the location flag
+            char lflag = *locparse;
+            char* endptr = NULL;
+            long parseval = strtol( locparse + 1, &(endptr), 10 );
+            if ( ( lflag != 'p'  &&  lflag != 'c'  &&  lflag != 's' )  ||
+                 endptr == NULL  ||  endptr == locparse + 1  ||  parseval < 0  ||  parseval > INT_MAX  ||
+                 ( *endptr != '-'  &&  *endptr != '\0' ) ) {
+               printf( "ERROR: Failed to parse '-L' argument value: \"%s\"\n", optarg );
+               pr_usage = 1;
+               break;
+            }
+            if ( lflag == 'p' ) { rman.gstate.rebuildloc.pod = (int)parseval; }
+            else if ( lflag == 'c' ) { rman.gstate.rebuildloc.cap = (int)parseval; }
+            else { rman.gstate.rebuildloc.scatter = (int)parseval; }
+            foundlval = 1;
+            locparse = endptr;
+         }
+         if ( pr_usage == 0  &&  foundlval == 0 ) {
+            printf( "ERROR: Failed to parse '-L' argument value: \"%s\"\n", optarg );
+            pr_usage = 1;
+         }
+         rman.gstate.lbrebuild = 1;
+         rman.gstate.thresh.rebuildthreshold = 1;
+         break;
+         }
+      case 'I':
+         {
+         char* endptr = NULL;
+         unsigned long long parseval = strtoull( optarg, &(endptr), 10 );
+         if ( parseval == ULLONG_MAX  ||  endptr == NULL  ||  endptr == optarg  ||
+              ( *endptr != 's'  &&  *endptr != 'm'  &&  *endptr != 'h'  &&  *endptr != 'd'  &&  *endptr != '\0' )  ||
+              ( *endptr != '\0'  &&  *(endptr + 1) != '\0' ) ) {
+            printf( "ERROR: Failed to parse '-I' argument value: \"%s\"\n", optarg );
+            pr_usage = 1;
+            break;
+         }
+         if ( *endptr == 'm' ) { parseval *= 60; }
+         else if ( *endptr == 'h' ) { parseval *= 60 * 60; }
+         else if ( *endptr == 'd' ) { parseval *= 60 * 60 * 24; }
+         rman.gstate.ckptthresh = currenttime.tv_sec - parseval;
+         incremental = 1;
+         break;
+         }
+      case 'B':
+         {
+         char* endptr = NULL;
+         unsigned long long parseval = strtoull( optarg, &(endptr), 10 );
+         if ( parseval == 0  ||  parseval == ULLONG_MAX  ||  endptr == NULL  ||  endptr == optarg  ||
+              ( *endptr != 'K'  &&  *endptr != 'M'  &&  *endptr != 'G'  &&  *endptr != 'T'  &&  *endptr != '\0' )  ||
+              ( *endptr != '\0'  &&  *(endptr + 1) != '\0' ) ) {
+            printf( "ERROR: Failed to parse '-B' argument value: \"%s\"\n", optarg );
+            pr_usage = 1;
+            break;
+         }
+         unsigned long long unitmult = 1;
+         if ( *endptr == 'K' ) { unitmult = 1024ULL; }
+         else if ( *endptr == 'M' ) { unitmult = 1024ULL * 1024; }
+         else if ( *endptr == 'G' ) { unitmult = 1024ULL * 1024 * 1024; }
+         else if ( *endptr == 'T' ) { unitmult = 1024ULL * 1024 * 1024 * 1024; }
+         if ( parseval > SIZE_MAX / unitmult ) {
+            printf( "ERROR: '-B' argument value is too large: \"%s\"\n", optarg );
+            pr_usage = 1;
+            break;
+         }
+         rman.rpckbudget = (size_t)( parseval * unitmult );
+         break;
+         }
+      case 'O':
+         if ( parse_ratelimits( optarg, rman.limits.oprate, 0 ) ) {
+            printf( "ERROR: Failed to parse '-O' argument value: \"%s\"\n", optarg );
+            pr_usage = 1;
+         }
+         break;
+      case 'W':
+         if ( parse_ratelimits( optarg, rman.limits.byterate, 1 ) ) {
+            printf( "ERROR: Failed to parse '-W' argument value: \"%s\"\n", optarg );
+            pr_usage = 1;
+         }
+         break;
       case '?':
          printf( "ERROR: Unrecognized cmdline argument: \'%c\'\n", optopt );
       case 'h': // note fallthrough from above
@@ -1923,12 +2340,20 @@ int main(int argc, char** argv) {
    }
 
    // validate arguments
+   if ( incremental  &&  rman.gstate.dryrun ) {
+      fprintf( stderr, "ERROR: The '-I' arg is incompatible with '-d'\n" );
+      return -1;
+   }
+   if ( rman.rpckbudget  &&  rman.gstate.thresh.repackthreshold == 0 ) {
+      fprintf( stderr, "ERROR: The '-B' arg requires '-P'\n" );
+      return -1;
+   }
    if ( rman.execprevroot ) {
       // check if we were incorrectly passed any args
       if ( rman.gstate.thresh.gcthreshold  ||  rman.gstate.thresh.rebuildthreshold  ||
            rman.gstate.thresh.repackthreshold  ||  rman.gstate.thresh.cleanupthreshold  ||
-           rman.iteration[0] != '\0' ) {
-         fprintf( stderr, "ERROR: The '-G', '-R', '-P', and '-i' args are incompatible with '-X'\n" );
+           rman.iteration[0] != '\0'  ||  incremental ) {
+         fprintf( stderr, "ERROR: The '-G', '-R', '-P', '-L', '-i', and '-I' args are incompatible with '-X'\n" );
          return -1;
       }
       // parse over the specified path, looking for RECORD_ITERATION_PARENT
@@ -2014,6 +2439,15 @@ int main(int argc, char** argv) {
       free( newroot );
       return -1;
    }
+   if ( incremental ) {
+      // checkpoints persist across iterations, beneath the base logging root
+      rman.ckptroot = strdup( (rman.logroot) ? rman.logroot : DEFAULT_LOG_ROOT );
+      if ( rman.ckptroot == NULL ) {
+         fprintf( stderr, "ERROR: Failed to duplicate checkpoint root path\n" );
+         free( newroot );
+         return -1;
+      }
+   }
    rman.logroot = newroot;
    if ( rman.preservelogtgt ) {
       char* newpresroot;
@@ -2363,6 +2797,38 @@ int main(int argc, char** argv) {
               rman.nscount, (recurse) ? "Recursing Below " : "", (rman.nslist[0])->idstr );
    }
 
+   // establish our repack policy, which persists across all NS passes of this rank
+   if ( rman.gstate.thresh.repackthreshold ) {
+      // divide the budget of the run between all working ranks, rounding up so as to never drop to 'unlimited'
+      size_t rankbudget = rman.rpckbudget / rman.workingranks;
+      if ( rman.rpckbudget % rman.workingranks ) { rankbudget++; }
+      if ( (rman.gstate.rpolicy = repackpolicy_init( rankbudget )) == NULL ) {
+         fprintf( stderr, "ERROR: Failed to initialize repack policy\n" );
+         cleanupstate( &(rman), 1 );
+         return -1;
+      }
+   }
+
+   // establish our throttle, which persists across all NS passes of this rank
+   char throttled = 0;
+   int optype = 0;
+   for ( ; optype < THROTTLE_OPTYPES; optype++ ) {
+      // divide the limits of the run between all working ranks, rounding up so as to never drop to 'unlimited'
+      if ( rman.limits.oprate[optype] ) {
+         rman.limits.oprate[optype] = ( rman.limits.oprate[optype] + rman.workingranks - 1 ) / rman.workingranks;
+         throttled = 1;
+      }
+      if ( rman.limits.byterate[optype] ) {
+         rman.limits.byterate[optype] = ( rman.limits.byterate[optype] + rman.workingranks - 1 ) / rman.workingranks;
+         throttled = 1;
+      }
+   }
+   if ( throttled  &&  (rman.gstate.throttle = resourcethrottle_init( &(rman.limits) )) == NULL ) {
+      fprintf( stderr, "ERROR: Failed to initialize resource throttle\n" );
+      cleanupstate( &(rman), 1 );
+      return -1;
+   }
+
    // actually perform core behavior loops
    int bres;
    if ( rman.ranknum == 0 ) {
@@ -73,6 +73,7 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 
 #include <dirent.h>
 #include <string.h>
+#include <time.h>
 
 
 //   -------------   INTERNAL DEFINITIONS    -------------
@@ -91,6 +92,46 @@ typedef struct repackstreamer_struct {
    char* streamstatus;
 }* REPACKSTREAMER;
 
+typedef struct repackcandidate_struct {
+   opinfo* ops;       // repack operations of the datastream
+   size_t  livebytes; // live bytes to be rewritten by the ops ( charged against the budget )
+   double  score;     // objects reclaimed, per object of live data rewritten
+} repackcandidate;
+
+typedef struct repackpolicy_struct {
+   // synchronization and access control
+   pthread_mutex_t lock;
+   // budget info
+   size_t budget;     // total bytes which may be scheduled ( zero, if unlimited )
+   size_t spent;      // total bytes scheduled thus far
+   // candidate info
+   repackcandidate* candlist;
+   size_t candcount;  // count of populated candidates
+   size_t candalloc;  // allocated length of the candidate list
+   size_t candindex;  // index of the next candidate to be considered for scheduling
+   char   ranked;     // flag indicating that the unconsidered candidates are sorted by score
+}* REPACKPOLICY;
+
+typedef struct throttlebucket_struct {
+   int            pod;        // storage location of the bucket
+   int            cap;
+   operation_type type;       // operation type of the bucket
+   double         optokens;   // remaining op allowance ( negative, if already committed to waiting )
+   double         bytetokens; // remaining byte allowance ( negative, if already committed to waiting )
+   struct timespec lastfill;  // time at which allowances were last replenished
+} throttlebucket;
+
+typedef struct resourcethrottle_struct {
+   // synchronization and access control
+   pthread_mutex_t lock;
+   // limit info
+   throttle_limits limits;
+   // bucket info
+   throttlebucket* bucketlist;
+   size_t bucketcount;  // count of populated buckets
+   size_t bucketalloc;  // allocated length of the bucket list
+}* RESOURCETHROTTLE;
+
 typedef struct streamwalker_struct {
    // initialization info
    marfs_position pos;
@@ -118,8 +159,17 @@ typedef struct streamwalker_struct {
    // repack info
    opinfo*     rpckops;      // repack operation list
    size_t      activebytes;  // active bytes in the current object
+   size_t      rpckobjbytes; // bytes of the current object targeted by repack ops
+   char        rpckdead;     // flag indicating that the current object holds data of inactive files
+   REPACKPOLICY rpckpolicy;  // repack policy to submit the stream candidate to ( NULL, if ops are directly produced )
+   opinfo*     rpckcands;    // repack ops of all objects retained for the stream candidate ( policy only )
+   size_t      rpcklive;     // live bytes of all retained objects
+   size_t      rpckobjs;     // count of retained objects
    // rebuild info
    opinfo*     rbldops;      // rebuild operation list
+   size_t      liveobj;      // first object not yet noted as referenced by a live file
+   char        livezero;     // flag indicating that file zero is live, but its objects have yet to be noted
+   FILE*       manifest;     // object manifest to be populated with all live objects ( NULL, if none )
 }* streamwalker;
 
 
@@ -348,10 +398,351 @@ int repackstreamer_abort( REPACKSTREAMER repackst ) {
 }
 
 
+//   -------------   REPACKPOLICY FUNCTIONS    -------------
+
+/**
+ * Initialize a new repackpolicy
+ * NOTE -- A repackpolicy accumulates the repack candidates of every datastream walked, ranks them by the benefit of
+ *         repacking each ( dead bytes and objects reclaimed, per live byte rewritten ), and then schedules the most
+ *         beneficial candidates, up to a total byte budget.  The budget is shared by all passes using the policy.
+ * @param size_t budget : Total count of live bytes which may be scheduled for repack ( zero, if unlimited )
+ * @return REPACKPOLICY : New repackpolicy, or NULL on failure
+ */
+REPACKPOLICY repackpolicy_init( size_t budget ) {
+   // allocate a new struct
+   REPACKPOLICY policy = malloc( sizeof( struct repackpolicy_struct ) );
+   if ( policy == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate new repackpolicy\n" );
+      return NULL;
+   }
+   // populate all struct elements
+   if ( pthread_mutex_init( &(policy->lock), NULL ) ) {
+      LOG( LOG_ERR, "Failed to initialize lock\n" );
+      free( policy );
+      return NULL;
+   }
+   policy->budget = budget;
+   policy->spent = 0;
+   policy->candalloc = 64;
+   policy->candlist = malloc( sizeof( repackcandidate ) * policy->candalloc );
+   if ( policy->candlist == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate candidate list\n" );
+      pthread_mutex_destroy( &(policy->lock) );
+      free( policy );
+      return NULL;
+   }
+   policy->candcount = 0;
+   policy->candindex = 0;
+   policy->ranked = 0;
+   return policy;
+}
+
+/**
+ * Submit the repack candidate of a single datastream to the given repackpolicy
+ * @param REPACKPOLICY policy : Repackpolicy to submit to
+ * @param opinfo* ops : Repack operations of the datastream
+ *                      NOTE -- the policy takes ownership of these ops, regardless of success or failure
+ * @param size_t livebytes : Count of live bytes to be rewritten by the ops
+ * @param size_t objcount : Count of objects to be freed by the ops
+ * @param size_t objcapacity : Data capacity of each object of the datastream
+ * @return int : Zero on success, or -1 on failure
+ */
+int repackpolicy_submit( REPACKPOLICY policy, opinfo* ops, size_t livebytes, size_t objcount, size_t objcapacity ) {
+   // validate args
+   if ( policy == NULL  ||  ops == NULL  ||  objcount == 0  ||  objcapacity == 0 ) {
+      LOG( LOG_ERR, "Received an invalid arg\n" );
+      if ( ops ) { resourcelog_freeopinfo( ops ); }
+      errno = EINVAL;
+      return -1;
+   }
+   // repacked data is packed densely alongside that of other streams, so the candidate frees 'objcount' objects
+   //    at the cost of writing 'livebytes / objcapacity' objects worth of new data
+   double rewrittenobjs = (double)( (livebytes) ? livebytes : 1 ) / (double)objcapacity;
+   double score = ( (double)objcount - rewrittenobjs ) / rewrittenobjs;
+   // acquire the policy lock
+   if ( pthread_mutex_lock( &(policy->lock) ) ) {
+      LOG( LOG_ERR, "Failed to acquire repackpolicy lock\n" );
+      resourcelog_freeopinfo( ops );
+      return -1;
+   }
+   // expand our candidate list, if necessary
+   if ( policy->candcount == policy->candalloc ) {
+      repackcandidate* newlist = realloc( policy->candlist, sizeof( repackcandidate ) * policy->candalloc * 2 );
+      if ( newlist == NULL ) {
+         LOG( LOG_ERR, "Failed to expand candidate list to %zu entries\n", policy->candalloc * 2 );
+         pthread_mutex_unlock( &(policy->lock) );
+         resourcelog_freeopinfo( ops );
+         return -1;
+      }
+      policy->candlist = newlist;
+      policy->candalloc *= 2;
+   }
+   LOG( LOG_INFO, "Noting repack candidate of StreamID \"%s\" ( %zu objects, %zu live bytes, score = %.3f )\n",
+        ops->ftag.streamid, objcount, livebytes, score );
+   repackcandidate* newcand = policy->candlist + policy->candcount;
+   newcand->ops = ops;
+   newcand->livebytes = livebytes;
+   newcand->score = score;
+   policy->candcount++;
+   policy->ranked = 0;
+   pthread_mutex_unlock( &(policy->lock) );
+   return 0;
+}
+
+// order repack candidates by descending score, preferring smaller candidates on a tie
+int repackpolicy_candcompare( const void* first, const void* second ) {
+   const repackcandidate* firstcand = first;
+   const repackcandidate* secondcand = second;
+   if ( firstcand->score > secondcand->score ) { return -1; }
+   if ( firstcand->score < secondcand->score ) { return 1; }
+   if ( firstcand->livebytes < secondcand->livebytes ) { return -1; }
+   if ( firstcand->livebytes > secondcand->livebytes ) { return 1; }
+   return 0;
+}
+
+/**
+ * Retrieve the most beneficial remaining repack candidate which fits within the remaining byte budget
+ * NOTE -- once no further candidate can be scheduled, all remaining candidates are discarded
+ * @param REPACKPOLICY policy : Repackpolicy to retrieve from
+ * @param opinfo** ops : Reference to be populated with the repack operations of the candidate
+ * @return int : 1, if a candidate was retrieved;
+ *               0, if no candidates remain to be scheduled;
+ *               -1, if a failure occurred
+ */
+int repackpolicy_next( REPACKPOLICY policy, opinfo** ops ) {
+   // validate args
+   if ( policy == NULL  ||  ops == NULL ) {
+      LOG( LOG_ERR, "Received an invalid arg\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // acquire the policy lock
+   if ( pthread_mutex_lock( &(policy->lock) ) ) {
+      LOG( LOG_ERR, "Failed to acquire repackpolicy lock\n" );
+      return -1;
+   }
+   // rank all unconsidered candidates
+   if ( !(policy->ranked) ) {
+      qsort( policy->candlist + policy->candindex, policy->candcount - policy->candindex,
+             sizeof( repackcandidate ), repackpolicy_candcompare );
+      policy->ranked = 1;
+   }
+   while ( policy->candindex < policy->candcount ) {
+      repackcandidate* cand = policy->candlist + policy->candindex;
+      policy->candindex++;
+      if ( policy->budget == 0  ||  cand->livebytes <= policy->budget - policy->spent ) {
+         // schedule this candidate
+         policy->spent += cand->livebytes;
+         *ops = cand->ops;
+         cand->ops = NULL;
+         pthread_mutex_unlock( &(policy->lock) );
+         return 1;
+      }
+      // our remaining budget only ever shrinks, so this candidate can never be scheduled
+      LOG( LOG_INFO, "Discarding repack candidate of StreamID \"%s\" ( %zu live bytes exceeds remaining budget of %zu )\n",
+           cand->ops->ftag.streamid, cand->livebytes, policy->budget - policy->spent );
+      resourcelog_freeopinfo( cand->ops );
+      cand->ops = NULL;
+   }
+   // all candidates have been considered, so reset the list for any subsequent pass
+   policy->candcount = 0;
+   policy->candindex = 0;
+   policy->ranked = 0;
+   pthread_mutex_unlock( &(policy->lock) );
+   return 0;
+}
+
+/**
+ * Terminate the given repackpolicy, discarding any remaining candidates
+ * @param REPACKPOLICY policy : Repackpolicy to terminate
+ * @param size_t* spent : Reference to be populated with the count of budgeted bytes scheduled by the policy
+ *                        ( may be NULL )
+ * @return int : Zero on success, or -1 on failure
+ */
+int repackpolicy_term( REPACKPOLICY policy, size_t* spent ) {
+   // validate args
+   if ( policy == NULL ) {
+      LOG( LOG_ERR, "Received a NULL repackpolicy\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // discard all unscheduled candidates
+   while ( policy->candindex < policy->candcount ) {
+      resourcelog_freeopinfo( (policy->candlist + policy->candindex)->ops );
+      policy->candindex++;
+   }
+   if ( spent ) { *spent = policy->spent; }
+   free( policy->candlist );
+   pthread_mutex_destroy( &(policy->lock) );
+   free( policy );
+   return 0;
+}
+
+
+//   -------------   RESOURCETHROTTLE FUNCTIONS    -------------
+
+/**
+ * Initialize a new resourcethrottle
+ * NOTE -- A resourcethrottle maintains a token bucket for each op type at each storage location ( pod and cap ),
+ *         delaying operations which would exceed the configured limits of their location.
+ * @param const throttle_limits* limits : Limits to be enforced by the throttle
+ * @return RESOURCETHROTTLE : New resourcethrottle, or NULL on failure
+ */
+RESOURCETHROTTLE resourcethrottle_init( const throttle_limits* limits ) {
+   // validate args
+   if ( limits == NULL ) {
+      LOG( LOG_ERR, "Received a NULL limits reference\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   // allocate a new struct
+   RESOURCETHROTTLE throttle = malloc( sizeof( struct resourcethrottle_struct ) );
+   if ( throttle == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate new resourcethrottle\n" );
+      return NULL;
+   }
+   // populate all struct elements
+   if ( pthread_mutex_init( &(throttle->lock), NULL ) ) {
+      LOG( LOG_ERR, "Failed to initialize lock\n" );
+      free( throttle );
+      return NULL;
+   }
+   throttle->limits = *limits;
+   throttle->bucketalloc = 16;
+   throttle->bucketlist = malloc( sizeof( throttlebucket ) * throttle->bucketalloc );
+   if ( throttle->bucketlist == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate bucket list\n" );
+      pthread_mutex_destroy( &(throttle->lock) );
+      free( throttle );
+      return NULL;
+   }
+   throttle->bucketcount = 0;
+   return throttle;
+}
+
+/**
+ * Acquire the throttle allowance for a single object operation, waiting until the allowance is available
+ * @param RESOURCETHROTTLE throttle : Resourcethrottle to acquire from
+ * @param operation_type type : Type of the operation
+ * @param const ne_location* location : Location of the object targeted by the operation
+ * @param size_t bytes : Count of bytes to be transferred by the operation
+ * @return int : Zero on success, or -1 on failure
+ */
+int resourcethrottle_acquire( RESOURCETHROTTLE throttle, operation_type type, const ne_location* location, size_t bytes ) {
+   // validate args
+   if ( throttle == NULL  ||  location == NULL  ||  (int)type < 0  ||  (int)type >= THROTTLE_OPTYPES ) {
+      LOG( LOG_ERR, "Received an invalid arg\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   size_t oprate = throttle->limits.oprate[type];
+   size_t byterate = throttle->limits.byterate[type];
+   if ( oprate == 0  &&  byterate == 0 ) { return 0; } // this op type is unlimited
+   // acquire the throttle lock
+   if ( pthread_mutex_lock( &(throttle->lock) ) ) {
+      LOG( LOG_ERR, "Failed to acquire resourcethrottle lock\n" );
+      return -1;
+   }
+   struct timespec curtime;
+   if ( clock_gettime( CLOCK_MONOTONIC, &(curtime) ) ) {
+      LOG( LOG_ERR, "Failed to identify current time\n" );
+      pthread_mutex_unlock( &(throttle->lock) );
+      return -1;
+   }
+   // locate the bucket of this op type and location
+   // NOTE -- scatter values only spread objects across dirs of the same storage, so are ignored here
+   throttlebucket* bucket = NULL;
+   size_t bucketindex = 0;
+   for ( ; bucketindex < throttle->bucketcount; bucketindex++ ) {
+      throttlebucket* parsebucket = throttle->bucketlist + bucketindex;
+      if ( parsebucket->type == type  &&  parsebucket->pod == location->pod  &&  parsebucket->cap == location->cap ) {
+         bucket = parsebucket;
+         break;
+      }
+   }
+   if ( bucket == NULL ) {
+      // expand our bucket list, if necessary
+      if ( throttle->bucketcount == throttle->bucketalloc ) {
+         throttlebucket* newlist = realloc( throttle->bucketlist, sizeof( throttlebucket ) * throttle->bucketalloc * 2 );
+         if ( newlist == NULL ) {
+            LOG( LOG_ERR, "Failed to expand bucket list to %zu entries\n", throttle->bucketalloc * 2 );
+            pthread_mutex_unlock( &(throttle->lock) );
+            return -1;
+         }
+         throttle->bucketlist = newlist;
+         throttle->bucketalloc *= 2;
+      }
+      // a fresh bucket begins with a full second of allowance
+      bucket = throttle->bucketlist + throttle->bucketcount;
+      bucket->pod = location->pod;
+      bucket->cap = location->cap;
+      bucket->type = type;
+      bucket->optokens = (double)oprate;
+      bucket->bytetokens = (double)byterate;
+      bucket->lastfill = curtime;
+      throttle->bucketcount++;
+   }
+   // replenish allowances, accumulating no more than a single second of burst
+   double elapsed = (double)( curtime.tv_sec - bucket->lastfill.tv_sec ) +
+                    (double)( curtime.tv_nsec - bucket->lastfill.tv_nsec ) / 1000000000.0;
+   bucket->lastfill = curtime;
+   bucket->optokens += elapsed * (double)oprate;
+   if ( bucket->optokens > (double)oprate ) { bucket->optokens = (double)oprate; }
+   bucket->bytetokens += elapsed * (double)byterate;
+   if ( bucket->bytetokens > (double)byterate ) { bucket->bytetokens = (double)byterate; }
+   // claim our allowance immediately, so that concurrent callers queue up behind us
+   double waittime = 0.0;
+   if ( oprate ) {
+      bucket->optokens -= 1.0;
+      if ( bucket->optokens < 0.0 ) { waittime = -(bucket->optokens) / (double)oprate; }
+   }
+   if ( byterate ) {
+      bucket->bytetokens -= (double)bytes;
+      if ( bucket->bytetokens < 0.0  &&  -(bucket->bytetokens) / (double)byterate > waittime ) {
+         waittime = -(bucket->bytetokens) / (double)byterate;
+      }
+   }
+   pthread_mutex_unlock( &(throttle->lock) );
+   // wait for our allowance to become available
+   if ( waittime > 0.0 ) {
+      LOG( LOG_INFO, "Throttling op for %.3f seconds at location ( pod=%d, cap=%d )\n",
+           waittime, location->pod, location->cap );
+      struct timespec waitspec;
+      waitspec.tv_sec = (time_t)waittime;
+      waitspec.tv_nsec = (long)( ( waittime - (double)waitspec.tv_sec ) * 1000000000.0 );
+      while ( nanosleep( &(waitspec), &(waitspec) ) ) {
+         if ( errno != EINTR ) {
+            LOG( LOG_ERR, "Failed to wait for throttle allowance\n" );
+            return -1;
+         }
+      }
+   }
+   return 0;
+}
+
+/**
+ * Terminate the given resourcethrottle
+ * @param RESOURCETHROTTLE throttle : Resourcethrottle to terminate
+ * @return int : Zero on success, or -1 on failure
+ */
+int resourcethrottle_term( RESOURCETHROTTLE throttle ) {
+   // validate args
+   if ( throttle == NULL ) {
+      LOG( LOG_ERR, "Received a NULL resourcethrottle\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   free( throttle->bucketlist );
+   pthread_mutex_destroy( &(throttle->lock) );
+   free( throttle );
+   return 0;
+}
+
+
 //   -------------   INTERNAL FUNCTIONS    -------------
 
 
-void process_deleteobj( marfs_position* pos, opinfo* op ) {
+void process_deleteobj( marfs_position* pos, opinfo* op, RESOURCETHROTTLE throttle ) {
    marfs_ds* ds = &(pos->ns->prepo->datascheme);
    size_t countval = 0;
    // check for extendedinfo
@@ -371,6 +762,11 @@ void process_deleteobj( marfs_position* pos, opinfo* op ) {
          op->errval = (errno) ? errno : ENOTRECOVERABLE;
          return;
       }
+      // wait for our allowance at this location
+      if ( throttle  &&  resourcethrottle_acquire( throttle, MARFS_DELETE_OBJ_OP, &(location), 0 ) ) {
+         LOG( LOG_WARNING, "Failed to acquire throttle allowance for deletion of object %zu of stream \"%s\"\n",
+                           tmptag.objno, tmptag.streamid );
+      }
       // delete the object
       LOG( LOG_INFO, "Deleting object %zu of stream \"%s\"\n", tmptag.objno, tmptag.streamid );
       int olderrno = errno;
@@ -385,6 +781,10 @@ void process_deleteobj( marfs_position* pos, opinfo* op ) {
             return;
          }
       }
+      // drop any local copy of the object, so that it can no longer be served or occupy cache space
+      if ( ds->cache  &&  datacache_invalidate( ds->cache, objname ) ) {
+         LOG( LOG_WARNING, "Failed to invalidate cached copy of object %zu of stream \"%s\"\n", tmptag.objno, tmptag.streamid );
+      }
       errno = olderrno;
       free( objname );
       countval++;
@@ -567,7 +967,7 @@ void process_deleteref( const marfs_position* pos, opinfo* op ) {
 }
 
 
-void process_rebuild( const marfs_position* pos, opinfo* op ) {
+void process_rebuild( const marfs_position* pos, opinfo* op, RESOURCETHROTTLE throttle ) {
    // quick refs
    rebuild_info* rebinf = (rebuild_info*)op->extendedinfo;
    marfs_ds* ds = &(pos->ns->prepo->datascheme);
@@ -585,6 +985,12 @@ void process_rebuild( const marfs_position* pos, opinfo* op ) {
          op->errval = (errno) ? errno : ENOTRECOVERABLE;
          return;
       }
+      // wait for our allowance at this location ( a rebuild reads and rewrites up to a full object )
+      if ( throttle  &&  resourcethrottle_acquire( throttle, MARFS_REBUILD_OP, &(location),
+                                                   (tmptag.objsize) ? tmptag.objsize : tmptag.bytes ) ) {
+         LOG( LOG_WARNING, "Failed to acquire throttle allowance for rebuild of object %zu of stream \"%s\"\n",
+                           tmptag.objno, tmptag.streamid );
+      }
       // open an object handle
       ne_handle obj = ne_open( ds->nectxt, objname, location, erasure, NE_REBUILD );
       if ( obj == NULL ) {
@@ -690,8 +1096,8 @@ void process_rebuild( const marfs_position* pos, opinfo* op ) {
    return;
 }
 
-// TODO
-void process_repack( const marfs_position* pos, opinfo* op, REPACKSTREAMER rpckstr ) {
+// TODO ( object transfers should acquire MARFS_REPACK_OP allowances from the throttle )
+void process_repack( const marfs_position* pos, opinfo* op, REPACKSTREAMER rpckstr, RESOURCETHROTTLE throttle ) {
 }
 
 
@@ -716,6 +1122,7 @@ void destroystreamwalker( streamwalker walker ) {
       if ( walker->ftagstr ) { free( walker->ftagstr ); }
       if ( walker->gcops ) { resourcelog_freeopinfo( walker->gcops ); }
       if ( walker->rpckops ) { resourcelog_freeopinfo( walker->rpckops ); }
+      if ( walker->rpckcands ) { resourcelog_freeopinfo( walker->rpckcands ); }
       if ( walker->rbldops ) { resourcelog_freeopinfo( walker->rbldops ); }
       if ( walker->ftag.ctag ) { free( walker->ftag.ctag ); }
       if ( walker->ftag.streamid ) { free( walker->ftag.streamid ); }
@@ -957,7 +1364,137 @@ int process_identifyoperation( opinfo** opchain, operation_type type, FTAG* ftag
    }
    *optgt = newop;
    return 0;
-} 
+}
+
+// note all objects ( not already noted ) referenced by the live file most recently encountered by the walker,
+//    generating location-based rebuild ops and recording the objects into any attached manifest
+int notelivefile( streamwalker walker, size_t endobj ) {
+   char rebuild = ( walker->rebuildthresh  &&  walker->stval.st_ctime < walker->rebuildthresh ) ? 1 : 0;
+   if ( rebuild == 0  &&  walker->manifest == NULL ) { return 0; }
+   marfs_ds* ds = &(walker->pos.ns->prepo->datascheme);
+   FTAG tmptag = walker->ftag;
+   if ( tmptag.objno < walker->liveobj ) { tmptag.objno = walker->liveobj; } // skip objects shared with a prior file
+   for ( ; tmptag.objno <= endobj; tmptag.objno++ ) {
+      char* objname = NULL;
+      ne_erasure erasure;
+      ne_location location;
+      if ( datastream_objtarget( &(tmptag), ds, &objname, &erasure, &location ) ) {
+         LOG( LOG_ERR, "Failed to populate object target info for object %zu of stream \"%s\"\n", tmptag.objno, tmptag.streamid );
+         return -1;
+      }
+      free( objname );
+      if ( walker->manifest ) {
+         // record this object, regardless of location
+         size_t tagstrlen = ftag_tostr( &(tmptag), walker->ftagstr, walker->ftagstralloc );
+         if ( tagstrlen >= walker->ftagstralloc ) {
+            char* newstr = malloc( sizeof(char) * (tagstrlen + 1) );
+            if ( newstr == NULL ) {
+               LOG( LOG_ERR, "Failed to increase ftag string allocation to length of %zu\n", tagstrlen + 1 );
+               return -1;
+            }
+            free( walker->ftagstr );
+            walker->ftagstr = newstr;
+            walker->ftagstralloc = tagstrlen + 1;
+            tagstrlen = ftag_tostr( &(tmptag), walker->ftagstr, walker->ftagstralloc );
+         }
+         if ( tagstrlen < 1  ||  tagstrlen >= walker->ftagstralloc ) {
+            LOG( LOG_ERR, "Failed to populate FTAG string for object %zu of stream \"%s\"\n", tmptag.objno, tmptag.streamid );
+            return -1;
+         }
+         // NOTE -- output errors are left for process_closemanifest() to detect
+         fprintf( walker->manifest, "%lld %d %d %d %s\n", (long long)walker->stval.st_ctime,
+                  location.pod, location.cap, location.scatter, walker->ftagstr );
+      }
+      // check for location match
+      if ( rebuild  &&
+           (walker->rebuildloc.pod < 0  ||  walker->rebuildloc.pod == location.pod )  &&
+           (walker->rebuildloc.cap < 0  ||  walker->rebuildloc.cap == location.cap )  &&
+           (walker->rebuildloc.scatter < 0  ||  walker->rebuildloc.scatter == location.scatter ) ) {
+         LOG( LOG_INFO, "Adding rebuild op for object %zu\n", tmptag.objno );
+         opinfo* optgt = NULL;
+         if ( process_identifyoperation( &(walker->rbldops), MARFS_REBUILD_OP, &(tmptag), &(optgt) ) ) {
+            LOG( LOG_ERR, "Failed to identify operation target for rebuild of object %zu\n", tmptag.objno );
+            return -1;
+         }
+         if ( optgt->count == 0  &&  optgt->extendedinfo ) {
+            // location-based rebuilds have no associated marker file or RTAG
+            free( optgt->extendedinfo );
+            optgt->extendedinfo = NULL;
+         }
+         optgt->count++;
+         walker->report.rbldobjs++;
+      }
+   }
+   if ( endobj >= walker->liveobj ) { walker->liveobj = endobj + 1; }
+   return 0;
+}
+
+// potentially generate a repack op for the active file most recently encountered by the walker
+int noterepackfile( streamwalker walker, size_t endobj ) {
+   // only files old enough for repack, and contained within a single object of a packed repo, are targeted
+   marfs_ds* ds = &(walker->pos.ns->prepo->datascheme);
+   if ( walker->repackthresh == 0  ||  walker->stval.st_ctime >= walker->repackthresh  ||
+        walker->ftag.objno != endobj  ||  ds->objfiles == 1  ||  ds->objsize <= walker->headerlen ) {
+      return 0;
+   }
+   opinfo* optgt = NULL;
+   if ( process_identifyoperation( &(walker->rpckops), MARFS_REPACK_OP, &(walker->ftag), &(optgt) ) ) {
+      LOG( LOG_ERR, "Failed to identify operation target for repack of file %zu\n", walker->ftag.fileno );
+      return -1;
+   }
+   optgt->count++;
+   repack_info* rpckinf = optgt->extendedinfo;
+   rpckinf->totalbytes += walker->ftag.bytes;
+   walker->rpckobjbytes += walker->ftag.bytes;
+   return 0;
+}
+
+// decide the fate of all repack ops targeting the current object, prior to the walker progressing beyond it
+//    ops are discarded if the object is not 'keepable', is too full, holds no dead data to be reclaimed,
+//    or holds live data which would not be repacked;
+//    otherwise, they are retained for submission to the walker's policy or directly dispatched via 'repackops'
+//    returns 1 if ops were dispatched, zero if not
+int noterepackobj( streamwalker walker, char keepable, opinfo** repackops ) {
+   int retval = 0;
+   if ( walker->rpckops ) {
+      size_t repackbytethresh = (walker->pos.ns->prepo->datascheme.objsize - walker->headerlen) / 2;
+      if ( !(keepable)  ||  !(walker->rpckdead)  ||  walker->activebytes >= repackbytethresh  ||
+           walker->activebytes != walker->rpckobjbytes ) {
+         // discard all ops
+         LOG( LOG_INFO, "Discarding repack ops of object %zu ( %zu active bytes, %zu targeted )\n",
+              walker->objno, walker->activebytes, walker->rpckobjbytes );
+         resourcelog_freeopinfo( walker->rpckops );
+      }
+      else {
+         // record repack counts
+         opinfo* repackparse = walker->rpckops;
+         opinfo* repacktail = NULL;
+         while ( repackparse ) {
+            walker->report.rpckfiles += repackparse->count;
+            walker->report.rpckbytes += ( (struct repack_info_struct*) repackparse->extendedinfo )->totalbytes;
+            repacktail = repackparse;
+            repackparse = repackparse->next;
+         }
+         if ( walker->rpckpolicy ) {
+            // retain all ops, to be submitted as a single candidate once the stream is complete
+            repacktail->next = walker->rpckcands;
+            walker->rpckcands = walker->rpckops;
+            walker->rpcklive += walker->activebytes;
+            walker->rpckobjs++;
+         }
+         else {
+            // dispatch all ops
+            repacktail->next = *repackops;
+            *repackops = walker->rpckops;
+            retval = 1;
+         }
+      }
+      walker->rpckops = NULL;
+   }
+   walker->rpckobjbytes = 0;
+   walker->rpckdead = 0;
+   return retval;
+}
 
 
 //   -------------   RESOURCE PROCESSING FUNCTIONS    -------------
@@ -1326,7 +1863,16 @@ streamwalker process_openstreamwalker( marfs_position* pos, const char* reftgt,
    walker->activeindex = 0;
    walker->rpckops = NULL;
    walker->activebytes = 0;
+   walker->rpckobjbytes = 0;
+   walker->rpckdead = 0;
+   walker->rpckpolicy = NULL;
+   walker->rpckcands = NULL;
+   walker->rpcklive = 0;
+   walker->rpckobjs = 0;
    walker->rbldops = NULL;
+   walker->liveobj = 0;
+   walker->livezero = 0;
+   walker->manifest = NULL;
    // retrieve xattrs from the inital stream file
    char filestate = 0;
    if ( process_getfileinfo( reftgt, 1, walker, &(filestate) )  ||  !(filestate) ) {
@@ -1340,7 +1886,8 @@ streamwalker process_openstreamwalker( marfs_position* pos, const char* reftgt,
       .majorversion = walker->ftag.majorversion,
       .minorversion = walker->ftag.minorversion,
       .ctag = walker->ftag.ctag,
-      .streamid = walker->ftag.streamid
+      .streamid = walker->ftag.streamid,
+      .compression = walker->ftag.compression
    };
    walker->headerlen = recovery_headertostr(&(header), NULL, 0);
    // calculate the ending position of this file
@@ -1441,13 +1988,22 @@ streamwalker process_openstreamwalker( marfs_position* pos, const char* reftgt,
       // file is active
       walker->report.fileusage++;
       walker->report.byteusage += walker->ftag.bytes;
-      // TODO potentially generate repack op
-      // TODO potentially generate rebuild op
+      if ( noterepackfile( walker, endobj ) ) {
+         LOG( LOG_ERR, "Failed to note repack state of initial reference target: \"%s\"\n", reftgt );
+         destroystreamwalker( walker );
+         return NULL;
+      }
+   }
+   if ( filestate == 1  &&  !(assumeactive) ) {
+      // note dead data within the final object of this file
+      walker->rpckdead = 1;
    }
    if ( filestate > 1  ||  assumeactive ) {
       // update state to reflect active initial file
       walker->activefiles++;
       walker->activebytes += walker->ftag.bytes;
+      // defer noting the objects of this file until the first iteration, allowing a manifest to be attached
+      walker->livezero = 1;
    }
    // update walker state to reflect new target
    walker->objno = endobj;
@@ -1472,6 +2028,43 @@ streamwalker process_openstreamwalker( marfs_position* pos, const char* reftgt,
    return walker;
 }
 
+/**
+ * Attach an object manifest to the given streamwalker, to be populated with all objects referenced by live files
+ * NOTE -- this must be called prior to the first iteration of the walker
+ * @param streamwalker walker : Streamwalker to attach the manifest to
+ * @param FILE* manifest : Object manifest, opened for recording ( see process_openmanifest() )
+ * @return int : Zero on success, or -1 on failure
+ */
+int process_streamwalkermanifest( streamwalker walker, FILE* manifest ) {
+   // validate args
+   if ( walker == NULL  ||  manifest == NULL ) {
+      LOG( LOG_ERR, "Received an invalid arg\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   walker->manifest = manifest;
+   return 0;
+}
+
+/**
+ * Attach a repackpolicy to the given streamwalker, to be submitted the repack candidate of the walked datastream
+ * NOTE -- this must be called prior to the first iteration of the walker.  A walker with an attached policy will
+ *         never directly produce repack operations; they must instead be retrieved via repackpolicy_next().
+ * @param streamwalker walker : Streamwalker to attach the policy to
+ * @param REPACKPOLICY policy : Repackpolicy to be submitted to
+ * @return int : Zero on success, or -1 on failure
+ */
+int process_streamwalkerpolicy( streamwalker walker, REPACKPOLICY policy ) {
+   // validate args
+   if ( walker == NULL  ||  policy == NULL ) {
+      LOG( LOG_ERR, "Received an invalid arg\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   walker->rpckpolicy = policy;
+   return 0;
+}
+
 /**
  * Iterate over a datastream, accumulating quota values and identifying operation targets
  * NOTE -- This func will return all possible operations, given walker settings.  It is up to the caller whether those ops 
@@ -1501,11 +2094,24 @@ int process_iteratestreamwalker( streamwalker walker, opinfo** gcops, opinfo** r
       errno = EINVAL;
       return -1;
    }
+   if ( walker->rebuildthresh != 0  &&  rebuildops == NULL ) {
+      LOG( LOG_ERR, "Received NULL rebuildops reference when the walker is set to produce those operations\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // note the objects of a live initial file
+   if ( walker->livezero ) {
+      if ( notelivefile( walker, walker->objno ) ) {
+         LOG( LOG_ERR, "Failed to note objects of initial file\n" );
+         return -1;
+      }
+      walker->livezero = 0;
+   }
    // set up some initial values
-   marfs_ds* ds = &(walker->pos.ns->prepo->datascheme);
    size_t objsize = walker->pos.ns->prepo->datascheme.objsize;   // current repo-defined chunking limit
-   size_t repackbytethresh = (objsize - walker->headerlen) / 2;
-   char pullxattrs = ( walker->gcthresh == 0  &&  walker->repackthresh == 0 ) ? 0 : 1;
+   // NOTE -- object targets of each file are only known if we pull xattrs
+   char pullxattrs = ( walker->gcthresh == 0  &&  walker->repackthresh == 0  &&
+                       walker->rebuildthresh == 0  &&  walker->manifest == NULL ) ? 0 : 1;
    char dispatchedops = 0;
    // iterate over all reference targets
    while ( walker->ftag.endofstream == 0  &&  (walker->ftag.state & FTAG_DATASTATE) >= FTAG_FIN ) {
@@ -1514,6 +2120,7 @@ int process_iteratestreamwalker( streamwalker walker, opinfo** gcops, opinfo** r
       if ( walker->gctag.refcnt ) {
          // handle any existing gctag value
          tgtoffset += walker->gctag.refcnt; // skip over count indicated by the tag
+         walker->rpckdead = 1; // skipped files begin in the current object, and their data is dead
          if ( walker->gctag.inprog  &&  walker->gcthresh ) {
             LOG( LOG_INFO, "Cleaning up in-progress deletion of %zu reference files from previous instance\n", walker->gctag.refcnt );
             opinfo* optgt = NULL;
@@ -1571,7 +2178,8 @@ int process_iteratestreamwalker( streamwalker walker, opinfo** gcops, opinfo** r
          LOG( LOG_ERR, "Failed to get info for reference target: \"%s\"\n", reftgt );
          return -1;
       }
-      pullxattrs = ( walker->gcthresh == 0  &&  walker->repackthresh == 0 ) ? 0 : 1; // return to default behavior
+      pullxattrs = ( walker->gcthresh == 0  &&  walker->repackthresh == 0  &&
+                     walker->rebuildthresh == 0  &&  walker->manifest == NULL ) ? 0 : 1; // return to default behavior
       if ( filestate == 0 ) {
          // file doesn't exist ( likely that we skipped a GCTAG on the previous file )
          // decrement to the previous index and make sure to check for xattrs
@@ -1672,38 +2280,8 @@ int process_iteratestreamwalker( streamwalker walker, opinfo** gcops, opinfo** r
                }
             }
             // need to handle repack ops
-            if ( walker->rpckops ) {
-               if ( walker->activebytes >= repackbytethresh ) {
-                  // discard all ops
-                  LOG( LOG_INFO, "Discarding repack ops due to excessive active bytes: %zu\n", walker->activebytes );
-                  resourcelog_freeopinfo( walker->rpckops );
-               }
-               else {
-                  // dispatch all ops
-                  walker->report.rpckfiles += walker->rpckops->count;
-                  walker->report.rpckbytes += ( (struct repack_info_struct*) walker->rpckops->extendedinfo )->totalbytes;
-                  *repackops = walker->rpckops;
-                  dispatchedops = 1; // note to exit after this file
-               }
-               walker->rpckops = NULL;
-            }
-            // possibly update rebuild ops
-            if ( walker->rebuildthresh  &&  walker->activefiles  &&  walker->stval.st_ctime < walker->rebuildthresh ) {
-               // check if object targets our rebuild location
-               char* objname = NULL;
-               ne_erasure erasure;
-               ne_location location;
-               if ( datastream_objtarget( &(walker->ftag), ds, &objname, &erasure, &location) ) {
-                  LOG( LOG_ERR, "Failed to populate object target info for object %zu of stream \"%s\"\n", walker->ftag.objno, walker->ftag.streamid );
-                  return -1;
-               }
-               // check for location match
-               if ( (walker->rebuildloc.pod < 0  ||  walker->rebuildloc.pod == location.pod )  &&
-                    (walker->rebuildloc.cap < 0  ||  walker->rebuildloc.cap == location.cap )  &&
-                    (walker->rebuildloc.scatter < 0  ||  walker->rebuildloc.scatter == location.scatter ) ) {
-                  // TODO generate a rebuild op for this object
-               }
-               free( objname );
+            if ( noterepackobj( walker, 1, repackops ) ) {
+               dispatchedops = 1; // note to exit after this file
             }
             // update state
             walker->activefiles = 0; // update active file count for new obj
@@ -1828,14 +2406,25 @@ int process_iteratestreamwalker( streamwalker walker, opinfo** gcops, opinfo** r
          walker->report.fileusage++;
          if ( haveftag ) { walker->report.byteusage += walker->ftag.bytes; }
          else { walker->report.byteusage += walker->stval.st_size; }
-         // TODO manage repack ops
-         // TODO potentially generate rebuild ops
+         // potentially target this file for repack
+         if ( haveftag  &&  noterepackfile( walker, endobj ) ) {
+            LOG( LOG_ERR, "Failed to note repack state of file %zu\n", walker->ftag.fileno );
+            return -1;
+         }
       }
+      // note dead data within the current object
+      if ( filestate == 1  &&  !(assumeactive) ) { walker->rpckdead = 1; }
       // potentially update values based on spanned objects
       if ( walker->objno != endobj ) {
+         // an object partially holding a live file can't be freed, so must not be repacked
+         if ( noterepackobj( walker, ( filestate > 1  ||  assumeactive ) ? 0 : 1, repackops ) ) {
+            dispatchedops = 1; // note to exit after this file
+         }
          walker->activefiles = 0; // update active file count for new obj
          walker->activebytes = 0; // update active byte count for new obj
          walker->report.objcount += endobj - walker->objno;
+         // the final object of an inactive file also holds dead data
+         if ( filestate == 1  &&  !(assumeactive) ) { walker->rpckdead = 1; }
       }
       if ( filestate > 1  ||  assumeactive ) {
          // handle GC state
@@ -1850,6 +2439,19 @@ int process_iteratestreamwalker( streamwalker walker, opinfo** gcops, opinfo** r
             dispatchedops = 1; // note to exit after this file
             walker->gcops = NULL;
          }
+         // handle rebuild state
+         if ( haveftag ) {
+            if ( notelivefile( walker, endobj ) ) {
+               LOG( LOG_ERR, "Failed to note objects of file %zu\n", walker->ftag.fileno );
+               return -1;
+            }
+            // dispatch rebuild ops immediately, so that they may be spread across all consumers
+            if ( walker->rbldops ) {
+               *rebuildops = walker->rbldops;
+               dispatchedops = 1; // note to exit after this file
+               walker->rbldops = NULL;
+            }
+         }
       }
       // update walker state to reflect new target
       walker->fileno += tgtoffset;
@@ -1866,25 +2468,20 @@ int process_iteratestreamwalker( streamwalker walker, opinfo** gcops, opinfo** r
       dispatchedops = 1;
       walker->gcops = NULL;
    }
-   if ( walker->rpckops ) {
-      if ( walker->activebytes >= repackbytethresh ) {
-         // discard all ops
-         LOG( LOG_INFO, "Discarding repack ops due to excessive active bytes: %zu\n", walker->activebytes );
-         resourcelog_freeopinfo( walker->rpckops );
-      }
-      else {
-         // record repack counts
-         opinfo* repackparse = walker->rpckops;
-         while ( repackparse ) {
-            walker->report.rpckfiles += repackparse->count;
-            walker->report.rpckbytes += ( (struct repack_info_struct*) repackparse->extendedinfo )->totalbytes;
-            repackparse = repackparse->next;
-         }
-         // dispatch all ops
-         *repackops = walker->rpckops;
-         dispatchedops = 1;
+   if ( noterepackobj( walker, 1, repackops ) ) {
+      dispatchedops = 1;
+   }
+   if ( walker->rpckcands ) {
+      // submit the candidate of this entire stream, for ranking against all others
+      int subres = repackpolicy_submit( walker->rpckpolicy, walker->rpckcands, walker->rpcklive,
+                                        walker->rpckobjs, objsize - walker->headerlen );
+      walker->rpckcands = NULL; // policy has taken ownership, regardless of result
+      walker->rpcklive = 0;
+      walker->rpckobjs = 0;
+      if ( subres ) {
+         LOG( LOG_ERR, "Failed to submit repack candidate of stream \"%s\"\n", walker->ftag.streamid );
+         return -1;
       }
-      walker->rpckops = NULL;
    }
    if ( walker->rbldops ) {
       *rebuildops = walker->rbldops;
@@ -1899,6 +2496,29 @@ int process_iteratestreamwalker( streamwalker walker, opinfo** gcops, opinfo** r
    return 0;
 }
 
+/**
+ * Check whether the given streamwalker traversed its entire datastream
+ * NOTE -- a traversal also halts at the first file which has yet to be finalized, in which case any objects
+ *         referenced by that file ( or by those following it ) will be absent from an attached manifest
+ * @param streamwalker walker : Streamwalker to be checked ( following an iteration result of zero )
+ * @return int : 1, if the walker reached the end of the datastream with every file finalized;
+ *               0, if the walker was halted by an unfinalized file;
+ *               -1, if a failure occurred
+ */
+int process_streamwalkerfinalized( streamwalker walker ) {
+   // check args
+   if ( walker == NULL ) {
+      LOG( LOG_ERR, "Received a NULL streamwalker reference\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   if ( (walker->ftag.state & FTAG_DATASTATE) < FTAG_FIN ) {
+      LOG( LOG_INFO, "Traversal halted at unfinalized file %zu of stream \"%s\"\n", walker->ftag.fileno, walker->ftag.streamid );
+      return 0;
+   }
+   return 1;
+}
+
 /**
  * Close the given streamwalker
  * @param streamwalker walker : Streamwalker to be closed
@@ -1918,7 +2538,7 @@ int process_closestreamwalker( streamwalker walker, streamwalker_report* report
    }
    // check for incomplete walker
    int retval = 0;
-   if ( walker->gcops  ||  walker->rpckops  ||  walker->rbldops  ||
+   if ( walker->gcops  ||  walker->rpckops  ||  walker->rpckcands  ||  walker->rbldops  ||
         (
             walker->ftag.endofstream == 0  &&
             (walker->gctag.refcnt == 0  ||  walker->gctag.eos == 0)  &&
@@ -1938,11 +2558,13 @@ int process_closestreamwalker( streamwalker walker, streamwalker_report* report
  *                     NOTE -- this will be updated to reflect operation completion / error
  * @param RESOURCELOG* log : Resource log to be updated with op completion / error
  * @param REPACKSTREAMER rpckstr : Repack streamer to be used for repack operations
+ * @param RESOURCETHROTTLE throttle : Throttle limiting the rate of object operations ( NULL, if unlimited )
  * @return int : Zero on success, or -1 on failure
  *               NOTE -- This func will not return 'failure' unless a critical internal error occurs.
  *                       'Standard' operation errors will simply be reflected in the op struct itself.
  */
-int process_executeoperation( marfs_position* pos, opinfo* op, RESOURCELOG* rlog, REPACKSTREAMER rpkstr ) {
+int process_executeoperation( marfs_position* pos, opinfo* op, RESOURCELOG* rlog, REPACKSTREAMER rpkstr,
+                              RESOURCETHROTTLE throttle ) {
    // check arguments
    if ( op == NULL ) {
       LOG( LOG_ERR, "Received a NULL operation value\n" );
@@ -1986,7 +2608,7 @@ int process_executeoperation( marfs_position* pos, opinfo* op, RESOURCELOG* rlog
          switch ( op->type ) {
             case MARFS_DELETE_OBJ_OP:
                LOG( LOG_INFO, "Performing object deletion op on stream \"%s\"\n", op->ftag.streamid );
-               process_deleteobj( pos, op );
+               process_deleteobj( pos, op, throttle );
                break;
             case MARFS_DELETE_REF_OP:
                LOG( LOG_INFO, "Performing reference deletion op on stream \"%s\"\n", op->ftag.streamid );
@@ -1994,11 +2616,11 @@ int process_executeoperation( marfs_position* pos, opinfo* op, RESOURCELOG* rlog
                break;
             case MARFS_REBUILD_OP:
                LOG( LOG_INFO, "Performing rebuild op on stream \"%s\"\n", op->ftag.streamid );
-               process_rebuild( pos, op );
+               process_rebuild( pos, op, throttle );
                break;
             case MARFS_REPACK_OP:
                LOG( LOG_INFO, "Performing repack op on stream \"%s\"\n", op->ftag.streamid );
-               process_repack( pos, op, rpkstr );
+               process_repack( pos, op, rpkstr, throttle );
                break;
             default:
                LOG( LOG_ERR, "Unrecognized operation type value\n" );
@@ -2034,3 +2656,469 @@ int process_executeoperation( marfs_position* pos, opinfo* op, RESOURCELOG* rlog
 }
 
 
+
+//   -------------   CHECKPOINT FUNCTIONS    -------------
+
+/**
+ * Generate the path of the checkpoint file for the given reference dir index
+ * @param const char* ckptdir : Checkpoint dir of the current NS
+ * @param size_t refindex : Index of the reference dir
+ * @param const char* suffix : Suffix to be appended to the checkpoint path ( empty string for none )
+ * @return char* : Newly allocated checkpoint path, or NULL on failure
+ */
+char* checkpointpath( const char* ckptdir, size_t refindex, const char* suffix ) {
+   int pathlen = snprintf( NULL, 0, "%s/refdir-%zu%s", ckptdir, refindex, suffix );
+   if ( pathlen < 1 ) {
+      LOG( LOG_ERR, "Failed to identify length of checkpoint path for reference index %zu\n", refindex );
+      return NULL;
+   }
+   char* path = malloc( sizeof(char) * (pathlen + 1) );
+   if ( path == NULL ) {
+      LOG( LOG_ERR, "Failed to allocate checkpoint path for reference index %zu\n", refindex );
+      return NULL;
+   }
+   if ( snprintf( path, pathlen + 1, "%s/refdir-%zu%s", ckptdir, refindex, suffix ) != pathlen ) {
+      LOG( LOG_ERR, "Checkpoint path has inconsistent length\n" );
+      free( path );
+      errno = EFAULT;
+      return NULL;
+   }
+   return path;
+}
+
+/**
+ * Populate a fresh checkpoint with the current digest values of the given reference dir
+ * @param marfs_position* pos : MarFS position of the NS containing the reference dir
+ * @param const char* refdirpath : Path of the reference dir
+ * @param refdir_checkpoint* ckpt : Reference to the checkpoint to be populated
+ *                                  NOTE -- all non-digest values will be zeroed
+ * @return int : Zero on success, or -1 on failure
+ */
+int process_refdirdigest( marfs_position* pos, const char* refdirpath, refdir_checkpoint* ckpt ) {
+   // check for invalid args
+   if ( pos == NULL  ||  pos->ctxt == NULL  ||  refdirpath == NULL  ||  ckpt == NULL ) {
+      LOG( LOG_ERR, "Received an invalid arg\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   MDAL mdal = pos->ns->prepo->metascheme.mdal;
+   struct stat stval;
+   if ( mdal->statref( pos->ctxt, refdirpath, &(stval) ) ) {
+      LOG( LOG_ERR, "Failed to stat reference dir \"%s\"\n", refdirpath );
+      return -1;
+   }
+   bzero( ckpt, sizeof( struct refdir_checkpoint_struct ) );
+   ckpt->mtime = stval.st_mtim;
+   ckpt->nlink = stval.st_nlink;
+   ckpt->size = stval.st_size;
+   return 0;
+}
+
+/**
+ * Determine if the given checkpoint digests match ( reference dir is unchanged since the earlier sweep )
+ * @param const refdir_checkpoint* prevckpt : Checkpoint of a previous sweep
+ * @param const refdir_checkpoint* curckpt : Checkpoint with current digest values
+ * @return int : One if the digests match, or zero if not
+ */
+int process_refdirunchanged( const refdir_checkpoint* prevckpt, const refdir_checkpoint* curckpt ) {
+   if ( prevckpt->mtime.tv_sec != curckpt->mtime.tv_sec  ||
+        prevckpt->mtime.tv_nsec != curckpt->mtime.tv_nsec  ||
+        prevckpt->nlink != curckpt->nlink  ||
+        prevckpt->size != curckpt->size ) {
+      return 0;
+   }
+   return 1;
+}
+
+/**
+ * Read the checkpoint of a previous sweep of the given reference dir
+ * @param const char* ckptdir : Checkpoint dir of the current NS
+ * @param size_t refindex : Index of the reference dir
+ * @param const char* refdirpath : Path of the reference dir
+ * @param refdir_checkpoint* ckpt : Reference to the checkpoint to be populated
+ * @return int : Zero on success, One if no checkpoint exists for the reference dir, or -1 on failure
+ */
+int process_readcheckpoint( const char* ckptdir, size_t refindex, const char* refdirpath, refdir_checkpoint* ckpt ) {
+   // check for invalid args
+   if ( ckptdir == NULL  ||  refdirpath == NULL  ||  ckpt == NULL ) {
+      LOG( LOG_ERR, "Received an invalid arg\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   char* ckptpath = checkpointpath( ckptdir, refindex, "" );
+   if ( ckptpath == NULL ) {
+      LOG( LOG_ERR, "Failed to identify checkpoint path for reference dir \"%s\"\n", refdirpath );
+      return -1;
+   }
+   FILE* ckptfile = fopen( ckptpath, "r" );
+   if ( ckptfile == NULL ) {
+      if ( errno == ENOENT ) {
+         LOG( LOG_INFO, "No checkpoint exists for reference dir \"%s\"\n", refdirpath );
+         free( ckptpath );
+         return 1;
+      }
+      LOG( LOG_ERR, "Failed to open checkpoint file \"%s\"\n", ckptpath );
+      free( ckptpath );
+      return -1;
+   }
+   // the first line should hold the reference dir path
+   char* readline = NULL;
+   size_t linealloc = 0;
+   ssize_t linelen = getline( &(readline), &(linealloc), ckptfile );
+   if ( linelen < 2  ||  readline[linelen - 1] != '\n' ) {
+      LOG( LOG_ERR, "Failed to read reference path from checkpoint file \"%s\"\n", ckptpath );
+      if ( readline ) { free( readline ); }
+      fclose( ckptfile );
+      free( ckptpath );
+      errno = EINVAL;
+      return -1;
+   }
+   readline[linelen - 1] = '\0';
+   if ( strcmp( readline, refdirpath ) ) {
+      // reference dirs have been reorganized since this checkpoint was recorded
+      LOG( LOG_INFO, "Checkpoint file \"%s\" is associated with a different reference dir: \"%s\"\n",
+                     ckptpath, readline );
+      free( readline );
+      fclose( ckptfile );
+      free( ckptpath );
+      return 1;
+   }
+   free( readline );
+   // the second line should hold all numeric values
+   long long mtimesec = 0;
+   long long mtimensec = 0;
+   unsigned long long nlink = 0;
+   long long size = 0;
+   long long sweeptime = 0;
+   refdir_checkpoint tmpckpt;
+   bzero( &(tmpckpt), sizeof( struct refdir_checkpoint_struct ) );
+   if ( fscanf( ckptfile, "%lld %lld %llu %lld %lld %zu %zu %zu %zu %zu %zu %zu\n",
+                &(mtimesec), &(mtimensec), &(nlink), &(size), &(sweeptime), &(tmpckpt.entries),
+                &(tmpckpt.report.fileusage), &(tmpckpt.report.byteusage), &(tmpckpt.report.filecount),
+                &(tmpckpt.report.objcount), &(tmpckpt.report.bytecount), &(tmpckpt.report.streamcount) ) != 12 ) {
+      LOG( LOG_ERR, "Failed to parse values of checkpoint file \"%s\"\n", ckptpath );
+      fclose( ckptfile );
+      free( ckptpath );
+      errno = EINVAL;
+      return -1;
+   }
+   fclose( ckptfile );
+   free( ckptpath );
+   tmpckpt.mtime.tv_sec = (time_t)mtimesec;
+   tmpckpt.mtime.tv_nsec = (long)mtimensec;
+   tmpckpt.nlink = (nlink_t)nlink;
+   tmpckpt.size = (off_t)size;
+   tmpckpt.sweeptime = (time_t)sweeptime;
+   *ckpt = tmpckpt;
+   return 0;
+}
+
+/**
+ * Record the checkpoint of a completed sweep of the given reference dir
+ * NOTE -- any previous checkpoint of the same reference dir will be atomically replaced
+ * @param const char* ckptdir : Checkpoint dir of the current NS
+ * @param size_t refindex : Index of the reference dir
+ * @param const char* refdirpath : Path of the reference dir
+ * @param const refdir_checkpoint* ckpt : Reference to the checkpoint to be recorded
+ * @return int : Zero on success, or -1 on failure
+ */
+int process_writecheckpoint( const char* ckptdir, size_t refindex, const char* refdirpath, const refdir_checkpoint* ckpt ) {
+   // check for invalid args
+   if ( ckptdir == NULL  ||  refdirpath == NULL  ||  ckpt == NULL ) {
+      LOG( LOG_ERR, "Received an invalid arg\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   char* ckptpath = checkpointpath( ckptdir, refindex, "" );
+   char* tmppath = checkpointpath( ckptdir, refindex, ".partial" );
+   if ( ckptpath == NULL  ||  tmppath == NULL ) {
+      LOG( LOG_ERR, "Failed to identify checkpoint paths for reference dir \"%s\"\n", refdirpath );
+      if ( ckptpath ) { free( ckptpath ); }
+      if ( tmppath ) { free( tmppath ); }
+      return -1;
+   }
+   // output all values to a temporary file
+   FILE* ckptfile = fopen( tmppath, "w" );
+   if ( ckptfile == NULL ) {
+      LOG( LOG_ERR, "Failed to open temporary checkpoint file \"%s\"\n", tmppath );
+      free( tmppath );
+      free( ckptpath );
+      return -1;
+   }
+   if ( fprintf( ckptfile, "%s\n%lld %lld %llu %lld %lld %zu %zu %zu %zu %zu %zu %zu\n", refdirpath,
+                 (long long)ckpt->mtime.tv_sec, (long long)ckpt->mtime.tv_nsec, (unsigned long long)ckpt->nlink,
+                 (long long)ckpt->size, (long long)ckpt->sweeptime, ckpt->entries,
+                 ckpt->report.fileusage, ckpt->report.byteusage, ckpt->report.filecount,
+                 ckpt->report.objcount, ckpt->report.bytecount, ckpt->report.streamcount ) < 1 ) {
+      LOG( LOG_ERR, "Failed to output values to temporary checkpoint file \"%s\"\n", tmppath );
+      fclose( ckptfile );
+      unlink( tmppath );
+      free( tmppath );
+      free( ckptpath );
+      return -1;
+   }
+   if ( fclose( ckptfile ) ) {
+      LOG( LOG_ERR, "Failed to close temporary checkpoint file \"%s\"\n", tmppath );
+      unlink( tmppath );
+      free( tmppath );
+      free( ckptpath );
+      return -1;
+   }
+   // replace any previous checkpoint
+   if ( rename( tmppath, ckptpath ) ) {
+      LOG( LOG_ERR, "Failed to rename temporary checkpoint file \"%s\" to \"%s\"\n", tmppath, ckptpath );
+      unlink( tmppath );
+      free( tmppath );
+      free( ckptpath );
+      return -1;
+   }
+   LOG( LOG_INFO, "Recorded checkpoint for reference dir \"%s\" ( %zu entries, %zu streams )\n",
+                  refdirpath, ckpt->entries, ckpt->report.streamcount );
+   free( tmppath );
+   free( ckptpath );
+   return 0;
+}
+
+
+/**
+ * Open the object manifest of the given reference dir
+ * NOTE -- A manifest lists the location of every object referenced by a live file of the datastreams beginning in
+ *         the reference dir.  It is only valid alongside the checkpoint of the same sweep, and allows a
+ *         location-based rebuild to skip walking those datastreams while the reference dir remains unchanged.
+ * @param const char* ckptdir : Checkpoint dir of the current NS
+ * @param size_t refindex : Index of the reference dir
+ * @param const char* refdirpath : Path of the reference dir
+ * @param time_t sweeptime : Sweep time of the checkpoint associated with the manifest
+ * @param char record : If non-zero, open a new manifest to be recorded ( see process_closemanifest() );
+ *                      if zero, open the existing manifest of the reference dir to be replayed
+ * @return FILE* : Open manifest, or NULL on failure
+ *                 NOTE -- errno will be set to ENOENT, if no applicable manifest exists to be replayed
+ */
+FILE* process_openmanifest( const char* ckptdir, size_t refindex, const char* refdirpath, time_t sweeptime, char record ) {
+   // check for invalid args
+   if ( ckptdir == NULL  ||  refdirpath == NULL ) {
+      LOG( LOG_ERR, "Received an invalid arg\n" );
+      errno = EINVAL;
+      return NULL;
+   }
+   char* mpath = checkpointpath( ckptdir, refindex, (record) ? "-objects.partial" : "-objects" );
+   if ( mpath == NULL ) {
+      LOG( LOG_ERR, "Failed to identify manifest path for reference dir \"%s\"\n", refdirpath );
+      return NULL;
+   }
+   if ( record ) {
+      // begin a new manifest, headed by the reference dir path and sweep time
+      FILE* manifest = fopen( mpath, "w" );
+      if ( manifest == NULL ) {
+         LOG( LOG_ERR, "Failed to open temporary manifest file \"%s\"\n", mpath );
+         free( mpath );
+         return NULL;
+      }
+      if ( fprintf( manifest, "%s\n%lld\n", refdirpath, (long long)sweeptime ) < 1 ) {
+         LOG( LOG_ERR, "Failed to output header of temporary manifest file \"%s\"\n", mpath );
+         fclose( manifest );
+         unlink( mpath );
+         free( mpath );
+         return NULL;
+      }
+      free( mpath );
+      return manifest;
+   }
+   FILE* manifest = fopen( mpath, "r" );
+   if ( manifest == NULL ) {
+      if ( errno == ENOENT ) {
+         LOG( LOG_INFO, "No object manifest exists for reference dir \"%s\"\n", refdirpath );
+         free( mpath );
+         errno = ENOENT;
+         return NULL;
+      }
+      LOG( LOG_ERR, "Failed to open manifest file \"%s\"\n", mpath );
+      free( mpath );
+      return NULL;
+   }
+   // the first line should hold the reference dir path, and the second the sweep time
+   char* readline = NULL;
+   size_t linealloc = 0;
+   ssize_t linelen = getline( &(readline), &(linealloc), manifest );
+   char matched = 0;
+   if ( linelen > 1  &&  readline[linelen - 1] == '\n' ) {
+      readline[linelen - 1] = '\0';
+      if ( strcmp( readline, refdirpath ) == 0 ) {
+         linelen = getline( &(readline), &(linealloc), manifest );
+         char* endptr = NULL;
+         if ( linelen > 1  &&  (long long)sweeptime == strtoll( readline, &(endptr), 10 )  &&  *endptr == '\n' ) {
+            matched = 1;
+         }
+      }
+   }
+   if ( readline ) { free( readline ); }
+   if ( !(matched) ) {
+      // this manifest is not associated with the given checkpoint
+      LOG( LOG_INFO, "Manifest file \"%s\" does not match the current checkpoint of reference dir \"%s\"\n",
+                     mpath, refdirpath );
+      fclose( manifest );
+      free( mpath );
+      errno = ENOENT;
+      return NULL;
+   }
+   free( mpath );
+   return manifest;
+}
+
+/**
+ * Close the given recorded object manifest
+ * NOTE -- replayed manifests should simply be closed via fclose()
+ * @param FILE* manifest : Manifest opened for recording
+ * @param const char* ckptdir : Checkpoint dir of the current NS
+ * @param size_t refindex : Index of the reference dir
+ * @param char commit : If non-zero, the manifest will atomically replace any previous manifest of the reference dir;
+ *                      if zero, the manifest will be discarded
+ * @return int : Zero on success, or -1 on failure ( the manifest will be discarded )
+ */
+int process_closemanifest( FILE* manifest, const char* ckptdir, size_t refindex, char commit ) {
+   // check for invalid args
+   if ( manifest == NULL  ||  ckptdir == NULL ) {
+      LOG( LOG_ERR, "Received an invalid arg\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   // any output failure will be reflected in the stream error state
+   char outputerror = ( ferror( manifest ) ) ? 1 : 0;
+   if ( fclose( manifest ) ) { outputerror = 1; }
+   char* mpath = checkpointpath( ckptdir, refindex, "-objects" );
+   char* tmppath = checkpointpath( ckptdir, refindex, "-objects.partial" );
+   if ( mpath == NULL  ||  tmppath == NULL ) {
+      LOG( LOG_ERR, "Failed to identify manifest paths for reference index %zu\n", refindex );
+      if ( mpath ) { free( mpath ); }
+      if ( tmppath ) { free( tmppath ); }
+      return -1;
+   }
+   if ( outputerror  ||  !(commit) ) {
+      unlink( tmppath );
+      free( tmppath );
+      free( mpath );
+      if ( outputerror ) {
+         LOG( LOG_ERR, "Failed to output content of manifest for reference index %zu\n", refindex );
+         return -1;
+      }
+      return 0;
+   }
+   // replace any previous manifest
+   if ( rename( tmppath, mpath ) ) {
+      LOG( LOG_ERR, "Failed to rename temporary manifest file \"%s\" to \"%s\"\n", tmppath, mpath );
+      unlink( tmppath );
+      free( tmppath );
+      free( mpath );
+      return -1;
+   }
+   free( tmppath );
+   free( mpath );
+   return 0;
+}
+
+/**
+ * Produce rebuild operations for objects of the given location from an object manifest
+ * NOTE -- each call produces a single operation, targeting a contiguous run of objects within one datastream
+ * @param FILE* manifest : Manifest opened for replay
+ * @param time_t rebuildthresh : Rebuild threshold value ( objects referenced by files more recent than this are ignored )
+ * @param const ne_location* rebuildloc : Location-based rebuild target
+ * @param opinfo** rebuildops : Reference to be populated with the generated rebuild operation
+ * @return int : 0, if the end of the manifest was reached and no new operations were generated;
+ *               1, if a new operation was generated;
+ *               -1, if a failure occurred
+ */
+int process_replaymanifest( FILE* manifest, time_t rebuildthresh, const ne_location* rebuildloc, opinfo** rebuildops ) {
+   // check for invalid args
+   if ( manifest == NULL  ||  rebuildloc == NULL  ||  rebuildops == NULL ) {
+      LOG( LOG_ERR, "Received an invalid arg\n" );
+      errno = EINVAL;
+      return -1;
+   }
+   opinfo* op = NULL;
+   char* readline = NULL;
+   size_t linealloc = 0;
+   while ( 1 ) {
+      long lineoffset = ftell( manifest );
+      ssize_t linelen = getline( &(readline), &(linealloc), manifest );
+      if ( linelen < 1 ) {
+         if ( feof( manifest ) ) { break; }
+         LOG( LOG_ERR, "Failed to read next line of manifest\n" );
+         if ( readline ) { free( readline ); }
+         if ( op ) { resourcelog_freeopinfo( op ); }
+         return -1;
+      }
+      long long ctimeval = 0;
+      int pod = 0;
+      int cap = 0;
+      int scatter = 0;
+      int tagoffset = 0;
+      if ( readline[linelen - 1] != '\n'  ||
+           sscanf( readline, "%lld %d %d %d %n", &(ctimeval), &(pod), &(cap), &(scatter), &(tagoffset) ) != 4  ||
+           tagoffset < 1 ) {
+         LOG( LOG_ERR, "Failed to parse manifest line: \"%s\"\n", readline );
+         free( readline );
+         if ( op ) { resourcelog_freeopinfo( op ); }
+         errno = EINVAL;
+         return -1;
+      }
+      readline[linelen - 1] = '\0';
+      // skip objects outside of our rebuild location, or referenced by files too recent to be rebuilt
+      if ( (time_t)ctimeval >= rebuildthresh  ||
+           (rebuildloc->pod >= 0  &&  rebuildloc->pod != pod)  ||
+           (rebuildloc->cap >= 0  &&  rebuildloc->cap != cap)  ||
+           (rebuildloc->scatter >= 0  &&  rebuildloc->scatter != scatter) ) {
+         continue;
+      }
+      FTAG ftag;
+      bzero( &(ftag), sizeof( FTAG ) );
+      if ( ftag_initstr( &(ftag), readline + tagoffset ) ) {
+         LOG( LOG_ERR, "Failed to parse FTAG of manifest line: \"%s\"\n", readline );
+         free( readline );
+         if ( op ) { resourcelog_freeopinfo( op ); }
+         errno = EINVAL;
+         return -1;
+      }
+      if ( op ) {
+         if ( ftag.objno == op->ftag.objno + op->count  &&
+              strcmp( ftag.streamid, op->ftag.streamid ) == 0  &&  strcmp( ftag.ctag, op->ftag.ctag ) == 0 ) {
+            // extend our existing op to include this object
+            op->count++;
+            free( ftag.ctag );
+            free( ftag.streamid );
+            continue;
+         }
+         // this object must be left for a subsequent op
+         free( ftag.ctag );
+         free( ftag.streamid );
+         if ( lineoffset < 0  ||  fseek( manifest, lineoffset, SEEK_SET ) ) {
+            LOG( LOG_ERR, "Failed to seek back to the start of a manifest line\n" );
+            free( readline );
+            resourcelog_freeopinfo( op );
+            return -1;
+         }
+         break;
+      }
+      // generate a new op for this object
+      // NOTE -- location-based rebuilds have no associated marker file or RTAG
+      op = calloc( 1, sizeof( struct opinfo_struct ) );
+      if ( op == NULL ) {
+         LOG( LOG_ERR, "Failed to allocate opinfo struct\n" );
+         free( ftag.ctag );
+         free( ftag.streamid );
+         free( readline );
+         return -1;
+      }
+      op->type = MARFS_REBUILD_OP;
+      op->extendedinfo = NULL;
+      op->start = 1;
+      op->count = 1;
+      op->errval = 0;
+      op->ftag = ftag;
+      op->next = NULL;
+   }
+   if ( readline ) { free( readline ); }
+   if ( op == NULL ) { return 0; }
+   *rebuildops = op;
+   return 1;
+}
+
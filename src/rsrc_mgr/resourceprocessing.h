@@ -77,6 +77,15 @@ typedef struct threshold_struct {
    // NOTE -- setting any of these values to zero will cause the corresponding operations to be skipped
 } thresholds;
 
+#define THROTTLE_OPTYPES ( MARFS_REPACK_OP + 1 )
+
+typedef struct throttle_limits_struct {
+   size_t oprate[THROTTLE_OPTYPES];   // per location op limit ( targeted objects per second ), indexed by op type
+   size_t byterate[THROTTLE_OPTYPES]; // per location bandwidth limit ( bytes per second ), indexed by op type
+   // NOTE -- setting any of these values to zero leaves the corresponding op type unlimited
+   // NOTE -- reference deletions are metadata-only, and are never throttled
+} throttle_limits;
+
 typedef struct streamwalker_report_struct {
    // quota info
    size_t fileusage;   // count of active files
@@ -99,8 +108,22 @@ typedef struct streamwalker_report_struct {
    size_t rbldbytes;  // count of rebuilt bytes
 } streamwalker_report;
 
+typedef struct refdir_checkpoint_struct {
+   // reference dir digest
+   struct timespec mtime; // modification time of the reference dir
+   nlink_t nlink;         // link count of the reference dir
+   off_t   size;          // reported size of the reference dir
+   // sweep info
+   time_t  sweeptime;     // time at which the reference dir sweep began
+   size_t  entries;       // count of entries encountered during the sweep
+   streamwalker_report report; // summed report of all datastreams beginning in the reference dir
+                               // NOTE -- only quota and stream info values are retained
+} refdir_checkpoint;
+
 // forward decls of internal types
 typedef struct repackstreamer_struct* REPACKSTREAMER;
+typedef struct repackpolicy_struct* REPACKPOLICY;
+typedef struct resourcethrottle_struct* RESOURCETHROTTLE;
 typedef struct streamwalker_struct* streamwalker;
 
 
@@ -141,6 +164,78 @@ int repackstreamer_complete( REPACKSTREAMER repackst );
  */
 int repackstreamer_abort( REPACKSTREAMER repackst );
 
+//   -------------   REPACKPOLICY FUNCTIONS    -------------
+
+/**
+ * Initialize a new repackpolicy
+ * NOTE -- A repackpolicy accumulates the repack candidates of every datastream walked, ranks them by the benefit of
+ *         repacking each ( dead bytes and objects reclaimed, per live byte rewritten ), and then schedules the most
+ *         beneficial candidates, up to a total byte budget.  The budget is shared by all passes using the policy.
+ * @param size_t budget : Total count of live bytes which may be scheduled for repack ( zero, if unlimited )
+ * @return REPACKPOLICY : New repackpolicy, or NULL on failure
+ */
+REPACKPOLICY repackpolicy_init( size_t budget );
+
+/**
+ * Submit the repack candidate of a single datastream to the given repackpolicy
+ * @param REPACKPOLICY policy : Repackpolicy to submit to
+ * @param opinfo* ops : Repack operations of the datastream
+ *                      NOTE -- the policy takes ownership of these ops, regardless of success or failure
+ * @param size_t livebytes : Count of live bytes to be rewritten by the ops
+ * @param size_t objcount : Count of objects to be freed by the ops
+ * @param size_t objcapacity : Data capacity of each object of the datastream
+ * @return int : Zero on success, or -1 on failure
+ */
+int repackpolicy_submit( REPACKPOLICY policy, opinfo* ops, size_t livebytes, size_t objcount, size_t objcapacity );
+
+/**
+ * Retrieve the most beneficial remaining repack candidate which fits within the remaining byte budget
+ * NOTE -- once no further candidate can be scheduled, all remaining candidates are discarded
+ * @param REPACKPOLICY policy : Repackpolicy to retrieve from
+ * @param opinfo** ops : Reference to be populated with the repack operations of the candidate
+ * @return int : 1, if a candidate was retrieved;
+ *               0, if no candidates remain to be scheduled;
+ *               -1, if a failure occurred
+ */
+int repackpolicy_next( REPACKPOLICY policy, opinfo** ops );
+
+/**
+ * Terminate the given repackpolicy, discarding any remaining candidates
+ * @param REPACKPOLICY policy : Repackpolicy to terminate
+ * @param size_t* spent : Reference to be populated with the count of budgeted bytes scheduled by the policy
+ *                        ( may be NULL )
+ * @return int : Zero on success, or -1 on failure
+ */
+int repackpolicy_term( REPACKPOLICY policy, size_t* spent );
+
+//   -------------   RESOURCETHROTTLE FUNCTIONS    -------------
+
+/**
+ * Initialize a new resourcethrottle
+ * NOTE -- A resourcethrottle maintains a token bucket for each op type at each storage location ( pod and cap ),
+ *         delaying operations which would exceed the configured limits of their location.
+ * @param const throttle_limits* limits : Limits to be enforced by the throttle
+ * @return RESOURCETHROTTLE : New resourcethrottle, or NULL on failure
+ */
+RESOURCETHROTTLE resourcethrottle_init( const throttle_limits* limits );
+
+/**
+ * Acquire the throttle allowance for a single object operation, waiting until the allowance is available
+ * @param RESOURCETHROTTLE throttle : Resourcethrottle to acquire from
+ * @param operation_type type : Type of the operation
+ * @param const ne_location* location : Location of the object targeted by the operation
+ * @param size_t bytes : Count of bytes to be transferred by the operation
+ * @return int : Zero on success, or -1 on failure
+ */
+int resourcethrottle_acquire( RESOURCETHROTTLE throttle, operation_type type, const ne_location* location, size_t bytes );
+
+/**
+ * Terminate the given resourcethrottle
+ * @param RESOURCETHROTTLE throttle : Resourcethrottle to terminate
+ * @return int : Zero on success, or -1 on failure
+ */
+int resourcethrottle_term( RESOURCETHROTTLE throttle );
+
 //   -------------   RESOURCE PROCESSING FUNCTIONS    -------------
 
 /**
@@ -179,6 +274,25 @@ opinfo* process_rebuildmarker( marfs_position* pos, char* markerpath, time_t reb
  */
 streamwalker process_openstreamwalker( marfs_position* pos, const char* reftgt, thresholds thresh, ne_location* rebuildloc );
 
+/**
+ * Attach an object manifest to the given streamwalker, to be populated with all objects referenced by live files
+ * NOTE -- this must be called prior to the first iteration of the walker
+ * @param streamwalker walker : Streamwalker to attach the manifest to
+ * @param FILE* manifest : Object manifest, opened for recording ( see process_openmanifest() )
+ * @return int : Zero on success, or -1 on failure
+ */
+int process_streamwalkermanifest( streamwalker walker, FILE* manifest );
+
+/**
+ * Attach a repackpolicy to the given streamwalker, to be submitted the repack candidate of the walked datastream
+ * NOTE -- this must be called prior to the first iteration of the walker.  A walker with an attached policy will
+ *         never directly produce repack operations; they must instead be retrieved via repackpolicy_next().
+ * @param streamwalker walker : Streamwalker to attach the policy to
+ * @param REPACKPOLICY policy : Repackpolicy to be submitted to
+ * @return int : Zero on success, or -1 on failure
+ */
+int process_streamwalkerpolicy( streamwalker walker, REPACKPOLICY policy );
+
 /**
  * Iterate over a datastream, accumulating quota values and identifying operation targets
  * NOTE -- This func will return all possible operations, given walker settings.  It is up to the caller whether those ops
@@ -193,6 +307,17 @@ streamwalker process_openstreamwalker( marfs_position* pos, const char* reftgt,
  */
 int process_iteratestreamwalker( streamwalker walker, opinfo** gcops, opinfo** repackops, opinfo** rebuildops );
 
+/**
+ * Check whether the given streamwalker traversed its entire datastream
+ * NOTE -- a traversal also halts at the first file which has yet to be finalized, in which case any objects
+ *         referenced by that file ( or by those following it ) will be absent from an attached manifest
+ * @param streamwalker walker : Streamwalker to be checked ( following an iteration result of zero )
+ * @return int : 1, if the walker reached the end of the datastream with every file finalized;
+ *               0, if the walker was halted by an unfinalized file;
+ *               -1, if a failure occurred
+ */
+int process_streamwalkerfinalized( streamwalker walker );
+
 /**
  * Close the given streamwalker
  * @param streamwalker walker : Streamwalker to be closed
@@ -208,11 +333,95 @@ int process_closestreamwalker( streamwalker walker, streamwalker_report* report
  *                     NOTE -- this will be updated to reflect operation completion / error
  * @param RESOURCELOG* log : Resource log to be updated with op completion / error
  * @param REPACKSTREAMER rpckstr : Repack streamer to be used for repack operations
+ * @param RESOURCETHROTTLE throttle : Throttle limiting the rate of object operations ( NULL, if unlimited )
  * @return int : Zero on success, or -1 on failure
  *               NOTE -- This func will not return 'failure' unless a critical internal error occurs.
  *                       'Standard' operation errors will simply be reflected in the op struct itself.
  */
-int process_executeoperation( marfs_position* pos, opinfo* op, RESOURCELOG* rlog, REPACKSTREAMER rpkstr );
+int process_executeoperation( marfs_position* pos, opinfo* op, RESOURCELOG* rlog, REPACKSTREAMER rpkstr,
+                              RESOURCETHROTTLE throttle );
+
+//   -------------   CHECKPOINT FUNCTIONS    -------------
+
+/**
+ * Populate a fresh checkpoint with the current digest values of the given reference dir
+ * @param marfs_position* pos : MarFS position of the NS containing the reference dir
+ * @param const char* refdirpath : Path of the reference dir
+ * @param refdir_checkpoint* ckpt : Reference to the checkpoint to be populated
+ *                                  NOTE -- all non-digest values will be zeroed
+ * @return int : Zero on success, or -1 on failure
+ */
+int process_refdirdigest( marfs_position* pos, const char* refdirpath, refdir_checkpoint* ckpt );
+
+/**
+ * Determine if the given checkpoint digests match ( reference dir is unchanged since the earlier sweep )
+ * @param const refdir_checkpoint* prevckpt : Checkpoint of a previous sweep
+ * @param const refdir_checkpoint* curckpt : Checkpoint with current digest values
+ * @return int : One if the digests match, or zero if not
+ */
+int process_refdirunchanged( const refdir_checkpoint* prevckpt, const refdir_checkpoint* curckpt );
+
+/**
+ * Read the checkpoint of a previous sweep of the given reference dir
+ * @param const char* ckptdir : Checkpoint dir of the current NS
+ * @param size_t refindex : Index of the reference dir
+ * @param const char* refdirpath : Path of the reference dir
+ * @param refdir_checkpoint* ckpt : Reference to the checkpoint to be populated
+ * @return int : Zero on success, One if no checkpoint exists for the reference dir, or -1 on failure
+ */
+int process_readcheckpoint( const char* ckptdir, size_t refindex, const char* refdirpath, refdir_checkpoint* ckpt );
+
+/**
+ * Record the checkpoint of a completed sweep of the given reference dir
+ * NOTE -- any previous checkpoint of the same reference dir will be atomically replaced
+ * @param const char* ckptdir : Checkpoint dir of the current NS
+ * @param size_t refindex : Index of the reference dir
+ * @param const char* refdirpath : Path of the reference dir
+ * @param const refdir_checkpoint* ckpt : Reference to the checkpoint to be recorded
+ * @return int : Zero on success, or -1 on failure
+ */
+int process_writecheckpoint( const char* ckptdir, size_t refindex, const char* refdirpath, const refdir_checkpoint* ckpt );
+
+/**
+ * Open the object manifest of the given reference dir
+ * NOTE -- A manifest lists the location of every object referenced by a live file of the datastreams beginning in
+ *         the reference dir.  It is only valid alongside the checkpoint of the same sweep, and allows a
+ *         location-based rebuild to skip walking those datastreams while the reference dir remains unchanged.
+ * @param const char* ckptdir : Checkpoint dir of the current NS
+ * @param size_t refindex : Index of the reference dir
+ * @param const char* refdirpath : Path of the reference dir
+ * @param time_t sweeptime : Sweep time of the checkpoint associated with the manifest
+ * @param char record : If non-zero, open a new manifest to be recorded ( see process_closemanifest() );
+ *                      if zero, open the existing manifest of the reference dir to be replayed
+ * @return FILE* : Open manifest, or NULL on failure
+ *                 NOTE -- errno will be set to ENOENT, if no applicable manifest exists to be replayed
+ */
+FILE* process_openmanifest( const char* ckptdir, size_t refindex, const char* refdirpath, time_t sweeptime, char record );
+
+/**
+ * Close the given recorded object manifest
+ * NOTE -- replayed manifests should simply be closed via fclose()
+ * @param FILE* manifest : Manifest opened for recording
+ * @param const char* ckptdir : Checkpoint dir of the current NS
+ * @param size_t refindex : Index of the reference dir
+ * @param char commit : If non-zero, the manifest will atomically replace any previous manifest of the reference dir;
+ *                      if zero, the manifest will be discarded
+ * @return int : Zero on success, or -1 on failure ( the manifest will be discarded )
+ */
+int process_closemanifest( FILE* manifest, const char* ckptdir, size_t refindex, char commit );
+
+/**
+ * Produce rebuild operations for objects of the given location from an object manifest
+ * NOTE -- each call produces a single operation, targeting a contiguous run of objects within one datastream
+ * @param FILE* manifest : Manifest opened for replay
+ * @param time_t rebuildthresh : Rebuild threshold value ( objects referenced by files more recent than this are ignored )
+ * @param const ne_location* rebuildloc : Location-based rebuild target
+ * @param opinfo** rebuildops : Reference to be populated with the generated rebuild operation
+ * @return int : 0, if the end of the manifest was reached and no new operations were generated;
+ *               1, if a new operation was generated;
+ *               -1, if a failure occurred
+ */
+int process_replaymanifest( FILE* manifest, time_t rebuildthresh, const ne_location* rebuildloc, opinfo** rebuildops );
 
 
 #endif // _RESOURCEPROCESSING_H
@@ -67,6 +67,14 @@ GNU licenses can be found at http://www.gnu.org/licenses/.
 #include <logging.h>
 
 #include "resourcethreads.h"
+#include "stats/stats.h"
+
+// DEL-OBJ work packages are sized to occupy a consumer thread for roughly this long
+#define GC_BATCH_TARGET_NS 1000000000ULL
+// object count of DEL-OBJ work packages, prior to any observed deletion latency
+#define GC_BATCH_INITIAL 16
+// maximum object count of a single DEL-OBJ work package
+#define GC_BATCH_MAX 4096
 
 
 //   -------------   RESOURCE INPUT FUNCTIONS    -------------
@@ -228,11 +236,12 @@ int resourceinput_setrange( RESOURCEINPUT* resourceinput, size_t start, size_t e
  * @param opinfo** nextop : Reference to be populated with a new op from an input logfile
  * @param MDAL_SCANNER* scanner : Reference to be populated with a new reference scanner
  * @param char** rdirpath : Reference to be populated with the path of a newly opened reference dir
+ * @param size_t* rdirindex : Reference to be populated with the index of a newly opened reference dir
  * @return int : Zero, if no inputs are currently available;
  *               One, if an input was produced;
  *               Ten, if the caller should prepare for termination ( resourceinput is preparing to be closed )
  */
-int resourceinput_getnext( RESOURCEINPUT* resourceinput, opinfo** nextop, MDAL_SCANNER* scanner, char** rdirpath ) {
+int resourceinput_getnext( RESOURCEINPUT* resourceinput, opinfo** nextop, MDAL_SCANNER* scanner, char** rdirpath, size_t* rdirindex ) {
    // check for valid ref
    if ( resourceinput == NULL  ||  *resourceinput == NULL ) {
       LOG( LOG_ERR, "Received an invalid resourceinput arg\n" );
@@ -303,6 +312,7 @@ int resourceinput_getnext( RESOURCEINPUT* resourceinput, opinfo** nextop, MDAL_S
    pthread_mutex_unlock( &(rin->lock) );
    *scanner = scanres;
    *rdirpath = node->name;
+   *rdirindex = (size_t)res;
    return 1;
 }
 
@@ -579,8 +589,126 @@ int resourceinput_abort( RESOURCEINPUT* resourceinput ) {
 }
 
 
+//   -------------   INTERNAL FUNCTIONS    -------------
+
+/**
+ * Begin accumulating a checkpoint for the reference dir just retrieved by the given producer thread,
+ *  or skip that reference dir entirely if it is unchanged since a sufficiently recent checkpoint
+ * NOTE -- checkpoint failures are never fatal, they just result in an untracked scan of the dir
+ * NOTE -- a location-based rebuild may only skip a reference dir if the object manifest of its previous
+ *         sweep is available, in which case that manifest will be replayed to produce rebuild ops
+ * @param rthread_state* tstate : State of the producer thread
+ * @return int : Zero if the reference dir should be scanned, or One if it was skipped ( scanner closed )
+ */
+int rthread_startcheckpoint( rthread_state* tstate ) {
+   rthread_global_state* gstate = tstate->gstate;
+   tstate->ckptactive = 0;
+   if ( gstate->ckptdir == NULL ) { return 0; }
+   // digest the current state of the reference dir, prior to scanning it
+   refdir_checkpoint curckpt;
+   if ( process_refdirdigest( &(gstate->pos), tstate->rdirpath, &(curckpt) ) ) {
+      LOG( LOG_WARNING, "Thread %u failed to digest reference dir \"%s\", so no checkpoint will be recorded\n",
+                        tstate->tID, tstate->rdirpath );
+      return 0;
+   }
+   curckpt.sweeptime = time( NULL );
+   // check for an applicable checkpoint from a previous sweep
+   refdir_checkpoint prevckpt;
+   int readres = process_readcheckpoint( gstate->ckptdir, tstate->rdirindex, tstate->rdirpath, &(prevckpt) );
+   if ( readres < 0 ) {
+      LOG( LOG_WARNING, "Thread %u failed to read previous checkpoint of reference dir \"%s\"\n",
+                        tstate->tID, tstate->rdirpath );
+   }
+   else if ( readres == 0  &&  prevckpt.sweeptime >= gstate->ckptthresh  &&
+             process_refdirunchanged( &(prevckpt), &(curckpt) ) ) {
+      if ( gstate->lbrebuild ) {
+         // a location-based rebuild may only skip this dir by replaying the manifest of the previous sweep
+         tstate->replay = process_openmanifest( gstate->ckptdir, tstate->rdirindex, tstate->rdirpath, prevckpt.sweeptime, 0 );
+         if ( tstate->replay == NULL ) {
+            LOG( LOG_INFO, "Thread %u has no object manifest for unchanged reference dir \"%s\", so it will be rescanned\n",
+                           tstate->tID, tstate->rdirpath );
+         }
+      }
+      if ( !(gstate->lbrebuild)  ||  tstate->replay ) {
+         LOG( LOG_INFO, "Thread %u is skipping unchanged reference dir \"%s\" ( carrying forward %zu streams )\n",
+                        tstate->tID, tstate->rdirpath, prevckpt.report.streamcount );
+         if ( gstate->pos.ns->prepo->metascheme.mdal->closescanner( tstate->scanner ) ) {
+            LOG( LOG_WARNING, "Thread %u failed to close scanner of skipped reference dir \"%s\"\n",
+                              tstate->tID, tstate->rdirpath );
+         }
+         tstate->scanner = NULL;
+         tstate->rdirpath = NULL;
+         // carry forward the quota and stream values of the previous sweep
+         tstate->report.fileusage   += prevckpt.report.fileusage;
+         tstate->report.byteusage   += prevckpt.report.byteusage;
+         tstate->report.filecount   += prevckpt.report.filecount;
+         tstate->report.objcount    += prevckpt.report.objcount;
+         tstate->report.bytecount   += prevckpt.report.bytecount;
+         tstate->report.streamcount += prevckpt.report.streamcount;
+         return 1;
+      }
+   }
+   tstate->ckpt = curckpt;
+   tstate->ckptactive = 1;
+   // record an object manifest, whenever our walks will already be pulling the necessary file xattrs
+   if ( gstate->thresh.gcthreshold  ||  gstate->thresh.repackthreshold  ||  gstate->lbrebuild ) {
+      tstate->manifest = process_openmanifest( gstate->ckptdir, tstate->rdirindex, tstate->rdirpath, curckpt.sweeptime, 1 );
+      if ( tstate->manifest == NULL ) {
+         LOG( LOG_WARNING, "Thread %u failed to open an object manifest for reference dir \"%s\"\n",
+                           tstate->tID, tstate->rdirpath );
+      }
+   }
+   return 0;
+}
+
+
 //   -------------   THREAD BEHAVIOR FUNCTIONS    -------------
 
+/**
+ * Identify the count of objects to be included in the next DEL-OBJ work package
+ * NOTE -- Packages are sized to occupy a consumer for roughly GC_BATCH_TARGET_NS, based upon
+ *         observed deletion latency.  However, while fewer packages are outstanding than there
+ *         are consumers, packages are capped to an even share of the remaining objects, so
+ *         that the work of a single large stream is still spread across all consumers.
+ * @param rthread_global_state* gstate : Global state of the resource threads
+ * @param size_t remaining : Count of objects remaining to be distributed
+ * @return size_t : Object count of the next work package
+ */
+size_t rthread_delobjbatch( rthread_global_state* gstate, size_t remaining ) {
+   size_t batch = GC_BATCH_INITIAL;
+   uint64_t objns = __atomic_load_n( &(gstate->delobjns), __ATOMIC_RELAXED );
+   if ( objns ) {
+      batch = ( objns >= GC_BATCH_TARGET_NS ) ? 1 : (size_t)( GC_BATCH_TARGET_NS / objns );
+      if ( batch > GC_BATCH_MAX ) { batch = GC_BATCH_MAX; }
+   }
+   size_t outstanding = __atomic_load_n( &(gstate->delobjpkgs), __ATOMIC_RELAXED );
+   if ( gstate->numconsthreads  &&  outstanding < gstate->numconsthreads ) {
+      size_t share = ( remaining + gstate->numconsthreads - 1 ) / gstate->numconsthreads;
+      if ( batch > share ) { batch = share; }
+   }
+   if ( batch > remaining ) { batch = remaining; }
+   if ( batch == 0 ) { batch = 1; }
+   return batch;
+}
+
+/**
+ * Note the completion of a DEL-OBJ work package, incorporating its latency into future package sizing
+ * @param rthread_global_state* gstate : Global state of the resource threads
+ * @param uint64_t start : Start timestamp of the package execution ( see stats_start() )
+ * @param size_t objcount : Count of objects deleted by the package ( zero, if none were attempted )
+ */
+void rthread_notedelobj( rthread_global_state* gstate, uint64_t start, size_t objcount ) {
+   __atomic_sub_fetch( &(gstate->delobjpkgs), 1, __ATOMIC_RELAXED );
+   if ( objcount == 0 ) { return; }
+   uint64_t sample = ( stats_start() - start ) / objcount;
+   if ( sample == 0 ) { sample = 1; }
+   // exponentially weighted moving average, favoring history
+   // NOTE -- an update lost to a concurrent completion is harmless, so no need for a CAS loop
+   uint64_t prev = __atomic_load_n( &(gstate->delobjns), __ATOMIC_RELAXED );
+   uint64_t avg = ( prev ) ? ( prev - (prev >> 3) + (sample >> 3) ) : sample;
+   __atomic_store_n( &(gstate->delobjns), (avg) ? avg : 1, __ATOMIC_RELAXED );
+}
+
 /**
  * Resource thread initialization ( producers and consumers )
  * NOTE -- see thread_queue.h in the erasureUtils repo for arg / return descriptions
@@ -613,6 +741,10 @@ int rthread_consumer_func( void** state, void** work_todo ) {
    opinfo* op = (opinfo*)(*work_todo);
    // execute operation
    if ( op ) {
+      // note DEL-OBJ package info prior to execution, which will free the op
+      char isdelobj = ( op->type == MARFS_DELETE_OBJ_OP );
+      size_t objcount = op->count;
+      uint64_t start = stats_start();
       if ( tstate->gstate->dryrun ) {
          LOG( LOG_INFO, "Thread %u is discarding ( DRY-RUN ) a %s operation on StreamID \"%s\"\n", tstate->tID,
               (op->type == MARFS_DELETE_OBJ_OP) ? "DEL-OBJ" :
@@ -620,6 +752,7 @@ int rthread_consumer_func( void** state, void** work_todo ) {
               (op->type == MARFS_REBUILD_OP)    ? "REBUILD" :
               (op->type == MARFS_REPACK_OP)     ? "REPACK"  : "UNKNOWN", op->ftag.streamid );
          resourcelog_freeopinfo( op );
+         if ( isdelobj ) { rthread_notedelobj( tstate->gstate, start, 0 ); }
       }
       else {
          LOG( LOG_INFO, "Thread %u is executing a %s operation on StreamID \"%s\"\n", tstate->tID,
@@ -627,7 +760,8 @@ int rthread_consumer_func( void** state, void** work_todo ) {
               (op->type == MARFS_DELETE_REF_OP) ? "DEL-REF" :
               (op->type == MARFS_REBUILD_OP)    ? "REBUILD" :
               (op->type == MARFS_REPACK_OP)     ? "REPACK"  : "UNKNOWN", op->ftag.streamid );
-         if ( process_executeoperation( &(tstate->gstate->pos), op, &(tstate->gstate->rlog), tstate->gstate->rpst ) ) {
+         if ( process_executeoperation( &(tstate->gstate->pos), op, &(tstate->gstate->rlog),
+                                        tstate->gstate->rpst, tstate->gstate->throttle ) ) {
             LOG( LOG_ERR, "Thread %u has encountered critical error during operation execution\n", tstate->tID );
             *work_todo = NULL;
             tstate->fatalerror = 1;
@@ -637,6 +771,7 @@ int rthread_consumer_func( void** state, void** work_todo ) {
             }
             return -1;
          }
+         if ( isdelobj ) { rthread_notedelobj( tstate->gstate, start, objcount ); }
       }
       *work_todo = NULL;
    }
@@ -669,11 +804,12 @@ int rthread_producer_func( void** state, void** work_tofill ) {
          }
          // NOTE -- object deletions always preceed reference deletions, so it should be safe to just check the first
          if ( tstate->gcops->type == MARFS_DELETE_OBJ_OP ) {
-            if ( tstate->gcops->count > 1 ) {
+            size_t batch = rthread_delobjbatch( tstate->gstate, tstate->gcops->count );
+            if ( tstate->gcops->count > batch ) {
                // temporarily strip our op chain down to a single DEL-OBJ op, followed by all reference deletions
                opinfo* orignext = tstate->gcops->next;
                tstate->gcops->next = refdel;
-               // split the object deletion op apart into multiple work packages
+               // split a batch of objects off of the deletion op, as a new work package
                newop = resourcelog_dupopinfo( tstate->gcops );
                // restore original op chain structure
                tstate->gcops->next = orignext;
@@ -684,10 +820,14 @@ int rthread_producer_func( void** state, void** work_tofill ) {
                   newop = tstate->gcops;
                   tstate->gcops = NULL; // remove state reference, so we don't repeat
                }
-               newop->count = 1; // set to a single object deletion
-               tstate->gcops->count--; // note one less op to distribute
-               delobj_info* delobjinf = (delobj_info*) tstate->gcops->extendedinfo;
-               delobjinf->offset++; // note to skip over one additional leading object
+               else {
+                  newop->count = batch; // set to a batch of object deletions
+                  tstate->gcops->count -= batch; // note fewer ops to distribute
+                  delobj_info* delobjinf = (delobj_info*) tstate->gcops->extendedinfo;
+                  delobjinf->offset += batch; // note to skip over the batched leading objects
+                  LOG( LOG_INFO, "Thread %u split a batch of %zu object deletions from StreamID \"%s\" ( %zu remain )\n",
+                       tstate->tID, batch, newop->ftag.streamid, tstate->gcops->count );
+               }
             }
             else {
                // check if we have additional ops between the lead op and the first ref del op
@@ -777,6 +917,15 @@ int rthread_producer_func( void** state, void** work_tofill ) {
          }
          if ( walkres == 0 ) { // check for end of stream
             LOG( LOG_INFO, "Thread %u has reached the end of a datastream\n", tstate->tID );
+            // a manifest is only valid if every stream of the reference dir was walked in its entirety
+            //    NOTE -- finalizing a file does not modify its reference dir, so a manifest missing the objects of
+            //            an unfinalized file would otherwise be replayed by every subsequent location-based rebuild
+            char discardmanifest = 0;
+            if ( tstate->manifest  &&  process_streamwalkerfinalized( tstate->walker ) != 1 ) {
+               LOG( LOG_INFO, "Thread %u walked a datastream with unfinalized files, so the object manifest of "
+                              "reference dir \"%s\" will be discarded\n", tstate->tID, tstate->rdirpath );
+               discardmanifest = 1;
+            }
             streamwalker_report tmpreport = {0};
             if ( process_closestreamwalker( tstate->walker, &(tmpreport) ) ) {
                LOG( LOG_ERR, "Thread %u failed to close a streamwalker\n", tstate->tID );
@@ -790,6 +939,10 @@ int rthread_producer_func( void** state, void** work_tofill ) {
                return -1;
             }
             tstate->walker = NULL;
+            if ( discardmanifest ) {
+               process_closemanifest( tstate->manifest, tstate->gstate->ckptdir, tstate->rdirindex, 0 );
+               tstate->manifest = NULL;
+            }
             tstate->report.fileusage   += tmpreport.fileusage;
             tstate->report.byteusage   += tmpreport.byteusage;
             tstate->report.filecount   += tmpreport.filecount;
@@ -804,6 +957,54 @@ int rthread_producer_func( void** state, void** work_tofill ) {
             tstate->report.rpckbytes   += tmpreport.rpckbytes;
             tstate->report.rbldobjs    += tmpreport.rbldobjs;
             tstate->report.rbldbytes   += tmpreport.rbldbytes;
+            if ( tstate->ckptactive ) {
+               // note the values of this stream in the checkpoint of its starting reference dir
+               tstate->ckpt.report.fileusage   += tmpreport.fileusage;
+               tstate->ckpt.report.byteusage   += tmpreport.byteusage;
+               tstate->ckpt.report.filecount   += tmpreport.filecount;
+               tstate->ckpt.report.objcount    += tmpreport.objcount;
+               tstate->ckpt.report.bytecount   += tmpreport.bytecount;
+               tstate->ckpt.report.streamcount += tmpreport.streamcount;
+            }
+         }
+      }
+      else if ( tstate->replay ) {
+         // produce rebuild ops from the object manifest of an unchanged reference dir, in place of walking its streams
+         int replayres = process_replaymanifest( tstate->replay, tstate->gstate->thresh.rebuildthreshold,
+                                                 &(tstate->gstate->rebuildloc), &(newop) );
+         if ( replayres < 0 ) {
+            LOG( LOG_ERR, "Thread %u failed to replay an object manifest of NS \"%s\"\n",
+                          tstate->tID, tstate->gstate->pos.ns->idstr );
+            snprintf( tstate->errorstr, MAX_STR_BUFFER,
+                      "Thread %u failed to replay an object manifest of NS \"%s\"\n",
+                      tstate->tID, tstate->gstate->pos.ns->idstr );
+            tstate->fatalerror = 1;
+            // ensure termination of all other threads ( avoids possible deadlock )
+            if ( resourceinput_purge( &(tstate->gstate->rinput), 1 ) ) {
+               LOG( LOG_WARNING, "Failed to purge resource input following fatal error\n" );
+            }
+            return -1;
+         }
+         if ( replayres == 0 ) {
+            LOG( LOG_INFO, "Thread %u has finished replay of an object manifest\n", tstate->tID );
+            fclose( tstate->replay );
+            tstate->replay = NULL;
+         }
+         else {
+            tstate->report.rbldobjs += newop->count;
+            // log the new operation, before we distribute it
+            if ( resourcelog_processop( &(tstate->gstate->rlog), newop, NULL ) ) {
+               LOG( LOG_ERR, "Thread %u failed to log start of a manifest REBUILD operation\n", tstate->tID );
+               snprintf( tstate->errorstr, MAX_STR_BUFFER,
+                         "Thread %u failed to log start of a manifest REBUILD operation\n", tstate->tID );
+               resourcelog_freeopinfo( newop );
+               tstate->fatalerror = 1;
+               // ensure termination of all other threads ( avoids possible deadlock )
+               if ( resourceinput_purge( &(tstate->gstate->rinput), 1 ) ) {
+                  LOG( LOG_WARNING, "Failed to purge resource input following fatal error\n" );
+               }
+               return -1;
+            }
          }
       }
       else if ( tstate->scanner ) {
@@ -811,8 +1012,24 @@ int rthread_producer_func( void** state, void** work_tofill ) {
          char* reftgt = NULL;
          ssize_t tgtval = 0;
          int scanres = process_refdir( tstate->gstate->pos.ns, tstate->scanner, tstate->rdirpath, &(reftgt), &(tgtval) );
+         if ( scanres > 0 ) { tstate->ckpt.entries++; }
          if ( scanres == 0 ) {
             LOG( LOG_INFO, "Thread %u has finished scan of reference dir \"%s\"\n", tstate->tID, tstate->rdirpath );
+            if ( tstate->ckptactive ) {
+               // all streams beginning in this dir have been walked, so record our manifest and checkpoint
+               if ( tstate->manifest ) {
+                  if ( process_closemanifest( tstate->manifest, tstate->gstate->ckptdir, tstate->rdirindex, 1 ) ) {
+                     LOG( LOG_WARNING, "Thread %u failed to record object manifest of reference dir \"%s\"\n",
+                                       tstate->tID, tstate->rdirpath );
+                  }
+                  tstate->manifest = NULL;
+               }
+               if ( process_writecheckpoint( tstate->gstate->ckptdir, tstate->rdirindex, tstate->rdirpath, &(tstate->ckpt) ) ) {
+                  LOG( LOG_WARNING, "Thread %u failed to record checkpoint of reference dir \"%s\"\n",
+                                    tstate->tID, tstate->rdirpath );
+               }
+               tstate->ckptactive = 0;
+            }
             // NULL out our dir references, just in case
             tstate->scanner = NULL;
             tstate->rdirpath = NULL;
@@ -837,6 +1054,24 @@ int rthread_producer_func( void** state, void** work_tofill ) {
                }
                return -1;
             }
+            if ( tstate->manifest  &&  process_streamwalkermanifest( tstate->walker, tstate->manifest ) ) {
+               LOG( LOG_WARNING, "Thread %u failed to attach an object manifest to a streamwalker, so none will be recorded\n",
+                                 tstate->tID );
+               process_closemanifest( tstate->manifest, tstate->gstate->ckptdir, tstate->rdirindex, 0 );
+               tstate->manifest = NULL;
+            }
+            if ( tstate->gstate->rpolicy  &&  process_streamwalkerpolicy( tstate->walker, tstate->gstate->rpolicy ) ) {
+               LOG( LOG_ERR, "Thread %u failed to attach the repack policy to a streamwalker\n", tstate->tID );
+               snprintf( tstate->errorstr, MAX_STR_BUFFER,
+                         "Thread %u failed to attach the repack policy to a streamwalker\n", tstate->tID );
+               tstate->fatalerror = 1;
+               if ( reftgt ) { free( reftgt ); }
+               // ensure termination of all other threads ( avoids possible deadlock )
+               if ( resourceinput_purge( &(tstate->gstate->rinput), 1 ) ) {
+                  LOG( LOG_WARNING, "Failed to purge resource input following fatal error\n" );
+               }
+               return -1;
+            }
             tstate->streamcount++;
          }
          else if ( scanres == 2 ) { // rebuild marker file
@@ -905,10 +1140,37 @@ int rthread_producer_func( void** state, void** work_tofill ) {
          // free temporary reference target string
          if ( reftgt ) { free( reftgt ); }
       }
+      else if ( tstate->rpckdrain ) {
+         // schedule the most beneficial repack candidates of the NS, now that all streams have been walked
+         // NOTE -- the resource input may be destroyed at any point after its termination, so is never purged here
+         int polres = repackpolicy_next( tstate->gstate->rpolicy, &(newop) );
+         if ( polres < 0 ) {
+            LOG( LOG_ERR, "Thread %u failed to retrieve the next repack candidate of NS \"%s\"\n",
+                          tstate->tID, tstate->gstate->pos.ns->idstr );
+            snprintf( tstate->errorstr, MAX_STR_BUFFER,
+                      "Thread %u failed to retrieve the next repack candidate of NS \"%s\"\n",
+                      tstate->tID, tstate->gstate->pos.ns->idstr );
+            tstate->fatalerror = 1;
+            return -1;
+         }
+         if ( polres == 0 ) {
+            LOG( LOG_INFO, "Thread %u is signaling FINISHED state\n", tstate->tID );
+            return 1;
+         }
+         // log the new operation, before we distribute it
+         if ( resourcelog_processop( &(tstate->gstate->rlog), newop, NULL ) ) {
+            LOG( LOG_ERR, "Thread %u failed to log start of a REPACK operation\n", tstate->tID );
+            snprintf( tstate->errorstr, MAX_STR_BUFFER,
+                      "Thread %u failed to log start of a REPACK operation\n", tstate->tID );
+            resourcelog_freeopinfo( newop );
+            tstate->fatalerror = 1;
+            return -1;
+         }
+      }
       else {
          // pull from our resource input reference
          int inputres = 0;
-         while ( (inputres = resourceinput_getnext( &(tstate->gstate->rinput), &(newop), &(tstate->scanner), &(tstate->rdirpath) )) == 0 ) {
+         while ( (inputres = resourceinput_getnext( &(tstate->gstate->rinput), &(newop), &(tstate->scanner), &(tstate->rdirpath), &(tstate->rdirindex) )) == 0 ) {
             // wait until inputs are available
             LOG( LOG_INFO, "Thread %u is waiting for inputs\n", tstate->tID );
             if ( resourceinput_waitforupdate( &(tstate->gstate->rinput) ) ) {
@@ -939,6 +1201,12 @@ int rthread_producer_func( void** state, void** work_tofill ) {
                }
                return -1;
             }
+            if ( tstate->gstate->rpolicy ) {
+               // all producers have completed their walks, so begin scheduling repack candidates
+               LOG( LOG_INFO, "Thread %u is scheduling repack candidates\n", tstate->tID );
+               tstate->rpckdrain = 1;
+               continue;
+            }
             LOG( LOG_INFO, "Thread %u is signaling FINISHED state\n", tstate->tID );
             return 1;
          }
@@ -956,6 +1224,10 @@ int rthread_producer_func( void** state, void** work_tofill ) {
             }
             return -1;
          }
+         // check if a newly opened reference dir can be skipped, based on a previous checkpoint
+         if ( tstate->scanner  &&  rthread_startcheckpoint( tstate ) ) {
+            LOG( LOG_INFO, "Thread %u skipped reference dir %zu\n", tstate->tID, tstate->rdirindex );
+         }
       }
    }
    LOG( LOG_INFO, "Thread %u dispatching a %s%s operation on StreamID \"%s\"\n", tstate->tID,
@@ -968,6 +1240,8 @@ int rthread_producer_func( void** state, void** work_tofill ) {
         (newop->next->type == MARFS_DELETE_REF_OP) ? " + DEL-REF" :
         (newop->next->type == MARFS_REBUILD_OP)    ? " + REBUILD" :
         (newop->next->type == MARFS_REPACK_OP)     ? " + REPACK"  : " + UNKNOWN", newop->ftag.streamid );
+   // track outstanding DEL-OBJ packages, for use in sizing subsequent packages
+   if ( newop->type == MARFS_DELETE_OBJ_OP ) { __atomic_add_fetch( &(tstate->gstate->delobjpkgs), 1, __ATOMIC_RELAXED ); }
    // actually populate our work package
    *work_tofill = (void*)newop;
    return 0;
@@ -1007,6 +1281,22 @@ void rthread_term_func( void** state, void** prev_work, TQ_Control_Flags flg ) {
          tstate->fatalerror = 1;
       }
    }
+   if ( tstate->manifest ) {
+      LOG( LOG_INFO, "Thread %u is discarding an incomplete object manifest\n", tstate->tID );
+      process_closemanifest( tstate->manifest, tstate->gstate->ckptdir, tstate->rdirindex, 0 );
+      tstate->manifest = NULL;
+   }
+   if ( tstate->replay ) {
+      LOG( LOG_ERR, "Thread %u is closing a partially replayed object manifest\n", tstate->tID );
+      fclose( tstate->replay );
+      tstate->replay = NULL;
+      // this is non-standard, so ensure we note an error
+      if ( !(tstate->fatalerror) ) {
+         snprintf( tstate->errorstr, MAX_STR_BUFFER,
+                   "Thread %u held a partially replayed object manifest at termination\n", tstate->tID );
+         tstate->fatalerror = 1;
+      }
+   }
    // merely note termination ( state struct itself will be freed by master proc )
    LOG( LOG_INFO, "Thread %u is terminating\n", tstate->tID );
 }
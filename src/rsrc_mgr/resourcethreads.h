@@ -95,8 +95,18 @@ typedef struct rthread_global_state_struct {
    RESOURCEINPUT   rinput;
    RESOURCELOG     rlog;
    REPACKSTREAMER  rpst;
+   REPACKPOLICY    rpolicy;    // ranks and budgets repack candidates ( NULL, if ops are dispatched as walked )
+   RESOURCETHROTTLE throttle;  // limits the rate of object operations per location ( NULL, if unlimited )
    unsigned int    numprodthreads;
    unsigned int    numconsthreads;
+
+   // Checkpoint Values
+   char*           ckptdir;    // checkpoint dir of the current NS ( NULL, if checkpointing is disabled )
+   time_t          ckptthresh; // reference dirs last swept prior to this time will always be rescanned
+
+   // GC Batching Values ( should be zeroed prior to thread startup )
+   uint64_t        delobjns;   // moving average latency of a single object deletion, in nanoseconds
+   size_t          delobjpkgs; // count of DEL-OBJ work packages currently queued or executing
 } rthread_global_state;
 
 typedef struct rthread_state_struct {
@@ -111,6 +121,13 @@ typedef struct rthread_state_struct {
    streamwalker  walker;
    opinfo*       gcops;
    opinfo*       repackops;
+   char          rpckdrain;   // flag indicating that input is complete, and repack candidates are being scheduled
+   // producer thread checkpoint state
+   size_t        rdirindex;   // index of the reference dir being scanned
+   char          ckptactive;  // flag indicating that a checkpoint is being accumulated for the scan
+   refdir_checkpoint ckpt;
+   FILE*         manifest;    // object manifest being recorded alongside the checkpoint ( NULL, if none )
+   FILE*         replay;      // object manifest being replayed in place of a scan ( NULL, if none )
    // producer thread totals
    size_t        streamcount;
    streamwalker_report report;
@@ -153,11 +170,12 @@ int resourceinput_setrange( RESOURCEINPUT* resourceinput, size_t start, size_t e
  * @param opinfo** nextop : Reference to be populated with a new op from an input logfile
  * @param MDAL_SCANNER* scanner : Reference to be populated with a new reference scanner
  * @param char** rdirpath : Reference to be populated with the path of a newly opened reference dir
+ * @param size_t* rdirindex : Reference to be populated with the index of a newly opened reference dir
  * @return int : Zero, if no inputs are currently available;
  *               One, if an input was produced;
  *               Ten, if the caller should prepare for termination ( resourceinput is preparing to be closed )
  */
-int resourceinput_getnext( RESOURCEINPUT* resourceinput, opinfo** nextop, MDAL_SCANNER* scanner, char** rdirpath );
+int resourceinput_getnext( RESOURCEINPUT* resourceinput, opinfo** nextop, MDAL_SCANNER* scanner, char** rdirpath, size_t* rdirindex );
 
 /**
  * Destroy all available inputs and signal threads to prepare or for imminent termination
@@ -643,7 +643,8 @@ int walk_stream(const marfs_ms* ms, const marfs_ds* ds, MDAL_CTXT ctxt, char** r
     .majorversion = RECOVERY_CURRENT_MAJORVERSION,
     .minorversion = RECOVERY_CURRENT_MINORVERSION,
     .ctag = ftag.ctag,
-    .streamid = ftag.streamid
+    .streamid = ftag.streamid,
+    .compression = ftag.compression
   };
   size_t headerlen;
   if ((headerlen = recovery_headertostr(&(header), NULL, 0)) < 1) {
@@ -179,6 +179,7 @@ int main(int argc, char **argv)
    opparse->ftag.minorversion = FTAG_CURRENT_MINORVERSION;
    opparse->ftag.objfiles = 4;
    opparse->ftag.objsize = 1024;
+   opparse->ftag.compression = FTAG_COMPRESS_NONE;
    opparse->ftag.refbreadth = 10;
    opparse->ftag.refdepth = 9;
    opparse->ftag.refdigits = 32;
@@ -622,6 +623,36 @@ int main(int argc, char **argv)
 //      return -1;
 //   }
 
+   // insert, then complete, deletion ops across many concurrent streams
+   char* origstreamid = opset->ftag.streamid;
+   char streamidbuf[64];
+   opset->ftag.streamid = streamidbuf;
+   opset->next = NULL;
+   opset->count = 1;
+   int streamindex;
+   for ( streamindex = 0; streamindex < 5000; streamindex++ ) {
+      snprintf( streamidbuf, 64, "concurrentstream%d", streamindex );
+      opset->start = 1;
+      if ( resourcelog_processop( &(wlog), opset, NULL ) ) {
+         printf( "failed to insert deletion op start for stream %d\n", streamindex );
+         return -1;
+      }
+   }
+   for ( streamindex = 4999; streamindex >= 0; streamindex-- ) {
+      snprintf( streamidbuf, 64, "concurrentstream%d", streamindex );
+      opset->start = 0;
+      progress = 0;
+      if ( resourcelog_processop( &(wlog), opset, &(progress) ) ) {
+         printf( "failed to insert deletion op completion for stream %d\n", streamindex );
+         return -1;
+      }
+      if ( !(progress) ) {
+         printf( "deletion op completion for stream %d failed to set 'progress' flag\n", streamindex );
+         return -1;
+      }
+   }
+   opset->ftag.streamid = origstreamid;
+
    free( wlogpath );
 
    // free all operations
@@ -326,6 +326,64 @@ int main(int argc, char **argv)
    }
 
 
+   // a manifest recorded while 'file3' remains unfinalized must not be committed
+   if ( mkdir( "./test_rman_topdir/ckpt_root", S_IRWXU )  &&  errno != EEXIST ) {
+      printf( "Failed to create checkpoint root\n" );
+      return -1;
+   }
+   FILE* manifest = process_openmanifest( "./test_rman_topdir/ckpt_root", 0, "manifestref/", 12345, 1 );
+   if ( manifest == NULL ) {
+      printf( "failed to open manifest for recording of unfinalized stream\n" );
+      return -1;
+   }
+   struct timeval currenttime;
+   if ( gettimeofday( &currenttime, NULL ) ) {
+      printf( "failed to get current time for unfinalized walk\n" );
+      return -1;
+   }
+   thresholds thresh = {
+      .gcthreshold = 0,
+      .repackthreshold = 0,
+      .rebuildthreshold = currenttime.tv_sec + 120,
+      .cleanupthreshold = 0
+   };
+   ne_location anyloc = { .pod = -1, .cap = -1, .scatter = -1 };
+   streamwalker walker = process_openstreamwalker( &pos, rpath, thresh, &(anyloc) );
+   if ( walker == NULL  ||  process_streamwalkermanifest( walker, manifest ) ) {
+      printf( "failed to open manifest streamwalker for unfinalized stream\n" );
+      return -1;
+   }
+   opinfo* gcops = NULL;
+   opinfo* repackops = NULL;
+   opinfo* rebuildops = NULL;
+   int walkres = 0;
+   while ( (walkres = process_iteratestreamwalker( walker, &(gcops), &(repackops), &(rebuildops) )) > 0 ) {
+      resourcelog_freeopinfo( rebuildops );
+      rebuildops = NULL;
+   }
+   if ( walkres ) {
+      printf( "failed iteration of unfinalized stream\n" );
+      return -1;
+   }
+   if ( process_streamwalkerfinalized( walker ) != 0 ) {
+      printf( "walk of unfinalized stream was reported as complete\n" );
+      return -1;
+   }
+   if ( process_closestreamwalker( walker, NULL ) ) {
+      printf( "failed to close walker of unfinalized stream\n" );
+      return -1;
+   }
+   if ( process_closemanifest( manifest, "./test_rman_topdir/ckpt_root", 0, 0 ) ) {
+      printf( "failed to discard manifest of unfinalized stream\n" );
+      return -1;
+   }
+   errno = 0;
+   if ( process_openmanifest( "./test_rman_topdir/ckpt_root", 0, "manifestref/", 12345, 0 )  ||  errno != ENOENT ) {
+      printf( "unexpected result of opening a discarded manifest\n" );
+      return -1;
+   }
+
+
    // close the stream
    if ( datastream_close( &(stream) ) ) {
       printf( "close failure for no-pack\n" );
@@ -334,25 +392,23 @@ int main(int argc, char **argv)
 
 
    // walk the produced datastream
-   struct timeval currenttime;
    if ( gettimeofday( &currenttime, NULL ) ) {
       printf( "failed to get current time for first walk\n" );
       return -1;
    }
-   thresholds thresh = { // set thresholds to 2min in the future
-      .gcthreshold = currenttime.tv_sec + 120,
-      .repackthreshold = currenttime.tv_sec + 120,
-      .rebuildthreshold = 0, // no rebuilds for now
-      .cleanupthreshold = currenttime.tv_sec + 120
-   };
-   streamwalker walker = process_openstreamwalker( &pos, rpath, thresh, NULL );
+   // set thresholds to 2min in the future
+   thresh.gcthreshold = currenttime.tv_sec + 120;
+   thresh.repackthreshold = currenttime.tv_sec + 120;
+   thresh.rebuildthreshold = 0; // no rebuilds for now
+   thresh.cleanupthreshold = currenttime.tv_sec + 120;
+   walker = process_openstreamwalker( &pos, rpath, thresh, NULL );
    if ( walker == NULL ) {
       printf( "failed to open streamwalker for \"%s\"\n", rpath );
       return -1;
    }
-   opinfo* gcops = NULL;
-   opinfo* repackops = NULL;
-   opinfo* rebuildops = NULL;
+   gcops = NULL;
+   repackops = NULL;
+   rebuildops = NULL;
    if ( process_iteratestreamwalker( walker, &(gcops), &(repackops), &(rebuildops) ) ) {
       printf( "unexpected result of first iteration from \"%s\"\n", rpath );
       return -1;
@@ -475,6 +531,120 @@ int main(int argc, char **argv)
    }
 
 
+   // now that 'file3' is finalized, perform a location-based rebuild walk, recording an object manifest
+   manifest = process_openmanifest( "./test_rman_topdir/ckpt_root", 0, "manifestref/", 12345, 1 );
+   if ( manifest == NULL ) {
+      printf( "failed to open manifest for recording\n" );
+      return -1;
+   }
+   thresh.rebuildthreshold = currenttime.tv_sec + 120;
+   walker = process_openstreamwalker( &pos, rpath, thresh, &(objlocation3) );
+   if ( walker == NULL ) {
+      printf( "failed to open rebuild streamwalker for \"%s\"\n", rpath );
+      return -1;
+   }
+   if ( process_streamwalkermanifest( walker, manifest ) ) {
+      printf( "failed to attach manifest to rebuild streamwalker\n" );
+      return -1;
+   }
+   size_t rbldcount = 0;
+   while ( (walkres = process_iteratestreamwalker( walker, &(gcops), &(repackops), &(rebuildops) )) > 0 ) {
+      // we should only have location-based rebuild ops
+      if ( gcops  ||  repackops  ||  rebuildops == NULL ) {
+         printf( "unexpected ops following rebuild iteration of no-pack stream\n" );
+         return -1;
+      }
+      opinfo* parseop = rebuildops;
+      while ( parseop ) {
+         if ( parseop->type != MARFS_REBUILD_OP  ||  parseop->extendedinfo ) {
+            printf( "unexpected op following rebuild iteration of no-pack stream\n" );
+            return -1;
+         }
+         rbldcount += parseop->count;
+         parseop = parseop->next;
+      }
+      resourcelog_freeopinfo( rebuildops );
+      rebuildops = NULL;
+   }
+   if ( walkres ) {
+      printf( "failed rebuild iteration of no-pack stream\n" );
+      return -1;
+   }
+   if ( process_streamwalkerfinalized( walker ) != 1 ) {
+      printf( "walk of finalized no-pack stream was reported as incomplete\n" );
+      return -1;
+   }
+   if ( process_closestreamwalker( walker, &(walkreport) ) ) {
+      printf( "failed to close rebuild walker\n" );
+      return -1;
+   }
+   if ( rbldcount < 1  ||  rbldcount != walkreport.rbldobjs  ||  walkreport.fileusage != 3 ) {
+      printf( "improper rebuild walk counts: %zu ops / %zu rbldobjs / %zu fileusage\n",
+              rbldcount, walkreport.rbldobjs, walkreport.fileusage );
+      return -1;
+   }
+   if ( process_closemanifest( manifest, "./test_rman_topdir/ckpt_root", 0, 1 ) ) {
+      printf( "failed to commit recorded manifest\n" );
+      return -1;
+   }
+   // a manifest should only be replayed alongside the checkpoint of the same sweep
+   errno = 0;
+   if ( process_openmanifest( "./test_rman_topdir/ckpt_root", 0, "manifestref/", 54321, 0 )  ||  errno != ENOENT ) {
+      printf( "unexpected result of opening a manifest of a different sweep\n" );
+      return -1;
+   }
+   // replay of the manifest should produce the same rebuild targets as the walk
+   manifest = process_openmanifest( "./test_rman_topdir/ckpt_root", 0, "manifestref/", 12345, 0 );
+   if ( manifest == NULL ) {
+      printf( "failed to open manifest for replay\n" );
+      return -1;
+   }
+   size_t replaycount = 0;
+   while ( (walkres = process_replaymanifest( manifest, thresh.rebuildthreshold, &(objlocation3), &(rebuildops) )) > 0 ) {
+      if ( rebuildops->type != MARFS_REBUILD_OP  ||  rebuildops->next ) {
+         printf( "unexpected op following manifest replay\n" );
+         return -1;
+      }
+      replaycount += rebuildops->count;
+      resourcelog_freeopinfo( rebuildops );
+      rebuildops = NULL;
+   }
+   fclose( manifest );
+   if ( walkres  ||  replaycount != rbldcount ) {
+      printf( "improper manifest replay count: %zu\n", replaycount );
+      return -1;
+   }
+   // ...while an unrestricted location should target every live object ( including those of 'file3' )
+   manifest = process_openmanifest( "./test_rman_topdir/ckpt_root", 0, "manifestref/", 12345, 0 );
+   if ( manifest == NULL ) {
+      printf( "failed to reopen manifest for replay\n" );
+      return -1;
+   }
+   replaycount = 0;
+   while ( (walkres = process_replaymanifest( manifest, thresh.rebuildthreshold, &(anyloc), &(rebuildops) )) > 0 ) {
+      replaycount += rebuildops->count;
+      resourcelog_freeopinfo( rebuildops );
+      rebuildops = NULL;
+   }
+   fclose( manifest );
+   if ( walkres  ||  replaycount != 23 ) {
+      printf( "improper unrestricted manifest replay count: %zu\n", replaycount );
+      return -1;
+   }
+   // ...and an old threshold should target nothing at all
+   manifest = process_openmanifest( "./test_rman_topdir/ckpt_root", 0, "manifestref/", 12345, 0 );
+   if ( manifest == NULL  ||  process_replaymanifest( manifest, 1, &(anyloc), &(rebuildops) ) ) {
+      printf( "unexpected result of manifest replay with an old threshold\n" );
+      return -1;
+   }
+   fclose( manifest );
+   if ( unlink( "./test_rman_topdir/ckpt_root/refdir-0-objects" )  ||  rmdir( "./test_rman_topdir/ckpt_root" ) ) {
+      printf( "Failed to cleanup manifest\n" );
+      return -1;
+   }
+   thresh.rebuildthreshold = 0;
+
+
 
    // start up a resourcelog
    RESOURCELOG logfile = NULL;
@@ -530,7 +700,7 @@ int main(int argc, char **argv)
    }
    // process the gcops
    // TODO repackstreamer
-   if ( process_executeoperation( &(pos), gcops, &(logfile), NULL ) ) {
+   if ( process_executeoperation( &(pos), gcops, &(logfile), NULL, NULL ) ) {
       printf( "failed to process first gc op of nopack\n" );
       return -1;
    }
@@ -660,7 +830,7 @@ int main(int argc, char **argv)
    }
    // process the gcops
    // TODO repackstreamer
-   if ( process_executeoperation( &(pos), gcops, &(logfile), NULL ) ) {
+   if ( process_executeoperation( &(pos), gcops, &(logfile), NULL, NULL ) ) {
       printf( "failed to process second gc op of nopack\n" );
       return -1;
    }
@@ -750,7 +920,7 @@ int main(int argc, char **argv)
    }
    // process the gcops
    // TODO repackstreamer
-   if ( process_executeoperation( &(pos), gcops, &(logfile), NULL ) ) {
+   if ( process_executeoperation( &(pos), gcops, &(logfile), NULL, NULL ) ) {
       printf( "failed to process third gc op of nopack\n" );
       return -1;
    }
@@ -1269,7 +1439,7 @@ int main(int argc, char **argv)
    }
    // process the gcops
    // TODO repackstreamer
-   if ( process_executeoperation( &(pos), gcops, &(logfile), NULL ) ) {
+   if ( process_executeoperation( &(pos), gcops, &(logfile), NULL, NULL ) ) {
       printf( "failed to process third gc op of pack\n" );
       return -1;
    }
@@ -1382,7 +1552,7 @@ int main(int argc, char **argv)
    }
    // process the gcops
    // TODO repackstreamer
-   if ( process_executeoperation( &(pos), gcops, &(logfile), NULL ) ) {
+   if ( process_executeoperation( &(pos), gcops, &(logfile), NULL, NULL ) ) {
       printf( "failed to process fourth gc op of pack\n" );
       return -1;
    }
@@ -1622,7 +1792,7 @@ int main(int argc, char **argv)
    }
    // process the gcops
    // TODO reparallel-writestreamer
-   if ( process_executeoperation( &(pos), gcops, &(logfile), NULL ) ) {
+   if ( process_executeoperation( &(pos), gcops, &(logfile), NULL, NULL ) ) {
       printf( "failed to process first gc op of parallel-write\n" );
       return -1;
    }
@@ -1763,7 +1933,7 @@ int main(int argc, char **argv)
    }
    // process the gcops
    // TODO reparallel-writestreamer
-   if ( process_executeoperation( &(pos), gcops, &(logfile), NULL ) ) {
+   if ( process_executeoperation( &(pos), gcops, &(logfile), NULL, NULL ) ) {
       printf( "failed to process final gc op of parallel-write\n" );
       return -1;
    }
@@ -1838,6 +2008,154 @@ int main(int argc, char **argv)
       return -1;
    }
 
+   // verify reference dir checkpoints
+   if ( mkdir( "./test_rman_topdir/ckpt_root", S_IRWXU )  &&  errno != EEXIST ) {
+      printf( "Failed to create checkpoint root\n" );
+      return -1;
+   }
+   const char* ckptref = pos.ns->prepo->metascheme.refnodes[0].name;
+   refdir_checkpoint ckpt;
+   refdir_checkpoint readckpt;
+   errno = 0;
+   if ( process_readcheckpoint( "./test_rman_topdir/ckpt_root", 0, ckptref, &(readckpt) ) != 1 ) {
+      printf( "Unexpected result of reading a nonexistent checkpoint\n" );
+      return -1;
+   }
+   if ( process_refdirdigest( &(pos), ckptref, &(ckpt) ) ) {
+      printf( "Failed to digest reference dir \"%s\"\n", ckptref );
+      return -1;
+   }
+   ckpt.sweeptime = 12345;
+   ckpt.entries = 3;
+   ckpt.report.fileusage = 4;
+   ckpt.report.byteusage = 5;
+   ckpt.report.streamcount = 6;
+   if ( process_writecheckpoint( "./test_rman_topdir/ckpt_root", 0, ckptref, &(ckpt) ) ) {
+      printf( "Failed to write checkpoint of reference dir \"%s\"\n", ckptref );
+      return -1;
+   }
+   if ( process_readcheckpoint( "./test_rman_topdir/ckpt_root", 0, ckptref, &(readckpt) ) ) {
+      printf( "Failed to read checkpoint of reference dir \"%s\"\n", ckptref );
+      return -1;
+   }
+   if ( !(process_refdirunchanged( &(readckpt), &(ckpt) ))  ||  readckpt.sweeptime != 12345  ||
+        readckpt.entries != 3  ||  readckpt.report.fileusage != 4  ||  readckpt.report.byteusage != 5  ||
+        readckpt.report.streamcount != 6  ||  readckpt.report.filecount ) {
+      printf( "Checkpoint values of reference dir \"%s\" do not match\n", ckptref );
+      return -1;
+   }
+   if ( process_readcheckpoint( "./test_rman_topdir/ckpt_root", 0, "otherref/", &(readckpt) ) != 1 ) {
+      printf( "Unexpected result of reading a checkpoint of a mismatched reference dir\n" );
+      return -1;
+   }
+   readckpt.nlink++;
+   if ( process_refdirunchanged( &(readckpt), &(ckpt) ) ) {
+      printf( "Modified checkpoint digest was still considered unchanged\n" );
+      return -1;
+   }
+   if ( unlink( "./test_rman_topdir/ckpt_root/refdir-0" )  ||  rmdir( "./test_rman_topdir/ckpt_root" ) ) {
+      printf( "Failed to cleanup checkpoint root\n" );
+      return -1;
+   }
+
+   // test ranking and budgeting of repack candidates
+   REPACKPOLICY rpolicy = repackpolicy_init( 160 );
+   if ( rpolicy == NULL ) {
+      printf( "Failed to initialize repack policy\n" );
+      return -1;
+   }
+   FTAG polftag = {0};
+   polftag.ctag = "POLICY-CLIENT";
+   polftag.streamid = "policystream";
+   size_t polindex = 0;
+   size_t polbytes[3]  = { 100, 500, 50 };  // live bytes of each candidate
+   size_t polobjs[3]   = { 1, 1, 2 };       // objects freed by each candidate
+   for ( ; polindex < 3; polindex++ ) {
+      opinfo* polop = NULL;
+      polftag.fileno = polindex;
+      if ( process_identifyoperation( NULL, MARFS_REPACK_OP, &(polftag), &(polop) ) ) {
+         printf( "Failed to generate repack op for policy candidate %zu\n", polindex );
+         return -1;
+      }
+      polop->count = 1;
+      ((repack_info*)polop->extendedinfo)->totalbytes = polbytes[polindex];
+      if ( repackpolicy_submit( rpolicy, polop, polbytes[polindex], polobjs[polindex], 1000 ) ) {
+         printf( "Failed to submit policy candidate %zu\n", polindex );
+         return -1;
+      }
+   }
+   // expect the densest reclamation first, with the large candidate exceeding our remaining budget
+   size_t polorder[2] = { 2, 0 };
+   for ( polindex = 0; polindex < 2; polindex++ ) {
+      opinfo* polop = NULL;
+      if ( repackpolicy_next( rpolicy, &(polop) ) != 1  ||  polop == NULL ) {
+         printf( "Failed to retrieve policy candidate %zu\n", polindex );
+         return -1;
+      }
+      if ( polop->ftag.fileno != polorder[polindex] ) {
+         printf( "Unexpected policy candidate %zu: %zu\n", polindex, polop->ftag.fileno );
+         return -1;
+      }
+      resourcelog_freeopinfo( polop );
+   }
+   opinfo* polop = NULL;
+   if ( repackpolicy_next( rpolicy, &(polop) )  ||  polop ) {
+      printf( "Unexpected policy candidate beyond budget\n" );
+      return -1;
+   }
+   size_t polspent = 0;
+   if ( repackpolicy_term( rpolicy, &(polspent) )  ||  polspent != 150 ) {
+      printf( "Unexpected repack policy budget usage: %zu\n", polspent );
+      return -1;
+   }
+
+   // test per-location rate limiting of object operations
+   throttle_limits limits = {0};
+   limits.oprate[MARFS_DELETE_OBJ_OP] = 10;
+   RESOURCETHROTTLE throttle = resourcethrottle_init( &(limits) );
+   if ( throttle == NULL ) {
+      printf( "Failed to initialize resource throttle\n" );
+      return -1;
+   }
+   ne_location thrloc1 = { .pod = 0, .cap = 1, .scatter = 2 };
+   ne_location thrloc2 = { .pod = 1, .cap = 1, .scatter = 2 };
+   struct timespec thrstart;
+   struct timespec thrend;
+   clock_gettime( CLOCK_MONOTONIC, &(thrstart) );
+   int thriter = 0;
+   for ( ; thriter < 15; thriter++ ) {
+      // a full second of allowance is available immediately, with the remaining 5 ops spaced out
+      if ( resourcethrottle_acquire( throttle, MARFS_DELETE_OBJ_OP, &(thrloc1), 0 ) ) {
+         printf( "Failed to acquire throttle allowance %d\n", thriter );
+         return -1;
+      }
+   }
+   clock_gettime( CLOCK_MONOTONIC, &(thrend) );
+   double thrtime = (double)( thrend.tv_sec - thrstart.tv_sec ) + (double)( thrend.tv_nsec - thrstart.tv_nsec ) / 1000000000.0;
+   if ( thrtime < 0.45 ) {
+      printf( "Throttle failed to delay excessive ops: %.3f seconds\n", thrtime );
+      return -1;
+   }
+   // other locations and op types should be unaffected
+   clock_gettime( CLOCK_MONOTONIC, &(thrstart) );
+   for ( thriter = 0; thriter < 10; thriter++ ) {
+      if ( resourcethrottle_acquire( throttle, MARFS_DELETE_OBJ_OP, &(thrloc2), 0 )  ||
+           resourcethrottle_acquire( throttle, MARFS_REBUILD_OP, &(thrloc1), 1024 ) ) {
+         printf( "Failed to acquire unrelated throttle allowance %d\n", thriter );
+         return -1;
+      }
+   }
+   clock_gettime( CLOCK_MONOTONIC, &(thrend) );
+   thrtime = (double)( thrend.tv_sec - thrstart.tv_sec ) + (double)( thrend.tv_nsec - thrstart.tv_nsec ) / 1000000000.0;
+   if ( thrtime >= 0.45 ) {
+      printf( "Throttle delayed unrelated ops: %.3f seconds\n", thrtime );
+      return -1;
+   }
+   if ( resourcethrottle_term( throttle ) ) {
+      printf( "Failed to terminate resource throttle\n" );
+      return -1;
+   }
+
    // cleanup our data buffer
    free( databuf );
 
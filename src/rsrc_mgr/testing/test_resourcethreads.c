@@ -125,6 +125,39 @@ int main(int argc, char **argv)
       return -1;
    }
 
+   // verify DEL-OBJ package sizing
+   rthread_global_state batchstate;
+   bzero( &(batchstate), sizeof( struct rthread_global_state_struct ) );
+   batchstate.numconsthreads = 4;
+   if ( rthread_delobjbatch( &(batchstate), 10000 ) != GC_BATCH_INITIAL ) {
+      printf( "unexpected initial DEL-OBJ batch size\n" );
+      return -1;
+   }
+   batchstate.delobjpkgs = 4;
+   batchstate.delobjns = GC_BATCH_TARGET_NS / 1000;
+   if ( rthread_delobjbatch( &(batchstate), 10000 ) != 1000 ) {
+      printf( "unexpected latency-based DEL-OBJ batch size\n" );
+      return -1;
+   }
+   batchstate.delobjns = 1;
+   if ( rthread_delobjbatch( &(batchstate), 10000 ) != GC_BATCH_MAX ) {
+      printf( "DEL-OBJ batch size exceeds maximum\n" );
+      return -1;
+   }
+   batchstate.delobjpkgs = 0;
+   if ( rthread_delobjbatch( &(batchstate), 100 ) != 25  ||  rthread_delobjbatch( &(batchstate), 3 ) != 1 ) {
+      printf( "DEL-OBJ batch size was not capped to a share of remaining objects\n" );
+      return -1;
+   }
+   batchstate.delobjpkgs = 1;
+   batchstate.delobjns = 0;
+   rthread_notedelobj( &(batchstate), stats_start() - 8000000, 8 );
+   if ( batchstate.delobjpkgs != 0  ||  batchstate.delobjns < 1000000 ) {
+      printf( "unexpected DEL-OBJ state following package completion ( pkgs = %zu, ns = %llu )\n",
+              batchstate.delobjpkgs, (unsigned long long)batchstate.delobjns );
+      return -1;
+   }
+
    // Initialize the libxml lib and check for API mismatches
    LIBXML_TEST_VERSION
 
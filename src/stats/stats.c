@@ -0,0 +1,366 @@
+/*
+Copyright (c) 2015, Los Alamos National Security, LLC
+All rights reserved.
+
+Copyright 2015.  Los Alamos National Security, LLC. This software was
+produced under U.S. Government contract DE-AC52-06NA25396 for Los
+Alamos National Laboratory (LANL), which is operated by Los Alamos
+National Security, LLC for the U.S. Department of Energy. The
+U.S. Government has rights to use, reproduce, and distribute this
+software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL SECURITY,
+LLC MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY
+FOR THE USE OF THIS SOFTWARE.  If software is modified to produce
+derivative works, such modified software should be clearly marked, so
+as not to confuse it with the version available from LANL.
+
+Additionally, redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the following
+conditions are met: 1. Redistributions of source code must retain the
+above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of Los Alamos National Security, LLC, Los Alamos
+National Laboratory, LANL, the U.S. Government, nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL LOS
+ALAMOS NATIONAL SECURITY, LLC OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-----
+NOTE:
+-----
+MarFS is released under the BSD license.
+
+MarFS was reviewed and released by LANL under Los Alamos Computer Code
+identifier: LA-CC-15-039.
+
+MarFS uses libaws4c for Amazon S3 object communication. The original
+version is at https://aws.amazon.com/code/Amazon-S3/2601 and under the
+LGPL license.  LANL added functionality to the original work. The
+original work plus LANL contributions is found at
+https://github.com/jti-lanl/aws4c.
+
+GNU licenses can be found at http://www.gnu.org/licenses/.
+*/
+
+#include "marfs_auto_config.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "stats.h"
+
+//   -------------   INTERNAL DEFINITIONS    -------------
+
+typedef struct stats_counter_struct {
+   uint64_t errors;
+   uint64_t bytes;
+   uint64_t totalns;
+   uint64_t maxns;
+   uint64_t buckets[STATS_BUCKET_COUNT];
+} stats_counter;
+
+// every thread records into a private block, which is only ever written by that thread
+// blocks are never freed; a block released by an exiting thread is reclaimed by the next new one
+typedef struct stats_block_struct {
+   struct stats_block_struct* next; // immutable, once the block is published
+   int inuse;                       // non-zero while claimed by a live thread
+   stats_counter ops[STATS_OPCOUNT];
+} stats_block;
+
+static stats_block* blocklist = NULL;
+static __thread stats_block* threadblock = NULL;
+static pthread_key_t blockkey;
+static pthread_once_t blockkeyonce = PTHREAD_ONCE_INIT;
+
+static const char* opnames[STATS_OPCOUNT] = {
+   [STATS_MARFS_INIT]            = "marfs_init",
+   [STATS_MARFS_SETCTAG]         = "marfs_setctag",
+   [STATS_MARFS_CONFIGVER]       = "marfs_configver",
+   [STATS_MARFS_TERM]            = "marfs_term",
+   [STATS_MARFS_MOUNTPATH]       = "marfs_mountpath",
+   [STATS_MARFS_ACCESS]          = "marfs_access",
+   [STATS_MARFS_STAT]            = "marfs_stat",
+   [STATS_MARFS_CHMOD]           = "marfs_chmod",
+   [STATS_MARFS_CHOWN]           = "marfs_chown",
+   [STATS_MARFS_RENAME]          = "marfs_rename",
+   [STATS_MARFS_SYMLINK]         = "marfs_symlink",
+   [STATS_MARFS_READLINK]        = "marfs_readlink",
+   [STATS_MARFS_UNLINK]          = "marfs_unlink",
+   [STATS_MARFS_LINK]            = "marfs_link",
+   [STATS_MARFS_UTIMENS]         = "marfs_utimens",
+   [STATS_MARFS_MKDIR]           = "marfs_mkdir",
+   [STATS_MARFS_RMDIR]           = "marfs_rmdir",
+   [STATS_MARFS_STATVFS]         = "marfs_statvfs",
+   [STATS_MARFS_FSTAT]           = "marfs_fstat",
+   [STATS_MARFS_FUTIMENS]        = "marfs_futimens",
+   [STATS_MARFS_FSETXATTR]       = "marfs_fsetxattr",
+   [STATS_MARFS_FGETXATTR]       = "marfs_fgetxattr",
+   [STATS_MARFS_FREMOVEXATTR]    = "marfs_fremovexattr",
+   [STATS_MARFS_FLISTXATTR]      = "marfs_flistxattr",
+   [STATS_MARFS_OPENDIR]         = "marfs_opendir",
+   [STATS_MARFS_READDIR]         = "marfs_readdir",
+   [STATS_MARFS_READDIRPLUS]     = "marfs_readdirplus",
+   [STATS_MARFS_CLOSEDIR]        = "marfs_closedir",
+   [STATS_MARFS_CHDIR]           = "marfs_chdir",
+   [STATS_MARFS_DSETXATTR]       = "marfs_dsetxattr",
+   [STATS_MARFS_DGETXATTR]       = "marfs_dgetxattr",
+   [STATS_MARFS_DREMOVEXATTR]    = "marfs_dremovexattr",
+   [STATS_MARFS_DLISTXATTR]      = "marfs_dlistxattr",
+   [STATS_MARFS_CREAT]           = "marfs_creat",
+   [STATS_MARFS_CREAT_BATCH]     = "marfs_creat_batch",
+   [STATS_MARFS_OPEN]            = "marfs_open",
+   [STATS_MARFS_CLOSE]           = "marfs_close",
+   [STATS_MARFS_RELEASE]         = "marfs_release",
+   [STATS_MARFS_FLUSH]           = "marfs_flush",
+   [STATS_MARFS_SETRECOVERYPATH] = "marfs_setrecoverypath",
+   [STATS_MARFS_READ]            = "marfs_read",
+   [STATS_MARFS_WRITE]           = "marfs_write",
+   [STATS_MARFS_SEEK]            = "marfs_seek",
+   [STATS_MARFS_READ_AT_OFFSET]  = "marfs_read_at_offset",
+   [STATS_MARFS_CHUNKBOUNDS]     = "marfs_chunkbounds",
+   [STATS_MARFS_FTRUNCATE]       = "marfs_ftruncate",
+   [STATS_MARFS_EXTEND]          = "marfs_extend",
+   [STATS_MARFS_AREAD]           = "marfs_aread",
+   [STATS_MARFS_AWRITE]          = "marfs_awrite",
+   [STATS_DS_OPENOBJ]            = "open_current_obj",
+   [STATS_DS_CLOSEOBJ]           = "close_current_obj",
+   [STATS_DS_PUTFTAG]            = "putftag",
+   [STATS_HASH_LOOKUP]           = "hash_lookup"
+};
+
+/**
+ * Release the calling thread's block for reuse ( pthread key destructor )
+ * @param void* block : Reference to the exiting thread's stats_block
+ */
+static void releaseblock( void* block ) {
+   __atomic_store_n( &(((stats_block*)block)->inuse), 0, __ATOMIC_RELEASE );
+}
+
+/**
+ * Create the pthread key used to release blocks at thread exit
+ */
+static void createblockkey( void ) {
+   pthread_key_create( &blockkey, releaseblock );
+}
+
+/**
+ * Identify the stats_block of the calling thread, claiming or allocating one if necessary
+ * @return stats_block* : Reference to the calling thread's block, or NULL on failure
+ */
+static stats_block* getblock( void ) {
+   if ( threadblock ) { return threadblock; }
+   pthread_once( &blockkeyonce, createblockkey );
+   // attempt to reclaim a block abandoned by a previous thread
+   stats_block* block = __atomic_load_n( &blocklist, __ATOMIC_ACQUIRE );
+   for ( ; block; block = block->next ) {
+      int expected = 0;
+      if ( __atomic_compare_exchange_n( &(block->inuse), &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) ) {
+         break;
+      }
+   }
+   if ( block == NULL ) {
+      // allocate and publish a new block
+      block = calloc( 1, sizeof( struct stats_block_struct ) );
+      if ( block == NULL ) { return NULL; }
+      block->inuse = 1;
+      block->next = __atomic_load_n( &blocklist, __ATOMIC_RELAXED );
+      while ( !__atomic_compare_exchange_n( &blocklist, &(block->next), block, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED ) ) {}
+   }
+   pthread_setspecific( blockkey, block );
+   threadblock = block;
+   return block;
+}
+
+/**
+ * Identify the histogram bucket of the given latency value
+ * @param uint64_t ns : Latency value
+ * @return int : Bucket index
+ */
+static int bucketindex( uint64_t ns ) {
+   if ( ns < STATS_SUBBUCKET_COUNT ) { return (int)ns; }
+   int exponent = 63 - __builtin_clzll( ns );
+   if ( exponent >= STATS_MAX_EXPONENT ) { return STATS_BUCKET_COUNT - 1; }
+   return ( ( exponent - STATS_SUBBUCKET_BITS + 1 ) * STATS_SUBBUCKET_COUNT ) +
+          (int)( ( ns >> ( exponent - STATS_SUBBUCKET_BITS ) ) & ( STATS_SUBBUCKET_COUNT - 1 ) );
+}
+
+/**
+ * Identify the largest latency value which maps to the given histogram bucket
+ * @param int index : Bucket index
+ * @return uint64_t : Upper bound of the bucket
+ */
+static uint64_t bucketlimit( int index ) {
+   if ( index < STATS_SUBBUCKET_COUNT ) { return (uint64_t)index; }
+   int exponent = ( index / STATS_SUBBUCKET_COUNT ) + STATS_SUBBUCKET_BITS - 1;
+   uint64_t sub = (uint64_t)( index % STATS_SUBBUCKET_COUNT );
+   uint64_t width = 1ULL << ( exponent - STATS_SUBBUCKET_BITS );
+   return ( ( STATS_SUBBUCKET_COUNT + sub ) * width ) + width - 1;
+}
+
+// only the owning thread ever writes a counter, so a relaxed load + store is sufficient
+#define STATS_ADD( field, val ) __atomic_store_n( &(field), (field) + (val), __ATOMIC_RELAXED )
+
+
+//   -------------   EXTERNAL FUNCTIONS    -------------
+
+/**
+ * Produce a start timestamp for a tracked operation
+ * @return uint64_t : Current monotonic time, in nanoseconds
+ */
+uint64_t stats_start( void ) {
+   struct timespec ts;
+   clock_gettime( CLOCK_MONOTONIC, &ts );
+   return ( (uint64_t)ts.tv_sec * 1000000000ULL ) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Record the completion of a tracked operation
+ * NOTE -- Each thread records into its own private counters, so this function never
+ *         blocks or contends with other threads.
+ * @param stats_op op : Operation being recorded
+ * @param uint64_t start : Start timestamp of the operation ( see stats_start() )
+ * @param size_t bytes : Count of data bytes moved by the operation
+ * @param char failed : If non-zero, the operation will be counted as an error
+ */
+void stats_record( stats_op op, uint64_t start, size_t bytes, char failed ) {
+   if ( op < 0  ||  op >= STATS_OPCOUNT ) { return; }
+   uint64_t end = stats_start();
+   uint64_t elapsed = ( end > start ) ? end - start : 0;
+   int origerrno = errno; // never disturb the errno value of the tracked op
+   stats_block* block = getblock();
+   errno = origerrno;
+   if ( block == NULL ) { return; } // silently drop values we have nowhere to store
+   stats_counter* counter = &(block->ops[op]);
+   if ( failed ) { STATS_ADD( counter->errors, 1 ); }
+   if ( bytes ) { STATS_ADD( counter->bytes, bytes ); }
+   STATS_ADD( counter->totalns, elapsed );
+   if ( elapsed > counter->maxns ) { __atomic_store_n( &(counter->maxns), elapsed, __ATOMIC_RELAXED ); }
+   STATS_ADD( counter->buckets[bucketindex( elapsed )], 1 );
+}
+
+/**
+ * Produce the name string of the given operation
+ * @param stats_op op : Operation to identify
+ * @return const char* : Name of the operation, or NULL if invalid
+ */
+const char* stats_opname( stats_op op ) {
+   if ( op < 0  ||  op >= STATS_OPCOUNT ) {
+      errno = EINVAL;
+      return NULL;
+   }
+   return opnames[op];
+}
+
+/**
+ * Populate a summary of all recorded values for the given operation, across all threads
+ * NOTE -- Values recorded concurrently with this call may or may not be included.
+ * @param stats_op op : Operation to summarize
+ * @param stats_summary* summary : Reference to the summary to be populated
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int stats_summarize( stats_op op, stats_summary* summary ) {
+   if ( op < 0  ||  op >= STATS_OPCOUNT  ||  summary == NULL ) {
+      errno = EINVAL;
+      return -1;
+   }
+   bzero( summary, sizeof( struct stats_summary_struct ) );
+   uint64_t* buckets = calloc( STATS_BUCKET_COUNT, sizeof( uint64_t ) );
+   if ( buckets == NULL ) { return -1; }
+   // merge the counters of every thread
+   stats_block* block = __atomic_load_n( &blocklist, __ATOMIC_ACQUIRE );
+   for ( ; block; block = block->next ) {
+      stats_counter* counter = &(block->ops[op]);
+      summary->errors += __atomic_load_n( &(counter->errors), __ATOMIC_RELAXED );
+      summary->bytes += __atomic_load_n( &(counter->bytes), __ATOMIC_RELAXED );
+      summary->totalns += __atomic_load_n( &(counter->totalns), __ATOMIC_RELAXED );
+      uint64_t maxns = __atomic_load_n( &(counter->maxns), __ATOMIC_RELAXED );
+      if ( maxns > summary->maxns ) { summary->maxns = maxns; }
+      int index;
+      for ( index = 0; index < STATS_BUCKET_COUNT; index++ ) {
+         uint64_t bcount = __atomic_load_n( &(counter->buckets[index]), __ATOMIC_RELAXED );
+         buckets[index] += bcount;
+         // derive the count from the buckets, so percentiles are always self-consistent
+         summary->count += bcount;
+      }
+   }
+   // walk the merged histogram, identifying each percentile
+   uint64_t p50tgt = ( summary->count * 500 + 999 ) / 1000;
+   uint64_t p90tgt = ( summary->count * 900 + 999 ) / 1000;
+   uint64_t p99tgt = ( summary->count * 990 + 999 ) / 1000;
+   uint64_t p999tgt = ( summary->count * 999 + 999 ) / 1000;
+   uint64_t seen = 0;
+   int index;
+   for ( index = 0; index < STATS_BUCKET_COUNT  &&  seen < summary->count; index++ ) {
+      if ( buckets[index] == 0 ) { continue; }
+      seen += buckets[index];
+      uint64_t limit = bucketlimit( index );
+      if ( limit > summary->maxns ) { limit = summary->maxns; }
+      if ( summary->p50ns == 0  &&  seen >= p50tgt ) { summary->p50ns = limit; }
+      if ( summary->p90ns == 0  &&  seen >= p90tgt ) { summary->p90ns = limit; }
+      if ( summary->p99ns == 0  &&  seen >= p99tgt ) { summary->p99ns = limit; }
+      if ( summary->p999ns == 0  &&  seen >= p999tgt ) { summary->p999ns = limit; }
+   }
+   free( buckets );
+   return 0;
+}
+
+/**
+ * Populate the given string with a report of all recorded operation values
+ * NOTE -- The report consists of a single header line, beginning with '#', followed by a
+ *         line for each operation of the form :
+ *            <op-name> <count> <errors> <bytes> <total-ns> <max-ns> <p50-ns> <p90-ns> <p99-ns> <p999-ns>
+ * @param char* buf : String to be populated
+ * @param size_t len : Allocated length of the target string
+ * @return size_t : Length of the produced string ( excluding NULL-terminator )
+ *                  NOTE -- if this value is >= the length of the provided buffer, this
+ *                  indicates that insufficint buffer space was provided and the resulting
+ *                  output string was truncated.
+ */
+size_t stats_report( char* buf, size_t len ) {
+   size_t total = 0;
+   int prres = snprintf( buf, len, "# op count errors bytes total_ns max_ns p50_ns p90_ns p99_ns p999_ns\n" );
+   if ( prres < 0 ) { return 0; }
+   total += prres;
+   stats_op op;
+   for ( op = 0; op < STATS_OPCOUNT; op++ ) {
+      stats_summary summary;
+      if ( stats_summarize( op, &summary ) ) { return 0; }
+      // once we have run out of buffer, keep going only to determine the required length
+      char* tgt = ( total < len ) ? buf + total : NULL;
+      size_t remaining = ( total < len ) ? len - total : 0;
+      prres = snprintf( tgt, remaining, "%s %llu %llu %llu %llu %llu %llu %llu %llu %llu\n",
+                        opnames[op],
+                        (unsigned long long)summary.count,
+                        (unsigned long long)summary.errors,
+                        (unsigned long long)summary.bytes,
+                        (unsigned long long)summary.totalns,
+                        (unsigned long long)summary.maxns,
+                        (unsigned long long)summary.p50ns,
+                        (unsigned long long)summary.p90ns,
+                        (unsigned long long)summary.p99ns,
+                        (unsigned long long)summary.p999ns );
+      if ( prres < 0 ) { return 0; }
+      total += prres;
+   }
+   return total;
+}
+
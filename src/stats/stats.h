@@ -0,0 +1,192 @@
+#ifndef _STATS_H
+#define _STATS_H
+/*
+Copyright (c) 2015, Los Alamos National Security, LLC
+All rights reserved.
+
+Copyright 2015.  Los Alamos National Security, LLC. This software was
+produced under U.S. Government contract DE-AC52-06NA25396 for Los
+Alamos National Laboratory (LANL), which is operated by Los Alamos
+National Security, LLC for the U.S. Department of Energy. The
+U.S. Government has rights to use, reproduce, and distribute this
+software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL SECURITY,
+LLC MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY
+FOR THE USE OF THIS SOFTWARE.  If software is modified to produce
+derivative works, such modified software should be clearly marked, so
+as not to confuse it with the version available from LANL.
+ 
+Additionally, redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the following
+conditions are met: 1. Redistributions of source code must retain the
+above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of Los Alamos National Security, LLC, Los Alamos
+National Laboratory, LANL, the U.S. Government, nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL LOS
+ALAMOS NATIONAL SECURITY, LLC OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-----
+NOTE:
+-----
+MarFS is released under the BSD license.
+
+MarFS was reviewed and released by LANL under Los Alamos Computer Code
+identifier: LA-CC-15-039.
+
+MarFS uses libaws4c for Amazon S3 object communication. The original version
+is at https://aws.amazon.com/code/Amazon-S3/2601 and under the LGPL license.
+LANL added functionality to the original work. The original work plus
+LANL contributions is found at https://github.com/jti-lanl/aws4c.
+
+GNU licenses can be found at http://www.gnu.org/licenses/.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// Latency values are tracked in log-linear buckets : values below STATS_SUBBUCKET_COUNT
+// nanoseconds get an exact bucket, while larger values are split into STATS_SUBBUCKET_COUNT
+// buckets per power of two ( ~12% precision ).  Values beyond 2^STATS_MAX_EXPONENT ns
+// ( ~73 min ) are clamped into the final bucket.
+#define STATS_SUBBUCKET_BITS 3
+#define STATS_SUBBUCKET_COUNT ( 1 << STATS_SUBBUCKET_BITS )
+#define STATS_MAX_EXPONENT 42
+#define STATS_BUCKET_COUNT ( ( STATS_MAX_EXPONENT - STATS_SUBBUCKET_BITS + 1 ) * STATS_SUBBUCKET_COUNT )
+
+typedef enum {
+   // MarFS API entry points
+   STATS_MARFS_INIT = 0,
+   STATS_MARFS_SETCTAG,
+   STATS_MARFS_CONFIGVER,
+   STATS_MARFS_TERM,
+   STATS_MARFS_MOUNTPATH,
+   STATS_MARFS_ACCESS,
+   STATS_MARFS_STAT,
+   STATS_MARFS_CHMOD,
+   STATS_MARFS_CHOWN,
+   STATS_MARFS_RENAME,
+   STATS_MARFS_SYMLINK,
+   STATS_MARFS_READLINK,
+   STATS_MARFS_UNLINK,
+   STATS_MARFS_LINK,
+   STATS_MARFS_UTIMENS,
+   STATS_MARFS_MKDIR,
+   STATS_MARFS_RMDIR,
+   STATS_MARFS_STATVFS,
+   STATS_MARFS_FSTAT,
+   STATS_MARFS_FUTIMENS,
+   STATS_MARFS_FSETXATTR,
+   STATS_MARFS_FGETXATTR,
+   STATS_MARFS_FREMOVEXATTR,
+   STATS_MARFS_FLISTXATTR,
+   STATS_MARFS_OPENDIR,
+   STATS_MARFS_READDIR,
+   STATS_MARFS_READDIRPLUS,
+   STATS_MARFS_CLOSEDIR,
+   STATS_MARFS_CHDIR,
+   STATS_MARFS_DSETXATTR,
+   STATS_MARFS_DGETXATTR,
+   STATS_MARFS_DREMOVEXATTR,
+   STATS_MARFS_DLISTXATTR,
+   STATS_MARFS_CREAT,
+   STATS_MARFS_CREAT_BATCH,
+   STATS_MARFS_OPEN,
+   STATS_MARFS_CLOSE,
+   STATS_MARFS_RELEASE,
+   STATS_MARFS_FLUSH,
+   STATS_MARFS_SETRECOVERYPATH,
+   STATS_MARFS_READ,
+   STATS_MARFS_WRITE,
+   STATS_MARFS_SEEK,
+   STATS_MARFS_READ_AT_OFFSET,
+   STATS_MARFS_CHUNKBOUNDS,
+   STATS_MARFS_FTRUNCATE,
+   STATS_MARFS_EXTEND,
+   STATS_MARFS_AREAD,
+   STATS_MARFS_AWRITE,
+   // internal operations
+   STATS_DS_OPENOBJ,
+   STATS_DS_CLOSEOBJ,
+   STATS_DS_PUTFTAG,
+   STATS_HASH_LOOKUP,
+   STATS_OPCOUNT // count of tracked operations ( must remain last )
+} stats_op;
+
+typedef struct stats_summary_struct {
+   uint64_t count;   // count of completed operations
+   uint64_t errors;  // count of operations which reported failure
+   uint64_t bytes;   // total data bytes moved by the operation ( zero for most ops )
+   uint64_t totalns; // total latency, in nanoseconds
+   uint64_t maxns;   // maximum observed latency, in nanoseconds
+   uint64_t p50ns;   // 50th percentile latency, in nanoseconds ( bucket upper bound )
+   uint64_t p90ns;   // 90th percentile latency, in nanoseconds ( bucket upper bound )
+   uint64_t p99ns;   // 99th percentile latency, in nanoseconds ( bucket upper bound )
+   uint64_t p999ns;  // 99.9th percentile latency, in nanoseconds ( bucket upper bound )
+} stats_summary;
+
+/**
+ * Produce a start timestamp for a tracked operation
+ * @return uint64_t : Current monotonic time, in nanoseconds
+ */
+uint64_t stats_start( void );
+
+/**
+ * Record the completion of a tracked operation
+ * NOTE -- Each thread records into its own private counters, so this function never
+ *         blocks or contends with other threads.
+ * @param stats_op op : Operation being recorded
+ * @param uint64_t start : Start timestamp of the operation ( see stats_start() )
+ * @param size_t bytes : Count of data bytes moved by the operation
+ * @param char failed : If non-zero, the operation will be counted as an error
+ */
+void stats_record( stats_op op, uint64_t start, size_t bytes, char failed );
+
+/**
+ * Produce the name string of the given operation
+ * @param stats_op op : Operation to identify
+ * @return const char* : Name of the operation, or NULL if invalid
+ */
+const char* stats_opname( stats_op op );
+
+/**
+ * Populate a summary of all recorded values for the given operation, across all threads
+ * NOTE -- Values recorded concurrently with this call may or may not be included.
+ * @param stats_op op : Operation to summarize
+ * @param stats_summary* summary : Reference to the summary to be populated
+ * @return int : Zero on success, or -1 if a failure occurred
+ */
+int stats_summarize( stats_op op, stats_summary* summary );
+
+/**
+ * Populate the given string with a report of all recorded operation values
+ * NOTE -- The report consists of a single header line, beginning with '#', followed by a
+ *         line for each operation of the form :
+ *            <op-name> <count> <errors> <bytes> <total-ns> <max-ns> <p50-ns> <p90-ns> <p99-ns> <p999-ns>
+ * @param char* buf : String to be populated
+ * @param size_t len : Allocated length of the target string
+ * @return size_t : Length of the produced string ( excluding NULL-terminator )
+ *                  NOTE -- if this value is >= the length of the provided buffer, this
+ *                  indicates that insufficint buffer space was provided and the resulting
+ *                  output string was truncated.
+ */
+size_t stats_report( char* buf, size_t len );
+
+#endif // _STATS_H
+
@@ -0,0 +1,191 @@
+/*
+Copyright (c) 2015, Los Alamos National Security, LLC
+All rights reserved.
+
+Copyright 2015.  Los Alamos National Security, LLC. This software was
+produced under U.S. Government contract DE-AC52-06NA25396 for Los
+Alamos National Laboratory (LANL), which is operated by Los Alamos
+National Security, LLC for the U.S. Department of Energy. The
+U.S. Government has rights to use, reproduce, and distribute this
+software.  NEITHER THE GOVERNMENT NOR LOS ALAMOS NATIONAL SECURITY,
+LLC MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY LIABILITY
+FOR THE USE OF THIS SOFTWARE.  If software is modified to produce
+derivative works, such modified software should be clearly marked, so
+as not to confuse it with the version available from LANL.
+
+Additionally, redistribution and use in source and binary forms, with
+or without modification, are permitted provided that the following
+conditions are met: 1. Redistributions of source code must retain the
+above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of Los Alamos National Security, LLC, Los Alamos
+National Laboratory, LANL, the U.S. Government, nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY LOS ALAMOS NATIONAL SECURITY, LLC AND
+CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING,
+BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL LOS
+ALAMOS NATIONAL SECURITY, LLC OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+-----
+NOTE:
+-----
+MarFS is released under the BSD license.
+
+MarFS was reviewed and released by LANL under Los Alamos Computer Code
+identifier: LA-CC-15-039.
+
+MarFS uses libaws4c for Amazon S3 object communication. The original
+version is at https://aws.amazon.com/code/Amazon-S3/2601 and under the
+LGPL license.  LANL added functionality to the original work. The
+original work plus LANL contributions is found at
+https://github.com/jti-lanl/aws4c.
+
+GNU licenses can be found at http://www.gnu.org/licenses/.
+*/
+
+#include "stats/stats.c"
+
+#include <unistd.h>
+
+#define THREAD_COUNT 8
+#define OPS_PER_THREAD 10000
+
+void* recordthread( void* arg ) {
+   size_t tnum = (size_t)arg;
+   int index;
+   for ( index = 0; index < OPS_PER_THREAD; index++ ) {
+      uint64_t start = stats_start();
+      // every tenth op of odd threads 'fails'
+      stats_record( STATS_MARFS_WRITE, start, tnum + 1, ( tnum % 2 )  &&  ( index % 10 == 0 ) );
+   }
+   return NULL;
+}
+
+int main( int argc, char** argv ) {
+
+   // NOTE -- I'm ignoring memory leaks for error conditions
+   //         which result in immediate termination
+
+   // verify bucket boundaries are consistent
+   uint64_t value;
+   for ( value = 0; value < ( 1ULL << 20 ); value++ ) {
+      int index = bucketindex( value );
+      if ( index < 0  ||  index >= STATS_BUCKET_COUNT ) {
+         printf( "value %llu mapped to out of bounds bucket %d\n", (unsigned long long)value, index );
+         return -1;
+      }
+      if ( value > bucketlimit( index )  ||  ( index  &&  value <= bucketlimit( index - 1 ) ) ) {
+         printf( "value %llu is outside the bounds of bucket %d\n", (unsigned long long)value, index );
+         return -1;
+      }
+   }
+   if ( bucketindex( UINT64_MAX ) != STATS_BUCKET_COUNT - 1 ) {
+      printf( "max value did not map to the final bucket\n" );
+      return -1;
+   }
+
+   // record from many threads at once
+   pthread_t threads[THREAD_COUNT];
+   size_t tnum;
+   for ( tnum = 0; tnum < THREAD_COUNT; tnum++ ) {
+      if ( pthread_create( &(threads[tnum]), NULL, recordthread, (void*)tnum ) ) {
+         printf( "failed to create thread %zu\n", tnum );
+         return -1;
+      }
+   }
+   for ( tnum = 0; tnum < THREAD_COUNT; tnum++ ) {
+      if ( pthread_join( threads[tnum], NULL ) ) {
+         printf( "failed to join thread %zu\n", tnum );
+         return -1;
+      }
+   }
+
+   // a fresh thread should reclaim a released block, rather than allocating another
+   size_t blockcount = 0;
+   stats_block* block = blocklist;
+   for ( ; block; block = block->next ) { blockcount++; }
+   if ( blockcount == 0  ||  blockcount > THREAD_COUNT ) {
+      printf( "unexpected stats block count of %zu\n", blockcount );
+      return -1;
+   }
+   if ( pthread_create( &(threads[0]), NULL, recordthread, (void*)0 )  ||  pthread_join( threads[0], NULL ) ) {
+      printf( "failed to run reuse thread\n" );
+      return -1;
+   }
+   size_t newcount = 0;
+   for ( block = blocklist; block; block = block->next ) { newcount++; }
+   if ( newcount != blockcount ) {
+      printf( "expected %zu stats blocks after reuse, but found %zu\n", blockcount, newcount );
+      return -1;
+   }
+
+   // verify aggregate values
+   stats_summary summary;
+   if ( stats_summarize( STATS_MARFS_WRITE, &summary ) ) {
+      printf( "failed to summarize write stats\n" );
+      return -1;
+   }
+   uint64_t expcount = ( THREAD_COUNT + 1 ) * OPS_PER_THREAD;
+   uint64_t experrors = ( THREAD_COUNT / 2 ) * ( OPS_PER_THREAD / 10 );
+   uint64_t expbytes = OPS_PER_THREAD; // the reuse thread
+   for ( tnum = 0; tnum < THREAD_COUNT; tnum++ ) { expbytes += ( tnum + 1 ) * OPS_PER_THREAD; }
+   if ( summary.count != expcount  ||  summary.errors != experrors  ||  summary.bytes != expbytes ) {
+      printf( "unexpected write summary: count=%llu(exp %llu) errors=%llu(exp %llu) bytes=%llu(exp %llu)\n",
+              (unsigned long long)summary.count, (unsigned long long)expcount,
+              (unsigned long long)summary.errors, (unsigned long long)experrors,
+              (unsigned long long)summary.bytes, (unsigned long long)expbytes );
+      return -1;
+   }
+   if ( summary.p50ns > summary.p90ns  ||  summary.p90ns > summary.p99ns  ||
+        summary.p99ns > summary.p999ns  ||  summary.p999ns > summary.maxns ) {
+      printf( "inconsistent write percentiles\n" );
+      return -1;
+   }
+   if ( stats_summarize( STATS_MARFS_READ, &summary )  ||  summary.count  ||  summary.maxns ) {
+      printf( "unexpected read summary\n" );
+      return -1;
+   }
+
+   // verify report length semantics
+   size_t replen = stats_report( NULL, 0 );
+   if ( replen == 0 ) {
+      printf( "failed to determine report length\n" );
+      return -1;
+   }
+   char* report = malloc( replen + 1 );
+   if ( report == NULL ) {
+      printf( "failed to allocate report string\n" );
+      return -1;
+   }
+   if ( stats_report( report, replen + 1 ) != replen ) {
+      printf( "inconsistent report length\n" );
+      return -1;
+   }
+   if ( strstr( report, "\nmarfs_write 90000 " ) == NULL ) {
+      printf( "report is missing expected write line:\n%s", report );
+      return -1;
+   }
+   char shortbuf[16];
+   if ( stats_report( shortbuf, 16 ) != replen  ||  strlen( shortbuf ) != 15 ) {
+      printf( "truncated report has unexpected length\n" );
+      return -1;
+   }
+   free( report );
+
+   return 0;
+}
+
@@ -208,17 +208,29 @@ int ftag_initstr( FTAG* ftag, char* ftagstr ) {
    }
    parse++; // skip over the '|' char
    char foundvals = 0;
+   char foundcomp = 0;
+   ftag->compression = FTAG_COMPRESS_NONE; // compression value is optional
    while ( *parse != '\0' ) {
       size_t* tgtval = NULL;
       if ( *parse == 'F' ) { tgtval = &(ftag->objfiles); }
       else if ( *parse == 'D' ) { tgtval = &(ftag->objsize); }
+      else if ( *parse == 'C' ) { foundcomp = 1; }
       else { LOG( LOG_ERR, "Unrecognized value tag: \"%c\"\n", *parse ); return -1; }
       parseval = strtoull( parse + 1, &(endptr), 10 );
-      if ( parseval > SIZE_MAX ) {
-         LOG( LOG_ERR, "Parsed objfile value exceeds size limits: %llu\n", parseval );
-         return -1;
+      if ( tgtval == NULL ) {
+         if ( parseval == FTAG_COMPRESS_NONE  ||  parseval > FTAG_COMPRESS_MAX ) {
+            LOG( LOG_ERR, "Unrecognized compression type value: %llu\n", parseval );
+            return -1;
+         }
+         ftag->compression = (FTAG_COMPRESSION)parseval;
+      }
+      else {
+         if ( parseval > SIZE_MAX ) {
+            LOG( LOG_ERR, "Parsed objfile value exceeds size limits: %llu\n", parseval );
+            return -1;
+         }
+         *tgtval = parseval;
       }
-      *tgtval = parseval;
       foundvals++;
       if ( *endptr != '-'  &&  *endptr != ')' ) {
          LOG( LOG_ERR, "Unrecognized stream value format\n" );
@@ -227,8 +239,8 @@ int ftag_initstr( FTAG* ftag, char* ftagstr ) {
       parse = endptr + 1; // skip over the separator char
       if ( *endptr == ')' ) { break; }
    }
-   if ( foundvals != 2 ) {
-      LOG( LOG_ERR, "Expected two stream object values (objfiles/objsize), but found %d\n", (int)foundvals );
+   if ( foundvals != 2 + foundcomp ) {
+      LOG( LOG_ERR, "Expected two stream object values (objfiles/objsize), but found %d\n", (int)(foundvals - foundcomp) );
       return -1;
    }
    // parse reference tree info
@@ -463,12 +475,28 @@ size_t ftag_tostr( const FTAG* ftag, char* tgtstr, size_t len ) {
    totsz += prres;
 
    // output stream identification info
-   prres = snprintf( tgtstr, len, "%s(%s|%s|F%zu-D%zu)",
-                     FTAG_STREAMINFO_HEADER,
-                     ftag->ctag,
-                     ftag->streamid,
-                     ftag->objfiles,
-                     ftag->objsize );
+   // NOTE -- compression info is omitted for uncompressed streams, for compatibility
+   if ( ftag->compression > FTAG_COMPRESS_MAX ) {
+      LOG( LOG_ERR, "Cannot output string for unrecognized compression type: %d\n", (int)ftag->compression );
+      return 0;
+   }
+   if ( ftag->compression == FTAG_COMPRESS_NONE ) {
+      prres = snprintf( tgtstr, len, "%s(%s|%s|F%zu-D%zu)",
+                        FTAG_STREAMINFO_HEADER,
+                        ftag->ctag,
+                        ftag->streamid,
+                        ftag->objfiles,
+                        ftag->objsize );
+   }
+   else {
+      prres = snprintf( tgtstr, len, "%s(%s|%s|F%zu-D%zu-C%d)",
+                        FTAG_STREAMINFO_HEADER,
+                        ftag->ctag,
+                        ftag->streamid,
+                        ftag->objfiles,
+                        ftag->objsize,
+                        (int)ftag->compression );
+   }
    if ( prres < 1 ) {
       LOG( LOG_ERR, "Failed to output stream info string\n" );
       return 0;
@@ -565,6 +593,7 @@ int ftag_cmp( const FTAG* ftag1, const FTAG* ftag2 ) {
         ftag1->minorversion != ftag2->minorversion            ||
         ftag1->objfiles != ftag2->objfiles                    ||
         ftag1->objsize != ftag2->objsize                      ||
+        ftag1->compression != ftag2->compression              ||
         ftag1->refbreadth != ftag2->refbreadth                ||
         ftag1->refdepth != ftag2->refdepth                    ||
         ftag1->refdigits != ftag2->refdigits                  ||
@@ -84,6 +84,14 @@ typedef enum
    FTAG_READABLE = 8,  // Readable flag -- file's data is readable by arbitrary procs
 } FTAG_STATE;
 
+typedef enum
+{
+   // Data Object Compression Types ( applied uniformly to every object of a stream )
+   FTAG_COMPRESS_NONE = 0, // object content is stored exactly as written
+   FTAG_COMPRESS_ZLIB = 1, // object content is stored as a series of deflated blocks
+   FTAG_COMPRESS_MAX = FTAG_COMPRESS_ZLIB // largest recognized compression type value
+} FTAG_COMPRESSION;
+
 
 typedef struct ftag_struct {
    // version info
@@ -95,6 +103,7 @@ typedef struct ftag_struct {
    // stream structure info
    size_t objfiles;
    size_t objsize;
+   FTAG_COMPRESSION compression;
    // reference tree info
    int    refbreadth;
    int    refdepth;
@@ -76,6 +76,7 @@ int main(int argc, char **argv)
    ftag.streamid = "teststreamidvalue";
    ftag.objfiles = 1024;
    ftag.objsize = 1073741824; // 1GiB
+   ftag.compression = FTAG_COMPRESS_NONE;
    ftag.refbreadth = 24;
    ftag.refdepth = 123;
    ftag.refdigits = 1;
@@ -113,6 +114,7 @@ int main(int argc, char **argv)
    oftag.streamid = "testostreamid";
    oftag.objfiles = 10;
    oftag.objsize = 10737;
+   oftag.compression = FTAG_COMPRESS_ZLIB;
    oftag.refbreadth = 43;
    oftag.refdepth = 1;
    oftag.refdigits = 543;
@@ -177,6 +179,40 @@ int main(int argc, char **argv)
    free( oftag.streamid );
    free( oftag.ctag );
 
+   // verify that compression info survives a string round trip
+   ftag.compression = FTAG_COMPRESS_ZLIB;
+   ftagstrlen = ftag_tostr( &(ftag), NULL, 0 );
+   if ( ftagstrlen < 1 ) {
+      printf( "failed to generate compressed ftag string\n" );
+      return -1;
+   }
+   ftagstr = malloc( sizeof(char) * (ftagstrlen + 1) );
+   if ( ftagstr == NULL ) {
+      printf( "failed to allocate space for compressed ftag string\n" );
+      return -1;
+   }
+   if ( ftag_tostr( &(ftag), ftagstr, ftagstrlen + 1 ) != ftagstrlen ) {
+      printf( "inconsistent length of compressed ftag string\n" );
+      return -1;
+   }
+   if ( strstr( ftagstr, "-C1)" ) == NULL ) {
+      printf( "compressed ftag string lacks compression info: \"%s\"\n", ftagstr );
+      return -1;
+   }
+   oftag.compression = FTAG_COMPRESS_NONE;
+   if ( ftag_initstr( &(oftag), ftagstr ) ) {
+      printf( "failed to init ftag from compressed str: \"%s\"\n", ftagstr );
+      return -1;
+   }
+   if ( ftag_cmp( &(ftag), &(oftag) ) ) {
+      printf( "orig values differ from compressed string vals: \"%s\"\n", ftagstr );
+      return -1;
+   }
+   free( ftagstr );
+   free( oftag.streamid );
+   free( oftag.ctag );
+   ftag.compression = FTAG_COMPRESS_NONE;
+
    // test rebuild tag processing
    ne_state rtag = {
       .versz = 1234,